@@ -107,6 +107,21 @@ int32_t AVDemuxerImpl::ReadSampleBuffer(uint32_t trackIndex, std::shared_ptr<AVB
     return StatusToAVCodecServiceErrCode(demuxerEngine_->ReadSample(trackIndex, sample));
 }
 
+int32_t AVDemuxerImpl::ReadSampleBuffers(uint32_t trackIndex, const std::vector<std::shared_ptr<AVBuffer>> &samples,
+    uint32_t maxBytes, uint32_t &readCount)
+{
+    AVCODEC_SYNC_TRACE;
+
+    AVCODEC_LOGD("ReadSampleBuffers: trackIndex=%{public}u, count=%{public}zu", trackIndex, samples.size());
+
+    readCount = 0;
+    CHECK_AND_RETURN_RET_LOG(demuxerEngine_ != nullptr, AVCS_ERR_INVALID_OPERATION, "Demuxer engine does not exist");
+
+    CHECK_AND_RETURN_RET_LOG(!samples.empty(), AVCS_ERR_INVALID_VAL, "Read samples failed because no sample buffer!");
+
+    return StatusToAVCodecServiceErrCode(demuxerEngine_->ReadSamples(trackIndex, samples, maxBytes, readCount));
+}
+
 int32_t AVDemuxerImpl::ReadSample(uint32_t trackIndex, std::shared_ptr<AVSharedMemory> sample,
     AVCodecBufferInfo &info, uint32_t &flag)
 {
@@ -37,6 +37,8 @@ public:
     int32_t ReadSample(uint32_t trackIndex, std::shared_ptr<AVSharedMemory> sample,
         AVCodecBufferInfo &info, AVCodecBufferFlag &flag) override;
     int32_t ReadSampleBuffer(uint32_t trackIndex, std::shared_ptr<AVBuffer> sample) override;
+    int32_t ReadSampleBuffers(uint32_t trackIndex, const std::vector<std::shared_ptr<AVBuffer>> &samples,
+        uint32_t maxBytes, uint32_t &readCount) override;
     int32_t SeekToTime(int64_t millisecond, const SeekMode mode) override;
     int32_t SetCallback(const std::shared_ptr<AVDemuxerCallback> &callback) override;
     int32_t GetMediaKeySystemInfo(std::multimap<std::string, std::vector<uint8_t>> &infos) override;
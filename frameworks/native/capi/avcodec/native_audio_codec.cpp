@@ -13,7 +13,6 @@
  * limitations under the License.
  */
 
-#include <list>
 #include <mutex>
 #include <shared_mutex>
 #include "avcodec_audio_codec.h"
@@ -24,6 +23,7 @@
 #include "native_avcodec_audiocodec.h"
 #include "native_avcodec_base.h"
 #include "native_avmagic.h"
+#include "native_buffer_cache.h"
 #include "avcodec_codec_name.h"
 #include "avcodec_audio_codec_impl.h"
 #ifdef SUPPORT_DRM
@@ -45,14 +45,20 @@ struct AudioCodecObject : public OH_AVCodec {
     }
     ~AudioCodecObject() = default;
 
+    void ClearBufferList()
+    {
+        inputBufferCache_.Clear();
+        outputBufferCache_.Clear();
+    }
+
     const std::shared_ptr<AVCodecAudioCodecImpl> audioCodec_;
-    std::list<OHOS::sptr<OH_AVBuffer>> bufferObjList_;
+    NativeAVBufferCache inputBufferCache_;
+    NativeAVBufferCache outputBufferCache_;
     std::shared_ptr<NativeAudioCodec> callback_ = nullptr;
     std::atomic<bool> isFlushing_ = false;
     std::atomic<bool> isFlushed_ = false;
     std::atomic<bool> isStop_ = false;
     std::atomic<bool> isEOS_ = false;
-    std::shared_mutex memoryObjListMutex_;
 };
 
 class NativeAudioCodec : public MediaCodecCallback {
@@ -94,7 +100,7 @@ public:
                 AVCODEC_LOGD("At flush, eos or stop, no buffer available");
                 return;
             }
-            OH_AVBuffer *data = GetTransData(codec_, index, buffer);
+            OH_AVBuffer *data = GetTransData(codec_, index, buffer, false);
             callback_.onNeedInputBuffer(codec_, index, data, userData_);
         }
     }
@@ -110,7 +116,7 @@ public:
                 AVCODEC_LOGD("At flush or stop, ignore");
                 return;
             }
-            OH_AVBuffer *data = GetTransData(codec_, index, buffer);
+            OH_AVBuffer *data = GetTransData(codec_, index, buffer, true);
             callback_.onNewOutputBuffer(codec_, index, data, userData_);
         }
     }
@@ -122,7 +128,8 @@ public:
     }
 
 private:
-    OH_AVBuffer *GetTransData(struct OH_AVCodec *codec, uint32_t index, std::shared_ptr<AVBuffer> buffer)
+    OH_AVBuffer *GetTransData(struct OH_AVCodec *codec, uint32_t index, std::shared_ptr<AVBuffer> buffer,
+                              bool isOutput)
     {
         CHECK_AND_RETURN_RET_LOG(codec != nullptr, nullptr, "input codec is nullptr!");
         CHECK_AND_RETURN_RET_LOG(codec->magic_ == AVMagic::AVCODEC_MAGIC_AUDIO_DECODER ||
@@ -132,21 +139,10 @@ private:
         CHECK_AND_RETURN_RET_LOG(audioCodecObj->audioCodec_ != nullptr, nullptr, "audioc odec is nullptr!");
         CHECK_AND_RETURN_RET_LOG(buffer != nullptr, nullptr, "get output buffer is nullptr!");
 
-        {
-            std::shared_lock<std::shared_mutex> lock(audioCodecObj->memoryObjListMutex_);
-            for (auto &bufferObj : audioCodecObj->bufferObjList_) {
-                if (bufferObj->IsEqualBuffer(buffer)) {
-                    return reinterpret_cast<OH_AVBuffer *>(bufferObj.GetRefPtr());
-                }
-            }
-        }
-
-        OHOS::sptr<OH_AVBuffer> object = new (std::nothrow) OH_AVBuffer(buffer);
+        auto &bufferCache = isOutput ? audioCodecObj->outputBufferCache_ : audioCodecObj->inputBufferCache_;
+        OH_AVBuffer *object = bufferCache.FindOrCreate(index, buffer);
         CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVBuffer");
-
-        std::lock_guard<std::shared_mutex> lock(audioCodecObj->memoryObjListMutex_);
-        audioCodecObj->bufferObjList_.push_back(object);
-        return reinterpret_cast<OH_AVBuffer *>(object.GetRefPtr());
+        return object;
     }
     struct OH_AVCodec *codec_;
     struct OH_AVCodecCallback callback_;
@@ -217,10 +213,7 @@ OH_AVErrCode OH_AudioCodec_Destroy(struct OH_AVCodec *codec)
         if (audioCodecObj->callback_ != nullptr) {
             audioCodecObj->callback_->StopCallback();
         }
-        {
-            std::lock_guard<std::shared_mutex> lock(audioCodecObj->memoryObjListMutex_);
-            audioCodecObj->bufferObjList_.clear();
-        }
+        audioCodecObj->ClearBufferList();
         audioCodecObj->isStop_.store(true);
         int32_t ret = audioCodecObj->audioCodec_->Release();
         if (ret != AVCS_ERR_OK) {
@@ -305,8 +298,7 @@ OH_AVErrCode OH_AudioCodec_Stop(struct OH_AVCodec *codec)
         AVCODEC_LOGE("audioCodec Stop failed!, set stop status to false");
         return AVCSErrorToOHAVErrCode(static_cast<AVCodecServiceErrCode>(ret));
     }
-    std::lock_guard<std::shared_mutex> lock(audioCodecObj->memoryObjListMutex_);
-    audioCodecObj->bufferObjList_.clear();
+    audioCodecObj->ClearBufferList();
 
     return AV_ERR_OK;
 }
@@ -332,8 +324,7 @@ OH_AVErrCode OH_AudioCodec_Flush(struct OH_AVCodec *codec)
     audioCodecObj->isFlushed_.store(true);
     audioCodecObj->isFlushing_.store(false);
     AVCODEC_LOGD("set flush status to false");
-    std::lock_guard<std::shared_mutex> lock(audioCodecObj->memoryObjListMutex_);
-    audioCodecObj->bufferObjList_.clear();
+    audioCodecObj->ClearBufferList();
     return AV_ERR_OK;
 }
 
@@ -355,8 +346,7 @@ OH_AVErrCode OH_AudioCodec_Reset(struct OH_AVCodec *codec)
         return AVCSErrorToOHAVErrCode(static_cast<AVCodecServiceErrCode>(ret));
     }
 
-    std::lock_guard<std::shared_mutex> lock(audioCodecObj->memoryObjListMutex_);
-    audioCodecObj->bufferObjList_.clear();
+    audioCodecObj->ClearBufferList();
     return AV_ERR_OK;
 }
 
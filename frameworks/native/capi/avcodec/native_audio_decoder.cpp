@@ -13,7 +13,6 @@
  * limitations under the License.
  */
 
-#include <list>
 #include <mutex>
 #include <shared_mutex>
 #include "avcodec_audio_decoder.h"
@@ -24,6 +23,7 @@
 #include "native_avcodec_audiodecoder.h"
 #include "native_avcodec_base.h"
 #include "native_avmagic.h"
+#include "native_buffer_cache.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_AUDIO, "NativeAudioDecoder"};
@@ -38,14 +38,20 @@ struct AudioDecoderObject : public OH_AVCodec {
         : OH_AVCodec(AVMagic::AVCODEC_MAGIC_AUDIO_DECODER), audioDecoder_(decoder) {}
     ~AudioDecoderObject() = default;
 
+    void ClearBufferList()
+    {
+        inputMemoryCache_.Clear();
+        outputMemoryCache_.Clear();
+    }
+
     const std::shared_ptr<AVCodecAudioDecoder> audioDecoder_;
-    std::list<OHOS::sptr<OH_AVMemory>> memoryObjList_;
+    NativeAVMemoryCache inputMemoryCache_;
+    NativeAVMemoryCache outputMemoryCache_;
     std::shared_ptr<NativeAudioDecoder> callback_ = nullptr;
     std::atomic<bool> isFlushing_ = false;
     std::atomic<bool> isFlushed_ = false;
     std::atomic<bool> isStop_ = false;
     std::atomic<bool> isEOS_ = false;
-    std::shared_mutex memoryObjListMutex_;
 };
 
 class NativeAudioDecoder : public AVCodecCallback {
@@ -130,21 +136,9 @@ private:
         CHECK_AND_RETURN_RET_LOG(audioDecObj->audioDecoder_ != nullptr, nullptr, "audioDecoder_ is nullptr!");
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get input buffer is nullptr!");
 
-        {
-            std::shared_lock<std::shared_mutex> lock(audioDecObj->memoryObjListMutex_);
-            for (auto &memoryObj : audioDecObj->memoryObjList_) {
-                if (memoryObj->IsEqualMemory(memory)) {
-                    return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-                }
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
+        OH_AVMemory *object = audioDecObj->inputMemoryCache_.FindOrCreate(index, memory);
         CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        std::lock_guard<std::shared_mutex> lock(audioDecObj->memoryObjListMutex_);
-        audioDecObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return object;
     }
 
     OH_AVMemory *GetOutputData(struct OH_AVCodec *codec, uint32_t index, std::shared_ptr<AVSharedMemory> memory)
@@ -156,21 +150,9 @@ private:
         CHECK_AND_RETURN_RET_LOG(audioDecObj->audioDecoder_ != nullptr, nullptr, "audioDecoder_ is nullptr!");
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get output buffer is nullptr!");
 
-        {
-            std::shared_lock<std::shared_mutex> lock(audioDecObj->memoryObjListMutex_);
-            for (auto &memoryObj : audioDecObj->memoryObjList_) {
-                if (memoryObj->IsEqualMemory(memory)) {
-                    return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-                }
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
+        OH_AVMemory *object = audioDecObj->outputMemoryCache_.FindOrCreate(index, memory);
         CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        std::lock_guard<std::shared_mutex> lock(audioDecObj->memoryObjListMutex_);
-        audioDecObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return object;
     }
 
     struct OH_AVCodec *codec_;
@@ -225,10 +207,7 @@ OH_AVErrCode OH_AudioDecoder_Destroy(struct OH_AVCodec *codec)
         if (audioDecObj->callback_ != nullptr) {
             audioDecObj->callback_->StopCallback();
         }
-        {
-            std::lock_guard<std::shared_mutex> lock(audioDecObj->memoryObjListMutex_);
-            audioDecObj->memoryObjList_.clear();
-        }
+        audioDecObj->ClearBufferList();
         audioDecObj->isStop_.store(true);
         int32_t ret = audioDecObj->audioDecoder_->Release();
         if (ret != AVCS_ERR_OK) {
@@ -313,8 +292,7 @@ OH_AVErrCode OH_AudioDecoder_Stop(struct OH_AVCodec *codec)
         AVCODEC_LOGE("audioDecoder Stop failed!, set stop status to false");
         return AVCSErrorToOHAVErrCode(static_cast<AVCodecServiceErrCode>(ret));
     }
-    std::lock_guard<std::shared_mutex> lock(audioDecObj->memoryObjListMutex_);
-    audioDecObj->memoryObjList_.clear();
+    audioDecObj->ClearBufferList();
 
     return AV_ERR_OK;
 }
@@ -340,8 +318,7 @@ OH_AVErrCode OH_AudioDecoder_Flush(struct OH_AVCodec *codec)
     audioDecObj->isFlushed_.store(true);
     audioDecObj->isFlushing_.store(false);
     AVCODEC_LOGD("set flush status to false");
-    std::lock_guard<std::shared_mutex> lock(audioDecObj->memoryObjListMutex_);
-    audioDecObj->memoryObjList_.clear();
+    audioDecObj->ClearBufferList();
     return AV_ERR_OK;
 }
 
@@ -363,8 +340,7 @@ OH_AVErrCode OH_AudioDecoder_Reset(struct OH_AVCodec *codec)
         return AVCSErrorToOHAVErrCode(static_cast<AVCodecServiceErrCode>(ret));
     }
 
-    std::lock_guard<std::shared_mutex> lock(audioDecObj->memoryObjListMutex_);
-    audioDecObj->memoryObjList_.clear();
+    audioDecObj->ClearBufferList();
     return AV_ERR_OK;
 }
 
@@ -13,7 +13,6 @@
  * limitations under the License.
  */
 
-#include <list>
 #include <mutex>
 #include <shared_mutex>
 #include "avcodec_audio_encoder.h"
@@ -24,6 +23,7 @@
 #include "native_avcodec_audioencoder.h"
 #include "native_avcodec_base.h"
 #include "native_avmagic.h"
+#include "native_buffer_cache.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_AUDIO, "NativeAudioEncoder"};
@@ -40,14 +40,20 @@ struct AudioEncoderObject : public OH_AVCodec {
     }
     ~AudioEncoderObject() = default;
 
+    void ClearBufferList()
+    {
+        inputMemoryCache_.Clear();
+        outputMemoryCache_.Clear();
+    }
+
     const std::shared_ptr<AVCodecAudioEncoder> audioEncoder_;
-    std::list<OHOS::sptr<OH_AVMemory>> memoryObjList_;
+    NativeAVMemoryCache inputMemoryCache_;
+    NativeAVMemoryCache outputMemoryCache_;
     std::shared_ptr<NativeAudioEncoderCallback> callback_ = nullptr;
     std::atomic<bool> isFlushing_ = false;
     std::atomic<bool> isFlushed_ = false;
     std::atomic<bool> isStop_ = false;
     std::atomic<bool> isEOS_ = false;
-    std::shared_mutex memoryObjListMutex_;
 };
 
 class NativeAudioEncoderCallback : public AVCodecCallback {
@@ -130,21 +136,9 @@ private:
         CHECK_AND_RETURN_RET_LOG(audioEncObj->audioEncoder_ != nullptr, nullptr, "audioEncoder_ is nullptr!");
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get input buffer is nullptr!");
 
-        {
-            std::shared_lock<std::shared_mutex> lock(audioEncObj->memoryObjListMutex_);
-            for (auto &memoryObj : audioEncObj->memoryObjList_) {
-                if (memoryObj->IsEqualMemory(memory)) {
-                    return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-                }
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new (std::nothrow) OH_AVMemory(memory);
+        OH_AVMemory *object = audioEncObj->inputMemoryCache_.FindOrCreate(index, memory);
         CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        std::lock_guard<std::shared_mutex> lock(audioEncObj->memoryObjListMutex_);
-        audioEncObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return object;
     }
 
     OH_AVMemory *GetOutputData(struct OH_AVCodec *codec, uint32_t index, std::shared_ptr<AVSharedMemory> memory)
@@ -156,21 +150,9 @@ private:
         CHECK_AND_RETURN_RET_LOG(audioEncObj->audioEncoder_ != nullptr, nullptr, "audioEncoder_ is nullptr!");
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get output buffer is nullptr!");
 
-        {
-            std::shared_lock<std::shared_mutex> lock(audioEncObj->memoryObjListMutex_);
-            for (auto &memoryObj : audioEncObj->memoryObjList_) {
-                if (memoryObj->IsEqualMemory(memory)) {
-                    return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-                }
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new (std::nothrow) OH_AVMemory(memory);
+        OH_AVMemory *object = audioEncObj->outputMemoryCache_.FindOrCreate(index, memory);
         CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        std::lock_guard<std::shared_mutex> lock(audioEncObj->memoryObjListMutex_);
-        audioEncObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return object;
     }
 
     struct OH_AVCodec *codec_;
@@ -225,10 +207,7 @@ OH_AVErrCode OH_AudioEncoder_Destroy(struct OH_AVCodec *codec)
         if (audioEncObj->callback_ != nullptr) {
             audioEncObj->callback_->StopCallback();
         }
-        {
-            std::lock_guard<std::shared_mutex> lock(audioEncObj->memoryObjListMutex_);
-            audioEncObj->memoryObjList_.clear();
-        }
+        audioEncObj->ClearBufferList();
         int32_t ret = audioEncObj->audioEncoder_->Release();
         if (ret != AVCS_ERR_OK) {
             AVCODEC_LOGE("audioEncoder Release failed!");
@@ -313,8 +292,7 @@ OH_AVErrCode OH_AudioEncoder_Stop(struct OH_AVCodec *codec)
         AVCODEC_LOGE("audioEncoder Stop failed! Set stop status to false");
         return AVCSErrorToOHAVErrCode(static_cast<AVCodecServiceErrCode>(ret));
     }
-    std::lock_guard<std::shared_mutex> lock(audioEncObj->memoryObjListMutex_);
-    audioEncObj->memoryObjList_.clear();
+    audioEncObj->ClearBufferList();
 
     return AV_ERR_OK;
 }
@@ -341,8 +319,7 @@ OH_AVErrCode OH_AudioEncoder_Flush(struct OH_AVCodec *codec)
     audioEncObj->isFlushed_.store(true);
     audioEncObj->isFlushing_.store(false);
     AVCODEC_LOGD("Set flush status to false");
-    std::lock_guard<std::shared_mutex> lock(audioEncObj->memoryObjListMutex_);
-    audioEncObj->memoryObjList_.clear();
+    audioEncObj->ClearBufferList();
     return AV_ERR_OK;
 }
 
@@ -361,8 +338,7 @@ OH_AVErrCode OH_AudioEncoder_Reset(struct OH_AVCodec *codec)
         AVCODEC_LOGE("audioEncoder Reset failed! Set stop status to false");
         return AVCSErrorToOHAVErrCode(static_cast<AVCodecServiceErrCode>(ret));
     }
-    std::lock_guard<std::shared_mutex> lock(audioEncObj->memoryObjListMutex_);
-    audioEncObj->memoryObjList_.clear();
+    audioEncObj->ClearBufferList();
     return AV_ERR_OK;
 }
 
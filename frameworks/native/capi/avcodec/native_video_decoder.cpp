@@ -13,11 +13,8 @@
  * limitations under the License.
  */
 
-#include <list>
 #include <mutex>
-#include <queue>
 #include <shared_mutex>
-#include <unordered_map>
 #include "avcodec_errors.h"
 #include "avcodec_log.h"
 #include "avcodec_trace.h"
@@ -28,6 +25,7 @@
 #include "native_avcodec_base.h"
 #include "native_avcodec_videodecoder.h"
 #include "native_avmagic.h"
+#include "native_buffer_cache.h"
 #include "native_window.h"
 
 #ifdef SUPPORT_DRM
@@ -35,7 +33,6 @@
 #endif
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_FRAMEWORK, "NativeVideoDecoder"};
-constexpr size_t MAX_TEMPNUM = 64;
 
 using namespace OHOS::MediaAVCodec;
 using namespace OHOS::Media;
@@ -51,15 +48,12 @@ struct VideoDecoderObject : public OH_AVCodec {
 
     void ClearBufferList();
     void StopCallback();
-    void BufferToTempFunc(std::unordered_map<uint32_t, OHOS::sptr<OH_AVBuffer>> &tempMap);
-    void MemoryToTempFunc(std::unordered_map<uint32_t, OHOS::sptr<OH_AVMemory>> &tempMap);
 
     const std::shared_ptr<AVCodecVideoDecoder> videoDecoder_;
-    std::queue<OHOS::sptr<MFObjectMagic>> tempList_;
-    std::unordered_map<uint32_t, OHOS::sptr<OH_AVMemory>> outputMemoryMap_;
-    std::unordered_map<uint32_t, OHOS::sptr<OH_AVMemory>> inputMemoryMap_;
-    std::unordered_map<uint32_t, OHOS::sptr<OH_AVBuffer>> outputBufferMap_;
-    std::unordered_map<uint32_t, OHOS::sptr<OH_AVBuffer>> inputBufferMap_;
+    NativeAVMemoryCache outputMemoryCache_;
+    NativeAVMemoryCache inputMemoryCache_;
+    NativeAVBufferCache outputBufferCache_;
+    NativeAVBufferCache inputBufferCache_;
     std::shared_ptr<NativeVideoDecoderCallback> callback_ = nullptr;
     bool isSetMemoryCallback_ = false;
     bool isSetBufferCallback_ = false;
@@ -225,62 +219,20 @@ private:
                               bool isOutput)
     {
         struct VideoDecoderObject *videoDecObj = reinterpret_cast<VideoDecoderObject *>(codec);
-        auto &memoryMap = isOutput ? videoDecObj->outputMemoryMap_ : videoDecObj->inputMemoryMap_;
-        {
-            std::shared_lock<std::shared_mutex> lock(videoDecObj->objListMutex_);
-            auto iter = memoryMap.find(index);
-            if (iter != memoryMap.end() && iter->second->IsEqualMemory(memory)) {
-                return reinterpret_cast<OH_AVMemory *>(iter->second.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new (std::nothrow) OH_AVMemory(memory);
+        auto &memoryCache = isOutput ? videoDecObj->outputMemoryCache_ : videoDecObj->inputMemoryCache_;
+        OH_AVMemory *object = memoryCache.FindOrCreate(index, memory);
         CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "AV memory create failed");
-
-        std::lock_guard<std::shared_mutex> lock(videoDecObj->objListMutex_);
-        auto iterAndRet = memoryMap.emplace(index, object);
-        if (!iterAndRet.second) {
-            auto &temp = iterAndRet.first->second;
-            temp->magic_ = MFMagic::MFMAGIC_UNKNOWN;
-            temp->memory_ = nullptr;
-            videoDecObj->tempList_.push(std::move(temp));
-            iterAndRet.first->second = object;
-            if (videoDecObj->tempList_.size() > MAX_TEMPNUM) {
-                videoDecObj->tempList_.pop();
-            }
-        }
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return object;
     }
 
     OH_AVBuffer *GetTransData(struct OH_AVCodec *codec, uint32_t index, std::shared_ptr<AVBuffer> &buffer,
                               bool isOutput)
     {
         struct VideoDecoderObject *videoDecObj = reinterpret_cast<VideoDecoderObject *>(codec);
-        auto &bufferMap = isOutput ? videoDecObj->outputBufferMap_ : videoDecObj->inputBufferMap_;
-        {
-            std::shared_lock<std::shared_mutex> lock(videoDecObj->objListMutex_);
-            auto iter = bufferMap.find(index);
-            if (iter != bufferMap.end() && iter->second->IsEqualBuffer(buffer)) {
-                return reinterpret_cast<OH_AVBuffer *>(iter->second.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVBuffer> object = new (std::nothrow) OH_AVBuffer(buffer);
+        auto &bufferCache = isOutput ? videoDecObj->outputBufferCache_ : videoDecObj->inputBufferCache_;
+        OH_AVBuffer *object = bufferCache.FindOrCreate(index, buffer);
         CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVBuffer");
-
-        std::lock_guard<std::shared_mutex> lock(videoDecObj->objListMutex_);
-        auto iterAndRet = bufferMap.emplace(index, object);
-        if (!iterAndRet.second) {
-            auto &temp = iterAndRet.first->second;
-            temp->magic_ = MFMagic::MFMAGIC_UNKNOWN;
-            temp->buffer_ = nullptr;
-            videoDecObj->tempList_.push(std::move(temp));
-            iterAndRet.first->second = object;
-            if (videoDecObj->tempList_.size() > MAX_TEMPNUM) {
-                videoDecObj->tempList_.pop();
-            }
-        }
-        return reinterpret_cast<OH_AVBuffer *>(object.GetRefPtr());
+        return object;
     }
 
     struct OH_AVCodec *codec_ = nullptr;
@@ -294,18 +246,11 @@ void VideoDecoderObject::ClearBufferList()
 {
     std::lock_guard<std::shared_mutex> lock(objListMutex_);
     if (isSetBufferCallback_) {
-        BufferToTempFunc(inputBufferMap_);
-        BufferToTempFunc(outputBufferMap_);
-        inputBufferMap_.clear();
-        outputBufferMap_.clear();
+        inputBufferCache_.Clear();
+        outputBufferCache_.Clear();
     } else if (isSetMemoryCallback_) {
-        MemoryToTempFunc(inputMemoryMap_);
-        MemoryToTempFunc(outputMemoryMap_);
-        inputMemoryMap_.clear();
-        outputMemoryMap_.clear();
-    }
-    while (tempList_.size() > MAX_TEMPNUM) {
-        tempList_.pop();
+        inputMemoryCache_.Clear();
+        outputMemoryCache_.Clear();
     }
 }
 
@@ -317,23 +262,6 @@ void VideoDecoderObject::StopCallback()
     callback_->StopCallback();
 }
 
-void VideoDecoderObject::BufferToTempFunc(std::unordered_map<uint32_t, OHOS::sptr<OH_AVBuffer>> &tempMap)
-{
-    for (auto &val : tempMap) {
-        val.second->magic_ = MFMagic::MFMAGIC_UNKNOWN;
-        val.second->buffer_ = nullptr;
-        tempList_.push(std::move(val.second));
-    }
-}
-
-void VideoDecoderObject::MemoryToTempFunc(std::unordered_map<uint32_t, OHOS::sptr<OH_AVMemory>> &tempMap)
-{
-    for (auto &val : tempMap) {
-        val.second->magic_ = MFMagic::MFMAGIC_UNKNOWN;
-        val.second->memory_ = nullptr;
-        tempList_.push(std::move(val.second));
-    }
-}
 } // namespace
 namespace OHOS {
 namespace MediaAVCodec {
@@ -560,10 +488,8 @@ OH_AVErrCode OH_VideoDecoder_PushInputBuffer(struct OH_AVCodec *codec, uint32_t
 
     {
         std::shared_lock<std::shared_mutex> lock(videoDecObj->objListMutex_);
-        auto bufferIter = videoDecObj->inputBufferMap_.find(index);
-        CHECK_AND_RETURN_RET_LOG(bufferIter != videoDecObj->inputBufferMap_.end(), AV_ERR_INVALID_VAL,
-                                 "Invalid buffer index");
-        auto buffer = bufferIter->second->buffer_;
+        std::shared_ptr<AVBuffer> buffer = videoDecObj->inputBufferCache_.FindData(index);
+        CHECK_AND_RETURN_RET_LOG(buffer != nullptr, AV_ERR_INVALID_VAL, "Invalid buffer index");
         if (buffer->flag_ == AVCODEC_BUFFER_FLAG_EOS) {
             videoDecObj->isEOS_.store(true);
             AVCODEC_LOGD("Set eos status to true");
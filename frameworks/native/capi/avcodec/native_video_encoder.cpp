@@ -28,6 +28,7 @@
 #include "native_avcodec_base.h"
 #include "native_avcodec_videoencoder.h"
 #include "native_avmagic.h"
+#include "native_buffer_cache.h"
 #include "native_window.h"
 
 namespace {
@@ -48,16 +49,14 @@ struct VideoEncoderObject : public OH_AVCodec {
     void ClearBufferList();
     void StopCallback();
     void FormatToTempFunc(std::unordered_map<uint32_t, OHOS::sptr<OH_AVFormat>> &tempMap);
-    void BufferToTempFunc(std::unordered_map<uint32_t, OHOS::sptr<OH_AVBuffer>> &tempMap);
-    void MemoryToTempFunc(std::unordered_map<uint32_t, OHOS::sptr<OH_AVMemory>> &tempMap);
 
     const std::shared_ptr<AVCodecVideoEncoder> videoEncoder_;
     std::queue<OHOS::sptr<MFObjectMagic>> tempList_;
     std::unordered_map<uint32_t, OHOS::sptr<OH_AVFormat>> inputFormatMap_;
-    std::unordered_map<uint32_t, OHOS::sptr<OH_AVMemory>> outputMemoryMap_;
-    std::unordered_map<uint32_t, OHOS::sptr<OH_AVMemory>> inputMemoryMap_;
-    std::unordered_map<uint32_t, OHOS::sptr<OH_AVBuffer>> outputBufferMap_;
-    std::unordered_map<uint32_t, OHOS::sptr<OH_AVBuffer>> inputBufferMap_;
+    NativeAVMemoryCache outputMemoryCache_;
+    NativeAVMemoryCache inputMemoryCache_;
+    NativeAVBufferCache outputBufferCache_;
+    NativeAVBufferCache inputBufferCache_;
     std::shared_ptr<NativeVideoEncoderCallback> callback_ = nullptr;
     bool isSetMemoryCallback_ = false;
     bool isSetBufferCallback_ = false;
@@ -249,62 +248,20 @@ private:
                               bool isOutput)
     {
         struct VideoEncoderObject *videoEncObj = reinterpret_cast<VideoEncoderObject *>(codec);
-        auto &memoryMap = isOutput ? videoEncObj->outputMemoryMap_ : videoEncObj->inputMemoryMap_;
-        {
-            std::shared_lock<std::shared_mutex> lock(videoEncObj->objListMutex_);
-            auto iter = memoryMap.find(index);
-            if (iter != memoryMap.end() && iter->second->IsEqualMemory(memory)) {
-                return reinterpret_cast<OH_AVMemory *>(iter->second.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new (std::nothrow) OH_AVMemory(memory);
+        auto &memoryCache = isOutput ? videoEncObj->outputMemoryCache_ : videoEncObj->inputMemoryCache_;
+        OH_AVMemory *object = memoryCache.FindOrCreate(index, memory);
         CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "AV memory create failed");
-
-        std::lock_guard<std::shared_mutex> lock(videoEncObj->objListMutex_);
-        auto iterAndRet = memoryMap.emplace(index, object);
-        if (!iterAndRet.second) {
-            auto &temp = iterAndRet.first->second;
-            temp->magic_ = MFMagic::MFMAGIC_UNKNOWN;
-            temp->memory_ = nullptr;
-            videoEncObj->tempList_.push(std::move(temp));
-            iterAndRet.first->second = object;
-            if (videoEncObj->tempList_.size() > MAX_TEMPNUM) {
-                videoEncObj->tempList_.pop();
-            }
-        }
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return object;
     }
 
     OH_AVBuffer *GetTransData(struct OH_AVCodec *codec, uint32_t index, std::shared_ptr<AVBuffer> &buffer,
                               bool isOutput)
     {
         struct VideoEncoderObject *videoEncObj = reinterpret_cast<VideoEncoderObject *>(codec);
-        auto &bufferMap = isOutput ? videoEncObj->outputBufferMap_ : videoEncObj->inputBufferMap_;
-        {
-            std::shared_lock<std::shared_mutex> lock(videoEncObj->objListMutex_);
-            auto iter = bufferMap.find(index);
-            if (iter != bufferMap.end() && iter->second->IsEqualBuffer(buffer)) {
-                return reinterpret_cast<OH_AVBuffer *>(iter->second.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVBuffer> object = new (std::nothrow) OH_AVBuffer(buffer);
+        auto &bufferCache = isOutput ? videoEncObj->outputBufferCache_ : videoEncObj->inputBufferCache_;
+        OH_AVBuffer *object = bufferCache.FindOrCreate(index, buffer);
         CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVBuffer");
-
-        std::lock_guard<std::shared_mutex> lock(videoEncObj->objListMutex_);
-        auto iterAndRet = bufferMap.emplace(index, object);
-        if (!iterAndRet.second) {
-            auto &temp = iterAndRet.first->second;
-            temp->magic_ = MFMagic::MFMAGIC_UNKNOWN;
-            temp->buffer_ = nullptr;
-            videoEncObj->tempList_.push(std::move(temp));
-            iterAndRet.first->second = object;
-            if (videoEncObj->tempList_.size() > MAX_TEMPNUM) {
-                videoEncObj->tempList_.pop();
-            }
-        }
-        return reinterpret_cast<OH_AVBuffer *>(object.GetRefPtr());
+        return object;
     }
 
     OH_AVFormat *GetTransData(struct OH_AVCodec *codec, uint32_t index, std::shared_ptr<Format> &parameter)
@@ -357,15 +314,11 @@ void VideoEncoderObject::ClearBufferList()
 {
     std::lock_guard<std::shared_mutex> lock(objListMutex_);
     if (isSetBufferCallback_) {
-        BufferToTempFunc(inputBufferMap_);
-        BufferToTempFunc(outputBufferMap_);
-        inputBufferMap_.clear();
-        outputBufferMap_.clear();
+        inputBufferCache_.Clear();
+        outputBufferCache_.Clear();
     } else if (isSetMemoryCallback_) {
-        MemoryToTempFunc(inputMemoryMap_);
-        MemoryToTempFunc(outputMemoryMap_);
-        inputMemoryMap_.clear();
-        outputMemoryMap_.clear();
+        inputMemoryCache_.Clear();
+        outputMemoryCache_.Clear();
     }
     if (inputFormatMap_.size() > 0) {
         FormatToTempFunc(inputFormatMap_);
@@ -400,24 +353,6 @@ void VideoEncoderObject::FormatToTempFunc(std::unordered_map<uint32_t, OHOS::spt
         tempList_.push(std::move(val.second));
     }
 }
-
-void VideoEncoderObject::BufferToTempFunc(std::unordered_map<uint32_t, OHOS::sptr<OH_AVBuffer>> &tempMap)
-{
-    for (auto &val : tempMap) {
-        val.second->magic_ = MFMagic::MFMAGIC_UNKNOWN;
-        val.second->buffer_ = nullptr;
-        tempList_.push(std::move(val.second));
-    }
-}
-
-void VideoEncoderObject::MemoryToTempFunc(std::unordered_map<uint32_t, OHOS::sptr<OH_AVMemory>> &tempMap)
-{
-    for (auto &val : tempMap) {
-        val.second->magic_ = MFMagic::MFMAGIC_UNKNOWN;
-        val.second->memory_ = nullptr;
-        tempList_.push(std::move(val.second));
-    }
-}
 } // namespace
 
 namespace OHOS {
@@ -804,10 +739,8 @@ OH_AVErrCode OH_VideoEncoder_PushInputBuffer(struct OH_AVCodec *codec, uint32_t
 
     {
         std::shared_lock<std::shared_mutex> lock(videoEncObj->objListMutex_);
-        auto bufferIter = videoEncObj->inputBufferMap_.find(index);
-        CHECK_AND_RETURN_RET_LOG(bufferIter != videoEncObj->inputBufferMap_.end(), AV_ERR_INVALID_VAL,
-                                 "Invalid buffer index");
-        auto buffer = bufferIter->second->buffer_;
+        std::shared_ptr<AVBuffer> buffer = videoEncObj->inputBufferCache_.FindData(index);
+        CHECK_AND_RETURN_RET_LOG(buffer != nullptr, AV_ERR_INVALID_VAL, "Invalid buffer index");
         if (buffer->flag_ == AVCODEC_BUFFER_FLAG_EOS) {
             videoEncObj->isEOS_.store(true);
             AVCODEC_LOGD("Set eos status to true");
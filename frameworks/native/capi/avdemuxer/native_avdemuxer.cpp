@@ -232,6 +232,40 @@ OH_AVErrCode OH_AVDemuxer_ReadSampleBuffer(OH_AVDemuxer *demuxer, uint32_t track
     return AV_ERR_OK;
 }
 
+OH_AVErrCode OH_AVDemuxer_ReadSampleBuffers(OH_AVDemuxer *demuxer, uint32_t trackIndex, OH_AVBuffer **samples,
+    uint32_t sampleCount, uint32_t maxBytes, uint32_t *readCount)
+{
+    CHECK_AND_RETURN_RET_LOG(demuxer != nullptr, AV_ERR_INVALID_VAL,
+        "Read samples failed because input demuxer is nullptr!");
+    CHECK_AND_RETURN_RET_LOG(demuxer->magic_ == AVMagic::AVCODEC_MAGIC_AVDEMUXER, AV_ERR_INVALID_VAL, "magic error!");
+
+    CHECK_AND_RETURN_RET_LOG(samples != nullptr && sampleCount > 0, AV_ERR_INVALID_VAL,
+        "Read samples failed because input samples is nullptr!");
+    CHECK_AND_RETURN_RET_LOG(readCount != nullptr, AV_ERR_INVALID_VAL,
+        "Read samples failed because input readCount is nullptr!");
+    *readCount = 0;
+
+    struct DemuxerObject *demuxerObj = reinterpret_cast<DemuxerObject *>(demuxer);
+    CHECK_AND_RETURN_RET_LOG(demuxerObj->demuxer_ != nullptr, AV_ERR_INVALID_VAL,
+        "New DemuxerObject failed when read samples!");
+
+    std::vector<std::shared_ptr<AVBuffer>> buffers;
+    buffers.reserve(sampleCount);
+    for (uint32_t i = 0; i < sampleCount; ++i) {
+        CHECK_AND_RETURN_RET_LOG(samples[i] != nullptr && samples[i]->buffer_ != nullptr, AV_ERR_INVALID_VAL,
+            "Read samples failed because input sample %{public}u is nullptr!", i);
+        buffers.push_back(samples[i]->buffer_);
+    }
+
+    int32_t ret = demuxerObj->demuxer_->ReadSampleBuffers(trackIndex, buffers, maxBytes, *readCount);
+    CHECK_AND_RETURN_RET_LOG(ret != AVCS_ERR_NO_MEMORY, AV_ERR_NO_MEMORY,
+        "demuxer_ ReadSampleBuffers failed! sample size is too small to copy full frame data");
+    CHECK_AND_RETURN_RET_LOG(ret == AVCS_ERR_OK, AVCSErrorToOHAVErrCode(static_cast<AVCodecServiceErrCode>(ret)),
+                             "demuxer_ ReadSampleBuffers failed!");
+
+    return AV_ERR_OK;
+}
+
 OH_AVErrCode OH_AVDemuxer_SeekToTime(OH_AVDemuxer *demuxer, int64_t millisecond, OH_AVSeekMode mode)
 {
     CHECK_AND_RETURN_RET_LOG(demuxer != nullptr, AV_ERR_INVALID_VAL, "Seek failed because input demuxer is nullptr!");
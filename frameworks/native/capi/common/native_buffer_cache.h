@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NATIVE_BUFFER_CACHE_H
+#define NATIVE_BUFFER_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include "buffer/avbuffer.h"
+#include "buffer/avsharedmemory.h"
+#include "common/native_mfmagic.h"
+
+namespace OHOS {
+namespace MediaAVCodec {
+inline void InvalidateNativeObject(OH_AVBuffer &object)
+{
+    object.magic_ = MFMagic::MFMAGIC_UNKNOWN;
+    object.buffer_ = nullptr;
+}
+
+inline void InvalidateNativeObject(OH_AVMemory &object)
+{
+    object.magic_ = MFMagic::MFMAGIC_UNKNOWN;
+    object.memory_ = nullptr;
+}
+
+inline std::shared_ptr<Media::AVBuffer> GetNativeData(const OH_AVBuffer &object)
+{
+    return object.buffer_;
+}
+
+inline std::shared_ptr<Media::AVSharedMemory> GetNativeData(const OH_AVMemory &object)
+{
+    return object.memory_;
+}
+
+/**
+ * Wrappers handed to the app in buffer callbacks, indexed by buffer index.
+ *
+ * Indexes below SLOT_NUM live in a fixed array of atomic slot pointers, a hit is one atomic load and a pointer compare
+ * without any lock. An entry never changes once published, a replacement publishes a new entry and retires the old
+ * one. Retired entries are only freed by Clear, which runs on stop and reset, so a lookup racing a replacement never
+ * touches freed memory. Clear keeps the last MAX_RETIRED_NUM retired wrappers alive, because the app may still hold
+ * them. Indexes beyond the slots fall back to a map under the lock.
+ */
+template <typename Object, typename Data>
+class NativeBufferCache {
+public:
+    static constexpr uint32_t SLOT_NUM = 64;
+    static constexpr size_t MAX_RETIRED_NUM = 64;
+
+    NativeBufferCache() = default;
+    ~NativeBufferCache() = default;
+
+    NativeBufferCache(const NativeBufferCache &) = delete;
+    NativeBufferCache &operator=(const NativeBufferCache &) = delete;
+
+    Object *Find(uint32_t index, const std::shared_ptr<Data> &data) const
+    {
+        if (index < SLOT_NUM) {
+            const Entry *entry = slots_[index].load(std::memory_order_acquire);
+            return (entry != nullptr && entry->key == data.get()) ? entry->object.GetRefPtr() : nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Entry *entry = FindOverflow(index);
+        return (entry != nullptr && entry->key == data.get()) ? entry->object.GetRefPtr() : nullptr;
+    }
+
+    Object *Find(uint32_t index) const
+    {
+        if (index < SLOT_NUM) {
+            const Entry *entry = slots_[index].load(std::memory_order_acquire);
+            return entry != nullptr ? entry->object.GetRefPtr() : nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Entry *entry = FindOverflow(index);
+        return entry != nullptr ? entry->object.GetRefPtr() : nullptr;
+    }
+
+    // the data behind an index, taken from the entry and not the wrapper, which a replacement invalidates midway
+    std::shared_ptr<Data> FindData(uint32_t index) const
+    {
+        if (index < SLOT_NUM) {
+            const Entry *entry = slots_[index].load(std::memory_order_acquire);
+            return entry != nullptr ? entry->data.lock() : nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Entry *entry = FindOverflow(index);
+        return entry != nullptr ? entry->data.lock() : nullptr;
+    }
+
+    Object *FindOrCreate(uint32_t index, const std::shared_ptr<Data> &data)
+    {
+        Object *object = Find(index, data);
+        return object != nullptr ? object : Create(index, data);
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &slot : slots_) {
+            Retire(slot.exchange(nullptr, std::memory_order_acq_rel));
+        }
+        for (auto &val : overflow_) {
+            Retire(val.second);
+        }
+        overflow_.clear();
+        for (auto &entry : entries_) {
+            if (entry != nullptr) {
+                retired_.push(std::move(entry));
+            }
+        }
+        entries_.clear();
+        while (retired_.size() > MAX_RETIRED_NUM) {
+            retired_.pop();
+        }
+    }
+
+private:
+    struct Entry {
+        OHOS::sptr<Object> object;
+        std::weak_ptr<Data> data;
+        const Data *key = nullptr; // the wrapper holds a reference to data, so the address can not be reused
+    };
+
+    Entry *FindOverflow(uint32_t index) const
+    {
+        auto iter = overflow_.find(index);
+        return iter != overflow_.end() ? iter->second : nullptr;
+    }
+
+    Object *Create(uint32_t index, const std::shared_ptr<Data> &data)
+    {
+        std::unique_ptr<Entry> entry(new (std::nothrow) Entry());
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        entry->object = new (std::nothrow) Object(data);
+        if (entry->object == nullptr) {
+            return nullptr;
+        }
+        entry->data = data;
+        entry->key = data.get();
+        Object *object = entry->object.GetRefPtr();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry *current = index < SLOT_NUM ? slots_[index].load(std::memory_order_relaxed) : FindOverflow(index);
+        if (current != nullptr && current->key == data.get()) {
+            return current->object.GetRefPtr(); // created by another callback thread meanwhile
+        }
+        if (index < SLOT_NUM) {
+            slots_[index].store(entry.get(), std::memory_order_release);
+        } else {
+            overflow_[index] = entry.get();
+        }
+        entries_.push_back(std::move(entry));
+        Retire(current);
+        return object;
+    }
+
+    // the entry stays owned by entries_ until Clear, a lookup may still be reading it
+    static void Retire(Entry *entry)
+    {
+        if (entry != nullptr) {
+            InvalidateNativeObject(*entry->object);
+        }
+    }
+
+    std::array<std::atomic<Entry *>, SLOT_NUM> slots_ {};
+    std::unordered_map<uint32_t, Entry *> overflow_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+    std::queue<std::unique_ptr<Entry>> retired_;
+    mutable std::mutex mutex_;
+};
+
+using NativeAVBufferCache = NativeBufferCache<OH_AVBuffer, Media::AVBuffer>;
+using NativeAVMemoryCache = NativeBufferCache<OH_AVMemory, Media::AVSharedMemory>;
+} // namespace MediaAVCodec
+} // namespace OHOS
+#endif // NATIVE_BUFFER_CACHE_H
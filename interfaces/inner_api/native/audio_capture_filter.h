@@ -24,6 +24,7 @@ namespace OHOS {
 namespace Media {
 namespace AudioCaptureModule {
 class AudioCaptureModule;
+struct AudioLevels;
 }
 namespace Pipeline {
 
@@ -60,6 +61,7 @@ public:
         const std::shared_ptr<AudioStandard::AudioCapturerInfoChangeCallback> &callback);
     Status GetCurrentCapturerChangeInfo(AudioStandard::AudioCapturerChangeInfo &changeInfo);
     int32_t GetMaxAmplitude();
+    Status GetAudioLevels(AudioCaptureModule::AudioLevels &levels);
     void SetCallingInfo(int32_t appUid, int32_t appPid, const std::string &bundleName, uint64_t instanceId);
 private:
     void ReadLoop();
@@ -52,6 +52,7 @@ public:
     void SetParameter(const std::shared_ptr<Meta> &parameter) override;
 
     void SetDumpFlag(bool isDump);
+    void SetMemoryBudget(uint64_t budgetId);
 
     void GetParameter(std::shared_ptr<Meta> &parameter) override;
 
@@ -82,6 +82,19 @@ public:
      */
     virtual int32_t ReadSampleBuffer(uint32_t trackIndex, std::shared_ptr<AVBuffer> sample) = 0;
 
+    /**
+     * @brief Retrieve consecutive samples of the selected track in one call, the size and info of each sample
+     * is stored in its buffer.
+     * @param trackIndex Get the samples from this track.
+     * @param samples The AVBuffer handle pointers to get buffer data, filled in order.
+     * @param maxBytes Stop before a sample that would take the total size over maxBytes, 0 means no limit.
+     * @param readCount Number of buffers filled, including the eos buffer.
+     * @return Returns {@link AVCS_ERR_OK} if success; returns an error code otherwise.
+     * @since 5.0
+     */
+    virtual int32_t ReadSampleBuffers(uint32_t trackIndex, const std::vector<std::shared_ptr<AVBuffer>> &samples,
+        uint32_t maxBytes, uint32_t &readCount) = 0;
+
     /**
      * @brief All selected tracks seek near to the requested time according to the seek mode.
      * @param millisecond The timestamp for seeking which is the position relative to the beginning of the file.
@@ -38,6 +38,12 @@ namespace OHOS {
 namespace Media {
 class VideoDecoderAdapter;
 namespace Pipeline {
+struct VideoDropInfo {
+    uint64_t skippedBeforeDecode {0}; // late non reference frames never sent to the decoder
+    uint64_t droppedAfterDecode {0}; // decoded frames released unrendered because they were late
+    int64_t avgDecodeCostUs {0};
+};
+
 class DecoderSurfaceFilter : public Filter, public std::enable_shared_from_this<DecoderSurfaceFilter> {
 public:
     explicit DecoderSurfaceFilter(const std::string& name, FilterType type);
@@ -90,6 +96,7 @@ public:
     void SetCallingInfo(int32_t appUid, int32_t appPid, std::string bundleName, uint64_t instanceId);
 
     Status GetLagInfo(int32_t& lagTimes, int32_t& maxLagDuration, int32_t& avgLagDuration);
+    Status GetLagInfo(int32_t& lagTimes, int32_t& maxLagDuration, int32_t& avgLagDuration, VideoDropInfo& dropInfo);
     void SetBitrateStart();
     void OnOutputFormatChanged(const MediaAVCodec::Format &format);
     Status StartSeekContinous();
@@ -114,6 +121,8 @@ private:
     void RenderNextOutput(uint32_t index, std::shared_ptr<AVBuffer> &outputBuffer);
     Status ReleaseOutputBuffer(int index, bool render, const std::shared_ptr<AVBuffer> &outBuffer, int64_t renderTime);
     bool AcquireNextRenderBuffer(bool byIdx, uint32_t &index, std::shared_ptr<AVBuffer> &outBuffer);
+    bool PopOutputBuffer(std::pair<int, std::shared_ptr<AVBuffer>> &task);
+    int64_t GetRenderSlackUs(int64_t pts);
 
     std::string name_;
     FilterType filterType_;
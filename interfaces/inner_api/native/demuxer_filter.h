@@ -25,6 +25,12 @@
 #include "meta/media_types.h"
 #include "osal/task/mutex.h"
 
+namespace OHOS {
+namespace MediaAVCodec {
+class MemoryBudget;
+} // namespace MediaAVCodec
+} // namespace OHOS
+
 namespace OHOS {
 namespace Media {
 namespace Pipeline {
@@ -53,6 +59,8 @@ public:
     Status SetDataSource(const std::shared_ptr<MediaSource> source);
     Status SetSubtitleSource(const std::shared_ptr<MediaSource> source);
     void SetBundleName(const std::string& bundleName);
+    // Replaces the session MemoryBudget the filter creates for itself, call before SetDataSource
+    void SetMemoryBudget(uint64_t budgetId);
     Status SeekTo(int64_t seekTime, Plugins::SeekMode mode, int64_t& realSeekTime);
 
     Status StartReferenceParser(int64_t startTimeMs, bool isForward = true);
@@ -134,6 +142,8 @@ private:
     std::shared_ptr<MediaDemuxer> demuxer_;
     std::shared_ptr<MediaSource> mediaSource_;
     std::shared_ptr<FilterLinkCallback> onLinkedResultCallback_;
+    // root of the session, shared by the source, the demuxer and the decoders linked after it
+    std::shared_ptr<MediaAVCodec::MemoryBudget> memoryBudget_;
 
     std::map<StreamType, std::vector<int32_t>> track_id_map_;
     Mutex mapMutex_ {};
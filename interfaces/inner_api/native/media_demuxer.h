@@ -78,6 +78,8 @@ public:
     Status SelectTrack(int32_t trackId);
     Status UnselectTrack(int32_t trackId);
     Status ReadSample(uint32_t trackId, std::shared_ptr<AVBuffer> sample);
+    Status ReadSamples(uint32_t trackId, const std::vector<std::shared_ptr<AVBuffer>> &samples, uint32_t maxBytes,
+        uint32_t &readCount);
     Status GetBitRates(std::vector<uint32_t> &bitRates);
     Status SelectBitRate(uint32_t bitRate);
     Status GetDownloadInfo(DownloadInfo& downloadInfo);
@@ -124,6 +126,9 @@ public:
     Status ResumeDemuxerReadLoop();
     Status PauseDemuxerReadLoop();
     void SetCacheLimit(uint32_t limitSize);
+    // Attaches the source cache and the demuxed packets to a session MemoryBudget, call before SetDataSource
+    void SetMemoryBudget(uint64_t budgetId);
+    Status SetKeyFrameOnly(bool keyFrameOnly);
 private:
     class AVBufferQueueProducerListener;
     class TrackWrapper;
@@ -140,6 +145,7 @@ private:
     void InitDefaultTrack(const Plugins::MediaInfo& mediaInfo, uint32_t& videoTrackId,
         uint32_t& audioTrackId, uint32_t& subtitleTrackId, std::string& videoMime);
     bool IsOffsetValid(int64_t offset) const;
+    void ApplyMemoryBudget();
     std::shared_ptr<Meta> GetTrackMeta(uint32_t trackId);
     Status AddDemuxerCopyTask(uint32_t trackId, TaskType type);
 
@@ -186,6 +192,8 @@ private:
     Status CopyFrameToUserQueue(uint32_t trackId);
     bool GetBufferFromUserQueue(uint32_t queueIndex, uint32_t size = 0);
     Status InnerReadSample(uint32_t trackId, std::shared_ptr<AVBuffer>);
+    std::shared_ptr<Plugins::DemuxerPlugin> GetPluginByTrackId(uint32_t trackId, int32_t &innerTrackId);
+    void OnReadSampleResult(uint32_t trackId, Status ret);
     Status InnerSelectTrack(int32_t trackId);
     Status HandleRead(uint32_t trackId);
     int64_t ParserRefInfo();
@@ -227,6 +235,7 @@ private:
     std::shared_ptr<BaseStreamDemuxer> streamDemuxer_;
     std::shared_ptr<BaseStreamDemuxer> subStreamDemuxer_;
     std::string bundleName_ {};
+    uint64_t memoryBudgetId_ {0};
     std::string playerId_;
     bool waitForDataFail_{false};
 
@@ -234,6 +234,12 @@ public:
      */
     static constexpr std::string_view MD_KEY_AUDIO_SAMPLES_PER_FRAME = "audio_samples_per_frame";
 
+    /**
+     * Key for the longest audio an output buffer of a decoder plugin packs, in milliseconds, value type is
+     * int32_t, 0 gives one frame per buffer
+     */
+    static constexpr std::string_view MD_KEY_AUDIO_MAX_OUTPUT_DURATION = "max_output_duration";
+
     /**
      * Key for Number of delayed video frames, value type is uint32_t
      */
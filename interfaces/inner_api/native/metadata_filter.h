@@ -31,6 +31,8 @@
 
 namespace OHOS {
 namespace Media {
+class SurfaceBufferForwarder;
+
 namespace Pipeline {
 class MetaDataFilter : public Filter, public std::enable_shared_from_this<MetaDataFilter> {
 public:
@@ -85,6 +87,7 @@ private:
     sptr<AVBufferQueueProducer> outputBufferQueueProducer_;
 
     sptr<Surface> inputSurface_;
+    std::shared_ptr<SurfaceBufferForwarder> forwarder_;
 
     bool isStop_{false};
     bool refreshTotalPauseTime_{false};
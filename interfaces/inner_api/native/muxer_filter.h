@@ -34,6 +34,7 @@ public:
     ~MuxerFilter() override;
     Status SetOutputParameter(int32_t appUid, int32_t appPid, int32_t fd, int32_t format);
     Status SetTransCoderMode();
+    Status SetFragmentedOutput(int32_t fragmentDurationMs);
     int64_t GetCurrentPtsMs();
     void Init(const std::shared_ptr<EventReceiver> &receiver, const std::shared_ptr<FilterCallback> &callback) override;
     Status DoPrepare() override;
@@ -19,6 +19,7 @@
 #include "common/status.h"
 #include "meta/meta.h"
 #include "sink/media_synchronous_sink.h"
+#include "sink/subtitle_cue_index.h"
 #include "media_sync_manager.h"
 #include "buffer/avbuffer_queue.h"
 #include "buffer/avbuffer_queue_define.h"
@@ -62,9 +63,11 @@ private:
     };
     void NotifyRender(SubtitleInfo &subtitleInfo);
     void RenderLoop();
-    uint64_t CalcWaitTime(SubtitleInfo &subtitleInfo);
-    uint32_t ActionToDo(SubtitleInfo &subtitleInfo);
-    void GetTargetSubtitleIndex(int64_t currentTime);
+    void RenderActiveCues(int64_t curTime);
+    bool IsBeyondLookahead(int64_t pts, int64_t curTime);
+    std::shared_ptr<AVBuffer> TakeHeldBuffer(int64_t curTime);
+    void ClearCues();
+    uint64_t CalcWaitTime(int64_t curTime);
     Status PrepareInputBufferQueue();
     int64_t getDurationUsPlayedAtSampleRate(uint32_t numFrames);
     int64_t GetMediaTime();
@@ -89,14 +92,15 @@ private:
     std::atomic<bool> isThreadExit_{false};
     std::atomic<bool> shouldUpdate_{false};
     float speed_ = 1.0;
-    enum SubtitleBufferState : uint32_t {
-        WAIT,
-        SHOW,
-        DROP,
-    };
-    std::vector<SubtitleInfo> subtitleInfoVec_;
-    uint32_t currentInfoIndex_ = 0;
-    std::atomic<bool> isFlush_ = false;
+    // cues received since the last flush that have not ended yet
+    SubtitleCueIndex cueIndex_;
+    // input buffer of a cue too far ahead of playback, returned once playback gets close so the demuxer waits
+    std::shared_ptr<AVBuffer> heldBuffer_;
+    int64_t heldPts_ {0};
+    std::vector<uint32_t> shownCueIds_;
+    std::vector<const SubtitleCue *> activeCues_;
+    // media time of the boundary the render loop sleeps until, cues starting later need not wake it
+    int64_t nextWakeTime_ {SubtitleCueIndex::NO_BOUNDARY};
     std::vector<std::shared_ptr<AVBuffer>> inputBufferVector_;
 };
 }
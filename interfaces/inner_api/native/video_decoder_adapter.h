@@ -16,7 +16,10 @@
 #ifndef VIDEO_DECODER_ADAPTER_H
 #define VIDEO_DECODER_ADAPTER_H
 
+#include <atomic>
+#include <functional>
 #include <shared_mutex>
+#include <unordered_map>
 #include <vector>
 #include "surface.h"
 #include "avcodec_video_decoder.h"
@@ -68,7 +71,22 @@ public:
     int64_t GetCurrentMillisecond();
     Status GetLagInfo(int32_t& lagTimes, int32_t& maxLagDuration, int32_t& avgLagDuration);
     void ResetRenderTime();
+
+    // Returns how long until the frame of pts is due for rendering, negative when it is already late
+    using RenderSlackQuery = std::function<int64_t(int64_t pts)>;
+    /**
+     * Non reference frames whose render slack is below the average decode cost would miss their render time, they
+     * are handed back to the demuxer without being decoded.
+     */
+    void SetRenderSlackQuery(const RenderSlackQuery &query);
+    int64_t GetDecodeCostUs();
+    uint64_t GetSkippedFrameCount();
 private:
+    bool CanSkipDecode(const std::shared_ptr<AVBuffer> &buffer);
+    void RecordDecodeQueued(uint32_t index, int64_t pts);
+    void RecordDecodeStart(uint32_t index);
+    void RecordDecodeEnd(int64_t pts);
+
     std::shared_ptr<Media::AVBufferQueue> inputBufferQueue_;
     sptr<Media::AVBufferQueueProducer> inputBufferQueueProducer_;
     sptr<Media::AVBufferQueueConsumer> inputBufferQueueConsumer_;
@@ -91,6 +109,13 @@ private:
     int32_t appUid_ = -1;
     int32_t appPid_ = -1;
     std::string bundleName_;
+
+    RenderSlackQuery renderSlackQuery_;
+    std::mutex decodeCostMutex_;
+    std::unordered_map<uint32_t, int64_t> queuedFrames_; // input index to the pts the decoder has not taken yet
+    std::unordered_map<int64_t, int64_t> decodeStartTimes_; // pts to the time the decoder took the frame, in us
+    std::atomic<int64_t> decodeCostUs_ {0};
+    std::atomic<uint64_t> skippedFrameCnt_ {0};
 };
 
 class VideoDecoderCallback : public OHOS::MediaAVCodec::MediaCodecCallback {
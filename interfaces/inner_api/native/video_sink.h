@@ -40,10 +40,13 @@ public:
     void SetSeekFlag();
     void SetLastPts(int64_t lastPts);
     Status SetParameter(const std::shared_ptr<Meta>& meta);
+    // Time left until the frame of pts is due for rendering, INT64_MAX while the render clock is not anchored
+    int64_t GetRenderSlackUs(int64_t pts);
 private:
     float GetSpeed(float speed);
     int64_t refreshTime_ {0};
-    bool isFirstFrame_ {true};
+    // read by GetRenderSlackUs on the decoder input thread
+    std::atomic<bool> isFirstFrame_ {true};
     uint32_t frameRate_ {0};
     int64_t firstFramePts_ {0};
     int64_t firstFrameNowct_ {0};
@@ -57,7 +60,7 @@ private:
     std::atomic<uint64_t> renderFrameCnt_ {0};
     std::atomic<uint64_t> discardFrameCnt_ {0};
     std::shared_ptr<EventReceiver> eventReceiver_ {nullptr};
-    int64_t firstPts_ {HST_TIME_NONE};
+    std::atomic<int64_t> firstPts_ {HST_TIME_NONE};
     int64_t fixDelay_ {0};
     bool seekFlag_{false};
     std::atomic<bool> lastFrameDropped_ {false};
@@ -140,6 +140,31 @@ OH_AVErrCode OH_AVDemuxer_ReadSample(OH_AVDemuxer *demuxer, uint32_t trackIndex,
 OH_AVErrCode OH_AVDemuxer_ReadSampleBuffer(OH_AVDemuxer *demuxer, uint32_t trackIndex,
     OH_AVBuffer *sample);
 
+/**
+ * @brief Get several consecutive encoded samples of the specified track in one call. The track index must be
+ * selected before reading samples. Samples are stored in order, the size, pts and flags of each sample are stored
+ * in the attribute of its buffer. Reading stops when every buffer is filled, before a sample that would take the
+ * total size over maxBytes, after the end of stream buffer, or after a sample that did not fit into its buffer.
+ * @syscap SystemCapability.Multimedia.Media.Spliter
+ * @param demuxer Pointer to an OH_AVDemuxer instance.
+ * @param trackIndex The index of the track from which read encoded samples.
+ * @param samples Array of OH_AVBuffer handle pointers storing the sample data and corresponding attribute.
+ * @param sampleCount Number of buffers in samples.
+ * @param maxBytes Upper bound of the total sample size read by this call, 0 means no limit.
+ * The first sample is always read.
+ * @param readCount Number of buffers filled by this call, including the end of stream buffer.
+ * @return Returns AV_ERR_OK if the execution is successful,
+ * otherwise returns a specific error code, refer to {@link OH_AVErrCode}
+ *          {@link AV_ERR_INVALID_VAL} demuxer is invalid, demuxer is not properly initialized, samples is invalid,
+ *                                     trackIndex is out of range, readCount is nullptr.
+ *          {@link AV_ERR_OPERATE_NOT_PERMIT} trackIndex has not been selected.
+ *          {@link AV_ERR_NO_MEMORY} capability of the last read sample is not enough to store frame data.
+ *          {@link AV_ERR_UNKNOWN} failed to read or parse frame from file.
+ * @since 12
+*/
+OH_AVErrCode OH_AVDemuxer_ReadSampleBuffers(OH_AVDemuxer *demuxer, uint32_t trackIndex, OH_AVBuffer **samples,
+    uint32_t sampleCount, uint32_t maxBytes, uint32_t *readCount);
+
 /**
  * @brief All selected tracks seek near to the requested time according to the seek mode.
  * @syscap SystemCapability.Multimedia.Media.Spliter
@@ -109,6 +109,48 @@ struct DemuxerPlugin : public PluginBase {
      */
     virtual Status ReadSample(uint32_t trackId, std::shared_ptr<AVBuffer> sample) = 0;
 
+    /**
+     * @brief Reads consecutive data frames of one track in a single call.
+     *
+     * The function is valid only after RUNNING state. Frames are stored in samples in order, the size of each
+     * frame is carried by its buffer. Reading stops when every buffer is filled, before a frame that would take
+     * the total size over maxBytes (0 means no limit, the first frame is always read), after the eos buffer, or
+     * after a frame that did not fit into its buffer.
+     *
+     * @param trackId Identifies the media track.
+     * @param samples Buffers where store data frames.
+     * @param maxBytes Upper bound of the total frame size read by this call.
+     * @param readCount Number of buffers filled, including the eos buffer.
+     * @return  Execution Status return
+     *  @retval OK: At least one buffer has been filled, a later error is reported by the next call.
+     */
+    virtual Status ReadSamples(uint32_t trackId, const std::vector<std::shared_ptr<AVBuffer>> &samples,
+        uint32_t maxBytes, uint32_t &readCount)
+    {
+        constexpr uint32_t stopFlags =
+            static_cast<uint32_t>(AVBufferFlag::EOS) | static_cast<uint32_t>(AVBufferFlag::PARTIAL_FRAME);
+        readCount = 0;
+        uint64_t totalBytes = 0;
+        for (const auto &sample : samples) {
+            int32_t nextSize = 0;
+            Status ret = (maxBytes != 0 && readCount > 0) ? GetNextSampleSize(trackId, nextSize) : Status::OK;
+            if ((ret != Status::OK && ret != Status::END_OF_STREAM) ||
+                (maxBytes != 0 && totalBytes + static_cast<uint64_t>(nextSize) > maxBytes)) {
+                break;
+            }
+            ret = ReadSample(trackId, sample);
+            if (ret != Status::OK) {
+                return readCount > 0 ? Status::OK : ret;
+            }
+            ++readCount;
+            totalBytes += static_cast<uint64_t>(sample->memory_->GetSize());
+            if ((sample->flag_ & stopFlags) != 0) {
+                break;
+            }
+        }
+        return Status::OK;
+    }
+
     /**
      * @brief Get next sample size.
      *
@@ -167,6 +209,46 @@ struct DemuxerPlugin : public PluginBase {
         const uint32_t index, uint64_t &relativePresentationTimeUs) = 0;
 
     virtual void SetCacheLimit(uint32_t limitSize) = 0;
+
+    /**
+     * @brief Charges the packets cached by the plugin to the session memory budget with the given id.
+     *
+     * @param budgetId The id of the session MemoryBudget, 0 detaches the plugin from any budget.
+     */
+    virtual void SetMemoryBudget(uint64_t budgetId)
+    {
+        (void)budgetId;
+    }
+
+    /**
+     * @brief Outputs only the key frames of video tracks, for thumbnail and scrubbing workloads.
+     *
+     * Non key frames are skipped before they are cached or converted. A plugin that can locate key frames through
+     * the container index may seek over them without reading them at all. The mode applies to frames read after
+     * the call, seek to drop the frames already cached.
+     *
+     * @param keyFrameOnly Whether the key frame only mode is enabled.
+     * @return  Execution Status return
+     *  @retval OK: The mode has been applied.
+     *  @retval ERROR_INVALID_OPERATION: The plugin does not support the mode.
+     */
+    virtual Status SetKeyFrameOnly(bool keyFrameOnly)
+    {
+        (void)keyFrameOnly;
+        return Status::ERROR_INVALID_OPERATION;
+    }
+
+    /**
+     * @brief Tells whether the data source is a local file or fd, called before SetDataSource.
+     *
+     * A plugin may read a local source through several independent positions, a network source is read in order.
+     *
+     * @param isLocalSource Whether the source is a local file or fd.
+     */
+    virtual void SetLocalSource(bool isLocalSource)
+    {
+        (void)isLocalSource;
+    }
 };
 
 /// Demuxer plugin api major number.
@@ -159,6 +159,9 @@ public:
 
     virtual void SetBundleName(const std::string& bundleName) {}
 
+    // Charges the download cache to the session MemoryBudget with the given id, applies to the next SetSource
+    virtual void SetMemoryBudget(uint64_t budgetId) {}
+
     virtual Status GetDownloadInfo(DownloadInfo& downloadInfo)
     {
         return Status::OK;
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avcodec_latency_stats.h"
+#include <algorithm>
+
+namespace {
+constexpr uint32_t STAGE_NUM = static_cast<uint32_t>(OHOS::MediaAVCodec::LatencyStage::STAGE_BUTT);
+constexpr uint32_t BITS_OF_UINT64 = 64;
+constexpr uint64_t PERCENT_50 = 50;
+constexpr uint64_t PERCENT_99 = 99;
+constexpr uint64_t PERCENT_ALL = 100;
+const char *const STAGE_NAMES[STAGE_NUM] = {"Demux", "Decrypt", "Decode", "Render", "Mux"};
+
+uint32_t GetBucketIndex(uint64_t costUs)
+{
+    if (costUs == 0) {
+        return 0;
+    }
+    uint32_t index = BITS_OF_UINT64 - 1 - static_cast<uint32_t>(__builtin_clzll(costUs));
+    return index < OHOS::MediaAVCodec::LatencySnapshot::BUCKET_NUM ? index :
+        OHOS::MediaAVCodec::LatencySnapshot::BUCKET_NUM - 1;
+}
+
+// upper bound of the bucket that holds the given percentile, in us
+uint64_t GetPercentileUs(const OHOS::MediaAVCodec::LatencySnapshot &snapshot, uint64_t percent)
+{
+    uint64_t target = (snapshot.count * percent + PERCENT_ALL - 1) / PERCENT_ALL;
+    uint64_t accumulated = 0;
+    for (uint32_t i = 0; i < OHOS::MediaAVCodec::LatencySnapshot::BUCKET_NUM; i++) {
+        accumulated += snapshot.buckets[i];
+        if (accumulated >= target) {
+            return i + 1 < OHOS::MediaAVCodec::LatencySnapshot::BUCKET_NUM ?
+                std::min(1ULL << (i + 1), static_cast<unsigned long long>(snapshot.maxUs)) : snapshot.maxUs;
+        }
+    }
+    return snapshot.maxUs;
+}
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+AVCodecLatencyStats &AVCodecLatencyStats::GetInstance()
+{
+    static AVCodecLatencyStats instance;
+    return instance;
+}
+
+void AVCodecLatencyStats::Record(LatencyStage stage, int64_t costUs)
+{
+    uint32_t index = static_cast<uint32_t>(stage);
+    if (index >= STAGE_NUM) {
+        return;
+    }
+    uint64_t cost = costUs > 0 ? static_cast<uint64_t>(costUs) : 0;
+    Histogram &histogram = histograms_[index];
+    histogram.sumUs.fetch_add(cost, std::memory_order_relaxed);
+    histogram.buckets[GetBucketIndex(cost)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t maxUs = histogram.maxUs.load(std::memory_order_relaxed);
+    while (cost > maxUs && !histogram.maxUs.compare_exchange_weak(maxUs, cost, std::memory_order_relaxed)) {
+    }
+}
+
+LatencySnapshot AVCodecLatencyStats::GetSnapshot(LatencyStage stage) const
+{
+    LatencySnapshot snapshot;
+    uint32_t index = static_cast<uint32_t>(stage);
+    if (index >= STAGE_NUM) {
+        return snapshot;
+    }
+    const Histogram &histogram = histograms_[index];
+    for (uint32_t i = 0; i < LatencySnapshot::BUCKET_NUM; i++) {
+        snapshot.buckets[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sumUs = histogram.sumUs.load(std::memory_order_relaxed);
+    snapshot.maxUs = histogram.maxUs.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void AVCodecLatencyStats::Reset()
+{
+    for (auto &histogram : histograms_) {
+        histogram.sumUs.store(0, std::memory_order_relaxed);
+        histogram.maxUs.store(0, std::memory_order_relaxed);
+        for (auto &bucket : histogram.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void AVCodecLatencyStats::GetDumpString(std::string &dumpString) const
+{
+    dumpString += "Latency_Histogram(us)\n";
+    for (uint32_t i = 0; i < STAGE_NUM; i++) {
+        LatencySnapshot snapshot = GetSnapshot(static_cast<LatencyStage>(i));
+        if (snapshot.count == 0) {
+            continue;
+        }
+        dumpString += std::string("    ") + STAGE_NAMES[i] + " - count: " + std::to_string(snapshot.count) +
+            ", avg: " + std::to_string(snapshot.sumUs / snapshot.count) +
+            ", p50: <=" + std::to_string(GetPercentileUs(snapshot, PERCENT_50)) +
+            ", p99: <=" + std::to_string(GetPercentileUs(snapshot, PERCENT_99)) +
+            ", max: " + std::to_string(snapshot.maxUs) + ", buckets:";
+        for (uint32_t j = 0; j < LatencySnapshot::BUCKET_NUM; j++) {
+            dumpString += " " + std::to_string(snapshot.buckets[j]);
+        }
+        dumpString += "\n";
+    }
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
@@ -20,7 +20,18 @@ namespace OHOS {
 namespace MediaAVCodec {
 AVCodecTrace::AVCodecTrace(const std::string& funcName)
 {
-    StartTrace(HITRACE_TAG_ZMEDIA, funcName);
+    if (IsEnabled()) {
+        StartTrace(HITRACE_TAG_ZMEDIA, funcName);
+        isTracing_ = true;
+    }
+}
+
+AVCodecTrace::AVCodecTrace(const char *funcName)
+{
+    if (funcName != nullptr && IsEnabled()) {
+        StartTrace(HITRACE_TAG_ZMEDIA, funcName);
+        isTracing_ = true;
+    }
 }
 
 void AVCodecTrace::TraceBegin(const std::string& funcName, int32_t taskId)
@@ -28,19 +39,47 @@ void AVCodecTrace::TraceBegin(const std::string& funcName, int32_t taskId)
     StartAsyncTrace(HITRACE_TAG_ZMEDIA, funcName, taskId);
 }
 
+void AVCodecTrace::TraceBegin(const char *funcName, int32_t taskId)
+{
+    if (funcName != nullptr && IsEnabled()) {
+        StartAsyncTrace(HITRACE_TAG_ZMEDIA, funcName, taskId);
+    }
+}
+
 void AVCodecTrace::TraceEnd(const std::string& funcName, int32_t taskId)
 {
     FinishAsyncTrace(HITRACE_TAG_ZMEDIA, funcName, taskId);
 }
 
+void AVCodecTrace::TraceEnd(const char *funcName, int32_t taskId)
+{
+    if (funcName != nullptr && IsEnabled()) {
+        FinishAsyncTrace(HITRACE_TAG_ZMEDIA, funcName, taskId);
+    }
+}
+
 void AVCodecTrace::CounterTrace(const std::string& varName, int32_t val)
 {
     CountTrace(HITRACE_TAG_ZMEDIA, varName, val);
 }
 
+void AVCodecTrace::CounterTrace(const char *varName, int32_t val)
+{
+    if (varName != nullptr && IsEnabled()) {
+        CountTrace(HITRACE_TAG_ZMEDIA, varName, val);
+    }
+}
+
+bool AVCodecTrace::IsEnabled()
+{
+    return IsTagEnabled(HITRACE_TAG_ZMEDIA);
+}
+
 AVCodecTrace::~AVCodecTrace()
 {
-    FinishTrace(HITRACE_TAG_ZMEDIA);
+    if (isTracing_) {
+        FinishTrace(HITRACE_TAG_ZMEDIA);
+    }
 }
 } // namespace MediaAVCodec
 } // namespace OHOS
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVCODEC_LATENCY_STATS_H
+#define AVCODEC_LATENCY_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace MediaAVCodec {
+enum class LatencyStage : uint32_t {
+    DEMUX = 0,
+    DECRYPT,
+    DECODE,
+    RENDER,
+    MUX,
+    STAGE_BUTT,
+};
+
+struct LatencySnapshot {
+    static constexpr uint32_t BUCKET_NUM = 21; // bucket i holds [2^i, 2^(i+1)) us, the last one everything above
+    uint64_t count = 0;
+    uint64_t sumUs = 0;
+    uint64_t maxUs = 0;
+    std::array<uint64_t, BUCKET_NUM> buckets {};
+};
+
+/**
+ * Process wide log2 latency histograms per pipeline stage. Recording is a handful of relaxed atomic
+ * adds, so it stays on in production and is read back through the DumpInfo paths.
+ */
+class __attribute__((visibility("default"))) AVCodecLatencyStats : public NoCopyable {
+public:
+    static AVCodecLatencyStats &GetInstance();
+    void Record(LatencyStage stage, int64_t costUs);
+    LatencySnapshot GetSnapshot(LatencyStage stage) const;
+    void Reset();
+    void GetDumpString(std::string &dumpString) const;
+
+private:
+    AVCodecLatencyStats() = default;
+    ~AVCodecLatencyStats() = default;
+
+    struct Histogram {
+        std::atomic<uint64_t> sumUs {0};
+        std::atomic<uint64_t> maxUs {0};
+        std::array<std::atomic<uint64_t>, LatencySnapshot::BUCKET_NUM> buckets {};
+    };
+    std::array<Histogram, static_cast<uint32_t>(LatencyStage::STAGE_BUTT)> histograms_;
+};
+
+// Records the time the scope was alive, minus the time between Pause and Resume, e.g. waits for a free buffer
+class AVCodecLatencyScope : public NoCopyable {
+public:
+    explicit AVCodecLatencyScope(LatencyStage stage) : stage_(stage), begin_(std::chrono::steady_clock::now()) {}
+    ~AVCodecLatencyScope()
+    {
+        Pause();
+        AVCodecLatencyStats::GetInstance().Record(stage_,
+            std::chrono::duration_cast<std::chrono::microseconds>(cost_).count());
+    }
+    void Pause()
+    {
+        if (isRunning_) {
+            cost_ += std::chrono::steady_clock::now() - begin_;
+            isRunning_ = false;
+        }
+    }
+    void Resume()
+    {
+        if (!isRunning_) {
+            begin_ = std::chrono::steady_clock::now();
+            isRunning_ = true;
+        }
+    }
+
+private:
+    LatencyStage stage_;
+    std::chrono::steady_clock::time_point begin_;
+    std::chrono::steady_clock::duration cost_ {0};
+    bool isRunning_ {true};
+};
+} // namespace MediaAVCodec
+} // namespace OHOS
+#endif // AVCODEC_LATENCY_STATS_H
@@ -21,15 +21,27 @@
 
 namespace OHOS {
 namespace MediaAVCodec {
-#define AVCODEC_SYNC_TRACE AVCodecTrace trace(std::string(__FUNCTION__))
+#define AVCODEC_SYNC_TRACE AVCodecTrace trace(__FUNCTION__)
 
+/**
+ * The const char* overloads take string literals or __FUNCTION__ and only build a trace string
+ * when the media trace tag is enabled, so a disabled trace costs a single branch.
+ */
 class __attribute__((visibility("default"))) AVCodecTrace : public NoCopyable {
 public:
     explicit AVCodecTrace(const std::string& funcName);
+    explicit AVCodecTrace(const char *funcName);
     static void TraceBegin(const std::string& funcName, int32_t taskId);
+    static void TraceBegin(const char *funcName, int32_t taskId);
     static void TraceEnd(const std::string& funcName, int32_t taskId);
+    static void TraceEnd(const char *funcName, int32_t taskId);
     static void CounterTrace(const std::string& varName, int32_t val);
+    static void CounterTrace(const char *varName, int32_t val);
+    static bool IsEnabled();
     ~AVCodecTrace();
+
+private:
+    bool isTracing_ = false;
 };
 } // namespace MediaAVCodec
 } // namespace OHOS
@@ -14,8 +14,11 @@
  */
 
 #include "codec_drm_decrypt.h"
+#include <algorithm>
 #include "avcodec_errors.h"
+#include "avcodec_latency_stats.h"
 #include "avcodec_log.h"
+#include "nal_unit_scanner.h"
 #include "securec.h"
 
 namespace {
@@ -25,7 +28,6 @@ constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_FRAMEWORK, "
 namespace OHOS {
 namespace MediaAVCodec {
 
-#define DRM_VIDEO_FRAME_ARR_LEN            3
 #define DRM_AMBIGUITY_ARR_LEN              3
 #define DRM_USER_DATA_REGISTERED_UUID_SIZE 16
 constexpr uint32_t DRM_LEGACY_LEN = 3;
@@ -51,8 +53,10 @@ constexpr uint8_t DRM_AVS_FLAG = 0xb5;
 constexpr uint8_t DRM_USER_DATA_UNREGISTERED_TAG = 0x05;
 constexpr uint32_t DRM_MIN_DRM_INFO_LEN = 2;
 constexpr uint32_t DRM_INVALID_START_POS = 0xffffffff;
+#ifdef SUPPORT_DRM
+constexpr int32_t DRM_CAPABILITY_NOT_SUPPORTED = 801; // 801: capability not supported by the drm module
+#endif
 
-static const uint8_t VIDEO_FRAME_ARR[DRM_VIDEO_FRAME_ARR_LEN] = { 0x00, 0x00, 0x01 };
 static const uint8_t AMBIGUITY_ARR[DRM_AMBIGUITY_ARR_LEN] = { 0x00, 0x00, 0x03 };
 static const uint8_t USER_REGISTERED_UUID[DRM_USER_DATA_REGISTERED_UUID_SIZE] = {
     0x70, 0xc1, 0xdb, 0x9f, 0x66, 0xae, 0x41, 0x27, 0xbf, 0xc0, 0xbb, 0x19, 0x81, 0x69, 0x4b, 0x66
@@ -87,14 +91,9 @@ void CodecDrmDecrypt::DrmGetSkipClearBytes(uint32_t &skipBytes) const
 int32_t CodecDrmDecrypt::DrmGetNalTypeAndIndex(const uint8_t *data, uint32_t dataSize,
     uint8_t &nalType, uint32_t &posIndex) const
 {
-    uint32_t i;
+    uint32_t i = NalUnitScanner::FindStartCode(data, dataSize, posIndex);
     nalType = 0;
-    for (i = posIndex; (i + DRM_LEGACY_LEN) < dataSize; i++) {
-        if ((data[i] != VIDEO_FRAME_ARR[DRM_ARR_SUBSCRIPT_ZERO]) ||
-            (data[i + DRM_ARR_SUBSCRIPT_ONE] != VIDEO_FRAME_ARR[DRM_ARR_SUBSCRIPT_ONE]) ||
-            (data[i + DRM_ARR_SUBSCRIPT_TWO] != VIDEO_FRAME_ARR[DRM_ARR_SUBSCRIPT_TWO])) {
-            continue;
-        }
+    for (; (i + DRM_LEGACY_LEN) < dataSize; i = NalUnitScanner::FindStartCode(data, dataSize, i + 1)) {
         if (codingType_ == DRM_VIDEO_AVC) {
             nalType = data[i + DRM_ARR_SUBSCRIPT_THREE] & DRM_H264_VIDEO_NAL_TYPE_UMASK_NUM;
             if ((nalType == DRM_H264_VIDEO_START_NAL_TYPE) ||
@@ -117,23 +116,16 @@ int32_t CodecDrmDecrypt::DrmGetNalTypeAndIndex(const uint8_t *data, uint32_t dat
             }
         }
     }
-    posIndex = i;
+    if (dataSize > DRM_LEGACY_LEN && posIndex < dataSize - DRM_LEGACY_LEN) {
+        posIndex = dataSize - DRM_LEGACY_LEN;
+    }
     return -1;
 }
 
 void CodecDrmDecrypt::DrmGetSyncHeaderIndex(const uint8_t *data, uint32_t dataSize, uint32_t &posIndex)
 {
-    uint32_t i;
-    for (i = posIndex; (i + DRM_LEGACY_LEN) < dataSize; i++) {
-        if ((data[i] != VIDEO_FRAME_ARR[DRM_ARR_SUBSCRIPT_ZERO]) ||
-            (data[i + DRM_ARR_SUBSCRIPT_ONE] != VIDEO_FRAME_ARR[DRM_ARR_SUBSCRIPT_ONE]) ||
-            (data[i + DRM_ARR_SUBSCRIPT_TWO] != VIDEO_FRAME_ARR[DRM_ARR_SUBSCRIPT_TWO])) {
-            continue;
-        }
-        posIndex = i;
-        return;
-    }
-    posIndex = dataSize;
+    uint32_t i = NalUnitScanner::FindStartCode(data, dataSize, posIndex);
+    posIndex = ((i + DRM_LEGACY_LEN) < dataSize) ? i : dataSize;
     return;
 }
 
@@ -381,27 +373,23 @@ int CodecDrmDecrypt::DrmFindCeiNalUnit(const uint8_t *data, uint32_t dataSize, u
 int CodecDrmDecrypt::DrmFindCeiPos(const uint8_t *data, uint32_t dataSize, uint32_t &ceiStartPos,
     uint32_t &ceiEndPos) const
 {
-    uint32_t i;
-    for (i = 0; (i + DRM_LEGACY_LEN) < dataSize; i++) {
-        /*the start code prefix is 0x000001*/
-        if ((data[i] == VIDEO_FRAME_ARR[DRM_ARR_SUBSCRIPT_ZERO]) &&
-            (data[i + DRM_ARR_SUBSCRIPT_ONE] == VIDEO_FRAME_ARR[DRM_ARR_SUBSCRIPT_ONE]) &&
-            (data[i + DRM_ARR_SUBSCRIPT_TWO] == VIDEO_FRAME_ARR[DRM_ARR_SUBSCRIPT_TWO])) {
-            uint32_t startPos = DRM_INVALID_START_POS;
-            if (ceiStartPos != DRM_INVALID_START_POS) {
-                ceiEndPos = i;
-                AVCODEC_LOGD("cei found, start pos:%{public}x end pos:%{public}x", ceiStartPos, ceiEndPos);
-            }
-            /* found a nal unit, process nal to find the cei.*/
-            if (!DrmFindCeiNalUnit(data, dataSize, startPos, i)) {
-                break;
-            }
-            if (startPos != DRM_INVALID_START_POS) {
-                ceiStartPos = startPos;
-                ceiEndPos = DRM_INVALID_START_POS;
-            }
-            i += DRM_LEGACY_LEN;
+    /*the start code prefix is 0x000001*/
+    uint32_t i = NalUnitScanner::FindStartCode(data, dataSize, 0);
+    for (; (i + DRM_LEGACY_LEN) < dataSize; i = NalUnitScanner::FindStartCode(data, dataSize, i + 1)) {
+        uint32_t startPos = DRM_INVALID_START_POS;
+        if (ceiStartPos != DRM_INVALID_START_POS) {
+            ceiEndPos = i;
+            AVCODEC_LOGD("cei found, start pos:%{public}x end pos:%{public}x", ceiStartPos, ceiEndPos);
+        }
+        /* found a nal unit, process nal to find the cei.*/
+        if (!DrmFindCeiNalUnit(data, dataSize, startPos, i)) {
+            break;
         }
+        if (startPos != DRM_INVALID_START_POS) {
+            ceiStartPos = startPos;
+            ceiEndPos = DRM_INVALID_START_POS;
+        }
+        i += DRM_LEGACY_LEN;
     }
     if ((ceiStartPos != DRM_INVALID_START_POS) && (ceiEndPos != DRM_INVALID_START_POS) &&
         (ceiStartPos < ceiEndPos) && (ceiEndPos <= dataSize)) {
@@ -623,19 +611,13 @@ int32_t CodecDrmDecrypt::DrmVideoCencDecrypt(std::shared_ptr<AVBuffer> &inBuf, s
     return ret;
 }
 
-int32_t CodecDrmDecrypt::DrmAudioCencDecrypt(std::shared_ptr<AVBuffer> &inBuf, std::shared_ptr<AVBuffer> &outBuf,
-    uint32_t &dataSize)
+int32_t CodecDrmDecrypt::GetAudioCencInfo(const std::shared_ptr<AVBuffer> &inBuf, uint32_t dataSize,
+    std::vector<uint8_t> &drmCencVec, MetaDrmCencInfo &clearCencInfo, MetaDrmCencInfo *&cencInfo)
 {
-    AVCODEC_LOGD("DrmAudioCencDecrypt");
-    int32_t ret = AVCS_ERR_UNKNOWN;
-    CHECK_AND_RETURN_RET_LOG((inBuf != nullptr && outBuf != nullptr), ret, "DrmCencDecrypt parameter err");
-    CHECK_AND_RETURN_RET_LOG((inBuf->meta_ != nullptr), ret, "DrmCencDecrypt meta null");
-
-    std::vector<uint8_t> drmCencVec;
-    MetaDrmCencInfo *cencInfo = nullptr;
-    MetaDrmCencInfo clearCencInfo;
     bool res = inBuf->meta_->GetData(Media::Tag::DRM_CENC_INFO, drmCencVec);
     if (res) {
+        CHECK_AND_RETURN_RET_LOG(drmCencVec.size() >= sizeof(MetaDrmCencInfo), AVCS_ERR_INVALID_VAL,
+            "DrmCencDecrypt cenc info err");
         cencInfo = reinterpret_cast<MetaDrmCencInfo *>(&drmCencVec[0]);
         if (cencInfo->algo == MetaDrmCencAlgorithm::META_DRM_ALG_CENC_UNENCRYPTED) {
             cencInfo->subSampleNum = 1;
@@ -653,25 +635,150 @@ int32_t CodecDrmDecrypt::DrmAudioCencDecrypt(std::shared_ptr<AVBuffer> &inBuf, s
                 cencInfo->algo == MetaDrmCencAlgorithm::META_DRM_ALG_CENC_SM4_CBC) {
                 cencInfo->subSampleNum = 2; // 2: subSampleNum
                 cencInfo->subSamples[0].clearHeaderLen = 0;
-                cencInfo->subSamples[0].payLoadLen = (dataSize / 16) * 16; // 16: BlockSize
-                cencInfo->subSamples[1].clearHeaderLen = dataSize % 16; // 16: BlockSize
+                cencInfo->subSamples[0].payLoadLen = (dataSize / DRM_AES_BLOCK_SIZE) * DRM_AES_BLOCK_SIZE;
+                cencInfo->subSamples[1].clearHeaderLen = dataSize % DRM_AES_BLOCK_SIZE;
                 cencInfo->subSamples[1].payLoadLen = 0;
             }
         }
     } else {
         errno_t errCode = memset_s(&clearCencInfo, sizeof(MetaDrmCencInfo), 0, sizeof(MetaDrmCencInfo));
-        CHECK_AND_RETURN_RET_LOG(errCode == EOK, ret, "memset cenc info err");
+        CHECK_AND_RETURN_RET_LOG(errCode == EOK, AVCS_ERR_UNKNOWN, "memset cenc info err");
         clearCencInfo.algo = MetaDrmCencAlgorithm::META_DRM_ALG_CENC_UNENCRYPTED;
         clearCencInfo.subSampleNum = 1;
         clearCencInfo.subSamples[0].clearHeaderLen = dataSize;
         clearCencInfo.subSamples[0].payLoadLen = 0;
-        cencInfo = reinterpret_cast<MetaDrmCencInfo *>(&clearCencInfo);
+        cencInfo = &clearCencInfo;
     }
+    return AVCS_ERR_OK;
+}
+
+int32_t CodecDrmDecrypt::DrmAudioCencDecrypt(std::shared_ptr<AVBuffer> &inBuf, std::shared_ptr<AVBuffer> &outBuf,
+    uint32_t &dataSize)
+{
+    AVCODEC_LOGD("DrmAudioCencDecrypt");
+    int32_t ret = AVCS_ERR_UNKNOWN;
+    CHECK_AND_RETURN_RET_LOG((inBuf != nullptr && outBuf != nullptr), ret, "DrmCencDecrypt parameter err");
+    CHECK_AND_RETURN_RET_LOG((inBuf->meta_ != nullptr), ret, "DrmCencDecrypt meta null");
+
+    std::vector<uint8_t> drmCencVec;
+    MetaDrmCencInfo *cencInfo = nullptr;
+    MetaDrmCencInfo clearCencInfo;
+    ret = GetAudioCencInfo(inBuf, dataSize, drmCencVec, clearCencInfo, cencInfo);
+    CHECK_AND_RETURN_RET_LOG(ret == AVCS_ERR_OK, ret, "DrmCencDecrypt get cenc info failed");
     ret = DecryptMediaData(cencInfo, inBuf, outBuf);
 
     return ret;
 }
 
+int32_t CodecDrmDecrypt::DrmAudioCencDecryptBatch(std::vector<DrmDecryptTask> &tasks)
+{
+    AVCODEC_LOGD("DrmAudioCencDecryptBatch, size:%{public}zu", tasks.size());
+    std::lock_guard<std::mutex> drmLock(configMutex_);
+    DrmCryptInfo cryptInfo;
+    std::vector<uint8_t> drmCencVec;
+    MetaDrmCencInfo clearCencInfo;
+    for (auto &task : tasks) {
+        CHECK_AND_RETURN_RET_LOG((task.inBuf != nullptr && task.outBuf != nullptr && task.inBuf->meta_ != nullptr),
+            AVCS_ERR_UNKNOWN, "DrmCencDecrypt parameter err");
+        MetaDrmCencInfo *cencInfo = nullptr;
+        int32_t ret = GetAudioCencInfo(task.inBuf, task.dataSize, drmCencVec, clearCencInfo, cencInfo);
+        CHECK_AND_RETURN_RET_LOG(ret == AVCS_ERR_OK, ret, "DrmCencDecrypt get cenc info failed");
+        if (cencInfo->algo == MetaDrmCencAlgorithm::META_DRM_ALG_CENC_UNENCRYPTED && svpFlag_ != SVP_TRUE) {
+            // a clear sample needs no key session round trip, only the copy the session would have done
+            ret = CopyClearSample(task);
+        } else if (task.inBuf == task.outBuf) {
+            ret = DecryptInPlace(cencInfo, cryptInfo, task);
+        } else {
+            ret = DecryptSample(cencInfo, cryptInfo, task.inBuf, task.outBuf);
+        }
+        CHECK_AND_RETURN_RET_LOG(ret == AVCS_ERR_OK, ret, "DrmCencDecrypt batch failed");
+    }
+    return AVCS_ERR_OK;
+}
+
+int32_t CodecDrmDecrypt::DecryptInPlace(const MetaDrmCencInfo * const cencInfo, DrmCryptInfo &cryptInfo,
+    DrmDecryptTask &task)
+{
+    InPlaceSupport support = inPlaceSupport_;
+    if (support == InPlaceSupport::SUPPORTED) {
+        return DecryptSample(cencInfo, cryptInfo, task.inBuf, task.outBuf);
+    }
+    CHECK_AND_RETURN_RET_LOG((task.inBuf->memory_ != nullptr &&
+        task.inBuf->memory_->GetCapacity() >= static_cast<int32_t>(task.dataSize)),
+        AVCS_ERR_NO_MEMORY, "DecryptInPlace sample memory err");
+    std::shared_ptr<AVAllocator> avAllocator = AVAllocatorFactory::CreateSharedAllocator(MEMORY_READ_WRITE);
+    CHECK_AND_RETURN_RET_LOG(avAllocator != nullptr, AVCS_ERR_NO_MEMORY, "DecryptInPlace allocator null");
+    std::shared_ptr<AVBuffer> outBuf = AVBuffer::CreateAVBuffer(avAllocator, static_cast<int32_t>(task.dataSize));
+    CHECK_AND_RETURN_RET_LOG((outBuf != nullptr && outBuf->memory_ != nullptr), AVCS_ERR_NO_MEMORY,
+        "DecryptInPlace out buffer null");
+    outBuf->memory_->SetSize(static_cast<int32_t>(task.dataSize));
+    int32_t ret = AVCS_ERR_OK;
+    if (support == InPlaceSupport::UNKNOWN) {
+        // a failed attempt may leave the sample half written, so the ciphertext is kept aside until one succeeded
+        ret = CopySampleData(outBuf, task.inBuf, task.dataSize);
+        CHECK_AND_RETURN_RET_LOG(ret == AVCS_ERR_OK, ret, "DecryptInPlace keep sample failed");
+        ret = DecryptSample(cencInfo, cryptInfo, task.inBuf, task.outBuf);
+        if (ret == AVCS_ERR_OK) {
+            inPlaceSupport_ = InPlaceSupport::SUPPORTED;
+            return ret;
+        }
+        int32_t restoreRet = CopySampleData(task.inBuf, outBuf, task.dataSize);
+        CHECK_AND_RETURN_RET_LOG(restoreRet == AVCS_ERR_OK, restoreRet, "DecryptInPlace restore sample failed");
+        // only a module that refuses in-place buffers is ruled out, any other error may pass on the next sample
+        CHECK_AND_RETURN_RET_LOG(ret == AVCS_ERR_UNSUPPORT, ret, "DecryptInPlace failed");
+        AVCODEC_LOGW("decrypt module rejected in-place decryption, falling back to the copy path");
+        inPlaceSupport_ = InPlaceSupport::UNSUPPORTED;
+    }
+    ret = DecryptSample(cencInfo, cryptInfo, task.inBuf, outBuf);
+    CHECK_AND_RETURN_RET_LOG(ret == AVCS_ERR_OK, ret, "DecryptInPlace copy path failed");
+    return CopySampleData(task.inBuf, outBuf, task.dataSize);
+}
+
+int32_t CodecDrmDecrypt::CopySampleData(const std::shared_ptr<AVBuffer> &dst, const std::shared_ptr<AVBuffer> &src,
+    uint32_t dataSize)
+{
+    errno_t errCode = memcpy_s(dst->memory_->GetAddr(), dst->memory_->GetCapacity(),
+        src->memory_->GetAddr(), dataSize);
+    CHECK_AND_RETURN_RET_LOG(errCode == EOK, AVCS_ERR_UNKNOWN, "CopySampleData memcpy err");
+    return AVCS_ERR_OK;
+}
+
+int32_t CodecDrmDecrypt::CopyClearSample(const DrmDecryptTask &task)
+{
+    if (task.inBuf == task.outBuf) {
+        return AVCS_ERR_OK;
+    }
+    CHECK_AND_RETURN_RET_LOG((task.inBuf->memory_ != nullptr && task.outBuf->memory_ != nullptr),
+        AVCS_ERR_NO_MEMORY, "CopyClearSample memory_ null");
+    CHECK_AND_RETURN_RET_LOG(task.outBuf->memory_->GetCapacity() >= static_cast<int32_t>(task.dataSize),
+        AVCS_ERR_NO_MEMORY, "CopyClearSample out buffer too small");
+    return CopySampleData(task.outBuf, task.inBuf, task.dataSize);
+}
+
+bool CodecDrmDecrypt::CanDecryptInPlace(const std::shared_ptr<AVBuffer> &buffer) const
+{
+    // the decrypt module reads and writes the same fd backed buffer, secure buffers always need a separate output
+    return inPlaceSupport_ != InPlaceSupport::UNSUPPORTED && svpFlag_ != SVP_TRUE && buffer != nullptr &&
+        buffer->memory_ != nullptr && buffer->memory_->GetMemoryType() == MemoryType::SHARED_MEMORY &&
+        buffer->memory_->GetFileDescriptor() >= 0;
+}
+
+bool CodecDrmDecrypt::NeedsDecryption(const std::shared_ptr<AVBuffer> &buffer) const
+{
+    if (svpFlag_ == SVP_TRUE || buffer == nullptr || buffer->meta_ == nullptr) {
+        return true;
+    }
+    std::vector<uint8_t> drmCencVec;
+    if (!buffer->meta_->GetData(Media::Tag::DRM_CENC_INFO, drmCencVec)) {
+        return false;
+    }
+    if (drmCencVec.size() < sizeof(MetaDrmCencInfo)) {
+        return true;
+    }
+    auto cencInfo = reinterpret_cast<const MetaDrmCencInfo *>(drmCencVec.data());
+    return cencInfo->algo != MetaDrmCencAlgorithm::META_DRM_ALG_CENC_UNENCRYPTED;
+}
+
 void CodecDrmDecrypt::SetCodecName(const std::string &codecName)
 {
     codecName_ = codecName;
@@ -700,6 +807,7 @@ void CodecDrmDecrypt::SetDecryptionConfig(const sptr<DrmStandard::IMediaKeySessi
         svpFlag_ = SVP_FALSE;
     }
     mode_ = MetaDrmCencInfoMode::META_DRM_CENC_INFO_KEY_IV_SUBSAMPLES_SET;
+    inPlaceSupport_ = InPlaceSupport::UNKNOWN;
     CHECK_AND_RETURN_LOG((keySession != nullptr), "SetDecryptConfig keySession nullptr");
     keySessionServiceProxy_ = keySession;
     CHECK_AND_RETURN_LOG((keySessionServiceProxy_ != nullptr), "SetDecryptConfig keySessionServiceProxy nullptr");
@@ -735,41 +843,70 @@ int32_t CodecDrmDecrypt::SetDrmBuffer(const std::shared_ptr<AVBuffer> &inBuf,
     return AVCS_ERR_OK;
 }
 
-int32_t CodecDrmDecrypt::DecryptMediaData(const MetaDrmCencInfo * const cencInfo, std::shared_ptr<AVBuffer> &inBuf,
-    std::shared_ptr<AVBuffer> &outBuf)
+int32_t CodecDrmDecrypt::FillCryptInfo(const MetaDrmCencInfo * const cencInfo, DrmCryptInfo &cryptInfo)
 {
-    AVCODEC_LOGI("CodecDrmDecrypt DecryptMediaData");
-#ifdef SUPPORT_DRM
-    std::lock_guard<std::mutex> drmLock(configMutex_);
-    int32_t retCode = AVCS_ERR_INVALID_VAL;
-    DrmStandard::IMediaDecryptModuleService::CryptInfo cryptInfo;
     CHECK_AND_RETURN_RET_LOG(((cencInfo->keyIdLen <= static_cast<uint32_t>(META_DRM_KEY_ID_SIZE)) &&
         (cencInfo->ivLen <= static_cast<uint32_t>(META_DRM_IV_SIZE)) &&
-        (cencInfo->subSampleNum <= static_cast<uint32_t>(META_DRM_MAX_SUB_SAMPLE_NUM))), retCode, "parameter err");
+        (cencInfo->subSampleNum <= static_cast<uint32_t>(META_DRM_MAX_SUB_SAMPLE_NUM))), AVCS_ERR_INVALID_VAL,
+        "parameter err");
     cryptInfo.type = static_cast<DrmStandard::IMediaDecryptModuleService::CryptAlgorithmType>(cencInfo->algo);
-    std::vector<uint8_t> keyIdVector(cencInfo->keyId, cencInfo->keyId + cencInfo->keyIdLen);
-    cryptInfo.keyId = keyIdVector;
-    std::vector<uint8_t> ivVector(cencInfo->iv, cencInfo->iv + cencInfo->ivLen);
-    cryptInfo.iv = ivVector;
+    // consecutive samples of one track almost always share the key, keep the vector instead of rebuilding it
+    if (cryptInfo.keyId.size() != cencInfo->keyIdLen ||
+        !std::equal(cryptInfo.keyId.begin(), cryptInfo.keyId.end(), cencInfo->keyId)) {
+        cryptInfo.keyId.assign(cencInfo->keyId, cencInfo->keyId + cencInfo->keyIdLen);
+    }
+    cryptInfo.iv.assign(cencInfo->iv, cencInfo->iv + cencInfo->ivLen);
     cryptInfo.pattern.encryptBlocks = cencInfo->encryptBlocks;
     cryptInfo.pattern.skipBlocks = cencInfo->skipBlocks;
-
+    cryptInfo.subSample.clear();
     for (uint32_t i = 0; i < cencInfo->subSampleNum; i++) {
         DrmStandard::IMediaDecryptModuleService::SubSample temp({ cencInfo->subSamples[i].clearHeaderLen,
             cencInfo->subSamples[i].payLoadLen });
         cryptInfo.subSample.emplace_back(temp);
     }
+    return AVCS_ERR_OK;
+}
 
+int32_t CodecDrmDecrypt::DecryptSample(const MetaDrmCencInfo * const cencInfo, DrmCryptInfo &cryptInfo,
+    std::shared_ptr<AVBuffer> &inBuf, std::shared_ptr<AVBuffer> &outBuf)
+{
+    int32_t retCode = FillCryptInfo(cencInfo, cryptInfo);
+    CHECK_AND_RETURN_RET_LOG((retCode == AVCS_ERR_OK), retCode, "DecryptSample fill crypt info failed");
     DrmBuffer inDrmBuffer;
     DrmBuffer outDrmBuffer;
     retCode = SetDrmBuffer(inBuf, outBuf, inDrmBuffer, outDrmBuffer);
     CHECK_AND_RETURN_RET_LOG((retCode == AVCS_ERR_OK), retCode, "SetDecryptConfig failed cause SetDrmBuffer failed");
-    retCode = AVCS_ERR_INVALID_VAL;
-    CHECK_AND_RETURN_RET_LOG((decryptModuleProxy_ != nullptr), retCode,
+    AVCodecLatencyScope latency(LatencyStage::DECRYPT);
+    return DecryptByModule(cryptInfo, inDrmBuffer, outDrmBuffer);
+}
+
+int32_t CodecDrmDecrypt::DecryptByModule(const DrmCryptInfo &cryptInfo, DrmBuffer &inDrmBuffer,
+    DrmBuffer &outDrmBuffer)
+{
+#ifdef SUPPORT_DRM
+    CHECK_AND_RETURN_RET_LOG((decryptModuleProxy_ != nullptr), AVCS_ERR_INVALID_VAL,
         "SetDecryptConfig decryptModuleProxy_ nullptr");
-    retCode = decryptModuleProxy_->DecryptMediaData(svpFlag_, cryptInfo, inDrmBuffer, outDrmBuffer);
+    int32_t retCode = decryptModuleProxy_->DecryptMediaData(svpFlag_, cryptInfo, inDrmBuffer, outDrmBuffer);
+    CHECK_AND_RETURN_RET_LOG((retCode != DRM_CAPABILITY_NOT_SUPPORTED), AVCS_ERR_UNSUPPORT,
+        "CodecDrmDecrypt decrypt not supported!");
     CHECK_AND_RETURN_RET_LOG((retCode == 0), AVCS_ERR_UNKNOWN, "CodecDrmDecrypt decrypt failed!");
     return AVCS_ERR_OK;
+#else
+    (void)cryptInfo;
+    (void)inDrmBuffer;
+    (void)outDrmBuffer;
+    return AVCS_ERR_OK;
+#endif
+}
+
+int32_t CodecDrmDecrypt::DecryptMediaData(const MetaDrmCencInfo * const cencInfo, std::shared_ptr<AVBuffer> &inBuf,
+    std::shared_ptr<AVBuffer> &outBuf)
+{
+    AVCODEC_LOGI("CodecDrmDecrypt DecryptMediaData");
+#ifdef SUPPORT_DRM
+    std::lock_guard<std::mutex> drmLock(configMutex_);
+    DrmCryptInfo cryptInfo;
+    return DecryptSample(cencInfo, cryptInfo, inBuf, outBuf);
 #else
     (void)cencInfo;
     (void)inBuf;
@@ -16,7 +16,9 @@
 #ifndef CODEC_DRM_DECRYPT_H
 #define CODEC_DRM_DECRYPT_H
 
+#include <atomic>
 #include <mutex>
+#include <vector>
 #include "buffer/avbuffer.h"
 #include "meta/meta.h"
 #include "foundation/multimedia/drm_framework/services/drm_service/ipc/i_keysession_service.h"
@@ -31,6 +33,7 @@ using MetaDrmCencInfo = Plugins::MetaDrmCencInfo;
 using MetaDrmCencAlgorithm = Plugins::MetaDrmCencAlgorithm;
 using MetaDrmCencInfoMode = Plugins::MetaDrmCencInfoMode;
 using DrmBuffer = DrmStandard::IMediaDecryptModuleService::DrmBuffer;
+using DrmCryptInfo = DrmStandard::IMediaDecryptModuleService::CryptInfo;
 
 enum SvpMode : int32_t {
     SVP_CLEAR = -1, /* it's not a protection video */
@@ -38,16 +41,35 @@ enum SvpMode : int32_t {
     SVP_TRUE, /* it's a protection video and need secure decoder */
 };
 
+struct DrmDecryptTask {
+    std::shared_ptr<AVBuffer> inBuf;
+    std::shared_ptr<AVBuffer> outBuf; // the same buffer as inBuf for in-place decryption
+    uint32_t dataSize = 0;
+};
+
 class CodecDrmDecrypt {
 public:
+    virtual ~CodecDrmDecrypt() = default;
     int32_t DrmVideoCencDecrypt(std::shared_ptr<AVBuffer> &inBuf, std::shared_ptr<AVBuffer> &outBuf,
         uint32_t &dataSize);
     int32_t DrmAudioCencDecrypt(std::shared_ptr<AVBuffer> &inBuf, std::shared_ptr<AVBuffer> &outBuf,
         uint32_t &dataSize);
+    /**
+     * Decrypts pending audio samples under one session lock, reusing the crypt info between samples of the
+     * same key. Clear samples of a non secure session skip the decrypt module.
+     */
+    int32_t DrmAudioCencDecryptBatch(std::vector<DrmDecryptTask> &tasks);
+    // false once the decrypt module of the session rejected a buffer that is both input and output
+    bool CanDecryptInPlace(const std::shared_ptr<AVBuffer> &buffer) const;
+    // a clear sample of a non secure session is passed to the decoder as it is, no copy and no decryption
+    bool NeedsDecryption(const std::shared_ptr<AVBuffer> &buffer) const;
     void SetCodecName(const std::string &codecName);
     void SetDecryptionConfig(const sptr<DrmStandard::IMediaKeySessionService> &keySession,
         const bool svpFlag);
 
+protected:
+    virtual int32_t DecryptByModule(const DrmCryptInfo &cryptInfo, DrmBuffer &inDrmBuffer, DrmBuffer &outDrmBuffer);
+
 private:
     void GetCodingType();
     void DrmGetSkipClearBytes(uint32_t &skipBytes) const;
@@ -75,10 +97,25 @@ private:
         MetaDrmCencInfo *cencInfo) const;
     int32_t DecryptMediaData(const MetaDrmCencInfo * const cencInfo, std::shared_ptr<AVBuffer> &inBuf,
         std::shared_ptr<AVBuffer> &outBuf);
+    static int32_t GetAudioCencInfo(const std::shared_ptr<AVBuffer> &inBuf, uint32_t dataSize,
+        std::vector<uint8_t> &drmCencVec, MetaDrmCencInfo &clearCencInfo, MetaDrmCencInfo *&cencInfo);
+    static int32_t FillCryptInfo(const MetaDrmCencInfo * const cencInfo, DrmCryptInfo &cryptInfo);
+    int32_t DecryptSample(const MetaDrmCencInfo * const cencInfo, DrmCryptInfo &cryptInfo,
+        std::shared_ptr<AVBuffer> &inBuf, std::shared_ptr<AVBuffer> &outBuf);
+    int32_t DecryptInPlace(const MetaDrmCencInfo * const cencInfo, DrmCryptInfo &cryptInfo, DrmDecryptTask &task);
+    static int32_t CopyClearSample(const DrmDecryptTask &task);
+    static int32_t CopySampleData(const std::shared_ptr<AVBuffer> &dst, const std::shared_ptr<AVBuffer> &src,
+        uint32_t dataSize);
     static int32_t SetDrmBuffer(const std::shared_ptr<AVBuffer> &inBuf, const std::shared_ptr<AVBuffer> &outBuf,
         DrmBuffer &inDrmBuffer, DrmBuffer &outDrmBuffer);
 
 private:
+    enum class InPlaceSupport : int32_t {
+        UNKNOWN,
+        SUPPORTED,
+        UNSUPPORTED,
+    };
+
     std::mutex configMutex_;
     std::string codecName_;
     int32_t codingType_ = 0;
@@ -86,6 +123,8 @@ private:
     sptr<DrmStandard::IMediaDecryptModuleService> decryptModuleProxy_;
     int32_t svpFlag_ = SVP_CLEAR;
     MetaDrmCencInfoMode mode_ = MetaDrmCencInfoMode::META_DRM_CENC_INFO_KEY_IV_SUBSAMPLES_SET;
+    // the decrypt module has no capability query, the first in-place decryption of a session answers it
+    std::atomic<InPlaceSupport> inPlaceSupport_ {InPlaceSupport::UNKNOWN};
 };
 
 } // namespace MediaAVCodec
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_buffer_free_list.h"
+#include <thread>
+
+namespace OHOS {
+namespace MediaAVCodec {
+namespace {
+uint64_t RoundUpPowerOfTwo(uint32_t value)
+{
+    uint64_t size = 1;
+    while (size < value) {
+        size <<= 1;
+    }
+    return size;
+}
+} // namespace
+
+AudioBufferFreeList::AudioBufferFreeList(uint32_t capacity)
+    : mask_(RoundUpPowerOfTwo(capacity) - 1), slots_(std::make_unique<Slot[]>(mask_ + 1))
+{
+    Clear();
+}
+
+bool AudioBufferFreeList::Push(uint32_t index) noexcept
+{
+    uint64_t pos = pushPos_.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    while (true) {
+        slot = &slots_[pos & mask_];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence - pos);
+        if (diff == 0) {
+            if (pushPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // the slot still waits for a consumer that claimed it and got preempted, only full when it really is
+            if (pos - popPos_.load(std::memory_order_relaxed) > mask_) {
+                return false;
+            }
+            std::this_thread::yield();
+            pos = pushPos_.load(std::memory_order_relaxed);
+        } else {
+            pos = pushPos_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->index = index;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool AudioBufferFreeList::Pop(uint32_t &index) noexcept
+{
+    uint64_t pos = popPos_.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    while (true) {
+        slot = &slots_[pos & mask_];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence - (pos + 1));
+        if (diff == 0) {
+            if (popPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = popPos_.load(std::memory_order_relaxed);
+        }
+    }
+    index = slot->index;
+    slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+}
+
+bool AudioBufferFreeList::Empty() const noexcept
+{
+    return popPos_.load() >= pushPos_.load();
+}
+
+uint32_t AudioBufferFreeList::Capacity() const noexcept
+{
+    return static_cast<uint32_t>(mask_ + 1);
+}
+
+void AudioBufferFreeList::Clear() noexcept
+{
+    for (uint64_t i = 0; i <= mask_; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    pushPos_.store(0, std::memory_order_relaxed);
+    popPos_.store(0, std::memory_order_release);
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
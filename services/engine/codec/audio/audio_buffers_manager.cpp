@@ -24,13 +24,16 @@ constexpr uint8_t LOGD_FREQUENCY = 5;
 namespace OHOS {
 namespace MediaAVCodec {
 constexpr short DEFAULT_SLEEP_TIME = 500;
+constexpr uint32_t NEW_BUFFER_HEADROOM = 2; // free list room for buffers added by RequestNewBuffer
 
 AudioBuffersManager::~AudioBuffersManager() {}
 
 AudioBuffersManager::AudioBuffersManager(const uint32_t bufferSize, const std::string_view &name, const uint16_t count,
                                          const uint32_t metaSize)
     : isRunning_(true),
-      inBufIndexExist(count, false),
+      waiterCount_(0),
+      freeList_(static_cast<uint32_t>(count) * NEW_BUFFER_HEADROOM),
+      inFreeList_(std::make_unique<std::atomic<bool>[]>(freeList_.Capacity())),
       bufferCount_(count),
       bufferSize_(bufferSize),
       metaSize_(metaSize),
@@ -60,67 +63,66 @@ bool AudioBuffersManager::SetBufferBusy(const uint32_t &index)
 
 void AudioBuffersManager::initBuffers()
 {
-    std::lock_guard<std::mutex> lock(stateMutex_);
     AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "start allocate %{public}s buffers,each buffer size:%{public}d",
         name_.data(), bufferSize_);
-    for (size_t i = 0; i < bufferCount_; i++) {
+    // reserved up front so a later RequestNewBuffer never moves the entries other threads read
+    bufferInfo_.reserve(freeList_.Capacity());
+    for (uint32_t i = 0; i < bufferCount_; i++) {
         bufferInfo_[i] = std::make_shared<AudioBufferInfo>(bufferSize_, name_, metaSize_);
-        inBufIndexQue_.emplace(i);
-        inBufIndexExist[i] = true;
+        inFreeList_[i] = true;
+        freeList_.Push(i);
     }
 }
 
 bool AudioBuffersManager::RequestNewBuffer(uint32_t &index, std::shared_ptr<AudioBufferInfo> &buffer)
 {
+    if (bufferInfo_.size() >= freeList_.Capacity()) {
+        AVCODEC_LOGW("Request new %{public}s buffer failed, already %{public}zu buffers.", name_.data(),
+            bufferInfo_.size());
+        return false;
+    }
     buffer = createNewBuffer();
     if (buffer == nullptr) {
         return false;
     }
     index = bufferInfo_.size() - 1;
-    inBufIndexExist.emplace_back(false);
+    inFreeList_[index] = false;
     return true;
 }
 
 bool AudioBuffersManager::RequestAvailableIndex(uint32_t &index)
 {
-    while (inBufIndexQue_.empty() && isRunning_) {
-        AVCODEC_LOGD("Request empty %{public}s buffer", name_.data());
-        std::unique_lock aLock(availableMutex_);
-        availableCondition_.wait_for(aLock, std::chrono::milliseconds(DEFAULT_SLEEP_TIME),
-                                     [this] { return !inBufIndexQue_.empty() || !isRunning_; });
+    while (!freeList_.Pop(index)) {
+        if (!isRunning_) {
+            return false;
+        }
+        WaitAvailable();
     }
-
     if (!isRunning_) {
+        freeList_.Push(index);
         return false;
     }
-    {
-        std::lock_guard<std::mutex> lock(stateMutex_);
-        index = inBufIndexQue_.front();
-        inBufIndexQue_.pop();
-    }
     if (index >= bufferInfo_.size()) {
         AVCODEC_LOGW("Request %{public}s buffer index is invalidate ,index:%{public}u.", name_.data(), index);
         return false;
     }
     AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "Request %{public}s buffer successful,index:%{public}u", name_.data(), index);
-    inBufIndexExist[index] = false;
+    inFreeList_[index] = false;
     bufferInfo_[index]->SetBufferOwned();
     return true;
 }
 
 void AudioBuffersManager::ReleaseAll()
 {
-    {
-        std::lock_guard<std::mutex> lock(stateMutex_);
-        while (!inBufIndexQue_.empty()) {
-            inBufIndexQue_.pop();
-        }
-    }
+    // the worker stops its tasks asynchronously, they may still request and release while this runs, so the list
+    // is not cleared under them: only the indexes not queued yet are pushed, the flag keeps each one queued once
     for (uint32_t i = 0; i < bufferInfo_.size(); ++i) {
         bufferInfo_[i]->ResetBuffer();
-        inBufIndexQue_.emplace(i);
-        inBufIndexExist[i] = true;
+        if (!inFreeList_[i].exchange(true)) {
+            freeList_.Push(i);
+        }
     }
+    NotifyAvailable();
     AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "release all %{public}s buffer.", name_.data());
 }
 
@@ -132,6 +134,7 @@ void AudioBuffersManager::SetRunning()
 void AudioBuffersManager::DisableRunning()
 {
     isRunning_ = false;
+    std::lock_guard<std::mutex> lock(availableMutex_);
     availableCondition_.notify_all();
 }
 
@@ -139,18 +142,37 @@ bool AudioBuffersManager::ReleaseBuffer(const uint32_t &index)
 {
     if (index < bufferInfo_.size()) {
         AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "ReleaseBuffer %{public}s buffer,index:%{public}u", name_.data(), index);
-        std::lock_guard<std::mutex> lock(stateMutex_);
         bufferInfo_[index]->ResetBuffer();
-        if (!inBufIndexExist[index]) {
-            inBufIndexQue_.emplace(index);
-            inBufIndexExist[index] = true;
+        if (!inFreeList_[index].exchange(true)) {
+            freeList_.Push(index);
+            NotifyAvailable();
         }
-        availableCondition_.notify_all();
         return true;
     }
     return false;
 }
 
+void AudioBuffersManager::WaitAvailable()
+{
+    AVCODEC_LOGD("Request empty %{public}s buffer", name_.data());
+    std::unique_lock aLock(availableMutex_);
+    waiterCount_.fetch_add(1);
+    availableCondition_.wait_for(aLock, std::chrono::milliseconds(DEFAULT_SLEEP_TIME),
+                                 [this] { return !freeList_.Empty() || !isRunning_; });
+    waiterCount_.fetch_sub(1);
+}
+
+void AudioBuffersManager::NotifyAvailable()
+{
+    // a read modify write rather than a load, it orders against the increment in WaitAvailable: either the waiter
+    // is counted here or its predicate sees the index just pushed
+    if (waiterCount_.fetch_add(0) == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(availableMutex_);
+    availableCondition_.notify_all();
+}
+
 std::shared_ptr<AudioBufferInfo> AudioBuffersManager::createNewBuffer()
 {
     std::shared_ptr<AudioBufferInfo> buffer = std::make_shared<AudioBufferInfo>(bufferSize_, name_, metaSize_);
@@ -158,4 +180,4 @@ std::shared_ptr<AudioBufferInfo> AudioBuffersManager::createNewBuffer()
     return buffer;
 }
 } // namespace MediaAVCodec
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
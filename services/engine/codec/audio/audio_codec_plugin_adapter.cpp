@@ -0,0 +1,551 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_codec_plugin_adapter.h"
+#include <map>
+#include "audio_codec_adapter.h"
+#include "avcodec_errors.h"
+#include "avcodec_log.h"
+#include "avcodec_trace.h"
+#include "media_description.h"
+#include "plugin/plugin_manager_v2.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_AUDIO, "AvCodec-AudioCodecPluginAdapter"};
+constexpr uint8_t LOGD_FREQUENCY = 5;
+constexpr int32_t WAIT_TIMEOUT_MS = 500;
+const std::string_view INPUT_BUFFER = "inputBuffer";
+const std::string_view OUTPUT_BUFFER = "outputBuffer";
+const std::string_view ASYNC_DECODE_FRAME = "OS_AuCodecShim";
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+using namespace OHOS::Media;
+
+AudioCodecPluginAdapter::AudioCodecPluginAdapter(const std::string &name) : state_(CodecState::RELEASED), name_(name)
+{
+}
+
+std::shared_ptr<CodecBase> AudioCodecPluginAdapter::Create(const std::string &name)
+{
+    // the probe is a bare plugin instance, it is dropped before Init
+    if (Plugins::PluginManagerV2::Instance().CreatePluginByName(name) != nullptr) {
+        return std::make_shared<AudioCodecPluginAdapter>(name);
+    }
+    AVCODEC_LOGW("no media engine plugin for %{public}s, using the legacy codec", name.c_str());
+    return std::make_shared<AudioCodecAdapter>(name);
+}
+
+AudioCodecPluginAdapter::~AudioCodecPluginAdapter()
+{
+    StopDecodeTask();
+    DestroyPlugin();
+    callback_ = nullptr;
+    state_ = CodecState::RELEASED;
+}
+
+int32_t AudioCodecPluginAdapter::SetCallback(const std::shared_ptr<AVCodecCallback> &callback)
+{
+    AVCODEC_SYNC_TRACE;
+    if (state_ != CodecState::RELEASED && state_ != CodecState::INITIALIZED && state_ != CodecState::INITIALIZING) {
+        AVCODEC_LOGE("SetCallback failed, state = %{public}s .", StateToString(state_).data());
+        return AVCodecServiceErrCode::AVCS_ERR_INVALID_STATE;
+    }
+    CHECK_AND_RETURN_RET_LOG(callback != nullptr, AVCodecServiceErrCode::AVCS_ERR_INVALID_VAL,
+        "SetCallback failed, callback is nullptr.");
+    callback_ = callback;
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::Configure(const Format &format)
+{
+    AVCODEC_SYNC_TRACE;
+    AVCODEC_LOGI("state %{public}s to INITIALIZED, name:%{public}s", StateToString(state_).data(), name_.data());
+    CHECK_AND_RETURN_RET_LOG(format.ContainKey(MediaDescriptionKey::MD_KEY_CHANNEL_COUNT),
+        AVCodecServiceErrCode::AVCS_ERR_CONFIGURE_MISMATCH_CHANNEL_COUNT,
+        "Configure failed, missing channel count key in format.");
+    CHECK_AND_RETURN_RET_LOG(format.ContainKey(MediaDescriptionKey::MD_KEY_SAMPLE_RATE),
+        AVCodecServiceErrCode::AVCS_ERR_MISMATCH_SAMPLE_RATE, "Configure failed, missing sample rate key in format.");
+    CHECK_AND_RETURN_RET_LOG(state_ == CodecState::RELEASED, AVCodecServiceErrCode::AVCS_ERR_INVALID_STATE,
+        "Configure failed, state = %{public}s .", StateToString(state_).data());
+
+    state_ = CodecState::INITIALIZING;
+    int32_t syncMode = 0;
+    syncMode_ = format.GetIntValue(SYNC_MODE_KEY, syncMode) && syncMode != 0;
+    int32_t ret = CreatePlugin(format);
+    if (ret != AVCodecServiceErrCode::AVCS_ERR_OK) {
+        DestroyPlugin();
+        state_ = CodecState::RELEASED;
+        return ret;
+    }
+    if (!syncMode_) {
+        decodeTask_ = std::make_unique<TaskThread>(ASYNC_DECODE_FRAME);
+        decodeTask_->RegisterHandler([this] { DecodeLoop(); });
+    }
+    AVCODEC_LOGI("configured, sync mode:%{public}d", syncMode_);
+    state_ = CodecState::INITIALIZED;
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::Start()
+{
+    AVCODEC_SYNC_TRACE;
+    CHECK_AND_RETURN_RET_LOG(callback_ != nullptr, AVCodecServiceErrCode::AVCS_ERR_UNKNOWN,
+        "Start failed, callback not initialized.");
+    CHECK_AND_RETURN_RET_LOG(plugin_ != nullptr, AVCodecServiceErrCode::AVCS_ERR_UNKNOWN,
+        "Start failed, plugin not initialized.");
+    CHECK_AND_RETURN_RET_LOG(state_ == CodecState::INITIALIZED || state_ == CodecState::FLUSHED,
+        AVCodecServiceErrCode::AVCS_ERR_INVALID_STATE, "Start failed, state = %{public}s .",
+        StateToString(state_).data());
+    AVCODEC_LOGI("state %{public}s to RUNNING", StateToString(state_).data());
+    if (state_ == CodecState::INITIALIZED) {
+        state_ = CodecState::STARTING;
+        Status status = plugin_->Start();
+        if (status != Status::OK) {
+            AVCODEC_LOGE("plugin start failed, status:%{public}d", static_cast<int32_t>(status));
+            state_ = CodecState::INITIALIZED;
+            return StatusToAVCodecServiceErrCode(status);
+        }
+    } else {
+        state_ = CodecState::RESUMING;
+    }
+    isRunning_ = true;
+    if (decodeTask_ != nullptr) {
+        decodeTask_->Start();
+    }
+    state_ = CodecState::RUNNING;
+    OfferInputBuffers();
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::Stop()
+{
+    AVCODEC_SYNC_TRACE;
+    CHECK_AND_RETURN_RET_LOG(callback_ != nullptr, AVCodecServiceErrCode::AVCS_ERR_UNKNOWN,
+        "Stop failed, callback not initialized.");
+    if (state_ == CodecState::INITIALIZED || state_ == CodecState::RELEASED || state_ == CodecState::STOPPING ||
+        state_ == CodecState::RELEASING) {
+        AVCODEC_LOGD("Stop, state_=%{public}s", StateToString(state_).data());
+        return AVCodecServiceErrCode::AVCS_ERR_OK;
+    }
+    state_ = CodecState::STOPPING;
+    StopDecodeTask();
+    Status status;
+    {
+        std::lock_guard<std::mutex> lock(decodeMutex_);
+        status = plugin_->Flush();
+        (void)plugin_->Stop();
+        ResetBuffers();
+    }
+    AVCODEC_LOGI("state %{public}s to INITIALIZED", StateToString(state_).data());
+    state_ = CodecState::INITIALIZED;
+    CHECK_AND_RETURN_RET_LOG(status == Status::OK, AVCodecServiceErrCode::AVCS_ERR_INVALID_STATE,
+        "flush status=%{public}d", static_cast<int32_t>(status));
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::Flush()
+{
+    AVCODEC_SYNC_TRACE;
+    CHECK_AND_RETURN_RET_LOG(callback_ != nullptr, AVCodecServiceErrCode::AVCS_ERR_UNKNOWN,
+        "Flush failed, callback not initialized.");
+    if (state_ == CodecState::FLUSHED) {
+        AVCODEC_LOGW("Flush, state is already flushed.");
+        return AVCodecServiceErrCode::AVCS_ERR_OK;
+    }
+    if (state_ != CodecState::RUNNING) {
+        callback_->OnError(AVCodecErrorType::AVCODEC_ERROR_INTERNAL, AVCodecServiceErrCode::AVCS_ERR_INVALID_STATE);
+        AVCODEC_LOGE("Flush failed, state =%{public}s", StateToString(state_).data());
+        return AVCodecServiceErrCode::AVCS_ERR_INVALID_STATE;
+    }
+    AVCODEC_LOGI("state %{public}s to FLUSHING then FLUSHED", StateToString(state_).data());
+    state_ = CodecState::FLUSHING;
+    isRunning_ = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queueCond_.notify_all();
+    }
+    if (decodeTask_ != nullptr) {
+        decodeTask_->Pause();
+    }
+    Status status;
+    {
+        std::lock_guard<std::mutex> lock(decodeMutex_);
+        status = plugin_->Flush();
+        ResetBuffers();
+    }
+    state_ = CodecState::FLUSHED;
+    CHECK_AND_RETURN_RET_LOG(status == Status::OK, AVCodecServiceErrCode::AVCS_ERR_INVALID_STATE,
+        "flush status=%{public}d", static_cast<int32_t>(status));
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::Reset()
+{
+    AVCODEC_SYNC_TRACE;
+    if (state_ == CodecState::RELEASED || state_ == CodecState::RELEASING) {
+        AVCODEC_LOGW("Reset, state is already released, state =%{public}s .", StateToString(state_).data());
+        return AVCodecServiceErrCode::AVCS_ERR_OK;
+    }
+    StopDecodeTask();
+    int32_t ret = AVCodecServiceErrCode::AVCS_ERR_OK;
+    if (plugin_ != nullptr) {
+        ret = StatusToAVCodecServiceErrCode(plugin_->Reset());
+    }
+    DestroyPlugin();
+    AVCODEC_LOGI("state %{public}s to RELEASED", StateToString(state_).data());
+    state_ = CodecState::RELEASED;
+    return ret;
+}
+
+int32_t AudioCodecPluginAdapter::Release()
+{
+    AVCODEC_SYNC_TRACE;
+    if (state_ == CodecState::RELEASED || state_ == CodecState::RELEASING) {
+        AVCODEC_LOGW("Release, state is already released, state =%{public}s .", StateToString(state_).data());
+        return AVCodecServiceErrCode::AVCS_ERR_OK;
+    }
+    AVCODEC_LOGI("state %{public}s to RELEASING then RELEASED", StateToString(state_).data());
+    state_ = CodecState::RELEASING;
+    StopDecodeTask();
+    DestroyPlugin();
+    state_ = CodecState::RELEASED;
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::NotifyEos()
+{
+    AVCODEC_SYNC_TRACE;
+    Flush();
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::SetParameter(const Format &format)
+{
+    AVCODEC_SYNC_TRACE;
+    (void)format;
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::GetOutputFormat(Format &format)
+{
+    AVCODEC_SYNC_TRACE;
+    CHECK_AND_RETURN_RET_LOG(plugin_ != nullptr, AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY,
+        "Codec not init or nullptr");
+    auto meta = std::make_shared<Meta>();
+    Status status = plugin_->GetParameter(meta);
+    CHECK_AND_RETURN_RET_LOG(status == Status::OK, StatusToAVCodecServiceErrCode(status),
+        "plugin get parameter failed");
+    format = Format();
+    format.SetMeta(std::move(meta));
+    if (!format.ContainKey(MediaDescriptionKey::MD_KEY_CODEC_NAME)) {
+        format.PutStringValue(MediaDescriptionKey::MD_KEY_CODEC_NAME, name_);
+    }
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::QueueInputBuffer(uint32_t index, const AVCodecBufferInfo &info,
+                                                  AVCodecBufferFlag flag)
+{
+    AVCODEC_SYNC_TRACE;
+    AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "%{public}s queue buffer enter,index:%{public}u", name_.data(), index);
+    CHECK_AND_RETURN_RET_LOG(state_ == CodecState::RUNNING, AVCodecServiceErrCode::AVCS_ERR_INVALID_STATE,
+        "QueueInputBuffer failed, state = %{public}s .", StateToString(state_).data());
+    CHECK_AND_RETURN_RET_LOG(index < inputs_.size(), AVCodecServiceErrCode::AVCS_ERR_INVALID_VAL,
+        "input index %{public}u out of range", index);
+    CHECK_AND_RETURN_RET_LOG(info.size >= 0 && info.offset >= 0, AVCodecServiceErrCode::AVCS_ERR_INVALID_VAL,
+        "size %{public}d and offset %{public}d could not less than 0", info.size, info.offset);
+    BufferSlot &slot = *inputs_[index];
+    CHECK_AND_RETURN_RET_LOG(info.size <= slot.memory->GetSize() - info.offset,
+        AVCodecServiceErrCode::AVCS_ERR_INVALID_VAL, "Size could not lager than buffersize, size %{public}d.",
+        info.size);
+    CHECK_AND_RETURN_RET_LOG(slot.ownedByClient.exchange(false), AVCodecServiceErrCode::AVCS_ERR_UNKNOWN,
+        "input buffer %{public}u is not owned by client, please don't queue it again.", index);
+    slot.info = info;
+    slot.flag = flag;
+    inputQueue_.Push(index);
+    if (syncMode_) {
+        std::vector<Delivery> deliveries;
+        DecodeQueued(deliveries);
+        Deliver(deliveries);
+    } else {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queueCond_.notify_all();
+    }
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::ReleaseOutputBuffer(uint32_t index)
+{
+    AVCODEC_SYNC_TRACE;
+    AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "%{public}s release buffer,index:%{public}u", name_.data(), index);
+    CHECK_AND_RETURN_RET_LOG(index < outputs_.size(), AVCodecServiceErrCode::AVCS_ERR_INVALID_VAL,
+        "output index %{public}u out of range", index);
+    CHECK_AND_RETURN_RET_LOG(outputs_[index]->ownedByClient.exchange(false), AVCodecServiceErrCode::AVCS_ERR_UNKNOWN,
+        "output buffer %{public}u is not owned by client, could not released", index);
+    freeOutputs_.Push(index);
+    if (syncMode_) {
+        std::vector<Delivery> deliveries;
+        DecodeQueued(deliveries);
+        Deliver(deliveries);
+    } else {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queueCond_.notify_all();
+    }
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+void AudioCodecPluginAdapter::OnInputBufferDone(const std::shared_ptr<AVBuffer> &inputBuffer)
+{
+    // results are taken from the plugin return codes, the buffers never leave this adapter
+    (void)inputBuffer;
+}
+
+void AudioCodecPluginAdapter::OnOutputBufferDone(const std::shared_ptr<AVBuffer> &outputBuffer)
+{
+    // packing is off, so the plugin only reports the slot it was just given and DrainOutput takes it from there
+    (void)outputBuffer;
+}
+
+void AudioCodecPluginAdapter::OnEvent(const std::shared_ptr<Plugins::PluginEvent> event)
+{
+    (void)event;
+    AVCODEC_LOGD("plugin event");
+}
+
+int32_t AudioCodecPluginAdapter::CreatePlugin(const Format &format)
+{
+    AVCODEC_SYNC_TRACE;
+    CHECK_AND_RETURN_RET_LOG(!name_.empty(), AVCodecServiceErrCode::AVCS_ERR_UNKNOWN, "codec name is empty");
+    auto plugin = Plugins::PluginManagerV2::Instance().CreatePluginByName(name_);
+    CHECK_AND_RETURN_RET_LOG(plugin != nullptr, AVCodecServiceErrCode::AVCS_ERR_UNKNOWN,
+        "create plugin failed, name: %{public}s.", name_.data());
+    plugin_ = std::reinterpret_pointer_cast<Plugins::CodecPlugin>(plugin);
+    Status status = plugin_->Init();
+    CHECK_AND_RETURN_RET_LOG(status == Status::OK, StatusToAVCodecServiceErrCode(status), "plugin init failed");
+    // a plugin packing several frames keeps an output buffer across calls, every slot here is filled in one call
+    Format pluginFormat = format;
+    pluginFormat.PutIntValue(MediaDescriptionKey::MD_KEY_AUDIO_MAX_OUTPUT_DURATION, 0);
+    status = plugin_->SetParameter(pluginFormat.GetMeta());
+    CHECK_AND_RETURN_RET_LOG(status == Status::OK, StatusToAVCodecServiceErrCode(status),
+        "plugin set parameter failed");
+    status = plugin_->SetDataCallback(this);
+    CHECK_AND_RETURN_RET_LOG(status == Status::OK, StatusToAVCodecServiceErrCode(status),
+        "plugin set data callback failed");
+
+    auto bufferConfig = std::make_shared<Meta>();
+    status = plugin_->GetParameter(bufferConfig);
+    CHECK_AND_RETURN_RET_LOG(status == Status::OK, StatusToAVCodecServiceErrCode(status),
+        "plugin get parameter failed");
+    int32_t inputSize = 0;
+    int32_t outputSize = 0;
+    CHECK_AND_RETURN_RET_LOG(bufferConfig->Get<Tag::AUDIO_MAX_INPUT_SIZE>(inputSize) &&
+        bufferConfig->Get<Tag::AUDIO_MAX_OUTPUT_SIZE>(outputSize), AVCodecServiceErrCode::AVCS_ERR_UNKNOWN,
+        "plugin reports no buffer size");
+    int32_t ret = CreateBuffers(inputs_, inputSize, INPUT_BUFFER);
+    CHECK_AND_RETURN_RET_LOG(ret == AVCodecServiceErrCode::AVCS_ERR_OK, ret, "create input buffers failed");
+    ret = CreateBuffers(outputs_, outputSize, OUTPUT_BUFFER);
+    CHECK_AND_RETURN_RET_LOG(ret == AVCodecServiceErrCode::AVCS_ERR_OK, ret, "create output buffers failed");
+    ResetBuffers();
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+int32_t AudioCodecPluginAdapter::CreateBuffers(std::vector<std::unique_ptr<BufferSlot>> &slots, int32_t size,
+                                               std::string_view name)
+{
+    CHECK_AND_RETURN_RET_LOG(size > 0, AVCodecServiceErrCode::AVCS_ERR_INVALID_VAL,
+        "invalid %{public}s size %{public}d", name.data(), size);
+    slots.clear();
+    for (uint32_t i = 0; i < DEFAULT_BUFFER_COUNT; ++i) {
+        auto slot = std::make_unique<BufferSlot>();
+        slot->memory = std::make_shared<AVSharedMemoryBase>(size, AVSharedMemory::Flags::FLAGS_READ_WRITE,
+                                                            std::string(name));
+        CHECK_AND_RETURN_RET_LOG(slot->memory->Init() == AVCodecServiceErrCode::AVCS_ERR_OK,
+            AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY, "create %{public}s avsharedmemory failed", name.data());
+        // the plugin works on the very memory the client fills and reads
+        slot->buffer = AVBuffer::CreateAVBuffer(slot->memory->GetBase(), slot->memory->GetSize());
+        CHECK_AND_RETURN_RET_LOG(slot->buffer != nullptr && slot->buffer->memory_ != nullptr,
+            AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY, "wrap %{public}s failed", name.data());
+        slots.push_back(std::move(slot));
+    }
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+void AudioCodecPluginAdapter::ResetBuffers()
+{
+    inputQueue_.Clear();
+    freeOutputs_.Clear();
+    for (auto &slot : inputs_) {
+        slot->ownedByClient = false;
+    }
+    for (uint32_t i = 0; i < outputs_.size(); ++i) {
+        outputs_[i]->ownedByClient = false;
+        freeOutputs_.Push(i);
+    }
+    outputPending_ = false;
+}
+
+void AudioCodecPluginAdapter::OfferInputBuffers()
+{
+    for (uint32_t i = 0; i < inputs_.size() && isRunning_; ++i) {
+        inputs_[i]->ownedByClient = true;
+        callback_->OnInputBufferAvailable(i, inputs_[i]->memory);
+    }
+}
+
+void AudioCodecPluginAdapter::DecodeQueued(std::vector<Delivery> &deliveries)
+{
+    std::lock_guard<std::mutex> lock(decodeMutex_);
+    uint32_t index = 0;
+    while (isRunning_) {
+        if (outputPending_) {
+            DrainOutput(deliveries);
+        }
+        // only feed the plugin while a decoded frame has somewhere to go
+        if (freeOutputs_.Empty() || !inputQueue_.Pop(index)) {
+            break;
+        }
+        SendInput(index, deliveries);
+    }
+}
+
+void AudioCodecPluginAdapter::SendInput(uint32_t index, std::vector<Delivery> &deliveries)
+{
+    AVCODEC_SYNC_TRACE;
+    BufferSlot &slot = *inputs_[index];
+    std::shared_ptr<AVBuffer> buffer = slot.buffer;
+    if (slot.info.offset > 0) {
+        buffer = AVBuffer::CreateAVBuffer(slot.memory->GetBase() + slot.info.offset, slot.info.size, slot.info.size);
+    } else {
+        buffer->memory_->SetSize(slot.info.size);
+    }
+    buffer->pts_ = slot.info.presentationTimeUs;
+    buffer->flag_ = slot.flag;
+    Status status = plugin_->QueueInputBuffer(buffer);
+    if (status == Status::ERROR_NOT_ENOUGH_DATA) {
+        AVCODEC_LOGW("current input buffer is not enough,skip this frame");
+    } else if (status != Status::OK && status != Status::END_OF_STREAM) {
+        AVCODEC_LOGE("queue input failed, status:%{public}d", static_cast<int32_t>(status));
+        deliveries.push_back({Delivery::Kind::ERROR, index, StatusToAVCodecServiceErrCode(status)});
+    }
+    outputPending_ = true;
+    slot.ownedByClient = true;
+    deliveries.push_back({Delivery::Kind::INPUT, index, AVCodecServiceErrCode::AVCS_ERR_OK});
+}
+
+void AudioCodecPluginAdapter::DrainOutput(std::vector<Delivery> &deliveries)
+{
+    AVCODEC_SYNC_TRACE;
+    uint32_t index = 0;
+    while (freeOutputs_.Pop(index)) {
+        BufferSlot &slot = *outputs_[index];
+        slot.buffer->memory_->SetSize(0);
+        slot.buffer->flag_ = AVCODEC_BUFFER_FLAG_NONE;
+        Status status = plugin_->QueueOutputBuffer(slot.buffer);
+        if (status != Status::ERROR_AGAIN && status != Status::END_OF_STREAM) {
+            freeOutputs_.Push(index);
+            outputPending_ = false;
+            if (status != Status::ERROR_NOT_ENOUGH_DATA) {
+                AVCODEC_LOGE("process output buffer error! index:%{public}u", index);
+                deliveries.push_back({Delivery::Kind::ERROR, index, StatusToAVCodecServiceErrCode(status)});
+            }
+            return;
+        }
+        slot.info = {slot.buffer->pts_, slot.buffer->memory_->GetSize(), 0};
+        slot.flag = (slot.buffer->flag_ & AVCODEC_BUFFER_FLAG_EOS) != 0 ? AVCODEC_BUFFER_FLAG_EOS :
+            AVCODEC_BUFFER_FLAG_NONE;
+        slot.ownedByClient = true;
+        deliveries.push_back({Delivery::Kind::OUTPUT, index, AVCodecServiceErrCode::AVCS_ERR_OK});
+        if (status == Status::END_OF_STREAM) {
+            outputPending_ = false;
+            return;
+        }
+    }
+}
+
+void AudioCodecPluginAdapter::Deliver(const std::vector<Delivery> &deliveries)
+{
+    for (const auto &delivery : deliveries) {
+        switch (delivery.kind) {
+            case Delivery::Kind::INPUT:
+                callback_->OnInputBufferAvailable(delivery.index, inputs_[delivery.index]->memory);
+                break;
+            case Delivery::Kind::OUTPUT: {
+                const BufferSlot &slot = *outputs_[delivery.index];
+                callback_->OnOutputBufferAvailable(delivery.index, slot.info, slot.flag, slot.memory);
+                break;
+            }
+            default:
+                callback_->OnError(AVCodecErrorType::AVCODEC_ERROR_INTERNAL, delivery.errorCode);
+                break;
+        }
+    }
+}
+
+void AudioCodecPluginAdapter::DecodeLoop()
+{
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        queueCond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS), [this] {
+            return !isRunning_ || (!freeOutputs_.Empty() && (outputPending_ || !inputQueue_.Empty()));
+        });
+    }
+    std::vector<Delivery> deliveries;
+    DecodeQueued(deliveries);
+    Deliver(deliveries);
+}
+
+void AudioCodecPluginAdapter::StopDecodeTask()
+{
+    isRunning_ = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queueCond_.notify_all();
+    }
+    if (decodeTask_ != nullptr) {
+        decodeTask_->Stop();
+    }
+}
+
+void AudioCodecPluginAdapter::DestroyPlugin()
+{
+    std::lock_guard<std::mutex> lock(decodeMutex_);
+    decodeTask_ = nullptr;
+    if (plugin_ != nullptr) {
+        (void)plugin_->Release();
+        plugin_ = nullptr;
+    }
+    inputs_.clear();
+    outputs_.clear();
+    inputQueue_.Clear();
+    freeOutputs_.Clear();
+    outputPending_ = false;
+}
+
+std::string_view AudioCodecPluginAdapter::StateToString(CodecState state)
+{
+    static const std::map<CodecState, std::string_view> stateStrMap = {
+        {CodecState::RELEASED, " RELEASED"},         {CodecState::INITIALIZED, " INITIALIZED"},
+        {CodecState::FLUSHED, " FLUSHED"},           {CodecState::RUNNING, " RUNNING"},
+        {CodecState::INITIALIZING, " INITIALIZING"}, {CodecState::STARTING, " STARTING"},
+        {CodecState::STOPPING, " STOPPING"},         {CodecState::FLUSHING, " FLUSHING"},
+        {CodecState::RESUMING, " RESUMING"},         {CodecState::RELEASING, " RELEASING"},
+    };
+    auto it = stateStrMap.find(state);
+    return it == stateStrMap.end() ? " UNKNOWN" : it->second;
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
@@ -16,7 +16,7 @@
 #include "audio_resample.h"
 #include "avcodec_log.h"
 #include "securec.h"
-#include "ffmpeg_converter.h"
+#include "audio_sample_converter.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_AUDIO, "AvCodec-AudioResample"};
@@ -24,46 +24,31 @@ constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_AUDIO, "AvCo
 
 namespace OHOS {
 namespace MediaAVCodec {
+using Media::Status;
+
+AudioResample::AudioResample() : converter_(std::make_unique<Media::Plugins::Ffmpeg::AudioSampleConverter>())
+{
+}
+
+AudioResample::~AudioResample() = default;
+
 int32_t AudioResample::Init(const ResamplePara& resamplePara)
 {
-    auto ret = InitSwrContext(resamplePara);
-    if (ret != AVCodecServiceErrCode::AVCS_ERR_OK) {
-        return ret;
-    }
-    auto destFrameSize = av_samples_get_buffer_size(nullptr, resamplePara_.channels,
-                                                    resamplePara_.destSamplesPerFrame, resamplePara_.destFmt, 0);
-    resampleCache_.reserve(destFrameSize);
-    resampleChannelAddr_.reserve(resamplePara_.channels);
-    auto tmp = resampleChannelAddr_.data();
-    av_samples_fill_arrays(tmp, nullptr, resampleCache_.data(), resamplePara_.channels,
-                           resamplePara_.destSamplesPerFrame, resamplePara_.destFmt, 0);
-    return AVCodecServiceErrCode::AVCS_ERR_OK;
+    return InitSwrContext(resamplePara);
 }
 
 int32_t AudioResample::InitSwrContext(const ResamplePara& resamplePara)
 {
     resamplePara_ = resamplePara;
-    SwrContext *swrContext = swr_alloc();
-    if (swrContext == nullptr) {
-        AVCODEC_LOGE("cannot allocate swr context");
-        return AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY;
-    }
-    int error =
-        swr_alloc_set_opts2(&swrContext, &resamplePara_.channelLayout, resamplePara_.destFmt, resamplePara_.sampleRate,
-                            &resamplePara_.channelLayout, resamplePara_.srcFmt, resamplePara_.sampleRate, 0, nullptr);
-    if (error < 0) {
-        AVCODEC_LOGE("swr init error");
-        return AVCodecServiceErrCode::AVCS_ERR_UNKNOWN;
-    }
-    if (swr_init(swrContext) != 0) {
-        AVCODEC_LOGE("swr init error");
-        return AVCodecServiceErrCode::AVCS_ERR_UNKNOWN;
+    Status ret = converter_->Init(resamplePara_.srcFmt, resamplePara_.destFmt, resamplePara_.channelLayout,
+                                  resamplePara_.sampleRate);
+    if (ret != Status::OK) {
+        AVCODEC_LOGE("sample converter init error");
+        return ret == Status::ERROR_NO_MEMORY ? AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY :
+                                                AVCodecServiceErrCode::AVCS_ERR_UNKNOWN;
     }
-    swrCtx_ = std::shared_ptr<SwrContext>(swrContext, [](SwrContext *ptr) {
-        if (ptr) {
-            swr_free(&ptr);
-        }
-    });
+    AVCODEC_LOGD("convert %{public}d to %{public}d, accelerated: %{public}d", resamplePara_.srcFmt,
+                 resamplePara_.destFmt, converter_->IsAccelerated());
     return AVCodecServiceErrCode::AVCS_ERR_OK;
 }
 
@@ -79,47 +64,26 @@ int32_t AudioResample::Convert(const uint8_t* srcBuffer, const size_t srcLength,
         }
     }
     int32_t samples = lineSize / av_get_bytes_per_sample(resamplePara_.srcFmt);
-    auto res = swr_convert(swrCtx_.get(), resampleChannelAddr_.data(), resamplePara_.destSamplesPerFrame,
-                           tmpInput.data(), samples);
-    if (res < 0) {
+    if (converter_->Convert(tmpInput.data(), samples, destBuffer, destLength) != Status::OK) {
         AVCODEC_LOGE("resample input failed");
         destLength = 0;
-    } else {
-        destBuffer = resampleCache_.data();
-        destLength = static_cast<size_t>(res * av_get_bytes_per_sample(resamplePara_.destFmt) * resamplePara_.channels);
     }
     return AVCodecServiceErrCode::AVCS_ERR_OK;
 }
 
-int32_t AudioResample::ConvertFrame(AVFrame *outputFrame, const AVFrame *inputFrame)
+int32_t AudioResample::ConvertFrame(const AVFrame *inputFrame, uint8_t *dest, size_t capacity, size_t &destLength)
 {
-    if (outputFrame == nullptr || inputFrame == nullptr) {
+    if (inputFrame == nullptr || dest == nullptr) {
         AVCODEC_LOGE("Frame null pointer");
         return AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY;
     }
-    int planar = av_sample_fmt_is_planar(static_cast<AVSampleFormat>(inputFrame->format));
-    if (planar) {
-        for (auto i = 0; i < inputFrame->channels; i++) {
-            if (inputFrame->extended_data[i] == nullptr) {
-                AVCODEC_LOGE("this is a planar audio, inputFrame->channels: %{public}d, "
-                             "but inputFrame->extended_data[%{public}d] is nullptr", inputFrame->channels, i);
-                return AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY;
-            }
-        }
-    } else {
-        if (inputFrame->extended_data[0] == nullptr) {
-            AVCODEC_LOGE("inputFrame->extended_data[0] is nullptr");
-            return AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY;
-        }
+    Status ret = converter_->Convert(inputFrame, dest, capacity, destLength);
+    if (ret == Status::ERROR_NO_MEMORY) {
+        AVCODEC_LOGE("output buffer size is not enough, capacity: %{public}zu", capacity);
+        return AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY;
     }
-
-    outputFrame->ch_layout = resamplePara_.channelLayout;
-    outputFrame->format = resamplePara_.destFmt;
-    outputFrame->sample_rate = resamplePara_.sampleRate;
-
-    auto ret = swr_convert_frame(swrCtx_.get(), outputFrame, inputFrame);
-    if (ret < 0) {
-        AVCODEC_LOGE("convert frame failed, %{public}s", FFMpegConverter::AVStrError(ret).c_str());
+    if (ret != Status::OK) {
+        AVCODEC_LOGE("convert frame failed, nb_samples: %{public}d", inputFrame->nb_samples);
         return AVCodecServiceErrCode::AVCS_ERR_UNKNOWN;
     }
     return AVCodecServiceErrCode::AVCS_ERR_OK;
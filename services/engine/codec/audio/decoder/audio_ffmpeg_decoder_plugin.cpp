@@ -188,21 +188,23 @@ int32_t AudioFfmpegDecoderPlugin::ReceiveBuffer(std::shared_ptr<AudioBufferInfo>
 
 int32_t AudioFfmpegDecoderPlugin::ConvertPlanarFrame(std::shared_ptr<AudioBufferInfo> &outBuffer)
 {
-    convertedFrame_ = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *fp) { av_frame_free(&fp); });
-    if (convertedFrame_ == nullptr) {
-        AVCODEC_LOGE("av_frame_alloc failed");
-        return AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY;
-    }
-    if (resample_->ConvertFrame(convertedFrame_.get(), cachedFrame_.get()) != AVCodecServiceErrCode::AVCS_ERR_OK) {
+    auto ioInfoMem = outBuffer->GetBuffer();
+    size_t outputSize = 0;
+    int32_t ret = resample_->ConvertFrame(cachedFrame_.get(), ioInfoMem->GetBase(),
+                                          static_cast<size_t>(ioInfoMem->GetSize()), outputSize);
+    if (ret != AVCodecServiceErrCode::AVCS_ERR_OK) {
         AVCODEC_LOGE("convert frame failed");
-        return AVCodecServiceErrCode::AVCS_ERR_UNKNOWN;
+        return ret;
     }
+    auto attr = outBuffer->GetBufferAttr();
+    attr.presentationTimeUs = static_cast<uint64_t>(cachedFrame_->pts);
+    attr.size = static_cast<int32_t>(outputSize);
+    outBuffer->SetBufferAttr(attr);
     return AVCodecServiceErrCode::AVCS_ERR_OK;
 }
 
 int32_t AudioFfmpegDecoderPlugin::ReceiveFrameSucc(std::shared_ptr<AudioBufferInfo> &outBuffer)
 {
-    auto outFrame = cachedFrame_;
     if (needResample_) {
         if (resample_ == nullptr) {
             format_.PutIntValue(MediaDescriptionKey::MD_KEY_BITS_PER_CODED_SAMPLE,
@@ -215,14 +217,12 @@ int32_t AudioFfmpegDecoderPlugin::ReceiveFrameSucc(std::shared_ptr<AudioBufferIn
                 return AVCodecServiceErrCode::AVCS_ERR_UNKNOWN;
             }
         }
-        if (ConvertPlanarFrame(outBuffer) != AVCodecServiceErrCode::AVCS_ERR_OK) {
-            return AVCodecServiceErrCode::AVCS_ERR_UNKNOWN;
-        }
-        outFrame = convertedFrame_;
+        // the converted samples go straight into the output buffer
+        return ConvertPlanarFrame(outBuffer);
     }
     auto ioInfoMem = outBuffer->GetBuffer();
-    int32_t bytePerSample = av_get_bytes_per_sample(static_cast<AVSampleFormat>(outFrame->format));
-    int32_t outputSize = outFrame->nb_samples * bytePerSample * outFrame->channels;
+    int32_t bytePerSample = av_get_bytes_per_sample(static_cast<AVSampleFormat>(cachedFrame_->format));
+    int32_t outputSize = cachedFrame_->nb_samples * bytePerSample * cachedFrame_->channels;
     AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "ReceiveFrameSucc buffer real size:%{public}u,size:%{public}u, name:%{public}s",
                        outputSize, ioInfoMem->GetSize(), name_.data());
     if (ioInfoMem->GetSize() < outputSize) {
@@ -230,7 +230,7 @@ int32_t AudioFfmpegDecoderPlugin::ReceiveFrameSucc(std::shared_ptr<AudioBufferIn
         return AVCodecServiceErrCode::AVCS_ERR_NO_MEMORY;
     }
 
-    ioInfoMem->Write(outFrame->data[0], outputSize);
+    ioInfoMem->Write(cachedFrame_->data[0], outputSize);
     auto attr = outBuffer->GetBufferAttr();
     attr.presentationTimeUs = static_cast<uint64_t>(cachedFrame_->pts);
     attr.size = outputSize;
@@ -363,7 +363,6 @@ int32_t AudioFfmpegDecoderPlugin::InitResample()
             .destSamplesPerFrame = 0,
             .destFmt = destFmt_,
         };
-        convertedFrame_ = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *fp) { av_frame_free(&fp); });
         resample_ = std::make_shared<AudioResample>();
         if (resample_->InitSwrContext(resamplePara) != AVCodecServiceErrCode::AVCS_ERR_OK) {
             AVCODEC_LOGE("Resample init failed.");
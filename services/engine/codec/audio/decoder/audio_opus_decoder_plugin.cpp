@@ -23,11 +23,13 @@
 #include "ffmpeg_converter.h"
 #include "avcodec_audio_common.h"
 #include "securec.h"
+#include "library_cache.h"
 #include "audio_opus_decoder_plugin.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_AUDIO, "AvCodec-AudioOpusDecoderPlugin"};
 constexpr std::string_view AUDIO_CODEC_NAME = "opus";
+const std::string OPUS_LIB_PATH = "libav_codec_ext_base.z.so";
 constexpr int32_t INITVAL = -1;
 constexpr int64_t TIME_US = 20000;
 constexpr int32_t MIN_CHANNELS = 1;
@@ -44,13 +46,13 @@ AudioOpusDecoderPlugin::AudioOpusDecoderPlugin()
     : PluginCodecPtr(nullptr), fbytes(nullptr), len(-1), codeData(nullptr), channels(-1), sampleRate(-1)
 {
     ret = 0;
-    handle = dlopen("libav_codec_ext_base.z.so", 1);
+    handle = LibraryCache::GetInstance().Acquire(OPUS_LIB_PATH, RTLD_LAZY);
     if (!handle) {
         ret = -1;
         AVCODEC_LOGE("AudioOpusDecoderPlugin dlopen error, check .so file exist");
     }
-    OpusPluginClassCreateFun *PluginCodecCreate =
-        (OpusPluginClassCreateFun *)dlsym(handle, "OpusPluginClassDecoderCreate");
+    auto PluginCodecCreate = reinterpret_cast<OpusPluginClassCreateFun *>(handle == nullptr ? nullptr :
+        LibraryCache::GetInstance().GetSymbol(OPUS_LIB_PATH, "OpusPluginClassDecoderCreate"));
     if (!PluginCodecCreate) {
         ret = -1;
         AVCODEC_LOGE("AudioOpusDecoderPlugin dlsym error, check .so file has this function");
@@ -203,6 +205,7 @@ int32_t AudioOpusDecoderPlugin::Release()
     std::lock_guard<std::mutex> lock(avMutext_);
     if (!PluginCodecPtr) {
         AVCODEC_LOGD("AudioOpusDecoderPlugin Release dlopen or dlsym error. release");
+        ReleaseLibrary();
         return AVCodecServiceErrCode::AVCS_ERR_OK;
     }
     ret = PluginCodecPtr->Release();
@@ -211,11 +214,16 @@ int32_t AudioOpusDecoderPlugin::Release()
     }
     delete PluginCodecPtr;
     PluginCodecPtr = nullptr;
+    ReleaseLibrary();
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+void AudioOpusDecoderPlugin::ReleaseLibrary()
+{
     if (handle) {
-        dlclose(handle);
+        LibraryCache::GetInstance().Release(OPUS_LIB_PATH);
         handle = nullptr;
     }
-    return AVCodecServiceErrCode::AVCS_ERR_OK;
 }
 
 int32_t AudioOpusDecoderPlugin::Flush()
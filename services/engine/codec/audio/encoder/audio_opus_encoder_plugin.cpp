@@ -23,11 +23,13 @@
 #include "ffmpeg_converter.h"
 #include "avcodec_audio_common.h"
 #include "securec.h"
+#include "library_cache.h"
 #include "audio_opus_encoder_plugin.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_AUDIO, "AvCodec-AudioOpusEncoderPlugin"};
 constexpr std::string_view AUDIO_CODEC_NAME = "opus";
+const std::string OPUS_LIB_PATH = "libav_codec_ext_base.z.so";
 constexpr int32_t INITVAL = -1;
 constexpr float TIME_S = 0.02;
 constexpr int64_t TIME_US = 20000;
@@ -49,13 +51,13 @@ AudioOpusEncoderPlugin::AudioOpusEncoderPlugin()
       channels(-1), sampleRate(-1), bitRate(-1), complexity(-1)
 {
     ret = 0;
-    handle = dlopen("libav_codec_ext_base.z.so", 1);
+    handle = LibraryCache::GetInstance().Acquire(OPUS_LIB_PATH, RTLD_LAZY);
     if (!handle) {
         ret = -1;
         AVCODEC_LOGE("AudioOpusEncoderPlugin dlopen error, check .so file exist");
     }
-    OpusPluginClassCreateFun* PluginCodecCreate = (OpusPluginClassCreateFun *)dlsym(handle,
-        "OpusPluginClassEncoderCreate");
+    auto PluginCodecCreate = reinterpret_cast<OpusPluginClassCreateFun *>(handle == nullptr ? nullptr :
+        LibraryCache::GetInstance().GetSymbol(OPUS_LIB_PATH, "OpusPluginClassEncoderCreate"));
     if (!PluginCodecCreate) {
         ret = -1;
         AVCODEC_LOGE("AudioOpusEncoderPlugin dlsym error, check .so file has this function");
@@ -228,6 +230,7 @@ int32_t AudioOpusEncoderPlugin::Release()
     std::lock_guard<std::mutex> lock(avMutext_);
     if (!PluginCodecPtr) {
         AVCODEC_LOGD("AudioOpusEncoderPlugin Release dlopen or dlsym error. release");
+        ReleaseLibrary();
         return AVCodecServiceErrCode::AVCS_ERR_OK;
     }
     ret = PluginCodecPtr->Release();
@@ -236,11 +239,16 @@ int32_t AudioOpusEncoderPlugin::Release()
     }
     delete PluginCodecPtr;
     PluginCodecPtr = nullptr;
+    ReleaseLibrary();
+    return AVCodecServiceErrCode::AVCS_ERR_OK;
+}
+
+void AudioOpusEncoderPlugin::ReleaseLibrary()
+{
     if (handle) {
-        dlclose(handle);
+        LibraryCache::GetInstance().Release(OPUS_LIB_PATH);
         handle = nullptr;
     }
-    return AVCodecServiceErrCode::AVCS_ERR_OK;
 }
 
 int32_t AudioOpusEncoderPlugin::Flush()
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AV_CODEC_AUDIO_BUFFER_FREE_LIST_H
+#define AV_CODEC_AUDIO_BUFFER_FREE_LIST_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace MediaAVCodec {
+/**
+ * Bounded multi producer multi consumer queue of buffer indexes.
+ *
+ * Every slot carries a sequence number that tells producers and consumers whose turn it is, so Push and Pop only
+ * take one compare and swap on the shared position. Pop never blocks, Push only yields while a consumer preempted
+ * between claiming and freeing a slot holds it. Capacity is rounded up to a power of two.
+ */
+class AudioBufferFreeList : public NoCopyable {
+public:
+    explicit AudioBufferFreeList(uint32_t capacity);
+
+    ~AudioBufferFreeList() = default;
+
+    // Returns false when the list is full
+    bool Push(uint32_t index) noexcept;
+
+    // Returns false when the list is empty
+    bool Pop(uint32_t &index) noexcept;
+
+    // May briefly report non empty while a concurrent Push is still publishing its slot
+    bool Empty() const noexcept;
+
+    uint32_t Capacity() const noexcept;
+
+    // Drops every queued index, callers must make sure no Push or Pop runs concurrently
+    void Clear() noexcept;
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    struct Slot {
+        std::atomic<uint64_t> sequence {0};
+        uint32_t index {0};
+    };
+
+    uint64_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> pushPos_ {0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> popPos_ {0};
+};
+} // namespace MediaAVCodec
+} // namespace OHOS
+
+#endif
@@ -16,13 +16,13 @@
 #ifndef AV_CODEC_ENGIN_BFFERS_H
 #define AV_CODEC_ENGIN_BFFERS_H
 
+#include "audio_buffer_free_list.h"
 #include "audio_buffer_info.h"
 #include "nocopyable.h"
 
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
-#include <queue>
 #include <string_view>
 
 namespace OHOS {
@@ -53,14 +53,18 @@ public:
 private:
     void initBuffers();
     std::shared_ptr<AudioBufferInfo> createNewBuffer();
+    void WaitAvailable();
+    void NotifyAvailable();
 
 private:
     std::atomic<bool> isRunning_;
+    // requesters only take the mutex to sleep once the free list runs dry
     std::mutex availableMutex_;
     std::condition_variable availableCondition_;
-    std::queue<uint32_t> inBufIndexQue_;
-    std::vector<bool> inBufIndexExist;
-    mutable std::mutex stateMutex_;
+    std::atomic<uint32_t> waiterCount_;
+    AudioBufferFreeList freeList_;
+    // set while the index sits in freeList_, keeps a double release from queueing it twice
+    std::unique_ptr<std::atomic<bool>[]> inFreeList_;
     const uint16_t bufferCount_;
     uint32_t bufferSize_;
     uint32_t metaSize_;
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CODEC_AUDIO_CODEC_PLUGIN_ADAPTER_H
+#define CODEC_AUDIO_CODEC_PLUGIN_ADAPTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "audio_buffer_free_list.h"
+#include "audio_common_info.h"
+#include "avcodec_common.h"
+#include "codecbase.h"
+#include "nocopyable.h"
+#include "plugin/codec_plugin.h"
+#include "task_thread.h"
+
+namespace OHOS {
+namespace MediaAVCodec {
+/**
+ * Serves the legacy AudioCodecAdapter api with a media engine codec plugin.
+ *
+ * Input and output indexes map to shared memory the client sees, the plugin reads and writes that memory through
+ * AVBuffer wrappers, so no buffer queue sits in between. In the default asynchronous mode a single task thread
+ * decodes the queued input, with SYNC_MODE_KEY set in the configure format QueueInputBuffer and
+ * ReleaseOutputBuffer decode on the calling thread and no thread is started at all.
+ */
+class AudioCodecPluginAdapter : public CodecBase, public Media::Plugins::DataCallback, public NoCopyable {
+public:
+    static constexpr std::string_view SYNC_MODE_KEY = "audio_codec_sync_mode";
+
+    explicit AudioCodecPluginAdapter(const std::string &name);
+
+    /**
+     * Picks the codec for name while the shim is on: this adapter when the media engine has a plugin of that name,
+     * the legacy AudioCodecAdapter otherwise.
+     */
+    static std::shared_ptr<CodecBase> Create(const std::string &name);
+
+    ~AudioCodecPluginAdapter() override;
+
+    int32_t SetCallback(const std::shared_ptr<AVCodecCallback> &callback) override;
+
+    int32_t Configure(const Format &format) override;
+
+    int32_t Start() override;
+
+    int32_t Stop() override;
+
+    int32_t Flush() override;
+
+    int32_t Reset() override;
+
+    int32_t Release() override;
+
+    int32_t NotifyEos() override;
+
+    int32_t SetParameter(const Format &format) override;
+
+    int32_t GetOutputFormat(Format &format) override;
+
+    int32_t QueueInputBuffer(uint32_t index, const AVCodecBufferInfo &info, AVCodecBufferFlag flag) override;
+
+    int32_t ReleaseOutputBuffer(uint32_t index) override;
+
+    void OnInputBufferDone(const std::shared_ptr<Media::AVBuffer> &inputBuffer) override;
+
+    void OnOutputBufferDone(const std::shared_ptr<Media::AVBuffer> &outputBuffer) override;
+
+    void OnEvent(const std::shared_ptr<Media::Plugins::PluginEvent> event) override;
+
+private:
+    struct BufferSlot {
+        std::shared_ptr<AVSharedMemoryBase> memory;
+        std::shared_ptr<Media::AVBuffer> buffer;
+        std::atomic<bool> ownedByClient {false};
+        AVCodecBufferInfo info;
+        AVCodecBufferFlag flag {AVCODEC_BUFFER_FLAG_NONE};
+    };
+    // Callbacks collected under decodeMutex_ and fired after it is released, so the client may call back in
+    struct Delivery {
+        enum class Kind { INPUT, OUTPUT, ERROR } kind;
+        uint32_t index;
+        int32_t errorCode;
+    };
+    static constexpr uint32_t DEFAULT_BUFFER_COUNT = 8;
+
+    int32_t CreatePlugin(const Format &format);
+    int32_t CreateBuffers(std::vector<std::unique_ptr<BufferSlot>> &slots, int32_t size, std::string_view name);
+    void ResetBuffers();
+    void OfferInputBuffers();
+    void DecodeQueued(std::vector<Delivery> &deliveries);
+    void SendInput(uint32_t index, std::vector<Delivery> &deliveries);
+    void DrainOutput(std::vector<Delivery> &deliveries);
+    void Deliver(const std::vector<Delivery> &deliveries);
+    void DecodeLoop();
+    void StopDecodeTask();
+    void DestroyPlugin();
+    std::string_view StateToString(CodecState state);
+
+    std::atomic<CodecState> state_;
+    const std::string name_;
+    bool syncMode_ {false};
+    std::shared_ptr<AVCodecCallback> callback_;
+    std::shared_ptr<Media::Plugins::CodecPlugin> plugin_;
+    std::vector<std::unique_ptr<BufferSlot>> inputs_;
+    std::vector<std::unique_ptr<BufferSlot>> outputs_;
+    AudioBufferFreeList inputQueue_ {DEFAULT_BUFFER_COUNT};
+    AudioBufferFreeList freeOutputs_ {DEFAULT_BUFFER_COUNT};
+    // the plugin may still hold decoded frames that did not fit into the free output buffers
+    std::atomic<bool> outputPending_ {false};
+    std::mutex decodeMutex_;
+    std::mutex queueMutex_;
+    std::condition_variable queueCond_;
+    std::atomic<bool> isRunning_ {false};
+    std::unique_ptr<TaskThread> decodeTask_;
+};
+} // namespace MediaAVCodec
+} // namespace OHOS
+#endif
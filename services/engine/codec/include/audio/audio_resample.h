@@ -28,6 +28,14 @@ extern "C" {
 #endif
 
 namespace OHOS {
+namespace Media {
+namespace Plugins {
+namespace Ffmpeg {
+class AudioSampleConverter;
+} // namespace Ffmpeg
+} // namespace Plugins
+} // namespace Media
+
 namespace MediaAVCodec {
 struct ResamplePara {
     uint32_t channels {2}; // 2: STEREO
@@ -41,16 +49,17 @@ struct ResamplePara {
 
 class AudioResample {
 public:
+    AudioResample();
+    ~AudioResample();
     int32_t Init(const ResamplePara& resamplePara);
     int32_t Convert(const uint8_t* srcBuffer, const size_t srcLength, uint8_t*& destBuffer, size_t& destLength);
     int32_t InitSwrContext(const ResamplePara& resamplePara);
-    int32_t ConvertFrame(AVFrame *outputFrame, const AVFrame *inputFrame);
+    // converts the frame straight into dest, which must hold at least destLength bytes
+    int32_t ConvertFrame(const AVFrame *inputFrame, uint8_t *dest, size_t capacity, size_t &destLength);
 
 private:
     ResamplePara resamplePara_ {};
-    std::vector<uint8_t> resampleCache_ {};
-    std::vector<uint8_t*> resampleChannelAddr_ {};
-    std::shared_ptr<SwrContext> swrCtx_ {nullptr};
+    std::unique_ptr<Media::Plugins::Ffmpeg::AudioSampleConverter> converter_;
 };
 } // namespace MediaAVCodec
 } // namespace OHOS
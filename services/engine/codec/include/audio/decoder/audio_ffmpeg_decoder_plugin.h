@@ -93,7 +93,6 @@ private:
     std::shared_ptr<AudioResample> resample_;
     bool needResample_;
     AVSampleFormat destFmt_;
-    std::shared_ptr<AVFrame> convertedFrame_;
 
 private:
     int32_t SendBuffer(const std::shared_ptr<AudioBufferInfo> &inputBuffer);
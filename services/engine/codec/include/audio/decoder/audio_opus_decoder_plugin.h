@@ -55,6 +55,7 @@ private:
     Format format_;
     mutable std::mutex avMutext_;
     int32_t CheckSampleFormat();
+    void ReleaseLibrary();
     OHOS::MediaAVCodec::AudioBaseCodecExt *PluginCodecPtr;
     int32_t ret;
     unsigned char *fbytes;
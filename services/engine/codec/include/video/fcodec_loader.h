@@ -24,15 +24,12 @@ class FCodecLoader : public VideoCodecLoader {
 public:
     static std::shared_ptr<CodecBase> CreateByName(const std::string &name);
     static int32_t GetCapabilityList(std::vector<CapabilityData> &caps);
+    static void GetDumpInfo(std::string &dumpString);
 
 private:
     FCodecLoader();
     ~FCodecLoader() = default;
-    void CloseLibrary();
     static FCodecLoader &GetInstance();
-
-    std::mutex mutex_;
-    int32_t fcodecCount_ = 0;
 };
 } // namespace MediaAVCodec
 } // namespace OHOS
@@ -24,15 +24,12 @@ class HevcDecoderLoader : public VideoCodecLoader {
 public:
     static std::shared_ptr<CodecBase> CreateByName(const std::string &name);
     static int32_t GetCapabilityList(std::vector<CapabilityData> &caps);
+    static void GetDumpInfo(std::string &dumpString);
 
 private:
     HevcDecoderLoader();
     ~HevcDecoderLoader() = default;
-    void CloseLibrary();
     static HevcDecoderLoader &GetInstance();
-
-    std::mutex mutex_;
-    int32_t hevcDecoderCount_ = 0;
 };
 } // namespace MediaAVCodec
 } // namespace OHOS
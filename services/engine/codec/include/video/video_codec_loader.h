@@ -15,6 +15,12 @@
 
 #ifndef VIDEO_CODEC_LOADER_H
 #define VIDEO_CODEC_LOADER_H
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
 #include "codecbase.h"
 #include "codeclistbase.h"
 
@@ -22,9 +28,10 @@ namespace OHOS {
 namespace MediaAVCodec {
 class VideoCodecLoader {
 public:
-    VideoCodecLoader(const char *libPath, const char *createFuncName, const char *getCapsFuncName)
-        : libPath_(libPath), createFuncName_(createFuncName), getCapsFuncName_(getCapsFuncName){};
-    ~VideoCodecLoader() = default;
+    // resetFuncName names the entry point that resets an instance for reuse, without it nothing is pooled
+    VideoCodecLoader(const char *libPath, const char *createFuncName, const char *getCapsFuncName,
+                     const char *resetFuncName = nullptr);
+    virtual ~VideoCodecLoader();
 
     std::shared_ptr<CodecBase> Create(const std::string &name);
     int32_t GetCaps(std::vector<CapabilityData> &caps);
@@ -32,15 +39,67 @@ public:
     int32_t Init();
     void Close();
 
+protected:
+    enum StartType : uint32_t {
+        START_COLD,   // library loaded and instance created
+        START_WARM,   // library resident, instance created
+        START_POOLED, // Reset()-ed instance taken from the warm pool
+        START_TYPE_BUTT,
+    };
+    using DestroyFunc = void (*)(CodecBase *codec);
+
+    /**
+     * Creates a codec, reusing a pooled instance of the same name when there is one. Released instances are recycled
+     * into the pool and the library stays loaded until it has been idle for persist.media_service.codec_pool.idle_ms.
+     */
+    std::shared_ptr<CodecBase> CreateFromPool(const std::string &name, DestroyFunc destroy);
+    int32_t GetCapsAndRelease(std::vector<CapabilityData> &caps);
+    bool IsLoaded() const
+    {
+        return codecHandle_ != nullptr;
+    }
+    void RecordStart(StartType type, std::chrono::steady_clock::time_point startTime);
+    void GetStartDumpInfo(const std::string &tag, std::string &dumpString);
+
+    std::mutex mutex_;
+
 private:
     using CreateByNameFuncType = void (*)(const std::string &name, std::shared_ptr<CodecBase> &codec);
     using GetCapabilityFuncType = int32_t (*)(std::vector<CapabilityData> &caps);
+    using ResetFuncType = int32_t (*)(CodecBase *codec);
+    struct PooledCodec {
+        std::string name;
+        CodecBase *codec = nullptr;
+        DestroyFunc destroy = nullptr;
+        std::chrono::steady_clock::time_point releaseTime;
+    };
+    struct StartStats {
+        std::atomic<uint64_t> count = 0;
+        std::atomic<int64_t> totalUs = 0;
+    };
+
+    void Recycle(const std::string &name, CodecBase *codec, DestroyFunc destroy);
+    void ReleaseLibrary();
+    void ReapIdle();
+
     std::shared_ptr<void> codecHandle_ = nullptr;
     CreateByNameFuncType createFunc_ = nullptr;
     GetCapabilityFuncType getCapsFunc_ = nullptr;
+    ResetFuncType resetFunc_ = nullptr;
     const char *libPath_ = nullptr;
     const char *createFuncName_ = nullptr;
     const char *getCapsFuncName_ = nullptr;
+    const char *resetFuncName_ = nullptr;
+
+    uint32_t poolSize_ = 0;
+    std::chrono::milliseconds idleTtl_ {0};
+    int32_t instanceCount_ = 0;
+    std::list<PooledCodec> pool_; // the most recently released instance is at the front
+    std::chrono::steady_clock::time_point idleSince_;
+    StartStats startStats_[START_TYPE_BUTT];
+    std::unique_ptr<std::thread> reaper_ = nullptr;
+    std::condition_variable reaperCond_;
+    bool reaperExit_ = false;
 };
 } // namespace MediaAVCodec
 } // namespace OHOS
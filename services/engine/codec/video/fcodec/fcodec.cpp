@@ -516,6 +516,37 @@ int32_t FCodec::Release()
     return AVCS_ERR_OK;
 }
 
+int32_t FCodec::ResetForReuse()
+{
+    // back to the state of a new instance, Configure initializes the codec again. The callback is dropped as it
+    // keeps the last owner alive
+    int32_t ret = Release();
+    CHECK_AND_RETURN_RET_LOG(ret == AVCS_ERR_OK, ret, "Reset for reuse failed: cannot release codec");
+    callback_ = nullptr;
+    avCodecContext_ = nullptr;
+    avPacket_ = nullptr;
+    cachedFrame_ = nullptr;
+    width_ = 0;
+    height_ = 0;
+    inputBufferSize_ = 0;
+    outputBufferSize_ = 0;
+    isOutBufSetted_ = false;
+    outputPixelFmt_ = VideoPixelFormat::UNKNOWN;
+    sInfo_ = SurfaceControl();
+    isSendWait_ = false;
+    isSendEos_ = false;
+    decNum_ = 0;
+    if (dumpInFile_ != nullptr) {
+        dumpInFile_->close();
+        dumpInFile_ = nullptr;
+    }
+    if (dumpOutFile_ != nullptr) {
+        dumpOutFile_->close();
+        dumpOutFile_ = nullptr;
+    }
+    return AVCS_ERR_OK;
+}
+
 void FCodec::SetSurfaceParameter(const Format &format, const std::string_view &formatKey, FormatDataType formatType)
 {
     CHECK_AND_RETURN_LOG(formatType == FORMAT_TYPE_INT32, "Set parameter failed: type should be int32");
@@ -31,5 +31,10 @@ void CreateFCodecByName(const std::string &name, std::shared_ptr<CodecBase> &cod
     fcodec->IncStrongRef(fcodec.GetRefPtr());
     codec = std::shared_ptr<FCodec>(fcodec.GetRefPtr(), [](FCodec *ptr) { (void)ptr; });
 }
+
+int32_t ResetFCodecForReuse(CodecBase *codec)
+{
+    return static_cast<FCodec *>(codec)->ResetForReuse();
+}
 }
 } // namespace OHOS::MediaAVCodec::Codec
\ No newline at end of file
@@ -25,6 +25,7 @@ namespace OHOS::MediaAVCodec {
 extern "C" {  // these functions will be dlsym by avcodec
 int32_t GetCodecCapabilityList(std::vector<CapabilityData> &caps);
 void CreateCodecByName(const std::string& name, std::shared_ptr<CodecBase>& codec);
+int32_t ResetFCodecForReuse(CodecBase *codec);
 }
 }
 
@@ -26,49 +26,32 @@ constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_FRAMEWORK, "
 const char *FCODEC_LIB_PATH = "libfcodec.z.so";
 const char *FCODEC_CREATE_FUNC_NAME = "CreateFCodecByName";
 const char *FCODEC_GETCAPS_FUNC_NAME = "GetFCodecCapabilityList";
+const char *FCODEC_RESET_FUNC_NAME = "ResetFCodecForReuse";
 
+void DestroyFCodec(CodecBase *ptr)
+{
+    FCodec *codec = reinterpret_cast<FCodec *>(ptr);
+    codec->DecStrongRef(codec);
+}
 } // namespace
 std::shared_ptr<CodecBase> FCodecLoader::CreateByName(const std::string &name)
 {
-    FCodecLoader &loader = GetInstance();
-
-    CodecBase *noDeleterPtr = nullptr;
-    {
-        std::lock_guard<std::mutex> lock(loader.mutex_);
-        CHECK_AND_RETURN_RET_LOG(loader.Init() == AVCS_ERR_OK, nullptr, "Create codec by name failed: init error");
-        noDeleterPtr = loader.Create(name).get();
-        CHECK_AND_RETURN_RET_LOG(noDeleterPtr != nullptr, nullptr, "Create fcodec by name failed: no memory");
-        ++(loader.fcodecCount_);
-    }
-    auto deleter = [&loader](CodecBase *ptr) {
-        std::lock_guard<std::mutex> lock(loader.mutex_);
-        FCodec *codec = reinterpret_cast<FCodec*>(ptr);
-        codec->DecStrongRef(codec);
-        --(loader.fcodecCount_);
-        loader.CloseLibrary();
-    };
-    return std::shared_ptr<CodecBase>(noDeleterPtr, deleter);
+    return GetInstance().CreateFromPool(name, DestroyFCodec);
 }
 
 int32_t FCodecLoader::GetCapabilityList(std::vector<CapabilityData> &caps)
 {
-    FCodecLoader &loader = GetInstance();
-
-    std::lock_guard<std::mutex> lock(loader.mutex_);
-    CHECK_AND_RETURN_RET_LOG(loader.Init() == AVCS_ERR_OK, AVCS_ERR_UNKNOWN, "Get capability failed: init error");
-    int32_t ret = loader.GetCaps(caps);
-    loader.CloseLibrary();
-    return ret;
+    return GetInstance().GetCapsAndRelease(caps);
 }
 
-FCodecLoader::FCodecLoader() : VideoCodecLoader(FCODEC_LIB_PATH, FCODEC_CREATE_FUNC_NAME, FCODEC_GETCAPS_FUNC_NAME) {}
+void FCodecLoader::GetDumpInfo(std::string &dumpString)
+{
+    GetInstance().GetStartDumpInfo("FCodec", dumpString);
+}
 
-void FCodecLoader::CloseLibrary()
+FCodecLoader::FCodecLoader()
+    : VideoCodecLoader(FCODEC_LIB_PATH, FCODEC_CREATE_FUNC_NAME, FCODEC_GETCAPS_FUNC_NAME, FCODEC_RESET_FUNC_NAME)
 {
-    if (fcodecCount_) {
-        return;
-    }
-    Close();
 }
 
 FCodecLoader &FCodecLoader::GetInstance()
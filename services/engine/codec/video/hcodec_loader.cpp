@@ -28,17 +28,35 @@ const char *HCODEC_GETCAPS_FUNC_NAME = "GetHCodecCapabilityList";
 std::shared_ptr<CodecBase> HCodecLoader::CreateByName(const std::string &name)
 {
     HCodecLoader &loader = GetInstance();
-    CHECK_AND_RETURN_RET_LOG(loader.Init() == AVCS_ERR_OK, nullptr, "Create codec by name failed: init error");
-    return loader.Create(name);
+    auto startTime = std::chrono::steady_clock::now();
+    // hcodec instances own hardware components, only the library is kept resident and never pooled
+    StartType type = START_COLD;
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex_);
+        if (loader.IsLoaded()) {
+            type = START_WARM;
+        }
+        CHECK_AND_RETURN_RET_LOG(loader.Init() == AVCS_ERR_OK, nullptr, "Create codec by name failed: init error");
+    }
+    std::shared_ptr<CodecBase> codec = loader.Create(name);
+    CHECK_AND_RETURN_RET_LOG(codec != nullptr, nullptr, "Create hcodec by name failed: no memory");
+    loader.RecordStart(type, startTime);
+    return codec;
 }
 
 int32_t HCodecLoader::GetCapabilityList(std::vector<CapabilityData> &caps)
 {
     HCodecLoader &loader = GetInstance();
+    std::lock_guard<std::mutex> lock(loader.mutex_);
     CHECK_AND_RETURN_RET_LOG(loader.Init() == AVCS_ERR_OK, AVCS_ERR_UNKNOWN, "Get capability failed: init error");
     return loader.GetCaps(caps);
 }
 
+void HCodecLoader::GetDumpInfo(std::string &dumpString)
+{
+    GetInstance().GetStartDumpInfo("HCodec", dumpString);
+}
+
 HCodecLoader::HCodecLoader() : VideoCodecLoader(HCODEC_LIB_PATH, HCODEC_CREATE_FUNC_NAME, HCODEC_GETCAPS_FUNC_NAME) {}
 
 HCodecLoader &HCodecLoader::GetInstance()
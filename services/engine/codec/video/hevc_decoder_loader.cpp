@@ -26,52 +26,33 @@ constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_FRAMEWORK, "
 const char *HEVC_DECODER_LIB_PATH = "libhevc_decoder.z.so";
 const char *HEVC_DECODER_CREATE_FUNC_NAME = "CreateHevcDecoderByName";
 const char *HEVC_DECODER_GETCAPS_FUNC_NAME = "GetHevcDecoderCapabilityList";
+const char *HEVC_DECODER_RESET_FUNC_NAME = "ResetHevcDecoderForReuse";
+
+void DestroyHevcDecoder(CodecBase *ptr)
+{
+    HevcDecoder *codec = reinterpret_cast<HevcDecoder *>(ptr);
+    codec->DecStrongRef(codec);
+}
 } // namespace
 
 std::shared_ptr<CodecBase> HevcDecoderLoader::CreateByName(const std::string &name)
 {
-    HevcDecoderLoader &loader = GetInstance();
-
-    CodecBase *noDeleterPtr = nullptr;
-    {
-        std::lock_guard<std::mutex> lock(loader.mutex_);
-        CHECK_AND_RETURN_RET_LOG(loader.Init() == AVCS_ERR_OK, nullptr, "Create codec by name failed: init error");
-        noDeleterPtr = loader.Create(name).get();
-        CHECK_AND_RETURN_RET_LOG(noDeleterPtr != nullptr, nullptr, "Create hevcdecoder by name failed: no memory");
-        ++(loader.hevcDecoderCount_);
-    }
-    auto deleter = [&loader](CodecBase *ptr) {
-        std::lock_guard<std::mutex> lock(loader.mutex_);
-        HevcDecoder *codec = reinterpret_cast<HevcDecoder*>(ptr);
-        codec->DecStrongRef(codec);
-        --(loader.hevcDecoderCount_);
-        loader.CloseLibrary();
-    };
-    return std::shared_ptr<CodecBase>(noDeleterPtr, deleter);
+    return GetInstance().CreateFromPool(name, DestroyHevcDecoder);
 }
 
 int32_t HevcDecoderLoader::GetCapabilityList(std::vector<CapabilityData> &caps)
 {
-    HevcDecoderLoader &loader = GetInstance();
-
-    std::lock_guard<std::mutex> lock(loader.mutex_);
-    CHECK_AND_RETURN_RET_LOG(loader.Init() == AVCS_ERR_OK, AVCS_ERR_UNKNOWN, "Get capability failed: init error");
-    int32_t ret = loader.GetCaps(caps);
-    loader.CloseLibrary();
-    return ret;
+    return GetInstance().GetCapsAndRelease(caps);
 }
 
-HevcDecoderLoader::HevcDecoderLoader() : VideoCodecLoader(HEVC_DECODER_LIB_PATH,
-    HEVC_DECODER_CREATE_FUNC_NAME, HEVC_DECODER_GETCAPS_FUNC_NAME) {}
-
-void HevcDecoderLoader::CloseLibrary()
+void HevcDecoderLoader::GetDumpInfo(std::string &dumpString)
 {
-    if (hevcDecoderCount_ != 0) {
-        return;
-    }
-    Close();
+    GetInstance().GetStartDumpInfo("HevcDecoder", dumpString);
 }
 
+HevcDecoderLoader::HevcDecoderLoader() : VideoCodecLoader(HEVC_DECODER_LIB_PATH,
+    HEVC_DECODER_CREATE_FUNC_NAME, HEVC_DECODER_GETCAPS_FUNC_NAME, HEVC_DECODER_RESET_FUNC_NAME) {}
+
 HevcDecoderLoader &HevcDecoderLoader::GetInstance()
 {
     static HevcDecoderLoader loader;
@@ -60,6 +60,7 @@ constexpr uint32_t DEFAULT_TRY_REQ_TIME = 10;
 constexpr int32_t VIDEO_INSTANCE_SIZE = 64;
 constexpr int32_t VIDEO_BLOCKPERFRAME_SIZE = 36864;
 constexpr int32_t VIDEO_BLOCKPERSEC_SIZE = 983040;
+constexpr int32_t DEFAULT_BIT_DEPTH = 8;
 #ifdef BUILD_ENG_VERSION
 constexpr uint32_t PATH_MAX_LEN = 128;
 constexpr char DUMP_PATH[] = "/data/misc/hevcdecoderdump";
@@ -551,6 +552,40 @@ int32_t HevcDecoder::Release()
     return AVCS_ERR_OK;
 }
 
+int32_t HevcDecoder::ResetForReuse()
+{
+    // back to the state of a new instance, Configure initializes the codec again. The callback is dropped as it
+    // keeps the last owner alive
+    int32_t ret = Release();
+    CHECK_AND_RETURN_RET_LOG(ret == AVCS_ERR_OK, ret, "Reset for reuse failed: cannot release codec");
+    callback_ = nullptr;
+    cachedFrame_ = nullptr;
+    width_ = 0;
+    height_ = 0;
+    inputBufferSize_ = 0;
+    bitDepth_ = DEFAULT_BIT_DEPTH;
+    isOutBufSetted_ = false;
+    outputPixelFmt_ = VideoPixelFormat::UNKNOWN;
+    sInfo_ = SurfaceControl();
+    surface_ = nullptr;
+    isSendEos_ = false;
+#ifdef BUILD_ENG_VERSION
+    if (dumpInFile_ != nullptr) {
+        dumpInFile_->close();
+        dumpInFile_ = nullptr;
+    }
+    if (dumpOutFile_ != nullptr) {
+        dumpOutFile_->close();
+        dumpOutFile_ = nullptr;
+    }
+    if (dumpConvertFile_ != nullptr) {
+        dumpConvertFile_->close();
+        dumpConvertFile_ = nullptr;
+    }
+#endif
+    return AVCS_ERR_OK;
+}
+
 void HevcDecoder::SetSurfaceParameter(const Format &format, const std::string_view &formatKey,
                                       FormatDataType formatType)
 {
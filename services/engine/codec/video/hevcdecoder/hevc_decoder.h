@@ -55,6 +55,7 @@ public:
     int32_t Flush() override;
     int32_t Reset() override;
     int32_t Release() override;
+    int32_t ResetForReuse();
     int32_t SetParameter(const Format &format) override;
     int32_t GetOutputFormat(Format &format) override;
 
@@ -31,5 +31,10 @@ void CreateHevcDecoderByName(const std::string &name, std::shared_ptr<CodecBase>
     hevcDecoder->IncStrongRef(hevcDecoder.GetRefPtr());
     codec = std::shared_ptr<HevcDecoder>(hevcDecoder.GetRefPtr(), [](HevcDecoder *ptr) { (void)ptr; });
 }
+
+int32_t ResetHevcDecoderForReuse(CodecBase *codec)
+{
+    return static_cast<HevcDecoder *>(codec)->ResetForReuse();
+}
 }
 } // namespace OHOS::MediaAVCodec::Codec
\ No newline at end of file
@@ -25,6 +25,7 @@ namespace OHOS::MediaAVCodec {
 extern "C" {  // these functions will be dlsym by avcodec
 int32_t GetHevcDecoderCapabilityList(std::vector<CapabilityData> &caps);
 void CreateHevcDecoderByName(const std::string& name, std::shared_ptr<CodecBase>& codec);
+int32_t ResetHevcDecoderForReuse(CodecBase *codec);
 }
 }
 
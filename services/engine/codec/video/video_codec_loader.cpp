@@ -13,16 +13,51 @@
  * limitations under the License.
  */
 #include "video_codec_loader.h"
+#include <algorithm>
 #include <dlfcn.h>
 #include "avcodec_errors.h"
 #include "avcodec_log.h"
+#include "syspara/parameters.h"
 
 namespace OHOS {
 namespace MediaAVCodec {
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_FRAMEWORK, "VideoCodecLoader"};
+constexpr int32_t DEFAULT_POOL_SIZE = 2;      // pooled instances per codec name
+constexpr int32_t MAX_POOL_SIZE = 8;
+constexpr int32_t DEFAULT_IDLE_TTL_MS = 10000;
+constexpr int32_t MAX_IDLE_TTL_MS = 600000;
+const char *START_TYPE_NAMES[] = {"cold", "warm", "pooled"};
 } // namespace
 
+VideoCodecLoader::VideoCodecLoader(const char *libPath, const char *createFuncName, const char *getCapsFuncName,
+                                   const char *resetFuncName)
+    : libPath_(libPath), createFuncName_(createFuncName), getCapsFuncName_(getCapsFuncName),
+      resetFuncName_(resetFuncName)
+{
+    idleTtl_ = std::chrono::milliseconds(OHOS::system::GetIntParameter<int32_t>(
+        "persist.media_service.codec_pool.idle_ms", DEFAULT_IDLE_TTL_MS, 0, MAX_IDLE_TTL_MS));
+    // without an idle ttl nothing is kept warm, which is the behaviour of unloading on the last release
+    poolSize_ = idleTtl_.count() == 0 ? 0 : static_cast<uint32_t>(OHOS::system::GetIntParameter<int32_t>(
+        "persist.media_service.codec_pool.size", DEFAULT_POOL_SIZE, 0, MAX_POOL_SIZE));
+}
+
+VideoCodecLoader::~VideoCodecLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reaperExit_ = true;
+    }
+    reaperCond_.notify_all();
+    if (reaper_ != nullptr && reaper_->joinable()) {
+        reaper_->join();
+    }
+    for (auto &item : pool_) {
+        item.destroy(item.codec);
+    }
+    pool_.clear();
+}
+
 int32_t VideoCodecLoader::Init()
 {
     if (codecHandle_ != nullptr) {
@@ -37,9 +72,17 @@ int32_t VideoCodecLoader::Init()
     auto getCapsFunc = reinterpret_cast<GetCapabilityFuncType>(dlsym(handle, getCapsFuncName_));
     CHECK_AND_RETURN_RET_LOG(getCapsFunc != nullptr, AVCS_ERR_UNKNOWN, "Load getCapsFunc failed: %{public}s",
                              getCapsFuncName_);
+    ResetFuncType resetFunc = nullptr;
+    if (resetFuncName_ != nullptr) {
+        resetFunc = reinterpret_cast<ResetFuncType>(dlsym(handle, resetFuncName_));
+        if (resetFunc == nullptr) {
+            AVCODEC_LOGW("Load resetFunc failed: %{public}s, instances are not pooled", resetFuncName_);
+        }
+    }
     codecHandle_ = handleSP;
     createFunc_ = createFunc;
     getCapsFunc_ = getCapsFunc;
+    resetFunc_ = resetFunc;
 
     AVCODEC_LOGI("Init library:%{public}s", libPath_);
     return AVCS_ERR_OK;
@@ -50,6 +93,7 @@ void VideoCodecLoader::Close()
     codecHandle_ = nullptr;
     createFunc_ = nullptr;
     getCapsFunc_ = nullptr;
+    resetFunc_ = nullptr;
     AVCODEC_LOGI("Close library:%{public}s", libPath_);
 }
 
@@ -64,5 +108,129 @@ int32_t VideoCodecLoader::GetCaps(std::vector<CapabilityData> &caps)
 {
     return getCapsFunc_(caps);
 }
+
+std::shared_ptr<CodecBase> VideoCodecLoader::CreateFromPool(const std::string &name, DestroyFunc destroy)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    CodecBase *noDeleterPtr = nullptr;
+    StartType type = START_POOLED;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = std::find_if(pool_.begin(), pool_.end(), [&name](const PooledCodec &item) {
+            return item.name == name;
+        });
+        if (iter != pool_.end()) {
+            noDeleterPtr = iter->codec;
+            pool_.erase(iter);
+        } else {
+            type = codecHandle_ == nullptr ? START_COLD : START_WARM;
+            CHECK_AND_RETURN_RET_LOG(Init() == AVCS_ERR_OK, nullptr, "Create codec by name failed: init error");
+            noDeleterPtr = Create(name).get();
+            CHECK_AND_RETURN_RET_LOG(noDeleterPtr != nullptr, nullptr, "Create codec by name failed: no memory");
+        }
+        ++instanceCount_;
+    }
+    RecordStart(type, startTime);
+    auto deleter = [this, name, destroy](CodecBase *ptr) { Recycle(name, ptr, destroy); };
+    return std::shared_ptr<CodecBase>(noDeleterPtr, deleter);
+}
+
+int32_t VideoCodecLoader::GetCapsAndRelease(std::vector<CapabilityData> &caps)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(Init() == AVCS_ERR_OK, AVCS_ERR_UNKNOWN, "Get capability failed: init error");
+    int32_t ret = GetCaps(caps);
+    ReleaseLibrary();
+    return ret;
+}
+
+void VideoCodecLoader::RecordStart(StartType type, std::chrono::steady_clock::time_point startTime)
+{
+    auto costUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+    startStats_[type].count.fetch_add(1, std::memory_order_relaxed);
+    startStats_[type].totalUs.fetch_add(costUs.count(), std::memory_order_relaxed);
+}
+
+void VideoCodecLoader::GetStartDumpInfo(const std::string &tag, std::string &dumpString)
+{
+    std::string info;
+    for (uint32_t i = 0; i < START_TYPE_BUTT; i++) {
+        uint64_t count = startStats_[i].count.load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        info += std::string(info.empty() ? "" : ", ") + START_TYPE_NAMES[i] + ": " + std::to_string(count) +
+            " avg " + std::to_string(startStats_[i].totalUs.load(std::memory_order_relaxed) /
+            static_cast<int64_t>(count));
+    }
+    if (info.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    dumpString += "    " + tag + " - " + info + ", idle pooled: " + std::to_string(pool_.size()) + "\n";
+}
+
+void VideoCodecLoader::Recycle(const std::string &name, CodecBase *codec, DestroyFunc destroy)
+{
+    ResetFuncType reset = nullptr;
+    {
+        // the library stays loaded while this instance is counted
+        std::lock_guard<std::mutex> lock(mutex_);
+        reset = resetFunc_;
+    }
+    // the reset stops codec threads, keep it out of the lock
+    bool reusable = poolSize_ > 0 && reset != nullptr && reset(codec) == AVCS_ERR_OK;
+    std::lock_guard<std::mutex> lock(mutex_);
+    --instanceCount_;
+    auto pooled = std::count_if(pool_.begin(), pool_.end(), [&name](const PooledCodec &item) {
+        return item.name == name;
+    });
+    if (reusable && static_cast<uint32_t>(pooled) < poolSize_) {
+        pool_.push_front({name, codec, destroy, std::chrono::steady_clock::now()});
+    } else {
+        destroy(codec);
+    }
+    ReleaseLibrary();
+}
+
+void VideoCodecLoader::ReleaseLibrary()
+{
+    if (instanceCount_ != 0) {
+        return;
+    }
+    if (idleTtl_.count() == 0) {
+        Close();
+        return;
+    }
+    idleSince_ = std::chrono::steady_clock::now();
+    if (reaper_ == nullptr) {
+        reaper_ = std::make_unique<std::thread>(&VideoCodecLoader::ReapIdle, this);
+    }
+    reaperCond_.notify_one();
+}
+
+void VideoCodecLoader::ReapIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!reaperExit_) {
+        auto now = std::chrono::steady_clock::now();
+        while (!pool_.empty() && pool_.back().releaseTime + idleTtl_ <= now) {
+            pool_.back().destroy(pool_.back().codec);
+            pool_.pop_back();
+        }
+        bool libraryIdle = instanceCount_ == 0 && pool_.empty() && codecHandle_ != nullptr;
+        if (libraryIdle && idleSince_ + idleTtl_ <= now) {
+            AVCODEC_LOGI("Library idle for %{public}lld ms", static_cast<long long>(idleTtl_.count()));
+            Close();
+            libraryIdle = false;
+        }
+        if (pool_.empty() && !libraryIdle) {
+            reaperCond_.wait(lock);
+            continue;
+        }
+        auto deadline = pool_.empty() ? idleSince_ + idleTtl_ : pool_.back().releaseTime + idleTtl_;
+        reaperCond_.wait_until(lock, deadline);
+    }
+}
 } // namespace MediaAVCodec
 } // namespace OHOS
\ No newline at end of file
@@ -379,6 +379,13 @@ int32_t AudioCaptureFilter::GetMaxAmplitude()
     return audioCaptureModule_->GetMaxAmplitude();
 }
 
+Status AudioCaptureFilter::GetAudioLevels(AudioCaptureModule::AudioLevels &levels)
+{
+    FALSE_RETURN_V_MSG_E(audioCaptureModule_ != nullptr, Status::ERROR_INVALID_OPERATION,
+        "audioCaptureModule_ is nullptr, cannot get audio levels");
+    return audioCaptureModule_->GetAudioLevels(levels);
+}
+
 void AudioCaptureFilter::OnLinkedResult(const sptr<AVBufferQueueProducer> &queue, std::shared_ptr<Meta> &meta)
 {
     MEDIA_LOG_I("OnLinkedResult");
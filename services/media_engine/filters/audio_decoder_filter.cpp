@@ -328,6 +328,13 @@ void AudioDecoderFilter::SetDumpFlag(bool isDump)
     }
 }
 
+void AudioDecoderFilter::SetMemoryBudget(uint64_t budgetId)
+{
+    if (mediaCodec_ != nullptr) {
+        mediaCodec_->SetMemoryBudget(budgetId);
+    }
+}
+
 void AudioDecoderFilter::OnLinkedResult(const sptr<AVBufferQueueProducer> &outputBufferQueue,
     std::shared_ptr<Meta> &meta)
 {
@@ -17,9 +17,11 @@
 
 #include "decoder_surface_filter.h"
 #include <sys/time.h>
+#include <unistd.h>
 #include "filter/filter_factory.h"
 #include "plugin/plugin_time.h"
 #include "avcodec_errors.h"
+#include "avcodec_latency_stats.h"
 #include "common/log.h"
 #include "common/media_core.h"
 #include "avcodec_info.h"
@@ -39,6 +41,7 @@ namespace Pipeline {
 static const uint32_t LOCK_WAIT_TIME = 1000; // Lock wait for 1000ms.
 static const int64_t PLAY_RANGE_DEFAULT_VALUE = -1;
 static const int64_t MICROSECONDS_CONVERT_UNIT = 1000; // ms change to us
+static const size_t MAX_LATE_RELEASE_BATCH = 8; // late frames released in one go by the render loop
 
 static AutoRegisterFilter<DecoderSurfaceFilter> g_registerDecoderSurfaceFilter("builtin.player.videodecoder",
     FilterType::FILTERTYPE_VDEC, [](const std::string& name, const FilterType type) {
@@ -196,6 +199,11 @@ Status DecoderSurfaceFilter::Configure(const std::shared_ptr<Meta> &parameter)
     std::shared_ptr<MediaAVCodec::MediaCodecCallback> mediaCodecCallback
         = std::make_shared<FilterMediaCodecCallback>(shared_from_this());
     videoDecoder_->SetCallback(mediaCodecCallback);
+    std::weak_ptr<DecoderSurfaceFilter> weakFilter = shared_from_this();
+    videoDecoder_->SetRenderSlackQuery([weakFilter](int64_t pts) {
+        auto filter = weakFilter.lock();
+        return filter != nullptr ? filter->GetRenderSlackUs(pts) : INT64_MAX;
+    });
     return ret;
 }
 
@@ -463,6 +471,18 @@ Status DecoderSurfaceFilter::GetLagInfo(int32_t& lagTimes, int32_t& maxLagDurati
     return videoDecoder_->GetLagInfo(lagTimes, maxLagDuration, avgLagDuration);
 }
 
+Status DecoderSurfaceFilter::GetLagInfo(int32_t& lagTimes, int32_t& maxLagDuration, int32_t& avgLagDuration,
+    VideoDropInfo& dropInfo)
+{
+    if (videoDecoder_ == nullptr) {
+        return Status::ERROR_INVALID_OPERATION;
+    }
+    dropInfo.skippedBeforeDecode = videoDecoder_->GetSkippedFrameCount();
+    dropInfo.droppedAfterDecode = discardFrameCnt_.load();
+    dropInfo.avgDecodeCostUs = videoDecoder_->GetDecodeCostUs();
+    return videoDecoder_->GetLagInfo(lagTimes, maxLagDuration, avgLagDuration);
+}
+
 void DecoderSurfaceFilter::GetParameter(std::shared_ptr<Meta> &parameter)
 {
     MEDIA_LOG_I("GetParameter enter parameter is valid:  %{public}i", parameter != nullptr);
@@ -604,13 +624,16 @@ Status DecoderSurfaceFilter::ReleaseOutputBuffer(int index, bool render, const s
         }
         return Status::OK;
     }
-    if (renderTime > 0L && render) {
-        videoDecoder_->RenderOutputBufferAtTime(index, renderTime);
-    } else if (outBuffer->pts_ < 0) {
-        MEDIA_LOG_W("Avoid render video frame with pts=%{public}" PUBLIC_LOG_D64, outBuffer->pts_);
-        videoDecoder_->ReleaseOutputBuffer(index, false);
-    } else {
-        videoDecoder_->ReleaseOutputBuffer(index, render);
+    {
+        MediaAVCodec::AVCodecLatencyScope latency(MediaAVCodec::LatencyStage::RENDER);
+        if (renderTime > 0L && render) {
+            videoDecoder_->RenderOutputBufferAtTime(index, renderTime);
+        } else if (outBuffer->pts_ < 0) {
+            MEDIA_LOG_W("Avoid render video frame with pts=%{public}" PUBLIC_LOG_D64, outBuffer->pts_);
+            videoDecoder_->ReleaseOutputBuffer(index, false);
+        } else {
+            videoDecoder_->ReleaseOutputBuffer(index, render);
+        }
     }
     if (!isInSeekContinous_) {
         videoSink_->SetLastPts(outBuffer->pts_);
@@ -655,10 +678,24 @@ int64_t DecoderSurfaceFilter::CalculateNextRender(uint32_t index, std::shared_pt
         MEDIA_LOG_D("DrainOutputBuffer not seeking and render. pts: " PUBLIC_LOG_D64, outputBuffer->pts_);
         videoSink_->SetFirstPts(outputBuffer->pts_);
         waitTime = videoSink_->DoSyncWrite(outputBuffer);
+        if (waitTime >= 0) {
+            renderFrameCnt_++;
+        } else if (!(outputBuffer->flag_ & (uint32_t)(Plugins::AVBufferFlag::EOS))) {
+            discardFrameCnt_++;
+        }
     }
     return waitTime;
 }
 
+int64_t DecoderSurfaceFilter::GetRenderSlackUs(int64_t pts)
+{
+    // frames decoded for seeking, dragging or the first frame are not paced by the clock
+    if (isSeek_.load() || isInSeekContinous_ || doPrepareFrame_.load() || isPaused_.load()) {
+        return INT64_MAX;
+    }
+    return videoSink_->GetRenderSlackUs(pts);
+}
+
 // async filter should call this function
 void DecoderSurfaceFilter::RenderNextOutput(uint32_t index, std::shared_ptr<AVBuffer> &outputBuffer)
 {
@@ -717,6 +754,7 @@ void DecoderSurfaceFilter::DrainOutputBuffer(uint32_t index, std::shared_ptr<AVB
 
 void DecoderSurfaceFilter::RenderLoop()
 {
+    std::vector<std::pair<int, std::shared_ptr<AVBuffer>>> lateTasks;
     while (true) {
         std::pair<int, std::shared_ptr<AVBuffer>> nextTask;
         {
@@ -732,6 +770,20 @@ void DecoderSurfaceFilter::RenderLoop()
             outputBuffers_.pop_front();
         }
         int64_t waitTime = CalculateNextRender(nextTask.first, nextTask.second);
+        // a late frame is held while the frames decoded behind it are late as well, then they are released together
+        while (waitTime < 0 && lateTasks.size() + 1 < MAX_LATE_RELEASE_BATCH) {
+            std::pair<int, std::shared_ptr<AVBuffer>> task;
+            if (!PopOutputBuffer(task)) {
+                break;
+            }
+            lateTasks.push_back(std::move(nextTask));
+            nextTask = std::move(task);
+            waitTime = CalculateNextRender(nextTask.first, nextTask.second);
+        }
+        for (auto &lateTask : lateTasks) {
+            ReleaseOutputBuffer(lateTask.first, false, lateTask.second, -1);
+        }
+        lateTasks.clear();
         MEDIA_LOG_D("RenderLoop pts: " PUBLIC_LOG_D64"  waitTime:" PUBLIC_LOG_D64,
             nextTask.second->pts_, waitTime);
         if (waitTime > 0) {
@@ -741,6 +793,15 @@ void DecoderSurfaceFilter::RenderLoop()
     }
 }
 
+bool DecoderSurfaceFilter::PopOutputBuffer(std::pair<int, std::shared_ptr<AVBuffer>> &task)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    FALSE_RETURN_V(!outputBuffers_.empty() && !isPaused_.load() && !isThreadExit_.load(), false);
+    task = std::move(outputBuffers_.front());
+    outputBuffers_.pop_front();
+    return true;
+}
+
 Status DecoderSurfaceFilter::SetVideoSurface(sptr<Surface> videoSurface)
 {
     if (!videoSurface) {
@@ -829,6 +890,11 @@ int32_t DecoderSurfaceFilter::GetDecRateUpperLimit()
 void DecoderSurfaceFilter::OnDumpInfo(int32_t fd)
 {
     MEDIA_LOG_D("DecoderSurfaceFilter::OnDumpInfo called.");
+    std::string dumpString = "DecoderSurfaceFilter rendered frames:" + std::to_string(renderFrameCnt_.load()) +
+        ", late frames dropped after decode:" + std::to_string(discardFrameCnt_.load()) + "\n";
+    if (fd >= 0 && write(fd, dumpString.c_str(), dumpString.size()) < 0) {
+        MEDIA_LOG_E("DecoderSurfaceFilter::OnDumpInfo write failed.");
+    }
     if (videoDecoder_ != nullptr) {
         videoDecoder_->OnDumpInfo(fd);
     }
@@ -19,12 +19,15 @@
 #include "avcodec_common.h"
 #include "avcodec_trace.h"
 #include "filter/filter_factory.h"
+#include "audio_decoder_filter.h"
 #include "common/log.h"
 #include "osal/task/autolock.h"
 #include "common/media_core.h"
 #include "demuxer_filter.h"
 #include "media_types.h"
 #include "avcodec_sysevent.h"
+#include "memory_budget.h"
+#include "parameters.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_DOMAIN_SYSTEM_PLAYER, "DemuxerFilter" };
@@ -37,6 +40,11 @@ using namespace MediaAVCodec;
 using MediaType = OHOS::Media::Plugins::MediaType;
 namespace {
     const std::string MIME_IMAGE = "image";
+    constexpr uint64_t BYTES_PER_MB = 1024 * 1024;
+    constexpr int32_t DEFAULT_SESSION_MEMORY_LIMIT_MB = 256;
+    // 0 only accounts the session, nothing is reclaimed or throttled
+    const uint64_t SESSION_MEMORY_LIMIT = static_cast<uint64_t>(OHOS::system::GetIntParameter<int32_t>(
+        "persist.media_service.session_memory_limit_mb", DEFAULT_SESSION_MEMORY_LIMIT_MB, 0, INT32_MAX)) * BYTES_PER_MB;
 }
 static AutoRegisterFilter<DemuxerFilter> g_registerAudioCaptureFilter(
     "builtin.player.demuxer", FilterType::FILTERTYPE_DEMUXER,
@@ -103,6 +111,10 @@ private:
 DemuxerFilter::DemuxerFilter(std::string name, FilterType type) : Filter(name, type)
 {
     demuxer_ = std::make_shared<MediaDemuxer>();
+    memoryBudget_ = MemoryBudget::Create(name, SESSION_MEMORY_LIMIT);
+    if (memoryBudget_ != nullptr) {
+        demuxer_->SetMemoryBudget(memoryBudget_->GetId());
+    }
     AutoLock lock(mapMutex_);
     track_id_map_.clear();
 }
@@ -159,6 +171,16 @@ void DemuxerFilter::SetBundleName(const std::string& bundleName)
     }
 }
 
+void DemuxerFilter::SetMemoryBudget(uint64_t budgetId)
+{
+    auto budget = MemoryBudget::Find(budgetId);
+    FALSE_RETURN_MSG(budget != nullptr, "Memory budget " PUBLIC_LOG_U64 " not found", budgetId);
+    memoryBudget_ = budget;
+    if (demuxer_ != nullptr) {
+        demuxer_->SetMemoryBudget(budgetId);
+    }
+}
+
 void DemuxerFilter::SetCallerInfo(uint64_t instanceId, const std::string& appName)
 {
     instanceId_ = instanceId;
@@ -527,6 +549,9 @@ Status DemuxerFilter::LinkNext(const std::shared_ptr<Filter> &nextFilter, Stream
     nextFiltersMap_[outType].push_back(nextFilter_);
     MEDIA_LOG_I_SHORT("LinkNext NextFilter FilterType " PUBLIC_LOG_D32, nextFilter_->GetFilterType());
     meta->SetData(Tag::REGULAR_TRACK_ID, trackId);
+    if (memoryBudget_ != nullptr && nextFilter->GetFilterType() == FilterType::FILTERTYPE_ADEC) {
+        std::static_pointer_cast<AudioDecoderFilter>(nextFilter)->SetMemoryBudget(memoryBudget_->GetId());
+    }
     std::shared_ptr<FilterLinkCallback> filterLinkCallback
         = std::make_shared<DemuxerFilterLinkCallback>(shared_from_this());
     return nextFilter->OnLinked(outType, meta, filterLinkCallback);
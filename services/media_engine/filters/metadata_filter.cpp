@@ -22,6 +22,7 @@
 #include "avcodec_common.h"
 #include "avcodec_trace.h"
 #include "common/log.h"
+#include "surface_buffer_forwarder.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_DOMAIN_METADATA, "HiStreamer" };
@@ -150,6 +151,10 @@ sptr<Surface> MetaDataFilter::GetInputMetaSurface()
         MEDIA_LOG_E("Create the surface consumer fail");
         return nullptr;
     }
+    // forwarded buffers stay with the muxer until it wrote them, the default queue is too short for that
+    if (consumerSurface->SetQueueSize(SurfaceBufferForwarder::SURFACE_QUEUE_SIZE) != GSERROR_OK) {
+        MEDIA_LOG_W("set consumer queue size " PUBLIC_LOG_U32 " fail", SurfaceBufferForwarder::SURFACE_QUEUE_SIZE);
+    }
     GSError err = consumerSurface->SetDefaultUsage(METASURFACE_USAGE);
     if (err == GSERROR_OK) {
         MEDIA_LOG_I("set consumer usage 0x%{public}x succ", METASURFACE_USAGE);
@@ -212,6 +217,9 @@ Status MetaDataFilter::DoStop()
     MEDIA_LOG_I("Stop");
     MediaAVCodec::AVCodecTrace trace("MetaDataFilter::Stop");
     isStop_ = true;
+    if (forwarder_ != nullptr) {
+        forwarder_->Reclaim();
+    }
     latestBufferTime_ = TIME_NONE;
     latestPausedTime_ = TIME_NONE;
     totalPausedTime_ = 0;
@@ -306,6 +314,15 @@ void MetaDataFilter::OnLinkedResult(const sptr<AVBufferQueueProducer> &outputBuf
     MEDIA_LOG_I("OnLinkedResult");
     MediaAVCodec::AVCodecTrace trace("MetaDataFilter::OnLinkedResult");
     outputBufferQueueProducer_ = outputBufferQueue;
+    // the forwarder is destroyed before inputSurface_, it returns the buffers the muxer gives back
+    auto release = [this](const sptr<SurfaceBuffer> &buffer) {
+        if (inputSurface_ != nullptr) {
+            inputSurface_->ReleaseBuffer(buffer, -1);
+        }
+    };
+    forwarder_ = std::make_shared<SurfaceBufferForwarder>("OS_TimedMeta", release);
+    Status ret = forwarder_->SetOutputBufferQueue(outputBufferQueueProducer_);
+    FALSE_LOG_MSG(ret == Status::OK, "SetOutputBufferQueue fail");
 }
 
 void MetaDataFilter::OnUpdatedResult(std::shared_ptr<Meta> &meta)
@@ -328,9 +345,7 @@ void MetaDataFilter::OnBufferAvailable()
     OHOS::Rect damage;
     GSError ret = inputSurface_->AcquireBuffer(buffer, fence, timestamp, damage);
     FALSE_RETURN(ret == GSERROR_OK && buffer != nullptr);
-    constexpr uint32_t waitForEver = -1;
-    (void)fence->Wait(waitForEver);
-    if (isStop_) {
+    if (isStop_ || forwarder_ == nullptr) {
         inputSurface_->ReleaseBuffer(buffer, -1);
         return;
     }
@@ -345,30 +360,14 @@ void MetaDataFilter::OnBufferAvailable()
         inputSurface_->ReleaseBuffer(buffer, -1);
         return;
     }
-
-    std::shared_ptr<AVBuffer> emptyOutputBuffer;
-    AVBufferConfig avBufferConfig;
-    avBufferConfig.size = bufferSize;
-    avBufferConfig.memoryType = MemoryType::SHARED_MEMORY;
-    avBufferConfig.memoryFlag = MemoryFlag::MEMORY_READ_WRITE;
-    int32_t timeOutMs = 100;
-    Status status = outputBufferQueueProducer_->RequestBuffer(emptyOutputBuffer, avBufferConfig, timeOutMs);
-    if (status != Status::OK) {
-        MEDIA_LOG_E("RequestBuffer fail.");
-        inputSurface_->ReleaseBuffer(buffer, -1);
-        return;
-    }
-    std::shared_ptr<AVMemory> &bufferMem = emptyOutputBuffer->memory_;
-    if (emptyOutputBuffer->memory_ == nullptr) {
-        MEDIA_LOG_I("emptyOutputBuffer->memory_ is nullptr.");
-        inputSurface_->ReleaseBuffer(buffer, -1);
-        return;
-    }
-    bufferMem->Write((const uint8_t *)buffer->GetVirAddr(), bufferSize, 0);
-    UpdateBufferConfig(emptyOutputBuffer, timestamp);
-    status = outputBufferQueueProducer_->PushBuffer(emptyOutputBuffer, true);
-    FALSE_LOG_MSG(status == Status::OK, "PushBuffer fail");
-    inputSurface_->ReleaseBuffer(buffer, -1);
+    forwarder_->Forward(buffer, fence, [this, timestamp, bufferSize](const sptr<SurfaceBuffer> &buffer,
+        std::shared_ptr<AVBuffer> &output) {
+        FALSE_RETURN_V_MSG_E(bufferSize >= 0 && static_cast<uint32_t>(bufferSize) <= buffer->GetSize(), false,
+            "invalid data size " PUBLIC_LOG_D32, bufferSize);
+        output->memory_->SetSize(bufferSize);
+        UpdateBufferConfig(output, timestamp);
+        return true;
+    });
 }
 
 void MetaDataFilter::UpdateBufferConfig(std::shared_ptr<AVBuffer> buffer, int64_t timestamp)
@@ -108,6 +108,20 @@ Status MuxerFilter::SetTransCoderMode()
     return Status::OK;
 }
  
+Status MuxerFilter::SetFragmentedOutput(int32_t fragmentDurationMs)
+{
+    MEDIA_LOG_I("SetFragmentedOutput, fragmentDurationMs:" PUBLIC_LOG_D32, fragmentDurationMs);
+    FALSE_RETURN_V_MSG_E(mediaMuxer_ != nullptr, Status::ERROR_WRONG_STATE, "output parameter is not set");
+    std::shared_ptr<Meta> param = std::make_shared<Meta>();
+    param->SetData("fragmented_mp4", 1);
+    param->SetData("fragment_duration", fragmentDurationMs);
+    Status ret = mediaMuxer_->SetParameter(param);
+    if (ret != Status::OK) {
+        SetFaultEvent("MuxerFilter::SetFragmentedOutput error", (int32_t)ret);
+    }
+    return ret;
+}
+
 int64_t MuxerFilter::GetCurrentPtsMs()
 {
     if (lastVideoPts_ != 0) {
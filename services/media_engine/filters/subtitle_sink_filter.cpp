@@ -205,6 +205,10 @@ void SubtitleSinkFilter::SetSyncCenter(std::shared_ptr<MediaSyncManager> syncCen
 Status SubtitleSinkFilter::OnUpdated(StreamType inType, const std::shared_ptr<Meta>& meta,
     const std::shared_ptr<FilterLinkCallback>& callback)
 {
+    // another subtitle track is linked, the cues of the previous one must not show up
+    if (subtitleSink_ != nullptr) {
+        subtitleSink_->Flush();
+    }
     return Filter::OnUpdated(inType, meta, callback);
 }
 
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "surface_buffer_forwarder.h"
+#include <chrono>
+#include "iremote_stub.h"
+#include "avcodec_trace.h"
+#include "common/log.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_DOMAIN_SYSTEM_PLAYER, "SurfaceBufferForwarder" };
+constexpr int32_t FENCE_WAIT_TIMEOUT_MS = 3000;
+constexpr int32_t DRAIN_TIMEOUT_MS = 1000;
+constexpr int32_t DRAIN_POLL_MS = 10;
+}
+
+namespace OHOS {
+namespace Media {
+class SurfaceBufferForwarder::ProducerListener : public IRemoteStub<IProducerListener> {
+public:
+    explicit ProducerListener(std::weak_ptr<SurfaceBufferForwarder> forwarder) : forwarder_(std::move(forwarder)) {}
+
+    virtual ~ProducerListener() = default;
+
+    int OnRemoteRequest(uint32_t code, MessageParcel& arguments, MessageParcel& reply, MessageOption& option) override
+    {
+        return IPCObjectStub::OnRemoteRequest(code, arguments, reply, option);
+    }
+
+    // runs on the consumer thread inside its release, the wrappers are taken back on the forwarder task
+    void OnBufferAvailable() override
+    {
+        if (auto forwarder = forwarder_.lock()) {
+            SurfaceBufferForwarder *ptr = forwarder.get();
+            forwarder->task_->SubmitJobOnce([ptr] { ptr->Reclaim(); });
+        }
+    }
+
+private:
+    std::weak_ptr<SurfaceBufferForwarder> forwarder_;
+};
+
+SurfaceBufferForwarder::SurfaceBufferForwarder(const std::string &name, ReleaseCallback release)
+    : release_(std::move(release))
+{
+    task_ = std::make_unique<Task>(name, "", TaskType::VIDEO, TaskPriority::HIGH, false);
+}
+
+SurfaceBufferForwarder::~SurfaceBufferForwarder()
+{
+    task_->Stop();
+    std::unique_lock<std::mutex> lock(mutex_);
+    // the producer listener no longer reaches this object, releases by the consumer are polled for
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DRAIN_TIMEOUT_MS);
+    ReclaimLocked();
+    while (!inFlight_.empty() && std::chrono::steady_clock::now() < deadline) {
+        reclaimCond_.wait_for(lock, std::chrono::milliseconds(DRAIN_POLL_MS));
+        ReclaimLocked();
+    }
+    FALSE_RETURN_MSG(inFlight_.empty(), "consumer still holds " PUBLIC_LOG_ZU " buffers, left to it",
+        inFlight_.size());
+}
+
+Status SurfaceBufferForwarder::SetOutputBufferQueue(const sptr<AVBufferQueueProducer> &producer)
+{
+    FALSE_RETURN_V_MSG_E(producer != nullptr, Status::ERROR_NULL_POINTER, "producer is nullptr");
+    std::lock_guard<std::mutex> lock(mutex_);
+    producer_ = producer;
+    sptr<IProducerListener> listener = OHOS::sptr<ProducerListener>::MakeSptr(weak_from_this());
+    return producer_->SetBufferAvailableListener(listener);
+}
+
+void SurfaceBufferForwarder::Forward(const sptr<SurfaceBuffer> &buffer, const sptr<SyncFence> &fence,
+    FillCallback fill)
+{
+    task_->SubmitJobOnce([this, buffer, fence, fill = std::move(fill)] { DoForward(buffer, fence, fill); });
+}
+
+void SurfaceBufferForwarder::Reclaim()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReclaimLocked();
+}
+
+size_t SurfaceBufferForwarder::GetInFlightCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inFlight_.size();
+}
+
+void SurfaceBufferForwarder::DoForward(const sptr<SurfaceBuffer> &buffer, const sptr<SyncFence> &fence,
+    const FillCallback &fill)
+{
+    MediaAVCodec::AVCodecTrace trace("SurfaceBufferForwarder::DoForward");
+    if (fence != nullptr && fence->Wait(FENCE_WAIT_TIMEOUT_MS) < 0) {
+        MEDIA_LOG_E("wait fence failed");
+        release_(buffer);
+        return;
+    }
+    std::shared_ptr<AVBuffer> wrapper = AVBuffer::CreateAVBuffer(buffer);
+    if (wrapper == nullptr || wrapper->memory_ == nullptr || !fill(buffer, wrapper)) {
+        release_(buffer);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (producer_ == nullptr) {
+        release_(buffer);
+        return;
+    }
+    ReclaimLocked();
+    if (producer_->AttachBuffer(wrapper, false) != Status::OK) {
+        MEDIA_LOG_E("AttachBuffer failed, in flight: " PUBLIC_LOG_ZU, inFlight_.size());
+        release_(buffer);
+        return;
+    }
+    inFlight_[wrapper->GetUniqueId()] = {wrapper, buffer};
+    if (!Push(wrapper)) {
+        MEDIA_LOG_E("PushBuffer failed");
+    }
+}
+
+bool SurfaceBufferForwarder::Push(const std::shared_ptr<AVBuffer> &wrapper)
+{
+    // the wrapper was attached as a free buffer, released wrappers still in the free list may be handed out first
+    uint64_t id = wrapper->GetUniqueId();
+    for (size_t i = 0; i < inFlight_.size(); i++) {
+        std::shared_ptr<AVBuffer> requested;
+        AVBufferConfig config;
+        if (producer_->RequestBuffer(requested, config, 0) != Status::OK || requested == nullptr) {
+            break;
+        }
+        if (requested->GetUniqueId() == id) {
+            if (producer_->PushBuffer(requested, true) == Status::OK) {
+                return true;
+            }
+            break;
+        }
+        if (!ReclaimOne(requested)) {
+            producer_->PushBuffer(requested, false);
+            break;
+        }
+    }
+    // a wrapper that cannot be detached stays in flight and is reclaimed once the queue hands it out
+    if (producer_->DetachBuffer(wrapper) == Status::OK) {
+        release_(inFlight_[id].surfaceBuffer);
+        inFlight_.erase(id);
+    }
+    return false;
+}
+
+bool SurfaceBufferForwarder::ReclaimOne(const std::shared_ptr<AVBuffer> &buffer)
+{
+    auto it = inFlight_.find(buffer->GetUniqueId());
+    if (it == inFlight_.end()) {
+        return false;
+    }
+    producer_->DetachBuffer(buffer);
+    release_(it->second.surfaceBuffer);
+    inFlight_.erase(it);
+    reclaimCond_.notify_all();
+    return true;
+}
+
+void SurfaceBufferForwarder::ReclaimLocked()
+{
+    if (producer_ == nullptr) {
+        return;
+    }
+    while (!inFlight_.empty()) {
+        std::shared_ptr<AVBuffer> buffer;
+        AVBufferConfig config;
+        if (producer_->RequestBuffer(buffer, config, 0) != Status::OK || buffer == nullptr) {
+            return;
+        }
+        if (!ReclaimOne(buffer)) {
+            producer_->PushBuffer(buffer, false);
+            return;
+        }
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FILTERS_SURFACE_BUFFER_FORWARDER_H
+#define FILTERS_SURFACE_BUFFER_FORWARDER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "surface.h"
+#include "sync_fence.h"
+#include "buffer/avbuffer.h"
+#include "buffer/avbuffer_queue_producer.h"
+#include "common/status.h"
+#include "osal/task/task.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Hands encoded SurfaceBuffers to an AVBufferQueue without copying the payload.
+ *
+ * Each SurfaceBuffer is wrapped in a surface backed AVBuffer, attached to the output queue and pushed. After the
+ * consumer released a wrapper it is requested back and detached, and the SurfaceBuffer goes back to the surface.
+ * Fence waits and hand-offs run in order on a task of their own, so the surface callback thread never blocks.
+ */
+class SurfaceBufferForwarder : public std::enable_shared_from_this<SurfaceBufferForwarder> {
+public:
+    // The muxer interleaver holds up to half of its 10 buffer queue per track, one more is being written, and the
+    // producer needs a free slot to keep encoding. A smaller surface queue stalls the encoder behind the muxer.
+    static constexpr uint32_t SURFACE_QUEUE_SIZE = 8;
+
+    // Sets size, pts and flags of the wrapper, returning false drops the frame
+    using FillCallback = std::function<bool(const sptr<SurfaceBuffer> &buffer, std::shared_ptr<AVBuffer> &output)>;
+    // Returns a SurfaceBuffer to the surface it was acquired from
+    using ReleaseCallback = std::function<void(const sptr<SurfaceBuffer> &buffer)>;
+
+    SurfaceBufferForwarder(const std::string &name, ReleaseCallback release);
+    // Waits a bounded time for the consumer to release the wrappers it holds. Wrappers it still holds afterwards
+    // are neither detached nor released, they keep their SurfaceBuffer alive until the queue drops them.
+    ~SurfaceBufferForwarder();
+
+    Status SetOutputBufferQueue(const sptr<AVBufferQueueProducer> &producer);
+    void Forward(const sptr<SurfaceBuffer> &buffer, const sptr<SyncFence> &fence, FillCallback fill);
+    // Returns the SurfaceBuffers of every wrapper the consumer has released so far
+    void Reclaim();
+    size_t GetInFlightCount();
+
+private:
+    class ProducerListener;
+    struct InFlight {
+        std::shared_ptr<AVBuffer> wrapper;
+        sptr<SurfaceBuffer> surfaceBuffer;
+    };
+
+    void DoForward(const sptr<SurfaceBuffer> &buffer, const sptr<SyncFence> &fence, const FillCallback &fill);
+    bool Push(const std::shared_ptr<AVBuffer> &wrapper);
+    bool ReclaimOne(const std::shared_ptr<AVBuffer> &buffer);
+    void ReclaimLocked();
+
+    std::mutex mutex_;
+    std::condition_variable reclaimCond_;
+    ReleaseCallback release_;
+    sptr<AVBufferQueueProducer> producer_;
+    std::unordered_map<uint64_t, InFlight> inFlight_;
+    std::unique_ptr<Task> task_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // FILTERS_SURFACE_BUFFER_FORWARDER_H
@@ -22,6 +22,7 @@
 #include "avcodec_common.h"
 #include "avcodec_trace.h"
 #include "common/log.h"
+#include "surface_buffer_forwarder.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_DOMAIN_SYSTEM_PLAYER, "VideoCaptureFilter" };
@@ -150,6 +151,10 @@ sptr<Surface> VideoCaptureFilter::GetInputSurface()
         MEDIA_LOG_E("Create the surface consumer fail");
         return nullptr;
     }
+    // forwarded buffers stay with the muxer until it wrote them, the default queue is too short for that
+    if (consumerSurface->SetQueueSize(SurfaceBufferForwarder::SURFACE_QUEUE_SIZE) != GSERROR_OK) {
+        MEDIA_LOG_W("set consumer queue size " PUBLIC_LOG_U32 " fail", SurfaceBufferForwarder::SURFACE_QUEUE_SIZE);
+    }
     GSError err = consumerSurface->SetDefaultUsage(ENCODE_USAGE);
     if (err == GSERROR_OK) {
         MEDIA_LOG_E("set consumer usage 0x%{public}x succ", ENCODE_USAGE);
@@ -212,6 +217,9 @@ Status VideoCaptureFilter::DoStop()
     MEDIA_LOG_I("Stop");
     MediaAVCodec::AVCodecTrace trace("VideoCaptureFilter::Stop");
     isStop_ = true;
+    if (forwarder_ != nullptr) {
+        forwarder_->Reclaim();
+    }
     latestBufferTime_ = TIME_NONE;
     latestPausedTime_ = TIME_NONE;
     totalPausedTime_ = 0;
@@ -306,6 +314,15 @@ void VideoCaptureFilter::OnLinkedResult(const sptr<AVBufferQueueProducer> &outpu
     MEDIA_LOG_I("OnLinkedResult");
     MediaAVCodec::AVCodecTrace trace("VideoCaptureFilter::OnLinkedResult");
     outputBufferQueueProducer_ = outputBufferQueue;
+    // the forwarder is destroyed before inputSurface_, it returns the buffers the muxer gives back
+    auto release = [this](const sptr<SurfaceBuffer> &buffer) {
+        if (inputSurface_ != nullptr) {
+            inputSurface_->ReleaseBuffer(buffer, -1);
+        }
+    };
+    forwarder_ = std::make_shared<SurfaceBufferForwarder>("OS_VideoCapture", release);
+    Status ret = forwarder_->SetOutputBufferQueue(outputBufferQueueProducer_);
+    FALSE_LOG_MSG(ret == Status::OK, "SetOutputBufferQueue fail");
 }
 
 void VideoCaptureFilter::OnUpdatedResult(std::shared_ptr<Meta> &meta)
@@ -320,7 +337,8 @@ void VideoCaptureFilter::OnUnlinkedResult(std::shared_ptr<Meta> &meta)
 
 void VideoCaptureFilter::OnBufferAvailable()
 {
-    MEDIA_LOG_I("OnBufferAvailable");
+    MEDIA_LOG_D("OnBufferAvailable");
+    MediaAVCodec::AVCodecTrace trace("VideoCaptureFilter::OnBufferAvailable");
     sptr<SurfaceBuffer> buffer;
     sptr<SyncFence> fence;
     int64_t timestamp;
@@ -332,9 +350,7 @@ void VideoCaptureFilter::OnBufferAvailable()
         MEDIA_LOG_E("AcquireBuffer failed");
         return;
     }
-    constexpr uint32_t waitForEver = -1;
-    (void)fence->Wait(waitForEver);
-    if (isStop_) {
+    if (isStop_ || forwarder_ == nullptr) {
         inputSurface_->ReleaseBuffer(buffer, -1);
         return;
     }
@@ -344,31 +360,16 @@ void VideoCaptureFilter::OnBufferAvailable()
         extraData->ExtraGet("dataSize", bufferSize);
         extraData->ExtraGet("isKeyFrame", isKeyFrame);
     }
-
-    std::shared_ptr<AVBuffer> emptyOutputBuffer;
-    AVBufferConfig avBufferConfig;
-    avBufferConfig.size = bufferSize;
-    avBufferConfig.memoryType = MemoryType::SHARED_MEMORY;
-    avBufferConfig.memoryFlag = MemoryFlag::MEMORY_READ_WRITE;
-    int32_t timeOutMs = 100;
-    Status status = outputBufferQueueProducer_->RequestBuffer(emptyOutputBuffer, avBufferConfig, timeOutMs);
-    if (status != Status::OK) {
-        MEDIA_LOG_E("RequestBuffer fail.");
-        inputSurface_->ReleaseBuffer(buffer, -1);
-        return;
-    }
-    std::shared_ptr<AVMemory> &bufferMem = emptyOutputBuffer->memory_;
-    if (emptyOutputBuffer->memory_ == nullptr) {
-        MEDIA_LOG_I("emptyOutputBuffer->memory_ is nullptr.");
-        inputSurface_->ReleaseBuffer(buffer, -1);
-        return;
-    }
-    emptyOutputBuffer->flag_ = isKeyFrame != 0 ? static_cast<uint32_t>(Plugins::AVBufferFlag::SYNC_FRAME) : 0;
-    bufferMem->Write((const uint8_t *)buffer->GetVirAddr(), bufferSize, 0);
-    UpdateBufferConfig(emptyOutputBuffer, timestamp);
-    status = outputBufferQueueProducer_->PushBuffer(emptyOutputBuffer, true);
-    FALSE_LOG_MSG(status == Status::OK, "PushBuffer fail");
-    inputSurface_->ReleaseBuffer(buffer, -1);
+    // the fence is waited for on the forwarder task, the encoded payload is handed on without a copy
+    forwarder_->Forward(buffer, fence, [this, timestamp, bufferSize, isKeyFrame](const sptr<SurfaceBuffer> &buffer,
+        std::shared_ptr<AVBuffer> &output) {
+        FALSE_RETURN_V_MSG_E(bufferSize >= 0 && static_cast<uint32_t>(bufferSize) <= buffer->GetSize(), false,
+            "invalid data size " PUBLIC_LOG_D32, bufferSize);
+        output->memory_->SetSize(bufferSize);
+        output->flag_ = isKeyFrame != 0 ? static_cast<uint32_t>(Plugins::AVBufferFlag::SYNC_FRAME) : 0;
+        UpdateBufferConfig(output, timestamp);
+        return true;
+    });
 }
 
 void VideoCaptureFilter::UpdateBufferConfig(std::shared_ptr<AVBuffer> buffer, int64_t timestamp)
@@ -389,7 +390,7 @@ void VideoCaptureFilter::UpdateBufferConfig(std::shared_ptr<AVBuffer> buffer, in
     buffer->pts_ = timestamp - startBufferTime_ - totalPausedTime_;
     buffer->pts_ = buffer->pts_ / NS_PER_US; // the unit of pts is us
     MediaAVCodec::AVCodecTrace trace("VideoCaptureFilter::UpdateBufferConfig");
-    MEDIA_LOG_I("UpdateBufferConfig buffer->pts" PUBLIC_LOG_D64, buffer->pts_);
+    MEDIA_LOG_D("UpdateBufferConfig buffer->pts" PUBLIC_LOG_D64, buffer->pts_);
 }
 
 } // namespace Pipeline
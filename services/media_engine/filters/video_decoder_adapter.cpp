@@ -15,6 +15,7 @@
 #define MEDIA_PIPELINE
 
 #include <malloc.h>
+#include <chrono>
 #include <map>
 #include <unistd.h>
 #include <vector>
@@ -41,6 +42,17 @@ using namespace MediaAVCodec;
 const std::string VIDEO_INPUT_BUFFER_QUEUE_NAME = "VideoDecoderInputBufferQueue";
 //Threshold for frame lag detection, set to 100 milliseconds.
 const int64_t LAG_LIMIT_TIME = 100;
+// Frames dropped inside the decoder never come out, forget them when this many frames are pending
+const size_t MAX_DECODING_FRAME_NUM = 64;
+// Weight of history in the decode cost average, out of DECODE_COST_SMOOTH_BASE
+const int64_t DECODE_COST_SMOOTH_WEIGHT = 7;
+const int64_t DECODE_COST_SMOOTH_BASE = 8;
+
+static int64_t GetSteadyTimeUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 VideoDecoderCallback::VideoDecoderCallback(std::shared_ptr<VideoDecoderAdapter> videoDecoder)
 {
@@ -179,6 +191,11 @@ Status VideoDecoderAdapter::Flush()
     FALSE_RETURN_V_MSG(mediaCodec_ != nullptr, Status::ERROR_INVALID_STATE, "mediaCodec_ is nullptr");
     FALSE_RETURN_V_MSG(isConfigured_, Status::ERROR_INVALID_STATE, "mediaCodec_ is not configured");
     int32_t ret = mediaCodec_->Flush();
+    {
+        std::lock_guard<std::mutex> costLock(decodeCostMutex_);
+        queuedFrames_.clear();
+        decodeStartTimes_.clear();
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     if (inputBufferQueueConsumer_ != nullptr) {
         for (auto &buffer : bufferVector_) {
@@ -269,6 +286,13 @@ void VideoDecoderAdapter::AquireAvailableInputBuffer()
             tmpBuffer->memory_->SetSize(0);
         }
         FALSE_RETURN_MSG(mediaCodec_ != nullptr, "mediaCodec_ is nullptr.");
+        if (CanSkipDecode(tmpBuffer)) {
+            skippedFrameCnt_++;
+            MEDIA_LOG_D_SHORT("Skip late non reference frame, pts: %{public}" PRId64, tmpBuffer->pts_);
+            inputBufferQueueConsumer_->ReleaseBuffer(tmpBuffer);
+            return;
+        }
+        int64_t pts = tmpBuffer->pts_;
         int32_t ret = mediaCodec_->QueueInputBuffer(index);
         if (ret != ERR_OK) {
             MEDIA_LOG_E_SHORT("QueueInputBuffer failed, index: %{public}u,  bufferid: %{public}" PRIu64
@@ -279,6 +303,7 @@ void VideoDecoderAdapter::AquireAvailableInputBuffer()
                     MSERR_DRM_VERIFICATION_FAILED});
             }
         } else {
+            RecordDecodeQueued(index, pts);
             MEDIA_LOG_D_SHORT("QueueInputBuffer success, index: %{public}u,  bufferid: %{public}" PRIu64
                 ", pts: %{public}" PRIu64", flag: %{public}u", index, tmpBuffer->GetUniqueId(),
                 tmpBuffer->pts_, tmpBuffer->flag_);
@@ -291,6 +316,7 @@ void VideoDecoderAdapter::AquireAvailableInputBuffer()
 void VideoDecoderAdapter::OnInputBufferAvailable(uint32_t index, std::shared_ptr<AVBuffer> buffer)
 {
     FALSE_RETURN_MSG(buffer != nullptr && buffer->meta_ != nullptr, "meta_ is nullptr.");
+    RecordDecodeStart(index);
     buffer->meta_->SetData(Tag::REGULAR_TRACK_ID, index);
     if (inputBufferQueueConsumer_ == nullptr) {
         MEDIA_LOG_E_SHORT("inputBufferQueueConsumer_ is null");
@@ -339,10 +365,74 @@ void VideoDecoderAdapter::OnOutputBufferAvailable(uint32_t index, std::shared_pt
         MEDIA_LOG_D_SHORT("OnOutputBufferAvailable start. buffer is nullptr, index: %{public}u", index);
     }
     FALSE_RETURN_MSG(buffer != nullptr, "buffer is nullptr");
+    RecordDecodeEnd(buffer->pts_);
     FALSE_RETURN_MSG(callback_ != nullptr, "callback_ is nullptr");
     callback_->OnOutputBufferAvailable(index, buffer);
 }
 
+void VideoDecoderAdapter::SetRenderSlackQuery(const RenderSlackQuery &query)
+{
+    renderSlackQuery_ = query;
+}
+
+int64_t VideoDecoderAdapter::GetDecodeCostUs()
+{
+    return decodeCostUs_.load();
+}
+
+uint64_t VideoDecoderAdapter::GetSkippedFrameCount()
+{
+    return skippedFrameCnt_.load();
+}
+
+bool VideoDecoderAdapter::CanSkipDecode(const std::shared_ptr<AVBuffer> &buffer)
+{
+    if (renderSlackQuery_ == nullptr || (buffer->flag_ & (uint32_t)(Plugins::AVBufferFlag::EOS))) {
+        return false;
+    }
+    bool canDrop = false;
+    if (!buffer->meta_->GetData(Tag::VIDEO_BUFFER_CAN_DROP, canDrop) || !canDrop) {
+        return false;
+    }
+    int64_t decodeCostUs = decodeCostUs_.load();
+    return decodeCostUs > 0 && renderSlackQuery_(buffer->pts_) < decodeCostUs;
+}
+
+void VideoDecoderAdapter::RecordDecodeQueued(uint32_t index, int64_t pts)
+{
+    std::lock_guard<std::mutex> lock(decodeCostMutex_);
+    queuedFrames_[index] = pts;
+}
+
+// The decoder hands an input slot back once it took the frame, the time waited in its input queue is not decode cost
+void VideoDecoderAdapter::RecordDecodeStart(uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(decodeCostMutex_);
+    auto iter = queuedFrames_.find(index);
+    if (iter == queuedFrames_.end()) {
+        return;
+    }
+    if (decodeStartTimes_.size() >= MAX_DECODING_FRAME_NUM) {
+        decodeStartTimes_.clear();
+    }
+    decodeStartTimes_[iter->second] = GetSteadyTimeUs();
+    queuedFrames_.erase(iter);
+}
+
+void VideoDecoderAdapter::RecordDecodeEnd(int64_t pts)
+{
+    std::lock_guard<std::mutex> lock(decodeCostMutex_);
+    auto iter = decodeStartTimes_.find(pts);
+    if (iter == decodeStartTimes_.end()) {
+        return;
+    }
+    int64_t costUs = GetSteadyTimeUs() - iter->second;
+    decodeStartTimes_.erase(iter);
+    int64_t lastCostUs = decodeCostUs_.load();
+    decodeCostUs_ = lastCostUs == 0 ? costUs :
+        (lastCostUs * DECODE_COST_SMOOTH_WEIGHT + costUs) / DECODE_COST_SMOOTH_BASE;
+}
+
 int32_t VideoDecoderAdapter::GetOutputFormat(Format &format)
 {
     FALSE_RETURN_V_MSG(mediaCodec_ != nullptr, AVCodecServiceErrCode::AVCS_ERR_INVALID_VAL,
@@ -440,6 +530,9 @@ void VideoDecoderAdapter::OnDumpInfo(int32_t fd)
     if (inputBufferQueue_ != nullptr) {
         dumpString += "VideoDecoderAdapter buffer size is:" + std::to_string(inputBufferQueue_->GetQueueSize()) + "\n";
     }
+    dumpString += "VideoDecoderAdapter decode cost(us) is:" + std::to_string(decodeCostUs_.load()) + "\n";
+    dumpString += "VideoDecoderAdapter late frames skipped before decode:" +
+        std::to_string(skippedFrameCnt_.load()) + "\n";
     if (fd < 0) {
         MEDIA_LOG_E_SHORT("VideoDecoderAdapter::OnDumpInfo fd is invalid.");
         return;
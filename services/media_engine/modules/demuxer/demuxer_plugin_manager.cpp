@@ -470,6 +470,7 @@ bool DemuxerPluginManager::InitPlugin(std::shared_ptr<BaseStreamDemuxer> streamD
 
     streamInfoMap_[id].dataSource = std::make_shared<DataSourceImpl>(streamDemuxer, id);
     streamInfoMap_[id].dataSource->SetIsDash(isDash_);
+    streamInfoMap_[id].plugin->SetLocalSource(isLocalSource_);
 
     Status st = streamInfoMap_[id].plugin->SetDataSource(streamInfoMap_[id].dataSource);
     return st == Status::OK;
@@ -480,6 +481,11 @@ bool DemuxerPluginManager::IsDash() const
     return isDash_;
 }
 
+void DemuxerPluginManager::SetLocalSource(bool isLocalSource)
+{
+    isLocalSource_ = isLocalSource;
+}
+
 void DemuxerPluginManager::SetResetEosStatus(bool flag)
 {
     needResetEosStatus_ = flag;
@@ -117,6 +117,7 @@ public:
     int32_t GetInnerTrackID(int32_t trackId);
     bool IsDash() const;
     bool IsSubtitle() const;
+    void SetLocalSource(bool isLocalSource);
     Status StopPlugin(int32_t streamId, std::shared_ptr<BaseStreamDemuxer> streamDemuxer);
     Status StartPlugin(int32_t streamId, std::shared_ptr<BaseStreamDemuxer> streamDemuxer);
     Status StartAllPlugin(std::shared_ptr<BaseStreamDemuxer> streamDemuxer);
@@ -154,6 +155,7 @@ private:
 
     Plugins::MediaInfo curMediaInfo_;
     bool isDash_ = false;
+    bool isLocalSource_ = false;
     bool needResetEosStatus_ = false;
 };
 } // namespace Media
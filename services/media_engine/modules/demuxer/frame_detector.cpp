@@ -15,12 +15,13 @@
 
 #include "frame_detector.h"
 
-#include <algorithm>
 #include <memory>
+#include "nal_unit_scanner.h"
 
 namespace OHOS {
 namespace Media {
 using namespace std;
+using MediaAVCodec::NalUnitScanner;
 
 std::shared_ptr<FrameDetector> FrameDetector::GetFrameDetector(CodeType type)
 {
@@ -38,31 +39,16 @@ std::shared_ptr<FrameDetector> FrameDetector::GetFrameDetector(CodeType type)
 
 bool FrameDetector::IsContainIdrFrame(const uint8_t* buff, size_t bufSize)
 {
-    if (buff == nullptr) {
+    if (buff == nullptr || bufSize > UINT32_MAX - START_CODE_LEN) {
         return false;
     }
-    using FirstByteInNalu = uint8_t;
-    list<pair<size_t, FirstByteInNalu>> posOfNalUnit;
-    size_t pos = 0;
-    while (pos < bufSize) {
-        auto pFound = search(buff + pos, buff + bufSize, begin(START_CODE), end(START_CODE));
-        pos = static_cast<size_t>(distance(buff, pFound));
-        if (pos == bufSize || pos + START_CODE_LEN >= bufSize) { // fail to find startCode or just at the end
-            break;
-        }
-        posOfNalUnit.emplace_back(pos, buff[pos + START_CODE_LEN]);
-        pos += START_CODE_LEN;
-    }
-    for (auto it = posOfNalUnit.begin(); it != posOfNalUnit.end(); ++it) {
-        auto nex = next(it);
-        NALUInfo nal {
-            .startPos = it->first,
-            .endPos = (nex == posOfNalUnit.end()) ? (bufSize) : (nex->first),
-            .nalType = GetNalType(it->second),
-        };
-        if (IsIDR(nal.nalType)) {
+    uint32_t size = static_cast<uint32_t>(bufSize);
+    uint32_t pos = NalUnitScanner::FindStartCode(buff, size, 0);
+    while (pos + START_CODE_LEN < size) { // stop when no startCode is found or it is just at the end
+        if (IsIDR(GetNalType(buff[pos + START_CODE_LEN]))) {
             return true;
         }
+        pos = NalUnitScanner::FindStartCode(buff, size, pos + START_CODE_LEN);
     }
     return false;
 }
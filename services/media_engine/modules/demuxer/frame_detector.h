@@ -36,20 +36,13 @@ protected:
     virtual ~FrameDetector() = default;
 
 private:
-    struct NALUInfo {
-        size_t startPos;
-        size_t endPos;
-        uint8_t nalType;
-    };
-
     virtual uint8_t GetNalType(uint8_t byte) = 0;
     virtual bool IsPPS(uint8_t nalType) = 0;
     virtual bool IsVCL(uint8_t nalType) = 0;
     virtual bool IsIDR(uint8_t nalType) = 0;
     virtual bool IsPrefixSEI(uint8_t nalType) { return false; }
 
-    static constexpr uint8_t START_CODE[] = {0, 0, 1};
-    static constexpr size_t START_CODE_LEN = sizeof(START_CODE);
+    static constexpr uint32_t START_CODE_LEN = 3;
 };
 
 class FrameDetectorH264 : public FrameDetector {
@@ -23,6 +23,7 @@
 #include <map>
 
 #include "avcodec_common.h"
+#include "avcodec_latency_stats.h"
 #include "avcodec_trace.h"
 #include "cpp_ext/type_traits_ext.h"
 #include "buffer/avallocator.h"
@@ -37,6 +38,7 @@
 #include "source/source.h"
 #include "stream_demuxer.h"
 #include "media_core.h"
+#include "memory_budget.h"
 #include "osal/utils/dump_buffer.h"
 #include "demuxer_plugin_manager.h"
 
@@ -578,6 +580,9 @@ Status MediaDemuxer::InnerPrepare()
     if (ret == Status::OK) {
         InitMediaMetaData(mediaInfo);
         InitDefaultTrack(mediaInfo, videoTrackId_, audioTrackId_, subtitleTrackId_, videoMime_);
+        if (memoryBudgetId_ != 0) {
+            ApplyMemoryBudget();
+        }
         if (videoTrackId_ != TRACK_ID_DUMMY) {
             AddDemuxerCopyTask(videoTrackId_, TaskType::VIDEO);
             demuxerPluginManager_->UpdateTempTrackMapInfo(videoTrackId_, videoTrackId_, -1);
@@ -628,6 +633,7 @@ Status MediaDemuxer::SetDataSource(const std::shared_ptr<MediaSource> &source)
     std::vector<StreamInfo> streams;
     source_->GetStreamInfo(streams);
     demuxerPluginManager_->InitDefaultPlay(streams);
+    demuxerPluginManager_->SetLocalSource(source_->IsLocalFile());
 
     streamDemuxer_ = std::make_shared<StreamDemuxer>();
     streamDemuxer_->SetSource(source_);
@@ -759,6 +765,11 @@ void MediaDemuxer::OnDumpInfo(int32_t fd)
     std::string dumpString;
     dumpString += "MediaDemuxer buffer queue map size: " + std::to_string(bufferQueueMap_.size()) + "\n";
     dumpString += "MediaDemuxer buffer map size: " + std::to_string(bufferMap_.size()) + "\n";
+    MediaAVCodec::AVCodecLatencyStats::GetInstance().GetDumpString(dumpString);
+    auto memoryBudget = memoryBudgetId_ == 0 ? nullptr : MediaAVCodec::MemoryBudget::Find(memoryBudgetId_);
+    if (memoryBudget != nullptr) {
+        memoryBudget->GetDumpInfo(dumpString);
+    }
     int ret = write(fd, dumpString.c_str(), dumpString.size());
     if (ret < 0) {
         MEDIA_LOG_E("MediaDemuxer::OnDumpInfo write failed.");
@@ -1073,6 +1084,9 @@ Status MediaDemuxer::SeekTo(int64_t seekTime, Plugins::SeekMode mode, int64_t& r
         Plugins::Ms2HstTime(seekTime, realSeekTime);
     } else {
         MEDIA_LOG_D("SeekTo start");
+        if (source_ != nullptr) {
+            source_->CancelRead();
+        }
         if (mode == SeekMode::SEEK_CLOSEST_INNER) {
             ret = demuxerPluginManager_->SeekTo(seekTime, SeekMode::SEEK_PREVIOUS_SYNC, realSeekTime);
         } else {
@@ -1715,6 +1729,7 @@ if (trackId == videoTrackId_ && VideoStreamReadyCallback_ != nullptr) {
 Status MediaDemuxer::CopyFrameToUserQueue(uint32_t trackId)
 {
     MediaAVCodec::AVCodecTrace trace("MediaDemuxer::CopyFrameToUserQueue");
+    MediaAVCodec::AVCodecLatencyScope latency(MediaAVCodec::LatencyStage::DEMUX);
     MEDIA_LOG_D("CopyFrameToUserQueue enter, track:" PUBLIC_LOG_U32, trackId);
 
     std::shared_ptr<Plugins::DemuxerPlugin> pluginTemp = nullptr;
@@ -1768,25 +1783,19 @@ Status MediaDemuxer::CopyFrameToUserQueue(uint32_t trackId)
     return ret;
 }
 
-Status MediaDemuxer::InnerReadSample(uint32_t trackId, std::shared_ptr<AVBuffer> sample)
+std::shared_ptr<Plugins::DemuxerPlugin> MediaDemuxer::GetPluginByTrackId(uint32_t trackId, int32_t &innerTrackId)
 {
-    MEDIA_LOG_D("copy frame for track " PUBLIC_LOG_U32, trackId);
-
-    int32_t innerTrackID = static_cast<int32_t>(trackId);
-    std::shared_ptr<Plugins::DemuxerPlugin> pluginTemp = nullptr;
+    innerTrackId = static_cast<int32_t>(trackId);
     if (demuxerPluginManager_->IsDash() || demuxerPluginManager_->GetTmpStreamIDByTrackID(subtitleTrackId_) != -1) {
         int32_t streamID = demuxerPluginManager_->GetTmpStreamIDByTrackID(trackId);
-        pluginTemp = demuxerPluginManager_->GetPluginByStreamID(streamID);
-        FALSE_RETURN_V_MSG_E(pluginTemp != nullptr, Status::ERROR_INVALID_PARAMETER,
-            "InnerReadSample failed due to get demuxer plugin failed.");
-        innerTrackID = demuxerPluginManager_->GetTmpInnerTrackIDByTrackID(trackId);
-    } else {
-        pluginTemp = demuxerPluginManager_->GetPluginByStreamID(demuxerPluginManager_->GetStreamIDByTrackID(trackId));
-        FALSE_RETURN_V_MSG_E(pluginTemp != nullptr, Status::ERROR_INVALID_PARAMETER,
-            "InnerReadSample failed due to get demuxer plugin failed.");
+        innerTrackId = demuxerPluginManager_->GetTmpInnerTrackIDByTrackID(trackId);
+        return demuxerPluginManager_->GetPluginByStreamID(streamID);
     }
+    return demuxerPluginManager_->GetPluginByStreamID(demuxerPluginManager_->GetStreamIDByTrackID(trackId));
+}
 
-    Status ret = pluginTemp->ReadSample(innerTrackID, sample);
+void MediaDemuxer::OnReadSampleResult(uint32_t trackId, Status ret)
+{
     if (ret == Status::END_OF_STREAM) {
         MEDIA_LOG_I("Read buffer eos for track " PUBLIC_LOG_U32, trackId);
     } else if (ret == Status::ERROR_NO_MEMORY) {
@@ -1798,6 +1807,19 @@ Status MediaDemuxer::InnerReadSample(uint32_t trackId, std::shared_ptr<AVBuffer>
     } else if (ret != Status::OK) {
         MEDIA_LOG_I("Read buffer error for track " PUBLIC_LOG_U32 ", ret: " PUBLIC_LOG_D32, trackId, (int32_t)(ret));
     }
+}
+
+Status MediaDemuxer::InnerReadSample(uint32_t trackId, std::shared_ptr<AVBuffer> sample)
+{
+    MEDIA_LOG_D("copy frame for track " PUBLIC_LOG_U32, trackId);
+
+    int32_t innerTrackID = static_cast<int32_t>(trackId);
+    std::shared_ptr<Plugins::DemuxerPlugin> pluginTemp = GetPluginByTrackId(trackId, innerTrackID);
+    FALSE_RETURN_V_MSG_E(pluginTemp != nullptr, Status::ERROR_INVALID_PARAMETER,
+        "InnerReadSample failed due to get demuxer plugin failed.");
+
+    Status ret = pluginTemp->ReadSample(innerTrackID, sample);
+    OnReadSampleResult(trackId, ret);
     MEDIA_LOG_D("finish copy frame for track " PUBLIC_LOG_U32, trackId);
 
     // to get DrmInfo
@@ -1874,6 +1896,50 @@ Status MediaDemuxer::ReadSample(uint32_t trackId, std::shared_ptr<AVBuffer> samp
     return ret;
 }
 
+Status MediaDemuxer::ReadSamples(uint32_t trackId, const std::vector<std::shared_ptr<AVBuffer>> &samples,
+    uint32_t maxBytes, uint32_t &readCount)
+{
+    MediaAVCodec::AVCODEC_SYNC_TRACE;
+    readCount = 0;
+    FALSE_RETURN_V_MSG_E(!useBufferQueue_, Status::ERROR_WRONG_STATE,
+        "Cannot call read frame when use buffer queue.");
+    FALSE_RETURN_V_MSG_E(eosMap_.count(trackId) > 0, Status::ERROR_INVALID_OPERATION,
+        "Read samples failed due to track has not been selected");
+    FALSE_RETURN_V_MSG_E(!samples.empty(), Status::ERROR_INVALID_PARAMETER, "Read samples failed due to no sample");
+    for (const auto &sample : samples) {
+        FALSE_RETURN_V_MSG_E(sample != nullptr && sample->memory_ != nullptr, Status::ERROR_INVALID_PARAMETER,
+            "Read samples failed due to input sample is nullptr");
+    }
+    if (eosMap_[trackId]) {
+        MEDIA_LOG_W("Track " PUBLIC_LOG_U32 " has reached eos", trackId);
+        samples[0]->flag_ = (uint32_t)(AVBufferFlag::EOS);
+        samples[0]->memory_->SetSize(0);
+        readCount = 1;
+        return Status::END_OF_STREAM;
+    }
+
+    int32_t innerTrackID = static_cast<int32_t>(trackId);
+    std::shared_ptr<Plugins::DemuxerPlugin> pluginTemp = GetPluginByTrackId(trackId, innerTrackID);
+    FALSE_RETURN_V_MSG_E(pluginTemp != nullptr, Status::ERROR_INVALID_PARAMETER,
+        "ReadSamples failed due to get demuxer plugin failed.");
+    Status ret = pluginTemp->ReadSamples(innerTrackID, samples, maxBytes, readCount);
+    OnReadSampleResult(trackId, ret);
+    ProcessDrmInfos();
+    FALSE_RETURN_V(ret == Status::OK, ret);
+
+    for (uint32_t i = 0; i < readCount; ++i) {
+        if (samples[i]->flag_ & (uint32_t)(AVBufferFlag::EOS)) {
+            eosMap_[trackId] = true;
+            samples[i]->memory_->SetSize(0);
+        }
+        if (samples[i]->flag_ & (uint32_t)(AVBufferFlag::PARTIAL_FRAME)) {
+            ret = Status::ERROR_NO_MEMORY;
+        }
+    }
+    MEDIA_LOG_D("Read " PUBLIC_LOG_U32 " samples for track " PUBLIC_LOG_U32, readCount, trackId);
+    return ret;
+}
+
 void MediaDemuxer::HandleSourceDrmInfoEvent(const std::multimap<std::string, std::vector<uint8_t>> &info)
 {
     MEDIA_LOG_I("HandleSourceDrmInfoEvent");
@@ -2139,6 +2205,46 @@ void MediaDemuxer::SetCacheLimit(uint32_t limitSize)
     pluginTemp->SetCacheLimit(limitSize);
 }
 
+void MediaDemuxer::SetMemoryBudget(uint64_t budgetId)
+{
+    MEDIA_LOG_I("SetMemoryBudget " PUBLIC_LOG_U64, budgetId);
+    memoryBudgetId_ = budgetId;
+    if (source_ != nullptr) {
+        source_->SetMemoryBudget(budgetId);
+    }
+}
+
+void MediaDemuxer::ApplyMemoryBudget()
+{
+    FALSE_RETURN_MSG(demuxerPluginManager_ != nullptr, "ApplyMemoryBudget failed, no plugin manager.");
+    std::shared_ptr<Plugins::DemuxerPlugin> applied = nullptr;
+    for (uint32_t trackId : { videoTrackId_, audioTrackId_ }) {
+        if (trackId == TRACK_ID_DUMMY) {
+            continue;
+        }
+        int32_t streamID = demuxerPluginManager_->GetTmpStreamIDByTrackID(static_cast<int32_t>(trackId));
+        std::shared_ptr<Plugins::DemuxerPlugin> plugin = demuxerPluginManager_->GetPluginByStreamID(streamID);
+        if (plugin != nullptr && plugin != applied) {
+            plugin->SetMemoryBudget(memoryBudgetId_);
+            applied = plugin;
+        }
+    }
+}
+
+Status MediaDemuxer::SetKeyFrameOnly(bool keyFrameOnly)
+{
+    MEDIA_LOG_I("SetKeyFrameOnly " PUBLIC_LOG_D32, static_cast<int32_t>(keyFrameOnly));
+    FALSE_RETURN_V_MSG_E(demuxerPluginManager_ != nullptr, Status::ERROR_NULL_POINTER,
+        "SetKeyFrameOnly failed due to demuxerPluginManager_ is nullptr.");
+    FALSE_RETURN_V_MSG_E(videoTrackId_ != TRACK_ID_DUMMY, Status::ERROR_INVALID_OPERATION,
+        "SetKeyFrameOnly failed due to no video track.");
+    int32_t innerTrackId = -1;
+    std::shared_ptr<Plugins::DemuxerPlugin> pluginTemp = GetPluginByTrackId(videoTrackId_, innerTrackId);
+    FALSE_RETURN_V_MSG_E(pluginTemp != nullptr, Status::ERROR_NULL_POINTER,
+        "SetKeyFrameOnly failed due to get demuxer plugin failed.");
+    return pluginTemp->SetKeyFrameOnly(keyFrameOnly);
+}
+
 bool MediaDemuxer::IsVideoEos()
 {
     if (videoTrackId_ == TRACK_ID_DUMMY) {
@@ -45,7 +45,7 @@ namespace Media {
 const int32_t TRY_READ_SLEEP_TIME = 10;  //ms
 const int32_t TRY_READ_TIMES = 10;
 constexpr uint64_t LIVE_CONTENT_LENGTH = 2147483646;
-StreamDemuxer::StreamDemuxer() : position_(0)
+StreamDemuxer::StreamDemuxer()
 {
     MEDIA_LOG_I("VodStreamDemuxer called");
 }
@@ -233,8 +233,11 @@ Status StreamDemuxer::ReadRetry(int32_t streamID, uint64_t offset, size_t size,
     FALSE_RETURN_V_MSG_E(data->GetMemory() != nullptr, Status::ERROR_UNKNOWN, "getmemory invalid");
     Status err = Status::OK;
     int32_t retryTimes = 0;
+    // frame reads feed the decoders, they go ahead of header probing
+    ReadPriority priority = pluginStateMap_[streamID] == DemuxerState::DEMUXER_STATE_PARSE_FRAME ?
+        ReadPriority::PLAYBACK : ReadPriority::METADATA;
     while (true && !isInterruptNeeded_.load()) {
-        err = source_->Read(streamID, data, offset, size);
+        err = source_->Read(streamID, data, offset, size, priority);
         if (err != Status::END_OF_STREAM && data->GetMemory()->GetSize() == 0) {
             OSAL::SleepFor(TRY_READ_SLEEP_TIME);
             retryTimes++;
@@ -252,8 +255,7 @@ Status StreamDemuxer::ReadRetry(int32_t streamID, uint64_t offset, size_t size,
 Status StreamDemuxer::PullData(int32_t streamID, uint64_t offset, size_t size,
     std::shared_ptr<Plugins::Buffer>& data)
 {
-    MEDIA_LOG_DD("IN, offset: " PUBLIC_LOG_U64 ", size: " PUBLIC_LOG_ZU
-        ", position: " PUBLIC_LOG_U64, offset, size, position_);
+    MEDIA_LOG_DD("IN, offset: " PUBLIC_LOG_U64 ", size: " PUBLIC_LOG_ZU, offset, size);
     if (!source_) {
         return Status::ERROR_INVALID_OPERATION;
     }
@@ -280,18 +282,7 @@ Status StreamDemuxer::PullData(int32_t streamID, uint64_t offset, size_t size,
         }
         MEDIA_LOG_DD("TotalSize_: " PUBLIC_LOG_U64, totalSize);
     }
-    if (position_ != offset) {
-        err = source_->SeekTo(offset);
-        FALSE_RETURN_V_MSG_E(err == Status::OK, err, "Seek to " PUBLIC_LOG_U64 " fail", offset);
-        position_ = offset;
-    }
-
-    err = ReadRetry(streamID, offset, readSize, data);
-    if (err == Status::OK) {
-        FALSE_RETURN_V_MSG_E(data->GetMemory() != nullptr, Status::ERROR_UNKNOWN, "data->GetMemory invalid");
-        position_ += data->GetMemory()->GetSize();
-    }
-    return err;
+    return ReadRetry(streamID, offset, readSize, data);
 }
 
 Status StreamDemuxer::ResetCache(int32_t streamID)
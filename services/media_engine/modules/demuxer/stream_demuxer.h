@@ -67,7 +67,6 @@ private:
     Status ProcInnerDash(int32_t streamID,  uint64_t offset, std::shared_ptr<Buffer>& bufferPtr);
 private:
     std::map<int32_t, CacheData> cacheDataMap_;
-    uint64_t position_;
 };
 } // namespace Media
 } // namespace OHOS
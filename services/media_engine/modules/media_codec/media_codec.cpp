@@ -18,13 +18,16 @@
 #include "osal/task/autolock.h"
 #include "plugin/plugin_manager_v2.h"
 #include "osal/utils/dump_buffer.h"
+#include "avcodec_latency_stats.h"
 #include "avcodec_trace.h"
+#include "memory_budget.h"
 #include "plugin/plugin_manager_v2.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_DOMAIN_AUDIO, "MediaCodec" };
 const std::string INPUT_BUFFER_QUEUE_NAME = "MediaCodecInputBufferQueue";
 constexpr int32_t DEFAULT_BUFFER_NUM = 8;
+constexpr size_t DRM_DECRYPT_BATCH_MAX = 8;
 constexpr int32_t TIME_OUT_MS = 50;
 const std::string DUMP_PARAM = "a";
 const std::string DUMP_FILE_NAME = "player_audio_decoder_output.pcm";
@@ -74,6 +77,10 @@ MediaCodec::~MediaCodec()
     codecCallback_ = nullptr;
     mediaCodecCallback_ = nullptr;
     outputBufferCapacity_ = 0;
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->SetReclaimer(nullptr);
+        memoryBudget_->Release(chargedBytes_ + drmStagingBytes_);
+    }
 }
 
 int32_t MediaCodec::Init(const std::string &mime, bool isEncoder)
@@ -435,9 +442,67 @@ Status MediaCodec::AttachBufffer()
             i, inputBuffer->GetUniqueId());
         inputBufferVector_.push_back(inputBuffer);
     }
+    ChargeBufferMemory(static_cast<uint64_t>(capacity) * static_cast<uint64_t>(inputBufferNum));
     return Status::OK;
 }
 
+void MediaCodec::ChargeBufferMemory(uint64_t bytes)
+{
+    chargedBytes_ += bytes;
+    if (memoryBudget_ != nullptr && !memoryBudget_->Charge(bytes)) {
+        MEDIA_LOG_W("codec buffers exceed the memory budget, usage: " PUBLIC_LOG_U64, memoryBudget_->GetUsage());
+    }
+}
+
+void MediaCodec::SetMemoryBudget(uint64_t budgetId)
+{
+    AutoLock lock(stateMutex_);
+    FALSE_RETURN_MSG(budgetId != memoryBudgetId_, "Memory budget " PUBLIC_LOG_U64 " already applied", budgetId);
+    auto session = MediaAVCodec::MemoryBudget::Find(budgetId);
+    FALSE_RETURN_MSG(session != nullptr, "Memory budget " PUBLIC_LOG_U64 " not found", budgetId);
+    auto budget = session->CreateChild("codec_buffer", MediaAVCodec::MemoryBudget::RECLAIM_CODEC_BUFFER);
+    FALSE_RETURN(budget != nullptr);
+    std::lock_guard<std::mutex> stagingLock(drmStagingMutex_);
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->SetReclaimer(nullptr);
+        memoryBudget_->Release(chargedBytes_ + drmStagingBytes_);
+    }
+    memoryBudget_ = budget;
+    memoryBudgetId_ = budgetId;
+    memoryBudget_->Charge(chargedBytes_ + drmStagingBytes_);
+    memoryBudget_->SetReclaimer([this](uint64_t bytes) { return ReclaimDrmStagingBuffers(bytes); });
+}
+
+uint64_t MediaCodec::ReclaimDrmStagingBuffers(uint64_t bytes)
+{
+    // the staging pairs are allocated again by the next encrypted batch, a batch in progress is not waited for
+    std::unique_lock<std::mutex> lock(drmStagingMutex_, std::try_to_lock);
+    FALSE_RETURN_V(lock.owns_lock(), 0);
+    uint64_t freed = 0;
+    while (!drmStagingBuffers_.empty() && freed < bytes) {
+        freed += StagingPairCapacity(drmStagingBuffers_.back());
+        drmStagingBuffers_.pop_back();
+    }
+    drmStagingBytes_ -= freed;
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Release(freed);
+    }
+    MEDIA_LOG_I("Reclaim drm staging buffers " PUBLIC_LOG_U64 "/" PUBLIC_LOG_U64, freed, bytes);
+    return freed;
+}
+
+uint64_t MediaCodec::StagingPairCapacity(
+    const std::pair<std::shared_ptr<AVBuffer>, std::shared_ptr<AVBuffer>> &staging)
+{
+    uint64_t capacity = 0;
+    for (const auto &buffer : { staging.first, staging.second }) {
+        if (buffer != nullptr && buffer->memory_ != nullptr) {
+            capacity += static_cast<uint64_t>(buffer->memory_->GetCapacity());
+        }
+    }
+    return capacity;
+}
+
 Status MediaCodec::AttachDrmBufffer(std::shared_ptr<AVBuffer> &drmInbuf, std::shared_ptr<AVBuffer> &drmOutbuf,
     uint32_t size)
 {
@@ -463,40 +528,101 @@ Status MediaCodec::AttachDrmBufffer(std::shared_ptr<AVBuffer> &drmInbuf, std::sh
     return Status::OK;
 }
 
-Status MediaCodec::DrmAudioCencDecrypt(std::shared_ptr<AVBuffer> &filledInputBuffer)
+Status MediaCodec::GetDrmStagingBuffer(size_t index, uint32_t size, std::shared_ptr<AVBuffer> &drmInBuf,
+    std::shared_ptr<AVBuffer> &drmOutBuf)
 {
-    MEDIA_LOG_D("DrmAudioCencDecrypt enter");
-    Status ret = Status::OK;
+    if (index >= drmStagingBuffers_.size()) {
+        drmStagingBuffers_.resize(index + 1);
+    }
+    auto &staging = drmStagingBuffers_[index];
+    if (staging.first == nullptr || staging.second == nullptr ||
+        staging.first->memory_->GetCapacity() < static_cast<int32_t>(size)) {
+        uint64_t oldCapacity = StagingPairCapacity(staging);
+        Status ret = AttachDrmBufffer(staging.first, staging.second, size);
+        FALSE_RETURN_V_MSG_E(ret == Status::OK, Status::ERROR_UNKNOWN, "AttachDrmBufffer failed");
+        uint64_t newCapacity = StagingPairCapacity(staging);
+        drmStagingBytes_ += newCapacity - oldCapacity;
+        if (memoryBudget_ != nullptr) {
+            memoryBudget_->Release(oldCapacity);
+            memoryBudget_->Charge(newCapacity);
+        }
+    }
+    staging.first->memory_->SetSize(size);
+    staging.second->memory_->SetSize(size);
+    drmInBuf = staging.first;
+    drmOutBuf = staging.second;
+    return Status::OK;
+}
 
-    // 1. allocate drm buffer
-    uint32_t bufSize = static_cast<uint32_t>(filledInputBuffer->memory_->GetSize());
-    if (bufSize == 0) {
-        MEDIA_LOG_D("MediaCodec DrmAudioCencDecrypt input buffer size equal 0");
-        return ret;
-    }
-    std::shared_ptr<AVBuffer> drmInBuf;
-    std::shared_ptr<AVBuffer> drmOutBuf;
-    ret = AttachDrmBufffer(drmInBuf, drmOutBuf, bufSize);
-    FALSE_RETURN_V_MSG_E(ret == Status::OK, Status::ERROR_UNKNOWN, "AttachDrmBufffer failed");
-
-    // 2. copy data to drm input buffer
-    int32_t drmRes = memcpy_s(drmInBuf->memory_->GetAddr(), bufSize,
-        filledInputBuffer->memory_->GetAddr(), bufSize);
-    FALSE_RETURN_V_MSG_E(drmRes == 0, Status::ERROR_UNKNOWN, "memcpy_s drmInBuf failed");
-    if (filledInputBuffer->meta_ != nullptr) {
-        *(drmInBuf->meta_) = *(filledInputBuffer->meta_);
-    }
-    // 4. decrypt
-    drmRes = drmDecryptor_->DrmAudioCencDecrypt(drmInBuf, drmOutBuf, bufSize);
+Status MediaCodec::DrmAudioCencDecrypt(std::vector<std::shared_ptr<AVBuffer>> &filledInputBuffers)
+{
+    MEDIA_LOG_D("DrmAudioCencDecrypt enter, batch size: " PUBLIC_LOG_ZU, filledInputBuffers.size());
+    std::lock_guard<std::mutex> stagingLock(drmStagingMutex_);
+    std::vector<MediaAVCodec::DrmDecryptTask> tasks;
+    std::vector<std::pair<std::shared_ptr<AVBuffer>, std::shared_ptr<AVBuffer>>> copyBacks; // <dst, drmOutBuf>
+    tasks.reserve(filledInputBuffers.size());
+    for (auto &filledInputBuffer : filledInputBuffers) {
+        uint32_t bufSize = static_cast<uint32_t>(filledInputBuffer->memory_->GetSize());
+        if (bufSize == 0) {
+            MEDIA_LOG_D("MediaCodec DrmAudioCencDecrypt input buffer size equal 0");
+            continue;
+        }
+        // 1. clear samples go to the decoder untouched, fd backed input buffers are decrypted in place,
+        // others go through a reused drm buffer pair
+        if (!drmDecryptor_->NeedsDecryption(filledInputBuffer)) {
+            continue;
+        }
+        if (drmDecryptor_->CanDecryptInPlace(filledInputBuffer)) {
+            tasks.push_back({filledInputBuffer, filledInputBuffer, bufSize});
+            continue;
+        }
+        std::shared_ptr<AVBuffer> drmInBuf;
+        std::shared_ptr<AVBuffer> drmOutBuf;
+        Status ret = GetDrmStagingBuffer(copyBacks.size(), bufSize, drmInBuf, drmOutBuf);
+        FALSE_RETURN_V_MSG_E(ret == Status::OK, Status::ERROR_UNKNOWN, "GetDrmStagingBuffer failed");
+
+        // 2. copy data to drm input buffer
+        int32_t drmRes = memcpy_s(drmInBuf->memory_->GetAddr(), bufSize,
+            filledInputBuffer->memory_->GetAddr(), bufSize);
+        FALSE_RETURN_V_MSG_E(drmRes == 0, Status::ERROR_UNKNOWN, "memcpy_s drmInBuf failed");
+        *(drmInBuf->meta_) = filledInputBuffer->meta_ != nullptr ? *(filledInputBuffer->meta_) : Meta();
+        tasks.push_back({drmInBuf, drmOutBuf, bufSize});
+        copyBacks.emplace_back(filledInputBuffer, drmOutBuf);
+    }
+    FALSE_RETURN_V(!tasks.empty(), Status::OK);
+
+    // 3. decrypt
+    int32_t drmRes = drmDecryptor_->DrmAudioCencDecryptBatch(tasks);
     FALSE_RETURN_V_MSG_E(drmRes == 0, Status::ERROR_DRM_DECRYPT_FAILED, "DrmAudioCencDecrypt return error");
 
-    // 5. copy decrypted data from drm output buffer back
-    drmRes = memcpy_s(filledInputBuffer->memory_->GetAddr(), bufSize,
-        drmOutBuf->memory_->GetAddr(), bufSize);
-    FALSE_RETURN_V_MSG_E(drmRes == 0, Status::ERROR_UNKNOWN, "memcpy_s drmOutBuf failed");
+    // 4. copy decrypted data from drm output buffer back
+    for (auto &copyBack : copyBacks) {
+        int32_t bufSize = copyBack.first->memory_->GetSize();
+        drmRes = memcpy_s(copyBack.first->memory_->GetAddr(), bufSize, copyBack.second->memory_->GetAddr(), bufSize);
+        FALSE_RETURN_V_MSG_E(drmRes == 0, Status::ERROR_UNKNOWN, "memcpy_s drmOutBuf failed");
+    }
     return Status::OK;
 }
 
+void MediaCodec::AcquireDrmInputBatch(std::vector<std::shared_ptr<AVBuffer>> &filledInputBuffers)
+{
+    // drain what the demuxer already queued so one decrypt pass covers it, later notifications find it empty.
+    // Stop and Flush clear the input queue under the state lock, a batch never takes buffers behind them
+    AutoLock lock(stateMutex_);
+    FALSE_RETURN_MSG(state_ == CodecState::RUNNING, "state changed to %{public}s, stop drm batch",
+        StateToString(state_).data());
+    while (filledInputBuffers.size() < DRM_DECRYPT_BATCH_MAX) {
+        std::shared_ptr<AVBuffer> filledInputBuffer;
+        if (inputBufferQueueConsumer_->AcquireBuffer(filledInputBuffer) != Status::OK) {
+            break;
+        }
+        filledInputBuffers.push_back(filledInputBuffer);
+        if (filledInputBuffer->flag_ & static_cast<uint32_t>(Plugins::AVBufferFlag::EOS)) {
+            break;
+        }
+    }
+}
+
 void MediaCodec::HandleAudioCencDecryptError()
 {
     MEDIA_LOG_E("MediaCodec DrmAudioCencDecrypt failed.");
@@ -561,6 +687,7 @@ int32_t MediaCodec::PrepareOutputBufferQueue()
                              "outputBufferConfig is nullptr");
         FALSE_RETURN_V(outputBufferConfig->Get<Tag::AUDIO_MAX_OUTPUT_SIZE>(outputBufferCapacity_),
                        (int32_t)Status::ERROR_INVALID_PARAMETER);
+        size_t attachedNum = outputBufferVector_.size();
         for (int i = 0; i < outputBufferNum; i++) {
             auto avAllocator = AVAllocatorFactory::CreateSharedAllocator(MemoryFlag::MEMORY_READ_WRITE);
             std::shared_ptr<AVBuffer> outputBuffer = AVBuffer::CreateAVBuffer(avAllocator, outputBufferCapacity_);
@@ -572,6 +699,8 @@ int32_t MediaCodec::PrepareOutputBufferQueue()
                 outputBufferVector_.push_back(outputBuffer);
             }
         }
+        ChargeBufferMemory(static_cast<uint64_t>(outputBufferCapacity_) *
+            static_cast<uint64_t>(outputBufferVector_.size() - attachedNum));
     } else {
         for (uint32_t i = 0; i < outputBuffers.size(); i++) {
             if (outputBufferQueueProducer_->AttachBuffer(outputBuffers[i], false) == Status::OK) {
@@ -598,7 +727,10 @@ void MediaCodec::ProcessInputBuffer()
     }
     ret = inputBufferQueueConsumer_->AcquireBuffer(filledInputBuffer);
     if (ret != Status::OK) {
-        MEDIA_LOG_E("ProcessInputBuffer AcquireBuffer fail");
+        // a previous drm batch may already have drained the buffer this notification is for
+        if (drmDecryptor_ == nullptr) {
+            MEDIA_LOG_E("ProcessInputBuffer AcquireBuffer fail");
+        }
         return;
     }
     if (state_ != CodecState::RUNNING) {
@@ -606,33 +738,47 @@ void MediaCodec::ProcessInputBuffer()
         inputBufferQueueConsumer_->ReleaseBuffer(filledInputBuffer);
         return;
     }
-    const int8_t RETRY = 3; // max retry count is 3
-    int8_t retryCount = 0;
-    do {
-        if (drmDecryptor_ != nullptr) {
-            ret = DrmAudioCencDecrypt(filledInputBuffer);
-            if (ret != Status::OK) {
+    std::vector<std::shared_ptr<AVBuffer>> filledInputBuffers = {filledInputBuffer};
+    if (drmDecryptor_ != nullptr) {
+        AcquireDrmInputBatch(filledInputBuffers);
+        ret = state_ == CodecState::RUNNING ? DrmAudioCencDecrypt(filledInputBuffers) : Status::ERROR_WRONG_STATE;
+        if (ret != Status::OK) {
+            if (ret != Status::ERROR_WRONG_STATE) {
                 HandleAudioCencDecryptError();
-                break;
             }
+            for (auto &buffer : filledInputBuffers) {
+                inputBufferQueueConsumer_->ReleaseBuffer(buffer);
+            }
+            return;
         }
+    }
+    for (auto &buffer : filledInputBuffers) {
+        // the plugin calls only, acquiring the input, decryption and waits for a free output buffer are left out
+        MediaAVCodec::AVCodecLatencyScope latency(MediaAVCodec::LatencyStage::DECODE);
+        if (QueueInputBufferToPlugin(buffer) != Status::OK) {
+            inputBufferQueueConsumer_->ReleaseBuffer(buffer);
+            MEDIA_LOG_E("Plugin queueInputBuffer failed.");
+            continue;
+        }
+        eosStatus = buffer->flag_;
+        do {
+            ret = HandleOutputBuffer(eosStatus, latency);
+        } while (ret == Status::ERROR_AGAIN);
+    }
+}
 
+Status MediaCodec::QueueInputBufferToPlugin(const std::shared_ptr<AVBuffer> &filledInputBuffer)
+{
+    const int8_t RETRY = 3; // max retry count is 3
+    int8_t retryCount = 0;
+    Status ret;
+    do {
         ret = codecPlugin_->QueueInputBuffer(filledInputBuffer);
         if (ret != Status::OK) {
             retryCount++;
-            continue;
         }
     } while (ret != Status::OK && retryCount < RETRY);
-
-    if (ret != Status::OK) {
-        inputBufferQueueConsumer_->ReleaseBuffer(filledInputBuffer);
-        MEDIA_LOG_E("Plugin queueInputBuffer failed.");
-        return;
-    }
-    eosStatus = filledInputBuffer->flag_;
-    do {
-        ret = HandleOutputBuffer(eosStatus);
-    } while (ret == Status::ERROR_AGAIN);
+    return ret;
 }
 
 #ifdef SUPPORT_DRM
@@ -692,15 +838,17 @@ Status MediaCodec::ChangePlugin(const std::string &mime, bool isEncoder, const s
     return ret;
 }
 
-Status MediaCodec::HandleOutputBuffer(uint32_t eosStatus)
+Status MediaCodec::HandleOutputBuffer(uint32_t eosStatus, MediaAVCodec::AVCodecLatencyScope &latency)
 {
     MEDIA_LOG_D("HandleOutputBuffer enter");
     Status ret = Status::OK;
     std::shared_ptr<AVBuffer> emptyOutputBuffer;
     AVBufferConfig avBufferConfig;
+    latency.Pause();
     do {
         ret = outputBufferQueueProducer_->RequestBuffer(emptyOutputBuffer, avBufferConfig, TIME_OUT_MS);
     } while (ret != Status::OK && state_ == CodecState::RUNNING);
+    latency.Resume();
     if (emptyOutputBuffer) {
         emptyOutputBuffer->flag_ = eosStatus;
     } else if (state_ != CodecState::RUNNING) {
@@ -765,6 +913,10 @@ void MediaCodec::ClearBufferQueue()
         outputBufferVector_.clear();
         outputBufferQueueProducer_->SetQueueSize(0);
     }
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Release(chargedBytes_);
+    }
+    chargedBytes_ = 0;
 }
 
 void MediaCodec::ClearInputBuffer()
@@ -17,6 +17,7 @@
 #define MODULES_MEDIA_CODEC_H
 
 #include <cstring>
+#include <mutex>
 #include "surface.h"
 #include "meta/meta.h"
 #include "buffer/avbuffer.h"
@@ -32,6 +33,10 @@
 #include "foundation/multimedia/av_codec/services/drm_decryptor/codec_drm_decrypt.h"
 
 namespace OHOS {
+namespace MediaAVCodec {
+class MemoryBudget;
+class AVCodecLatencyScope;
+} // namespace MediaAVCodec
 namespace Media {
 enum class CodecState : int32_t {
     UNINITIALIZED,
@@ -129,14 +134,24 @@ public:
 
     void OnDumpInfo(int32_t fd);
 
+    // Accounts the input and output buffers to the session MemoryBudget, call before Prepare
+    void SetMemoryBudget(uint64_t budgetId);
+
 private:
     std::shared_ptr<Plugins::CodecPlugin> CreatePlugin(Plugins::PluginType pluginType);
     std::shared_ptr<Plugins::CodecPlugin> CreatePlugin(const std::string &mime, Plugins::PluginType pluginType);
     Status AttachBufffer();
+    void ChargeBufferMemory(uint64_t bytes);
     Status AttachDrmBufffer(std::shared_ptr<AVBuffer> &drmInbuf, std::shared_ptr<AVBuffer> &drmOutbuf,
         uint32_t size);
-    Status DrmAudioCencDecrypt(std::shared_ptr<AVBuffer> &filledInputBuffer);
-    Status HandleOutputBuffer(uint32_t eosStatus);
+    Status GetDrmStagingBuffer(size_t index, uint32_t size, std::shared_ptr<AVBuffer> &drmInBuf,
+        std::shared_ptr<AVBuffer> &drmOutBuf);
+    static uint64_t StagingPairCapacity(const std::pair<std::shared_ptr<AVBuffer>, std::shared_ptr<AVBuffer>> &staging);
+    uint64_t ReclaimDrmStagingBuffers(uint64_t bytes);
+    Status DrmAudioCencDecrypt(std::vector<std::shared_ptr<AVBuffer>> &filledInputBuffers);
+    void AcquireDrmInputBatch(std::vector<std::shared_ptr<AVBuffer>> &filledInputBuffers);
+    Status QueueInputBufferToPlugin(const std::shared_ptr<AVBuffer> &filledInputBuffer);
+    Status HandleOutputBuffer(uint32_t eosStatus, MediaAVCodec::AVCodecLatencyScope &latency);
 
     int32_t PrepareInputBufferQueue();
 
@@ -175,8 +190,16 @@ private:
 
     std::atomic<CodecState> state_;
     std::shared_ptr<MediaAVCodec::CodecDrmDecrypt> drmDecryptor_ = nullptr;
+    // <drmInBuf, drmOutBuf> per batch slot, reused while the capacity fits
+    std::vector<std::pair<std::shared_ptr<AVBuffer>, std::shared_ptr<AVBuffer>>> drmStagingBuffers_;
+    // held by a decrypt batch, the budget reclaimer frees the staging pairs only while it is free
+    std::mutex drmStagingMutex_;
+    uint64_t drmStagingBytes_ = 0;
     std::vector<std::shared_ptr<AVBuffer>> inputBufferVector_;
     std::vector<std::shared_ptr<AVBuffer>> outputBufferVector_;
+    std::shared_ptr<MediaAVCodec::MemoryBudget> memoryBudget_ = nullptr;
+    uint64_t memoryBudgetId_ = 0;
+    uint64_t chargedBytes_ = 0;
     Mutex stateMutex_;
 };
 } // namespace Media
@@ -52,8 +52,8 @@ int32_t DataSinkFd::Read(uint8_t *buf, int32_t bufSize)
     if (pos_ >= end_) {
         return 0;
     }
-    FALSE_RETURN_V_MSG_E(lseek(fd_, pos_, SEEK_SET) >= 0, -1, "failed to seek, %{public}s", strerror(errno));
-    int32_t size = read(fd_, buf, bufSize);
+    // positioned io, one syscall per call instead of lseek plus read
+    int32_t size = static_cast<int32_t>(pread(fd_, buf, bufSize, pos_));
     FALSE_RETURN_V_MSG_E(size >= 0, -1, "failed to read, %{public}s", strerror(errno));
     pos_ = pos_ + size;
     return size;
@@ -62,8 +62,7 @@ int32_t DataSinkFd::Read(uint8_t *buf, int32_t bufSize)
 int32_t DataSinkFd::Write(const uint8_t *buf, int32_t bufSize)
 {
     FALSE_RETURN_V_MSG_E(fd_ > 0, -1, "failed to write, fd is  %{public}d", fd_);
-    FALSE_RETURN_V_MSG_E(lseek(fd_, pos_, SEEK_SET) >= 0, -1, "failed to seek, %{public}s", strerror(errno));
-    int32_t size = write(fd_, buf, bufSize);
+    int32_t size = static_cast<int32_t>(pwrite(fd_, buf, bufSize, pos_));
     FALSE_RETURN_V_MSG_E(size == bufSize, -1, "failed to write, %{public}s", strerror(errno));
     pos_ = pos_ + size;
     end_ = pos_ > end_ ? pos_ : end_;
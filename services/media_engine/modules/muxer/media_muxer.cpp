@@ -88,6 +88,8 @@ MediaMuxer::~MediaMuxer()
     appUid_ = -1;
     appPid_ = -1;
     muxer_ = nullptr;
+    writeBehindSink_ = nullptr;
+    dataSink_ = nullptr;
     tracks_.clear();
     MEDIA_LOG_D("0x%{public}06" PRIXPTR " instances destroy", FAKE_POINTER(this));
 }
@@ -116,7 +118,8 @@ Status MediaMuxer::Init(int32_t fd, Plugins::OutputFormat format)
     }
     FALSE_RETURN_V_MSG_E(state_ == State::INITIALIZED, Status::ERROR_WRONG_STATE,
         "The state is UNINITIALIZED");
-    return muxer_->SetDataSink(std::make_shared<DataSinkFd>(fd));
+    dataSink_ = std::make_shared<DataSinkFd>(fd);
+    return muxer_->SetDataSink(dataSink_);
 }
 
 Status MediaMuxer::Init(FILE *file, Plugins::OutputFormat format)
@@ -140,7 +143,8 @@ Status MediaMuxer::Init(FILE *file, Plugins::OutputFormat format)
     }
     FALSE_RETURN_V_MSG_E(state_ == State::INITIALIZED, Status::ERROR_WRONG_STATE,
                          "The state is UNINITIALIZED");
-    return muxer_->SetDataSink(std::make_shared<DataSinkFile>(file));
+    dataSink_ = std::make_shared<DataSinkFile>(file);
+    return muxer_->SetDataSink(dataSink_);
 }
 
 Status MediaMuxer::SetParameter(const std::shared_ptr<Meta> &param)
@@ -150,9 +154,23 @@ Status MediaMuxer::SetParameter(const std::shared_ptr<Meta> &param)
     FALSE_RETURN_V_MSG_E(state_ == State::INITIALIZED, Status::ERROR_WRONG_STATE,
         "The state is not INITIALIZED, the interface must be called after constructor and before Start(). "
         "The current state is %{public}s.", StateConvert(state_).c_str());
+    Status ret = SetWriteBehind(param);
+    FALSE_RETURN_V_MSG_E(ret == Status::NO_ERROR, ret, "SetParameter failed");
     return muxer_->SetParameter(param);
 }
 
+Status MediaMuxer::SetWriteBehind(const std::shared_ptr<Meta> &param)
+{
+    int32_t writeBehind = 0;
+    if (!param->GetData("io_write_behind", writeBehind) || writeBehind != 1 || writeBehindSink_ != nullptr) {
+        return Status::NO_ERROR;
+    }
+    FALSE_RETURN_V_MSG_E(dataSink_ != nullptr, Status::ERROR_INVALID_OPERATION, "no data sink to write behind");
+    writeBehindSink_ = std::make_shared<WriteBehindSink>(dataSink_);
+    MEDIA_LOG_I("write behind the muxer thread");
+    return muxer_->SetDataSink(writeBehindSink_);
+}
+
 Status MediaMuxer::SetUserMeta(const std::shared_ptr<Meta> &userMeta)
 {
     MEDIA_LOG_I("SetUserMeta");
@@ -210,7 +228,10 @@ sptr<AVBufferQueueProducer> MediaMuxer::GetInputBufferQueue(uint32_t trackIndex)
 
 Status MediaMuxer::WriteSample(uint32_t trackIndex, const std::shared_ptr<AVBuffer> &sample)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    // tracks_ is fixed once started, so writers of different tracks only meet in the writer thread and a full
+    // queue only blocks the writer of its own track. The shared lock keeps Stop from ending the writer thread
+    // between the state check and the push.
+    std::shared_lock<std::shared_mutex> writeLock(writeMutex_);
     FALSE_RETURN_V_MSG_E(state_ == State::STARTED, Status::ERROR_WRONG_STATE,
         "The state is not STARTED, the interface must be called after Start() and before Stop(). "
         "The current state is %{public}s", StateConvert(state_).c_str());
@@ -285,7 +306,11 @@ Status MediaMuxer::Stop()
     }
     FALSE_RETURN_V_MSG_E(state_ == State::STARTED, Status::ERROR_WRONG_STATE,
         "The state is not STARTED. The current state is %{public}s.", StateConvert(state_).c_str());
-    state_ = State::STOPPED;
+    {
+        // waits for the samples being written, the writer thread still drains their queues
+        std::unique_lock<std::shared_mutex> writeLock(writeMutex_);
+        state_ = State::STOPPED;
+    }
     for (auto& track : tracks_) { // Stop the producer first
         sptr<IConsumerListener> listener = nullptr;
         track->consumer_->SetBufferAvailableListener(listener);
@@ -293,6 +318,9 @@ Status MediaMuxer::Stop()
     StopThread();
     Status ret = muxer_->Stop();
     FALSE_RETURN_V_MSG_E(ret == Status::NO_ERROR, ret, "Stop failed!");
+    // the trailer must be on disk once Stop returns
+    FALSE_RETURN_V_MSG_E(writeBehindSink_ == nullptr || writeBehindSink_->Flush() == 0, Status::ERROR_UNKNOWN,
+        "Stop failed! write behind failed");
     return Status::NO_ERROR;
 }
 
@@ -326,6 +354,8 @@ Status MediaMuxer::Reset()
     }
     state_ = State::UNINITIALIZED;
     muxer_ = nullptr;
+    writeBehindSink_ = nullptr;
+    dataSink_ = nullptr;
     tracks_.clear();
 
     return Status::NO_ERROR;
@@ -337,34 +367,45 @@ void MediaMuxer::ThreadProcessor()
     constexpr int32_t timeoutMs = 500;
     constexpr uint32_t nameSizeMax = 15;
     pthread_setname_np(pthread_self(), threadName_.substr(0, nameSizeMax).c_str());
-    int32_t trackCount = static_cast<int32_t>(tracks_.size());
+    // the writer keeps at most half of each queue, the producers can refill the rest meanwhile
+    SampleInterleaver interleaver(static_cast<uint32_t>(tracks_.size()), SampleInterleaver::DEFAULT_WINDOW_US,
+        MAX_BUFFER_COUNT / 2);
     for (;;) {
-        if (isThreadExit_ && bufferAvailableCount_ <= 0) {
+        if (isThreadExit_ && bufferAvailableCount_ <= 0 && interleaver.Empty()) {
             MEDIA_LOG_D("Exit ThreadProcessor [%{public}s]", threadName_.c_str());
             return;
         }
-        std::unique_lock<std::mutex> lock(mutexBufferAvailable_);
-        condBufferAvailable_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
-            [this] { return isThreadExit_ || bufferAvailableCount_ > 0; });
-        int32_t trackIdx = -1;
-        std::shared_ptr<AVBuffer> buffer1 = nullptr;
-        for (int i = 0; i < trackCount; ++i) {
-            std::shared_ptr<AVBuffer> buffer2 = tracks_[i]->GetBuffer();
-            if ((buffer1 != nullptr && buffer2 != nullptr && buffer1->pts_ > buffer2->pts_) ||
-                (buffer1 == nullptr && buffer2 != nullptr)) {
-                buffer1 = buffer2;
-                trackIdx = i;
-            }
+        {
+            std::unique_lock<std::mutex> lock(mutexBufferAvailable_);
+            condBufferAvailable_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                [this] { return isThreadExit_ || bufferAvailableCount_ > 0; });
         }
-        if (buffer1 != nullptr) {
-            muxer_->WriteSample(tracks_[trackIdx]->trackId_, tracks_[trackIdx]->curBuffer_);
-            tracks_[trackIdx]->ReleaseBuffer();
+        PullSamples(interleaver);
+        int32_t trackIdx = -1;
+        while ((trackIdx = interleaver.Next(isThreadExit_)) >= 0) {
+            std::shared_ptr<AVBuffer> buffer = interleaver.Pop(static_cast<uint32_t>(trackIdx));
+            muxer_->WriteSample(tracks_[trackIdx]->trackId_, buffer);
+            tracks_[trackIdx]->ReleaseBuffer(buffer);
+            PullSamples(interleaver);
         }
         MEDIA_LOG_D("Track " PUBLIC_LOG_S " 2 bufferAvailableCount_ :" PUBLIC_LOG_D32,
             threadName_.c_str(), bufferAvailableCount_.load());
     }
 }
 
+void MediaMuxer::PullSamples(SampleInterleaver &interleaver)
+{
+    for (uint32_t i = 0; i < tracks_.size(); ++i) {
+        while (!interleaver.IsFull(i)) {
+            std::shared_ptr<AVBuffer> buffer = tracks_[i]->AcquireBuffer();
+            if (buffer == nullptr) {
+                break;
+            }
+            interleaver.Push(i, buffer);
+        }
+    }
+}
+
 void MediaMuxer::OnBufferAvailable()
 {
     ++bufferAvailableCount_;
@@ -373,32 +414,32 @@ void MediaMuxer::OnBufferAvailable()
         threadName_.c_str(), bufferAvailableCount_.load());
 }
 
-void MediaMuxer::ReleaseBuffer()
+void MediaMuxer::OnBufferAcquired()
 {
     --bufferAvailableCount_;
 }
 
-std::shared_ptr<AVBuffer> MediaMuxer::Track::GetBuffer()
+std::shared_ptr<AVBuffer> MediaMuxer::Track::AcquireBuffer()
 {
-    if (curBuffer_ == nullptr && bufferAvailableCount_ > 0) {
-        Status ret = consumer_->AcquireBuffer(curBuffer_);
-        if (ret != Status::OK) {
-            MEDIA_LOG_E("Track " PUBLIC_LOG_S " lost " PUBLIC_LOG_D32 " frames",
-                mimeType_.c_str(), bufferAvailableCount_.load());
-            --bufferAvailableCount_;
-            listener_->ReleaseBuffer();
-        }
+    if (bufferAvailableCount_ <= 0) {
+        return nullptr;
+    }
+    std::shared_ptr<AVBuffer> buffer = nullptr;
+    Status ret = consumer_->AcquireBuffer(buffer);
+    --bufferAvailableCount_;
+    listener_->OnBufferAcquired();
+    if (ret != Status::OK) {
+        MEDIA_LOG_E("Track " PUBLIC_LOG_S " lost a frame, " PUBLIC_LOG_D32 " left",
+            mimeType_.c_str(), bufferAvailableCount_.load());
+        return nullptr;
     }
-    return curBuffer_;
+    return buffer;
 }
 
-void MediaMuxer::Track::ReleaseBuffer()
+void MediaMuxer::Track::ReleaseBuffer(const std::shared_ptr<AVBuffer> &buffer)
 {
-    if (curBuffer_ != nullptr) {
-        consumer_->ReleaseBuffer(curBuffer_);
-        curBuffer_ = nullptr;
-        --bufferAvailableCount_;
-        listener_->ReleaseBuffer();
+    if (buffer != nullptr) {
+        consumer_->ReleaseBuffer(buffer);
     }
 }
 
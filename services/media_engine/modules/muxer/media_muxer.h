@@ -20,10 +20,13 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include "buffer/avbuffer_queue.h"
 #include "buffer/avbuffer_queue_define.h"
 #include "plugin/muxer_plugin.h"
+#include "sample_interleaver.h"
+#include "write_behind_sink.h"
 
 namespace OHOS {
 namespace Media {
@@ -53,10 +56,12 @@ private:
 
     std::shared_ptr<Plugins::MuxerPlugin> CreatePlugin(Plugins::OutputFormat format);
     void StartThread(const std::string &name);
+    Status SetWriteBehind(const std::shared_ptr<Meta> &param);
     void StopThread();
     void ThreadProcessor();
+    void PullSamples(SampleInterleaver &interleaver);
     void OnBufferAvailable();
-    void ReleaseBuffer();
+    void OnBufferAcquired();
     bool CanAddTrack(const std::string &mimeType);
     bool CheckKeys(const std::string &mimeType, const std::shared_ptr<Meta> &trackDesc);
     std::string StateConvert(State state);
@@ -65,8 +70,8 @@ private:
     public:
         Track() {};
         virtual ~Track() {};
-        std::shared_ptr<AVBuffer> GetBuffer();
-        void ReleaseBuffer();
+        std::shared_ptr<AVBuffer> AcquireBuffer();
+        void ReleaseBuffer(const std::shared_ptr<AVBuffer> &buffer);
         void SetBufferAvailableListener(MediaMuxer *listener);
         void OnBufferAvailable() override;
 
@@ -77,7 +82,6 @@ private:
         sptr<AVBufferQueueProducer> producer_ = nullptr;
         sptr<AVBufferQueueConsumer> consumer_ = nullptr;
         std::shared_ptr<AVBufferQueue> bufferQ_ = nullptr;
-        std::shared_ptr<AVBuffer> curBuffer_ = nullptr;
 
     private:
         std::atomic<int32_t> bufferAvailableCount_ = 0;
@@ -89,9 +93,13 @@ private:
     Plugins::OutputFormat format_;
     std::atomic<State> state_ = State::UNINITIALIZED;
     std::shared_ptr<Plugins::MuxerPlugin> muxer_ = nullptr;
+    std::shared_ptr<Plugins::DataSink> dataSink_ = nullptr;
+    std::shared_ptr<WriteBehindSink> writeBehindSink_ = nullptr;
     std::vector<sptr<Track>> tracks_;
     std::string threadName_;
     std::mutex mutex_;
+    // WriteSample holds it shared from the state check to the push, Stop takes it exclusively to leave STARTED
+    std::shared_mutex writeMutex_;
     std::mutex mutexBufferAvailable_;
     std::condition_variable condBufferAvailable_;
     std::atomic<int32_t> bufferAvailableCount_ = 0;
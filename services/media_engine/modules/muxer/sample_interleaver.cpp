@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sample_interleaver.h"
+#include <algorithm>
+
+namespace OHOS {
+namespace Media {
+SampleInterleaver::SampleInterleaver(uint32_t trackCount, int64_t windowUs, uint32_t maxPending)
+    : tracks_(trackCount), windowUs_(windowUs), maxPending_(maxPending > 0 ? maxPending : 1)
+{
+}
+
+void SampleInterleaver::Push(uint32_t track, const std::shared_ptr<AVBuffer> &sample)
+{
+    if (track >= tracks_.size() || sample == nullptr) {
+        return;
+    }
+    // encoders leave dts_ unset, then the running maximum of pts in decode order stands in for it, the key never
+    // decreases within a track so B-frames keep their place
+    Track &state = tracks_[track];
+    int64_t key = std::max(state.lastKey, sample->dts_ != 0 ? sample->dts_ : sample->pts_);
+    state.lastKey = key;
+    state.samples.push_back({key, sample});
+    pendingCount_++;
+}
+
+int32_t SampleInterleaver::Next(bool drain) const
+{
+    int32_t next = -1;
+    bool allPending = true;
+    bool lookAheadFull = false;
+    int64_t newestKey = INT64_MIN;
+    for (uint32_t i = 0; i < tracks_.size(); i++) {
+        const std::deque<Pending> &samples = tracks_[i].samples;
+        if (samples.empty()) {
+            allPending = false;
+            continue;
+        }
+        // ties go to the lower track, so equal timestamps interleave the same way every time
+        if (next < 0 || samples.front().key < tracks_[next].samples.front().key) {
+            next = static_cast<int32_t>(i);
+        }
+        lookAheadFull = lookAheadFull || samples.size() >= maxPending_;
+        newestKey = std::max(newestKey, samples.back().key);
+    }
+    if (next < 0 || drain || allPending || lookAheadFull) {
+        return next;
+    }
+    return newestKey - tracks_[next].samples.front().key >= windowUs_ ? next : -1;
+}
+
+std::shared_ptr<AVBuffer> SampleInterleaver::Pop(uint32_t track)
+{
+    if (track >= tracks_.size() || tracks_[track].samples.empty()) {
+        return nullptr;
+    }
+    std::shared_ptr<AVBuffer> sample = tracks_[track].samples.front().sample;
+    tracks_[track].samples.pop_front();
+    pendingCount_--;
+    return sample;
+}
+
+bool SampleInterleaver::IsFull(uint32_t track) const
+{
+    return track < tracks_.size() && tracks_[track].samples.size() >= maxPending_;
+}
+
+bool SampleInterleaver::Empty() const
+{
+    return pendingCount_ == 0;
+}
+} // namespace Media
+} // namespace OHOS
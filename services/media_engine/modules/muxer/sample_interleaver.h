@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVCODEC_SAMPLE_INTERLEAVER_H
+#define AVCODEC_SAMPLE_INTERLEAVER_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "buffer/avbuffer.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Merges the samples of several tracks into decode timestamp order for the muxer writer thread.
+ *
+ * Samples of one track must be pushed in decode order. The head with the smallest timestamp is only released once
+ * every other track has a sample pending too, unless the look-ahead is exhausted: some track holds maxPending
+ * samples, or the newest pending sample is windowUs ahead of it. The output therefore only depends on the samples
+ * and not on the order tracks delivered them in. Not thread safe, it belongs to the thread that drives it.
+ */
+class SampleInterleaver {
+public:
+    static constexpr int64_t DEFAULT_WINDOW_US = 500000;
+    static constexpr uint32_t DEFAULT_MAX_PENDING = 5;
+
+    explicit SampleInterleaver(uint32_t trackCount, int64_t windowUs = DEFAULT_WINDOW_US,
+        uint32_t maxPending = DEFAULT_MAX_PENDING);
+
+    void Push(uint32_t track, const std::shared_ptr<AVBuffer> &sample);
+
+    // Returns the track whose head goes next, or -1 while a track without pending samples may still deliver an
+    // earlier one. With drain set every pending sample is released.
+    int32_t Next(bool drain) const;
+
+    std::shared_ptr<AVBuffer> Pop(uint32_t track);
+
+    bool IsFull(uint32_t track) const;
+
+    bool Empty() const;
+
+private:
+    struct Pending {
+        int64_t key;
+        std::shared_ptr<AVBuffer> sample;
+    };
+    struct Track {
+        std::deque<Pending> samples;
+        int64_t lastKey {INT64_MIN};
+    };
+
+    std::vector<Track> tracks_;
+    int64_t windowUs_;
+    uint32_t maxPending_;
+    size_t pendingCount_ {0};
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVCODEC_SAMPLE_INTERLEAVER_H
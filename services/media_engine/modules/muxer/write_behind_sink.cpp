@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define HST_LOG_TAG "WriteBehindSink"
+
+#include "write_behind_sink.h"
+#include <cstdio>
+#include <pthread.h>
+#include "common/log.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_DOMAIN_MUXER, "HiStreamer" };
+}
+
+namespace OHOS {
+namespace Media {
+WriteBehindSink::WriteBehindSink(const std::shared_ptr<Plugins::DataSink> &sink, uint32_t maxPending)
+    : sink_(sink), maxPending_(maxPending > 0 ? maxPending : 1)
+{
+    int64_t pos = sink_->GetCurrentPosition();
+    end_ = sink_->Seek(0, SEEK_END);
+    pos_ = sink_->Seek(pos, SEEK_SET);
+    thread_ = std::thread(&WriteBehindSink::WriteLoop, this);
+}
+
+WriteBehindSink::~WriteBehindSink()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isStopped_ = true;
+        cond_.notify_all();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+int32_t WriteBehindSink::Read(uint8_t *buf, int32_t bufSize)
+{
+    FALSE_RETURN_V_MSG_E(Flush() == 0, -1, "failed to read, a queued write failed");
+    FALSE_RETURN_V_MSG_E(sink_->Seek(pos_, SEEK_SET) != -1, -1, "failed to seek");
+    int32_t size = sink_->Read(buf, bufSize);
+    if (size > 0) {
+        pos_ += size;
+    }
+    return size;
+}
+
+int32_t WriteBehindSink::Write(const uint8_t *buf, int32_t bufSize)
+{
+    FALSE_RETURN_V_MSG_E(bufSize >= 0, -1, "invalid size %{public}d", bufSize);
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return pending_.size() < maxPending_ || isFailed_; });
+    FALSE_RETURN_V_MSG_E(!isFailed_, -1, "failed to write, a queued write failed");
+    Request request;
+    request.pos = pos_;
+    if (!freeBuffers_.empty()) {
+        request.data = std::move(freeBuffers_.back());
+        freeBuffers_.pop_back();
+    }
+    request.data.assign(buf, buf + bufSize);
+    pending_.push_back(std::move(request));
+    cond_.notify_all();
+    pos_ += bufSize;
+    end_ = pos_ > end_ ? pos_ : end_;
+    return bufSize;
+}
+
+int64_t WriteBehindSink::Seek(int64_t offset, int whence)
+{
+    switch (whence) {
+        case SEEK_SET:
+            pos_ = offset;
+            break;
+        case SEEK_CUR:
+            pos_ = pos_ + offset;
+            break;
+        case SEEK_END:
+            pos_ = end_ + offset;
+            break;
+        default:
+            pos_ = offset;
+            break;
+    }
+    return pos_;
+}
+
+int64_t WriteBehindSink::GetCurrentPosition() const
+{
+    return pos_;
+}
+
+bool WriteBehindSink::CanRead()
+{
+    return sink_->CanRead();
+}
+
+int32_t WriteBehindSink::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return pending_.empty() && !isWriting_; });
+    return isFailed_ ? -1 : 0;
+}
+
+void WriteBehindSink::WriteLoop()
+{
+    pthread_setname_np(pthread_self(), "OS_MUXER_IO");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cond_.wait(lock, [this] { return !pending_.empty() || isStopped_; });
+        if (pending_.empty()) {
+            break;
+        }
+        Request request = std::move(pending_.front());
+        pending_.pop_front();
+        isWriting_ = true;
+        bool isFailed = isFailed_;
+        lock.unlock();
+        if (!isFailed) {
+            int32_t size = static_cast<int32_t>(request.data.size());
+            isFailed = sink_->Seek(request.pos, SEEK_SET) == -1 || sink_->Write(request.data.data(), size) != size;
+        }
+        lock.lock();
+        if (isFailed && !isFailed_) {
+            MEDIA_LOG_E("write of " PUBLIC_LOG_ZU " bytes at " PUBLIC_LOG_D64 " failed",
+                request.data.size(), request.pos);
+            isFailed_ = true;
+        }
+        isWriting_ = false;
+        if (freeBuffers_.size() < maxPending_) {
+            freeBuffers_.push_back(std::move(request.data));
+        }
+        cond_.notify_all();
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVCODEC_WRITE_BEHIND_SINK_H
+#define AVCODEC_WRITE_BEHIND_SINK_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "plugin/data_sink.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Hands writes to a worker thread so that file io overlaps with muxing.
+ *
+ * Write copies the data into a pooled buffer and returns at once, it only blocks while maxPending writes are
+ * queued. Read waits for the queued writes first, Seek and GetCurrentPosition are served locally. A failed write
+ * makes every later Write and Flush fail. Like any DataSink it is driven by one thread.
+ */
+class WriteBehindSink : public Plugins::DataSink {
+public:
+    static constexpr uint32_t DEFAULT_MAX_PENDING = 4;
+
+    explicit WriteBehindSink(const std::shared_ptr<Plugins::DataSink> &sink,
+        uint32_t maxPending = DEFAULT_MAX_PENDING);
+    WriteBehindSink(const WriteBehindSink &other) = delete;
+    WriteBehindSink& operator=(const WriteBehindSink&) = delete;
+    virtual ~WriteBehindSink();
+
+    int32_t Read(uint8_t *buf, int32_t bufSize) override;
+    int32_t Write(const uint8_t *buf, int32_t bufSize) override;
+    int64_t Seek(int64_t offset, int whence) override;
+    int64_t GetCurrentPosition() const override;
+    bool CanRead() override;
+
+    // Waits until every queued write reached the sink, returns -1 if any of them failed
+    int32_t Flush();
+
+private:
+    struct Request {
+        int64_t pos {0};
+        std::vector<uint8_t> data;
+    };
+
+    void WriteLoop();
+
+    std::shared_ptr<Plugins::DataSink> sink_;
+    const uint32_t maxPending_;
+    int64_t pos_ {0};
+    int64_t end_ {0};
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<Request> pending_;
+    std::vector<std::vector<uint8_t>> freeBuffers_;
+    bool isWriting_ {false};
+    bool isFailed_ {false};
+    bool isStopped_ {false};
+    std::thread thread_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVCODEC_WRITE_BEHIND_SINK_H
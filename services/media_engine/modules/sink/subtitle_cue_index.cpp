@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "subtitle_cue_index.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace Media {
+namespace {
+// bounds the bucket table for cues with bogus timestamps, about three days with the default bucket width
+constexpr size_t MAX_BUCKET_NUM = 1 << 18;
+}
+
+SubtitleCueIndex::SubtitleCueIndex(int64_t bucketUs) : bucketUs_(bucketUs > 0 ? bucketUs : DEFAULT_BUCKET_US)
+{
+}
+
+bool SubtitleCueIndex::Insert(const std::string &text, int64_t pts, int64_t duration)
+{
+    if (pts < 0 || duration <= 0 || pts > NO_BOUNDARY - duration) {
+        return false;
+    }
+    if (BucketOf(pts + duration - 1) >= MAX_BUCKET_NUM || Contains(text, pts, duration)) {
+        return false;
+    }
+    cues_.push_back({ text, pts, duration, nextId_++ });
+    AddToBuckets(static_cast<uint32_t>(cues_.size() - 1));
+    return true;
+}
+
+void SubtitleCueIndex::AddToBuckets(uint32_t slot)
+{
+    const SubtitleCue &cue = cues_[slot];
+    size_t last = BucketOf(cue.End() - 1);
+    if (buckets_.size() <= last) {
+        buckets_.resize(last + 1);
+    }
+    for (size_t i = BucketOf(cue.pts); i <= last; ++i) {
+        auto &bucket = buckets_[i];
+        auto pos = std::upper_bound(bucket.begin(), bucket.end(), cue.pts,
+            [this](int64_t start, uint32_t index) { return start < cues_[index].pts; });
+        bucket.insert(pos, slot);
+    }
+}
+
+size_t SubtitleCueIndex::EraseEndedBefore(int64_t time)
+{
+    auto ended = std::remove_if(cues_.begin(), cues_.end(), [time](const SubtitleCue &cue) {
+        return cue.End() <= time;
+    });
+    size_t erased = static_cast<size_t>(cues_.end() - ended);
+    if (erased == 0) {
+        return 0;
+    }
+    // slots moved, the buckets are rebuilt from the cues left, which are few once the played ones are gone
+    cues_.erase(ended, cues_.end());
+    buckets_.clear();
+    for (uint32_t slot = 0; slot < cues_.size(); ++slot) {
+        AddToBuckets(slot);
+    }
+    return erased;
+}
+
+void SubtitleCueIndex::FindActive(int64_t time, std::vector<const SubtitleCue *> &cues) const
+{
+    cues.clear();
+    if (time < 0 || BucketOf(time) >= buckets_.size()) {
+        return;
+    }
+    for (uint32_t index : buckets_[BucketOf(time)]) {
+        const SubtitleCue &cue = cues_[index];
+        if (cue.pts > time) {
+            break;
+        }
+        if (cue.End() > time) {
+            cues.push_back(&cue);
+        }
+    }
+}
+
+int64_t SubtitleCueIndex::NextBoundary(int64_t time) const
+{
+    int64_t boundary = NO_BOUNDARY;
+    for (size_t i = time < 0 ? 0 : BucketOf(time); i < buckets_.size(); ++i) {
+        for (uint32_t index : buckets_[i]) {
+            const SubtitleCue &cue = cues_[index];
+            if (cue.pts > time) {
+                // later cues of the bucket start, and so end, after this one
+                boundary = std::min(boundary, cue.pts);
+                break;
+            }
+            if (cue.End() > time) {
+                boundary = std::min(boundary, cue.End());
+            }
+        }
+        // boundaries found in later buckets can not be earlier than the end of this one
+        if (boundary <= static_cast<int64_t>(i + 1) * bucketUs_) {
+            return boundary;
+        }
+    }
+    return boundary;
+}
+
+void SubtitleCueIndex::Clear()
+{
+    cues_.clear();
+    buckets_.clear();
+}
+
+size_t SubtitleCueIndex::BucketOf(int64_t time) const
+{
+    return static_cast<size_t>(time / bucketUs_);
+}
+
+bool SubtitleCueIndex::Contains(const std::string &text, int64_t pts, int64_t duration) const
+{
+    size_t bucket = BucketOf(pts);
+    if (bucket >= buckets_.size()) {
+        return false;
+    }
+    return std::any_of(buckets_[bucket].begin(), buckets_[bucket].end(), [&](uint32_t index) {
+        const SubtitleCue &cue = cues_[index];
+        return cue.pts == pts && cue.duration == duration && cue.text == text;
+    });
+}
+} // namespace Media
+} // namespace OHOS
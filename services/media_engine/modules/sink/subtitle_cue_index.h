@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_SUBTITLE_CUE_INDEX_H
+#define HISTREAMER_SUBTITLE_CUE_INDEX_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace Media {
+struct SubtitleCue {
+    std::string text;
+    int64_t pts {0};
+    int64_t duration {0};
+    uint32_t id {0}; // unique within the index, kept when other cues are erased
+
+    int64_t End() const
+    {
+        return pts + duration;
+    }
+};
+
+/**
+ * Time bucketed interval index of subtitle cues.
+ *
+ * Every cue is listed, ordered by start time, in each fixed width bucket its [pts, pts + duration) interval
+ * overlaps, so the cues active at a time and the next cue boundary are found by scanning a single bucket whatever
+ * the number of cues or how they overlap. Cues may be inserted in any order, a cue already indexed is ignored.
+ */
+class SubtitleCueIndex {
+public:
+    static constexpr int64_t DEFAULT_BUCKET_US = 1000000;
+    static constexpr int64_t NO_BOUNDARY = std::numeric_limits<int64_t>::max();
+
+    explicit SubtitleCueIndex(int64_t bucketUs = DEFAULT_BUCKET_US);
+
+    // Returns false if the cue is invalid or already indexed
+    bool Insert(const std::string &text, int64_t pts, int64_t duration);
+    // Cues whose interval contains time, ordered by start time
+    void FindActive(int64_t time, std::vector<const SubtitleCue *> &cues) const;
+    // First cue start or end after time, NO_BOUNDARY if there is none
+    int64_t NextBoundary(int64_t time) const;
+    // Erases the cues ended at or before time, returns how many were erased
+    size_t EraseEndedBefore(int64_t time);
+    void Clear();
+
+    size_t Size() const
+    {
+        return cues_.size();
+    }
+
+    bool Empty() const
+    {
+        return cues_.empty();
+    }
+
+private:
+    size_t BucketOf(int64_t time) const;
+    bool Contains(const std::string &text, int64_t pts, int64_t duration) const;
+    void AddToBuckets(uint32_t slot);
+
+    int64_t bucketUs_;
+    std::vector<SubtitleCue> cues_;
+    std::vector<std::vector<uint32_t>> buckets_; // slots in cues_
+    uint32_t nextId_ {0};
+};
+} // namespace Media
+} // namespace OHOS
+#endif // HISTREAMER_SUBTITLE_CUE_INDEX_H
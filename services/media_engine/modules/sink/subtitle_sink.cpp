@@ -15,6 +15,7 @@
 
 #include "subtitle_sink.h"
 
+#include <algorithm>
 #include "common/log.h"
 #include "syspara/parameters.h"
 #include "meta/format.h"
@@ -27,6 +28,9 @@ namespace OHOS {
 namespace Media {
 namespace {
 constexpr bool SUBTITME_LOOP_RUNNING = true;
+// how far ahead of playback cues are taken from the demuxer, and how many are cached at most
+constexpr int64_t MAX_CUE_LOOKAHEAD_US = 10 * 1000 * 1000;
+constexpr size_t MAX_CACHED_CUE_NUM = 256;
 }
 
 SubtitleSink::SubtitleSink()
@@ -62,28 +66,6 @@ void SubtitleSink::NotifySeek()
     Flush();
 }
 
-void SubtitleSink::GetTargetSubtitleIndex(int64_t currentTime)
-{
-    int32_t left = 0;
-    int32_t right = subtitleInfoVec_.size();
-    while (left < right) {
-        int32_t mid = (left + right) / 2;
-        int64_t startTime = subtitleInfoVec_.at(mid).pts_;
-        int64_t endTime = subtitleInfoVec_.at(mid).duration_ + startTime;
-        if (startTime > currentTime) {
-            right = mid;
-            continue;
-        } else if (endTime < currentTime) {
-            left = mid + 1;
-            continue;
-        } else {
-            left = mid;
-            break;
-        }
-    }
-    currentInfoIndex_ = left;
-}
-
 Status SubtitleSink::Init(std::shared_ptr<Meta> &meta, const std::shared_ptr<Pipeline::EventReceiver> &receiver)
 {
     state_ = Pipeline::FilterState::INITIALIZED;
@@ -143,14 +125,23 @@ Status SubtitleSink::Start()
 
 Status SubtitleSink::Stop()
 {
-    updateCond_.notify_all();
-    state_ = Pipeline::FilterState::INITIALIZED;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        MEDIA_LOG_I("SubtitleSink Stop, cached cues: %{public}zu", cueIndex_.Size());
+        state_ = Pipeline::FilterState::INITIALIZED;
+    }
+    ClearCues();
     return Status::OK;
 }
 
 Status SubtitleSink::Pause()
 {
-    state_ = Pipeline::FilterState::PAUSED;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        state_ = Pipeline::FilterState::PAUSED;
+        shouldUpdate_ = true;
+    }
+    updateCond_.notify_all();
     return Status::OK;
 }
 
@@ -160,6 +151,7 @@ Status SubtitleSink::Resume()
         std::unique_lock<std::mutex> lock(mutex_);
         isEos_ = false;
         state_ = Pipeline::FilterState::RUNNING;
+        shouldUpdate_ = true;
     }
     updateCond_.notify_all();
     return Status::OK;
@@ -167,17 +159,26 @@ Status SubtitleSink::Resume()
 
 Status SubtitleSink::Flush()
 {
+    // after a seek or a track change the demuxer sends the cues from the new position again
+    ClearCues();
+    return Status::OK;
+}
+
+void SubtitleSink::ClearCues()
+{
+    std::shared_ptr<AVBuffer> heldBuffer;
     {
         std::unique_lock<std::mutex> lock(mutex_);
+        cueIndex_.Clear();
+        shownCueIds_.clear();
+        heldBuffer = std::move(heldBuffer_);
+        heldBuffer_ = nullptr;
         shouldUpdate_ = true;
-        if (subtitleInfoVec_.size() > 0) {
-            inputBufferQueueConsumer_->ReleaseBuffer(filledOutputBuffer_);
-            subtitleInfoVec_.clear();
-        }
     }
-    isFlush_.store(true);
     updateCond_.notify_all();
-    return Status::OK;
+    if (heldBuffer != nullptr && inputBufferQueueConsumer_ != nullptr) {
+        inputBufferQueueConsumer_->ReleaseBuffer(heldBuffer);
+    }
 }
 
 Status SubtitleSink::Release()
@@ -248,56 +249,110 @@ void SubtitleSink::DrainOutputBuffer(bool flushed)
     }
     std::string subtitleText(reinterpret_cast<const char *>(filledOutputBuffer_->memory_->GetAddr()),
                              filledOutputBuffer_->memory_->GetSize());
-    SubtitleInfo subtitleInfo{ subtitleText, filledOutputBuffer_->pts_, filledOutputBuffer_->duration_ };
+    int64_t pts = filledOutputBuffer_->pts_;
+    int64_t duration = filledOutputBuffer_->duration_;
+    int64_t curTime = GetMediaTime();
+    bool needUpdate = false;
     {
         std::unique_lock<std::mutex> lock(mutex_);
-        subtitleInfoVec_.push_back(subtitleInfo);
+        bool isInserted = cueIndex_.Insert(subtitleText, pts, duration);
+        if (isInserted && heldBuffer_ == nullptr && IsBeyondLookahead(pts, curTime)) {
+            // the cue is indexed already, keeping its buffer only stops the demuxer from feeding further ahead
+            heldBuffer_ = filledOutputBuffer_;
+            heldPts_ = pts;
+            shouldUpdate_ = true;
+            lock.unlock();
+            updateCond_.notify_all();
+            return;
+        }
+        needUpdate = isInserted && pts < nextWakeTime_;
+        if (needUpdate) {
+            shouldUpdate_ = true;
+        }
     }
-    updateCond_.notify_all();
+    // the cue is copied into the index, hand the buffer back so the demuxer can feed ahead
+    inputBufferQueueConsumer_->ReleaseBuffer(filledOutputBuffer_);
+    if (needUpdate) {
+        updateCond_.notify_all();
+    }
+}
+
+bool SubtitleSink::IsBeyondLookahead(int64_t pts, int64_t curTime)
+{
+    return pts - std::max<int64_t>(curTime, 0) > MAX_CUE_LOOKAHEAD_US || cueIndex_.Size() > MAX_CACHED_CUE_NUM;
+}
+
+std::shared_ptr<AVBuffer> SubtitleSink::TakeHeldBuffer(int64_t curTime)
+{
+    if (heldBuffer_ == nullptr || IsBeyondLookahead(heldPts_, curTime)) {
+        return nullptr;
+    }
+    std::shared_ptr<AVBuffer> heldBuffer = std::move(heldBuffer_);
+    heldBuffer_ = nullptr;
+    return heldBuffer;
 }
 
 void SubtitleSink::RenderLoop()
 {
+    auto wakeUp = [this] { return isThreadExit_.load() || shouldUpdate_.load(); };
     while (SUBTITME_LOOP_RUNNING) {
         std::unique_lock<std::mutex> lock(mutex_);
         updateCond_.wait(lock, [this] {
-            return isThreadExit_.load() ||
-                   (subtitleInfoVec_.size() > 0 && state_ == Pipeline::FilterState::RUNNING);
+            return isThreadExit_.load() || (!cueIndex_.Empty() && state_ == Pipeline::FilterState::RUNNING);
         });
-        if (isFlush_) {
-            MEDIA_LOG_I("SubtitleSink RenderLoop flush");
-            isFlush_.store(false);
-            continue;
-        }
         FALSE_RETURN(!isThreadExit_.load());
-        // wait timeout, seek or stop
-        SubtitleInfo tempSubtitleInfo = subtitleInfoVec_.back();
-        SubtitleInfo subtitleInfo{ tempSubtitleInfo.text_, tempSubtitleInfo.pts_, tempSubtitleInfo.duration_ };
-        int64_t waitTime = CalcWaitTime(subtitleInfo);
-        updateCond_.wait_for(lock, std::chrono::microseconds(waitTime),
-                             [this] { return isThreadExit_.load() || shouldUpdate_; });
-        MEDIA_LOG_I("SubtitleSink NotifyRender buffer. pts = " PUBLIC_LOG_D64 " waitTime: " PUBLIC_LOG_D64,
-            subtitleInfo.pts_, waitTime);
-        if (isFlush_) {
-            MEDIA_LOG_I("SubtitleSink RenderLoop flush");
-            isFlush_.store(false);
-            continue;
+        shouldUpdate_ = false;
+        int64_t curTime = GetMediaTime();
+        cueIndex_.EraseEndedBefore(curTime);
+        std::shared_ptr<AVBuffer> heldBuffer = TakeHeldBuffer(curTime);
+        if (heldBuffer != nullptr && inputBufferQueueConsumer_ != nullptr) {
+            lock.unlock();
+            inputBufferQueueConsumer_->ReleaseBuffer(heldBuffer);
+            lock.lock();
+        }
+        RenderActiveCues(curTime);
+        // sleep until a cue starts or ends, or until seek, speed change, pause or an earlier cue wakes the loop
+        nextWakeTime_ = cueIndex_.NextBoundary(curTime);
+        if (heldBuffer_ != nullptr && heldPts_ - MAX_CUE_LOOKAHEAD_US > curTime) {
+            // also wake when the held cue comes within the look ahead window, cue ends free the cache otherwise
+            nextWakeTime_ = std::min(nextWakeTime_, heldPts_ - MAX_CUE_LOOKAHEAD_US);
+        }
+        if (nextWakeTime_ == SubtitleCueIndex::NO_BOUNDARY) {
+            updateCond_.wait(lock, wakeUp);
+        } else {
+            updateCond_.wait_for(lock, std::chrono::microseconds(CalcWaitTime(curTime)), wakeUp);
         }
+        nextWakeTime_ = SubtitleCueIndex::NO_BOUNDARY;
         FALSE_RETURN(!isThreadExit_.load());
-        auto actionToDo = ActionToDo(subtitleInfo);
-        if (actionToDo == SubtitleBufferState::DROP) {
-            inputBufferQueueConsumer_->ReleaseBuffer(filledOutputBuffer_);
-            subtitleInfoVec_.clear();
-            continue;
-        } else if (actionToDo == SubtitleBufferState::WAIT) {
-            continue;
-        } else {}
-        NotifyRender(subtitleInfo);
-        inputBufferQueueConsumer_->ReleaseBuffer(filledOutputBuffer_);
-        subtitleInfoVec_.clear();
     }
 }
 
+void SubtitleSink::RenderActiveCues(int64_t curTime)
+{
+    cueIndex_.FindActive(curTime, activeCues_);
+    bool changed = activeCues_.size() != shownCueIds_.size() ||
+        !std::equal(activeCues_.begin(), activeCues_.end(), shownCueIds_.begin(),
+            [](const SubtitleCue *cue, uint32_t id) { return cue->id == id; });
+    if (!changed) {
+        return;
+    }
+    shownCueIds_.clear();
+    for (const SubtitleCue *cue : activeCues_) {
+        shownCueIds_.push_back(cue->id);
+    }
+    // the previous text expires by its duration when no cue is left
+    FALSE_RETURN(!activeCues_.empty());
+    SubtitleInfo subtitleInfo{ activeCues_.front()->text, activeCues_.back()->pts, 0 };
+    for (size_t i = 1; i < activeCues_.size(); ++i) {
+        subtitleInfo.text_ += "\n" + activeCues_[i]->text;
+    }
+    // overlapping cues are shown together until the next one starts or ends
+    subtitleInfo.duration_ = cueIndex_.NextBoundary(curTime) - curTime;
+    MEDIA_LOG_I("SubtitleSink NotifyRender cues: %{public}zu, pts = " PUBLIC_LOG_D64 ", duration = " PUBLIC_LOG_D64,
+        activeCues_.size(), subtitleInfo.pts_, subtitleInfo.duration_);
+    NotifyRender(subtitleInfo);
+}
+
 void SubtitleSink::ResetSyncInfo()
 {
     auto syncCenter = syncCenter_.lock();
@@ -307,30 +362,12 @@ void SubtitleSink::ResetSyncInfo()
     lastReportedClockTime_ = HST_TIME_NONE;
 }
 
-uint64_t SubtitleSink::CalcWaitTime(SubtitleInfo &subtitleInfo)
+uint64_t SubtitleSink::CalcWaitTime(int64_t curTime)
 {
-    int64_t curTime;
-    if (shouldUpdate_.load()) {
-        shouldUpdate_ = false;
-    }
-    curTime = GetMediaTime();
-    if (subtitleInfo.pts_ < curTime) {
+    if (nextWakeTime_ <= curTime) {
         return 0;
     }
-    return (subtitleInfo.pts_ - curTime) / speed_;
-}
-
-uint32_t SubtitleSink::ActionToDo(SubtitleInfo &subtitleInfo)
-{
-    auto curTime = GetMediaTime();
-    if (shouldUpdate_ || subtitleInfo.pts_ + subtitleInfo.duration_ < curTime) {
-        return SubtitleBufferState::DROP;
-    }
-    if (subtitleInfo.pts_ > curTime || state_ != Pipeline::FilterState::RUNNING) {
-        return SubtitleBufferState::WAIT;
-    }
-    subtitleInfo.duration_ -= curTime - subtitleInfo.pts_;
-    return SubtitleBufferState::SHOW;
+    return (nextWakeTime_ - curTime) / speed_;
 }
 
 int64_t SubtitleSink::DoSyncWrite(const std::shared_ptr<OHOS::Media::AVBuffer> &buffer)
@@ -187,6 +187,16 @@ int64_t VideoSink::CheckBufferLatenessMayWait(const std::shared_ptr<OHOS::Media:
     return dropFlag ? -1 : waitTimeUs;
 }
 
+int64_t VideoSink::GetRenderSlackUs(int64_t pts)
+{
+    auto syncCenter = syncCenter_.lock();
+    int64_t firstPts = firstPts_.load();
+    FALSE_RETURN_V(syncCenter != nullptr && !isFirstFrame_.load() && firstPts != HST_TIME_NONE, INT64_MAX);
+    auto ct4Buffer = syncCenter->GetClockTime(pts - firstPts);
+    FALSE_RETURN_V(ct4Buffer != Plugins::HST_TIME_NONE, INT64_MAX);
+    return ct4Buffer - syncCenter->GetClockTimeNow();
+}
+
 void VideoSink::SetSyncCenter(std::shared_ptr<Pipeline::MediaSyncManager> syncCenter)
 {
     MEDIA_LOG_D_SHORT("VideoSink::SetSyncCenter");
@@ -203,7 +213,7 @@ void VideoSink::SetFirstPts(int64_t pts)
 {
     if (firstPts_ == HST_TIME_NONE) {
         firstPts_ = pts;
-        MEDIA_LOG_I_SHORT("video DoSyncWrite set firstPts = " PUBLIC_LOG_D64, firstPts_);
+        MEDIA_LOG_I_SHORT("video DoSyncWrite set firstPts = " PUBLIC_LOG_D64, pts);
     }
 }
 
@@ -127,9 +127,20 @@ Status AudioCaptureModule::Prepare()
         "bufferSize is too big: " PUBLIC_LOG_ZU, size);
     bufferSize_ = size;
     MEDIA_LOG_E("bufferSize is: " PUBLIC_LOG_ZU, bufferSize_);
+    ConfigureLevelMeter();
     return Status::OK;
 }
 
+void AudioCaptureModule::ConfigureLevelMeter()
+{
+    Plugins::AudioSampleFormat sampleFormat = Plugins::AudioSampleFormat::INVALID_WIDTH;
+    FALSE_RETURN_MSG(SampleFmt2ModuleFmt(options_.streamInfo.format, sampleFormat),
+        "level meter does not support sample format " PUBLIC_LOG_D32,
+        static_cast<int32_t>(options_.streamInfo.format));
+    FALSE_LOG_MSG(levelMeter_.Configure(sampleFormat, options_.streamInfo.channels,
+        options_.streamInfo.samplingRate) == Status::OK, "Configure level meter fail");
+}
+
 Status AudioCaptureModule::Reset()
 {
     MEDIA_LOG_I("Reset enter.");
@@ -327,8 +338,7 @@ Status AudioCaptureModule::Read(std::shared_ptr<AVBuffer> &buffer, size_t expect
     FALSE_RETURN_V_MSG_E(size >= 0, Status::ERROR_NOT_ENOUGH_DATA, "audioCapturer Read() fail");
 
     if (isTrackMaxAmplitude) {
-        TrackMaxAmplitude((int16_t *)bufData->GetAddr(),
-            static_cast<int32_t>(static_cast<uint32_t>(bufData->GetSize()) >> 1));
+        levelMeter_.Process(bufData->GetAddr(), static_cast<size_t>(size));
     }
     return ret;
 }
@@ -381,27 +391,21 @@ int32_t AudioCaptureModule::GetMaxAmplitude()
     if (!isTrackMaxAmplitude) {
         isTrackMaxAmplitude = true;
     }
-    int16_t value = maxAmplitude_;
-    maxAmplitude_ = 0;
-    return value;
+    return levelMeter_.GetMaxAmplitude();
 }
 
-void AudioCaptureModule::SetAudioSource(AudioStandard::SourceType source)
+Status AudioCaptureModule::GetAudioLevels(AudioLevels &levels)
 {
-    options_.capturerInfo.sourceType = source;
+    // GetMaxAmplitude may have started the metering already, loudness still has to be switched on
+    isTrackMaxAmplitude = true;
+    levelMeter_.EnableLoudness(true);
+    levelMeter_.GetLevels(levels);
+    return Status::OK;
 }
 
-void AudioCaptureModule::TrackMaxAmplitude(int16_t *data, int32_t size)
+void AudioCaptureModule::SetAudioSource(AudioStandard::SourceType source)
 {
-    for (int32_t i = 0; i < size; i++) {
-        int16_t value = *data++;
-        if (value < 0) {
-            value = -value;
-        }
-        if (maxAmplitude_ < value) {
-            maxAmplitude_ = value;
-        }
-    }
+    options_.capturerInfo.sourceType = source;
 }
 
 void AudioCaptureModule::SetFaultEvent(const std::string &errMsg, int32_t ret)
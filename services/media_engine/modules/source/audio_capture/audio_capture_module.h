@@ -16,9 +16,11 @@
 #ifndef HISTREAMER_AUDIO_CAPTURE_MODULE_H
 #define HISTREAMER_AUDIO_CAPTURE_MODULE_H
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include "audio_capturer.h"
+#include "audio_level_meter.h"
 #include "common/status.h"
 #include "meta/meta.h"
 #include "buffer/avbuffer.h"
@@ -55,6 +57,8 @@ public:
         const std::shared_ptr<AudioStandard::AudioCapturerInfoChangeCallback> &callback);
     Status GetCurrentCapturerChangeInfo(AudioStandard::AudioCapturerChangeInfo &changeInfo);
     int32_t GetMaxAmplitude();
+    // Per channel levels and momentary loudness since the last call, metering starts with the first call
+    Status GetAudioLevels(AudioLevels &levels);
     void SetAudioSource(AudioStandard::SourceType source);
     void SetFaultEvent(const std::string &errMsg);
     void SetFaultEvent(const std::string &errMsg, int32_t ret);
@@ -65,8 +69,7 @@ private:
     bool AssignSampleRateIfSupported(const int32_t value);
     bool AssignChannelNumIfSupported(const int32_t value);
     bool AssignSampleFmtIfSupported(const Plugins::AudioSampleFormat value);
-
-    void TrackMaxAmplitude(int16_t *data, int32_t size);
+    void ConfigureLevelMeter();
 
     Mutex captureMutex_ {};
     std::unique_ptr<OHOS::AudioStandard::AudioCapturer> audioCapturer_ {nullptr};
@@ -80,8 +83,8 @@ private:
     int32_t appPid_ {0};
     int64_t appFullTokenId_ {0};
     size_t bufferSize_ {0};
-    int32_t maxAmplitude_ {0};
-    bool isTrackMaxAmplitude {false};
+    AudioLevelMeter levelMeter_;
+    std::atomic<bool> isTrackMaxAmplitude {false};
     std::string bundleName_;
     uint64_t instanceId_{0};
 };
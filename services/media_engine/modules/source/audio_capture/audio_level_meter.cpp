@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_level_meter.h"
+#include <algorithm>
+#include <cmath>
+#include "common/log.h"
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_DOMAIN_RECORDER, "AudioLevelMeter" };
+}
+
+namespace OHOS {
+namespace Media {
+namespace AudioCaptureModule {
+namespace {
+constexpr uint32_t LANE_NUM = 4;
+// float lane sums are moved to double before the rounding error of long blocks becomes visible
+constexpr size_t FLUSH_STEP_NUM = 256;
+constexpr float S16_MAX_AMPLITUDE = 32767.0f;
+constexpr float S16_SCALE = 32768.0f;
+constexpr float S24_SCALE = 8388608.0f;
+constexpr float S32_SCALE = 2147483648.0f;
+constexpr float U8_SCALE = 128.0f;
+constexpr int32_t U8_ZERO = 128;
+constexpr uint32_t S24_BYTES = 3;
+constexpr uint32_t BLOCKS_PER_SECOND = 10;
+constexpr double LOUDNESS_OFFSET = -0.691;
+constexpr double DB_FACTOR = 10.0;
+// ITU-R BS.1770 channel weights of the 5.1 layout, L R C LFE Ls Rs
+constexpr uint32_t SURROUND_CHANNEL_NUM = 6;
+constexpr double SURROUND_WEIGHTS[SURROUND_CHANNEL_NUM] = { 1.0, 1.0, 1.0, 0.0, 1.41, 1.41 };
+// ITU-R BS.1770 K-weighting pre-filter and RLB high pass, recomputed for the sample rate
+constexpr double SHELF_FREQUENCY = 1681.974450955533;
+constexpr double SHELF_GAIN_DB = 3.999843853973347;
+constexpr double SHELF_Q = 0.7071752369554196;
+constexpr double SHELF_BAND_EXPONENT = 0.4996667741545416;
+constexpr double HIGH_PASS_FREQUENCY = 38.13547087602444;
+constexpr double HIGH_PASS_Q = 0.5003270373238773;
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define AUDIO_LEVEL_METER_SIMD
+using Float4 = float32x4_t;
+inline Float4 Zero4()
+{
+    return vdupq_n_f32(0.0f);
+}
+inline Float4 AbsMax4(Float4 peak, Float4 value)
+{
+    return vmaxq_f32(peak, vabsq_f32(value));
+}
+inline Float4 SquareAdd4(Float4 sum, Float4 value)
+{
+    return vmlaq_f32(sum, value, value);
+}
+inline void Store4(float *out, Float4 value)
+{
+    vst1q_f32(out, value);
+}
+inline Float4 Load4(const int16_t *data)
+{
+    return vcvtq_f32_s32(vmovl_s16(vld1_s16(data)));
+}
+inline Float4 Load4(const int32_t *data)
+{
+    return vcvtq_f32_s32(vld1q_s32(data));
+}
+inline Float4 Load4(const float *data)
+{
+    return vld1q_f32(data);
+}
+#elif defined(__SSE2__)
+#define AUDIO_LEVEL_METER_SIMD
+using Float4 = __m128;
+inline Float4 Zero4()
+{
+    return _mm_setzero_ps();
+}
+inline Float4 AbsMax4(Float4 peak, Float4 value)
+{
+    return _mm_max_ps(peak, _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))));
+}
+inline Float4 SquareAdd4(Float4 sum, Float4 value)
+{
+    return _mm_add_ps(sum, _mm_mul_ps(value, value));
+}
+inline void Store4(float *out, Float4 value)
+{
+    _mm_storeu_ps(out, value);
+}
+inline Float4 Load4(const int16_t *data)
+{
+    __m128i value = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data));
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16)); // 16: sign extend to 32 bits
+}
+inline Float4 Load4(const int32_t *data)
+{
+    return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)));
+}
+inline Float4 Load4(const float *data)
+{
+    return _mm_loadu_ps(data);
+}
+#endif
+
+#ifdef AUDIO_LEVEL_METER_SIMD
+/**
+ * Accumulates whole vectors of samples into per channel peak and sum of squares, before scaling. Lane i always holds
+ * channel i % channelCount since the channel count divides the lane number. Returns the number of samples consumed.
+ */
+template <typename Sample>
+size_t AccumulateLanes(const uint8_t *data, size_t sampleCount, uint32_t channelCount, float *peak, double *sumSquares)
+{
+    const Sample *samples = reinterpret_cast<const Sample *>(data);
+    size_t stepCount = sampleCount / LANE_NUM;
+    Float4 peak4 = Zero4();
+    float lanePeak[LANE_NUM];
+    float laneSum[LANE_NUM];
+    for (size_t step = 0; step < stepCount;) {
+        size_t end = std::min(stepCount, step + FLUSH_STEP_NUM);
+        Float4 sum4 = Zero4();
+        for (; step < end; ++step) {
+            Float4 value = Load4(samples + step * LANE_NUM);
+            peak4 = AbsMax4(peak4, value);
+            sum4 = SquareAdd4(sum4, value);
+        }
+        Store4(laneSum, sum4);
+        for (uint32_t lane = 0; lane < LANE_NUM; ++lane) {
+            sumSquares[lane % channelCount] += laneSum[lane];
+        }
+    }
+    Store4(lanePeak, peak4);
+    for (uint32_t lane = 0; lane < LANE_NUM; ++lane) {
+        peak[lane % channelCount] = std::max(peak[lane % channelCount], lanePeak[lane]);
+    }
+    return stepCount * LANE_NUM;
+}
+#endif
+} // namespace
+
+Status AudioLevelMeter::Configure(Plugins::AudioSampleFormat format, uint32_t channelCount, uint32_t sampleRate)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    FALSE_RETURN_V_MSG_E(channelCount > 0 && channelCount <= MAX_CHANNEL_NUM && sampleRate > 0,
+        Status::ERROR_INVALID_PARAMETER, "Unsupported channel count " PUBLIC_LOG_U32 " or sample rate " PUBLIC_LOG_U32,
+        channelCount, sampleRate);
+    switch (format) {
+        case Plugins::AudioSampleFormat::SAMPLE_U8:
+            bytesPerSample_ = sizeof(uint8_t);
+            scale_ = 1.0f / U8_SCALE;
+            break;
+        case Plugins::AudioSampleFormat::SAMPLE_S16LE:
+            bytesPerSample_ = sizeof(int16_t);
+            scale_ = 1.0f / S16_SCALE;
+            break;
+        case Plugins::AudioSampleFormat::SAMPLE_S24LE:
+            bytesPerSample_ = S24_BYTES;
+            scale_ = 1.0f / S24_SCALE;
+            break;
+        case Plugins::AudioSampleFormat::SAMPLE_S32LE:
+            bytesPerSample_ = sizeof(int32_t);
+            scale_ = 1.0f / S32_SCALE;
+            break;
+        case Plugins::AudioSampleFormat::SAMPLE_F32LE:
+            bytesPerSample_ = sizeof(float);
+            scale_ = 1.0f;
+            break;
+        default:
+            format_ = Plugins::AudioSampleFormat::INVALID_WIDTH;
+            MEDIA_LOG_W("Unsupported sample format " PUBLIC_LOG_D32, static_cast<int32_t>(format));
+            return Status::ERROR_INVALID_PARAMETER;
+    }
+    format_ = format;
+    channelCount_ = channelCount;
+    sampleRate_ = sampleRate;
+    ConfigureLoudness();
+    peak_.fill(0.0f);
+    sumSquares_.fill(0.0);
+    frameCount_ = 0;
+    maxAmplitudePeak_ = 0.0f;
+    ResetLoudness();
+    return Status::OK;
+}
+
+void AudioLevelMeter::ConfigureLoudness()
+{
+    double k = std::tan(M_PI * SHELF_FREQUENCY / sampleRate_);
+    double vh = std::pow(10.0, SHELF_GAIN_DB / 20.0); // 20: amplitude decibel
+    double vb = std::pow(vh, SHELF_BAND_EXPONENT);
+    double a0 = 1.0 + k / SHELF_Q + k * k;
+    shelf_ = { (vh + vb * k / SHELF_Q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / SHELF_Q + k * k) / a0,
+        2.0 * (k * k - 1.0) / a0, (1.0 - k / SHELF_Q + k * k) / a0 };
+    k = std::tan(M_PI * HIGH_PASS_FREQUENCY / sampleRate_);
+    a0 = 1.0 + k / HIGH_PASS_Q + k * k;
+    highPass_ = { 1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / HIGH_PASS_Q + k * k) / a0 };
+    for (uint32_t channel = 0; channel < MAX_CHANNEL_NUM; ++channel) {
+        channelWeight_[channel] = (channelCount_ == SURROUND_CHANNEL_NUM && channel < SURROUND_CHANNEL_NUM) ?
+            SURROUND_WEIGHTS[channel] : 1.0;
+    }
+    blockFrames_ = std::max(sampleRate_ / BLOCKS_PER_SECOND, 1u);
+}
+
+void AudioLevelMeter::EnableLoudness(bool enable)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (loudnessEnabled_ != enable) {
+        loudnessEnabled_ = enable;
+        ResetLoudness();
+    }
+}
+
+void AudioLevelMeter::Process(const uint8_t *data, size_t size)
+{
+    FALSE_RETURN(data != nullptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    FALSE_RETURN(format_ != Plugins::AudioSampleFormat::INVALID_WIDTH);
+    size_t frameCount = size / (bytesPerSample_ * channelCount_);
+    FALSE_RETURN(frameCount > 0);
+    Accumulate(data, frameCount);
+    if (loudnessEnabled_) {
+        AccumulateLoudness(data, frameCount);
+    }
+}
+
+void AudioLevelMeter::Accumulate(const uint8_t *data, size_t frameCount)
+{
+    size_t sampleCount = frameCount * channelCount_;
+    std::array<float, MAX_CHANNEL_NUM> peak {};
+    std::array<double, MAX_CHANNEL_NUM> sumSquares {};
+    size_t index = 0;
+#ifdef AUDIO_LEVEL_METER_SIMD
+    if (LANE_NUM % channelCount_ == 0) {
+        if (format_ == Plugins::AudioSampleFormat::SAMPLE_S16LE) {
+            index = AccumulateLanes<int16_t>(data, sampleCount, channelCount_, peak.data(), sumSquares.data());
+        } else if (format_ == Plugins::AudioSampleFormat::SAMPLE_S32LE) {
+            index = AccumulateLanes<int32_t>(data, sampleCount, channelCount_, peak.data(), sumSquares.data());
+        } else if (format_ == Plugins::AudioSampleFormat::SAMPLE_F32LE) {
+            index = AccumulateLanes<float>(data, sampleCount, channelCount_, peak.data(), sumSquares.data());
+        }
+    }
+#endif
+    // the vector path stops on a frame boundary, so the tail starts at channel 0
+    for (uint32_t channel = 0; index < sampleCount; ++index) {
+        float value = ReadSample(data, index);
+        peak[channel] = std::max(peak[channel], std::fabs(value));
+        sumSquares[channel] += static_cast<double>(value) * value;
+        channel = (channel + 1 == channelCount_) ? 0 : channel + 1;
+    }
+
+    double squareScale = static_cast<double>(scale_) * scale_;
+    for (uint32_t channel = 0; channel < channelCount_; ++channel) {
+        float channelPeak = peak[channel] * scale_;
+        peak_[channel] = std::max(peak_[channel], channelPeak);
+        maxAmplitudePeak_ = std::max(maxAmplitudePeak_, channelPeak);
+        sumSquares_[channel] += sumSquares[channel] * squareScale;
+    }
+    frameCount_ += frameCount;
+}
+
+void AudioLevelMeter::AccumulateLoudness(const uint8_t *data, size_t frameCount)
+{
+    size_t index = 0;
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        for (uint32_t channel = 0; channel < channelCount_; ++channel, ++index) {
+            // direct form II transposed, the shelf output feeds the high pass
+            double x = static_cast<double>(ReadSample(data, index)) * scale_;
+            BiquadState &shelfState = shelfState_[channel];
+            double y = shelf_.b0 * x + shelfState.z1;
+            shelfState.z1 = shelf_.b1 * x - shelf_.a1 * y + shelfState.z2;
+            shelfState.z2 = shelf_.b2 * x - shelf_.a2 * y;
+            BiquadState &highPassState = highPassState_[channel];
+            double z = highPass_.b0 * y + highPassState.z1;
+            highPassState.z1 = highPass_.b1 * y - highPass_.a1 * z + highPassState.z2;
+            highPassState.z2 = highPass_.b2 * y - highPass_.a2 * z;
+            blockEnergy_[channel] += z * z;
+        }
+        if (++blockFrameCount_ < blockFrames_) {
+            continue;
+        }
+        double power = 0.0;
+        for (uint32_t channel = 0; channel < channelCount_; ++channel) {
+            power += channelWeight_[channel] * blockEnergy_[channel] / blockFrames_;
+            blockEnergy_[channel] = 0.0;
+        }
+        blockPower_[blockNum_ % MOMENTARY_BLOCK_NUM] = power;
+        ++blockNum_;
+        blockFrameCount_ = 0;
+        if (blockNum_ >= MOMENTARY_BLOCK_NUM) {
+            double mean = 0.0;
+            for (double blockPower : blockPower_) {
+                mean += blockPower / MOMENTARY_BLOCK_NUM;
+            }
+            momentaryLoudness_ = mean > 0.0 ?
+                std::max(static_cast<float>(LOUDNESS_OFFSET + DB_FACTOR * std::log10(mean)), SILENCE_LOUDNESS) :
+                SILENCE_LOUDNESS;
+        }
+    }
+}
+
+float AudioLevelMeter::ReadSample(const uint8_t *data, size_t index) const
+{
+    switch (format_) {
+        case Plugins::AudioSampleFormat::SAMPLE_U8:
+            return static_cast<float>(static_cast<int32_t>(data[index]) - U8_ZERO);
+        case Plugins::AudioSampleFormat::SAMPLE_S16LE:
+            return static_cast<float>(reinterpret_cast<const int16_t *>(data)[index]);
+        case Plugins::AudioSampleFormat::SAMPLE_S24LE: {
+            const uint8_t *sample = data + index * S24_BYTES;
+            // 8, 16, 24: assemble the little endian bytes at the top of an int32, then shift back with sign
+            int32_t value = static_cast<int32_t>((static_cast<uint32_t>(sample[0]) << 8) | // 0: low byte
+                (static_cast<uint32_t>(sample[1]) << 16) | (static_cast<uint32_t>(sample[2]) << 24)) >> 8;
+            return static_cast<float>(value);
+        }
+        case Plugins::AudioSampleFormat::SAMPLE_S32LE:
+            return static_cast<float>(reinterpret_cast<const int32_t *>(data)[index]);
+        case Plugins::AudioSampleFormat::SAMPLE_F32LE:
+            return reinterpret_cast<const float *>(data)[index];
+        default:
+            return 0.0f;
+    }
+}
+
+int32_t AudioLevelMeter::GetMaxAmplitude()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    float peak = std::min(maxAmplitudePeak_ * S16_SCALE, S16_MAX_AMPLITUDE);
+    maxAmplitudePeak_ = 0.0f;
+    return static_cast<int32_t>(peak);
+}
+
+void AudioLevelMeter::GetLevels(AudioLevels &levels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    levels.channels.assign(channelCount_, AudioChannelLevel());
+    for (uint32_t channel = 0; channel < channelCount_; ++channel) {
+        levels.channels[channel].peak = peak_[channel];
+        levels.channels[channel].rms = frameCount_ > 0 ?
+            static_cast<float>(std::sqrt(sumSquares_[channel] / frameCount_)) : 0.0f;
+    }
+    levels.momentaryLoudness = momentaryLoudness_;
+    peak_.fill(0.0f);
+    sumSquares_.fill(0.0);
+    frameCount_ = 0;
+}
+
+void AudioLevelMeter::Reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    peak_.fill(0.0f);
+    sumSquares_.fill(0.0);
+    frameCount_ = 0;
+    maxAmplitudePeak_ = 0.0f;
+    ResetLoudness();
+}
+
+void AudioLevelMeter::ResetLoudness()
+{
+    shelfState_.fill(BiquadState());
+    highPassState_.fill(BiquadState());
+    blockEnergy_.fill(0.0);
+    blockPower_.fill(0.0);
+    blockFrameCount_ = 0;
+    blockNum_ = 0;
+    momentaryLoudness_ = SILENCE_LOUDNESS;
+}
+} // namespace AudioCaptureModule
+} // namespace Media
+} // namespace OHOS
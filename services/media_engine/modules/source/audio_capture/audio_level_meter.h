@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_AUDIO_LEVEL_METER_H
+#define HISTREAMER_AUDIO_LEVEL_METER_H
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "common/status.h"
+#include "meta/audio_types.h"
+
+namespace OHOS {
+namespace Media {
+namespace AudioCaptureModule {
+struct AudioChannelLevel {
+    float peak {0.0f}; // absolute peak, 1.0 is full scale
+    float rms {0.0f};
+};
+
+struct AudioLevels {
+    std::vector<AudioChannelLevel> channels;
+    float momentaryLoudness {0.0f}; // EBU R128 momentary loudness in LUFS
+};
+
+/**
+ * Peak, RMS and loudness metering of interleaved PCM blocks.
+ *
+ * Process reads the captured block in place. Peak and sum of squares run through NEON or SSE2 kernels for s16, s32
+ * and f32 when the channel count divides the vector width, other layouts and formats take the scalar path. The
+ * K-weighted momentary loudness over the last 400 ms is only computed once enabled. Results accumulate until they
+ * are read, GetMaxAmplitude and GetLevels keep separate accumulators so both can be polled.
+ */
+class AudioLevelMeter {
+public:
+    static constexpr uint32_t MAX_CHANNEL_NUM = 16;
+    static constexpr float SILENCE_LOUDNESS = -70.0f; // EBU R128 absolute gate
+
+    Status Configure(Plugins::AudioSampleFormat format, uint32_t channelCount, uint32_t sampleRate);
+    void EnableLoudness(bool enable);
+    void Process(const uint8_t *data, size_t size);
+    // Peak since the last call in s16 scale, the way GetMaxAmplitude of the recorder reports it
+    int32_t GetMaxAmplitude();
+    // Per channel levels since the last call and the current momentary loudness
+    void GetLevels(AudioLevels &levels);
+    void Reset();
+
+private:
+    struct Biquad {
+        double b0 {1.0};
+        double b1 {0.0};
+        double b2 {0.0};
+        double a1 {0.0};
+        double a2 {0.0};
+    };
+    struct BiquadState {
+        double z1 {0.0};
+        double z2 {0.0};
+    };
+    static constexpr uint32_t MOMENTARY_BLOCK_NUM = 4; // 400 ms window of 100 ms blocks
+
+    void ConfigureLoudness();
+    void Accumulate(const uint8_t *data, size_t frameCount);
+    void AccumulateLoudness(const uint8_t *data, size_t frameCount);
+    float ReadSample(const uint8_t *data, size_t index) const;
+    void ResetLoudness();
+
+    std::mutex mutex_;
+    Plugins::AudioSampleFormat format_ {Plugins::AudioSampleFormat::INVALID_WIDTH};
+    uint32_t channelCount_ {0};
+    uint32_t sampleRate_ {0};
+    uint32_t bytesPerSample_ {0};
+    float scale_ {1.0f};
+    bool loudnessEnabled_ {false};
+
+    float maxAmplitudePeak_ {0.0f};
+    std::array<float, MAX_CHANNEL_NUM> peak_ {};
+    std::array<double, MAX_CHANNEL_NUM> sumSquares_ {};
+    uint64_t frameCount_ {0};
+
+    Biquad shelf_;
+    Biquad highPass_;
+    std::array<BiquadState, MAX_CHANNEL_NUM> shelfState_ {};
+    std::array<BiquadState, MAX_CHANNEL_NUM> highPassState_ {};
+    std::array<double, MAX_CHANNEL_NUM> channelWeight_ {};
+    std::array<double, MAX_CHANNEL_NUM> blockEnergy_ {};
+    std::array<double, MOMENTARY_BLOCK_NUM> blockPower_ {};
+    uint32_t blockFrames_ {0};
+    uint32_t blockFrameCount_ {0};
+    uint32_t blockNum_ {0};
+    float momentaryLoudness_ {SILENCE_LOUDNESS};
+};
+} // namespace AudioCaptureModule
+} // namespace Media
+} // namespace OHOS
+#endif // HISTREAMER_AUDIO_LEVEL_METER_H
@@ -73,6 +73,17 @@ bool ModuleFmt2SampleFmt(Plugins::AudioSampleFormat pFmt, OHOS::AudioStandard::A
     return false;
 }
 
+bool SampleFmt2ModuleFmt(OHOS::AudioStandard::AudioSampleFormat aFmt, Plugins::AudioSampleFormat &pFmt)
+{
+    for (const auto& item : g_aduFmtMap) {
+        if (item.first == aFmt) {
+            pFmt = item.second;
+            return true;
+        }
+    }
+    return false;
+}
+
 bool ChannelNumNum2Enum(int32_t numVal, OHOS::AudioStandard::AudioChannel &enumVal)
 {
     for (const auto& item : g_auChannelsMap) {
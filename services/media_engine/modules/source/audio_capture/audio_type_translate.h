@@ -26,6 +26,7 @@ namespace Media {
 namespace AudioCaptureModule {
 bool SampleRateNum2Enum(int32_t numVal, OHOS::AudioStandard::AudioSamplingRate &enumVal);
 bool ModuleFmt2SampleFmt(Plugins::AudioSampleFormat pFmt, OHOS::AudioStandard::AudioSampleFormat &aFmt);
+bool SampleFmt2ModuleFmt(OHOS::AudioStandard::AudioSampleFormat aFmt, Plugins::AudioSampleFormat &pFmt);
 bool ChannelNumNum2Enum(int32_t numVal, OHOS::AudioStandard::AudioChannel &enumVal);
 Status Error2Status(int32_t err);
 } // namespace AudioCaptureModule
@@ -55,6 +55,7 @@ Source::Source()
 Source::~Source()
 {
     MEDIA_LOG_D("~Source called");
+    ResetReadQueue();
     if (plugin_) {
         plugin_->Deinit();
     }
@@ -76,6 +77,7 @@ void Source::ClearData()
     isPluginReady_ = false;
     isAboveWaterline_ = false;
     seekToTimeFlag_ = false;
+    readPosition_ = 0;
 }
 
 Status Source::SetSource(const std::shared_ptr<MediaSource>& source)
@@ -84,6 +86,7 @@ Status Source::SetSource(const std::shared_ptr<MediaSource>& source)
     MEDIA_LOG_I("SetSource enter.");
     FALSE_RETURN_V_MSG_E(source != nullptr, Status::ERROR_INVALID_PARAMETER, "SetSource Invalid source");
 
+    ResetReadQueue();
     ClearData();
     Status ret = FindPlugin(source);
     FALSE_RETURN_V_MSG_E(ret == Status::OK, ret, "SetSource FindPlugin failed");
@@ -95,6 +98,11 @@ Status Source::SetSource(const std::shared_ptr<MediaSource>& source)
         seekToTimeFlag_ = plugin_->IsSeekToTimeSupported();
     }
     MEDIA_LOG_I("SetSource seekToTimeFlag_: " PUBLIC_LOG_D32, seekToTimeFlag_);
+    // reads of a seek to time source address its current segment rather than an offset, so they are not merged
+    readQueue_ = std::make_unique<SourceReadQueue>(
+        [this](int32_t streamID, uint64_t offset, size_t expectedLen, std::shared_ptr<Buffer>& buffer) {
+            return ReadFromPlugin(streamID, offset, expectedLen, buffer);
+        }, seekToTimeFlag_ ? 0 : SourceReadQueue::DEFAULT_MAX_MERGE_SIZE);
 
     MEDIA_LOG_I("SetSource exit.");
     return Status::OK;
@@ -107,6 +115,14 @@ void Source::SetBundleName(const std::string& bundleName)
     }
 }
 
+void Source::SetMemoryBudget(uint64_t budgetId)
+{
+    memoryBudgetId_ = budgetId;
+    if (plugin_ != nullptr) {
+        plugin_->SetMemoryBudget(budgetId);
+    }
+}
+
 void Source::SetDemuxerState(int32_t streamId)
 {
     plugin_->SetDemuxerState(streamId);
@@ -122,6 +138,9 @@ Status Source::InitPlugin(const std::shared_ptr<MediaSource>& source)
     FALSE_RETURN_V_MSG_E(ret == Status::OK, ret, "InitPlugin failed");
 
     plugin_->SetCallback(this);
+    if (memoryBudgetId_ != 0) {
+        plugin_->SetMemoryBudget(memoryBudgetId_);
+    }
     ret = plugin_->SetSource(source);
 
     MEDIA_LOG_I("InitPlugin exit");
@@ -193,6 +212,7 @@ Status Source::SeekToTime(int64_t seekTime, SeekMode mode)
     if (seekable_ != Seekable::SEEKABLE) {
         GetSeekable();
     }
+    CancelRead();
     int64_t timeNs;
     if (Plugins::Ms2HstTime(seekTime, timeNs)) {
         return plugin_->SeekToTime(timeNs, mode);
@@ -230,9 +250,15 @@ bool Source::IsNeedPreDownload()
     return plugin_->IsNeedPreDownload();
 }
 
+bool Source::IsLocalFile() const
+{
+    return protocol_ == "file" || protocol_ == "fd";
+}
+
 Status Source::Stop()
 {
     MEDIA_LOG_I("Stop entered.");
+    CancelRead();
     seekable_ = Seekable::INVALID;
     protocol_.clear();
     uri_.clear();
@@ -323,24 +349,28 @@ void Source::SetInterruptState(bool isInterruptNeeded)
     if (plugin_) {
         plugin_->SetInterruptState(isInterruptNeeded_);
     }
+    if (isInterruptNeeded) {
+        CancelRead();
+    }
 }
 
 Plugins::Seekable Source::GetSeekable()
 {
     FALSE_RETURN_V_MSG_E(plugin_ != nullptr, Plugins::Seekable::INVALID, "GetSeekable, Source plugin is nullptr");
     int32_t retry {0};
-    seekable_ = Seekable::INVALID;
+    Plugins::Seekable seekable = Seekable::INVALID;
     do {
-        seekable_ = plugin_->GetSeekable();
+        seekable = plugin_->GetSeekable();
         retry++;
-        if (seekable_ == Seekable::INVALID) {
+        if (seekable == Seekable::INVALID) {
             if (retry >= 20) { // 20 means retry times
                 break;
             }
             OSAL::SleepFor(10); // 10 means sleep time pre retry
         }
-    } while (seekable_ == Seekable::INVALID);
-    return seekable_;
+    } while (seekable == Seekable::INVALID);
+    seekable_ = seekable;
+    return seekable;
 }
 
 std::string Source::GetUriSuffix(const std::string& uri)
@@ -354,18 +384,59 @@ std::string Source::GetUriSuffix(const std::string& uri)
     return suffix;
 }
 
-Status Source::Read(int32_t streamID, std::shared_ptr<Buffer>& buffer, uint64_t offset, size_t expectedLen)
+Status Source::Read(int32_t streamID, std::shared_ptr<Buffer>& buffer, uint64_t offset, size_t expectedLen,
+    ReadPriority priority)
 {
     FALSE_RETURN_V_MSG_E(plugin_ != nullptr, Status::ERROR_INVALID_OPERATION, "ReadData, Source plugin is nullptr");
+    if (readQueue_ == nullptr) {
+        return ReadFromPlugin(streamID, offset, expectedLen, buffer);
+    }
+    return readQueue_->Read(streamID, offset, expectedLen, buffer, priority);
+}
+
+void Source::ResetReadQueue()
+{
+    FALSE_RETURN(readQueue_ != nullptr);
+    // a read blocked in the plugin would keep the queue from stopping, SetSource gives the next plugin a fresh state
+    if (plugin_ != nullptr) {
+        plugin_->SetInterruptState(true);
+    }
+    readQueue_.reset();
+}
+
+void Source::CancelRead()
+{
+    if (readQueue_ != nullptr) {
+        readQueue_->Cancel();
+    }
+}
+
+Status Source::ReadFromPlugin(int32_t streamID, uint64_t offset, size_t expectedLen, std::shared_ptr<Buffer>& buffer)
+{
     if (seekToTimeFlag_) {
         return plugin_->Read(streamID, buffer, offset, expectedLen);
     }
-    return plugin_->Read(buffer, offset, expectedLen);
+    // the plugins read from their own position, so the seek is issued right before the read it belongs to
+    if (seekable_ != Seekable::UNSEEKABLE && readPosition_ != offset) {
+        Status ret = plugin_->SeekTo(offset);
+        FALSE_RETURN_V_MSG_E(ret == Status::OK, ret, "Seek to " PUBLIC_LOG_U64 " fail", offset);
+        readPosition_ = offset;
+    }
+    Status ret = plugin_->Read(buffer, offset, expectedLen);
+    if (ret == Status::OK && buffer != nullptr && buffer->GetMemory() != nullptr) {
+        readPosition_ += buffer->GetMemory()->GetSize();
+    }
+    return ret;
 }
+
 Status Source::SeekTo(uint64_t offset)
 {
     FALSE_RETURN_V_MSG_E(plugin_ != nullptr, Status::ERROR_INVALID_OPERATION, "SeekTo, Source plugin is nullptr");
-    return plugin_->SeekTo(offset);
+    Status ret = plugin_->SeekTo(offset);
+    if (ret == Status::OK) {
+        readPosition_ = offset;
+    }
+    return ret;
 }
 
 Status Source::GetStreamInfo(std::vector<StreamInfo>& streams)
@@ -29,6 +29,7 @@
 #include "plugin/source_plugin.h"
 #include "meta/media_types.h"
 #include "media_demuxer.h"
+#include "source_read_queue.h"
 
 namespace OHOS {
 namespace Media {
@@ -68,6 +69,7 @@ public:
 
     virtual Status SetSource(const std::shared_ptr<MediaSource>& source);
     void SetBundleName(const std::string& bundleName);
+    void SetMemoryBudget(uint64_t budgetId);
     Status Prepare();
     Status Start();
     Status Stop();
@@ -91,9 +93,14 @@ public:
     Status SetCurrentBitRate(int32_t bitRate, int32_t streamID);
     void SetCallback(Callback* callback);
     bool IsNeedPreDownload();
+    // a file path or fd, read without any network round trip
+    bool IsLocalFile() const;
     void SetDemuxerState(int32_t streamId);
     Status GetStreamInfo(std::vector<StreamInfo>& streams);
-    Status Read(int32_t streamID, std::shared_ptr<Buffer>& buffer, uint64_t offset, size_t expectedLen);
+    Status Read(int32_t streamID, std::shared_ptr<Buffer>& buffer, uint64_t offset, size_t expectedLen,
+        ReadPriority priority = ReadPriority::PLAYBACK);
+    // drops the queued reads, their callers get ERROR_AGAIN and read again if they still need the data
+    void CancelRead();
     void SetInterruptState(bool isInterruptNeeded);
     Status GetDownloadInfo(DownloadInfo& downloadInfo);
     Status GetPlaybackInfo(PlaybackInfo& playbackInfo);
@@ -106,11 +113,14 @@ private:
     Status FindPlugin(const std::shared_ptr<MediaSource>& source);
 
     void ClearData();
+    Status ReadFromPlugin(int32_t streamID, uint64_t offset, size_t expectedLen, std::shared_ptr<Buffer>& buffer);
+    void ResetReadQueue();
 
     std::string protocol_;
     bool seekToTimeFlag_{false};
     std::string uri_;
-    Plugins::Seekable seekable_;
+    std::atomic<Plugins::Seekable> seekable_;
+    uint64_t memoryBudgetId_ {0};
 
     std::shared_ptr<Plugins::SourcePlugin> plugin_;
 
@@ -120,6 +130,8 @@ private:
 
     std::shared_ptr<CallbackImpl> mediaDemuxerCallback_;
     std::atomic<bool> isInterruptNeeded_{false};
+    std::unique_ptr<SourceReadQueue> readQueue_;
+    std::atomic<uint64_t> readPosition_ {0};
 };
 } // namespace Media
 } // namespace OHOS
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define HST_LOG_TAG "SourceReadQueue"
+
+#include "source_read_queue.h"
+#include <algorithm>
+#include <pthread.h>
+#include "common/log.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_DOMAIN_SYSTEM_PLAYER, "SourceReadQueue" };
+}
+
+namespace OHOS {
+namespace Media {
+SourceReadQueue::SourceReadQueue(ReadFunc readFunc, size_t maxMergeSize)
+    : readFunc_(std::move(readFunc)), maxMergeSize_(maxMergeSize)
+{
+    thread_ = std::thread(&SourceReadQueue::ReadLoop, this);
+}
+
+SourceReadQueue::~SourceReadQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isStopped_ = true;
+        cond_.notify_all();
+    }
+    // the read in flight finishes first, the requests a short read left over are queued again by then
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    RequestList requests;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests = TakePending();
+    }
+    for (auto &request : requests) {
+        request->ret = Status::ERROR_WRONG_STATE;
+    }
+    Complete(requests);
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return waiterCount_ == 0; });
+}
+
+Status SourceReadQueue::Read(int32_t streamID, uint64_t offset, size_t size, std::shared_ptr<Plugins::Buffer> &buffer,
+    ReadPriority priority)
+{
+    auto request = std::make_shared<Request>();
+    request->streamID = streamID;
+    request->offset = offset;
+    request->size = size;
+    request->buffer = buffer;
+    request->priority = priority;
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiterCount_++;
+    lock.unlock();
+    Enqueue(request);
+    lock.lock();
+    cond_.wait(lock, [&request] { return request->isDone; });
+    buffer = request->buffer;
+    waiterCount_--;
+    if (isStopped_) {
+        cond_.notify_all();
+    }
+    return request->ret;
+}
+
+void SourceReadQueue::ReadAsync(int32_t streamID, uint64_t offset, size_t size,
+    std::shared_ptr<Plugins::Buffer> buffer, ReadPriority priority, DoneCallback done)
+{
+    auto request = std::make_shared<Request>();
+    request->streamID = streamID;
+    request->offset = offset;
+    request->size = size;
+    request->buffer = std::move(buffer);
+    request->done = std::move(done);
+    request->priority = priority;
+    Enqueue(request);
+}
+
+void SourceReadQueue::Cancel()
+{
+    RequestList requests;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests = TakePending();
+    }
+    FALSE_RETURN(!requests.empty());
+    MEDIA_LOG_D("cancel " PUBLIC_LOG_ZU " queued reads", requests.size());
+    for (auto &request : requests) {
+        request->ret = Status::ERROR_AGAIN;
+    }
+    Complete(requests);
+}
+
+void SourceReadQueue::Enqueue(const std::shared_ptr<Request> &request)
+{
+    size_t index = std::min(static_cast<size_t>(request->priority), pending_.size() - 1);
+    request->priority = static_cast<ReadPriority>(index);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!isStopped_) {
+            pending_[index].push_back(request);
+            cond_.notify_all();
+            return;
+        }
+    }
+    request->ret = Status::ERROR_WRONG_STATE;
+    RequestList requests { request };
+    Complete(requests);
+}
+
+SourceReadQueue::RequestList SourceReadQueue::TakePending()
+{
+    RequestList requests;
+    for (auto &queue : pending_) {
+        requests.insert(requests.end(), queue.begin(), queue.end());
+        queue.clear();
+    }
+    return requests;
+}
+
+SourceReadQueue::RequestList SourceReadQueue::TakeRequests()
+{
+    RequestList requests;
+    for (auto &queue : pending_) {
+        if (!queue.empty()) {
+            requests.push_back(queue.front());
+            queue.pop_front();
+            break;
+        }
+    }
+    if (requests.empty() || maxMergeSize_ == 0) {
+        return requests;
+    }
+    int32_t streamID = requests.front()->streamID;
+    uint64_t end = requests.front()->offset + requests.front()->size;
+    bool isMerged = true;
+    while (isMerged) {
+        isMerged = false;
+        for (auto &queue : pending_) {
+            auto iter = std::find_if(queue.begin(), queue.end(), [streamID, end](const auto &request) {
+                return request->streamID == streamID && request->offset == end;
+            });
+            if (iter != queue.end() && end + (*iter)->size - requests.front()->offset <= maxMergeSize_) {
+                end += (*iter)->size;
+                requests.push_back(*iter);
+                queue.erase(iter);
+                isMerged = true;
+                break;
+            }
+        }
+    }
+    return requests;
+}
+
+void SourceReadQueue::ReadLoop()
+{
+    pthread_setname_np(pthread_self(), "OS_SOURCE_IO");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cond_.wait(lock, [this] {
+            return isStopped_ || std::any_of(pending_.begin(), pending_.end(),
+                [](const auto &queue) { return !queue.empty(); });
+        });
+        if (isStopped_) {
+            break;
+        }
+        RequestList requests = TakeRequests();
+        lock.unlock();
+        RequestList unserved = Serve(requests);
+        Complete(requests);
+        lock.lock();
+        for (auto iter = unserved.rbegin(); iter != unserved.rend(); ++iter) {
+            pending_[static_cast<size_t>((*iter)->priority)].push_front(*iter);
+        }
+    }
+}
+
+SourceReadQueue::RequestList SourceReadQueue::Serve(RequestList &requests)
+{
+    RequestList unserved;
+    auto first = requests.front();
+    if (requests.size() == 1) {
+        first->ret = readFunc_(first->streamID, first->offset, first->size, first->buffer);
+        return unserved;
+    }
+    size_t total = requests.back()->offset + requests.back()->size - first->offset;
+    MEDIA_LOG_D("merge " PUBLIC_LOG_ZU " reads into " PUBLIC_LOG_ZU " bytes at " PUBLIC_LOG_U64,
+        requests.size(), total, first->offset);
+    std::shared_ptr<Plugins::Buffer> merged = Plugins::Buffer::CreateDefaultBuffer(total);
+    Status ret = readFunc_(first->streamID, first->offset, total, merged);
+    auto memory = merged != nullptr ? merged->GetMemory() : nullptr;
+    size_t readSize = (ret == Status::OK && memory != nullptr) ? memory->GetSize() : 0;
+    for (auto iter = requests.begin(); iter != requests.end();) {
+        auto &request = *iter;
+        size_t begin = request->offset - first->offset;
+        size_t size = readSize > begin ? std::min(request->size, readSize - begin) : 0;
+        request->ret = size > 0 ? Status::OK : ret;
+        if (size == 0 && readSize > 0) {
+            // past the end of a short read, a read of its own tells whether there is more data
+            unserved.push_back(request);
+            iter = requests.erase(iter);
+            continue;
+        }
+        ++iter;
+        if (size == 0) {
+            continue;
+        }
+        if (request->buffer == nullptr) {
+            request->buffer = std::make_shared<Plugins::Buffer>();
+        }
+        auto dest = request->buffer->IsEmpty() ? request->buffer->AllocMemory(nullptr, request->size) :
+            request->buffer->GetMemory();
+        if (dest == nullptr) {
+            request->ret = Status::ERROR_NO_MEMORY;
+            continue;
+        }
+        dest->Write(memory->GetReadOnlyData() + begin, size, 0);
+    }
+    return unserved;
+}
+
+void SourceReadQueue::Complete(RequestList &requests)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &request : requests) {
+            request->isDone = true;
+        }
+        cond_.notify_all();
+    }
+    for (auto &request : requests) {
+        if (request->done) {
+            request->done(request->ret, request->buffer);
+        }
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEDIA_SOURCE_READ_QUEUE_H
+#define MEDIA_SOURCE_READ_QUEUE_H
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/status.h"
+#include "plugin/plugin_buffer.h"
+
+namespace OHOS {
+namespace Media {
+enum class ReadPriority : int32_t {
+    PLAYBACK = 0, // a sample the renderer is waiting on
+    METADATA,     // header probing and index parsing
+    PREFETCH,     // data nobody is waiting on yet
+    COUNT,
+};
+
+/**
+ * Runs the reads of a source plugin on a worker thread, most urgent first.
+ *
+ * Requests are served by priority and in arrival order within a priority. Before a read is issued, queued requests
+ * of the same stream that continue its range are merged into it up to maxMergeSize bytes, the data is then split
+ * back into the buffers of the requests, those a short read left empty are queued again. Cancel completes every
+ * queued request with ERROR_AGAIN and no data, the read in flight still finishes. Read blocks until its request
+ * completed, ReadAsync reports through a callback invoked without any lock held. The destructor waits for the read
+ * in flight, completes every other request with ERROR_WRONG_STATE and returns once no Read is blocked any more.
+ */
+class SourceReadQueue {
+public:
+    static constexpr size_t DEFAULT_MAX_MERGE_SIZE = 1024 * 1024;
+
+    using ReadFunc = std::function<Status(int32_t streamID, uint64_t offset, size_t size,
+        std::shared_ptr<Plugins::Buffer> &buffer)>;
+    using DoneCallback = std::function<void(Status ret, std::shared_ptr<Plugins::Buffer> &buffer)>;
+
+    // maxMergeSize 0 disables merging, for sources whose reads are not addressed by offset
+    explicit SourceReadQueue(ReadFunc readFunc, size_t maxMergeSize = DEFAULT_MAX_MERGE_SIZE);
+    SourceReadQueue(const SourceReadQueue &other) = delete;
+    SourceReadQueue& operator=(const SourceReadQueue&) = delete;
+    virtual ~SourceReadQueue();
+
+    Status Read(int32_t streamID, uint64_t offset, size_t size, std::shared_ptr<Plugins::Buffer> &buffer,
+        ReadPriority priority = ReadPriority::PLAYBACK);
+    void ReadAsync(int32_t streamID, uint64_t offset, size_t size, std::shared_ptr<Plugins::Buffer> buffer,
+        ReadPriority priority, DoneCallback done);
+    void Cancel();
+
+private:
+    struct Request {
+        int32_t streamID {0};
+        uint64_t offset {0};
+        size_t size {0};
+        std::shared_ptr<Plugins::Buffer> buffer;
+        DoneCallback done;
+        ReadPriority priority {ReadPriority::PLAYBACK};
+        Status ret {Status::OK};
+        bool isDone {false};
+    };
+    using RequestList = std::vector<std::shared_ptr<Request>>;
+
+    void Enqueue(const std::shared_ptr<Request> &request);
+    RequestList TakeRequests();
+    RequestList TakePending();
+    void ReadLoop();
+    // returns the requests a short read left empty, they are not complete yet
+    RequestList Serve(RequestList &requests);
+    void Complete(RequestList &requests);
+
+    ReadFunc readFunc_;
+    const size_t maxMergeSize_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::array<std::deque<std::shared_ptr<Request>>, static_cast<size_t>(ReadPriority::COUNT)> pending_;
+    bool isStopped_ {false};
+    uint32_t waiterCount_ {0}; // callers blocked in Read
+    std::thread thread_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // MEDIA_SOURCE_READ_QUEUE_H
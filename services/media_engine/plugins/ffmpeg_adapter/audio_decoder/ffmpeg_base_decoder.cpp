@@ -17,12 +17,15 @@
 #include "avcodec_common.h"
 #include "ffmpeg_converter.h"
 #include "avcodec_audio_common.h"
+#include "media_description.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_AUDIO, "AvCodec-FfmpegBaseDecoder"};
 constexpr uint8_t LOGD_FREQUENCY = 5;
 constexpr float TIME_BASE_FFMPEG = 1000000.f;
 constexpr AVSampleFormat DEFAULT_FFMPEG_SAMPLE_FORMAT = AV_SAMPLE_FMT_S16;
+constexpr int64_t MS_TO_US = 1000;
+constexpr uintptr_t DIRECT_OUTPUT_ALIGN = 64; // what the default allocator gives, for the decoders' simd stores
 static std::vector<OHOS::MediaAVCodec::AudioSampleFormat> supportedSampleFormats = {
     OHOS::MediaAVCodec::AudioSampleFormat::SAMPLE_U8,
     OHOS::MediaAVCodec::AudioSampleFormat::SAMPLE_S16LE,
@@ -47,7 +50,13 @@ FfmpegBaseDecoder::FfmpegBaseDecoder()
       avPacket_(nullptr),
       format_(nullptr),
       needResample_(false),
-      destFmt_(AV_SAMPLE_FMT_NONE)
+      destFmt_(AV_SAMPLE_FMT_NONE),
+      pendingBuffer_(nullptr),
+      pendingDurationUs_(0),
+      maxOutputDurationUs_(0),
+      lastFrameSize_(0),
+      frameHeld_(false),
+      directFrames_(0)
 {
 }
 
@@ -55,6 +64,7 @@ FfmpegBaseDecoder::~FfmpegBaseDecoder()
 {
     AVCODEC_LOGI("FfmpegBaseDecoder deconstructor running.");
     CloseCtxLocked();
+    pendingBuffer_ = nullptr;
 }
 
 Status FfmpegBaseDecoder::ProcessSendData(const std::shared_ptr<AVBuffer> &inputBuffer)
@@ -145,43 +155,124 @@ Status FfmpegBaseDecoder::ProcessReceiveData(std::shared_ptr<AVBuffer> &outBuffe
 
 Status FfmpegBaseDecoder::ReceiveBuffer(std::shared_ptr<AVBuffer> &outBuffer)
 {
-    auto ret = avcodec_receive_frame(avCodecContext_.get(), cachedFrame_.get());
-    Status status;
-    if (ret >= 0) {
-        AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "receive one frame");
-        if (cachedFrame_->pts == AV_NOPTS_VALUE) {
-            cachedFrame_->pts = nextPts_;
+    // the decoder keeps one output buffer across calls, a later outBuffer only takes over once that one is delivered
+    bool outBufferUsed = pendingBuffer_ == nullptr;
+    if (outBufferUsed) {
+        StartOutputBuffer(outBuffer);
+    }
+    auto deliver = [this, &outBuffer, &outBufferUsed]() {
+        DeliverOutputBuffer();
+        if (outBufferUsed) {
+            return false;
         }
-        status = ReceiveFrameSucc(outBuffer);
-        dataCallback_->OnOutputBufferDone(outBuffer);
-    } else if (ret == AVERROR_EOF) {
-        AVCODEC_LOGI("eos received");
-        outBuffer->flag_ = MediaAVCodec::AVCODEC_BUFFER_FLAG_EOS;
-        avcodec_flush_buffers(avCodecContext_.get());
-        status = Status::END_OF_STREAM;
-        dataCallback_->OnOutputBufferDone(outBuffer);
-    } else if (ret == AVERROR(EAGAIN)) {
-        AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "audio decoder not enough data");
-        status = Status::ERROR_NOT_ENOUGH_DATA;
-    } else {
-        AVCODEC_LOGE("audio decoder receive unknow error,ffmpeg error message:%{public}s", AVStrError(ret).data());
-        status = Status::ERROR_UNKNOWN;
+        outBufferUsed = true;
+        StartOutputBuffer(outBuffer);
+        return true;
+    };
+    while (true) {
+        int32_t ret = frameHeld_ ? 0 : avcodec_receive_frame(avCodecContext_.get(), cachedFrame_.get());
+        if (ret >= 0) {
+            AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "receive one frame");
+            if (!frameHeld_ && cachedFrame_->pts == AV_NOPTS_VALUE) {
+                cachedFrame_->pts = nextPts_;
+            }
+            frameHeld_ = false;
+            Status status = ReceiveFrameSucc();
+            if (status == Status::ERROR_AGAIN) {
+                // the frame starts the next output buffer
+                frameHeld_ = true;
+                if (!deliver()) {
+                    return Status::ERROR_AGAIN;
+                }
+                continue;
+            }
+            av_frame_unref(cachedFrame_.get());
+            if (status != Status::OK) {
+                return DropOutputBuffer(outBufferUsed, status);
+            }
+            if (IsOutputFull() && !deliver()) {
+                return Status::ERROR_AGAIN;
+            }
+        } else if (ret == AVERROR(EAGAIN)) {
+            AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "audio decoder not enough data");
+            // while packing an empty outBuffer is kept too, the next input decodes straight into it,
+            // one frame per buffer keeps none and hands it back to the caller
+            if (!outBufferUsed ||
+                (maxOutputDurationUs_ <= 0 && pendingBuffer_->memory_->GetSize() == 0 && directFrames_ == 0)) {
+                return DropOutputBuffer(outBufferUsed, Status::ERROR_NOT_ENOUGH_DATA);
+            }
+            return Status::OK;
+        } else if (ret == AVERROR_EOF) {
+            if (pendingBuffer_->memory_->GetSize() > 0 && !deliver()) {
+                return Status::ERROR_AGAIN;
+            }
+            AVCODEC_LOGI("eos received");
+            avcodec_flush_buffers(avCodecContext_.get());
+            if (!outBufferUsed) {
+                // the empty buffer kept for the next input carries the end of stream, outBuffer goes back
+                pendingBuffer_->flag_ = MediaAVCodec::AVCODEC_BUFFER_FLAG_EOS;
+                DeliverOutputBuffer();
+                return Status::ERROR_NOT_ENOUGH_DATA;
+            }
+            pendingBuffer_ = nullptr;
+            outBuffer->flag_ = MediaAVCodec::AVCODEC_BUFFER_FLAG_EOS;
+            dataCallback_->OnOutputBufferDone(outBuffer);
+            return Status::END_OF_STREAM;
+        } else {
+            AVCODEC_LOGE("audio decoder receive unknow error,ffmpeg error message:%{public}s", AVStrError(ret).data());
+            return DropOutputBuffer(outBufferUsed, Status::ERROR_UNKNOWN);
+        }
+    }
+}
+
+void FfmpegBaseDecoder::StartOutputBuffer(const std::shared_ptr<AVBuffer> &outBuffer)
+{
+    pendingBuffer_ = outBuffer;
+    pendingBuffer_->flag_ = MediaAVCodec::AVCODEC_BUFFER_FLAG_NONE;
+    pendingBuffer_->memory_->SetSize(0);
+    pendingDurationUs_ = 0;
+}
+
+void FfmpegBaseDecoder::DeliverOutputBuffer()
+{
+    AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "deliver output size:%{public}d, duration:%{public}" PRId64,
+                       pendingBuffer_->memory_->GetSize(), pendingDurationUs_);
+    std::shared_ptr<AVBuffer> outBuffer = std::move(pendingBuffer_);
+    pendingBuffer_ = nullptr;
+    dataCallback_->OnOutputBufferDone(outBuffer);
+}
+
+Status FfmpegBaseDecoder::DropOutputBuffer(bool outBufferUsed, Status status)
+{
+    // the caller takes outBuffer back on error, a buffer kept from an earlier call stays here
+    if (outBufferUsed) {
+        pendingBuffer_ = nullptr;
     }
-    av_frame_unref(cachedFrame_.get());
-    AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "end received");
     return status;
 }
 
-Status FfmpegBaseDecoder::ConvertPlanarFrame(std::shared_ptr<AVBuffer> &outBuffer)
+bool FfmpegBaseDecoder::IsOutputFull() const
 {
-    if (resample_.ConvertFrame(convertedFrame_.get(), cachedFrame_.get()) != Status::OK) {
+    if (maxOutputDurationUs_ <= 0 || pendingDurationUs_ >= maxOutputDurationUs_) {
+        return true;
+    }
+    auto memory = pendingBuffer_->memory_;
+    return memory->GetCapacity() - memory->GetSize() < lastFrameSize_;
+}
+
+Status FfmpegBaseDecoder::ConvertPlanarFrame(uint8_t *dest, int32_t capacity, int32_t &outputSize)
+{
+    size_t destLength = 0;
+    Status ret = resample_.ConvertFrame(cachedFrame_.get(), dest, static_cast<size_t>(capacity), destLength);
+    if (ret != Status::OK) {
         AVCODEC_LOGE("convert frame failed");
-        return Status::ERROR_UNKNOWN;
+        return ret == Status::ERROR_NO_MEMORY ? ret : Status::ERROR_UNKNOWN;
     }
+    outputSize = static_cast<int32_t>(destLength);
     return Status::OK;
 }
 
-Status FfmpegBaseDecoder::ReceiveFrameSucc(std::shared_ptr<AVBuffer> &outBuffer)
+Status FfmpegBaseDecoder::ReceiveFrameSucc()
 {
     if (isFirst) {
         isFirst = false;
@@ -206,30 +297,79 @@ Status FfmpegBaseDecoder::ReceiveFrameSucc(std::shared_ptr<AVBuffer> &outBuffer)
         int32_t sampleRate = avCodecContext_->sample_rate;
         durationTime_ = TIME_BASE_FFMPEG / sampleRate;
     }
-    nextPts_ = cachedFrame_->pts + static_cast<int64_t>(cachedFrame_->nb_samples * durationTime_);
-    auto outFrame = cachedFrame_;
-    if (needResample_) {
-        if (ConvertPlanarFrame(outBuffer) != Status::OK) {
-            return Status::ERROR_UNKNOWN;
-        }
-        outFrame = convertedFrame_;
-    }
-    auto ioInfoMem = outBuffer->memory_;
-    int32_t bytePerSample = av_get_bytes_per_sample(static_cast<AVSampleFormat>(outFrame->format));
-    int32_t outputSize = outFrame->nb_samples * bytePerSample * outFrame->channels;
+    auto ioInfoMem = pendingBuffer_->memory_;
+    int32_t offset = ioInfoMem->GetSize();
+    auto outFmt = needResample_ ? destFmt_ : static_cast<AVSampleFormat>(cachedFrame_->format);
+    int32_t outputSize = cachedFrame_->nb_samples * av_get_bytes_per_sample(outFmt) * cachedFrame_->channels;
     AVCODEC_LOGD_LIMIT(LOGD_FREQUENCY, "RecvFrameSucc buffer real size:%{public}u,size:%{public}u, name:%{public}s",
-                       outputSize, ioInfoMem->GetCapacity(), name_.data());
-    if (ioInfoMem->GetCapacity() < outputSize) {
+                       outputSize, ioInfoMem->GetCapacity() - offset, name_.data());
+    if (ioInfoMem->GetCapacity() - offset < outputSize) {
+        if (offset > 0) {
+            return Status::ERROR_AGAIN;
+        }
         AVCODEC_LOGE("output buffer size is not enough,output size:%{public}d", outputSize);
         return Status::ERROR_NO_MEMORY;
     }
-    ioInfoMem->Write(outFrame->data[0], outputSize, 0);
-    outBuffer->pts_ = cachedFrame_->pts;
-    ioInfoMem->SetSize(outputSize);
+    uint8_t *dest = ioInfoMem->GetAddr() + offset;
     if (needResample_) {
-        av_frame_unref(convertedFrame_.get());
+        // the converted samples go straight into the output buffer
+        Status ret = ConvertPlanarFrame(dest, ioInfoMem->GetCapacity() - offset, outputSize);
+        if (ret != Status::OK) {
+            return ret;
+        }
+    } else if (cachedFrame_->data[0] != dest) {
+        ioInfoMem->Write(cachedFrame_->data[0], outputSize, offset);
     }
-    return Status::ERROR_AGAIN;
+    if (offset == 0) {
+        pendingBuffer_->pts_ = cachedFrame_->pts;
+    }
+    ioInfoMem->SetSize(offset + outputSize);
+    nextPts_ = cachedFrame_->pts + static_cast<int64_t>(cachedFrame_->nb_samples * durationTime_);
+    pendingDurationUs_ += static_cast<int64_t>(cachedFrame_->nb_samples * durationTime_);
+    lastFrameSize_ = outputSize;
+    return Status::OK;
+}
+
+int FfmpegBaseDecoder::GetBuffer(AVCodecContext *context, AVFrame *frame, int flags)
+{
+    auto decoder = static_cast<FfmpegBaseDecoder *>(context->opaque);
+    if (decoder != nullptr && decoder->AttachOutputMemory(frame)) {
+        return 0;
+    }
+    return avcodec_default_get_buffer2(context, frame, flags);
+}
+
+void FfmpegBaseDecoder::ReleaseOutputMemory(void *opaque, uint8_t *data)
+{
+    (void)data;
+    static_cast<FfmpegBaseDecoder *>(opaque)->directFrames_--;
+}
+
+bool FfmpegBaseDecoder::AttachOutputMemory(AVFrame *frame)
+{
+    // only a frame that needs no conversion can be decoded in place, right behind the samples already written
+    auto format = static_cast<AVSampleFormat>(frame->format);
+    if (pendingBuffer_ == nullptr || frameHeld_ || directFrames_ > 0 || format != destFmt_ ||
+        av_sample_fmt_is_planar(format)) {
+        return false;
+    }
+    int32_t lineSize = 0;
+    int32_t size = av_samples_get_buffer_size(&lineSize, frame->ch_layout.nb_channels, frame->nb_samples, format, 0);
+    auto memory = pendingBuffer_->memory_;
+    uint8_t *dest = memory->GetAddr() + memory->GetSize();
+    if (size <= 0 || memory->GetCapacity() - memory->GetSize() < size ||
+        reinterpret_cast<uintptr_t>(dest) % DIRECT_OUTPUT_ALIGN != 0) {
+        return false;
+    }
+    frame->buf[0] = av_buffer_create(dest, size, ReleaseOutputMemory, this, 0);
+    if (frame->buf[0] == nullptr) {
+        return false;
+    }
+    frame->data[0] = dest;
+    frame->extended_data = frame->data;
+    frame->linesize[0] = lineSize;
+    directFrames_++;
+    return true;
 }
 
 Status FfmpegBaseDecoder::Reset()
@@ -237,6 +377,12 @@ Status FfmpegBaseDecoder::Reset()
     std::lock_guard<std::mutex> lock(avMutext_);
     CloseCtxLocked();
     nextPts_ = 0;
+    // the caller only regains a kept output buffer through the callback, it is handed back empty
+    if (pendingBuffer_ != nullptr) {
+        pendingBuffer_->memory_->SetSize(0);
+        DeliverOutputBuffer();
+    }
+    frameHeld_ = false;
     return Status::OK;
 }
 
@@ -244,6 +390,7 @@ Status FfmpegBaseDecoder::Release()
 {
     std::lock_guard<std::mutex> lock(avMutext_);
     auto ret = CloseCtxLocked();
+    pendingBuffer_ = nullptr;
     return ret;
 }
 
@@ -253,6 +400,14 @@ Status FfmpegBaseDecoder::Flush()
     if (avCodecContext_ != nullptr) {
         avcodec_flush_buffers(avCodecContext_.get());
     }
+    // the held output buffer stays for the samples after the seek, a frame decoded into it is already released
+    if (frameHeld_) {
+        av_frame_unref(cachedFrame_.get());
+        frameHeld_ = false;
+    }
+    if (pendingBuffer_ != nullptr) {
+        StartOutputBuffer(pendingBuffer_);
+    }
     nextPts_ = 0;
     return Status::OK;
 }
@@ -321,6 +476,12 @@ Status FfmpegBaseDecoder::InitContext(const std::shared_ptr<Meta> &format)
         AVCODEC_LOGW("channelLayout not set, unknow channelLayout");
     }
     format->GetData(Tag::AUDIO_MAX_INPUT_SIZE, maxInputSize_);
+    int32_t maxOutputDurationMs = 0;
+    if (format->GetData(std::string(MediaAVCodec::MediaDescriptionKey::MD_KEY_AUDIO_MAX_OUTPUT_DURATION),
+        maxOutputDurationMs) && maxOutputDurationMs > 0) {
+        AVCODEC_LOGI("pack output up to %{public}d ms", maxOutputDurationMs);
+        maxOutputDurationUs_ = maxOutputDurationMs * MS_TO_US;
+    }
 
     Status ret = SetCodecExtradata(format);
     if (ret != Status::OK) {
@@ -343,6 +504,11 @@ Status FfmpegBaseDecoder::OpenContext()
     avPacket_ = std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *ptr) { av_packet_free(&ptr); });
     {
         std::lock_guard<std::mutex> lock(avMutext_);
+        if (avCodec_->capabilities & AV_CODEC_CAP_DR1) {
+            // frames that need no conversion are decoded straight into the output buffer
+            avCodecContext_->opaque = this;
+            avCodecContext_->get_buffer2 = GetBuffer;
+        }
         auto res = avcodec_open2(avCodecContext_.get(), avCodec_.get(), nullptr);
         if (res != 0) {
             AVCODEC_LOGE("avcodec open error %{public}s", AVStrError(res).c_str());
@@ -375,11 +541,6 @@ Status FfmpegBaseDecoder::InitResample()
             AVCODEC_LOGE("Resmaple init failed.");
             return Status::ERROR_UNKNOWN;
         }
-        convertedFrame_ = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *fp) { av_frame_free(&fp); });
-        if (convertedFrame_ == nullptr) {
-            AVCODEC_LOGE("av_frame_alloc failed");
-            return Status::ERROR_NO_MEMORY;
-        }
         needResample_ = true;
     }
     return Status::OK;
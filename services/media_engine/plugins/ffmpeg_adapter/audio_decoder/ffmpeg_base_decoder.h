@@ -95,16 +95,31 @@ private:
     Ffmpeg::Resample resample_;
     bool needResample_;
     AVSampleFormat destFmt_;
-    std::shared_ptr<AVFrame> convertedFrame_;
     DataCallback *dataCallback_{nullptr};
     std::vector<uint8_t> config_data;
 
+    // output buffer being filled, it is kept across calls until it holds maxOutputDurationUs_ of samples
+    std::shared_ptr<AVBuffer> pendingBuffer_;
+    int64_t pendingDurationUs_;
+    int64_t maxOutputDurationUs_;
+    int32_t lastFrameSize_;
+    // cachedFrame_ did not fit into pendingBuffer_ and starts the next one
+    bool frameHeld_;
+    int32_t directFrames_;
+
 private:
     Status SendBuffer(const std::shared_ptr<AVBuffer> &inputBuffer);
     Status ReceiveBuffer(std::shared_ptr<AVBuffer> &outBuffer);
-    Status ReceiveFrameSucc(std::shared_ptr<AVBuffer> &outBuffer);
+    Status ReceiveFrameSucc();
+    void StartOutputBuffer(const std::shared_ptr<AVBuffer> &outBuffer);
+    void DeliverOutputBuffer();
+    Status DropOutputBuffer(bool outBufferUsed, Status status);
+    bool IsOutputFull() const;
     Status InitResample();
-    Status ConvertPlanarFrame(std::shared_ptr<AVBuffer> &outBuffer);
+    Status ConvertPlanarFrame(uint8_t *dest, int32_t capacity, int32_t &outputSize);
+    bool AttachOutputMemory(AVFrame *frame);
+    static int GetBuffer(AVCodecContext *context, AVFrame *frame, int flags);
+    static void ReleaseOutputMemory(void *opaque, uint8_t *data);
     void EnableResample(AVSampleFormat destFmt);
     Status SetCodecExtradata(const std::shared_ptr<Meta> &format);
 };
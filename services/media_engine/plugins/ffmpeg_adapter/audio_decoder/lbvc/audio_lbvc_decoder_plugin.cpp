@@ -83,12 +83,17 @@ AudioLbvcDecoderPlugin::AudioLbvcDecoderPlugin(const std::string &name)
 
 AudioLbvcDecoderPlugin::~AudioLbvcDecoderPlugin()
 {
+    // the HDI callback thread may still hold the codec
+    hdiCodec_->SetBufferDoneCallback(nullptr);
     hdiCodec_.reset();
     hdiCodec_ = nullptr;
 }
 
 Status AudioLbvcDecoderPlugin::Init()
 {
+    hdiCodec_->SetBufferDoneCallback([this](HdiCodec::PortIndex portIndex, const std::shared_ptr<AVBuffer> &buffer) {
+        OnBufferDone(portIndex, buffer);
+    });
     Status ret = hdiCodec_->InitComponent(LBVC_DECODER_COMPONENT_NAME);
     return ret;
 }
@@ -175,17 +180,16 @@ Status AudioLbvcDecoderPlugin::QueueInputBuffer(const std::shared_ptr<AVBuffer>
     if (inputBuffer->flag_ == BUFFER_FLAG_EOS) {
         AVCODEC_LOGI("QueueInputBuffer Eos!");
         eosFlag_ = true;
+        dataCallback_->OnInputBufferDone(inputBuffer);
         return Status::OK;
     }
 
+    // the buffer comes back through OnBufferDone once the component consumed it
     Status ret = hdiCodec_->EmptyThisBuffer(inputBuffer);
     if (ret != Status::OK) {
         AVCODEC_LOGE("EmptyThisBuffer failed!");
         return ret;
     }
-
-    dataCallback_->OnInputBufferDone(inputBuffer);
-    AVCODEC_LOGD("OnInputBufferDone");
     return Status::OK;
 }
 
@@ -193,6 +197,9 @@ Status AudioLbvcDecoderPlugin::QueueOutputBuffer(std::shared_ptr<AVBuffer> &outp
 {
     if (eosFlag_ == true) {
         AVCODEC_LOGI("QueueOutputBuffer Eos!");
+        if (hdiCodec_->WaitForInputDone() != Status::OK) {
+            AVCODEC_LOGW("input still pending at eos");
+        }
         outputBuffer->flag_ = BUFFER_FLAG_EOS;
         outputBuffer->memory_->SetSize(0);
         eosFlag_ = false;
@@ -205,22 +212,35 @@ Status AudioLbvcDecoderPlugin::QueueOutputBuffer(std::shared_ptr<AVBuffer> &outp
         AVCODEC_LOGE("FillThisBuffer failed!");
         return ret;
     }
-
-    dataCallback_->OnOutputBufferDone(outputBuffer);
-    AVCODEC_LOGD("OnOutputBufferDone");
     return Status::OK;
 }
 
 Status AudioLbvcDecoderPlugin::GetInputBuffers(std::vector<std::shared_ptr<AVBuffer>> &inputBuffers)
 {
+    hdiCodec_->GetInputBuffers(inputBuffers);
     return Status::OK;
 }
 
 Status AudioLbvcDecoderPlugin::GetOutputBuffers(std::vector<std::shared_ptr<AVBuffer>> &outputBuffers)
 {
+    hdiCodec_->GetOutputBuffers(outputBuffers);
     return Status::OK;
 }
 
+void AudioLbvcDecoderPlugin::OnBufferDone(HdiCodec::PortIndex portIndex, const std::shared_ptr<AVBuffer> &buffer)
+{
+    if (dataCallback_ == nullptr) {
+        return;
+    }
+    if (portIndex == HdiCodec::PortIndex::INPUT_PORT) {
+        dataCallback_->OnInputBufferDone(buffer);
+        AVCODEC_LOGD("OnInputBufferDone");
+    } else {
+        dataCallback_->OnOutputBufferDone(buffer);
+        AVCODEC_LOGD("OnOutputBufferDone");
+    }
+}
+
 Status AudioLbvcDecoderPlugin::Flush()
 {
     Status ret = hdiCodec_->SendCommand(CODEC_COMMAND_FLUSH, CODEC_STATE_EXECUTING);
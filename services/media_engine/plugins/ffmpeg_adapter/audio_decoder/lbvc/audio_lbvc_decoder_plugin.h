@@ -63,6 +63,7 @@ public:
 private:
     Status GetMetaData(const std::shared_ptr<Meta> &meta);
     bool CheckFormat();
+    void OnBufferDone(Hdi::HdiCodec::PortIndex portIndex, const std::shared_ptr<AVBuffer> &buffer);
 
 private:
     AudioSampleFormat audioSampleFormat_;
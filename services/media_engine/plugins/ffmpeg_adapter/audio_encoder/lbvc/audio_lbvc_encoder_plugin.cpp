@@ -85,12 +85,17 @@ AudioLbvcEncoderPlugin::AudioLbvcEncoderPlugin(const std::string &name)
 
 AudioLbvcEncoderPlugin::~AudioLbvcEncoderPlugin()
 {
+    // the HDI callback thread may still hold the codec
+    hdiCodec_->SetBufferDoneCallback(nullptr);
     hdiCodec_.reset();
     hdiCodec_ = nullptr;
 }
 
 Status AudioLbvcEncoderPlugin::Init()
 {
+    hdiCodec_->SetBufferDoneCallback([this](HdiCodec::PortIndex portIndex, const std::shared_ptr<AVBuffer> &buffer) {
+        OnBufferDone(portIndex, buffer);
+    });
     Status ret = hdiCodec_->InitComponent(LBVC_ENCODER_COMPONENT_NAME);
     return ret;
 }
@@ -178,17 +183,16 @@ Status AudioLbvcEncoderPlugin::QueueInputBuffer(const std::shared_ptr<AVBuffer>
     if (inputBuffer->flag_ == BUFFER_FLAG_EOS) {
         AVCODEC_LOGI("QueueInputBuffer Eos!");
         eosFlag_ = true;
+        dataCallback_->OnInputBufferDone(inputBuffer);
         return Status::OK;
     }
 
+    // the buffer comes back through OnBufferDone once the component consumed it
     Status ret = hdiCodec_->EmptyThisBuffer(inputBuffer);
     if (ret != Status::OK) {
         AVCODEC_LOGE("EmptyThisBuffer failed!");
         return ret;
     }
-
-    dataCallback_->OnInputBufferDone(inputBuffer);
-    AVCODEC_LOGD("OnInputBufferDone");
     return Status::OK;
 }
 
@@ -196,6 +200,9 @@ Status AudioLbvcEncoderPlugin::QueueOutputBuffer(std::shared_ptr<AVBuffer> &outp
 {
     if (eosFlag_ == true) {
         AVCODEC_LOGI("QueueOutputBuffer Eos!");
+        if (hdiCodec_->WaitForInputDone() != Status::OK) {
+            AVCODEC_LOGW("input still pending at eos");
+        }
         outputBuffer->flag_ = BUFFER_FLAG_EOS;
         outputBuffer->memory_->SetSize(0);
         eosFlag_ = false;
@@ -208,22 +215,35 @@ Status AudioLbvcEncoderPlugin::QueueOutputBuffer(std::shared_ptr<AVBuffer> &outp
         AVCODEC_LOGE("FillThisBuffer failed!");
         return ret;
     }
-
-    dataCallback_->OnOutputBufferDone(outputBuffer);
-    AVCODEC_LOGD("OnOutputBufferDone");
     return Status::OK;
 }
 
 Status AudioLbvcEncoderPlugin::GetInputBuffers(std::vector<std::shared_ptr<AVBuffer>> &inputBuffers)
 {
+    hdiCodec_->GetInputBuffers(inputBuffers);
     return Status::OK;
 }
 
 Status AudioLbvcEncoderPlugin::GetOutputBuffers(std::vector<std::shared_ptr<AVBuffer>> &outputBuffers)
 {
+    hdiCodec_->GetOutputBuffers(outputBuffers);
     return Status::OK;
 }
 
+void AudioLbvcEncoderPlugin::OnBufferDone(HdiCodec::PortIndex portIndex, const std::shared_ptr<AVBuffer> &buffer)
+{
+    if (dataCallback_ == nullptr) {
+        return;
+    }
+    if (portIndex == HdiCodec::PortIndex::INPUT_PORT) {
+        dataCallback_->OnInputBufferDone(buffer);
+        AVCODEC_LOGD("OnInputBufferDone");
+    } else {
+        dataCallback_->OnOutputBufferDone(buffer);
+        AVCODEC_LOGD("OnOutputBufferDone");
+    }
+}
+
 Status AudioLbvcEncoderPlugin::Flush()
 {
     Status ret = hdiCodec_->SendCommand(CODEC_COMMAND_FLUSH, CODEC_STATE_EXECUTING);
@@ -0,0 +1,612 @@
+/*
+ * Copyright (c) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "audio_sample_converter.h"
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <mutex>
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace OHOS {
+namespace Media {
+namespace Plugins {
+namespace Ffmpeg {
+namespace {
+constexpr int32_t MAX_KERNEL_CHANNELS = 8;
+// samples per channel converted at a time, the scratch planes of one block stay in the L1 cache
+constexpr int32_t BLOCK_SAMPLES = 256;
+constexpr size_t MAX_IDLE_CONTEXTS = 8;
+constexpr float S16_SCALE = 32768.0f;
+constexpr float S16_MAX = 32767.0f;
+constexpr float S16_MIN = -32768.0f;
+constexpr float S32_SCALE = 2147483648.0f;
+constexpr int32_t S32_TO_S16_SHIFT = 16;
+
+// the scalar conversions match the C reference of libswresample for finite samples
+inline int16_t FltToS16(float sample)
+{
+    float scaled = sample * S16_SCALE;
+    scaled = scaled < S16_MAX ? scaled : S16_MAX;
+    scaled = scaled > S16_MIN ? scaled : S16_MIN;
+    return static_cast<int16_t>(std::lrintf(scaled));
+}
+
+inline int32_t FltToS32(float sample)
+{
+    float scaled = sample * S32_SCALE;
+    if (scaled >= S32_SCALE) {
+        return INT32_MAX;
+    }
+    if (scaled <= -S32_SCALE) {
+        return INT32_MIN;
+    }
+    return static_cast<int32_t>(std::lrintf(scaled));
+}
+
+inline int16_t S32ToS16(int32_t sample)
+{
+    return static_cast<int16_t>(sample >> S32_TO_S16_SHIFT);
+}
+
+inline float S16ToFlt(int16_t sample)
+{
+    return sample * (1.0f / S16_SCALE);
+}
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define AUDIO_SAMPLE_CONVERTER_SIMD
+inline void FltToS16x8(const float *in, int16_t *out)
+{
+    int32x4_t low = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(in), S16_SCALE));
+    int32x4_t high = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(in + 4), S16_SCALE)); // 4: second half
+    vst1q_s16(out, vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+}
+
+inline void FltToS32x8(const float *in, int32_t *out)
+{
+    vst1q_s32(out, vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(in), S32_SCALE)));
+    vst1q_s32(out + 4, vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(in + 4), S32_SCALE))); // 4: second half
+}
+
+inline void S32ToS16x8(const int32_t *in, int16_t *out)
+{
+    int16x4_t low = vshrn_n_s32(vld1q_s32(in), S32_TO_S16_SHIFT);
+    int16x4_t high = vshrn_n_s32(vld1q_s32(in + 4), S32_TO_S16_SHIFT); // 4: second half
+    vst1q_s16(out, vcombine_s16(low, high));
+}
+
+inline void S16ToFltx8(const int16_t *in, float *out)
+{
+    int16x8_t value = vld1q_s16(in);
+    vst1q_f32(out, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(value))), 1.0f / S16_SCALE));
+    vst1q_f32(out + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(value))), 1.0f / S16_SCALE)); // 4
+}
+
+inline void Interleave2x8(const int16_t *left, const int16_t *right, int16_t *out)
+{
+    vst2q_s16(out, (int16x8x2_t { { vld1q_s16(left), vld1q_s16(right) } }));
+}
+
+inline void Interleave2x8(const int32_t *left, const int32_t *right, int32_t *out)
+{
+    vst2q_s32(out, (int32x4x2_t { { vld1q_s32(left), vld1q_s32(right) } }));
+    vst2q_s32(out + 8, (int32x4x2_t { { vld1q_s32(left + 4), vld1q_s32(right + 4) } })); // 8 4: second half
+}
+
+inline void Interleave2x8(const float *left, const float *right, float *out)
+{
+    vst2q_f32(out, (float32x4x2_t { { vld1q_f32(left), vld1q_f32(right) } }));
+    vst2q_f32(out + 8, (float32x4x2_t { { vld1q_f32(left + 4), vld1q_f32(right + 4) } })); // 8 4: second half
+}
+
+inline void Deinterleave2x8(const int16_t *in, int16_t *left, int16_t *right)
+{
+    int16x8x2_t value = vld2q_s16(in);
+    vst1q_s16(left, value.val[0]);
+    vst1q_s16(right, value.val[1]);
+}
+#elif defined(__SSE2__)
+#define AUDIO_SAMPLE_CONVERTER_SIMD
+inline __m128i LoadInt(const void *in)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+}
+
+inline void StoreInt(void *out, __m128i value)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), value);
+}
+
+inline __m128 Clamp(__m128 value, float low, float high)
+{
+    return _mm_max_ps(_mm_min_ps(value, _mm_set1_ps(high)), _mm_set1_ps(low));
+}
+
+inline void FltToS16x8(const float *in, int16_t *out)
+{
+    __m128 scale = _mm_set1_ps(S16_SCALE);
+    __m128i low = _mm_cvtps_epi32(Clamp(_mm_mul_ps(_mm_loadu_ps(in), scale), S16_MIN, S16_MAX));
+    __m128i high = _mm_cvtps_epi32(Clamp(_mm_mul_ps(_mm_loadu_ps(in + 4), scale), S16_MIN, S16_MAX)); // 4
+    StoreInt(out, _mm_packs_epi32(low, high));
+}
+
+inline __m128i FltToS32x4(__m128 value)
+{
+    __m128 scaled = _mm_mul_ps(value, _mm_set1_ps(S32_SCALE));
+    // cvtps2dq gives INT32_MIN on positive overflow, flipping all bits there turns it into INT32_MAX
+    __m128i overflow = _mm_castps_si128(_mm_cmpge_ps(scaled, _mm_set1_ps(S32_SCALE)));
+    return _mm_xor_si128(_mm_cvtps_epi32(scaled), overflow);
+}
+
+inline void FltToS32x8(const float *in, int32_t *out)
+{
+    StoreInt(out, FltToS32x4(_mm_loadu_ps(in)));
+    StoreInt(out + 4, FltToS32x4(_mm_loadu_ps(in + 4))); // 4: second half
+}
+
+inline void S32ToS16x8(const int32_t *in, int16_t *out)
+{
+    __m128i low = _mm_srai_epi32(LoadInt(in), S32_TO_S16_SHIFT);
+    __m128i high = _mm_srai_epi32(LoadInt(in + 4), S32_TO_S16_SHIFT); // 4: second half
+    StoreInt(out, _mm_packs_epi32(low, high));
+}
+
+inline void S16ToFltx8(const int16_t *in, float *out)
+{
+    __m128i value = LoadInt(in);
+    __m128 scale = _mm_set1_ps(1.0f / S16_SCALE);
+    // 16: sign extend to 32 bits
+    __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16);
+    __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(value, value), 16);
+    _mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+    _mm_storeu_ps(out + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale)); // 4: second half
+}
+
+inline void Interleave2x8(const int16_t *left, const int16_t *right, int16_t *out)
+{
+    __m128i leftValue = LoadInt(left);
+    __m128i rightValue = LoadInt(right);
+    StoreInt(out, _mm_unpacklo_epi16(leftValue, rightValue));
+    StoreInt(out + 8, _mm_unpackhi_epi16(leftValue, rightValue)); // 8: second half
+}
+
+inline void Interleave2x8(const int32_t *left, const int32_t *right, int32_t *out)
+{
+    for (int32_t i = 0; i < 8; i += 4) { // 8 frames, 4 per vector
+        __m128i leftValue = LoadInt(left + i);
+        __m128i rightValue = LoadInt(right + i);
+        StoreInt(out + 2 * i, _mm_unpacklo_epi32(leftValue, rightValue)); // 2 channels
+        StoreInt(out + 2 * i + 4, _mm_unpackhi_epi32(leftValue, rightValue)); // 2 channels, 4 second half
+    }
+}
+
+inline void Interleave2x8(const float *left, const float *right, float *out)
+{
+    for (int32_t i = 0; i < 8; i += 4) { // 8 frames, 4 per vector
+        __m128 leftValue = _mm_loadu_ps(left + i);
+        __m128 rightValue = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(leftValue, rightValue)); // 2 channels
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(leftValue, rightValue)); // 2 channels, 4 second half
+    }
+}
+
+inline void Deinterleave2x8(const int16_t *in, int16_t *left, int16_t *right)
+{
+    __m128i first = LoadInt(in);
+    __m128i second = LoadInt(in + 8); // 8: second half
+    // 16: the left sample sits in the low half of every 32 bit pair, sign extend both halves before packing
+    __m128i firstLeft = _mm_srai_epi32(_mm_slli_epi32(first, 16), 16);
+    __m128i secondLeft = _mm_srai_epi32(_mm_slli_epi32(second, 16), 16);
+    StoreInt(left, _mm_packs_epi32(firstLeft, secondLeft));
+    StoreInt(right, _mm_packs_epi32(_mm_srai_epi32(first, 16), _mm_srai_epi32(second, 16)));
+}
+#endif
+
+// every conversion handles VECTOR_STEP samples per vector call, the tail goes through Scalar
+constexpr int32_t VECTOR_STEP = 8;
+
+template <typename S, typename D, D (*ScalarFunc)(S), void (*VectorFunc)(const S *, D *)>
+struct SampleOp {
+    using Src = S;
+    using Dst = D;
+    static constexpr bool IDENTITY = false;
+    static void Transform(const Src *in, Dst *out, int32_t count)
+    {
+        int32_t i = 0;
+#ifdef AUDIO_SAMPLE_CONVERTER_SIMD
+        for (; i + VECTOR_STEP <= count; i += VECTOR_STEP) {
+            VectorFunc(in + i, out + i);
+        }
+#endif
+        for (; i < count; i++) {
+            out[i] = ScalarFunc(in[i]);
+        }
+    }
+};
+
+template <typename T>
+struct CopyOp {
+    using Src = T;
+    using Dst = T;
+    static constexpr bool IDENTITY = true;
+    static void Transform(const Src *in, Dst *out, int32_t count)
+    {
+        std::copy_n(in, count, out);
+    }
+};
+
+#ifndef AUDIO_SAMPLE_CONVERTER_SIMD
+// only the scalar tail of SampleOp runs without vector support
+template <typename S, typename D>
+inline void NoVector(const S *, D *)
+{
+}
+#define VECTOR_OF(func, S, D) NoVector<S, D>
+#else
+#define VECTOR_OF(func, S, D) func
+#endif
+
+using FltToS16Op = SampleOp<float, int16_t, FltToS16, VECTOR_OF(FltToS16x8, float, int16_t)>;
+using FltToS32Op = SampleOp<float, int32_t, FltToS32, VECTOR_OF(FltToS32x8, float, int32_t)>;
+using S32ToS16Op = SampleOp<int32_t, int16_t, S32ToS16, VECTOR_OF(S32ToS16x8, int32_t, int16_t)>;
+using S16ToFltOp = SampleOp<int16_t, float, S16ToFlt, VECTOR_OF(S16ToFltx8, int16_t, float)>;
+#undef VECTOR_OF
+
+template <typename T>
+void Interleave(const T *const *planes, T *out, int32_t count, int32_t channels)
+{
+    int32_t i = 0;
+#ifdef AUDIO_SAMPLE_CONVERTER_SIMD
+    if (channels == 2) { // 2: stereo
+        for (; i + VECTOR_STEP <= count; i += VECTOR_STEP) {
+            Interleave2x8(planes[0] + i, planes[1] + i, out + 2 * i); // 2: stereo
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        for (int32_t ch = 0; ch < channels; ch++) {
+            out[i * channels + ch] = planes[ch][i];
+        }
+    }
+}
+
+template <typename T>
+void Deinterleave(const T *in, T *const *planes, int32_t count, int32_t channels)
+{
+    int32_t i = 0;
+#ifdef AUDIO_SAMPLE_CONVERTER_SIMD
+    if constexpr (sizeof(T) == sizeof(int16_t)) {
+        if (channels == 2) { // 2: stereo
+            for (; i + VECTOR_STEP <= count; i += VECTOR_STEP) {
+                Deinterleave2x8(in + 2 * i, planes[0] + i, planes[1] + i); // 2: stereo
+            }
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        for (int32_t ch = 0; ch < channels; ch++) {
+            planes[ch][i] = in[i * channels + ch];
+        }
+    }
+}
+
+template <typename Op>
+void PackedKernel(const uint8_t *const *src, uint8_t *const *dest, int32_t samples, int32_t channels)
+{
+    Op::Transform(reinterpret_cast<const typename Op::Src *>(src[0]), reinterpret_cast<typename Op::Dst *>(dest[0]),
+        samples * channels);
+}
+
+template <typename Op>
+void PlanarToPackedKernel(const uint8_t *const *src, uint8_t *const *dest, int32_t samples, int32_t channels)
+{
+    using Src = typename Op::Src;
+    using Dst = typename Op::Dst;
+    Dst *out = reinterpret_cast<Dst *>(dest[0]);
+    if (channels == 1) {
+        Op::Transform(reinterpret_cast<const Src *>(src[0]), out, samples);
+        return;
+    }
+    alignas(16) Dst scratch[MAX_KERNEL_CHANNELS][BLOCK_SAMPLES]; // 16: vector alignment
+    const Dst *planes[MAX_KERNEL_CHANNELS] = {};
+    for (int32_t offset = 0; offset < samples; offset += BLOCK_SAMPLES) {
+        int32_t count = std::min(BLOCK_SAMPLES, samples - offset);
+        for (int32_t ch = 0; ch < channels; ch++) {
+            const Src *in = reinterpret_cast<const Src *>(src[ch]) + offset;
+            if constexpr (Op::IDENTITY) {
+                planes[ch] = in;
+            } else {
+                Op::Transform(in, scratch[ch], count);
+                planes[ch] = scratch[ch];
+            }
+        }
+        Interleave(planes, out + offset * channels, count, channels);
+    }
+}
+
+template <typename Op>
+void PackedToPlanarKernel(const uint8_t *const *src, uint8_t *const *dest, int32_t samples, int32_t channels)
+{
+    using Src = typename Op::Src;
+    using Dst = typename Op::Dst;
+    const Src *in = reinterpret_cast<const Src *>(src[0]);
+    if (channels == 1) {
+        Op::Transform(in, reinterpret_cast<Dst *>(dest[0]), samples);
+        return;
+    }
+    alignas(16) Src scratch[MAX_KERNEL_CHANNELS][BLOCK_SAMPLES]; // 16: vector alignment
+    Src *planes[MAX_KERNEL_CHANNELS] = {};
+    for (int32_t ch = 0; ch < channels; ch++) {
+        planes[ch] = scratch[ch];
+    }
+    for (int32_t offset = 0; offset < samples; offset += BLOCK_SAMPLES) {
+        int32_t count = std::min(BLOCK_SAMPLES, samples - offset);
+        Deinterleave(in + offset * channels, planes, count, channels);
+        for (int32_t ch = 0; ch < channels; ch++) {
+            Op::Transform(scratch[ch], reinterpret_cast<Dst *>(dest[ch]) + offset, count);
+        }
+    }
+}
+
+struct KernelEntry {
+    AVSampleFormat srcFmt;
+    AVSampleFormat destFmt;
+    AudioSampleConverter::Kernel kernel;
+};
+
+// decoders mostly produce planar float or 16/32 bit integers, the encoders take planar float
+const KernelEntry KERNELS[] = {
+    { AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_S16, PlanarToPackedKernel<FltToS16Op> },
+    { AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_FLT, PlanarToPackedKernel<CopyOp<float>> },
+    { AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_S32, PlanarToPackedKernel<FltToS32Op> },
+    { AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_S16, PackedKernel<FltToS16Op> },
+    { AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_S32, PackedKernel<FltToS32Op> },
+    { AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S16, PlanarToPackedKernel<CopyOp<int16_t>> },
+    { AV_SAMPLE_FMT_S32, AV_SAMPLE_FMT_S16, PackedKernel<S32ToS16Op> },
+    { AV_SAMPLE_FMT_S32P, AV_SAMPLE_FMT_S16, PlanarToPackedKernel<S32ToS16Op> },
+    { AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_FLT, PackedKernel<S16ToFltOp> },
+    { AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_FLTP, PackedToPlanarKernel<S16ToFltOp> },
+};
+
+/**
+ * Idle SwrContexts of finished converters, handed to the next converter with the same parameters. A context is
+ * only kept when it holds no delayed samples, which is always true without a rate change. There is one cache per
+ * library that compiles this file in.
+ */
+class SwrContextCache {
+public:
+    static SwrContextCache &GetInstance()
+    {
+        static SwrContextCache instance;
+        return instance;
+    }
+
+    ~SwrContextCache()
+    {
+        for (auto &entry : idle_) {
+            Free(entry);
+        }
+    }
+
+    SwrContext *Acquire(AVSampleFormat srcFmt, AVSampleFormat destFmt, const AVChannelLayout &channelLayout,
+        int32_t sampleRate)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(idle_.begin(), idle_.end(), [&](const Entry &entry) {
+                return entry.srcFmt == srcFmt && entry.destFmt == destFmt && entry.sampleRate == sampleRate &&
+                    av_channel_layout_compare(&entry.channelLayout, &channelLayout) == 0;
+            });
+            if (it != idle_.end()) {
+                SwrContext *swrCtx = it->swrCtx;
+                it->swrCtx = nullptr;
+                Free(*it);
+                idle_.erase(it);
+                return swrCtx;
+            }
+        }
+        SwrContext *swrCtx = nullptr;
+        int32_t error = swr_alloc_set_opts2(&swrCtx, &channelLayout, destFmt, sampleRate, &channelLayout, srcFmt,
+            sampleRate, 0, nullptr);
+        if (error < 0 || swrCtx == nullptr || swr_init(swrCtx) < 0) {
+            swr_free(&swrCtx);
+            return nullptr;
+        }
+        return swrCtx;
+    }
+
+    void Release(AVSampleFormat srcFmt, AVSampleFormat destFmt, const AVChannelLayout &channelLayout,
+        int32_t sampleRate, SwrContext *swrCtx)
+    {
+        Entry entry { srcFmt, destFmt, {}, sampleRate, swrCtx };
+        if (swr_get_delay(swrCtx, 1) != 0 || av_channel_layout_copy(&entry.channelLayout, &channelLayout) < 0) {
+            Free(entry);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.size() >= MAX_IDLE_CONTEXTS) {
+            Free(idle_.front());
+            idle_.pop_front();
+        }
+        idle_.push_back(entry);
+    }
+
+private:
+    struct Entry {
+        AVSampleFormat srcFmt;
+        AVSampleFormat destFmt;
+        AVChannelLayout channelLayout;
+        int32_t sampleRate;
+        SwrContext *swrCtx;
+    };
+
+    static void Free(Entry &entry)
+    {
+        if (entry.swrCtx != nullptr) {
+            swr_free(&entry.swrCtx);
+        }
+        av_channel_layout_uninit(&entry.channelLayout);
+    }
+
+    std::mutex mutex_;
+    std::list<Entry> idle_;
+};
+} // namespace
+
+AudioSampleConverter::~AudioSampleConverter()
+{
+    Release();
+}
+
+AudioSampleConverter::Kernel AudioSampleConverter::FindKernel(AVSampleFormat srcFmt, AVSampleFormat destFmt,
+    int32_t channels)
+{
+    if (channels <= 0 || channels > MAX_KERNEL_CHANNELS) {
+        return nullptr;
+    }
+    for (const auto &entry : KERNELS) {
+        if (entry.srcFmt == srcFmt && entry.destFmt == destFmt) {
+            return entry.kernel;
+        }
+    }
+    return nullptr;
+}
+
+Status AudioSampleConverter::Init(AVSampleFormat srcFmt, AVSampleFormat destFmt,
+    const AVChannelLayout &channelLayout, int32_t sampleRate)
+{
+    Release();
+    if (channelLayout.nb_channels <= 0 || av_channel_layout_copy(&channelLayout_, &channelLayout) < 0) {
+        return Status::ERROR_INVALID_PARAMETER;
+    }
+    srcFmt_ = srcFmt;
+    destFmt_ = destFmt;
+    sampleRate_ = sampleRate;
+    channels_ = channelLayout.nb_channels;
+    kernel_ = FindKernel(srcFmt, destFmt, channels_);
+    if (kernel_ != nullptr) {
+        return Status::OK;
+    }
+    swrCtx_ = SwrContextCache::GetInstance().Acquire(srcFmt, destFmt, channelLayout_, sampleRate);
+    if (swrCtx_ == nullptr) {
+        Release();
+        return Status::ERROR_UNKNOWN;
+    }
+    return Status::OK;
+}
+
+void AudioSampleConverter::Release()
+{
+    if (swrCtx_ != nullptr) {
+        SwrContextCache::GetInstance().Release(srcFmt_, destFmt_, channelLayout_, sampleRate_, swrCtx_);
+        swrCtx_ = nullptr;
+    }
+    av_channel_layout_uninit(&channelLayout_);
+    kernel_ = nullptr;
+    channels_ = 0;
+}
+
+bool AudioSampleConverter::IsAccelerated() const
+{
+    return kernel_ != nullptr;
+}
+
+size_t AudioSampleConverter::GetDestSize(int32_t samples) const
+{
+    int32_t size = av_samples_get_buffer_size(nullptr, channels_, samples, destFmt_, 1);
+    return size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+Status AudioSampleConverter::Convert(const uint8_t *const *src, int32_t samples, uint8_t *dest, size_t capacity,
+    size_t &destLength)
+{
+    destLength = 0;
+    if (kernel_ == nullptr && swrCtx_ == nullptr) {
+        return Status::ERROR_INVALID_OPERATION;
+    }
+    if (src == nullptr || dest == nullptr || samples < 0) {
+        return Status::ERROR_INVALID_PARAMETER;
+    }
+    size_t destSize = GetDestSize(samples);
+    if (capacity < destSize) {
+        return Status::ERROR_NO_MEMORY;
+    }
+    std::vector<uint8_t *> planes(av_sample_fmt_is_planar(destFmt_) ? channels_ : 1);
+    if (av_samples_fill_arrays(planes.data(), nullptr, dest, channels_, samples, destFmt_, 1) < 0) {
+        return Status::ERROR_INVALID_PARAMETER;
+    }
+    if (kernel_ != nullptr) {
+        kernel_(src, planes.data(), samples, channels_);
+        destLength = destSize;
+        return Status::OK;
+    }
+    int32_t converted = swr_convert(swrCtx_, planes.data(), samples, const_cast<const uint8_t **>(src), samples);
+    if (converted < 0) {
+        return Status::ERROR_UNKNOWN;
+    }
+    destLength = GetDestSize(converted);
+    return Status::OK;
+}
+
+Status AudioSampleConverter::Convert(const AVFrame *frame, uint8_t *dest, size_t capacity, size_t &destLength)
+{
+    destLength = 0;
+    if (frame == nullptr || frame->extended_data == nullptr) {
+        return Status::ERROR_INVALID_PARAMETER;
+    }
+    // the layout of dest depends on the channel count and the caller reports the rate, neither may change here
+    if (frame->ch_layout.nb_channels != channels_ || (frame->sample_rate > 0 && frame->sample_rate != sampleRate_)) {
+        return Status::ERROR_INVALID_DATA;
+    }
+    auto srcFmt = static_cast<AVSampleFormat>(frame->format);
+    if (srcFmt != srcFmt_) {
+        AVChannelLayout channelLayout {};
+        AVSampleFormat destFmt = destFmt_;
+        int32_t sampleRate = sampleRate_;
+        if (av_channel_layout_copy(&channelLayout, &channelLayout_) < 0) {
+            return Status::ERROR_NO_MEMORY;
+        }
+        Status ret = Init(srcFmt, destFmt, channelLayout, sampleRate);
+        av_channel_layout_uninit(&channelLayout);
+        if (ret != Status::OK) {
+            return ret;
+        }
+    }
+    int32_t planes = av_sample_fmt_is_planar(srcFmt_) ? channels_ : 1;
+    for (int32_t i = 0; i < planes; i++) {
+        if (frame->extended_data[i] == nullptr) {
+            return Status::ERROR_INVALID_PARAMETER;
+        }
+    }
+    return Convert(frame->extended_data, frame->nb_samples, dest, capacity, destLength);
+}
+
+Status AudioSampleConverter::Convert(const uint8_t *const *src, int32_t samples, uint8_t *&dest, size_t &destLength)
+{
+    size_t destSize = GetDestSize(samples);
+    if (destCache_.size() < destSize) {
+        destCache_.resize(destSize);
+    }
+    dest = destCache_.data();
+    return Convert(src, samples, destCache_.data(), destCache_.size(), destLength);
+}
+} // namespace Ffmpeg
+} // namespace Plugins
+} // namespace Media
+} // namespace OHOS
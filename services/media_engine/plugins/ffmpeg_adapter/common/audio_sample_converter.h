@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef AUDIO_SAMPLE_CONVERTER_H
+#define AUDIO_SAMPLE_CONVERTER_H
+
+#include <cstdint>
+#include <vector>
+#include "common/status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "libavutil/channel_layout.h"
+#include "libavutil/frame.h"
+#include "libavutil/samplefmt.h"
+#include "libswresample/swresample.h"
+#ifdef __cplusplus
+};
+#endif
+
+namespace OHOS {
+namespace Media {
+namespace Plugins {
+namespace Ffmpeg {
+/**
+ * Converts audio between sample formats at an unchanged rate and channel layout. Planar destinations are written as
+ * consecutive planes of the converted sample count.
+ *
+ * The conversions the audio codecs need most run through vectorized kernels, every other one through a SwrContext
+ * taken from a cache, so codec instances with the same parameters do not build their own. The converter is compiled
+ * into each library that uses it, and each of those libraries keeps a cache of its own.
+ *
+ * A frame whose sample format differs from the one given to Init switches the converter to that format. A frame
+ * with another channel count or sample rate is rejected, the caller has to Init again for it.
+ */
+class AudioSampleConverter {
+public:
+    AudioSampleConverter() = default;
+    ~AudioSampleConverter();
+    AudioSampleConverter(const AudioSampleConverter &) = delete;
+    AudioSampleConverter &operator=(const AudioSampleConverter &) = delete;
+
+    Status Init(AVSampleFormat srcFmt, AVSampleFormat destFmt, const AVChannelLayout &channelLayout,
+        int32_t sampleRate);
+    void Release();
+    bool IsAccelerated() const;
+    size_t GetDestSize(int32_t samples) const;
+    // src holds one pointer per plane, dest must hold GetDestSize(samples) bytes
+    Status Convert(const uint8_t *const *src, int32_t samples, uint8_t *dest, size_t capacity, size_t &destLength);
+    Status Convert(const AVFrame *frame, uint8_t *dest, size_t capacity, size_t &destLength);
+    // converts into a buffer the converter keeps and grows across calls
+    Status Convert(const uint8_t *const *src, int32_t samples, uint8_t *&dest, size_t &destLength);
+
+    using Kernel = void (*)(const uint8_t *const *src, uint8_t *const *dest, int32_t samples, int32_t channels);
+    // the vectorized kernel for a conversion, nullptr when it goes through libswresample
+    static Kernel FindKernel(AVSampleFormat srcFmt, AVSampleFormat destFmt, int32_t channels);
+
+private:
+    AVSampleFormat srcFmt_{AV_SAMPLE_FMT_NONE};
+    AVSampleFormat destFmt_{AV_SAMPLE_FMT_NONE};
+    AVChannelLayout channelLayout_{};
+    int32_t sampleRate_{0};
+    int32_t channels_{0};
+    Kernel kernel_{nullptr};
+    SwrContext *swrCtx_{nullptr};
+    std::vector<uint8_t> destCache_{};
+};
+} // namespace Ffmpeg
+} // namespace Plugins
+} // namespace Media
+} // namespace OHOS
+#endif // AUDIO_SAMPLE_CONVERTER_H
@@ -29,35 +29,7 @@ Status Resample::Init(const ResamplePara &resamplePara)
     resamplePara_ = resamplePara;
 #if defined(_WIN32) || !defined(OHOS_LITE)
     if (resamplePara_.bitsPerSample != 8 && resamplePara_.bitsPerSample != 24) { // 8 24
-        auto destFrameSize = av_samples_get_buffer_size(nullptr, resamplePara_.channels,
-                                                        resamplePara_.destSamplesPerFrame, resamplePara_.destFmt, 0);
-        resampleCache_.reserve(destFrameSize);
-        resampleChannelAddr_.reserve(resamplePara_.channels);
-        auto tmp = resampleChannelAddr_.data();
-        av_samples_fill_arrays(tmp, nullptr, resampleCache_.data(), resamplePara_.channels,
-                               resamplePara_.destSamplesPerFrame, resamplePara_.destFmt, 0);
-        auto swrContext = swr_alloc();
-        if (swrContext == nullptr) {
-            MEDIA_LOG_E("cannot allocate swr context");
-            return Status::ERROR_NO_MEMORY;
-        }
-        int32_t error = swr_alloc_set_opts2(&swrContext, &resamplePara_.channelLayout, resamplePara_.destFmt,
-                                            resamplePara_.sampleRate, &resamplePara_.channelLayout,
-                                            resamplePara_.srcFfFmt, resamplePara_.sampleRate, 0, nullptr);
-        if (error < 0) {
-            MEDIA_LOG_E("swr init error");
-            return Status::ERROR_UNKNOWN;
-        }
-        if (swr_init(swrContext) != 0) {
-            MEDIA_LOG_E("swr init error");
-            return Status::ERROR_UNKNOWN;
-        }
-        swrCtx_ = std::shared_ptr<SwrContext>(swrContext, [](SwrContext *ptr) {
-            if (ptr) {
-                swr_free(&ptr);
-                ptr = nullptr;
-            }
-        });
+        return InitSwrContext(resamplePara);
     }
 #endif
     return Status::OK;
@@ -66,28 +38,14 @@ Status Resample::Init(const ResamplePara &resamplePara)
 Status Resample::InitSwrContext(const ResamplePara &resamplePara)
 {
     resamplePara_ = resamplePara;
-    auto swrContext = swr_alloc();
-    if (swrContext == nullptr) {
-        MEDIA_LOG_E("cannot allocate swr context");
-        return Status::ERROR_NO_MEMORY;
+    Status ret = converter_.Init(resamplePara_.srcFfFmt, resamplePara_.destFmt, resamplePara_.channelLayout,
+                                 static_cast<int32_t>(resamplePara_.sampleRate));
+    if (ret != Status::OK) {
+        MEDIA_LOG_E("sample converter init error");
+        return ret;
     }
-    int32_t error =
-        swr_alloc_set_opts2(&swrContext, &resamplePara_.channelLayout, resamplePara_.destFmt, resamplePara_.sampleRate,
-                            &resamplePara_.channelLayout, resamplePara_.srcFfFmt, resamplePara_.sampleRate, 0, nullptr);
-    if (error < 0) {
-        MEDIA_LOG_E("swr init error");
-        return Status::ERROR_UNKNOWN;
-    }
-    if (swr_init(swrContext) != 0) {
-        MEDIA_LOG_E("swr init error");
-        return Status::ERROR_UNKNOWN;
-    }
-    swrCtx_ = std::shared_ptr<SwrContext>(swrContext, [](SwrContext *ptr) {
-        if (ptr) {
-            swr_free(&ptr);
-            ptr = nullptr;
-        }
-    });
+    MEDIA_LOG_D("convert " PUBLIC_LOG_D32 " to " PUBLIC_LOG_D32 ", accelerated: " PUBLIC_LOG_D32,
+                resamplePara_.srcFfFmt, resamplePara_.destFmt, converter_.IsAccelerated());
     return Status::OK;
 }
 
@@ -127,59 +85,26 @@ Status Resample::Convert(const uint8_t *srcBuffer, const size_t srcLength, uint8
             }
         }
         auto samples = lineSize / static_cast<size_t>(av_get_bytes_per_sample(resamplePara_.srcFfFmt));
-        auto res = swr_convert(swrCtx_.get(), resampleChannelAddr_.data(), resamplePara_.destSamplesPerFrame,
-                               tmpInput.data(), samples);
-        if (res < 0) {
+        if (converter_.Convert(tmpInput.data(), static_cast<int32_t>(samples), destBuffer, destLength) != Status::OK) {
             MEDIA_LOG_E("resample input failed");
             destLength = 0;
-        } else {
-            destBuffer = resampleCache_.data();
-            size_t bytesPerSample = static_cast<size_t>(av_get_bytes_per_sample(resamplePara_.destFmt));
-            destLength = static_cast<size_t>(res) * bytesPerSample * resamplePara_.channels;
         }
     }
 #endif
     return Status::OK;
 }
 
-static std::string AVStrError(int errnum)
-{
-    char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
-    av_strerror(errnum, errbuf, AV_ERROR_MAX_STRING_SIZE);
-    return std::string(errbuf);
-}
-
-Status Resample::ConvertFrame(AVFrame *outputFrame, const AVFrame *inputFrame)
+Status Resample::ConvertFrame(const AVFrame *inputFrame, uint8_t *dest, size_t capacity, size_t &destLength)
 {
-    if (outputFrame == nullptr || inputFrame == nullptr) {
+    if (inputFrame == nullptr || dest == nullptr) {
         MEDIA_LOG_E("Frame null pointer");
         return Status::ERROR_NO_MEMORY;
     }
-
-    int planar = av_sample_fmt_is_planar(static_cast<AVSampleFormat>(inputFrame->format));
-    if (planar) {
-        for (auto i = 0; i < inputFrame->channels; i++) {
-            if (inputFrame->extended_data[i] == nullptr) {
-                MEDIA_LOG_E("this is a planar audio, inputFrame->channels: %{public}d, "
-                            "but inputFrame->extended_data[%{public}d] is nullptr", inputFrame->channels, i);
-                return Status::ERROR_NO_MEMORY;
-            }
-        }
-    } else {
-        if (inputFrame->extended_data[0] == nullptr) {
-            MEDIA_LOG_E("inputFrame->extended_data[0] is nullptr");
-            return Status::ERROR_NO_MEMORY;
-        }
-    }
-
-    outputFrame->ch_layout = resamplePara_.channelLayout;
-    outputFrame->format = resamplePara_.destFmt;
-    outputFrame->sample_rate = static_cast<int>(resamplePara_.sampleRate);
-
-    auto ret = swr_convert_frame(swrCtx_.get(), outputFrame, inputFrame);
-    if (ret < 0) {
-        MEDIA_LOG_E("convert frame failed, %{public}s", AVStrError(ret).c_str());
-        return Status::ERROR_UNKNOWN;
+    Status ret = converter_.Convert(inputFrame, dest, capacity, destLength);
+    if (ret != Status::OK) {
+        MEDIA_LOG_E("convert frame failed, nb_samples: " PUBLIC_LOG_D32 ", capacity: " PUBLIC_LOG_ZU,
+                    inputFrame->nb_samples, capacity);
+        return ret;
     }
     return Status::OK;
 }
@@ -223,14 +148,6 @@ Status Scale::Convert(uint8_t **srcData, const int32_t *srcLineSize, uint8_t **d
     return Status::OK;
 }
 #endif
-Resample::~Resample()
-{
-#if defined(_WIN32) || !defined(OHOS_LITE)
-    if (swrCtx_) {
-        swrCtx_ = nullptr;
-    }
-#endif
-}
 } // namespace Ffmpeg
 } // namespace Plugins
 } // namespace Media
@@ -18,6 +18,7 @@
 #include <memory>
 #include <vector>
 #include "common/status.h"
+#include "audio_sample_converter.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,18 +53,18 @@ struct ResamplePara {
 class Resample {
 public:
     Resample() = default;
-    ~Resample();
+    ~Resample() = default;
     Status Init(const ResamplePara &resamplePara);
     Status InitSwrContext(const ResamplePara &resamplePara);
     Status Convert(const uint8_t *srcBuffer, const size_t srcLength, uint8_t *&destBuffer, size_t &destLength);
-    Status ConvertFrame(AVFrame *outputFrame, const AVFrame *inputFrame);
+    // converts the frame straight into dest, which must hold at least destLength bytes
+    Status ConvertFrame(const AVFrame *inputFrame, uint8_t *dest, size_t capacity, size_t &destLength);
 
 private:
     ResamplePara resamplePara_{};
 #if defined(_WIN32) || !defined(OHOS_LITE)
     std::vector<uint8_t> resampleCache_{};
-    std::vector<uint8_t *> resampleChannelAddr_{};
-    std::shared_ptr<SwrContext> swrCtx_{nullptr};
+    AudioSampleConverter converter_;
 #endif
 };
 
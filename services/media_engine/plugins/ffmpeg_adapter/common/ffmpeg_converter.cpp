@@ -15,19 +15,160 @@
 
 #define HST_LOG_TAG "FfmpegConverter"
 
-#include <vector>
-#include <algorithm>
+#include <array>
+#include <iterator>
+#include <utility>
 #include "common/log.h"
 #include "ffmpeg_converter.h"
 namespace {
 constexpr int US_PER_SECOND = 1000000;
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_DEMUXER, "FFmpegConverter"};
+constexpr int64_t MAX_DENSE_SPAN = 256;
+
+template <bool BY_SECOND, typename Pair>
+constexpr auto KeyOf(const Pair &item)
+{
+    if constexpr (BY_SECOND) {
+        return item.second;
+    } else {
+        return item.first;
+    }
+}
+
+template <bool BY_SECOND, typename Pair>
+constexpr auto ValueOf(const Pair &item)
+{
+    if constexpr (BY_SECOND) {
+        return item.first;
+    } else {
+        return item.second;
+    }
+}
+
+// Lookups generated at compile time from the pair tables below, either side of a pair can be the key. Like the linear
+// search they replace, a key listed twice resolves to its first entry.
+template <const auto &TABLE, bool BY_SECOND>
+struct LookupTraits {
+    using Key = decltype(KeyOf<BY_SECOND>(TABLE[0]));
+    using Value = decltype(ValueOf<BY_SECOND>(TABLE[0]));
+    struct Slot {
+        bool used{false};
+        Key key{};
+        Value value{};
+    };
+};
+
+template <const auto &TABLE, bool BY_SECOND>
+constexpr int64_t KeyBound(bool max)
+{
+    int64_t bound = static_cast<int64_t>(KeyOf<BY_SECOND>(TABLE[0]));
+    for (const auto &item : TABLE) {
+        int64_t key = static_cast<int64_t>(KeyOf<BY_SECOND>(item));
+        bound = (max ? key > bound : key < bound) ? key : bound;
+    }
+    return bound;
+}
+
+template <const auto &TABLE, bool BY_SECOND, int64_t MIN_KEY, int64_t SPAN>
+constexpr auto BuildDenseSlots()
+{
+    std::array<typename LookupTraits<TABLE, BY_SECOND>::Slot, SPAN> slots{};
+    for (const auto &item : TABLE) {
+        auto &slot = slots[static_cast<int64_t>(KeyOf<BY_SECOND>(item)) - MIN_KEY];
+        if (!slot.used) {
+            slot = {true, KeyOf<BY_SECOND>(item), ValueOf<BY_SECOND>(item)};
+        }
+    }
+    return slots;
+}
+
+// array indexed by the key, for enums and small integers
+template <const auto &TABLE, bool BY_SECOND = false>
+class DenseLookup {
+public:
+    using Key = typename LookupTraits<TABLE, BY_SECOND>::Key;
+    using Value = typename LookupTraits<TABLE, BY_SECOND>::Value;
+
+    static const Value *Find(Key key)
+    {
+        int64_t index = static_cast<int64_t>(key) - MIN_KEY;
+        if (index < 0 || index >= SPAN || !SLOTS[index].used) {
+            return nullptr;
+        }
+        return &SLOTS[index].value;
+    }
+
+private:
+    static constexpr int64_t MIN_KEY = KeyBound<TABLE, BY_SECOND>(false);
+    static constexpr int64_t SPAN = KeyBound<TABLE, BY_SECOND>(true) - MIN_KEY + 1;
+    static_assert(SPAN <= MAX_DENSE_SPAN, "keys too sparse for a dense lookup");
+    static constexpr auto SLOTS = BuildDenseSlots<TABLE, BY_SECOND, MIN_KEY, SPAN>();
+};
+
+template <size_t COUNT>
+constexpr size_t HashCapacity()
+{
+    size_t size = 1;
+    while (size < COUNT * 4) { // 4: a load factor of at most 1/4 keeps the probe sequences short
+        size <<= 1;
+    }
+    return size;
+}
+
+template <size_t SIZE, typename Key>
+constexpr size_t HashIndex(Key key)
+{
+    // murmur3 finalizer, spreads the few set channel bits over the whole index
+    uint64_t hash = static_cast<uint64_t>(key);
+    hash ^= hash >> 33;            // 33: finalizer shift
+    hash *= 0xff51afd7ed558ccdULL; // finalizer multiplier
+    hash ^= hash >> 33;            // 33: finalizer shift
+    return static_cast<size_t>(hash) & (SIZE - 1);
+}
+
+template <const auto &TABLE, bool BY_SECOND, size_t SIZE>
+constexpr auto BuildHashSlots()
+{
+    std::array<typename LookupTraits<TABLE, BY_SECOND>::Slot, SIZE> slots{};
+    for (const auto &item : TABLE) {
+        size_t index = HashIndex<SIZE>(KeyOf<BY_SECOND>(item));
+        while (slots[index].used && slots[index].key != KeyOf<BY_SECOND>(item)) {
+            index = (index + 1) & (SIZE - 1);
+        }
+        if (!slots[index].used) {
+            slots[index] = {true, KeyOf<BY_SECOND>(item), ValueOf<BY_SECOND>(item)};
+        }
+    }
+    return slots;
+}
+
+// open addressing hash table, for the sparse 64 bit channel layout masks
+template <const auto &TABLE, bool BY_SECOND = false>
+class HashLookup {
+public:
+    using Key = typename LookupTraits<TABLE, BY_SECOND>::Key;
+    using Value = typename LookupTraits<TABLE, BY_SECOND>::Value;
+
+    static const Value *Find(Key key)
+    {
+        for (size_t index = HashIndex<SIZE>(key); SLOTS[index].used; index = (index + 1) & (SIZE - 1)) {
+            if (SLOTS[index].key == key) {
+                return &SLOTS[index].value;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    static constexpr size_t SIZE = HashCapacity<std::size(TABLE)>();
+    static constexpr auto SLOTS = BuildHashSlots<TABLE, BY_SECOND, SIZE>();
+};
 }
 namespace OHOS {
 namespace Media {
 namespace Plugins {
 // ffmpeg channel layout to histreamer channel layout
-const std::vector<std::pair<AudioChannelLayout, uint64_t>> g_toFFMPEGChannelLayout = {
+constexpr std::pair<AudioChannelLayout, uint64_t> g_toFFMPEGChannelLayout[] = {
     {AudioChannelLayout::MONO, AV_CH_LAYOUT_MONO},
     {AudioChannelLayout::STEREO, AV_CH_LAYOUT_STEREO},
     {AudioChannelLayout::CH_2POINT1, AV_CH_LAYOUT_2POINT1},
@@ -58,7 +199,7 @@ const std::vector<std::pair<AudioChannelLayout, uint64_t>> g_toFFMPEGChannelLayo
     {AudioChannelLayout::STEREO_DOWNMIX, AV_CH_LAYOUT_STEREO_DOWNMIX},
 };
 
-const std::vector<std::pair<int, AudioChannelLayout>> g_channelLayoutDefaukltMap = {
+constexpr std::pair<int, AudioChannelLayout> g_channelLayoutDefaukltMap[] = {
     {2, AudioChannelLayout::STEREO},             // 2: STEREO
     {4, AudioChannelLayout::CH_4POINT0},         // 4: CH_4POINT0
     {6, AudioChannelLayout::CH_5POINT1},         // 6: CH_5POINT1
@@ -71,7 +212,7 @@ const std::vector<std::pair<int, AudioChannelLayout>> g_channelLayoutDefaukltMap
     {24, AudioChannelLayout::CH_22POINT2},       // 24: CH_22POINT2
 };
 
-const std::vector<std::pair<AVSampleFormat, AudioSampleFormat>> g_pFfSampleFmtMap = {
+constexpr std::pair<AVSampleFormat, AudioSampleFormat> g_pFfSampleFmtMap[] = {
     {AVSampleFormat::AV_SAMPLE_FMT_U8, AudioSampleFormat::SAMPLE_U8},
     {AVSampleFormat::AV_SAMPLE_FMT_S16, AudioSampleFormat::SAMPLE_S16LE},
     {AVSampleFormat::AV_SAMPLE_FMT_S32, AudioSampleFormat::SAMPLE_S32LE},
@@ -83,7 +224,7 @@ const std::vector<std::pair<AVSampleFormat, AudioSampleFormat>> g_pFfSampleFmtMa
 };
 
 // align with player framework capability.
-const std::vector<std::pair<AVCodecID, AudioSampleFormat>> g_pFfCodeIDToSampleFmtMap = {
+constexpr std::pair<AVCodecID, AudioSampleFormat> g_pFfCodeIDToSampleFmtMap[] = {
     {AVCodecID::AV_CODEC_ID_PCM_U8, AudioSampleFormat::SAMPLE_U8},
     {AVCodecID::AV_CODEC_ID_PCM_S16LE, AudioSampleFormat::SAMPLE_S16LE},
     {AVCodecID::AV_CODEC_ID_PCM_S24LE, AudioSampleFormat::SAMPLE_S24LE},
@@ -91,7 +232,7 @@ const std::vector<std::pair<AVCodecID, AudioSampleFormat>> g_pFfCodeIDToSampleFm
     {AVCodecID::AV_CODEC_ID_PCM_F32LE, AudioSampleFormat::SAMPLE_F32LE},
 };
 
-const std::vector<std::pair<AudioChannelLayout, std::string_view>> g_ChannelLayoutToString = {
+constexpr std::pair<AudioChannelLayout, std::string_view> g_ChannelLayoutToString[] = {
     {AudioChannelLayout::UNKNOWN, "UNKNOW"},
     {AudioChannelLayout::MONO, "MONO"},
     {AudioChannelLayout::STEREO, "STEREO"},
@@ -144,7 +285,7 @@ const std::vector<std::pair<AudioChannelLayout, std::string_view>> g_ChannelLayo
     {AudioChannelLayout::HOA_ORDER3_FUMA, "HOA_ORDER3_FUMA"},
 };
 
-const std::vector<std::pair<AVColorPrimaries, ColorPrimary>> g_pFfColorPrimariesMap = {
+constexpr std::pair<AVColorPrimaries, ColorPrimary> g_pFfColorPrimariesMap[] = {
     {AVColorPrimaries::AVCOL_PRI_BT709, ColorPrimary::BT709},
     {AVColorPrimaries::AVCOL_PRI_UNSPECIFIED, ColorPrimary::UNSPECIFIED},
     {AVColorPrimaries::AVCOL_PRI_BT470M, ColorPrimary::BT470_M},
@@ -159,7 +300,7 @@ const std::vector<std::pair<AVColorPrimaries, ColorPrimary>> g_pFfColorPrimaries
     {AVColorPrimaries::AVCOL_PRI_SMPTE432, ColorPrimary::P3D65},
 };
 
-const std::vector<std::pair<AVColorTransferCharacteristic, TransferCharacteristic>> g_pFfTransferCharacteristicMap = {
+constexpr std::pair<AVColorTransferCharacteristic, TransferCharacteristic> g_pFfTransferCharacteristicMap[] = {
     {AVColorTransferCharacteristic::AVCOL_TRC_BT709, TransferCharacteristic::BT709},
     {AVColorTransferCharacteristic::AVCOL_TRC_UNSPECIFIED, TransferCharacteristic::UNSPECIFIED},
     {AVColorTransferCharacteristic::AVCOL_TRC_GAMMA22, TransferCharacteristic::GAMMA_2_2},
@@ -181,7 +322,7 @@ const std::vector<std::pair<AVColorTransferCharacteristic, TransferCharacteristi
     {AVColorTransferCharacteristic::AVCOL_TRC_ARIB_STD_B67, TransferCharacteristic::HLG},
 };
 
-const std::vector<std::pair<AVColorSpace, MatrixCoefficient>> g_pFfMatrixCoefficientMap = {
+constexpr std::pair<AVColorSpace, MatrixCoefficient> g_pFfMatrixCoefficientMap[] = {
     {AVColorSpace::AVCOL_SPC_RGB, MatrixCoefficient::IDENTITY},
     {AVColorSpace::AVCOL_SPC_BT709, MatrixCoefficient::BT709},
     {AVColorSpace::AVCOL_SPC_UNSPECIFIED, MatrixCoefficient::UNSPECIFIED},
@@ -199,12 +340,12 @@ const std::vector<std::pair<AVColorSpace, MatrixCoefficient>> g_pFfMatrixCoeffic
     {AVColorSpace::AVCOL_SPC_ICTCP, MatrixCoefficient::ICTCP},
 };
 
-const std::vector<std::pair<AVColorRange, int>> g_pFfColorRangeMap = {
+constexpr std::pair<AVColorRange, int> g_pFfColorRangeMap[] = {
     {AVColorRange::AVCOL_RANGE_MPEG, 0},
     {AVColorRange::AVCOL_RANGE_JPEG, 1},
 };
 
-const std::vector<std::pair<AVChromaLocation, ChromaLocation>> g_pFfChromaLocationMap = {
+constexpr std::pair<AVChromaLocation, ChromaLocation> g_pFfChromaLocationMap[] = {
     {AVChromaLocation::AVCHROMA_LOC_UNSPECIFIED, ChromaLocation::UNSPECIFIED},
     {AVChromaLocation::AVCHROMA_LOC_LEFT, ChromaLocation::LEFT},
     {AVChromaLocation::AVCHROMA_LOC_CENTER, ChromaLocation::CENTER},
@@ -214,13 +355,13 @@ const std::vector<std::pair<AVChromaLocation, ChromaLocation>> g_pFfChromaLocati
     {AVChromaLocation::AVCHROMA_LOC_BOTTOM, ChromaLocation::BOTTOM},
 };
 
-const std::vector<std::pair<int, HEVCProfile>> g_pFfHEVCProfileMap = {
+constexpr std::pair<int, HEVCProfile> g_pFfHEVCProfileMap[] = {
     {FF_PROFILE_HEVC_MAIN, HEVCProfile::HEVC_PROFILE_MAIN},
     {FF_PROFILE_HEVC_MAIN_10, HEVCProfile::HEVC_PROFILE_MAIN_10},
     {FF_PROFILE_HEVC_MAIN_STILL_PICTURE, HEVCProfile::HEVC_PROFILE_MAIN_STILL},
 };
 
-const std::vector<std::pair<int, HEVCLevel>> g_pFfHEVCLevelMap = {
+constexpr std::pair<int, HEVCLevel> g_pFfHEVCLevelMap[] = {
     {30, HEVCLevel::HEVC_LEVEL_1},   {60, HEVCLevel::HEVC_LEVEL_2},  {63, HEVCLevel::HEVC_LEVEL_21},
     {90, HEVCLevel::HEVC_LEVEL_3},   {93, HEVCLevel::HEVC_LEVEL_31}, {120, HEVCLevel::HEVC_LEVEL_4},
     {123, HEVCLevel::HEVC_LEVEL_41}, {150, HEVCLevel::HEVC_LEVEL_5}, {153, HEVCLevel::HEVC_LEVEL_51},
@@ -230,132 +371,120 @@ const std::vector<std::pair<int, HEVCLevel>> g_pFfHEVCLevelMap = {
 
 HEVCLevel FFMpegConverter::ConvertFFMpegToOHHEVCLevel(int ffHEVCLevel)
 {
-    auto ite = std::find_if(g_pFfHEVCLevelMap.begin(), g_pFfHEVCLevelMap.end(),
-                            [&ffHEVCLevel](const auto &item) -> bool { return item.first == ffHEVCLevel; });
-    if (ite == g_pFfHEVCLevelMap.end()) {
+    auto value = DenseLookup<g_pFfHEVCLevelMap>::Find(ffHEVCLevel);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert hevc level failed: " PUBLIC_LOG_D32 "", ffHEVCLevel);
         return HEVCLevel::HEVC_LEVEL_UNKNOW;
     }
-    return ite->second;
+    return *value;
 }
 
 HEVCProfile FFMpegConverter::ConvertFFMpegToOHHEVCProfile(int ffHEVCProfile)
 {
-    auto ite = std::find_if(g_pFfHEVCProfileMap.begin(), g_pFfHEVCProfileMap.end(),
-                            [&ffHEVCProfile](const auto &item) -> bool { return item.first == ffHEVCProfile; });
-    if (ite == g_pFfHEVCProfileMap.end()) {
+    auto value = DenseLookup<g_pFfHEVCProfileMap>::Find(ffHEVCProfile);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert hevc profile failed: " PUBLIC_LOG_D32 "", ffHEVCProfile);
         return HEVCProfile::HEVC_PROFILE_UNKNOW;
     }
-    return ite->second;
+    return *value;
 }
 
 ColorPrimary FFMpegConverter::ConvertFFMpegToOHColorPrimaries(AVColorPrimaries ffColorPrimaries)
 {
-    auto ite = std::find_if(g_pFfColorPrimariesMap.begin(), g_pFfColorPrimariesMap.end(),
-                            [&ffColorPrimaries](const auto &item) -> bool { return item.first == ffColorPrimaries; });
-    if (ite == g_pFfColorPrimariesMap.end()) {
+    auto value = DenseLookup<g_pFfColorPrimariesMap>::Find(ffColorPrimaries);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert color primaries failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(ffColorPrimaries));
         return ColorPrimary::UNSPECIFIED;
     }
-    return ite->second;
+    return *value;
 }
 
 TransferCharacteristic FFMpegConverter::ConvertFFMpegToOHColorTrans(AVColorTransferCharacteristic ffColorTrans)
 {
-    auto ite = std::find_if(g_pFfTransferCharacteristicMap.begin(), g_pFfTransferCharacteristicMap.end(),
-                            [&ffColorTrans](const auto &item) -> bool { return item.first == ffColorTrans; });
-    if (ite == g_pFfTransferCharacteristicMap.end()) {
+    auto value = DenseLookup<g_pFfTransferCharacteristicMap>::Find(ffColorTrans);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert color trans failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(ffColorTrans));
         return TransferCharacteristic::UNSPECIFIED;
     }
-    return ite->second;
+    return *value;
 }
 
 MatrixCoefficient FFMpegConverter::ConvertFFMpegToOHColorMatrix(AVColorSpace ffColorSpace)
 {
-    auto ite = std::find_if(g_pFfMatrixCoefficientMap.begin(), g_pFfMatrixCoefficientMap.end(),
-                            [&ffColorSpace](const auto &item) -> bool { return item.first == ffColorSpace; });
-    if (ite == g_pFfMatrixCoefficientMap.end()) {
+    auto value = DenseLookup<g_pFfMatrixCoefficientMap>::Find(ffColorSpace);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert color matrix failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(ffColorSpace));
         return MatrixCoefficient::UNSPECIFIED;
     }
-    return ite->second;
+    return *value;
 }
 
 int FFMpegConverter::ConvertFFMpegToOHColorRange(AVColorRange ffColorRange)
 {
-    auto ite = std::find_if(g_pFfColorRangeMap.begin(), g_pFfColorRangeMap.end(),
-                            [&ffColorRange](const auto &item) -> bool { return item.first == ffColorRange; });
-    if (ite == g_pFfColorRangeMap.end()) {
+    auto value = DenseLookup<g_pFfColorRangeMap>::Find(ffColorRange);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert color range failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(ffColorRange));
         return 0;
     }
-    return ite->second;
+    return *value;
 }
 
 ChromaLocation FFMpegConverter::ConvertFFMpegToOHChromaLocation(AVChromaLocation ffChromaLocation)
 {
-    auto ite = std::find_if(g_pFfChromaLocationMap.begin(), g_pFfChromaLocationMap.end(),
-                            [&ffChromaLocation](const auto &item) -> bool { return item.first == ffChromaLocation; });
-    if (ite == g_pFfChromaLocationMap.end()) {
+    auto value = DenseLookup<g_pFfChromaLocationMap>::Find(ffChromaLocation);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert chroma location failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(ffChromaLocation));
         return ChromaLocation::UNSPECIFIED;
     }
-    return ite->second;
+    return *value;
 }
 
 AudioSampleFormat FFMpegConverter::ConvertFFMpegAVCodecIdToOHAudioFormat(AVCodecID codecId)
 {
-    auto ite = std::find_if(g_pFfCodeIDToSampleFmtMap.begin(), g_pFfCodeIDToSampleFmtMap.end(),
-                            [&codecId](const auto &item) -> bool { return item.first == codecId; });
-    if (ite == g_pFfCodeIDToSampleFmtMap.end()) {
+    auto value = DenseLookup<g_pFfCodeIDToSampleFmtMap>::Find(codecId);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert codec id failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(codecId));
         return AudioSampleFormat::INVALID_WIDTH;
     }
-    return ite->second;
+    return *value;
 }
 
 AudioSampleFormat FFMpegConverter::ConvertFFMpegToOHAudioFormat(AVSampleFormat ffSampleFormat)
 {
-    auto ite = std::find_if(g_pFfSampleFmtMap.begin(), g_pFfSampleFmtMap.end(),
-                            [&ffSampleFormat](const auto &item) -> bool { return item.first == ffSampleFormat; });
-    if (ite == g_pFfSampleFmtMap.end()) {
+    auto value = DenseLookup<g_pFfSampleFmtMap>::Find(ffSampleFormat);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert sample format failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(ffSampleFormat));
         return AudioSampleFormat::INVALID_WIDTH;
     }
-    return ite->second;
+    return *value;
 }
 
 AVSampleFormat FFMpegConverter::ConvertOHAudioFormatToFFMpeg(AudioSampleFormat sampleFormat)
 {
-    auto ite = std::find_if(g_pFfSampleFmtMap.begin(), g_pFfSampleFmtMap.end(),
-                            [&sampleFormat](const auto &item) -> bool { return item.second == sampleFormat; });
-    if (ite == g_pFfSampleFmtMap.end()) {
+    auto value = DenseLookup<g_pFfSampleFmtMap, true>::Find(sampleFormat);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert sample format failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(sampleFormat));
         return AVSampleFormat::AV_SAMPLE_FMT_NONE;
     }
-    return ite->first;
+    return *value;
 }
 
 AudioChannelLayout FFMpegConverter::ConvertFFToOHAudioChannelLayout(uint64_t ffChannelLayout)
 {
-    auto ite = std::find_if(g_toFFMPEGChannelLayout.begin(), g_toFFMPEGChannelLayout.end(),
-                            [&ffChannelLayout](const auto &item) -> bool { return item.second == ffChannelLayout; });
-    if (ite == g_toFFMPEGChannelLayout.end()) {
+    auto value = HashLookup<g_toFFMPEGChannelLayout, true>::Find(ffChannelLayout);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert channel layout failed: " PUBLIC_LOG_U64, ffChannelLayout);
         return AudioChannelLayout::MONO;
     }
-    return ite->first;
+    return *value;
 }
 
 AudioChannelLayout FFMpegConverter::GetDefaultChannelLayout(int channels)
 {
     AudioChannelLayout layout = AudioChannelLayout::MONO;
-    auto ite = std::find_if(g_channelLayoutDefaukltMap.begin(), g_channelLayoutDefaukltMap.end(),
-                            [&channels](const auto &item) -> bool { return item.first == channels; });
-    if (ite != g_channelLayoutDefaukltMap.end()) {
-        layout = ite->second;
+    auto value = DenseLookup<g_channelLayoutDefaukltMap>::Find(channels);
+    if (value != nullptr) {
+        layout = *value;
     }
     MEDIA_LOG_W("Get default channel layout: " PUBLIC_LOG_S "", ConvertOHAudioChannelLayoutToString(layout).data());
     return layout;
@@ -363,35 +492,32 @@ AudioChannelLayout FFMpegConverter::GetDefaultChannelLayout(int channels)
 
 AudioChannelLayout FFMpegConverter::ConvertFFToOHAudioChannelLayoutV2(uint64_t ffChannelLayout, int channels)
 {
-    auto ite = std::find_if(g_toFFMPEGChannelLayout.begin(), g_toFFMPEGChannelLayout.end(),
-                            [&ffChannelLayout](const auto &item) -> bool { return item.second == ffChannelLayout; });
-    if (ite == g_toFFMPEGChannelLayout.end()) {
+    auto value = HashLookup<g_toFFMPEGChannelLayout, true>::Find(ffChannelLayout);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert channel layout failed: " PUBLIC_LOG_U64, ffChannelLayout);
         return GetDefaultChannelLayout(channels);
     }
-    return ite->first;
+    return *value;
 }
 
 uint64_t FFMpegConverter::ConvertOHAudioChannelLayoutToFFMpeg(AudioChannelLayout channelLayout)
 {
-    auto ite = std::find_if(g_toFFMPEGChannelLayout.begin(), g_toFFMPEGChannelLayout.end(),
-                            [&channelLayout](const auto &item) -> bool { return item.first == channelLayout; });
-    if (ite == g_toFFMPEGChannelLayout.end()) {
+    auto value = HashLookup<g_toFFMPEGChannelLayout>::Find(channelLayout);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert channel layout failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(channelLayout));
         return AV_CH_LAYOUT_NATIVE;
     }
-    return ite->second;
+    return *value;
 }
 
 std::string_view FFMpegConverter::ConvertOHAudioChannelLayoutToString(AudioChannelLayout layout)
 {
-    auto ite = std::find_if(g_ChannelLayoutToString.begin(), g_ChannelLayoutToString.end(),
-                            [&layout](const auto &item) -> bool { return item.first == layout; });
-    if (ite == g_ChannelLayoutToString.end()) {
+    auto value = HashLookup<g_ChannelLayoutToString>::Find(layout);
+    if (value == nullptr) {
         MEDIA_LOG_W("Convert channel layout failed: " PUBLIC_LOG_D32 "", static_cast<int32_t>(layout));
         return g_ChannelLayoutToString[0].second;
     }
-    return ite->second;
+    return *value;
 }
 
 int64_t FFMpegConverter::ConvertAudioPtsToUs(int64_t pts, AVRational base)
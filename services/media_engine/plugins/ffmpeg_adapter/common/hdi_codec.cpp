@@ -13,7 +13,9 @@
  * limitations under the License.
  */
 #include "hdi_codec.h"
+#include <algorithm>
 #include "avcodec_log.h"
+#include "OMX_Component.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_AUDIO, "AvCodec-HdiCodec"};
@@ -31,16 +33,20 @@ HdiCodec::HdiCodec()
       compCb_(nullptr),
       compNode_(nullptr),
       compMgr_(nullptr),
-      outputOmxBuffer_(nullptr),
-      omxInBufferInfo_(std::make_shared<OmxBufferInfo>()),
-      omxOutBufferInfo_(std::make_shared<OmxBufferInfo>()),
       event_(CODEC_EVENT_ERROR)
 {
 }
 
+HdiCodec::HdiCodec(const sptr<ICodecComponentManager> &compMgr) : HdiCodec()
+{
+    compMgr_ = compMgr;
+}
+
 Status HdiCodec::InitComponent(const std::string &name)
 {
-    compMgr_ = GetComponentManager();
+    if (compMgr_ == nullptr) {
+        compMgr_ = GetComponentManager();
+    }
     if (compMgr_ == nullptr) {
         AVCODEC_LOGE("GetCodecComponentManager failed!");
         return Status::ERROR_NULL_POINTER;
@@ -146,21 +152,63 @@ Status HdiCodec::SetParameter(uint32_t index, const std::vector<int8_t> &paramVe
     return Status::OK;
 }
 
-Status HdiCodec::InitBuffers(uint32_t bufferSize)
+Status HdiCodec::InitBuffers(uint32_t bufferSize, uint32_t bufferCount)
+{
+    FreeBuffers();
+    for (PortIndex portIndex : {PortIndex::INPUT_PORT, PortIndex::OUTPUT_PORT}) {
+        uint32_t count = bufferCount > 0 ? bufferCount : GetPortBufferCount(portIndex);
+        for (uint32_t i = 0; i < count; i++) {
+            Status ret = InitBuffersByPort(portIndex, bufferSize);
+            if (ret != Status::OK) {
+                AVCODEC_LOGE("Init %{public}s Buffers failed, ret=%{public}d",
+                    portIndex == PortIndex::INPUT_PORT ? "Input" : "Output", ret);
+                return ret;
+            }
+        }
+    }
+    return Status::OK;
+}
+
+uint32_t HdiCodec::GetPortBufferCount(PortIndex portIndex)
 {
-    Status ret = InitBuffersByPort(PortIndex::INPUT_PORT, bufferSize);
-    if (ret != Status::OK) {
-        AVCODEC_LOGE("Init Input Buffers failed, ret=%{public}d", ret);
-        return ret;
+    OMX_PARAM_PORTDEFINITIONTYPE def;
+    (void)memset_s(&def, sizeof(def), 0x0, sizeof(def));
+    def.nSize = sizeof(def);
+    def.nVersion.s.nVersionMajor = 1;
+    def.nPortIndex = static_cast<uint32_t>(portIndex);
+    int8_t *p = reinterpret_cast<int8_t *>(&def);
+    std::vector<int8_t> inParamVec(p, p + sizeof(def));
+    std::vector<int8_t> outParamVec;
+    int32_t ret = compNode_->GetParameter(OMX_IndexParamPortDefinition, inParamVec, outParamVec);
+    if (ret != HDF_SUCCESS || outParamVec.size() != sizeof(def) ||
+        memcpy_s(&def, sizeof(def), outParamVec.data(), outParamVec.size()) != EOK || def.nBufferCountActual == 0) {
+        AVCODEC_LOGW("no buffer count for port %{public}u, use %{public}u", def.nPortIndex, DEFAULT_BUFFER_COUNT);
+        return DEFAULT_BUFFER_COUNT;
     }
+    AVCODEC_LOGI("port %{public}u uses %{public}u buffers", def.nPortIndex, def.nBufferCountActual);
+    return def.nBufferCountActual;
+}
+
+void HdiCodec::SetBufferDoneCallback(BufferDoneCallback callback)
+{
+    std::lock_guard lock(deliverMutex_);
+    bufferDoneCallback_ = std::move(callback);
+}
 
-    ret = InitBuffersByPort(PortIndex::OUTPUT_PORT, bufferSize);
-    if (ret != Status::OK) {
-        AVCODEC_LOGE("Init Output Buffers failed, ret=%{public}d", ret);
-        return ret;
+void HdiCodec::GetInputBuffers(std::vector<std::shared_ptr<AVBuffer>> &buffers)
+{
+    std::lock_guard lock(bufferMutex_);
+    for (const auto &info : omxInBuffers_) {
+        buffers.push_back(info->avBuffer);
     }
+}
 
-    return Status::OK;
+void HdiCodec::GetOutputBuffers(std::vector<std::shared_ptr<AVBuffer>> &buffers)
+{
+    std::lock_guard lock(bufferMutex_);
+    for (const auto &info : omxOutBuffers_) {
+        buffers.push_back(info->avBuffer);
+    }
 }
 
 Status HdiCodec::InitBuffersByPort(PortIndex portIndex, uint32_t bufferSize)
@@ -192,12 +240,14 @@ Status HdiCodec::InitBuffersByPort(PortIndex portIndex, uint32_t bufferSize)
     }
 
     omxBuffer->bufferId = outBuffer.bufferId;
+    auto info = std::make_shared<OmxBufferInfo>();
+    info->omxBuffer = omxBuffer;
+    info->avBuffer = avBuffer;
+    std::lock_guard lock(bufferMutex_);
     if (portIndex == PortIndex::INPUT_PORT) {
-        omxInBufferInfo_->omxBuffer = omxBuffer;
-        omxInBufferInfo_->avBuffer = avBuffer;
+        omxInBuffers_.push_back(info);
     } else if (portIndex == PortIndex::OUTPUT_PORT) {
-        omxOutBufferInfo_->omxBuffer = omxBuffer;
-        omxOutBufferInfo_->avBuffer = avBuffer;
+        omxOutBuffers_.push_back(info);
     }
 
     return Status::OK;
@@ -205,6 +255,10 @@ Status HdiCodec::InitBuffersByPort(PortIndex portIndex, uint32_t bufferSize)
 
 Status HdiCodec::SendCommand(CodecCommandType cmd, uint32_t param)
 {
+    if (cmd == CODEC_COMMAND_STATE_SET) {
+        std::lock_guard bufferLock(bufferMutex_);
+        isExecuting_ = param == CODEC_STATE_EXECUTING;
+    }
     std::unique_lock lock(mutex_);
     event_ = CODEC_EVENT_ERROR;
     int32_t ret = compNode_->SendCommand(cmd, param, {});
@@ -224,58 +278,145 @@ Status HdiCodec::SendCommand(CodecCommandType cmd, uint32_t param)
 
 Status HdiCodec::EmptyThisBuffer(const std::shared_ptr<AVBuffer> &buffer)
 {
-    omxInBufferInfo_->omxBuffer->filledLen = static_cast<uint32_t>(buffer->memory_->GetSize());
-    omxInBufferInfo_->omxBuffer->offset = static_cast<uint32_t>(buffer->memory_->GetOffset());
-    omxInBufferInfo_->omxBuffer->pts = buffer->pts_;
-    omxInBufferInfo_->omxBuffer->flag = buffer->flag_;
-
-    errno_t rc = memcpy_s(omxInBufferInfo_->avBuffer->memory_->GetAddr(), omxInBufferInfo_->omxBuffer->filledLen,
-                          buffer->memory_->GetAddr(), omxInBufferInfo_->omxBuffer->filledLen);
-    if (rc != EOK) {
-        AVCODEC_LOGE("memory copy failed!");
-        return Status::ERROR_INVALID_DATA;
+    std::unique_lock lock(bufferMutex_);
+    std::shared_ptr<OmxBufferInfo> info = FindBuffer(omxInBuffers_, buffer);
+    bool isCopy = info == nullptr;
+    if (isCopy) {
+        info = WaitFreeBuffer(lock, omxInBuffers_);
+        if (info == nullptr) {
+            AVCODEC_LOGE("no free input buffer!");
+            return Status::ERROR_AGAIN;
+        }
+        Status ret = CopyIn(buffer, info);
+        if (ret != Status::OK) {
+            return ret;
+        }
+    } else if (info->inFlight) {
+        AVCODEC_LOGE("input buffer is still owned by the component!");
+        return Status::ERROR_INVALID_OPERATION;
     }
-
-    int32_t ret = compNode_->EmptyThisBuffer(*omxInBufferInfo_->omxBuffer.get());
+    OmxCodecBuffer &omxBuffer = *info->omxBuffer.get();
+    omxBuffer.filledLen = static_cast<uint32_t>(buffer->memory_->GetSize());
+    omxBuffer.offset = isCopy ? 0 : static_cast<uint32_t>(buffer->memory_->GetOffset());
+    omxBuffer.pts = buffer->pts_;
+    omxBuffer.flag = buffer->flag_;
+    info->owner = isCopy ? nullptr : buffer;
+    info->inFlight = true;
+    inFlightInputs_++;
+    OmxCodecBuffer request = omxBuffer;
+    // EmptyBufferDone may arrive before the call returns
+    lock.unlock();
+
+    int32_t ret = compNode_->EmptyThisBuffer(request);
     if (ret != HDF_SUCCESS) {
         AVCODEC_LOGE("EmptyThisBuffer failed, ret=%{public}d", ret);
+        lock.lock();
+        info->owner = nullptr;
+        info->inFlight = false;
+        inFlightInputs_--;
+        bufferCond_.notify_all();
         return Status::ERROR_INVALID_DATA;
     }
+    if (isCopy) {
+        std::lock_guard deliverLock(deliverMutex_);
+        if (bufferDoneCallback_) {
+            bufferDoneCallback_(PortIndex::INPUT_PORT, buffer);
+        }
+    }
     AVCODEC_LOGD("EmptyThisBuffer OK");
     return Status::OK;
 }
 
-Status HdiCodec::FillThisBuffer(std::shared_ptr<AVBuffer> &buffer)
+Status HdiCodec::CopyIn(const std::shared_ptr<AVBuffer> &buffer, const std::shared_ptr<OmxBufferInfo> &info)
 {
-    std::unique_lock lock(mutex_);
-    outputOmxBuffer_ = nullptr;
-    int32_t ret = compNode_->FillThisBuffer(*omxOutBufferInfo_->omxBuffer.get());
-    if (ret != HDF_SUCCESS) {
+    int32_t size = buffer->memory_->GetSize();
+    int32_t capacity = info->avBuffer->memory_->GetCapacity();
+    if (size < 0 || size > capacity) {
+        AVCODEC_LOGE("input size %{public}d exceeds the buffer capacity %{public}d", size, capacity);
         return Status::ERROR_INVALID_DATA;
     }
-    condition_.wait_for(lock, std::chrono::milliseconds(TIMEOUT_MS), [this] { return outputOmxBuffer_ != nullptr; });
-    
-    if (outputOmxBuffer_ == nullptr) {
-        AVCODEC_LOGE("FillThisBuffer timeout!");
-        return Status::ERROR_INVALID_PARAMETER;
+    if (size == 0) {
+        return Status::OK;
     }
-
-    errno_t rc = memcpy_s(buffer->memory_->GetAddr(), outputOmxBuffer_->filledLen,
-                          omxOutBufferInfo_->avBuffer->memory_->GetAddr(), outputOmxBuffer_->filledLen);
+    errno_t rc = memcpy_s(info->avBuffer->memory_->GetAddr(), capacity, buffer->memory_->GetAddr(), size);
     if (rc != EOK) {
         AVCODEC_LOGE("memory copy failed!");
         return Status::ERROR_INVALID_DATA;
     }
+    return Status::OK;
+}
 
-    buffer->memory_->SetSize(outputOmxBuffer_->filledLen);
-    buffer->memory_->SetOffset(outputOmxBuffer_->offset);
-    buffer->pts_ = outputOmxBuffer_->pts;
-    buffer->flag_ = outputOmxBuffer_->flag;
-
+Status HdiCodec::FillThisBuffer(std::shared_ptr<AVBuffer> &buffer)
+{
+    std::unique_lock lock(bufferMutex_);
+    std::shared_ptr<OmxBufferInfo> info = FindBuffer(omxOutBuffers_, buffer);
+    if (info == nullptr) {
+        info = WaitFreeBuffer(lock, omxOutBuffers_);
+        if (info == nullptr) {
+            AVCODEC_LOGE("no free output buffer!");
+            return Status::ERROR_AGAIN;
+        }
+    } else if (info->inFlight) {
+        AVCODEC_LOGE("output buffer is still owned by the component!");
+        return Status::ERROR_INVALID_OPERATION;
+    }
+    OmxCodecBuffer &omxBuffer = *info->omxBuffer.get();
+    omxBuffer.filledLen = 0;
+    omxBuffer.offset = 0;
+    omxBuffer.flag = 0;
+    info->owner = buffer;
+    info->inFlight = true;
+    OmxCodecBuffer request = omxBuffer;
+    lock.unlock();
+
+    int32_t ret = compNode_->FillThisBuffer(request);
+    if (ret != HDF_SUCCESS) {
+        AVCODEC_LOGE("FillThisBuffer failed, ret=%{public}d", ret);
+        lock.lock();
+        info->owner = nullptr;
+        info->inFlight = false;
+        bufferCond_.notify_all();
+        return Status::ERROR_INVALID_DATA;
+    }
     AVCODEC_LOGD("FillThisBuffer OK");
     return Status::OK;
 }
 
+Status HdiCodec::WaitForInputDone()
+{
+    std::unique_lock lock(bufferMutex_);
+    bool done = bufferCond_.wait_for(lock, std::chrono::milliseconds(TIMEOUT_MS),
+        [this] { return inFlightInputs_ == 0 && pendingDeliveries_ == 0; });
+    if (!done) {
+        AVCODEC_LOGE("WaitForInputDone timeout, %{public}u input buffers in flight", inFlightInputs_);
+        return Status::ERROR_UNKNOWN;
+    }
+    return Status::OK;
+}
+
+std::shared_ptr<HdiCodec::OmxBufferInfo> HdiCodec::FindBuffer(const BufferList &buffers,
+    const std::shared_ptr<AVBuffer> &buffer)
+{
+    for (const auto &info : buffers) {
+        if (info->avBuffer == buffer) {
+            return info;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<HdiCodec::OmxBufferInfo> HdiCodec::WaitFreeBuffer(std::unique_lock<std::mutex> &lock,
+    const BufferList &buffers)
+{
+    std::shared_ptr<OmxBufferInfo> freeBuffer = nullptr;
+    bufferCond_.wait_for(lock, std::chrono::milliseconds(TIMEOUT_MS), [&buffers, &freeBuffer] {
+        auto it = std::find_if(buffers.begin(), buffers.end(), [](const auto &info) { return !info->inFlight; });
+        freeBuffer = it == buffers.end() ? nullptr : *it;
+        return freeBuffer != nullptr;
+    });
+    return freeBuffer;
+}
+
 Status HdiCodec::FreeBuffer(PortIndex portIndex, const std::shared_ptr<OmxCodecBuffer> &omxBuffer)
 {
     if (omxBuffer != nullptr) {
@@ -300,32 +441,137 @@ Status HdiCodec::OnEventHandler(CodecEventType event, const EventInfo &info)
 
 Status HdiCodec::OnEmptyBufferDone(const OmxCodecBuffer &buffer)
 {
-    return Status::OK;
+    return OnBufferDone(PortIndex::INPUT_PORT, buffer);
 }
 
 Status HdiCodec::OnFillBufferDone(const OmxCodecBuffer &buffer)
 {
-    std::unique_lock lock(mutex_);
-    outputOmxBuffer_ = std::make_shared<OmxCodecBuffer>(buffer);
-    condition_.notify_all();
+    return OnBufferDone(PortIndex::OUTPUT_PORT, buffer);
+}
+
+Status HdiCodec::OnBufferDone(PortIndex portIndex, const OmxCodecBuffer &buffer)
+{
+    {
+        std::lock_guard lock(bufferMutex_);
+        completions_.push_back({portIndex, buffer});
+        pendingDeliveries_++;
+    }
+    DeliverCompletions();
     return Status::OK;
 }
 
+void HdiCodec::DeliverCompletions()
+{
+    std::vector<std::shared_ptr<AVBuffer>> recycled;
+    {
+        std::lock_guard deliverLock(deliverMutex_);
+        for (;;) {
+            PortIndex portIndex;
+            std::shared_ptr<AVBuffer> owner = nullptr;
+            bool isRecycled = false;
+            {
+                std::lock_guard lock(bufferMutex_);
+                if (completions_.empty()) {
+                    break;
+                }
+                Completion completion = completions_.front();
+                completions_.pop_front();
+                portIndex = completion.portIndex;
+                owner = Complete(completion, isRecycled);
+            }
+            if (isRecycled) {
+                recycled.push_back(owner);
+            } else if (owner != nullptr && bufferDoneCallback_) {
+                bufferDoneCallback_(portIndex, owner);
+            }
+            std::lock_guard lock(bufferMutex_);
+            pendingDeliveries_--;
+            bufferCond_.notify_all();
+        }
+    }
+    // the component may complete a buffer inside FillThisBuffer, so no delivery is in progress here
+    for (auto &buffer : recycled) {
+        if (FillThisBuffer(buffer) != Status::OK) {
+            AVCODEC_LOGE("refill of an empty output failed");
+        }
+    }
+}
+
+std::shared_ptr<AVBuffer> HdiCodec::Complete(const Completion &completion, bool &isRecycled)
+{
+    const BufferList &buffers = completion.portIndex == PortIndex::INPUT_PORT ? omxInBuffers_ : omxOutBuffers_;
+    auto it = std::find_if(buffers.begin(), buffers.end(), [&completion](const auto &info) {
+        return info->inFlight && info->omxBuffer->bufferId == completion.buffer.bufferId;
+    });
+    if (it == buffers.end()) {
+        AVCODEC_LOGW("unknown buffer %{public}u returned", completion.buffer.bufferId);
+        return nullptr;
+    }
+    std::shared_ptr<OmxBufferInfo> info = *it;
+    std::shared_ptr<AVBuffer> owner = info->owner;
+    info->owner = nullptr;
+    info->inFlight = false;
+    if (completion.portIndex == PortIndex::INPUT_PORT) {
+        inFlightInputs_--;
+        return owner;
+    }
+    if (owner == nullptr) {
+        return owner;
+    }
+    // buffers returned by a flush come back empty, the caller has nothing to read from them. Leaving EXECUTING the
+    // component returns every buffer and must keep them.
+    const OmxCodecBuffer &omxBuffer = completion.buffer;
+    if (isExecuting_ && omxBuffer.filledLen == 0 && (omxBuffer.flag & OMX_BUFFERFLAG_EOS) == 0) {
+        isRecycled = true;
+        return owner;
+    }
+    uint32_t offset = omxBuffer.offset;
+    if (owner != info->avBuffer && omxBuffer.filledLen > 0) {
+        errno_t rc = memcpy_s(owner->memory_->GetAddr(), owner->memory_->GetCapacity(),
+            info->avBuffer->memory_->GetAddr() + offset, omxBuffer.filledLen);
+        if (rc != EOK) {
+            AVCODEC_LOGE("memory copy failed!");
+        }
+        offset = 0;
+    }
+    owner->memory_->SetSize(omxBuffer.filledLen);
+    owner->memory_->SetOffset(offset);
+    owner->pts_ = omxBuffer.pts;
+    owner->flag_ = omxBuffer.flag;
+    return owner;
+}
+
+void HdiCodec::FreeBuffers()
+{
+    BufferList inBuffers;
+    BufferList outBuffers;
+    {
+        std::lock_guard lock(bufferMutex_);
+        inBuffers.swap(omxInBuffers_);
+        outBuffers.swap(omxOutBuffers_);
+        inFlightInputs_ = 0;
+        bufferCond_.notify_all();
+    }
+    if (compNode_ == nullptr) {
+        return;
+    }
+    for (const auto &info : inBuffers) {
+        FreeBuffer(PortIndex::INPUT_PORT, info->omxBuffer);
+    }
+    for (const auto &info : outBuffers) {
+        FreeBuffer(PortIndex::OUTPUT_PORT, info->omxBuffer);
+    }
+}
+
 Status HdiCodec::Reset()
 {
-    FreeBuffer(PortIndex::INPUT_PORT, omxInBufferInfo_->omxBuffer);
-    FreeBuffer(PortIndex::OUTPUT_PORT, omxOutBufferInfo_->omxBuffer);
-    omxInBufferInfo_->Reset();
-    omxOutBufferInfo_->Reset();
+    FreeBuffers();
     return Status::OK;
 }
 
 void HdiCodec::Release()
 {
-    FreeBuffer(PortIndex::INPUT_PORT, omxInBufferInfo_->omxBuffer);
-    FreeBuffer(PortIndex::OUTPUT_PORT, omxOutBufferInfo_->omxBuffer);
-    omxInBufferInfo_->Reset();
-    omxOutBufferInfo_->Reset();
+    FreeBuffers();
     
     if (compMgr_ != nullptr && componentId_ > 0) {
         compMgr_->DestroyComponent(componentId_);
@@ -15,7 +15,10 @@
 #ifndef HDI_CODEC_H
 #define HDI_CODEC_H
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <mutex>
+#include <vector>
 #include "buffer/avbuffer.h"
 #include "v3_0/codec_ext_types.h"
 #include "v3_0/icodec_component_manager.h"
@@ -44,15 +47,30 @@ struct AudioCodecOmxParam {
     uint32_t reserved;
 };
 
+/**
+ * Drives an OMX audio component through the codec HDI.
+ *
+ * Every port owns several shared memory buffers registered with UseBuffer, handing them out through
+ * GetInputBuffers and GetOutputBuffers lets the caller fill and read them in place. Buffers stay with the component
+ * until its EmptyBufferDone or FillBufferDone, those callbacks queue completions that reach the BufferDoneCallback
+ * in order. Buffers the component does not know are copied into and out of a free registered one. Outputs that
+ * come back empty, as a flush returns them, are handed to the component again instead of to the callback.
+ */
 class HdiCodec : public std::enable_shared_from_this<HdiCodec> {
 public:
     enum class PortIndex : uint32_t {
         INPUT_PORT = 0,
         OUTPUT_PORT = 1
     };
+    // Called from the HDI callback thread, and for copied input buffers from EmptyThisBuffer itself
+    using BufferDoneCallback = std::function<void(PortIndex portIndex, const std::shared_ptr<AVBuffer> &buffer)>;
+    static constexpr uint32_t DEFAULT_BUFFER_COUNT = 4;
 
     HdiCodec();
 
+    // Uses the given component manager instead of the HDI service, so the codec can run against a mock
+    explicit HdiCodec(const sptr<ICodecComponentManager> &compMgr);
+
     Status InitComponent(const std::string &name);
 
     bool IsSupportCodecType(const std::string &name);
@@ -63,7 +81,15 @@ public:
 
     Status SetParameter(uint32_t index, const std::vector<int8_t> &paramVec);
 
-    Status InitBuffers(uint32_t bufferSize);
+    // bufferCount 0 registers as many buffers as each port definition asks for, DEFAULT_BUFFER_COUNT when the
+    // component does not tell
+    Status InitBuffers(uint32_t bufferSize, uint32_t bufferCount = 0);
+
+    void SetBufferDoneCallback(BufferDoneCallback callback);
+
+    void GetInputBuffers(std::vector<std::shared_ptr<AVBuffer>> &buffers);
+
+    void GetOutputBuffers(std::vector<std::shared_ptr<AVBuffer>> &buffers);
 
     Status SendCommand(CodecCommandType cmd, uint32_t param);
 
@@ -71,6 +97,9 @@ public:
 
     Status FillThisBuffer(std::shared_ptr<AVBuffer> &buffer);
 
+    // Waits until the component consumed every queued input and the completions reached the callback
+    Status WaitForInputDone();
+
     Status OnEventHandler(CodecEventType event, const EventInfo &info);
 
     Status OnEmptyBufferDone(const OmxCodecBuffer &buffer);
@@ -95,38 +124,70 @@ public:
 private:
     sptr<ICodecComponentManager> GetComponentManager();
     std::vector<CodecCompCapability> GetCapabilityList();
+    uint32_t GetPortBufferCount(PortIndex portIndex);
     Status InitBuffersByPort(PortIndex portIndex, uint32_t bufferSize);
     Status FreeBuffer(PortIndex portIndex, const std::shared_ptr<OmxCodecBuffer> &omxBuffer);
+    void FreeBuffers();
+    Status OnBufferDone(PortIndex portIndex, const OmxCodecBuffer &buffer);
+    void DeliverCompletions();
 
 private:
     struct OmxBufferInfo {
         std::shared_ptr<OmxCodecBuffer> omxBuffer = nullptr;
         std::shared_ptr<AVBuffer> avBuffer = nullptr;
+        // the buffer reported back when the component is done, avBuffer itself unless the data was copied
+        std::shared_ptr<AVBuffer> owner = nullptr;
+        bool inFlight = false;
 
         ~OmxBufferInfo()
         {
             omxBuffer = nullptr;
             avBuffer = nullptr;
+            owner = nullptr;
         }
 
         void Reset()
         {
             omxBuffer = nullptr;
             avBuffer = nullptr;
+            owner = nullptr;
+            inFlight = false;
         }
     };
+    struct Completion {
+        PortIndex portIndex;
+        OmxCodecBuffer buffer;
+    };
+    using BufferList = std::vector<std::shared_ptr<OmxBufferInfo>>;
+
+    static std::shared_ptr<OmxBufferInfo> FindBuffer(const BufferList &buffers,
+        const std::shared_ptr<AVBuffer> &buffer);
+    std::shared_ptr<OmxBufferInfo> WaitFreeBuffer(std::unique_lock<std::mutex> &lock, const BufferList &buffers);
+    // isRecycled tells an empty output that has to go back to the component instead of to the callback
+    std::shared_ptr<AVBuffer> Complete(const Completion &completion, bool &isRecycled);
+    Status CopyIn(const std::shared_ptr<AVBuffer> &buffer, const std::shared_ptr<OmxBufferInfo> &info);
 
     uint32_t componentId_;
     std::string componentName_;
     sptr<ICodecCallback> compCb_;
     sptr<ICodecComponent> compNode_;
     sptr<ICodecComponentManager> compMgr_;
-    std::shared_ptr<OmxCodecBuffer> outputOmxBuffer_;
-    std::shared_ptr<OmxBufferInfo> omxInBufferInfo_;
-    std::shared_ptr<OmxBufferInfo> omxOutBufferInfo_;
+    BufferList omxInBuffers_;
+    BufferList omxOutBuffers_;
     CodecEventType event_;
     std::mutex mutex_;
     std::condition_variable condition_;
+    // guards the buffer lists and completions_, bufferCond_ signals returned buffers
+    std::mutex bufferMutex_;
+    std::condition_variable bufferCond_;
+    std::deque<Completion> completions_;
+    uint32_t inFlightInputs_ {0};
+    uint32_t pendingDeliveries_ {0};
+    // set by the last state command, empty outputs are refilled only while executing
+    bool isExecuting_ {false};
+    // one thread delivers at a time, so completions reach the callback in the order the component sent them
+    std::mutex deliverMutex_;
+    BufferDoneCallback bufferDoneCallback_;
 };
 } // namespace Hdi
 } // namespace Plugins
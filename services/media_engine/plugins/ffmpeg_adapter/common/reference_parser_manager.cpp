@@ -16,8 +16,8 @@
 #define HST_LOG_TAG "ReferenceParserManager"
 
 #include <unistd.h>
-#include <dlfcn.h>
 #include "common/log.h"
+#include "library_cache.h"
 #include "reference_parser_manager.h"
 
 namespace {
@@ -28,10 +28,7 @@ constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_DEMUXER, "Hi
 namespace OHOS {
 namespace Media {
 namespace Plugins {
-void *ReferenceParserManager::handler_ = nullptr;
-ReferenceParserManager::CreateFunc ReferenceParserManager::createFunc_ = nullptr;
-ReferenceParserManager::DestroyFunc ReferenceParserManager::destroyFunc_ = nullptr;
-std::mutex ReferenceParserManager::mtx_;
+using MediaAVCodec::LibraryCache;
 
 ReferenceParserManager::~ReferenceParserManager()
 {
@@ -39,17 +36,20 @@ ReferenceParserManager::~ReferenceParserManager()
         destroyFunc_(referenceParser_);
         referenceParser_ = nullptr;
     }
+    if (libraryAcquired_) {
+        LibraryCache::GetInstance().Release(REFERENCE_LIB_PATH);
+    }
 }
 
 bool ReferenceParserManager::Init()
 {
-    std::lock_guard<std::mutex> lock(mtx_);
-    if (!handler_) {
-        if (!CheckSymbol(LoadPluginFile(REFERENCE_LIB_PATH))) {
-            MEDIA_LOG_E("Load Reference parser so fail");
-            return false;
-        }
-    }
+    LibraryCache &cache = LibraryCache::GetInstance();
+    FALSE_RETURN_V_MSG_E(cache.Acquire(REFERENCE_LIB_PATH) != nullptr, false, "Load Reference parser so fail");
+    libraryAcquired_ = true;
+    createFunc_ = reinterpret_cast<CreateFunc>(cache.GetSymbol(REFERENCE_LIB_PATH, "CreateRefParser"));
+    destroyFunc_ = reinterpret_cast<DestroyFunc>(cache.GetSymbol(REFERENCE_LIB_PATH, "DestroyRefParser"));
+    FALSE_RETURN_V_MSG_E(createFunc_ != nullptr && destroyFunc_ != nullptr, false,
+        "Load Reference parser symbol fail");
     return true;
 }
 
@@ -104,36 +104,6 @@ Status ReferenceParserManager::GetGopLayerInfo(uint32_t gopId, GopLayerInfo &gop
     return referenceParser_->GetGopLayerInfo(gopId, gopLayerInfo);
 }
 
-void *ReferenceParserManager::LoadPluginFile(const std::string &path)
-{
-    FALSE_RETURN_V_MSG_E(path.length() > 0, nullptr, "path is invalid.");
-    auto ptr = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
-    if (ptr == nullptr) {
-        MEDIA_LOG_E("dlopen failed due to %{public}s", ::dlerror());
-    }
-    handler_ = ptr;
-    return ptr;
-}
-
-bool ReferenceParserManager::CheckSymbol(void *handler)
-{
-    if (handler) {
-        std::string createFuncName = "CreateRefParser";
-        std::string destroyFuncName = "DestroyRefParser";
-        CreateFunc createFunc = nullptr;
-        DestroyFunc destroyFunc = nullptr;
-        createFunc = (CreateFunc)(::dlsym(handler, createFuncName.c_str()));
-        destroyFunc = (DestroyFunc)(::dlsym(handler, destroyFuncName.c_str()));
-        if (createFunc && destroyFunc) {
-            MEDIA_LOG_D("CheckSymbol:  createFuncName %{public}s", createFuncName.c_str());
-            MEDIA_LOG_D("CheckSymbol:  destroyFuncName %{public}s", destroyFuncName.c_str());
-            createFunc_ = createFunc;
-            destroyFunc_ = destroyFunc;
-            return true;
-        }
-    }
-    return false;
-}
 } // namespace Plugins
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
@@ -28,7 +28,6 @@ public:
     ReferenceParserManager(const ReferenceParserManager &) = delete;
     ReferenceParserManager operator=(const ReferenceParserManager &) = delete;
     ~ReferenceParserManager();
-    static bool Init();
 
     Status ParserNalUnits(uint8_t *nalData, int32_t nalDataSize, uint32_t frameId, int64_t dts);
     Status ParserExtraData(uint8_t *extraData, int32_t extraDataSize);
@@ -38,16 +37,15 @@ public:
     Status GetGopLayerInfo(uint32_t gopId, GopLayerInfo &gopLayerInfo);
     
 private:
-    RefParser *referenceParser_ {nullptr};
-    // .so initialize
-    static void *handler_;
-    static void *LoadPluginFile(const std::string &path);
-    static bool CheckSymbol(void *handler);
+    // takes a reference on the parser library, which is shared process-wide through LibraryCache
+    bool Init();
+
     using CreateFunc = RefParser *(*)(CodecType, std::vector<uint32_t>&);
     using DestroyFunc = void (*)(RefParser *);
-    static CreateFunc createFunc_;
-    static DestroyFunc destroyFunc_;
-    static std::mutex mtx_;
+    RefParser *referenceParser_ {nullptr};
+    bool libraryAcquired_ {false};
+    CreateFunc createFunc_ {nullptr};
+    DestroyFunc destroyFunc_ {nullptr};
 };
 } // namespace Plugins
 } // namespace Media
@@ -16,8 +16,8 @@
 #define HST_LOG_TAG "StreamParserManager"
 
 #include "stream_parser_manager.h"
-#include <dlfcn.h>
 #include "common/log.h"
+#include "library_cache.h"
 
 namespace {
 const std::string HEVC_LIB_PATH = "libav_codec_hevc_parser.z.so";
@@ -28,10 +28,7 @@ constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_DOMAIN_DEMUXER, "S
 namespace OHOS {
 namespace Media {
 namespace Plugins {
-std::mutex StreamParserManager::mtx_;
-std::map<StreamType, void *> StreamParserManager::handlerMap_ {};
-std::map<StreamType, CreateFunc> StreamParserManager::createFuncMap_ {};
-std::map<StreamType, DestroyFunc> StreamParserManager::destroyFuncMap_ {};
+using MediaAVCodec::LibraryCache;
 
 StreamParserManager::StreamParserManager()
 {
@@ -41,18 +38,16 @@ StreamParserManager::StreamParserManager()
 StreamParserManager::~StreamParserManager()
 {
     if (streamParser_) {
-        destroyFuncMap_[streamType_](streamParser_);
+        destroyFunc_(streamParser_);
         streamParser_ = nullptr;
     }
+    if (!libPath_.empty()) {
+        LibraryCache::GetInstance().Release(libPath_);
+    }
 }
 
 bool StreamParserManager::Init(StreamType streamType)
 {
-    std::lock_guard<std::mutex> lock(mtx_);
-    if (handlerMap_.count(streamType) && createFuncMap_.count(streamType) && destroyFuncMap_.count(streamType)) {
-        return true;
-    }
-
     std::string streamParserPath;
     if (streamType == StreamType::HEVC) {
         streamParserPath = HEVC_LIB_PATH;
@@ -62,13 +57,12 @@ bool StreamParserManager::Init(StreamType streamType)
         MEDIA_LOG_E("Unsupport stream parser type");
         return false;
     }
-    if (handlerMap_.count(streamType) == 0) {
-        handlerMap_[streamType] = LoadPluginFile(streamParserPath);
-    }
-    if (!CheckSymbol(handlerMap_[streamType], streamType)) {
-        MEDIA_LOG_E("Load stream parser so fail");
-        return false;
-    }
+    LibraryCache &cache = LibraryCache::GetInstance();
+    FALSE_RETURN_V_MSG_E(cache.Acquire(streamParserPath) != nullptr, false, "Load stream parser so fail");
+    libPath_ = streamParserPath;
+    createFunc_ = reinterpret_cast<CreateFunc>(cache.GetSymbol(libPath_, "CreateStreamParser"));
+    destroyFunc_ = reinterpret_cast<DestroyFunc>(cache.GetSymbol(libPath_, "DestroyStreamParser"));
+    FALSE_RETURN_V_MSG_E(createFunc_ != nullptr && destroyFunc_ != nullptr, false, "Load stream parser symbol fail");
     return true;
 }
 
@@ -79,7 +73,7 @@ std::shared_ptr<StreamParserManager> StreamParserManager::Create(StreamType stre
     if (!loader->Init(streamType)) {
         return nullptr;
     }
-    loader->streamParser_ = loader->createFuncMap_[streamType]();
+    loader->streamParser_ = loader->createFunc_();
     if (!loader->streamParser_) {
         MEDIA_LOG_E("createFunc_ fail");
         return nullptr;
@@ -186,34 +180,6 @@ void StreamParserManager::ResetXPSSendStatus()
     streamParser_->ResetXPSSendStatus();
 }
 
-void *StreamParserManager::LoadPluginFile(const std::string &path)
-{
-    auto ptr = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
-    if (ptr == nullptr) {
-        MEDIA_LOG_E("dlopen failed due to %{public}s", ::dlerror());
-    }
-    return ptr;
-}
-
-bool StreamParserManager::CheckSymbol(void *handler, StreamType streamType)
-{
-    if (handler) {
-        std::string createFuncName = "CreateStreamParser";
-        std::string destroyFuncName = "DestroyStreamParser";
-        CreateFunc createFunc = nullptr;
-        DestroyFunc destroyFunc = nullptr;
-        createFunc = (CreateFunc)(::dlsym(handler, createFuncName.c_str()));
-        destroyFunc = (DestroyFunc)(::dlsym(handler, destroyFuncName.c_str()));
-        if (createFunc && destroyFunc) {
-            MEDIA_LOG_D("CheckSymbol:  createFuncName %{public}s", createFuncName.c_str());
-            MEDIA_LOG_D("CheckSymbol:  destroyFuncName %{public}s", destroyFuncName.c_str());
-            createFuncMap_[streamType] = createFunc;
-            destroyFuncMap_[streamType] = destroyFunc;
-            return true;
-        }
-    }
-    return false;
-}
 } // namespace Plugins
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
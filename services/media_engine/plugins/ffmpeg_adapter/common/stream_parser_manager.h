@@ -17,9 +17,7 @@
 #define STREAM_PARSER_MANAGER_H
 
 #include <string>
-#include <map>
 #include <memory>
-#include <mutex>
 #include "stream_parser.h"
 
 namespace OHOS {
@@ -38,7 +36,6 @@ public:
     StreamParserManager(const StreamParserManager &) = delete;
     StreamParserManager operator=(const StreamParserManager &) = delete;
     ~StreamParserManager();
-    static bool Init(StreamType streamType);
 
     void ParseExtraData(const uint8_t *sample, int32_t size, uint8_t **extraDataBuf, int32_t *extraDataSize);
     bool IsHdrVivid();
@@ -59,15 +56,14 @@ public:
     void ParseAnnexbExtraData(const uint8_t *sample, int32_t size);
     
 private:
+    // takes a reference on the parser library, which is shared process-wide through LibraryCache
+    bool Init(StreamType streamType);
+
     StreamParser *streamParser_ {nullptr};
-    // .so initialize
-    static void *LoadPluginFile(const std::string &path);
-    static bool CheckSymbol(void *handler, StreamType streamType);
     StreamType streamType_;
-    static std::mutex mtx_;
-    static std::map<StreamType, void *> handlerMap_;
-    static std::map<StreamType, CreateFunc> createFuncMap_;
-    static std::map<StreamType, DestroyFunc> destroyFuncMap_;
+    std::string libPath_;
+    CreateFunc createFunc_ {nullptr};
+    DestroyFunc destroyFunc_ {nullptr};
 };
 } // namespace Plugins
 } // namespace Media
@@ -19,6 +19,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <deque>
+#include <vector>
 #include "common/log.h"
 
 namespace OHOS {
@@ -144,6 +145,25 @@ public:
         return element;
     }
 
+    T PopBack()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (que_.empty()) {
+            MEDIA_LOG_D("block queue " PUBLIC_LOG_S " is empty for PopBack.", name_.c_str());
+            return {};
+        }
+        T element = que_.back();
+        que_.pop_back();
+        condFull_.notify_one();
+        return element;
+    }
+
+    std::vector<T> Elements()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::vector<T>(que_.begin(), que_.end());
+    }
+
     void Clear()
     {
         std::lock_guard<std::mutex> lock(mutex_);
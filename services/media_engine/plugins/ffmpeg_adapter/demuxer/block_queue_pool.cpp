@@ -15,6 +15,7 @@
 
 #define HST_LOG_TAG "BlockQueuePool"
 
+#include <algorithm>
 #include "common/log.h"
 #include "block_queue_pool.h"
 
@@ -141,6 +142,9 @@ void BlockQueuePool::ResetQueue(uint32_t queueIndex)
         return;
     }
     blockQue->Clear();
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Release(quePool_[queueIndex].dataSize);
+    }
     quePool_[queueIndex].dataSize = 0;
     quePool_[queueIndex].isValid = true;
     return;
@@ -179,11 +183,20 @@ bool BlockQueuePool::Push(uint32_t trackIndex, std::shared_ptr<SamplePacket> blo
         MEDIA_LOG_D("block queue " PUBLIC_LOG_D32 " is nullptr, failed to push data", pushIndex);
         return false;
     }
-    sizeMap_[trackIndex] += 1;
+    uint32_t blockSize = 0;
     for (auto pkt : block->pkts) {
-        quePool_[pushIndex].dataSize += static_cast<uint32_t>(pkt->size);
+        blockSize += static_cast<uint32_t>(pkt->size);
+    }
+    if (!quePool_[pushIndex].blockQue->Push(block)) {
+        MEDIA_LOG_D("block queue " PUBLIC_LOG_D32 " is inactive, failed to push data", pushIndex);
+        return false;
     }
-    return quePool_[pushIndex].blockQue->Push(block);
+    sizeMap_[trackIndex] += 1;
+    quePool_[pushIndex].dataSize += blockSize;
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Charge(blockSize);
+    }
+    return true;
 }
 
 std::shared_ptr<SamplePacket> BlockQueuePool::Pop(uint32_t trackIndex)
@@ -209,15 +222,7 @@ std::shared_ptr<SamplePacket> BlockQueuePool::Pop(uint32_t trackIndex)
             MEDIA_LOG_D("block is nullptr");
             continue;
         }
-        for (auto pkt : block->pkts) {
-            if (pkt == nullptr) {
-                MEDIA_LOG_D("pkt is nullptr, will find next");
-                continue;
-            }
-            uint32_t pktSize = static_cast<uint32_t>(pkt->size);
-            quePool_[queIndex].dataSize =
-                quePool_[queIndex].dataSize >= pktSize ? quePool_[queIndex].dataSize -= pktSize : 0;
-        }
+        ReleaseBlock(queIndex, block);
         if (quePool_[queIndex].blockQue->Empty()) {
             ResetQueue(queIndex);
             MEDIA_LOG_D("track " PUBLIC_LOG_U32 " queue " PUBLIC_LOG_D32 " is empty, will return to pool.",
@@ -279,6 +284,88 @@ std::shared_ptr<SamplePacket> BlockQueuePool::Back(uint32_t trackIndex)
     return nullptr;
 }
 
+std::shared_ptr<SamplePacket> BlockQueuePool::PopBack(uint32_t trackIndex)
+{
+    std::unique_lock<std::recursive_mutex> lockCacheQ(mutextCacheQ_);
+    MEDIA_LOG_D("block queue " PUBLIC_LOG_S " PopBack enter, trackIndex: " PUBLIC_LOG_U32 ".",
+        name_.c_str(), trackIndex);
+    if (!HasQueue(trackIndex)) {
+        MEDIA_LOG_E("trackIndex: " PUBLIC_LOG_U32 " has not cache queue", trackIndex);
+        return nullptr;
+    }
+    auto& queVector = queMap_[trackIndex];
+    for (auto index = static_cast<int32_t>(queVector.size()) - 1; index >= 0; --index) {
+        auto queIndex = queVector[index];
+        if (quePool_[queIndex].blockQue == nullptr || quePool_[queIndex].blockQue->Size() <= 0) {
+            continue;
+        }
+        auto block = quePool_[queIndex].blockQue->PopBack();
+        if (block == nullptr) {
+            MEDIA_LOG_D("block is nullptr");
+            continue;
+        }
+        ReleaseBlock(queIndex, block);
+        if (quePool_[queIndex].blockQue->Empty()) {
+            ResetQueue(queIndex);
+            queVector.erase(queVector.begin() + index);
+        }
+        if (sizeMap_[trackIndex] > 0) {
+            sizeMap_[trackIndex] -= 1;
+        }
+        return block;
+    }
+    MEDIA_LOG_E("trackIndex: " PUBLIC_LOG_U32 " has not cache data", trackIndex);
+    return nullptr;
+}
+
+std::vector<std::shared_ptr<SamplePacket>> BlockQueuePool::GetSamples(uint32_t trackIndex)
+{
+    std::unique_lock<std::recursive_mutex> lockCacheQ(mutextCacheQ_);
+    std::vector<std::shared_ptr<SamplePacket>> samples;
+    if (!HasQueue(trackIndex)) {
+        return samples;
+    }
+    for (auto queIndex : queMap_[trackIndex]) {
+        if (quePool_[queIndex].blockQue == nullptr) {
+            continue;
+        }
+        auto elements = quePool_[queIndex].blockQue->Elements();
+        samples.insert(samples.end(), elements.begin(), elements.end());
+    }
+    return samples;
+}
+
+void BlockQueuePool::SetMemoryBudget(std::shared_ptr<MediaAVCodec::MemoryBudget> budget)
+{
+    std::unique_lock<std::recursive_mutex> lockCacheQ(mutextCacheQ_);
+    uint64_t dataSize = 0;
+    for (auto &que : quePool_) {
+        dataSize += que.second.dataSize;
+    }
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Release(dataSize);
+    }
+    memoryBudget_ = std::move(budget);
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Charge(dataSize);
+    }
+}
+
+void BlockQueuePool::ReleaseBlock(uint32_t queueIndex, const std::shared_ptr<SamplePacket> &block)
+{
+    for (auto pkt : block->pkts) {
+        if (pkt == nullptr) {
+            MEDIA_LOG_D("pkt is nullptr, will find next");
+            continue;
+        }
+        uint32_t pktSize = std::min(static_cast<uint32_t>(pkt->size), quePool_[queueIndex].dataSize);
+        quePool_[queueIndex].dataSize -= pktSize;
+        if (memoryBudget_ != nullptr) {
+            memoryBudget_->Release(pktSize);
+        }
+    }
+}
+
 uint32_t BlockQueuePool::GetValidQueue()
 {
     std::unique_lock<std::recursive_mutex> lockCacheQ(mutextCacheQ_);
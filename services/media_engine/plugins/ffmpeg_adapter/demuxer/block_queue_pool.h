@@ -20,6 +20,7 @@
 #include <cstdint>
 #include "block_queue.h"
 #include "common/status.h"
+#include "memory_budget.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -64,6 +65,12 @@ public:
     std::shared_ptr<SamplePacket> Pop(uint32_t trackIndex);
     std::shared_ptr<SamplePacket> Front(uint32_t trackIndex);
     std::shared_ptr<SamplePacket> Back(uint32_t trackIndex);
+    // Drops the newest sample of the track, the reader keeps the older ones
+    std::shared_ptr<SamplePacket> PopBack(uint32_t trackIndex);
+    // The cached samples of the track, oldest first
+    std::vector<std::shared_ptr<SamplePacket>> GetSamples(uint32_t trackIndex);
+    // Charges the packet bytes held by the pool to the budget
+    void SetMemoryBudget(std::shared_ptr<MediaAVCodec::MemoryBudget> budget);
     
 private:
     struct InnerQueue {
@@ -78,11 +85,13 @@ private:
     std::map<uint32_t, std::vector<uint32_t>> queMap_;
     std::map<uint32_t, uint32_t> sizeMap_;
     size_t singleQueSize_ {0};
+    std::shared_ptr<MediaAVCodec::MemoryBudget> memoryBudget_ {nullptr};
 
     uint32_t GetValidQueue();
     bool InnerQueueIsFull(uint32_t queueIndex);
     bool HasQueue(uint32_t trackIndex);
     void ResetQueue(uint32_t queueIndex);
+    void ReleaseBlock(uint32_t queueIndex, const std::shared_ptr<SamplePacket> &block);
     std::recursive_mutex mutextCacheQ_ {};
 };
 } // namespace Media
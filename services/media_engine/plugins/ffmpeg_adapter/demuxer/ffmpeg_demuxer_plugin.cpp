@@ -36,6 +36,7 @@
 #include "avcodec_sysevent.h"
 #include "ffmpeg_demuxer_plugin.h"
 #include "meta/format.h"
+#include "nal_unit_scanner.h"
 #include "syspara/parameters.h"
 
 namespace {
@@ -63,6 +64,18 @@ const uint32_t NAL_START_CODE_SIZE = 4;
 const uint32_t INIT_DOWNLOADS_DATA_SIZE_THRESHOLD = 2 * 1024 * 1024;
 const int64_t LIVE_FLV_PROBE_SIZE = 100 * 1024 * 2;
 const uint32_t DEFAULT_CACHE_LIMIT = 50 * 1024 * 1024; // 50M
+const int32_t CACHE_DRAIN_WAIT_MS = 20;
+const uint8_t HEVC_NAL_TYPE_SHIFT = 1;
+const uint8_t HEVC_NAL_TYPE_MASK = 0x3F;
+const uint8_t HEVC_IRAP_NAL_MIN = 16; // BLA_W_LP
+const uint8_t HEVC_IRAP_NAL_MAX = 23; // RSV_IRAP_VCL23
+// every cursor opens the file again and parses the whole sample table, so files with more tracks share one cursor
+const uint32_t MAX_TRACK_CURSOR_COUNT = 4;
+const uint32_t MP4_BOX_HEADER_SIZE = 8;
+const uint32_t MP4_LARGE_BOX_HEADER_SIZE = 16;
+const uint32_t MP4_BOX_SIZE_BYTES = 4;
+const uint32_t MP4_LARGE_BOX_SIZE_BYTES = 8;
+const uint64_t MAX_MOOV_CACHE_SIZE = 32 * 1024 * 1024; // 32M
 namespace {
 std::map<std::string, std::shared_ptr<AVInputFormat>> g_pluginInputFormat;
 std::mutex g_mtx;
@@ -73,6 +86,8 @@ Status RegisterPlugins(const std::shared_ptr<Register>& reg);
 
 void ReplaceDelimiter(const std::string &delmiters, char newDelimiter, std::string &str);
 
+bool IsHevcIrapFrame(const uint8_t *data, uint32_t size);
+
 static const std::map<SeekMode, int32_t>  g_seekModeToFFmpegSeekFlags = {
     { SeekMode::SEEK_PREVIOUS_SYNC, AVSEEK_FLAG_BACKWARD },
     { SeekMode::SEEK_NEXT_SYNC, AVSEEK_FLAG_FRAME },
@@ -304,6 +319,9 @@ FFmpegDemuxerPlugin::FFmpegDemuxerPlugin(std::string name)
     (void)mallopt(M_DELAYED_FREE, M_DELAYED_FREE_DISABLE);
 #endif
     av_log_set_callback(FfmpegLogPrint);
+    ioContext_.dataSourceMutex = &dataSourceMutex_;
+    parserRefIoContext_.dataSourceMutex = &dataSourceMutex_;
+    trackCursorEnabled_ = OHOS::system::GetParameter("persist.media_service.demuxer_track_cursor", "1") == "1";
 #ifdef BUILD_ENG_VERSION
     std::string dumpModeStr = OHOS::system::GetParameter("FFmpegDemuxerPlugin.dump", "0");
     dumpMode_ = static_cast<DumpMode>(strtoul(dumpModeStr.c_str(), nullptr, 2)); // 2 is binary
@@ -314,11 +332,15 @@ FFmpegDemuxerPlugin::FFmpegDemuxerPlugin(std::string name)
 
 FFmpegDemuxerPlugin::~FFmpegDemuxerPlugin()
 {
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->SetReclaimer(nullptr);
+    }
     std::lock_guard<std::shared_mutex> lock(sharedMutex_);
     MEDIA_LOG_D("Destroy FFmpeg Demuxer Plugin.");
 #ifndef _WIN32
     (void)mallopt(M_FLUSH_THREAD_CACHE, 0);
 #endif
+    trackCursors_.clear();
     formatContext_ = nullptr;
     pluginImpl_ = nullptr;
     avbsfContext_ = nullptr;
@@ -655,11 +677,17 @@ Status FFmpegDemuxerPlugin::Reset()
         cacheQueue_.RemoveTrackQueue(selectedTrackIds_[i]);
     }
     selectedTrackIds_.clear();
+    trackCursors_.clear();
+    trackCursorMode_ = false;
+    cursorSeekTime_ = AV_NOPTS_VALUE;
+    cursorTrackCount_ = 0;
+    moovCache_ = nullptr;
     pluginImpl_.reset();
     formatContext_.reset();
     avbsfContext_.reset();
     trackMtx_.clear();
     trackDfxInfoMap_.clear();
+    resumeDts_.clear();
     return Status::OK;
 }
 
@@ -728,7 +756,7 @@ void FFmpegDemuxerPlugin::ConvertHevcToAnnexb(AVPacket& pkt, std::shared_ptr<Sam
     streamParser_->ConvertPacketToAnnexb(&(pkt.data), pkt.size, cencInfo,
         static_cast<size_t>(cencInfoSize), false);
     if (NeedCombineFrame(samplePacket->pkts[0]->stream_index) &&
-        streamParser_->IsSyncFrame(pkt.data, pkt.size)) {
+        IsHevcIrapFrame(pkt.data, static_cast<uint32_t>(pkt.size))) {
         pkt.flags = static_cast<int32_t>(static_cast<uint32_t>(pkt.flags) | static_cast<uint32_t>(AV_PKT_FLAG_KEY));
     }
 }
@@ -906,6 +934,7 @@ Status FFmpegDemuxerPlugin::ConvertAVPacketToSample(
         trackDfxInfoMap_[tempPkt->stream_index].lastPts = sample->pts_;
         trackDfxInfoMap_[tempPkt->stream_index].lastDurantion = sample->duration_;
         trackDfxInfoMap_[tempPkt->stream_index].lastPos = tempPkt->pos;
+        trackDfxInfoMap_[tempPkt->stream_index].lastDts = tempPkt->dts;
     }
 #ifdef BUILD_ENG_VERSION
     DumpParam dumpParam {DumpMode(DUMP_AVBUFFER_OUTPUT & dumpMode_), tempPkt->data + samplePacket->offset,
@@ -992,6 +1021,12 @@ Status FFmpegDemuxerPlugin::ReadPacketToCacheQueue(const uint32_t readId)
             pkt = av_packet_alloc();
             FALSE_RETURN_V_MSG_E(pkt != nullptr, Status::ERROR_NULL_POINTER, "av_packet_alloc failed.");
         }
+        // seeking moves every track, so it is skipped once another track shares the cursor
+        int64_t keyFrameTime = lastKeyFrameTime_.exchange(AV_NOPTS_VALUE);
+        if (keyFrameTime != AV_NOPTS_VALUE && selectedTrackIds_.size() == 1) {
+            std::lock_guard<std::mutex> sLock(syncMutex_);
+            SeekToNextKeyFrame(formatContext_.get(), static_cast<int>(selectedTrackIds_[0]), keyFrameTime);
+        }
         std::unique_lock<std::mutex> sLock(syncMutex_);
         int ffmpegRet = av_read_frame(formatContext_.get(), pkt);
         sLock.unlock();
@@ -1015,7 +1050,8 @@ Status FFmpegDemuxerPlugin::ReadPacketToCacheQueue(const uint32_t readId)
             return Status::ERROR_UNKNOWN;
         }
         auto trackId = pkt->stream_index;
-        if (!TrackIsSelected(trackId)) {
+        if (!TrackIsSelected(trackId) || IsReadBeforeReclaim(*pkt) ||
+            IsSkippedByKeyFrameOnly(*pkt, selectedTrackIds_.size() == 1, lastKeyFrameTime_)) {
             av_packet_unref(pkt);
             continue;
         }
@@ -1033,6 +1069,259 @@ Status FFmpegDemuxerPlugin::ReadPacketToCacheQueue(const uint32_t readId)
     return ret;
 }
 
+bool FFmpegDemuxerPlugin::IsSkippedByKeyFrameOnly(const AVPacket &pkt, bool canSeek,
+    std::atomic<int64_t> &lastKeyFrameTime)
+{
+    // hevc in mpegts is combined from several packets, only the first one carries the key flag
+    if (!keyFrameOnly_ || NeedCombineFrame(pkt.stream_index)) {
+        return false;
+    }
+    AVStream *avStream = formatContext_->streams[pkt.stream_index];
+    if (avStream->codecpar->codec_type != AVMEDIA_TYPE_VIDEO) {
+        return false;
+    }
+    if ((static_cast<uint32_t>(pkt.flags) & static_cast<uint32_t>(AV_PKT_FLAG_KEY)) == 0) {
+        return true;
+    }
+    if (canSeek && avformat_index_get_entries_count(avStream) > 0) {
+        // the index is searched by decode time, the pts of a reordered key frame can be past the next entry
+        lastKeyFrameTime = pkt.dts;
+    }
+    return false;
+}
+
+void FFmpegDemuxerPlugin::SeekToNextKeyFrame(AVFormatContext *formatContext, int trackIndex,
+    int64_t keyFrameTime)
+{
+    AVStream *avStream = formatContext->streams[trackIndex];
+    int curIndex = av_index_search_timestamp(avStream, keyFrameTime, AVSEEK_FLAG_BACKWARD);
+    const AVIndexEntry *curEntry = curIndex >= 0 ? avformat_index_get_entry(avStream, curIndex) : nullptr;
+    FALSE_RETURN_MSG(curEntry != nullptr, "Key frame " PUBLIC_LOG_D64 " is not in index.", keyFrameTime);
+    int nextIndex = av_index_search_timestamp(avStream, curEntry->timestamp + 1, 0);
+    const AVIndexEntry *nextEntry = nextIndex >= 0 ? avformat_index_get_entry(avStream, nextIndex) : nullptr;
+    // the frames after the last key frame are dropped one by one until eos
+    FALSE_RETURN_MSG(nextEntry != nullptr, "No key frame after " PUBLIC_LOG_D64 " in index.", curEntry->timestamp);
+
+    int ret = av_seek_frame(formatContext, trackIndex, nextEntry->timestamp, AVSEEK_FLAG_BACKWARD);
+    if (formatContext->pb->error) {
+        formatContext->pb->error = 0;
+    }
+    FALSE_RETURN_MSG(ret >= 0, "Seek to next key frame " PUBLIC_LOG_D64 " failed, err: " PUBLIC_LOG_S,
+        nextEntry->timestamp, AVStrError(ret).c_str());
+}
+
+bool FFmpegDemuxerPlugin::IsTrackCursorSupported()
+{
+    // the cursors read apart from each other, which only pays off when a read is a cheap local seek
+    FALSE_RETURN_V(isLocalSource_ && seekable_ == Seekable::SEEKABLE && !ioContext_.dataSource->IsDash(), false);
+    // the mov demuxer reads every sample by its offset in the sample table and skips the discarded streams,
+    // other demuxers parse the interleaved data of all streams anyway
+    std::string formatName(formatContext_->iformat->name);
+    FALSE_RETURN_V(formatName.find("mp4") != std::string::npos, false);
+    uint32_t trackCount = 0;
+    for (uint32_t trackIndex = 0; trackIndex < formatContext_->nb_streams; ++trackIndex) {
+        AVStream *avStream = formatContext_->streams[trackIndex];
+        if (avStream == nullptr || !IsSupportedTrack(*avStream)) {
+            continue;
+        }
+        if (++trackCount > MAX_TRACK_CURSOR_COUNT) {
+            MEDIA_LOG_D("More than " PUBLIC_LOG_U32 " tracks.", MAX_TRACK_CURSOR_COUNT);
+            return false;
+        }
+        // fragmented files index their samples while reading, so every cursor would parse all fragments
+        if (avStream->nb_frames <= 0 || avformat_index_get_entries_count(avStream) < avStream->nb_frames) {
+            MEDIA_LOG_D("Track " PUBLIC_LOG_U32 " has no full sample table.", trackIndex);
+            return false;
+        }
+    }
+    cursorTrackCount_ = trackCount;
+    return true;
+}
+
+Status FFmpegDemuxerPlugin::OpenTrackCursor(uint32_t trackId)
+{
+    auto cursor = std::make_shared<TrackCursor>();
+    cursor->ioContext.dataSource = ioContext_.dataSource;
+    cursor->ioContext.fileSize = ioContext_.fileSize;
+    cursor->ioContext.initCompleted = true;
+    cursor->ioContext.dumpMode = dumpMode_;
+    cursor->ioContext.dataSourceMutex = &dataSourceMutex_;
+    // ffmpeg cannot hand a parsed sample table to another format context, so every cursor parses the moov,
+    // but from one copy in memory, and only the sample table is needed as the streams are known already
+    if (moovCache_ == nullptr) {
+        moovCache_ = LoadMoovCache();
+    }
+    cursor->ioContext.moovCache = moovCache_;
+    cursor->formatContext = InitAVFormatContext(&cursor->ioContext, false);
+    cursor->ioContext.moovCache = nullptr;
+    FALSE_RETURN_V_MSG_E(cursor->formatContext != nullptr &&
+        cursor->formatContext->nb_streams == formatContext_->nb_streams, Status::ERROR_UNKNOWN,
+        "Open cursor for track " PUBLIC_LOG_U32 " failed.", trackId);
+    for (uint32_t trackIndex = 0; trackIndex < cursor->formatContext->nb_streams; ++trackIndex) {
+        cursor->formatContext->streams[trackIndex]->discard = trackIndex == trackId ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+    // a track selected later starts where the other tracks are, or at the last seek before any of them read
+    int64_t startTime = AV_NOPTS_VALUE;
+    for (auto &iter : trackCursors_) {
+        int64_t readTime = iter.second->readTime;
+        if (readTime != AV_NOPTS_VALUE && (startTime == AV_NOPTS_VALUE || readTime < startTime)) {
+            startTime = readTime;
+        }
+    }
+    if (startTime == AV_NOPTS_VALUE) {
+        startTime = cursorSeekTime_;
+    }
+    if (startTime != AV_NOPTS_VALUE) {
+        AVStream *avStream = cursor->formatContext->streams[trackId];
+        int ret = av_seek_frame(cursor->formatContext.get(), static_cast<int>(trackId),
+            av_rescale_q(startTime, AV_TIME_BASE_Q, avStream->time_base), AVSEEK_FLAG_BACKWARD);
+        if (cursor->formatContext->pb->error) {
+            cursor->formatContext->pb->error = 0;
+        }
+        FALSE_RETURN_V_MSG_E(ret >= 0, Status::ERROR_UNKNOWN, "Seek cursor of track " PUBLIC_LOG_U32 " to "
+            PUBLIC_LOG_D64 " failed.", trackId, startTime);
+    }
+    // the packets parked while probing the first frame are read again from the start of the track
+    cacheQueue_.RemoveTrackQueue(trackId);
+    trackCursors_[trackId] = cursor;
+    if (trackCursors_.size() >= cursorTrackCount_) {
+        moovCache_ = nullptr;
+    }
+    MEDIA_LOG_I("Track " PUBLIC_LOG_U32 " reads from its own cursor.", trackId);
+    return Status::OK;
+}
+
+std::shared_ptr<FFmpegDemuxerPlugin::BoxCache> FFmpegDemuxerPlugin::LoadMoovCache()
+{
+    // the top level boxes are walked by their headers up to the moov
+    uint8_t header[MP4_LARGE_BOX_HEADER_SIZE] = {0};
+    int64_t offset = 0;
+    while (static_cast<uint64_t>(offset) + MP4_LARGE_BOX_HEADER_SIZE <= ioContext_.fileSize) {
+        FALSE_RETURN_V(ReadSourceAt(offset, header, sizeof(header)) == sizeof(header), nullptr);
+        uint64_t boxSize = 0;
+        for (uint32_t i = 0; i < MP4_BOX_SIZE_BYTES; ++i) {
+            boxSize = (boxSize << 8) | header[i]; // 8: bits per byte, sizes are big endian
+        }
+        uint64_t headerSize = MP4_BOX_HEADER_SIZE;
+        if (boxSize == 1) {
+            boxSize = 0;
+            for (uint32_t i = 0; i < MP4_LARGE_BOX_SIZE_BYTES; ++i) {
+                boxSize = (boxSize << 8) | header[MP4_BOX_HEADER_SIZE + i]; // 8: bits per byte
+            }
+            headerSize = MP4_LARGE_BOX_HEADER_SIZE;
+        } else if (boxSize == 0) {
+            boxSize = ioContext_.fileSize - static_cast<uint64_t>(offset);
+        }
+        FALSE_RETURN_V_MSG_E(boxSize >= headerSize && boxSize <= ioContext_.fileSize - static_cast<uint64_t>(offset),
+            nullptr, "Invalid box size " PUBLIC_LOG_U64 " at " PUBLIC_LOG_D64, boxSize, offset);
+        if (memcmp(header + MP4_BOX_SIZE_BYTES, "moov", MP4_BOX_SIZE_BYTES) == 0) {
+            FALSE_RETURN_V_MSG_W(boxSize <= MAX_MOOV_CACHE_SIZE, nullptr,
+                "Moov of " PUBLIC_LOG_U64 " bytes is read by each cursor", boxSize);
+            auto cache = std::make_shared<BoxCache>();
+            cache->offset = offset;
+            cache->data.resize(boxSize);
+            FALSE_RETURN_V(ReadSourceAt(offset, cache->data.data(), boxSize) == boxSize, nullptr);
+            MEDIA_LOG_I("Moov of " PUBLIC_LOG_U64 " bytes at " PUBLIC_LOG_D64 " is shared by the cursors",
+                boxSize, offset);
+            return cache;
+        }
+        offset += static_cast<int64_t>(boxSize);
+    }
+    return nullptr;
+}
+
+size_t FFmpegDemuxerPlugin::ReadSourceAt(int64_t offset, uint8_t *buf, size_t size)
+{
+    size_t readSize = 0;
+    while (readSize < size) {
+        auto buffer = std::make_shared<Buffer>();
+        auto bufData = buffer->WrapMemory(buf + readSize, size - readSize, 0);
+        FALSE_RETURN_V(buffer->GetMemory() != nullptr, readSize);
+        Status ret;
+        {
+            std::lock_guard<std::mutex> lock(dataSourceMutex_);
+            ret = ioContext_.dataSource->ReadAt(offset + static_cast<int64_t>(readSize), buffer, size - readSize);
+        }
+        size_t dataSize = buffer->GetMemory()->GetSize();
+        if (ret != Status::OK || dataSize == 0) {
+            break;
+        }
+        readSize += dataSize;
+    }
+    return readSize;
+}
+
+Status FFmpegDemuxerPlugin::ReadTrackCursorToCacheQueue(uint32_t trackId)
+{
+    auto iter = trackCursors_.find(trackId);
+    FALSE_RETURN_V_MSG_E(iter != trackCursors_.end(), Status::ERROR_UNKNOWN,
+        "Track " PUBLIC_LOG_U32 " has no cursor.", trackId);
+    std::shared_ptr<TrackCursor> cursor = iter->second;
+    AVFormatContext *formatContext = cursor->formatContext.get();
+    std::lock_guard<std::mutex> lock(*trackMtx_[trackId].get());
+    AVPacket *pkt = av_packet_alloc();
+    FALSE_RETURN_V_MSG_E(pkt != nullptr, Status::ERROR_NULL_POINTER, "av_packet_alloc failed.");
+    while (true) {
+        int64_t keyFrameTime = cursor->lastKeyFrameTime.exchange(AV_NOPTS_VALUE);
+        if (keyFrameTime != AV_NOPTS_VALUE) {
+            SeekToNextKeyFrame(formatContext, static_cast<int>(trackId), keyFrameTime);
+        }
+        // the cursors read in parallel, only the calls on the shared data source are serialized
+        int ffmpegRet = av_read_frame(formatContext, pkt);
+        if (ffmpegRet == AVERROR_EOF) {
+            pkt->stream_index = static_cast<int>(trackId);
+            WebvttMP4EOSProcess(pkt);
+            av_packet_free(&pkt);
+            MEDIA_LOG_I("Push eos into the cache " PUBLIC_LOG_U32 ".", trackId);
+            std::shared_ptr<SamplePacket> eosSample = std::make_shared<SamplePacket>();
+            eosSample->isEOS = true;
+            cacheQueue_.Push(trackId, eosSample);
+            return Status::END_OF_STREAM;
+        }
+        if (ffmpegRet < 0) {
+            av_packet_free(&pkt);
+            MEDIA_LOG_E("Read track " PUBLIC_LOG_U32 " failed due to av_read_frame failed:" PUBLIC_LOG_S
+                ", retry: " PUBLIC_LOG_D32, trackId, AVStrError(ffmpegRet).c_str(), int(cursor->ioContext.retry));
+            if (cursor->ioContext.retry) {
+                formatContext->pb->eof_reached = 0;
+                formatContext->pb->error = 0;
+                cursor->ioContext.retry = false;
+                return Status::ERROR_AGAIN;
+            }
+            return Status::ERROR_UNKNOWN;
+        }
+        if (static_cast<uint32_t>(pkt->stream_index) != trackId ||
+            IsSkippedByKeyFrameOnly(*pkt, true, cursor->lastKeyFrameTime)) {
+            av_packet_unref(pkt);
+            continue;
+        }
+        if (pkt->dts != AV_NOPTS_VALUE) {
+            cursor->readTime = av_rescale_q(pkt->dts, formatContext->streams[trackId]->time_base, AV_TIME_BASE_Q);
+        }
+        if (IsWebvttMP4(formatContext_->streams[trackId]) && WebvttPktProcess(pkt)) {
+            return Status::OK;
+        }
+        return AddPacketToCacheQueue(pkt);
+    }
+}
+
+int FFmpegDemuxerPlugin::SeekTrackCursors(int trackIndex, int64_t ffTime, int flag)
+{
+    // every cursor seeks on the same reference track, so the tracks start where the shared cursor would put them
+    cursorSeekTime_ = av_rescale_q(ffTime, formatContext_->streams[trackIndex]->time_base, AV_TIME_BASE_Q);
+    for (auto &iter : trackCursors_) {
+        AVFormatContext *formatContext = iter.second->formatContext.get();
+        int ret = av_seek_frame(formatContext, trackIndex, ffTime, flag);
+        if (formatContext->pb->error) {
+            formatContext->pb->error = 0;
+        }
+        iter.second->lastKeyFrameTime = AV_NOPTS_VALUE;
+        iter.second->readTime = AV_NOPTS_VALUE;
+        FALSE_RETURN_V_MSG_E(ret >= 0, ret, "Seek cursor of track " PUBLIC_LOG_U32 " failed.", iter.first);
+    }
+    return 0;
+}
+
 Status FFmpegDemuxerPlugin::SetEosSample(std::shared_ptr<AVBuffer> sample)
 {
     MEDIA_LOG_D("Set EOS buffer.");
@@ -1097,13 +1386,18 @@ int FFmpegDemuxerPlugin::AVReadPacket(void* opaque, uint8_t* buf, int bufSize)
     ret = -1;
     auto ioContext = static_cast<IOContext*>(opaque);
     FALSE_RETURN_V_MSG_E(ioContext != nullptr, ret, "ioContext is nullptr");
+    auto moovCache = ioContext->moovCache;
+    if (moovCache != nullptr && ioContext->offset >= moovCache->offset &&
+        ioContext->offset - moovCache->offset < static_cast<int64_t>(moovCache->data.size())) {
+        return ReadBoxCache(ioContext, buf, bufSize);
+    }
     auto buffer = std::make_shared<Buffer>();
     FALSE_RETURN_V_MSG_E(buffer != nullptr, ret, "buffer is nullptr");
     auto bufData = buffer->WrapMemory(buf, bufSize, 0);
     FALSE_RETURN_V_MSG_E(buffer->GetMemory() != nullptr, ret, "AVReadPacket buf is nullptr");
 
     MediaAVCodec::AVCodecTrace trace("AVReadPacket_ReadAt");
-    auto result = ioContext->dataSource->ReadAt(ioContext->offset, buffer, static_cast<size_t>(bufSize));
+    auto result = ReadDataSource(ioContext, buffer, static_cast<size_t>(bufSize));
     int dataSize = static_cast<int>(buffer->GetMemory()->GetSize());
     MEDIA_LOG_D("Want data size:" PUBLIC_LOG_D32 ", Get data size:" PUBLIC_LOG_D32 ", offset:" PUBLIC_LOG_D64
         ", readatIndex:" PUBLIC_LOG_D32, bufSize, dataSize, ioContext->offset, readatIndex_.load());
@@ -1144,6 +1438,26 @@ int FFmpegDemuxerPlugin::AVReadPacket(void* opaque, uint8_t* buf, int bufSize)
     return ret;
 }
 
+Status FFmpegDemuxerPlugin::ReadDataSource(IOContext *ioContext, std::shared_ptr<Buffer> &buffer, size_t size)
+{
+    if (ioContext->dataSourceMutex == nullptr) {
+        return ioContext->dataSource->ReadAt(ioContext->offset, buffer, size);
+    }
+    std::lock_guard<std::mutex> lock(*ioContext->dataSourceMutex);
+    return ioContext->dataSource->ReadAt(ioContext->offset, buffer, size);
+}
+
+int FFmpegDemuxerPlugin::ReadBoxCache(IOContext *ioContext, uint8_t *buf, int bufSize)
+{
+    auto &cache = *ioContext->moovCache;
+    size_t start = static_cast<size_t>(ioContext->offset - cache.offset);
+    size_t size = std::min(static_cast<size_t>(bufSize), cache.data.size() - start);
+    FALSE_RETURN_V_MSG_E(memcpy_s(buf, static_cast<size_t>(bufSize), cache.data.data() + start, size) == EOK, -1,
+        "Read moov cache failed.");
+    ioContext->offset += static_cast<int64_t>(size);
+    return static_cast<int>(size);
+}
+
 int64_t FFmpegDemuxerPlugin::AVSeek(void* opaque, int64_t offset, int whence)
 {
     auto ioContext = static_cast<IOContext*>(opaque);
@@ -1209,7 +1523,7 @@ AVIOContext* FFmpegDemuxerPlugin::AllocAVIOContext(int flags, IOContext *ioConte
     return avioContext;
 }
 
-std::shared_ptr<AVFormatContext> FFmpegDemuxerPlugin::InitAVFormatContext(IOContext *ioContext)
+std::shared_ptr<AVFormatContext> FFmpegDemuxerPlugin::InitAVFormatContext(IOContext *ioContext, bool findStreamInfo)
 {
     AVFormatContext* formatContext = avformat_alloc_context();
     FALSE_RETURN_V_MSG_E(formatContext != nullptr, nullptr, "Alloc formatContext failed.");
@@ -1234,7 +1548,7 @@ std::shared_ptr<AVFormatContext> FFmpegDemuxerPlugin::InitAVFormatContext(IOCont
         formatContext->probesize = LIVE_FLV_PROBE_SIZE;
     }
     FALSE_RETURN_V_MSG_E(formatContext->pb->buffer != nullptr, nullptr, "Custom buffer invalid.");
-    ret = avformat_find_stream_info(formatContext, NULL);
+    ret = findStreamInfo ? avformat_find_stream_info(formatContext, NULL) : 0;
     auto finishParse = std::chrono::system_clock::now();
     MEDIA_LOG_I("spend: open " PUBLIC_LOG_F " parse " PUBLIC_LOG_F,
         static_cast<std::chrono::duration<double, std::milli>>(finishiOpen - begin).count(),
@@ -1321,9 +1635,10 @@ Status FFmpegDemuxerPlugin::SetDataSource(const std::shared_ptr<DataSource>& sou
     FALSE_RETURN_V_MSG_E(formatContext_ != nullptr, Status::ERROR_UNKNOWN,
         "Set datasource failed due to can not init formatContext for source.");
     InitParser();
+    trackCursorMode_ = trackCursorEnabled_ && IsTrackCursorSupported();
 
     NotifyInitializationCompleted();
-    MEDIA_LOG_I("SetDataSource finish.");
+    MEDIA_LOG_I("SetDataSource finish, track cursor: " PUBLIC_LOG_D32, static_cast<int32_t>(trackCursorMode_));
     cachelimitSize_ = DEFAULT_CACHE_LIMIT;
     return Status::OK;
 }
@@ -1605,6 +1920,12 @@ Status FFmpegDemuxerPlugin::SelectTrack(uint32_t trackId)
     }
 
     if (!TrackIsSelected(trackId)) {
+        if (trackCursorMode_ && OpenTrackCursor(trackId) != Status::OK) {
+            FALSE_RETURN_V_MSG_E(trackCursors_.empty(), Status::ERROR_UNKNOWN,
+                "Select track failed due to open cursor for track " PUBLIC_LOG_U32 " failed.", trackId);
+            MEDIA_LOG_W("Open track cursor failed, read all tracks through the shared cursor.");
+            trackCursorMode_ = false;
+        }
         selectedTrackIds_.push_back(trackId);
         trackMtx_[trackId] = std::make_shared<std::mutex>();
         trackDfxInfoMap_[trackId] = {0, -1, -1};
@@ -1625,8 +1946,10 @@ Status FFmpegDemuxerPlugin::UnselectTrack(uint32_t trackId)
                               [trackId](uint32_t selectedId) {return trackId == selectedId; });
     if (TrackIsSelected(trackId)) {
         selectedTrackIds_.erase(index);
+        trackCursors_.erase(trackId);
         trackMtx_.erase(trackId);
         trackDfxInfoMap_.erase(trackId);
+        resumeDts_.erase(trackId);
         return cacheQueue_.RemoveTrackQueue(trackId);
     } else {
         MEDIA_LOG_W("Unselect track failed due to track " PUBLIC_LOG_U32 " is not in selected list.", trackId);
@@ -1671,15 +1994,23 @@ Status FFmpegDemuxerPlugin::SeekTo(int32_t trackId, int64_t seekTime, SeekMode m
     MEDIA_LOG_I("Seek:time [" PUBLIC_LOG_U64 "/" PUBLIC_LOG_U64 "/" PUBLIC_LOG_D64 "] flag ["
                 PUBLIC_LOG_D32 "/" PUBLIC_LOG_D32 "]",
                 seekTime, ffTime, realSeekTime, static_cast<int32_t>(mode), flag);
-    auto ret = av_seek_frame(formatContext_.get(), trackIndex, ffTime, flag);
-    if (formatContext_->pb->error) {
-        formatContext_->pb->error = 0;
+    int ret = 0;
+    if (trackCursorMode_) {
+        ret = SeekTrackCursors(trackIndex, ffTime, flag);
+    } else {
+        ret = av_seek_frame(formatContext_.get(), trackIndex, ffTime, flag);
+        if (formatContext_->pb->error) {
+            formatContext_->pb->error = 0;
+        }
     }
     FALSE_RETURN_V_MSG_E(ret >= 0, Status::ERROR_UNKNOWN,
         "Seek failed due to av_seek_frame failed, err: " PUBLIC_LOG_S ".", AVStrError(ret).c_str());
+    lastKeyFrameTime_ = AV_NOPTS_VALUE;
+    resumeDts_.clear();
     for (size_t i = 0; i < selectedTrackIds_.size(); ++i) {
         cacheQueue_.RemoveTrackQueue(selectedTrackIds_[i]);
         cacheQueue_.AddTrackQueue(selectedTrackIds_[i]);
+        trackDfxInfoMap_[selectedTrackIds_[i]].lastDts = AV_NOPTS_VALUE;
     }
     return Status::OK;
 }
@@ -1689,14 +2020,22 @@ Status FFmpegDemuxerPlugin::Flush()
     Status ret = Status::OK;
     std::lock_guard<std::shared_mutex> lock(sharedMutex_);
     MEDIA_LOG_I("Flush enter.");
+    lastKeyFrameTime_ = AV_NOPTS_VALUE;
+    resumeDts_.clear();
     for (size_t i = 0; i < selectedTrackIds_.size(); ++i) {
         ret = cacheQueue_.RemoveTrackQueue(selectedTrackIds_[i]);
         ret = cacheQueue_.AddTrackQueue(selectedTrackIds_[i]);
+        trackDfxInfoMap_[selectedTrackIds_[i]].lastDts = AV_NOPTS_VALUE;
     }
     if (formatContext_) {
         avio_flush(formatContext_.get()->pb);
         avformat_flush(formatContext_.get());
     }
+    for (auto &iter : trackCursors_) {
+        avio_flush(iter.second->formatContext->pb);
+        avformat_flush(iter.second->formatContext.get());
+        iter.second->lastKeyFrameTime = AV_NOPTS_VALUE;
+    }
     return ret;
 }
 
@@ -1705,6 +2044,10 @@ void FFmpegDemuxerPlugin::ResetEosStatus()
     MEDIA_LOG_I("ResetEosStatus enter.");
     formatContext_->pb->eof_reached = 0;
     formatContext_->pb->error = 0;
+    for (auto &iter : trackCursors_) {
+        iter.second->formatContext->pb->eof_reached = 0;
+        iter.second->formatContext->pb->error = 0;
+    }
 }
 
 Status FFmpegDemuxerPlugin::ReadSample(uint32_t trackId, std::shared_ptr<AVBuffer> sample)
@@ -1718,12 +2061,58 @@ Status FFmpegDemuxerPlugin::ReadSample(uint32_t trackId, std::shared_ptr<AVBuffe
     FALSE_RETURN_V_MSG_E(TrackIsSelected(trackId), Status::ERROR_INVALID_PARAMETER, "track has not been selected");
     FALSE_RETURN_V_MSG_E(sample != nullptr && sample->memory_!=nullptr, Status::ERROR_INVALID_PARAMETER,
         "Read Sample failed due to input sample is nullptr");
+    return ReadOneSample(trackId, sample);
+}
+
+Status FFmpegDemuxerPlugin::ReadSamples(uint32_t trackId, const std::vector<std::shared_ptr<AVBuffer>> &samples,
+    uint32_t maxBytes, uint32_t &readCount)
+{
+    std::shared_lock<std::shared_mutex> lock(sharedMutex_);
+    MediaAVCodec::AVCodecTrace trace("ReadSamples");
+    MEDIA_LOG_D("Read " PUBLIC_LOG_ZU " samples for track " PUBLIC_LOG_U32, samples.size(), trackId);
+    readCount = 0;
+    FALSE_RETURN_V_MSG_E(formatContext_ != nullptr, Status::ERROR_NULL_POINTER,
+        "Can not call this func before set data source.");
+    FALSE_RETURN_V_MSG_E(!selectedTrackIds_.empty(), Status::ERROR_INVALID_OPERATION, "No track has been selected.");
+    FALSE_RETURN_V_MSG_E(TrackIsSelected(trackId), Status::ERROR_INVALID_PARAMETER, "track has not been selected");
+    for (const auto &sample : samples) {
+        FALSE_RETURN_V_MSG_E(sample != nullptr && sample->memory_ != nullptr, Status::ERROR_INVALID_PARAMETER,
+            "Read Samples failed due to input sample is nullptr");
+    }
+    uint64_t totalBytes = 0;
+    for (const auto &sample : samples) {
+        if (maxBytes != 0 && readCount > 0) {
+            // the eos buffer carries no data, it is always taken into the batch
+            int32_t nextSize = 0;
+            Status ret = PeekNextSampleSize(trackId, nextSize);
+            if ((ret != Status::OK && ret != Status::END_OF_STREAM) ||
+                totalBytes + static_cast<uint64_t>(nextSize) > maxBytes) {
+                break;
+            }
+        }
+        Status ret = ReadOneSample(trackId, sample);
+        if (ret != Status::OK) {
+            return readCount > 0 ? Status::OK : ret;
+        }
+        ++readCount;
+        totalBytes += static_cast<uint64_t>(sample->memory_->GetSize());
+        if ((sample->flag_ & (static_cast<uint32_t>(AVBufferFlag::EOS) |
+            static_cast<uint32_t>(AVBufferFlag::PARTIAL_FRAME))) != 0) {
+            break;
+        }
+    }
+    return Status::OK;
+}
+
+Status FFmpegDemuxerPlugin::FillCacheQueue(uint32_t trackId)
+{
     Status ret;
     if (NeedCombineFrame(trackId) && cacheQueue_.GetCacheSize(trackId) == 1) {
         ret = ReadPacketToCacheQueue(trackId);
     }
     while (!cacheQueue_.HasCache(trackId)) {
-        ret = ReadPacketToCacheQueue(trackId);
+        WaitForCacheDrain();
+        ret = trackCursorMode_ ? ReadTrackCursorToCacheQueue(trackId) : ReadPacketToCacheQueue(trackId);
         if (ret == Status::END_OF_STREAM) {
             MEDIA_LOG_D("read to end.");
         }
@@ -1734,6 +2123,13 @@ Status FFmpegDemuxerPlugin::ReadSample(uint32_t trackId, std::shared_ptr<AVBuffe
         FALSE_RETURN_V_MSG_E(ret != Status::ERROR_NO_MEMORY, Status::ERROR_NO_MEMORY,
             "cache data size is greater than cache limit size.");
     }
+    return Status::OK;
+}
+
+Status FFmpegDemuxerPlugin::ReadOneSample(uint32_t trackId, std::shared_ptr<AVBuffer> sample)
+{
+    Status ret = FillCacheQueue(trackId);
+    FALSE_RETURN_V(ret == Status::OK, ret);
     std::lock_guard<std::mutex> lockTrack(*trackMtx_[trackId].get());
     auto samplePacket = cacheQueue_.Front(trackId);
     FALSE_RETURN_V_MSG_E(samplePacket != nullptr, Status::ERROR_NULL_POINTER, "Read failed, samplePacket is nullptr");
@@ -1753,6 +2149,9 @@ Status FFmpegDemuxerPlugin::ReadSample(uint32_t trackId, std::shared_ptr<AVBuffe
     } else if (ret == Status::OK) {
         MEDIA_LOG_D("All partial sample has been copied");
         cacheQueue_.Pop(trackId);
+        if (memoryBudget_ != nullptr) {
+            cacheDrainCond_.notify_all();
+        }
     }
     return ret;
 }
@@ -1764,26 +2163,13 @@ Status FFmpegDemuxerPlugin::GetNextSampleSize(uint32_t trackId, int32_t& size)
     MEDIA_LOG_D("Get size for track " PUBLIC_LOG_D32, trackId);
     FALSE_RETURN_V_MSG_E(formatContext_ != nullptr, Status::ERROR_UNKNOWN, "Have not set data source.");
     FALSE_RETURN_V_MSG_E(TrackIsSelected(trackId), Status::ERROR_UNKNOWN, "The track has not been selected");
-    
-    Status ret;
-    if (NeedCombineFrame(trackId) && cacheQueue_.GetCacheSize(trackId) == 1) {
-        ret = ReadPacketToCacheQueue(trackId);
-    }
-    while (!cacheQueue_.HasCache(trackId)) {
-        ret = ReadPacketToCacheQueue(trackId);
-        if (ret == Status::END_OF_STREAM) {
-            MEDIA_LOG_D("read thread, read to end.");
-        } else if (ret == Status::ERROR_UNKNOWN) {
-            MEDIA_LOG_E("read from ffmpeg faild.");
-            return Status::ERROR_UNKNOWN;
-        } else if (ret == Status::ERROR_AGAIN) {
-            MEDIA_LOG_E("read from ffmpeg faild, try again.");
-            return Status::ERROR_AGAIN;
-        } else if (ret == Status::ERROR_NO_MEMORY) {
-            MEDIA_LOG_E("cache data size is greater than cache limit size. ret = " PUBLIC_LOG_D32, ret);
-            return Status::ERROR_NO_MEMORY;
-        }
-    }
+    return PeekNextSampleSize(trackId, size);
+}
+
+Status FFmpegDemuxerPlugin::PeekNextSampleSize(uint32_t trackId, int32_t& size)
+{
+    Status ret = FillCacheQueue(trackId);
+    FALSE_RETURN_V(ret == Status::OK, ret);
     std::shared_ptr<SamplePacket> samplePacket = cacheQueue_.Front(trackId);
     FALSE_RETURN_V_MSG_E(samplePacket != nullptr, Status::ERROR_UNKNOWN, "Cache sample is nullptr");
     if (samplePacket->isEOS) {
@@ -2028,6 +2414,14 @@ Status FFmpegDemuxerPlugin::CheckCacheDataLimit(uint32_t trackId)
             outOfLimit_ = true;
         }
     }
+    // warned once each time the session goes over budget, it does not hide the user limit warning
+    bool overBudget = memoryBudget_ != nullptr && memoryBudget_->IsOverLimit();
+    if (overBudget && !overBudget_.exchange(true)) {
+        MEDIA_LOG_W("Track " PUBLIC_LOG_U32 " cache out of session budget, usage: " PUBLIC_LOG_U64
+            ", reads wait for the cache to drain", trackId, memoryBudget_->GetUsage());
+    } else if (!overBudget) {
+        overBudget_ = false;
+    }
     return Status::OK;
 }
 
@@ -2037,6 +2431,168 @@ void FFmpegDemuxerPlugin::SetCacheLimit(uint32_t limitSize)
     cachelimitSize_ = limitSize;
 }
 
+void FFmpegDemuxerPlugin::SetMemoryBudget(uint64_t budgetId)
+{
+    auto session = budgetId == 0 ? nullptr : MediaAVCodec::MemoryBudget::Find(budgetId);
+    FALSE_RETURN_MSG(budgetId == 0 || session != nullptr, "Memory budget " PUBLIC_LOG_U64 " not found", budgetId);
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->SetReclaimer(nullptr);
+    }
+    std::lock_guard<std::shared_mutex> lock(sharedMutex_);
+    memoryBudget_ = session == nullptr ? nullptr :
+        session->CreateChild("demuxer_cache", MediaAVCodec::MemoryBudget::RECLAIM_DEMUXER_CACHE);
+    cacheQueue_.SetMemoryBudget(memoryBudget_);
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->SetReclaimer([this](uint64_t bytes) { return ReclaimCache(bytes); });
+    }
+}
+
+void FFmpegDemuxerPlugin::WaitForCacheDrain()
+{
+    // reading on only grows the cache of the tracks behind, their readers get a moment to take from it first
+    if (memoryBudget_ == nullptr || memoryBudget_->GetUsage() == 0 || !memoryBudget_->IsOverLimit()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(cacheDrainMutex_);
+    cacheDrainCond_.wait_for(lock, std::chrono::milliseconds(CACHE_DRAIN_WAIT_MS),
+        [this] { return memoryBudget_->GetUsage() == 0 || !memoryBudget_->IsOverLimit(); });
+}
+
+bool FFmpegDemuxerPlugin::CanReclaimCache()
+{
+    // mov seeks every stream by decode time, so each track restarts at or before its first cached packet
+    FALSE_RETURN_V(formatContext_ != nullptr && formatContext_->iformat != nullptr &&
+        std::string(formatContext_->iformat->name).find("mov") != std::string::npos, false);
+    FALSE_RETURN_V(seekable_ == Seekable::SEEKABLE && !trackCursorMode_ && !keyFrameOnly_ && !ioContext_.eos, false);
+    for (auto trackId : selectedTrackIds_) {
+        if (NeedCombineFrame(trackId) || IsWebvttMP4(formatContext_->streams[trackId])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t FFmpegDemuxerPlugin::ReclaimCache(uint64_t bytes)
+{
+    // a read or a seek in progress is not waited for
+    std::unique_lock<std::shared_mutex> lock(sharedMutex_, std::try_to_lock);
+    FALSE_RETURN_V(lock.owns_lock() && CanReclaimCache(), 0);
+    // the newest sample of all tracks goes first, each track keeps the run its reader takes next
+    std::unordered_map<uint32_t, std::vector<std::shared_ptr<SamplePacket>>> samples;
+    std::unordered_map<uint32_t, size_t> dropCount;
+    for (auto trackId : selectedTrackIds_) {
+        samples[trackId] = cacheQueue_.GetSamples(trackId);
+        dropCount[trackId] = 0;
+    }
+    uint64_t freed = 0;
+    while (freed < bytes) {
+        uint32_t dropTrack = 0;
+        if (!PickReclaimTrack(samples, dropCount, dropTrack)) {
+            break;
+        }
+        auto &trackSamples = samples[dropTrack];
+        auto &count = dropCount[dropTrack];
+        for (auto pkt : trackSamples[trackSamples.size() - count - 1]->pkts) {
+            freed += static_cast<uint64_t>(pkt->size);
+        }
+        count++;
+    }
+    FALSE_RETURN_V(freed > 0, 0);
+    int64_t resumeTime = INT64_MAX;
+    std::unordered_map<uint32_t, int64_t> resumeDts;
+    for (auto trackId : selectedTrackIds_) {
+        auto &trackSamples = samples[trackId];
+        int64_t dts = trackDfxInfoMap_[trackId].lastDts == AV_NOPTS_VALUE ? AV_NOPTS_VALUE :
+            trackDfxInfoMap_[trackId].lastDts + 1;
+        if (dropCount[trackId] > 0) {
+            dts = trackSamples[trackSamples.size() - dropCount[trackId]]->pkts[0]->dts;
+        } else if (!trackSamples.empty()) {
+            auto &back = trackSamples.back();
+            // without a position after the kept samples the read again ones could not be told apart
+            FALSE_RETURN_V(!back->isEOS && !back->pkts.empty() && back->pkts[0]->dts != AV_NOPTS_VALUE, 0);
+            dts = back->pkts[0]->dts + 1;
+        }
+        if (dts != AV_NOPTS_VALUE) {
+            resumeDts[trackId] = dts;
+            resumeTime = std::min(resumeTime,
+                AvTime2Us(ConvertTimeFromFFmpeg(dts, formatContext_->streams[trackId]->time_base)));
+        }
+    }
+    int ret = av_seek_frame(formatContext_.get(), -1, resumeTime, AVSEEK_FLAG_BACKWARD);
+    if (formatContext_->pb->error) {
+        formatContext_->pb->error = 0;
+    }
+    FALSE_RETURN_V_MSG_E(ret >= 0, 0, "Reclaim cache failed to seek back, err: " PUBLIC_LOG_S, AVStrError(ret).c_str());
+    resumeDts_ = std::move(resumeDts);
+    for (auto trackId : selectedTrackIds_) {
+        for (size_t i = 0; i < dropCount[trackId]; ++i) {
+            cacheQueue_.PopBack(trackId);
+        }
+    }
+    MEDIA_LOG_I("Reclaim cache " PUBLIC_LOG_U64 "/" PUBLIC_LOG_U64 ", read again from " PUBLIC_LOG_D64,
+        freed, bytes, resumeTime);
+    return freed;
+}
+
+bool FFmpegDemuxerPlugin::PickReclaimTrack(
+    const std::unordered_map<uint32_t, std::vector<std::shared_ptr<SamplePacket>>> &samples,
+    const std::unordered_map<uint32_t, size_t> &dropCount, uint32_t &pickTrack)
+{
+    bool found = false;
+    int64_t pickTime = INT64_MIN;
+    for (const auto &[trackId, trackSamples] : samples) {
+        size_t count = dropCount.at(trackId);
+        if (count >= trackSamples.size()) {
+            continue;
+        }
+        auto &sample = trackSamples[trackSamples.size() - count - 1];
+        // a sample half copied to the reader or the end of the stream cannot be read again
+        if (sample == nullptr || sample->isEOS || sample->offset != 0 || sample->pkts.empty() ||
+            sample->pkts[0]->dts == AV_NOPTS_VALUE) {
+            continue;
+        }
+        int64_t time = AvTime2Us(ConvertTimeFromFFmpeg(sample->pkts[0]->dts,
+            formatContext_->streams[trackId]->time_base));
+        if (!found || time > pickTime || (time == pickTime && trackId > pickTrack)) {
+            pickTrack = trackId;
+            pickTime = time;
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool FFmpegDemuxerPlugin::IsReadBeforeReclaim(const AVPacket &pkt)
+{
+    auto iter = resumeDts_.find(static_cast<uint32_t>(pkt.stream_index));
+    if (iter == resumeDts_.end()) {
+        return false;
+    }
+    if (pkt.dts != AV_NOPTS_VALUE && pkt.dts < iter->second) {
+        return true;
+    }
+    resumeDts_.erase(iter);
+    return false;
+}
+
+Status FFmpegDemuxerPlugin::SetKeyFrameOnly(bool keyFrameOnly)
+{
+    std::lock_guard<std::shared_mutex> lock(sharedMutex_);
+    MEDIA_LOG_I("Set key frame only " PUBLIC_LOG_D32, static_cast<int32_t>(keyFrameOnly));
+    keyFrameOnly_ = keyFrameOnly;
+    lastKeyFrameTime_ = AV_NOPTS_VALUE;
+    for (auto &iter : trackCursors_) {
+        iter.second->lastKeyFrameTime = AV_NOPTS_VALUE;
+    }
+    return Status::OK;
+}
+
+void FFmpegDemuxerPlugin::SetLocalSource(bool isLocalSource)
+{
+    std::lock_guard<std::shared_mutex> lock(sharedMutex_);
+    isLocalSource_ = isLocalSource;
+}
+
 namespace { // plugin set
 int Sniff(const std::string& pluginName, std::shared_ptr<DataSource> dataSource)
 {
@@ -2060,8 +2616,7 @@ int Sniff(const std::string& pluginName, std::shared_ptr<DataSource> dataSource)
     FALSE_RETURN_V_MSG_E(bufferInfo->GetMemory() != nullptr, 0, "Sniff failed due to alloc buffer failed.");
     Status ret;
     {
-        std::string traceName = "Sniff_" + pluginName + "_Readat";
-        MediaAVCodec::AVCodecTrace trace(traceName.c_str());
+        MediaAVCodec::AVCodecTrace trace("FFmpegDemuxerPlugin::Sniff_ReadAt");
         ret = dataSource->ReadAt(0, bufferInfo, bufferSize);
     }
     FALSE_RETURN_V_MSG_E(ret == Status::OK, 0, "Sniff failed due to read probe data failed.");
@@ -2095,6 +2650,20 @@ void ReplaceDelimiter(const std::string& delmiters, char newDelimiter, std::stri
     MEDIA_LOG_D("Reset to [" PUBLIC_LOG_S "].", str.c_str());
 };
 
+bool IsHevcIrapFrame(const uint8_t *data, uint32_t size)
+{
+    uint32_t pos = OHOS::MediaAVCodec::NalUnitScanner::FindStartCode(data, size, 0);
+    while (pos + OHOS::MediaAVCodec::NalUnitScanner::START_CODE_LEN < size) {
+        uint32_t headerPos = pos + OHOS::MediaAVCodec::NalUnitScanner::START_CODE_LEN;
+        uint8_t nalType = (data[headerPos] >> HEVC_NAL_TYPE_SHIFT) & HEVC_NAL_TYPE_MASK;
+        if (nalType >= HEVC_IRAP_NAL_MIN && nalType <= HEVC_IRAP_NAL_MAX) {
+            return true;
+        }
+        pos = OHOS::MediaAVCodec::NalUnitScanner::FindStartCode(data, size, headerPos);
+    }
+    return false;
+}
+
 Status RegisterPlugins(const std::shared_ptr<Register>& reg)
 {
     MEDIA_LOG_I("Register ffmpeg demuxer plugin.");
@@ -17,6 +17,7 @@
 #define FFMPEG_DEMUXER_PLUGIN_H
 
 #include <atomic>
+#include <condition_variable>
 #include <vector>
 #include <thread>
 #include <map>
@@ -63,6 +64,8 @@ public:
     Status UnselectTrack(uint32_t trackId) override;
     Status SeekTo(int32_t trackId, int64_t seekTime, SeekMode mode, int64_t& realSeekTime) override;
     Status ReadSample(uint32_t trackId, std::shared_ptr<AVBuffer> sample) override;
+    Status ReadSamples(uint32_t trackId, const std::vector<std::shared_ptr<AVBuffer>> &samples, uint32_t maxBytes,
+        uint32_t &readCount) override;
     Status GetNextSampleSize(uint32_t trackId, int32_t& size) override;
     Status GetDrmInfo(std::multimap<std::string, std::vector<uint8_t>>& drmInfo) override;
     void ResetEosStatus() override;
@@ -78,6 +81,9 @@ public:
     Status GetRelativePresentationTimeUsByIndex(const uint32_t trackIndex,
         const uint32_t index, uint64_t &relativePresentationTimeUs) override;
     void SetCacheLimit(uint32_t limitSize) override;
+    void SetMemoryBudget(uint64_t budgetId) override;
+    Status SetKeyFrameOnly(bool keyFrameOnly) override;
+    void SetLocalSource(bool isLocalSource) override;
 
 private:
     enum DumpMode : unsigned long {
@@ -91,6 +97,11 @@ private:
         INDEX_TO_RELATIVEPTS,
         RELATIVEPTS_TO_INDEX,
     };
+    // a top level box read once, the track cursors parse it from memory instead of the data source
+    struct BoxCache {
+        int64_t offset {0};
+        std::vector<uint8_t> data {};
+    };
     struct IOContext {
         std::shared_ptr<DataSource> dataSource {nullptr};
         int64_t offset {0};
@@ -100,16 +111,27 @@ private:
         uint32_t initDownloadDataSize {0};
         std::atomic<bool> initCompleted {false};
         DumpMode dumpMode {DUMP_NONE};
+        std::mutex *dataSourceMutex {nullptr}; // shared by the contexts reading one data source at the same time
+        std::shared_ptr<BoxCache> moovCache {nullptr};
+    };
+    // reads one track through its own format context, every other stream is discarded
+    struct TrackCursor {
+        IOContext ioContext;
+        std::shared_ptr<AVFormatContext> formatContext {nullptr};
+        std::atomic<int64_t> lastKeyFrameTime {AV_NOPTS_VALUE};
+        std::atomic<int64_t> readTime {AV_NOPTS_VALUE}; // dts of the last packet read, in AV_TIME_BASE
     };
     void ConvertCsdToAnnexb(const AVStream& avStream, Meta &format);
     int64_t GetFileDuration(const AVFormatContext& avFormatContext);
     int64_t GetStreamDuration(const AVStream& avStream);
 
     static int AVReadPacket(void* opaque, uint8_t* buf, int bufSize);
+    static Status ReadDataSource(IOContext *ioContext, std::shared_ptr<Buffer> &buffer, size_t size);
+    static int ReadBoxCache(IOContext *ioContext, uint8_t *buf, int bufSize);
     static int AVWritePacket(void* opaque, uint8_t* buf, int bufSize);
     static int64_t AVSeek(void* opaque, int64_t offset, int whence);
     AVIOContext* AllocAVIOContext(int flags, IOContext *ioContext);
-    std::shared_ptr<AVFormatContext> InitAVFormatContext(IOContext *ioContext);
+    std::shared_ptr<AVFormatContext> InitAVFormatContext(IOContext *ioContext, bool findStreamInfo = true);
     static int CheckContextIsValid(void* opaque, int &bufSize);
     void NotifyInitializationCompleted();
 
@@ -120,12 +142,23 @@ private:
     bool TrackIsSelected(const uint32_t trackId);
     Status ReadPacketToCacheQueue(const uint32_t readId);
     Status AddPacketToCacheQueue(AVPacket *pkt);
+    bool IsSkippedByKeyFrameOnly(const AVPacket &pkt, bool canSeek, std::atomic<int64_t> &lastKeyFrameTime);
+    void SeekToNextKeyFrame(AVFormatContext *formatContext, int trackIndex, int64_t keyFrameTime);
+    bool IsTrackCursorSupported();
+    Status OpenTrackCursor(uint32_t trackId);
+    std::shared_ptr<BoxCache> LoadMoovCache();
+    size_t ReadSourceAt(int64_t offset, uint8_t *buf, size_t size);
+    Status ReadTrackCursorToCacheQueue(uint32_t trackId);
+    int SeekTrackCursors(int trackIndex, int64_t ffTime, int flag);
     Status SetDrmCencInfo(std::shared_ptr<AVBuffer> sample, std::shared_ptr<SamplePacket> samplePacket);
     void WriteBufferAttr(std::shared_ptr<AVBuffer> sample, std::shared_ptr<SamplePacket> samplePacket);
     Status ConvertAVPacketToSample(std::shared_ptr<AVBuffer> sample, std::shared_ptr<SamplePacket> samplePacket);
     void ConvertPacketToAnnexb(std::shared_ptr<AVBuffer> sample, AVPacket* avpacket,
         std::shared_ptr<SamplePacket> dstSamplePacket);
     Status SetEosSample(std::shared_ptr<AVBuffer> sample);
+    Status FillCacheQueue(uint32_t trackId);
+    Status ReadOneSample(uint32_t trackId, std::shared_ptr<AVBuffer> sample);
+    Status PeekNextSampleSize(uint32_t trackId, int32_t& size);
     Status WriteBuffer(std::shared_ptr<AVBuffer> outBuffer, const uint8_t *writeData, int32_t writeSize);
     void ParseDrmInfo(const MetaDrmInfo *const metaDrmInfo, int32_t drmInfoSize,
         std::multimap<std::string, std::vector<uint8_t>>& drmInfo);
@@ -145,6 +178,12 @@ private:
     bool IsWebvttMP4(const AVStream *avStream);
     void WebvttMP4EOSProcess(const AVPacket *pkt);
     Status CheckCacheDataLimit(uint32_t trackId);
+    void WaitForCacheDrain();
+    bool CanReclaimCache();
+    uint64_t ReclaimCache(uint64_t bytes);
+    bool PickReclaimTrack(const std::unordered_map<uint32_t, std::vector<std::shared_ptr<SamplePacket>>> &samples,
+        const std::unordered_map<uint32_t, size_t> &dropCount, uint32_t &pickTrack);
+    bool IsReadBeforeReclaim(const AVPacket &pkt);
 
     Status GetPresentationTimeUsFromFfmpegMOV(IndexAndPTSConvertMode mode,
         uint32_t trackIndex, int64_t absolutePTS, uint32_t index);
@@ -174,6 +213,17 @@ private:
     IOContext ioContext_;
     std::vector<uint32_t> selectedTrackIds_;
     BlockQueuePool cacheQueue_;
+    bool keyFrameOnly_ {false};
+    // set when the frames up to the next key frame can be seeked over, taken by the next read
+    std::atomic<int64_t> lastKeyFrameTime_ {AV_NOPTS_VALUE};
+    bool trackCursorEnabled_ {true};
+    bool isLocalSource_ {false};
+    bool trackCursorMode_ {false}; // every selected track reads from its own cursor instead of the shared one
+    std::unordered_map<uint32_t, std::shared_ptr<TrackCursor>> trackCursors_;
+    int64_t cursorSeekTime_ {AV_NOPTS_VALUE}; // last seek of the cursors, in AV_TIME_BASE
+    uint32_t cursorTrackCount_ {0};
+    std::shared_ptr<BoxCache> moovCache_ {nullptr}; // kept until every track that can be selected has a cursor
+    std::mutex dataSourceMutex_;
 
     std::shared_ptr<AVInputFormat> pluginImpl_ {nullptr};
     std::shared_ptr<AVFormatContext> formatContext_ {nullptr};
@@ -201,8 +251,14 @@ private:
     bool updatePosIsForward_ = true;
     bool isInit_ = false;
     uint32_t cachelimitSize_ = 0;
-    bool outOfLimit_ = false;
+    std::atomic<bool> outOfLimit_ {false}; // set by the track cursors concurrently
+    std::atomic<bool> overBudget_ {false};
     bool setLimitByUser = false;
+    std::shared_ptr<MediaAVCodec::MemoryBudget> memoryBudget_ {nullptr};
+    std::mutex cacheDrainMutex_;
+    std::condition_variable cacheDrainCond_;
+    // after a cache reclaim, the packets of a track below this dts were already read and are dropped
+    std::unordered_map<uint32_t, int64_t> resumeDts_;
 
     // dfx
     struct TrackDfxInfo {
@@ -210,6 +266,7 @@ private:
         int64_t lastPts;
         int64_t lastPos;
         int64_t lastDurantion;
+        int64_t lastDts = AV_NOPTS_VALUE; // where a cache reclaim resumes a track without cached packets
     };
     struct DumpParam {
         DumpMode mode;
@@ -224,7 +281,7 @@ private:
     std::unordered_map<int, TrackDfxInfo> trackDfxInfoMap_;
     DumpMode dumpMode_ {DUMP_NONE};
     static std::atomic<int> readatIndex_;
-    int avpacketIndex_ {0};
+    std::atomic<int> avpacketIndex_ {0};
 
     static void Dump(const DumpParam &dumpParam);
 };
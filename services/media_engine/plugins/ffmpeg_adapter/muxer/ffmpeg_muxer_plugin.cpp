@@ -21,6 +21,7 @@
 #include <set>
 
 #include "securec.h"
+#include "avcodec_latency_stats.h"
 #include "common/log.h"
 #include "ffmpeg_utils.h"
 #include "ffmpeg_converter.h"
@@ -36,12 +37,19 @@ using namespace Ffmpeg;
 std::map<std::string, std::shared_ptr<AVOutputFormat>> g_pluginOutputFmt;
 
 std::set<std::string> g_supportedMuxer = {"mp4", "ipod", "amr", "mp3", "wav"};
-constexpr uint8_t START_CODE[] = {0x00, 0x00, 0x01};
 constexpr float LATITUDE_MIN = -90.0f;
 constexpr float LATITUDE_MAX = 90.0f;
 constexpr float LONGITUDE_MIN = -180.0f;
 constexpr float LONGITUDE_MAX = 180.0f;
 const std::string TIMED_METADATA_HANDLER_NAME = "timed_metadata";
+constexpr int32_t DEFAULT_FRAGMENT_DURATION_MS = 1000;
+constexpr int32_t MIN_FRAGMENT_DURATION_MS = 100;
+constexpr int64_t MS_TO_US = 1000;
+// every avio flush is one DataSink::Write, a large buffer turns a video frame into a single write
+constexpr int32_t DEFAULT_IO_BUFFER_SIZE = 256 * 1024;
+constexpr int32_t MIN_IO_BUFFER_SIZE = 4 * 1024;
+constexpr int32_t MAX_IO_BUFFER_SIZE = 4 * 1024 * 1024;
+constexpr int32_t IO_BUFFER_ALIGN = 4 * 1024; // page size, buffer sized writes stay page aligned in the file
 
 bool IsMuxerSupported(const char *name)
 {
@@ -193,7 +201,7 @@ namespace Media {
 namespace Plugins {
 namespace Ffmpeg {
 FFmpegMuxerPlugin::FFmpegMuxerPlugin(std::string name)
-    : MuxerPlugin(std::move(name)), isWriteHeader_(false)
+    : MuxerPlugin(std::move(name)), isWriteHeader_(false), ioBufferSize_(DEFAULT_IO_BUFFER_SIZE)
 {
     MEDIA_LOG_D("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
 #ifndef _WIN32
@@ -237,8 +245,9 @@ Status FFmpegMuxerPlugin::SetDataSink(const std::shared_ptr<DataSink> &dataSink)
 {
     FALSE_RETURN_V_MSG_E(dataSink != nullptr, Status::ERROR_INVALID_PARAMETER, "data sink is null");
     DeInitAvIoCtx(formatContext_->pb);
-    formatContext_->pb = InitAvIoCtx(dataSink, 1);
+    formatContext_->pb = InitAvIoCtx(dataSink, 1, ioBufferSize_);
     FALSE_RETURN_V_MSG_E(formatContext_->pb != nullptr, Status::ERROR_INVALID_OPERATION, "failed to create io");
+    dataSink_ = dataSink;
     canReadFile_ = dataSink->CanRead();
     return Status::NO_ERROR;
 }
@@ -255,6 +264,10 @@ Status FFmpegMuxerPlugin::SetParameter(const std::shared_ptr<Meta> &param)
         useTimedMetadata_ = true;
         MEDIA_LOG_I("use timed metadata track");
     }
+    ret = SetFragment(param);
+    FALSE_RETURN_V_MSG_E(ret == Status::NO_ERROR, ret, "SetParameter failed");
+    ret = SetIoBufferSize(param);
+    FALSE_RETURN_V_MSG_E(ret == Status::NO_ERROR, ret, "SetParameter failed");
     ret = SetRotation(param);
     FALSE_RETURN_V_MSG_E(ret == Status::NO_ERROR, ret, "SetParameter failed");
     ret = SetLocation(param);
@@ -264,6 +277,51 @@ Status FFmpegMuxerPlugin::SetParameter(const std::shared_ptr<Meta> &param)
     return ret;
 }
 
+Status FFmpegMuxerPlugin::SetFragment(std::shared_ptr<Meta> param)
+{
+    int32_t dataInt = 0;
+    if (!param->GetData("fragmented_mp4", dataInt) || dataInt != 1) {
+        return Status::NO_ERROR;
+    }
+    std::string fmtName = outputFormat_ != nullptr ? outputFormat_->name : "";
+    FALSE_RETURN_V_MSG_E(fmtName == "mp4" || fmtName == "ipod", Status::ERROR_INVALID_DATA,
+        "fragmented output is not supported by %{public}s", fmtName.c_str());
+    int32_t durationMs = DEFAULT_FRAGMENT_DURATION_MS;
+    if (param->GetData("fragment_duration", durationMs)) {
+        FALSE_RETURN_V_MSG_E(durationMs >= MIN_FRAGMENT_DURATION_MS, Status::ERROR_INVALID_DATA,
+            "fragment duration %{public}d ms is too short", durationMs);
+    }
+    isFragmented_ = true;
+    fragmentDurationUs_ = static_cast<int64_t>(durationMs) * MS_TO_US;
+    MEDIA_LOG_I("fragmented mp4, fragment duration " PUBLIC_LOG_D32 " ms", durationMs);
+    return Status::NO_ERROR;
+}
+
+Status FFmpegMuxerPlugin::SetIoBufferSize(const std::shared_ptr<Meta> &param)
+{
+    int32_t size = 0;
+    if (!param->GetData("io_buffer_size", size)) {
+        return Status::NO_ERROR;
+    }
+    FALSE_RETURN_V_MSG_E(!isWriteHeader_, Status::ERROR_WRONG_STATE, "io buffer size must be set before start");
+    FALSE_RETURN_V_MSG_E(size >= MIN_IO_BUFFER_SIZE && size <= MAX_IO_BUFFER_SIZE, Status::ERROR_INVALID_DATA,
+        "io buffer size " PUBLIC_LOG_D32 " is out of range", size);
+    size = (size + IO_BUFFER_ALIGN - 1) / IO_BUFFER_ALIGN * IO_BUFFER_ALIGN;
+    if (size == ioBufferSize_) {
+        return Status::NO_ERROR;
+    }
+    ioBufferSize_ = size;
+    MEDIA_LOG_I("io buffer size " PUBLIC_LOG_D32, ioBufferSize_);
+    if (dataSink_ == nullptr) {
+        return Status::NO_ERROR;
+    }
+    // nothing is written before the header, so the io context is simply recreated with the new buffer
+    DeInitAvIoCtx(formatContext_->pb);
+    formatContext_->pb = InitAvIoCtx(dataSink_, 1, ioBufferSize_);
+    FALSE_RETURN_V_MSG_E(formatContext_->pb != nullptr, Status::ERROR_INVALID_OPERATION, "failed to create io");
+    return Status::NO_ERROR;
+}
+
 Status FFmpegMuxerPlugin::SetRotation(std::shared_ptr<Meta> param)
 {
     if (param->Find(Tag::VIDEO_ROTATION) != param->end()) {
@@ -731,7 +789,14 @@ Status FFmpegMuxerPlugin::AddTrack(int32_t &trackIndex, const std::shared_ptr<Me
 void FFmpegMuxerPlugin::HandleOptions(std::string& optionName)
 {
     std::vector<std::string> options {};
-    if (canReadFile_ && isFastStart_) {
+    if (isFragmented_) {
+        // moof+mdat are flushed per fragment, the moov is delayed until the codec config of annex-b
+        // streams is known, and no trailer pass over the sample tables is needed at stop.
+        options.push_back("frag_keyframe");
+        options.push_back("empty_moov");
+        options.push_back("delay_moov");
+        options.push_back("default_base_moof");
+    } else if (canReadFile_ && isFastStart_) {
         options.push_back("faststart");
     }
     if (useTimedMetadata_) {
@@ -747,6 +812,21 @@ void FFmpegMuxerPlugin::HandleOptions(std::string& optionName)
     }
 }
 
+void FFmpegMuxerPlugin::HandleFragmentOptions(AVDictionary **options)
+{
+    bool hasVideo = false;
+    for (uint32_t i = 0; i < formatContext_->nb_streams; i++) {
+        if (formatContext_->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO &&
+            !(formatContext_->streams[i]->disposition & AV_DISPOSITION_ATTACHED_PIC)) {
+            hasVideo = true;
+            break;
+        }
+    }
+    // with video, cut at the first key frame once the duration is reached so that every fragment
+    // is independently decodable; audio only streams are cut by duration.
+    av_dict_set_int(options, hasVideo ? "min_frag_duration" : "frag_duration", fragmentDurationUs_, 0);
+}
+
 Status FFmpegMuxerPlugin::Start()
 {
     FALSE_RETURN_V_MSG_E(formatContext_->pb != nullptr, Status::ERROR_INVALID_OPERATION, "data sink is not set");
@@ -770,7 +850,11 @@ Status FFmpegMuxerPlugin::Start()
     if (optionName.size() != 0) {
         av_dict_set(&options, "movflags", optionName.c_str(), 0);
     }
+    if (isFragmented_) {
+        HandleFragmentOptions(&options);
+    }
     int ret = avformat_write_header(formatContext_.get(), &options);
+    av_dict_free(&options);
     if (ret < 0) {
         MEDIA_LOG_E("write header failed, %{public}s", AVStrError(ret).c_str());
         return Status::ERROR_UNKNOWN;
@@ -809,8 +893,8 @@ Status FFmpegMuxerPlugin::WriteSample(uint32_t trackIndex, const std::shared_ptr
         "track index is invalid!");
     MEDIA_LOG_D("WriteSample track:" PUBLIC_LOG_U32 ", pts:" PUBLIC_LOG_D64 ", size:" PUBLIC_LOG_D32
         ", flags:" PUBLIC_LOG_U32, trackIndex, sample->pts_, sample->memory_->GetSize(), sample->flag_);
-
-    std::lock_guard<std::mutex> lock(mutex_);
+    // taken on the writer thread with no lock held, so it covers the sample conversion and the write only
+    MediaAVCodec::AVCodecLatencyScope latency(MediaAVCodec::LatencyStage::MUX);
     auto st = formatContext_->streams[trackIndex];
     if (st->codecpar->codec_id == AV_CODEC_ID_H264 || st->codecpar->codec_id == AV_CODEC_ID_HEVC) {
         return WriteVideoSample(trackIndex, sample);
@@ -819,11 +903,17 @@ Status FFmpegMuxerPlugin::WriteSample(uint32_t trackIndex, const std::shared_ptr
 }
 
 Status FFmpegMuxerPlugin::WriteNormal(uint32_t trackIndex, const std::shared_ptr<AVBuffer> &sample)
+{
+    return WriteNormal(trackIndex, sample, sample->memory_->GetAddr(), sample->memory_->GetSize());
+}
+
+Status FFmpegMuxerPlugin::WriteNormal(uint32_t trackIndex, const std::shared_ptr<AVBuffer> &sample,
+    uint8_t *data, int32_t size)
 {
     auto st = formatContext_->streams[trackIndex];
     (void)memset_s(cachePacket_.get(), sizeof(AVPacket), 0, sizeof(AVPacket));
-    cachePacket_->data = sample->memory_->GetAddr();
-    cachePacket_->size = sample->memory_->GetSize();
+    cachePacket_->data = data;
+    cachePacket_->size = size;
     cachePacket_->stream_index = static_cast<int>(trackIndex);
     cachePacket_->pts = ConvertTimeToFFmpegByUs(sample->pts_, st->time_base);
 
@@ -852,7 +942,7 @@ Status FFmpegMuxerPlugin::WriteNormal(uint32_t trackIndex, const std::shared_ptr
     if (ret < 0) {
         MEDIA_LOG_E("write sample buffer failed, " PUBLIC_LOG_S ". track id: " PUBLIC_LOG_U32
             ", pts: " PUBLIC_LOG_D64 ", flag: " PUBLIC_LOG_U32 ", size: " PUBLIC_LOG_D32,
-            AVStrError(ret).c_str(), trackIndex, sample->pts_, sample->flag_, sample->memory_->GetSize());
+            AVStrError(ret).c_str(), trackIndex, sample->pts_, sample->flag_, size);
         return Status::ERROR_UNKNOWN;
     }
     return Status::NO_ERROR;
@@ -894,52 +984,26 @@ Status FFmpegMuxerPlugin::WriteVideoSample(uint32_t trackIndex, const std::share
         }
     }
     if (videoTracksInfo_[trackIndex].isNeedTransData_) {
-        std::vector<uint8_t> nonAnnexbData = TransAnnexbToMp4(sample->memory_->GetAddr(), sample->memory_->GetSize());
-        int32_t size = static_cast<int32_t>(nonAnnexbData.size());
-        FALSE_RETURN_V_MSG_E(size > 0, Status::ERROR_INVALID_DATA, "annexb to mp4 is empty!");
-        std::shared_ptr<AVBuffer> buffer = AVBuffer::CreateAVBuffer(nonAnnexbData.data(), size, size);
-        buffer->pts_ = sample->pts_;
-        buffer->flag_ = sample->flag_;
-        return WriteNormal(trackIndex, buffer);
+        return WriteAnnexbSample(trackIndex, sample);
     }
     return WriteNormal(trackIndex, sample);
 }
 
-std::vector<uint8_t> FFmpegMuxerPlugin::TransAnnexbToMp4(const uint8_t *sample, int32_t size)
-{
-    std::vector<uint8_t> data;
-    uint8_t *nalStart = const_cast<uint8_t *>(sample);
-    uint8_t *end = nalStart + size;
-    uint8_t *nalEnd = nullptr;
-    int32_t startCodeLen = 0;
-    uint32_t naluSize = 0;
-
-    nalStart = FindNalStartCode(nalStart, end, startCodeLen);
-    nalStart = nalStart + startCodeLen;
-    while (nalStart < end) {
-        nalEnd = FindNalStartCode(nalStart, end, startCodeLen);
-        naluSize = static_cast<uint32_t>(nalEnd - nalStart);
-        for (int32_t i = sizeof(naluSize) - 1; i >= 0; --i) {
-            data.emplace_back((naluSize >> (i * 0x08)) & 0xFF);
-        }
-        data.insert(data.end(), nalStart, nalEnd);
-        nalStart = nalEnd + startCodeLen;
-    }
-    return data;
-}
-
-uint8_t *FFmpegMuxerPlugin::FindNalStartCode(const uint8_t *buf, const uint8_t *end, int32_t &startCodeLen)
+Status FFmpegMuxerPlugin::WriteAnnexbSample(uint32_t trackIndex, const std::shared_ptr<AVBuffer> &sample)
 {
-    startCodeLen = sizeof(START_CODE);
-    auto *iter = std::search(buf, end, START_CODE, START_CODE + startCodeLen);
-    if (iter != end) {
-        if (iter > buf && *(iter - 1) == 0x00) {
-            ++startCodeLen;
-            return const_cast<uint8_t *>(iter - 1);
-        }
+    uint8_t *data = sample->memory_->GetAddr();
+    uint32_t size = static_cast<uint32_t>(sample->memory_->GetSize());
+    MediaAVCodec::NalUnitScanner::Scan(data, size, nalUnits_);
+    FALSE_RETURN_V_MSG_E(!nalUnits_.empty(), Status::ERROR_INVALID_DATA, "annexb to mp4 is empty!");
+    // av_write_frame does not keep the packet data, so the start codes are put back before the caller sees it
+    if (MediaAVCodec::NalUnitScanner::ToLengthPrefixedInPlace(data, size, nalUnits_)) {
+        uint32_t offset = nalUnits_.front().startCodePos;
+        Status ret = WriteNormal(trackIndex, sample, data + offset, static_cast<int32_t>(size - offset));
+        MediaAVCodec::NalUnitScanner::RestoreStartCodes(data, nalUnits_);
+        return ret;
     }
-
-    return const_cast<uint8_t *>(iter);
+    uint32_t outSize = MediaAVCodec::NalUnitScanner::ToLengthPrefixed(data, size, nalUnits_, annexbScratch_);
+    return WriteNormal(trackIndex, sample, annexbScratch_.data(), static_cast<int32_t>(outSize));
 }
 
 bool FFmpegMuxerPlugin::IsAvccSample(const uint8_t* sample, int32_t size, int32_t nalSizeLen)
@@ -982,7 +1046,8 @@ Status FFmpegMuxerPlugin::SetNalSizeLen(AVStream *stream, const std::vector<uint
     return Status::NO_ERROR;
 }
 
-AVIOContext* FFmpegMuxerPlugin::InitAvIoCtx(const std::shared_ptr<DataSink>& dataSink, int writeFlags)
+AVIOContext* FFmpegMuxerPlugin::InitAvIoCtx(const std::shared_ptr<DataSink>& dataSink, int writeFlags,
+    int bufferSize)
 {
     if (dataSink == nullptr) {
         return nullptr;
@@ -991,8 +1056,8 @@ AVIOContext* FFmpegMuxerPlugin::InitAvIoCtx(const std::shared_ptr<DataSink>& dat
     ioContext->dataSink_ = dataSink;
     ioContext->pos_ = 0;
     ioContext->end_ = dataSink->Seek(0ll, SEEK_END);
+    ioContext->bufferSize_ = bufferSize;
 
-    constexpr int bufferSize = 4 * 1024; // 4096
     auto buffer = static_cast<unsigned char*>(av_malloc(bufferSize));
     AVIOContext *avioContext = avio_alloc_context(buffer, bufferSize, writeFlags, static_cast<void*>(ioContext),
                                                   IoRead, IoWrite, IoSeek);
@@ -1087,7 +1152,8 @@ int32_t FFmpegMuxerPlugin::IoOpen(AVFormatContext *s, AVIOContext **pb,
                                   const char *url, int flags, AVDictionary **options)
 {
     MEDIA_LOG_D("IoOpen flags %{public}d", flags);
-    *pb = InitAvIoCtx(static_cast<IOContext*>(s->pb->opaque)->dataSink_, 0);
+    auto ioContext = static_cast<IOContext*>(s->pb->opaque);
+    *pb = InitAvIoCtx(ioContext->dataSink_, 0, ioContext->bufferSize_);
     if (*pb == nullptr) {
         MEDIA_LOG_E("IoOpen failed");
         return -1;
@@ -16,9 +16,9 @@
 #ifndef AVCODEC_FFMPEG_MUXER_PLUGIN_H
 #define AVCODEC_FFMPEG_MUXER_PLUGIN_H
 
-#include <mutex>
 #include <unordered_map>
 #include "plugin/muxer_plugin.h"
+#include "nal_unit_scanner.h"
 #include "stream_parser_manager.h"
 
 #ifdef __cplusplus
@@ -34,6 +34,7 @@ namespace OHOS {
 namespace Media {
 namespace Plugins {
 namespace Ffmpeg {
+// Samples of every track arrive through the single interleaving writer thread of MediaMuxer, so writing takes no lock
 class FFmpegMuxerPlugin : public MuxerPlugin {
 public:
     explicit FFmpegMuxerPlugin(std::string name);
@@ -49,6 +50,7 @@ public:
     Status Reset() override;
 
 private:
+    Status SetFragment(std::shared_ptr<Meta> param);
     Status SetRotation(std::shared_ptr<Meta> param);
     Status SetLocation(std::shared_ptr<Meta> param);
     Status SetMetaData(std::shared_ptr<Meta> param);
@@ -66,16 +68,18 @@ private:
     Status AddVideoTrack(int32_t &trackIndex, const std::shared_ptr<Meta> &trackDesc, AVCodecID codeID, bool isCover);
     Status AddTimedMetaTrack(int32_t &trackIndex, const std::shared_ptr<Meta> &trackDesc, AVCodecID codeID);
     Status WriteNormal(uint32_t trackIndex, const std::shared_ptr<AVBuffer> &sample);
+    Status WriteNormal(uint32_t trackIndex, const std::shared_ptr<AVBuffer> &sample, uint8_t *data, int32_t size);
     Status WriteVideoSample(uint32_t trackIndex, const std::shared_ptr<AVBuffer> &sample);
-    std::vector<uint8_t> TransAnnexbToMp4(const uint8_t *sample, int32_t size);
-    uint8_t *FindNalStartCode(const uint8_t *buf, const uint8_t *end, int32_t &startCodeLen);
+    Status WriteAnnexbSample(uint32_t trackIndex, const std::shared_ptr<AVBuffer> &sample);
     bool IsAvccSample(const uint8_t* sample, int32_t size, int32_t nalSizeLen);
     Status SetNalSizeLen(AVStream *stream, const std::vector<uint8_t> &codecConfig);
+    Status SetIoBufferSize(const std::shared_ptr<Meta> &param);
     void HandleOptions(std::string& optionName);
+    void HandleFragmentOptions(AVDictionary **options);
     static int32_t IoRead(void *opaque, uint8_t *buf, int bufSize);
     static int32_t IoWrite(void *opaque, uint8_t *buf, int bufSize);
     static int64_t IoSeek(void *opaque, int64_t offset, int whence);
-    static AVIOContext *InitAvIoCtx(const std::shared_ptr<DataSink> &dataSink, int writeFlags);
+    static AVIOContext *InitAvIoCtx(const std::shared_ptr<DataSink> &dataSink, int writeFlags, int bufferSize);
     static void DeInitAvIoCtx(AVIOContext *ptr);
     static int32_t IoOpen(AVFormatContext *s, AVIOContext **pb, const char *url, int flags, AVDictionary **options);
     static void IoClose(AVFormatContext *s, AVIOContext *pb);
@@ -85,6 +89,7 @@ private:
         std::shared_ptr<DataSink> dataSink_ {};
         int64_t pos_ {0};
         int64_t end_ {0};
+        int bufferSize_ {0};
     };
 
     struct VideoSampleInfo {
@@ -104,9 +109,15 @@ private:
     bool isFastStart_ = {false};
     bool canReadFile_ = {false};
     bool useTimedMetadata_ = {false};
+    bool isFragmented_ = {false};
+    int64_t fragmentDurationUs_ {0};
+    int32_t ioBufferSize_ {0};
+    std::shared_ptr<DataSink> dataSink_ {nullptr};
     std::shared_ptr<StreamParserManager> hevcParser_ {nullptr};
     std::unordered_map<int32_t, VideoSampleInfo> videoTracksInfo_;
-    std::mutex mutex_;
+    // reused for every annex-b sample, the scratch buffer only serves samples with 3 byte start codes
+    std::vector<MediaAVCodec::NalUnitInfo> nalUnits_;
+    std::vector<uint8_t> annexbScratch_;
 };
 } // namespace Ffmpeg
 } // namespace Plugins
@@ -146,6 +146,25 @@ HttpMediaDownloader::~HttpMediaDownloader()
 {
     MEDIA_LOG_I("%{public}p ~HttpMediaDownloader dtor", this);
     Close(false);
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Release(ringBufferCharge_);
+    }
+}
+
+void HttpMediaDownloader::SetMemoryBudget(uint64_t budgetId)
+{
+    auto session = MediaAVCodec::MemoryBudget::Find(budgetId);
+    FALSE_RETURN_MSG(session != nullptr && memoryBudget_ == nullptr, "Memory budget " PUBLIC_LOG_U64 " not applied",
+        budgetId);
+    memoryBudget_ = session->CreateChild("http_cache", MediaAVCodec::MemoryBudget::RECLAIM_HTTP_CACHE);
+    FALSE_RETURN(memoryBudget_ != nullptr);
+    if (cacheMediaBuffer_ != nullptr) {
+        cacheMediaBuffer_->SetMemoryBudget(memoryBudget_);
+    } else if (buffer_ != nullptr) {
+        // the flv ring buffer is allocated up front and can not shrink, it is only accounted
+        ringBufferCharge_ = static_cast<uint64_t>(totalBufferSize_ > 0 ? totalBufferSize_ : RING_BUFFER_SIZE);
+        memoryBudget_->Charge(ringBufferCharge_);
+    }
 }
 
 bool HttpMediaDownloader::Open(const std::string& url, const std::map<std::string, std::string>& httpHeader)
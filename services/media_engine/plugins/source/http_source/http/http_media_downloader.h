@@ -53,6 +53,7 @@ public:
     void SetDemuxerState(int32_t streamId) override;
     void SetDownloadErrorState() override;
     void SetInterruptState(bool isInterruptNeeded) override;
+    void SetMemoryBudget(uint64_t budgetId) override;
     void GetDownloadInfo(DownloadInfo& downloadInfo) override;
     std::pair<int32_t, int32_t> GetDownloadInfo() override;
     void GetPlaybackInfo(PlaybackInfo& playbackInfo) override;
@@ -97,6 +98,8 @@ private:
 private:
     std::shared_ptr<RingBuffer> buffer_;
     std::shared_ptr<CacheMediaChunkBufferImpl> cacheMediaBuffer_;
+    std::shared_ptr<MediaAVCodec::MemoryBudget> memoryBudget_;
+    uint64_t ringBufferCharge_ {0};
     std::shared_ptr<Downloader> downloader_;
     std::shared_ptr<DownloadRequest> downloadRequest_;
     Mutex mutex_;
@@ -234,6 +234,9 @@ void HttpSourcePlugin::SetDownloaderBySource(std::shared_ptr<MediaSource> source
     }
     if (downloader_ != nullptr) {
         downloader_->SetInterruptState(isInterruptNeeded_);
+        if (memoryBudgetId_ != 0) {
+            downloader_->SetMemoryBudget(memoryBudgetId_);
+        }
     }
 }
 
@@ -317,6 +320,16 @@ void HttpSourcePlugin::SetInterruptState(bool isInterruptNeeded)
     }
 }
 
+void HttpSourcePlugin::SetMemoryBudget(uint64_t budgetId)
+{
+    MEDIA_LOG_I("SetMemoryBudget " PUBLIC_LOG_U64, budgetId);
+    AutoLock lock(mutex_);
+    memoryBudgetId_ = budgetId;
+    if (downloader_ != nullptr) {
+        downloader_->SetMemoryBudget(budgetId);
+    }
+}
+
 Status HttpSourcePlugin::SeekTo(uint64_t offset)
 {
     AutoLock lock(mutex_);
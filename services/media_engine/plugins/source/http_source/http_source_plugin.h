@@ -57,6 +57,7 @@ public:
     void SetDemuxerState(int32_t streamId) override;
     void SetDownloadErrorState() override;
     void SetInterruptState(bool isInterruptNeeded) override;
+    void SetMemoryBudget(uint64_t budgetId) override;
     Status GetDownloadInfo(DownloadInfo& downloadInfo) override;
     Status SetCurrentBitRate(int32_t bitRate, int32_t streamID) override;
     Status GetPlaybackInfo(PlaybackInfo& playbackInfo) override;
@@ -76,6 +77,7 @@ private:
     std::map<std::string, std::string> httpHeader_ {};
     std::string mimeType_ {};
     std::atomic<bool> isInterruptNeeded_{false};
+    uint64_t memoryBudgetId_ {0};
 };
 } // namespace HttpPluginLite
 } // namespace Plugin
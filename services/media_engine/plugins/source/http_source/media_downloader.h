@@ -109,6 +109,10 @@ public:
         MEDIA_LOG_W("SetPlayStrategy is unimplemented.");
     }
     virtual void SetInterruptState(bool isInterruptNeeded) = 0;
+    virtual void SetMemoryBudget(uint64_t budgetId)
+    {
+        MEDIA_LOG_W("SetMemoryBudget is unimplemented.");
+    }
     virtual Status GetStreamInfo(std::vector<StreamInfo>& streams)
     {
         MEDIA_LOG_W("GetStreamInfo is unimplemented.");
@@ -260,6 +260,13 @@ void DownloadMonitor::SetInterruptState(bool isInterruptNeeded)
     }
 }
 
+void DownloadMonitor::SetMemoryBudget(uint64_t budgetId)
+{
+    if (downloader_ != nullptr) {
+        downloader_->SetMemoryBudget(budgetId);
+    }
+}
+
 Status DownloadMonitor::GetStreamInfo(std::vector<StreamInfo>& streams)
 {
     return downloader_->GetStreamInfo(streams);
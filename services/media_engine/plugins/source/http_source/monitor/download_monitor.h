@@ -63,6 +63,7 @@ public:
     void SetDemuxerState(int32_t streamId) override;
     void SetPlayStrategy(const std::shared_ptr<PlayStrategy>& playStrategy) override;
     void SetInterruptState(bool isInterruptNeeded) override;
+    void SetMemoryBudget(uint64_t budgetId) override;
     Status GetStreamInfo(std::vector<StreamInfo>& streams) override;
     Status SelectStream(int32_t streamId) override;
     void GetDownloadInfo(DownloadInfo& downloadInfo) override;
@@ -19,6 +19,8 @@
 #include <cassert>
 #include <limits>
 #include <securec.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "media_cached_buffer.h"
 #include "common/log.h"
 #include "avcodec_log.h"
@@ -71,6 +73,10 @@ CacheMediaChunkBufferImpl::CacheMediaChunkBufferImpl()
 
 CacheMediaChunkBufferImpl::~CacheMediaChunkBufferImpl()
 {
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->SetReclaimer(nullptr);
+        memoryBudget_->Release(chargedBytes_);
+    }
     std::lock_guard lock(mutex_);
     freeChunks_.clear();
     fragmentCacheBuffer_.clear();
@@ -116,6 +122,9 @@ bool CacheMediaChunkBufferImpl::Init(uint64_t totalBuffSize, uint32_t chunkSize)
         return false;
     }
     
+    // chunks only take memory once written, residency is tracked so the budget sees what is really in use
+    sizePerChunk_ = sizePerChunk;
+    residentChunks_.assign(static_cast<size_t>(chunkNum), false);
     uint8_t* temp = bufferAddr_;
     for (auto i = 0; i < chunkNum; ++i) {
         auto chunkInfo = reinterpret_cast<CacheChunk*>(temp);
@@ -560,6 +569,70 @@ inline CacheChunk* PopFreeCacheChunk(CacheChunkList& freeChunks, int64_t offset)
     return tmp;
 }
 
+CacheChunk* CacheMediaChunkBufferImpl::PopFreeChunk(int64_t offset)
+{
+    CacheChunk* chunk = PopFreeCacheChunk(freeChunks_, offset);
+    if (chunk == nullptr || residentChunks_.empty()) {
+        return chunk;
+    }
+    size_t index = static_cast<size_t>(reinterpret_cast<uint8_t*>(chunk) - bufferAddr_) / sizePerChunk_;
+    if (!residentChunks_[index]) {
+        residentChunks_[index] = true;
+        chargedBytes_ += chunkSize_;
+        if (memoryBudget_ != nullptr) {
+            memoryBudget_->Charge(chunkSize_);
+        }
+    }
+    return chunk;
+}
+
+uint64_t CacheMediaChunkBufferImpl::ReclaimFreeChunks(uint64_t bytes)
+{
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || bufferAddr_ == nullptr) {
+        return 0;
+    }
+    uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uint64_t freed = 0;
+    // chunks are reused from the front, taking them from the back keeps them from faulting right back in
+    for (auto iter = freeChunks_.rbegin(); iter != freeChunks_.rend() && freed < bytes; ++iter) {
+        size_t index = static_cast<size_t>(reinterpret_cast<uint8_t*>(*iter) - bufferAddr_) / sizePerChunk_;
+        if (!residentChunks_[index]) {
+            continue;
+        }
+        // only whole pages inside the data area, the chunk header stays valid
+        uintptr_t begin = (reinterpret_cast<uintptr_t>((*iter)->data) + pageSize - 1) & ~(pageSize - 1);
+        uintptr_t end = (reinterpret_cast<uintptr_t>((*iter)->data) + chunkSize_) & ~(pageSize - 1);
+        if (end > begin) {
+            madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+        }
+        residentChunks_[index] = false;
+        freed += chunkSize_;
+    }
+    chargedBytes_ -= freed;
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Release(freed);
+    }
+    MEDIA_LOG_I("Reclaim free chunks " PUBLIC_LOG_U64 "/" PUBLIC_LOG_U64, freed, bytes);
+    return freed;
+}
+
+void CacheMediaChunkBufferImpl::SetMemoryBudget(std::shared_ptr<MediaAVCodec::MemoryBudget> budget)
+{
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->SetReclaimer(nullptr);
+    }
+    std::lock_guard lock(mutex_);
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Release(chargedBytes_);
+    }
+    memoryBudget_ = std::move(budget);
+    if (memoryBudget_ != nullptr) {
+        memoryBudget_->Charge(chargedBytes_);
+        memoryBudget_->SetReclaimer([this](uint64_t bytes) { return ReclaimFreeChunks(bytes); });
+    }
+}
+
 bool CacheMediaChunkBufferImpl::CheckThresholdFragmentCacheBuffer(FragmentIterator& currWritePos)
 {
     int64_t offset = -1;
@@ -651,7 +724,7 @@ CacheChunk* CacheMediaChunkBufferImpl::GetFreeCacheChunk(int64_t offset, bool ch
         MEDIA_LOG_D("curr write is new fragment.");
     }
     if (!freeChunks_.empty()) {
-        return PopFreeCacheChunk(freeChunks_, offset);
+        return PopFreeChunk(offset);
     }
     MEDIA_LOG_D("clear other fragment has read chunk.");
     for (auto iter = fragmentCacheBuffer_.begin(); iter != fragmentCacheBuffer_.end(); ++iter) {
@@ -661,12 +734,12 @@ CacheChunk* CacheMediaChunkBufferImpl::GetFreeCacheChunk(int64_t offset, bool ch
         }
     }
     if (!freeChunks_.empty()) {
-        return PopFreeCacheChunk(freeChunks_, offset);
+        return PopFreeChunk(offset);
     }
     while (fragmentCacheBuffer_.size() > CACHE_FRAGMENT_MIN_NUM_DEFAULT) {
         auto result = CheckThresholdFragmentCacheBuffer(currWritePos);
         if (!freeChunks_.empty()) {
-            return PopFreeCacheChunk(freeChunks_, offset);
+            return PopFreeChunk(offset);
         }
         if (!result) {
             break;
@@ -680,7 +753,7 @@ CacheChunk* CacheMediaChunkBufferImpl::GetFreeCacheChunk(int64_t offset, bool ch
         }
     }
     if (!freeChunks_.empty()) {
-        return PopFreeCacheChunk(freeChunks_, offset);
+        return PopFreeChunk(offset);
     }
     return nullptr;
 }
@@ -693,7 +766,7 @@ ChunkIterator CacheMediaChunkBufferImpl::SplitFragmentCacheBuffer(FragmentIterat
     auto& chunkInfo = *chunkPos;
     CacheChunk* splitHead = nullptr;
     if (offset != chunkInfo->offset) {
-        splitHead = freeChunks_.empty() ? GetFreeCacheChunk(offset, true) : PopFreeCacheChunk(freeChunks_, offset);
+        splitHead = freeChunks_.empty() ? GetFreeCacheChunk(offset, true) : PopFreeChunk(offset);
         if (splitHead == nullptr) {
             return currFragmentIter->chunks.end();
         }
@@ -21,9 +21,11 @@
 #include <mutex>
 #include <list>
 #include <chrono>
+#include <vector>
 
 #include "common/log.h"
 #include "lru_cache.h"
+#include "memory_budget.h"
 
 namespace OHOS {
 namespace Media {
@@ -87,6 +89,11 @@ public:
     void Dump(uint64_t param);
     bool Check();
     void Clear();
+    /**
+     * Chunks are charged to the budget the first time they hold data. Under memory pressure the pages of free
+     * chunks go back to the system and are charged again once reused.
+     */
+    void SetMemoryBudget(std::shared_ptr<MediaAVCodec::MemoryBudget> budget);
 
 protected:
     CacheChunk* GetFreeCacheChunk(int64_t offset, bool checkAllowFailContinue = false);
@@ -153,6 +160,8 @@ protected:
     void ResetReadSizeAlloc();
     CacheChunk* UpdateFragmentCacheForDelHead(FragmentIterator& fragmentIter);
     void HandleFragmentPos(FragmentIterator& fragmentIter);
+    CacheChunk* PopFreeChunk(int64_t offset);
+    uint64_t ReclaimFreeChunks(uint64_t bytes);
 
 private:
     std::mutex mutex_;
@@ -168,6 +177,10 @@ private:
     CacheChunkList freeChunks_;
     size_t fragmentMaxNum_;
     LruCache<int64_t, FragmentIterator> lruCache_;
+    size_t sizePerChunk_ {0};
+    std::vector<bool> residentChunks_;
+    uint64_t chargedBytes_ {0};
+    std::shared_ptr<MediaAVCodec::MemoryBudget> memoryBudget_ {nullptr};
 };
 
 class CacheMediaBuffer {
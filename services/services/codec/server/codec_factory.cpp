@@ -25,6 +25,8 @@
 #ifdef CLIENT_SUPPORT_CODEC
 #include "audio_codec.h"
 #include "audio_codec_adapter.h"
+#include "audio_codec_plugin_adapter.h"
+#include "parameters.h"
 #else
 #include "fcodec_loader.h"
 #include "hevc_decoder_loader.h"
@@ -33,6 +35,10 @@
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_FRAMEWORK, "CodecFactory"};
+#ifdef CLIENT_SUPPORT_CODEC
+// serve the api 10 audio codecs that have a media engine plugin with it instead of the legacy worker stack
+const bool IS_AUDIO_PLUGIN_SHIM = OHOS::system::GetParameter("persist.media_service.audio_plugin_shim", "0") == "1";
+#endif
 } // namespace
 
 namespace OHOS {
@@ -74,7 +80,9 @@ std::shared_ptr<CodecBase> CodecFactory::CreateCodecByName(const std::string &na
             break;
 #else
         case CodecType::AVCODEC_AUDIO_CODEC:
-            if (apiVersion == API_VERSION::API_VERSION_10) {
+            if (apiVersion == API_VERSION::API_VERSION_10 && IS_AUDIO_PLUGIN_SHIM) {
+                codec = AudioCodecPluginAdapter::Create(name);
+            } else if (apiVersion == API_VERSION::API_VERSION_10) {
                 codec = std::make_shared<AudioCodecAdapter>(name);
             } else {
                 codec = std::make_shared<AudioCodec>();
@@ -92,5 +100,20 @@ std::shared_ptr<CodecBase> CodecFactory::CreateCodecByName(const std::string &na
     EXPECT_AND_LOGI(codec != nullptr, "Create codec %{public}s successful", name.c_str());
     return codec;
 }
+
+void CodecFactory::GetLoaderDumpInfo(std::string &dumpString)
+{
+#ifndef CLIENT_SUPPORT_CODEC
+    std::string loaderInfo;
+    HCodecLoader::GetDumpInfo(loaderInfo);
+    FCodecLoader::GetDumpInfo(loaderInfo);
+    HevcDecoderLoader::GetDumpInfo(loaderInfo);
+    if (!loaderInfo.empty()) {
+        dumpString += "Codec_Start_Time(us)\n" + loaderInfo;
+    }
+#else
+    (void)dumpString;
+#endif
+}
 } // namespace MediaAVCodec
 } // namespace OHOS
@@ -27,6 +27,7 @@ public:
     static CodecFactory &Instance();
     std::vector<std::string> GetCodecNameArrayByMime(const std::string &mime, const bool isEncoder);
     std::shared_ptr<CodecBase> CreateCodecByName(const std::string &name, API_VERSION apiVersion);
+    void GetLoaderDumpInfo(std::string &dumpString);
 
 private:
     CodecFactory() = default;
@@ -22,6 +22,7 @@
 #include "avcodec_codec_name.h"
 #include "avcodec_dump_utils.h"
 #include "avcodec_errors.h"
+#include "avcodec_latency_stats.h"
 #include "avcodec_log.h"
 #include "avcodec_sysevent.h"
 #include "buffer/avbuffer.h"
@@ -760,6 +761,8 @@ int32_t CodecServer::DumpInfo(int32_t fd)
     std::string dumpString;
     dumpControler.GetDumpString(dumpString);
     dumpString += codecBase_->GetHidumperInfo();
+    AVCodecLatencyStats::GetInstance().GetDumpString(dumpString);
+    CodecFactory::Instance().GetLoaderDumpInfo(dumpString);
     dumpString += "\n";
     write(fd, dumpString.c_str(), dumpString.size());
     return AVCS_ERR_OK;
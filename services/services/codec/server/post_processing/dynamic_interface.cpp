@@ -14,7 +14,7 @@
  */
 
 #include "dynamic_interface.h"
-#include <dlfcn.h>
+#include "library_cache.h"
 #include "utils.h"
 
 namespace {
@@ -53,7 +53,7 @@ bool DynamicInterface::OpenLibrary()
         AVCODEC_LOGI("VPE lib is already loaded.");
         return true;
     }
-    lib_ = dlopen(LIBRARY_PATH, RTLD_LAZY);
+    lib_ = LibraryCache::GetInstance().Acquire(LIBRARY_PATH, RTLD_LAZY);
     CHECK_AND_RETURN_RET_LOG(lib_ != nullptr, false, "Load VPE lib failed.");
     return true;
 }
@@ -61,7 +61,7 @@ bool DynamicInterface::OpenLibrary()
 void DynamicInterface::CloseLibrary()
 {
     if (lib_ != nullptr) {
-        dlclose(lib_);
+        LibraryCache::GetInstance().Release(LIBRARY_PATH);
         lib_ = nullptr;
     }
 }
@@ -69,9 +69,9 @@ void DynamicInterface::CloseLibrary()
 bool DynamicInterface::ReadSymbols()
 {
     for (size_t i = 0; i < DYNAMIC_INTERFACE_NUM; ++i) {
-        auto fp = dlsym(lib_, DYNAMIC_INTERFACE_SYMBOLS[i]);
+        auto fp = LibraryCache::GetInstance().GetSymbol(LIBRARY_PATH, DYNAMIC_INTERFACE_SYMBOLS[i]);
         CHECK_AND_RETURN_RET_LOG(fp != nullptr, false, "Symbol not found");
-        interfaces_[i] = static_cast<void*>(fp);
+        interfaces_[i] = fp;
     }
 
     return true;
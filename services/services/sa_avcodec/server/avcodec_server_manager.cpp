@@ -24,6 +24,7 @@
 #include "avcodec_log.h"
 #include "avcodec_trace.h"
 #include "avcodec_xcollie.h"
+#include "library_cache.h"
 #include "system_ability_definition.h"
 #ifdef SUPPORT_CODEC
 #include "codec_service_stub.h"
@@ -61,6 +62,10 @@ int32_t AVCodecServerManager::Dump(int32_t fd, const std::vector<std::u16string>
         (void)iter.first->Dump(fd, args);
     }
 
+    std::string libraryInfo;
+    LibraryCache::GetInstance().GetDumpInfo(libraryInfo);
+    write(fd, libraryInfo.data(), libraryInfo.size());
+
     return OHOS::NO_ERROR;
 }
 
@@ -78,6 +83,7 @@ AVCodecServerManager::~AVCodecServerManager()
 
 void AVCodecServerManager::Init()
 {
+    LibraryCache::GetInstance().PreloadFromParameter();
     void *handle = dlopen(LIB_PATH, RTLD_NOW);
     CHECK_AND_RETURN_LOG(handle != nullptr, "Load so failed:%{public}s", LIB_PATH);
     libMemMgrClientHandle_ = std::shared_ptr<void>(handle, dlclose);
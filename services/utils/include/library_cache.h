@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AV_CODEC_LIBRARY_CACHE_H
+#define AV_CODEC_LIBRARY_CACHE_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <dlfcn.h>
+
+namespace OHOS {
+namespace MediaAVCodec {
+/**
+ * Process-wide registry of dlopen'd helper libraries.
+ *
+ * Every library is opened once and reference counted by path, resolved symbols are cached per library. A library
+ * whose last reference is released stays loaded for an idle period, so back-to-back sessions skip dlopen and dlsym.
+ * Preloaded libraries are never closed.
+ */
+class __attribute__((visibility("default"))) LibraryCache {
+public:
+    static LibraryCache &GetInstance();
+    // Creates a cache of its own instead of the shared one, for tests that need a short idle period
+    explicit LibraryCache(std::chrono::milliseconds idleTtl);
+    ~LibraryCache() = default;
+
+    /**
+     * Takes a reference on the library, opening it if needed. The flags only apply to the first open.
+     * Returns the dlopen handle, or nullptr on failure.
+     */
+    void *Acquire(const std::string &path, int32_t flags = RTLD_NOW | RTLD_LOCAL);
+    void Release(const std::string &path);
+    // Resolves the symbol of an acquired library, nullptr if the library is not loaded or has no such symbol
+    void *GetSymbol(const std::string &path, const std::string &symbol);
+    // Opens the library and keeps it loaded for the lifetime of the process
+    bool Preload(const std::string &path, int32_t flags = RTLD_NOW | RTLD_LOCAL);
+    // Preloads the comma separated list of persist.media_service.preload_libs
+    void PreloadFromParameter();
+    void GetDumpInfo(std::string &dumpString);
+
+private:
+    struct Library {
+        void *handle = nullptr;
+        uint32_t refCount = 0;
+        bool pinned = false;
+        std::chrono::steady_clock::time_point idleSince;
+        std::unordered_map<std::string, void *> symbols;
+        // metrics kept across reloads
+        uint32_t openCount = 0;
+        uint64_t acquireCount = 0;
+        int64_t lastOpenUs = 0;
+        int64_t totalOpenUs = 0;
+        uint64_t symbolLookupCount = 0;
+        uint64_t symbolHitCount = 0;
+    };
+
+    LibraryCache();
+    void *Open(const std::string &path, Library &library, int32_t flags);
+    void Close(const std::string &path, Library &library);
+    void CloseIdle(std::chrono::steady_clock::time_point now);
+
+    std::map<std::string, Library> libraries_;
+    std::chrono::milliseconds idleTtl_;
+    std::mutex mutex_;
+};
+} // namespace MediaAVCodec
+} // namespace OHOS
+#endif // AV_CODEC_LIBRARY_CACHE_H
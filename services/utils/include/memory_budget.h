@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AV_CODEC_MEMORY_BUDGET_H
+#define AV_CODEC_MEMORY_BUDGET_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace MediaAVCodec {
+/**
+ * Hierarchical byte budget of one playback session.
+ *
+ * A session creates a root budget and hands a child to every component that caches or buffers data. Charges go
+ * to the child and all of its ancestors, a limit of 0 leaves that level unlimited. When a charge would exceed a
+ * limit, or the session crosses its high watermark, reclaimers registered on the session are asked to give memory
+ * back in ascending reclaim order, so cheap to refill caches shrink before anything else.
+ */
+class __attribute__((visibility("default"))) MemoryBudget : public std::enable_shared_from_this<MemoryBudget> {
+public:
+    enum ReclaimOrder : uint32_t {
+        // data that can be downloaded again
+        RECLAIM_HTTP_CACHE = 0,
+        // packets demuxed ahead of the decoders
+        RECLAIM_DEMUXER_CACHE = 1,
+        // buffers the pipeline cannot run without
+        RECLAIM_CODEC_BUFFER = 2,
+    };
+    /**
+     * Frees up to the requested bytes, releases them on its own budget and returns how much it freed.
+     * Runs on whichever thread charges the session, so it must not block: skip when its own lock is busy.
+     * SetReclaimer waits for a running reclaimer, owners clear theirs before they go away.
+     */
+    using Reclaimer = std::function<uint64_t(uint64_t bytes)>;
+
+    static std::shared_ptr<MemoryBudget> Create(const std::string &name, uint64_t limit);
+    // Looks up a live session root by id, for components that only receive the id through a parameter
+    static std::shared_ptr<MemoryBudget> Find(uint64_t id);
+
+    ~MemoryBudget();
+
+    std::shared_ptr<MemoryBudget> CreateChild(const std::string &name, uint32_t reclaimOrder, uint64_t limit = 0);
+    void SetReclaimer(Reclaimer reclaimer);
+
+    // Charges the bytes if they fit, reclaiming from the session first when needed. Charges nothing on failure.
+    bool TryCharge(uint64_t bytes);
+    // Charges memory that is already in use, returns false when that took a level over its limit
+    bool Charge(uint64_t bytes);
+    void Release(uint64_t bytes);
+    // Asks the reclaimers of the whole subtree, except the one of the caller, for the bytes in reclaim order
+    uint64_t Reclaim(uint64_t bytes, const MemoryBudget *caller = nullptr);
+
+    uint64_t GetId() const;
+    const std::string &GetName() const;
+    uint64_t GetUsage() const;
+    uint64_t GetPeak() const;
+    uint64_t GetLimit() const;
+    bool IsOverLimit() const;
+    void GetDumpInfo(std::string &dumpString) const;
+
+private:
+    MemoryBudget(const std::string &name, uint64_t limit, uint32_t reclaimOrder, std::shared_ptr<MemoryBudget> parent);
+    // Adds the bytes from this level up, returns the first level pushed over its limit or nullptr
+    MemoryBudget *Add(uint64_t bytes);
+    void Subtract(uint64_t bytes, const MemoryBudget *last);
+    void ReclaimAboveWatermark();
+    void CollectNodes(std::vector<std::pair<uint32_t, std::shared_ptr<MemoryBudget>>> &nodes);
+    void DumpNode(std::string &dumpString, uint32_t depth) const;
+    MemoryBudget *Root();
+
+    const uint64_t id_;
+    const std::string name_;
+    const uint64_t limit_;
+    const uint32_t reclaimOrder_;
+    const std::shared_ptr<MemoryBudget> parent_;
+    std::atomic<uint64_t> usage_ {0};
+    std::atomic<uint64_t> peak_ {0};
+    std::atomic<uint64_t> failedCharges_ {0};
+    std::atomic<uint64_t> reclaimedBytes_ {0};
+    std::atomic<bool> reclaiming_ {false};
+    mutable std::mutex mutex_;
+    std::mutex reclaimMutex_;
+    Reclaimer reclaimer_;
+    std::vector<std::weak_ptr<MemoryBudget>> children_;
+};
+} // namespace MediaAVCodec
+} // namespace OHOS
+#endif
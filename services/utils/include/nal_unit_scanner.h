@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AV_CODEC_NAL_UNIT_SCANNER_H
+#define AV_CODEC_NAL_UNIT_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OHOS {
+namespace MediaAVCodec {
+struct NalUnitInfo {
+    uint32_t startCodePos = 0; // offset of the first start code byte, 0x000001 or 0x00000001
+    uint32_t headerPos = 0;    // offset of the first nal unit header byte
+    uint8_t startCodeLen = 0;  // 3 or 4
+    uint8_t header = 0;        // first nal unit header byte, the nal type is decoded by the caller
+};
+
+class __attribute__((visibility("default"))) NalUnitScanner {
+public:
+    static constexpr uint32_t START_CODE_LEN = 3;
+
+    /**
+     * Returns the offset of the first 0x000001 at or after pos, or size if there is none.
+     * Uses SSE2/AVX2/NEON when available, otherwise FindStartCodeScalar.
+     */
+    static uint32_t FindStartCode(const uint8_t *data, uint32_t size, uint32_t pos);
+    static uint32_t FindStartCodeScalar(const uint8_t *data, uint32_t size, uint32_t pos);
+
+    /**
+     * Collects every nal unit of an annex-b access unit in one pass. Start codes at the very end of the
+     * buffer without a header byte are ignored. Returns the number of nal units found.
+     */
+    static size_t Scan(const uint8_t *data, uint32_t size, std::vector<NalUnitInfo> &nalUnits);
+
+    /**
+     * Converts a scanned access unit to 4 byte big endian nal sizes without copying, by overwriting every 4 byte
+     * start code with the size of its nal unit. The result starts at the first start code. Returns false and
+     * leaves the data untouched when a 3 byte start code is present, the output would not fit in place.
+     */
+    static bool ToLengthPrefixedInPlace(uint8_t *data, uint32_t size, const std::vector<NalUnitInfo> &nalUnits);
+    // Writes the 4 byte start codes back after ToLengthPrefixedInPlace
+    static void RestoreStartCodes(uint8_t *data, const std::vector<NalUnitInfo> &nalUnits);
+    /**
+     * Copies a scanned access unit with 4 byte big endian nal sizes into out, which only grows so that a reused
+     * buffer stops allocating. Returns the number of bytes written.
+     */
+    static uint32_t ToLengthPrefixed(const uint8_t *data, uint32_t size, const std::vector<NalUnitInfo> &nalUnits,
+        std::vector<uint8_t> &out);
+};
+} // namespace MediaAVCodec
+} // namespace OHOS
+#endif // AV_CODEC_NAL_UNIT_SCANNER_H
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "library_cache.h"
+#include <cinttypes>
+#include <sstream>
+#include "avcodec_log.h"
+#include "syspara/parameters.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_FRAMEWORK, "LibraryCache"};
+constexpr int32_t DEFAULT_IDLE_TTL_MS = 30000;
+constexpr int32_t MAX_IDLE_TTL_MS = 600000;
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+LibraryCache &LibraryCache::GetInstance()
+{
+    static LibraryCache cache;
+    return cache;
+}
+
+LibraryCache::LibraryCache()
+    : LibraryCache(std::chrono::milliseconds(OHOS::system::GetIntParameter<int32_t>(
+        "persist.media_service.lib_cache.idle_ms", DEFAULT_IDLE_TTL_MS, 0, MAX_IDLE_TTL_MS)))
+{
+}
+
+LibraryCache::LibraryCache(std::chrono::milliseconds idleTtl) : idleTtl_(idleTtl)
+{
+}
+
+void *LibraryCache::Acquire(const std::string &path, int32_t flags)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CloseIdle(std::chrono::steady_clock::now());
+    Library &library = libraries_[path];
+    if (library.handle == nullptr && Open(path, library, flags) == nullptr) {
+        return nullptr;
+    }
+    ++library.refCount;
+    ++library.acquireCount;
+    return library.handle;
+}
+
+void LibraryCache::Release(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    auto iter = libraries_.find(path);
+    CHECK_AND_RETURN_LOG(iter != libraries_.end() && iter->second.refCount > 0, "Release unacquired library %{public}s",
+        path.c_str());
+    Library &library = iter->second;
+    if (--library.refCount == 0) {
+        library.idleSince = now;
+        if (idleTtl_.count() == 0 && !library.pinned) {
+            Close(path, library);
+        }
+    }
+    CloseIdle(now);
+}
+
+void *LibraryCache::GetSymbol(const std::string &path, const std::string &symbol)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = libraries_.find(path);
+    CHECK_AND_RETURN_RET_LOG(iter != libraries_.end() && iter->second.handle != nullptr, nullptr,
+        "Library %{public}s is not loaded", path.c_str());
+    Library &library = iter->second;
+    ++library.symbolLookupCount;
+    auto symbolIter = library.symbols.find(symbol);
+    if (symbolIter != library.symbols.end()) {
+        ++library.symbolHitCount;
+        return symbolIter->second;
+    }
+    void *address = dlsym(library.handle, symbol.c_str());
+    CHECK_AND_RETURN_RET_LOG(address != nullptr, nullptr, "Symbol %{public}s not found in %{public}s",
+        symbol.c_str(), path.c_str());
+    library.symbols.emplace(symbol, address);
+    return address;
+}
+
+bool LibraryCache::Preload(const std::string &path, int32_t flags)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Library &library = libraries_[path];
+    if (library.handle == nullptr && Open(path, library, flags) == nullptr) {
+        return false;
+    }
+    library.pinned = true;
+    AVCODEC_LOGI("Preloaded %{public}s in %{public}" PRId64 " us", path.c_str(), library.lastOpenUs);
+    return true;
+}
+
+void LibraryCache::PreloadFromParameter()
+{
+    std::string libs = OHOS::system::GetParameter("persist.media_service.preload_libs", "");
+    std::istringstream stream(libs);
+    std::string path;
+    while (std::getline(stream, path, ',')) {
+        if (!path.empty()) {
+            (void)Preload(path);
+        }
+    }
+}
+
+void LibraryCache::GetDumpInfo(std::string &dumpString)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (libraries_.empty()) {
+        return;
+    }
+    dumpString += "[Library_Cache]\n";
+    for (auto &[path, library] : libraries_) {
+        dumpString += "    " + path + " - loaded: " + std::to_string(library.handle != nullptr) +
+            ", pinned: " + std::to_string(library.pinned) + ", refs: " + std::to_string(library.refCount) +
+            ", acquires: " + std::to_string(library.acquireCount) + ", opens: " + std::to_string(library.openCount) +
+            ", last open(us): " + std::to_string(library.lastOpenUs) +
+            ", total open(us): " + std::to_string(library.totalOpenUs) +
+            ", symbol hits: " + std::to_string(library.symbolHitCount) + "/" +
+            std::to_string(library.symbolLookupCount) + "\n";
+    }
+}
+
+void *LibraryCache::Open(const std::string &path, Library &library, int32_t flags)
+{
+    auto start = std::chrono::steady_clock::now();
+    library.handle = dlopen(path.c_str(), flags);
+    CHECK_AND_RETURN_RET_LOG(library.handle != nullptr, nullptr, "Load %{public}s failed: %{public}s", path.c_str(),
+        dlerror());
+    library.lastOpenUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    library.totalOpenUs += library.lastOpenUs;
+    ++library.openCount;
+    return library.handle;
+}
+
+void LibraryCache::Close(const std::string &path, Library &library)
+{
+    AVCODEC_LOGD("Close idle library %{public}s", path.c_str());
+    library.symbols.clear();
+    dlclose(library.handle);
+    library.handle = nullptr;
+}
+
+void LibraryCache::CloseIdle(std::chrono::steady_clock::time_point now)
+{
+    for (auto &[path, library] : libraries_) {
+        if (library.handle != nullptr && library.refCount == 0 && !library.pinned &&
+            library.idleSince + idleTtl_ <= now) {
+            Close(path, library);
+        }
+    }
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_budget.h"
+#include <algorithm>
+#include <cinttypes>
+#include <map>
+#include "avcodec_log.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN_FRAMEWORK, "MemoryBudget"};
+// reclaiming starts above the high watermark of the session limit and stops at the low one
+constexpr uint64_t HIGH_WATERMARK_PERCENT = 90;
+constexpr uint64_t LOW_WATERMARK_PERCENT = 75;
+constexpr uint64_t PERCENT = 100;
+constexpr uint32_t DUMP_INDENT = 4;
+
+std::atomic<uint64_t> g_nextId {1};
+std::mutex g_registryMutex;
+std::map<uint64_t, std::weak_ptr<OHOS::MediaAVCodec::MemoryBudget>> g_registry;
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+std::shared_ptr<MemoryBudget> MemoryBudget::Create(const std::string &name, uint64_t limit)
+{
+    std::shared_ptr<MemoryBudget> budget(new (std::nothrow) MemoryBudget(name, limit, 0, nullptr));
+    CHECK_AND_RETURN_RET_LOG(budget != nullptr, nullptr, "Create memory budget %{public}s failed", name.c_str());
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    g_registry[budget->id_] = budget;
+    return budget;
+}
+
+std::shared_ptr<MemoryBudget> MemoryBudget::Find(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    auto iter = g_registry.find(id);
+    return iter == g_registry.end() ? nullptr : iter->second.lock();
+}
+
+MemoryBudget::MemoryBudget(const std::string &name, uint64_t limit, uint32_t reclaimOrder,
+    std::shared_ptr<MemoryBudget> parent)
+    : id_(g_nextId.fetch_add(1)), name_(name), limit_(limit), reclaimOrder_(reclaimOrder), parent_(std::move(parent))
+{
+}
+
+MemoryBudget::~MemoryBudget()
+{
+    if (parent_ == nullptr) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        g_registry.erase(id_);
+        return;
+    }
+    uint64_t leaked = usage_.load();
+    if (leaked > 0) {
+        AVCODEC_LOGW("%{public}s destroyed with %{public}" PRIu64 " bytes charged", name_.c_str(), leaked);
+        parent_->Subtract(leaked, nullptr);
+    }
+}
+
+std::shared_ptr<MemoryBudget> MemoryBudget::CreateChild(const std::string &name, uint32_t reclaimOrder,
+    uint64_t limit)
+{
+    std::shared_ptr<MemoryBudget> child(new (std::nothrow) MemoryBudget(name, limit, reclaimOrder,
+        shared_from_this()));
+    CHECK_AND_RETURN_RET_LOG(child != nullptr, nullptr, "Create memory budget %{public}s failed", name.c_str());
+    std::lock_guard<std::mutex> lock(mutex_);
+    children_.erase(std::remove_if(children_.begin(), children_.end(),
+        [](const std::weak_ptr<MemoryBudget> &node) { return node.expired(); }), children_.end());
+    children_.push_back(child);
+    return child;
+}
+
+void MemoryBudget::SetReclaimer(Reclaimer reclaimer)
+{
+    std::lock_guard<std::mutex> lock(reclaimMutex_);
+    reclaimer_ = std::move(reclaimer);
+}
+
+bool MemoryBudget::TryCharge(uint64_t bytes)
+{
+    MemoryBudget *over = Add(bytes);
+    if (over != nullptr) {
+        uint64_t excess = over->usage_.load() - over->limit_;
+        Subtract(bytes, nullptr);
+        over->Reclaim(excess, this);
+        over = Add(bytes);
+        if (over != nullptr) {
+            Subtract(bytes, nullptr);
+            failedCharges_.fetch_add(1);
+            return false;
+        }
+    }
+    ReclaimAboveWatermark();
+    return true;
+}
+
+bool MemoryBudget::Charge(uint64_t bytes)
+{
+    MemoryBudget *over = Add(bytes);
+    ReclaimAboveWatermark();
+    if (over != nullptr) {
+        failedCharges_.fetch_add(1);
+        return false;
+    }
+    return true;
+}
+
+void MemoryBudget::Release(uint64_t bytes)
+{
+    Subtract(bytes, nullptr);
+}
+
+uint64_t MemoryBudget::Reclaim(uint64_t bytes, const MemoryBudget *caller)
+{
+    std::vector<std::pair<uint32_t, std::shared_ptr<MemoryBudget>>> nodes;
+    CollectNodes(nodes);
+    std::stable_sort(nodes.begin(), nodes.end(),
+        [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    uint64_t freed = 0;
+    for (auto &[order, node] : nodes) {
+        if (freed >= bytes) {
+            break;
+        }
+        if (node.get() == caller || node->usage_.load() == 0) {
+            continue;
+        }
+        // a node another thread is already reclaiming from is skipped rather than waited for
+        std::unique_lock<std::mutex> reclaimLock(node->reclaimMutex_, std::try_to_lock);
+        if (!reclaimLock.owns_lock() || !node->reclaimer_) {
+            continue;
+        }
+        uint64_t nodeFreed = node->reclaimer_(bytes - freed);
+        node->reclaimedBytes_.fetch_add(nodeFreed);
+        freed += nodeFreed;
+    }
+    AVCODEC_LOGD("%{public}s reclaimed %{public}" PRIu64 "/%{public}" PRIu64 " bytes", name_.c_str(), freed, bytes);
+    return freed;
+}
+
+uint64_t MemoryBudget::GetId() const
+{
+    return id_;
+}
+
+const std::string &MemoryBudget::GetName() const
+{
+    return name_;
+}
+
+uint64_t MemoryBudget::GetUsage() const
+{
+    return usage_.load();
+}
+
+uint64_t MemoryBudget::GetPeak() const
+{
+    return peak_.load();
+}
+
+uint64_t MemoryBudget::GetLimit() const
+{
+    return limit_;
+}
+
+bool MemoryBudget::IsOverLimit() const
+{
+    for (const MemoryBudget *node = this; node != nullptr; node = node->parent_.get()) {
+        if (node->limit_ != 0 && node->usage_.load() > node->limit_) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MemoryBudget::GetDumpInfo(std::string &dumpString) const
+{
+    dumpString += "[Memory_Budget]\n";
+    DumpNode(dumpString, 1);
+}
+
+MemoryBudget *MemoryBudget::Add(uint64_t bytes)
+{
+    MemoryBudget *over = nullptr;
+    for (MemoryBudget *node = this; node != nullptr; node = node->parent_.get()) {
+        uint64_t usage = node->usage_.fetch_add(bytes) + bytes;
+        uint64_t peak = node->peak_.load();
+        while (usage > peak && !node->peak_.compare_exchange_weak(peak, usage)) {
+        }
+        if (over == nullptr && node->limit_ != 0 && usage > node->limit_) {
+            over = node;
+        }
+    }
+    return over;
+}
+
+void MemoryBudget::Subtract(uint64_t bytes, const MemoryBudget *last)
+{
+    for (MemoryBudget *node = this; node != nullptr; node = node->parent_.get()) {
+        uint64_t usage = node->usage_.load();
+        while (!node->usage_.compare_exchange_weak(usage, usage > bytes ? usage - bytes : 0)) {
+        }
+        if (usage < bytes) {
+            AVCODEC_LOGW("%{public}s released %{public}" PRIu64 " bytes, only %{public}" PRIu64 " charged",
+                node->name_.c_str(), bytes, usage);
+        }
+        if (node == last) {
+            break;
+        }
+    }
+}
+
+void MemoryBudget::ReclaimAboveWatermark()
+{
+    MemoryBudget *root = Root();
+    if (root->limit_ == 0) {
+        return;
+    }
+    uint64_t usage = root->usage_.load();
+    if (usage * PERCENT <= root->limit_ * HIGH_WATERMARK_PERCENT || root->reclaiming_.exchange(true)) {
+        return;
+    }
+    root->Reclaim(usage - root->limit_ * LOW_WATERMARK_PERCENT / PERCENT, this);
+    root->reclaiming_.store(false);
+}
+
+void MemoryBudget::CollectNodes(std::vector<std::pair<uint32_t, std::shared_ptr<MemoryBudget>>> &nodes)
+{
+    nodes.emplace_back(reclaimOrder_, shared_from_this());
+    std::vector<std::shared_ptr<MemoryBudget>> children;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &weak : children_) {
+            if (auto child = weak.lock()) {
+                children.push_back(std::move(child));
+            }
+        }
+    }
+    for (auto &child : children) {
+        child->CollectNodes(nodes);
+    }
+}
+
+void MemoryBudget::DumpNode(std::string &dumpString, uint32_t depth) const
+{
+    dumpString += std::string(depth * DUMP_INDENT, ' ') + name_ + " - usage: " + std::to_string(usage_.load()) +
+        ", peak: " + std::to_string(peak_.load()) + ", limit: " + std::to_string(limit_) +
+        ", failed charges: " + std::to_string(failedCharges_.load()) +
+        ", reclaimed: " + std::to_string(reclaimedBytes_.load()) + "\n";
+    std::vector<std::shared_ptr<MemoryBudget>> children;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &weak : children_) {
+            if (auto child = weak.lock()) {
+                children.push_back(std::move(child));
+            }
+        }
+    }
+    for (auto &child : children) {
+        child->DumpNode(dumpString, depth + 1);
+    }
+}
+
+MemoryBudget *MemoryBudget::Root()
+{
+    MemoryBudget *node = this;
+    while (node->parent_ != nullptr) {
+        node = node->parent_.get();
+    }
+    return node;
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
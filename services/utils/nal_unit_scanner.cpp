@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nal_unit_scanner.h"
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+constexpr uint32_t START_CODE_TAIL = 2; // bytes after the first byte of 0x000001
+constexpr uint32_t SKIP_NO_CANDIDATE = 3;
+constexpr uint32_t SKIP_NO_ZERO_PAIR = 2;
+constexpr uint8_t NAL_SIZE_LEN = 4;
+
+inline void WriteNalSize(uint8_t *dst, uint32_t nalSize)
+{
+    dst[0] = static_cast<uint8_t>(nalSize >> 24); // 24: most significant byte
+    dst[1] = static_cast<uint8_t>(nalSize >> 16); // 16: second byte
+    dst[2] = static_cast<uint8_t>(nalSize >> 8);  // 8: third byte
+    dst[3] = static_cast<uint8_t>(nalSize);       // 3: least significant byte
+}
+
+#if defined(__AVX2__)
+#define NAL_UNIT_SCANNER_SIMD
+constexpr uint32_t BLOCK_SIZE = 32;
+
+inline bool FindInBlock(const uint8_t *p, uint32_t &offset)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    __m256i b0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), zero);
+    __m256i b1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 1)), zero);
+    __m256i b2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 2)), one);
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(b0, b1), b2)));
+    if (mask == 0) {
+        return false;
+    }
+    offset = static_cast<uint32_t>(__builtin_ctz(mask));
+    return true;
+}
+#elif defined(__SSE2__)
+#define NAL_UNIT_SCANNER_SIMD
+constexpr uint32_t BLOCK_SIZE = 16;
+
+inline bool FindInBlock(const uint8_t *p, uint32_t &offset)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i b0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), zero);
+    __m128i b1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 1)), zero);
+    __m128i b2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 2)), one);
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(b0, b1), b2)));
+    if (mask == 0) {
+        return false;
+    }
+    offset = static_cast<uint32_t>(__builtin_ctz(mask));
+    return true;
+}
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define NAL_UNIT_SCANNER_SIMD
+constexpr uint32_t BLOCK_SIZE = 16;
+
+inline bool FindInBlock(const uint8_t *p, uint32_t &offset)
+{
+    uint8x16_t b0 = vceqq_u8(vld1q_u8(p), vdupq_n_u8(0));
+    uint8x16_t b1 = vceqq_u8(vld1q_u8(p + 1), vdupq_n_u8(0));
+    uint8x16_t b2 = vceqq_u8(vld1q_u8(p + 2), vdupq_n_u8(1));
+    uint8x16_t hit = vandq_u8(vandq_u8(b0, b1), b2);
+    if (vmaxvq_u8(hit) == 0) {
+        return false;
+    }
+    // narrow every byte lane to a nibble so the first hit can be located with one ctz
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+    offset = static_cast<uint32_t>(__builtin_ctzll(mask) >> 2); // 4 bits per lane
+    return true;
+}
+#endif
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+uint32_t NalUnitScanner::FindStartCodeScalar(const uint8_t *data, uint32_t size, uint32_t pos)
+{
+    if (data == nullptr) {
+        return size;
+    }
+    uint32_t i = pos;
+    while (i + START_CODE_TAIL < size) {
+        if (data[i + START_CODE_TAIL] > 1) {
+            i += SKIP_NO_CANDIDATE;
+        } else if (data[i + 1] != 0) {
+            i += SKIP_NO_ZERO_PAIR;
+        } else if (data[i] != 0 || data[i + START_CODE_TAIL] != 1) {
+            i++;
+        } else {
+            return i;
+        }
+    }
+    return size;
+}
+
+uint32_t NalUnitScanner::FindStartCode(const uint8_t *data, uint32_t size, uint32_t pos)
+{
+    if (data == nullptr) {
+        return size;
+    }
+    uint32_t i = pos;
+#ifdef NAL_UNIT_SCANNER_SIMD
+    // every load of the block reads up to BLOCK_SIZE + 2 bytes, the tail is handled by the scalar scan
+    while (size >= BLOCK_SIZE + START_CODE_TAIL && i <= size - BLOCK_SIZE - START_CODE_TAIL) {
+        uint32_t offset = 0;
+        if (FindInBlock(data + i, offset)) {
+            return i + offset;
+        }
+        i += BLOCK_SIZE;
+    }
+#endif
+    return FindStartCodeScalar(data, size, i);
+}
+
+size_t NalUnitScanner::Scan(const uint8_t *data, uint32_t size, std::vector<NalUnitInfo> &nalUnits)
+{
+    nalUnits.clear();
+    uint32_t pos = FindStartCode(data, size, 0);
+    while (pos < size && pos + START_CODE_LEN < size) {
+        NalUnitInfo info;
+        info.startCodePos = pos;
+        info.startCodeLen = START_CODE_LEN;
+        uint32_t lowerBound = nalUnits.empty() ? 0 : nalUnits.back().headerPos + 1;
+        if (pos > lowerBound && data[pos - 1] == 0) {
+            info.startCodePos = pos - 1;
+            info.startCodeLen = START_CODE_LEN + 1;
+        }
+        info.headerPos = pos + START_CODE_LEN;
+        info.header = data[info.headerPos];
+        nalUnits.emplace_back(info);
+        pos = FindStartCode(data, size, info.headerPos);
+    }
+    return nalUnits.size();
+}
+
+bool NalUnitScanner::ToLengthPrefixedInPlace(uint8_t *data, uint32_t size, const std::vector<NalUnitInfo> &nalUnits)
+{
+    for (const auto &nal : nalUnits) {
+        if (nal.startCodeLen != NAL_SIZE_LEN) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < nalUnits.size(); i++) {
+        uint32_t end = i + 1 < nalUnits.size() ? nalUnits[i + 1].startCodePos : size;
+        WriteNalSize(data + nalUnits[i].startCodePos, end - nalUnits[i].headerPos);
+    }
+    return true;
+}
+
+void NalUnitScanner::RestoreStartCodes(uint8_t *data, const std::vector<NalUnitInfo> &nalUnits)
+{
+    for (const auto &nal : nalUnits) {
+        WriteNalSize(data + nal.startCodePos, 1);
+    }
+}
+
+uint32_t NalUnitScanner::ToLengthPrefixed(const uint8_t *data, uint32_t size,
+    const std::vector<NalUnitInfo> &nalUnits, std::vector<uint8_t> &out)
+{
+    uint32_t outSize = 0;
+    for (size_t i = 0; i < nalUnits.size(); i++) {
+        uint32_t end = i + 1 < nalUnits.size() ? nalUnits[i + 1].startCodePos : size;
+        outSize += NAL_SIZE_LEN + end - nalUnits[i].headerPos;
+    }
+    if (out.size() < outSize) {
+        out.resize(outSize);
+    }
+    uint8_t *dst = out.data();
+    for (size_t i = 0; i < nalUnits.size(); i++) {
+        uint32_t end = i + 1 < nalUnits.size() ? nalUnits[i + 1].startCodePos : size;
+        uint32_t nalSize = end - nalUnits[i].headerPos;
+        WriteNalSize(dst, nalSize);
+        std::copy(data + nalUnits[i].headerPos, data + end, dst + NAL_SIZE_LEN);
+        dst += NAL_SIZE_LEN + nalSize;
+    }
+    return outSize;
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
@@ -353,6 +353,46 @@ HWTEST_F(AudioCaptureModuleUnitTest, AudioCaptureGetMaxAmplitude_0100, TestSize.
     ret = audioCaptureModule_->Deinit();
     ASSERT_TRUE(ret == Status::OK);
 }
+/**
+ * @tc.name: AudioCaptureGetAudioLevels_0100
+ * @tc.desc: test GetAudioLevels after GetMaxAmplitude already started the metering
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioCaptureModuleUnitTest, AudioCaptureGetAudioLevels_0100, TestSize.Level1)
+{
+    audioCaptureModule_->SetAudioSource(AudioStandard::SourceType::SOURCE_TYPE_MIC);
+    Status ret = audioCaptureModule_->SetParameter(audioCaptureParameter_);
+    ASSERT_TRUE(ret == Status::OK);
+    ret = audioCaptureModule_->Init();
+    ASSERT_TRUE(ret == Status::OK);
+    ret = audioCaptureModule_->Prepare();
+    ASSERT_TRUE(ret == Status::OK);
+    ret = audioCaptureModule_->Start();
+    ASSERT_TRUE(ret == Status::OK);
+    uint64_t bufferSize = 0;
+    ret = audioCaptureModule_->GetSize(bufferSize);
+    ASSERT_TRUE(ret == Status::OK);
+    audioCaptureModule_->GetMaxAmplitude();
+    EXPECT_TRUE(audioCaptureModule_->isTrackMaxAmplitude);
+    EXPECT_FALSE(audioCaptureModule_->levelMeter_.loudnessEnabled_);
+    AudioCaptureModule::AudioLevels levels;
+    ret = audioCaptureModule_->GetAudioLevels(levels);
+    ASSERT_TRUE(ret == Status::OK);
+    EXPECT_TRUE(audioCaptureModule_->levelMeter_.loudnessEnabled_);
+    std::shared_ptr<AVAllocator> avAllocator =
+        AVAllocatorFactory::CreateSharedAllocator(MemoryFlag::MEMORY_READ_WRITE);
+    int32_t capacity = 1024;
+    std::shared_ptr<AVBuffer> buffer = AVBuffer::CreateAVBuffer(avAllocator, capacity);
+    ret = audioCaptureModule_->Read(buffer, bufferSize);
+    ASSERT_TRUE(ret == Status::OK);
+    ret = audioCaptureModule_->GetAudioLevels(levels);
+    ASSERT_TRUE(ret == Status::OK);
+    EXPECT_GE(levels.momentaryLoudness, AudioCaptureModule::AudioLevelMeter::SILENCE_LOUDNESS);
+    ret = audioCaptureModule_->Stop();
+    ASSERT_TRUE(ret == Status::OK);
+    ret = audioCaptureModule_->Deinit();
+    ASSERT_TRUE(ret == Status::OK);
+}
 /**
  * @tc.name: AudioSetAudioCapturerInfoChangeCallback_0100
  * @tc.desc: test SetAudioCapturerInfoChangeCallback
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "gtest/gtest.h"
+#include "audio_level_meter.h"
+
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace OHOS::Media::AudioCaptureModule;
+using namespace testing::ext;
+
+namespace {
+constexpr uint32_t SAMPLE_RATE = 48000;
+constexpr uint32_t STEREO = 2;
+constexpr uint32_t SURROUND = 6;
+constexpr double SINE_FREQUENCY = 1000.0;
+constexpr float SINE_AMPLITUDE = 0.1f;
+constexpr float S16_FULL_SCALE = 32768.0f;
+// a 1 kHz sine at 0 dBFS on one channel reads -3.01 LUFS
+constexpr float FULL_SCALE_SINE_LOUDNESS = -3.01f;
+constexpr float LOUDNESS_TOLERANCE = 0.1f;
+constexpr float LEVEL_TOLERANCE = 1e-4f;
+constexpr uint32_t BENCH_FRAME_NUM = 960; // one 20 ms capture block
+constexpr uint32_t BENCH_BLOCK_NUM = 20000;
+
+std::vector<float> Sine(uint32_t frameNum, uint32_t channelCount, float amplitude)
+{
+    std::vector<float> samples(frameNum * channelCount);
+    for (uint32_t frame = 0; frame < frameNum; ++frame) {
+        float value = amplitude * static_cast<float>(std::sin(2.0 * M_PI * SINE_FREQUENCY * frame / SAMPLE_RATE));
+        for (uint32_t channel = 0; channel < channelCount; ++channel) {
+            // every channel gets a different level, so a lane mixed into the wrong channel shows up
+            samples[frame * channelCount + channel] = value / (channel + 1);
+        }
+    }
+    return samples;
+}
+
+std::vector<int16_t> ToS16(const std::vector<float> &samples)
+{
+    std::vector<int16_t> out;
+    for (float sample : samples) {
+        out.push_back(static_cast<int16_t>(std::lround(sample * (S16_FULL_SCALE - 1))));
+    }
+    return out;
+}
+
+template <typename Sample>
+const uint8_t *Bytes(const std::vector<Sample> &samples)
+{
+    return reinterpret_cast<const uint8_t *>(samples.data());
+}
+
+// The scalar loop the capture module used before, kept as the benchmark baseline
+int32_t ScalarMaxAmplitude(const int16_t *data, int32_t size, int32_t maxAmplitude)
+{
+    for (int32_t i = 0; i < size; i++) {
+        int16_t value = *data++;
+        if (value < 0) {
+            value = -value;
+        }
+        if (maxAmplitude < value) {
+            maxAmplitude = value;
+        }
+    }
+    return maxAmplitude;
+}
+
+class AudioLevelMeterUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp(void) {}
+    void TearDown(void) {}
+};
+
+/**
+ * @tc.name: AudioLevelMeter_Levels_0100
+ * @tc.desc: per channel peak and rms of a stereo sine, through the vector path of every format
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioLevelMeterUnitTest, AudioLevelMeter_Levels_0100, TestSize.Level1)
+{
+    auto samples = Sine(SAMPLE_RATE / 10, STEREO, SINE_AMPLITUDE); // 10: 100 ms
+    std::vector<int32_t> s32;
+    for (float sample : samples) {
+        s32.push_back(static_cast<int32_t>(sample * 2147483647.0f)); // 2147483647: s32 full scale
+    }
+    auto s16 = ToS16(samples);
+    struct Case {
+        Plugins::AudioSampleFormat format;
+        const uint8_t *data;
+        size_t size;
+    } cases[] = {
+        { Plugins::AudioSampleFormat::SAMPLE_F32LE, Bytes(samples), samples.size() * sizeof(float) },
+        { Plugins::AudioSampleFormat::SAMPLE_S32LE, Bytes(s32), s32.size() * sizeof(int32_t) },
+        { Plugins::AudioSampleFormat::SAMPLE_S16LE, Bytes(s16), s16.size() * sizeof(int16_t) },
+    };
+    for (const auto &item : cases) {
+        AudioLevelMeter meter;
+        ASSERT_EQ(meter.Configure(item.format, STEREO, SAMPLE_RATE), Status::OK);
+        meter.Process(item.data, item.size);
+        AudioLevels levels;
+        meter.GetLevels(levels);
+        ASSERT_EQ(levels.channels.size(), STEREO);
+        for (uint32_t channel = 0; channel < STEREO; ++channel) {
+            float amplitude = SINE_AMPLITUDE / (channel + 1);
+            EXPECT_NEAR(levels.channels[channel].peak, amplitude, LEVEL_TOLERANCE);
+            EXPECT_NEAR(levels.channels[channel].rms, amplitude / std::sqrt(2.0f), LEVEL_TOLERANCE); // 2: sine rms
+        }
+        meter.GetLevels(levels);
+        EXPECT_EQ(levels.channels[0].peak, 0.0f);
+    }
+}
+
+/**
+ * @tc.name: AudioLevelMeter_Levels_0200
+ * @tc.desc: layouts off the vector path give the same levels, odd sized blocks keep channel alignment
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioLevelMeterUnitTest, AudioLevelMeter_Levels_0200, TestSize.Level1)
+{
+    auto samples = Sine(SAMPLE_RATE / 10, SURROUND, SINE_AMPLITUDE); // 10: 100 ms
+    AudioLevelMeter meter;
+    ASSERT_EQ(meter.Configure(Plugins::AudioSampleFormat::SAMPLE_F32LE, SURROUND, SAMPLE_RATE), Status::OK);
+    size_t half = samples.size() / 2 + 3; // 3: cut inside a frame, the partial frame is ignored
+    meter.Process(Bytes(samples), half * sizeof(float));
+    AudioLevels levels;
+    meter.GetLevels(levels);
+    ASSERT_EQ(levels.channels.size(), SURROUND);
+    for (uint32_t channel = 0; channel < SURROUND; ++channel) {
+        EXPECT_NEAR(levels.channels[channel].peak, SINE_AMPLITUDE / (channel + 1), LEVEL_TOLERANCE);
+    }
+}
+
+/**
+ * @tc.name: AudioLevelMeter_MaxAmplitude_0100
+ * @tc.desc: s16 peak keeps the recorder scale and saturates the most negative sample
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioLevelMeterUnitTest, AudioLevelMeter_MaxAmplitude_0100, TestSize.Level1)
+{
+    AudioLevelMeter meter;
+    ASSERT_EQ(meter.Configure(Plugins::AudioSampleFormat::SAMPLE_S16LE, 1, SAMPLE_RATE), Status::OK);
+    std::vector<int16_t> samples = { 1, -1200, 300, 4, 5, 6, 7 };
+    meter.Process(Bytes(samples), samples.size() * sizeof(int16_t));
+    EXPECT_EQ(meter.GetMaxAmplitude(), 1200);
+    EXPECT_EQ(meter.GetMaxAmplitude(), 0);
+    samples = { 0, INT16_MIN, 0, 0, 0 };
+    meter.Process(Bytes(samples), samples.size() * sizeof(int16_t));
+    EXPECT_EQ(meter.GetMaxAmplitude(), INT16_MAX);
+    EXPECT_NE(meter.Configure(Plugins::AudioSampleFormat::INVALID_WIDTH, 1, SAMPLE_RATE), Status::OK);
+    meter.Process(Bytes(samples), samples.size() * sizeof(int16_t));
+    EXPECT_EQ(meter.GetMaxAmplitude(), 0);
+}
+
+/**
+ * @tc.name: AudioLevelMeter_Loudness_0100
+ * @tc.desc: momentary loudness of a 1 kHz sine matches the BS.1770 reference
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioLevelMeterUnitTest, AudioLevelMeter_Loudness_0100, TestSize.Level1)
+{
+    AudioLevelMeter meter;
+    ASSERT_EQ(meter.Configure(Plugins::AudioSampleFormat::SAMPLE_F32LE, 1, SAMPLE_RATE), Status::OK);
+    auto samples = Sine(SAMPLE_RATE, 1, SINE_AMPLITUDE);
+    meter.Process(Bytes(samples), samples.size() * sizeof(float));
+    AudioLevels levels;
+    meter.GetLevels(levels);
+    EXPECT_EQ(levels.momentaryLoudness, AudioLevelMeter::SILENCE_LOUDNESS);
+
+    meter.EnableLoudness(true);
+    meter.Process(Bytes(samples), samples.size() * sizeof(float));
+    meter.GetLevels(levels);
+    float expected = FULL_SCALE_SINE_LOUDNESS + 20.0f * std::log10(SINE_AMPLITUDE); // 20: amplitude decibel
+    EXPECT_NEAR(levels.momentaryLoudness, expected, LOUDNESS_TOLERANCE);
+}
+
+/**
+ * @tc.name: AudioLevelMeter_Perf_0100
+ * @tc.desc: s16 stereo metering throughput against the scalar max amplitude loop
+ * @tc.type: PERF
+ */
+HWTEST_F(AudioLevelMeterUnitTest, AudioLevelMeter_Perf_0100, TestSize.Level3)
+{
+    auto block = ToS16(Sine(BENCH_FRAME_NUM, STEREO, SINE_AMPLITUDE));
+    size_t blockBytes = block.size() * sizeof(int16_t);
+    double totalMb = static_cast<double>(blockBytes) * BENCH_BLOCK_NUM / (1024 * 1024); // 1024: MB
+
+    AudioLevelMeter meter;
+    ASSERT_EQ(meter.Configure(Plugins::AudioSampleFormat::SAMPLE_S16LE, STEREO, SAMPLE_RATE), Status::OK);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_BLOCK_NUM; ++i) {
+        meter.Process(Bytes(block), blockBytes);
+    }
+    double meterSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_GT(meter.GetMaxAmplitude(), 0);
+
+    meter.EnableLoudness(true);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_BLOCK_NUM; ++i) {
+        meter.Process(Bytes(block), blockBytes);
+    }
+    double loudnessSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int32_t maxAmplitude = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_BLOCK_NUM; ++i) {
+        maxAmplitude = ScalarMaxAmplitude(block.data(), static_cast<int32_t>(block.size()), maxAmplitude);
+    }
+    double scalarSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_GT(maxAmplitude, 0);
+
+    std::cout << "peak+rms: " << totalMb / meterSec << " MB/s, with loudness: " << totalMb / loudnessSec
+              << " MB/s, scalar peak only: " << totalMb / scalarSec << " MB/s" << std::endl;
+}
+} // namespace
@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "securec.h"
+#include "audio_buffer_free_list.h"
+#include "audio_buffers_manager.h"
+#include "audio_codec_adapter.h"
+#include "avcodec_codec_name.h"
+#include "avcodec_errors.h"
+#include "media_description.h"
+
+using namespace std;
+using namespace testing::ext;
+using namespace OHOS::MediaAVCodec;
+
+namespace {
+constexpr uint32_t BUFFER_SIZE = 1024;
+constexpr uint16_t BUFFER_COUNT = 8;
+constexpr uint32_t STRESS_THREAD_NUM = 16;
+constexpr uint32_t STRESS_ROUND_NUM = 20000;
+constexpr uint32_t FREE_LIST_PRODUCER_NUM = 4;
+constexpr uint32_t FREE_LIST_ITEM_NUM = 100000;
+constexpr uint32_t SESSION_NUM = 64;
+constexpr uint32_t INPUT_REPEAT_NUM = 10;
+constexpr uint32_t AMRNB_CHANNEL_COUNT = 1;
+constexpr uint32_t AMRNB_SAMPLE_RATE = 8000;
+constexpr int64_t AMRNB_BITRATE = 12200;
+constexpr int64_t AMRNB_FRAME_US = 20000;
+constexpr auto SESSION_TIMEOUT = std::chrono::seconds(60);
+constexpr string_view INPUT_AMRNB_FILE_PATH = "/data/test/media/voice_amrnb_12200.dat";
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+class AudioBuffersManagerUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp() {}
+    void TearDown() {}
+};
+
+struct AmrFrame {
+    vector<uint8_t> data;
+};
+
+vector<AmrFrame> LoadAmrFrames()
+{
+    vector<AmrFrame> frames;
+    ifstream input(INPUT_AMRNB_FILE_PATH.data(), std::ios::binary);
+    int64_t size = 0;
+    int64_t pts = 0;
+    while (input.read(reinterpret_cast<char *>(&size), sizeof(size)) &&
+        input.read(reinterpret_cast<char *>(&pts), sizeof(pts))) {
+        if (size <= 0 || size > BUFFER_SIZE) {
+            break;
+        }
+        AmrFrame frame;
+        frame.data.resize(static_cast<size_t>(size));
+        if (!input.read(reinterpret_cast<char *>(frame.data.data()), size)) {
+            break;
+        }
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+// One decoder instance fed from memory, a single client thread serves both callbacks the way apps usually do
+class AmrDecodeSession : public AVCodecCallback {
+public:
+    explicit AmrDecodeSession(const vector<AmrFrame> &frames) : frames_(frames) {}
+
+    ~AmrDecodeSession()
+    {
+        {
+            lock_guard<mutex> lock(mutex_);
+            stop_ = true;
+            cond_.notify_all();
+        }
+        if (client_.joinable()) {
+            client_.join();
+        }
+    }
+
+    int32_t Start()
+    {
+        adec_ = std::make_shared<AudioCodecAdapter>(std::string(AVCodecCodecName::AUDIO_DECODER_AMRNB_NAME));
+        Format format;
+        format.PutIntValue(MediaDescriptionKey::MD_KEY_CHANNEL_COUNT, AMRNB_CHANNEL_COUNT);
+        format.PutIntValue(MediaDescriptionKey::MD_KEY_SAMPLE_RATE, AMRNB_SAMPLE_RATE);
+        format.PutLongValue(MediaDescriptionKey::MD_KEY_BITRATE, AMRNB_BITRATE);
+        int32_t ret = adec_->SetCallback(std::shared_ptr<AVCodecCallback>(this, [](AVCodecCallback *) {}));
+        if (ret != AVCodecServiceErrCode::AVCS_ERR_OK) {
+            return ret;
+        }
+        ret = adec_->Configure(format);
+        if (ret != AVCodecServiceErrCode::AVCS_ERR_OK) {
+            return ret;
+        }
+        client_ = std::thread([this] { ClientLoop(); });
+        return adec_->Start();
+    }
+
+    bool WaitDone()
+    {
+        unique_lock<mutex> lock(mutex_);
+        bool done = cond_.wait_for(lock, SESSION_TIMEOUT, [this] { return outputEos_ || error_; });
+        stop_ = true;
+        cond_.notify_all();
+        lock.unlock();
+        if (client_.joinable()) {
+            client_.join();
+        }
+        adec_->Stop();
+        adec_->Release();
+        return done && !error_;
+    }
+
+    uint64_t OutputFrames() const
+    {
+        return outputFrames_;
+    }
+
+    void OnError(AVCodecErrorType errorType, int32_t errorCode) override
+    {
+        (void)errorType;
+        cout << "Error errorCode=" << errorCode << endl;
+        lock_guard<mutex> lock(mutex_);
+        error_ = true;
+        cond_.notify_all();
+    }
+
+    void OnOutputFormatChanged(const Format &format) override
+    {
+        (void)format;
+    }
+
+    void OnInputBufferAvailable(uint32_t index, std::shared_ptr<AVSharedMemory> buffer) override
+    {
+        lock_guard<mutex> lock(mutex_);
+        inputQueue_.push({ index, buffer });
+        cond_.notify_all();
+    }
+
+    void OnOutputBufferAvailable(uint32_t index, AVCodecBufferInfo info, AVCodecBufferFlag flag,
+                                 std::shared_ptr<AVSharedMemory> buffer) override
+    {
+        (void)info;
+        (void)buffer;
+        lock_guard<mutex> lock(mutex_);
+        outputQueue_.push({ index, flag });
+        cond_.notify_all();
+    }
+
+private:
+    void ClientLoop()
+    {
+        while (true) {
+            queue<pair<uint32_t, std::shared_ptr<AVSharedMemory>>> inputs;
+            queue<pair<uint32_t, AVCodecBufferFlag>> outputs;
+            {
+                unique_lock<mutex> lock(mutex_);
+                cond_.wait(lock, [this] { return stop_ || !inputQueue_.empty() || !outputQueue_.empty(); });
+                if (stop_) {
+                    break;
+                }
+                inputs.swap(inputQueue_);
+                outputs.swap(outputQueue_);
+            }
+            for (; !outputs.empty(); outputs.pop()) {
+                auto [index, flag] = outputs.front();
+                adec_->ReleaseOutputBuffer(index);
+                if (flag != AVCODEC_BUFFER_FLAG_EOS) {
+                    outputFrames_++;
+                    continue;
+                }
+                lock_guard<mutex> lock(mutex_);
+                outputEos_ = true;
+                cond_.notify_all();
+            }
+            for (; !inputs.empty() && !inputEos_; inputs.pop()) {
+                QueueNextFrame(inputs.front().first, inputs.front().second);
+            }
+        }
+    }
+
+    void QueueNextFrame(uint32_t index, const std::shared_ptr<AVSharedMemory> &buffer)
+    {
+        AVCodecBufferInfo info;
+        info.presentationTimeUs = static_cast<int64_t>(sent_) * AMRNB_FRAME_US;
+        if (sent_ >= frames_.size() * INPUT_REPEAT_NUM) {
+            inputEos_ = true;
+            adec_->QueueInputBuffer(index, info, AVCODEC_BUFFER_FLAG_EOS);
+            return;
+        }
+        const AmrFrame &frame = frames_[sent_ % frames_.size()];
+        (void)memcpy_s(buffer->GetBase(), buffer->GetSize(), frame.data.data(), frame.data.size());
+        info.size = static_cast<int32_t>(frame.data.size());
+        sent_++;
+        adec_->QueueInputBuffer(index, info, AVCODEC_BUFFER_FLAG_NONE);
+    }
+
+    const vector<AmrFrame> &frames_;
+    std::shared_ptr<CodecBase> adec_;
+    std::thread client_;
+    mutex mutex_;
+    condition_variable cond_;
+    queue<pair<uint32_t, std::shared_ptr<AVSharedMemory>>> inputQueue_;
+    queue<pair<uint32_t, AVCodecBufferFlag>> outputQueue_;
+    size_t sent_ = 0;
+    bool inputEos_ = false;
+    bool outputEos_ = false;
+    bool error_ = false;
+    bool stop_ = false;
+    uint64_t outputFrames_ = 0;
+};
+
+/**
+ * @tc.name: AudioBufferFreeList_Bounded_001
+ * @tc.desc: capacity rounds up, full and empty are reported and Clear resets the ring
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioBuffersManagerUnitTest, AudioBufferFreeList_Bounded_001, TestSize.Level1)
+{
+    AudioBufferFreeList freeList(5); // 5: rounds up to 8
+    ASSERT_EQ(freeList.Capacity(), 8);
+    EXPECT_TRUE(freeList.Empty());
+    for (uint32_t i = 0; i < freeList.Capacity(); ++i) {
+        EXPECT_TRUE(freeList.Push(i));
+    }
+    EXPECT_FALSE(freeList.Push(0));
+    uint32_t index = 0;
+    for (uint32_t i = 0; i < freeList.Capacity(); ++i) {
+        ASSERT_TRUE(freeList.Pop(index));
+        EXPECT_EQ(index, i);
+    }
+    EXPECT_FALSE(freeList.Pop(index));
+    EXPECT_TRUE(freeList.Push(1));
+    freeList.Clear();
+    EXPECT_TRUE(freeList.Empty());
+    EXPECT_FALSE(freeList.Pop(index));
+}
+
+/**
+ * @tc.name: AudioBufferFreeList_Mpmc_001
+ * @tc.desc: every pushed index is popped exactly once with concurrent producers and consumers
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioBuffersManagerUnitTest, AudioBufferFreeList_Mpmc_001, TestSize.Level1)
+{
+    AudioBufferFreeList freeList(BUFFER_COUNT);
+    vector<atomic<uint32_t>> popped(FREE_LIST_ITEM_NUM * FREE_LIST_PRODUCER_NUM);
+    atomic<uint32_t> poppedNum = 0;
+    vector<thread> threads;
+    for (uint32_t producer = 0; producer < FREE_LIST_PRODUCER_NUM; ++producer) {
+        threads.emplace_back([&freeList, producer] {
+            for (uint32_t i = 0; i < FREE_LIST_ITEM_NUM; ++i) {
+                while (!freeList.Push(producer * FREE_LIST_ITEM_NUM + i)) {
+                    this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&freeList, &popped, &poppedNum] {
+            uint32_t index = 0;
+            while (poppedNum.load() < popped.size()) {
+                if (freeList.Pop(index)) {
+                    popped[index]++;
+                    poppedNum++;
+                } else {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &item : threads) {
+        item.join();
+    }
+    for (const auto &count : popped) {
+        ASSERT_EQ(count.load(), 1);
+    }
+}
+
+/**
+ * @tc.name: AudioBuffersManager_Release_001
+ * @tc.desc: a double release queues the index once and DisableRunning wakes a blocked request
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioBuffersManagerUnitTest, AudioBuffersManager_Release_001, TestSize.Level1)
+{
+    AudioBuffersManager manager(BUFFER_SIZE, "test", BUFFER_COUNT);
+    vector<uint32_t> owned(BUFFER_COUNT);
+    for (auto &index : owned) {
+        ASSERT_TRUE(manager.RequestAvailableIndex(index));
+    }
+    EXPECT_TRUE(manager.ReleaseBuffer(owned[0]));
+    EXPECT_TRUE(manager.ReleaseBuffer(owned[0]));
+    EXPECT_FALSE(manager.ReleaseBuffer(BUFFER_COUNT * 4)); // 4: out of range
+    uint32_t index = 0;
+    ASSERT_TRUE(manager.RequestAvailableIndex(index));
+    EXPECT_EQ(index, owned[0]);
+
+    atomic<bool> returned = false;
+    thread waiter([&manager, &returned] {
+        uint32_t blocked = 0;
+        EXPECT_FALSE(manager.RequestAvailableIndex(blocked));
+        returned = true;
+    });
+    this_thread::sleep_for(std::chrono::milliseconds(50)); // 50: let the waiter block
+    EXPECT_FALSE(returned.load());
+    manager.DisableRunning();
+    waiter.join();
+    EXPECT_TRUE(returned.load());
+
+    manager.SetRunning();
+    manager.ReleaseAll();
+    for (uint32_t i = 0; i < BUFFER_COUNT; ++i) {
+        EXPECT_TRUE(manager.RequestAvailableIndex(index));
+    }
+}
+
+/**
+ * @tc.name: AudioBuffersManager_Stress_001
+ * @tc.desc: threads fighting over few buffers never own the same index at once and none get lost
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioBuffersManagerUnitTest, AudioBuffersManager_Stress_001, TestSize.Level1)
+{
+    AudioBuffersManager manager(BUFFER_SIZE, "stress", BUFFER_COUNT);
+    vector<atomic<bool>> owned(BUFFER_COUNT);
+    atomic<uint32_t> conflicts = 0;
+    vector<thread> threads;
+    for (uint32_t i = 0; i < STRESS_THREAD_NUM; ++i) {
+        threads.emplace_back([&manager, &owned, &conflicts] {
+            uint32_t index = 0;
+            for (uint32_t round = 0; round < STRESS_ROUND_NUM; ++round) {
+                if (!manager.RequestAvailableIndex(index) || index >= BUFFER_COUNT) {
+                    conflicts++;
+                    return;
+                }
+                if (owned[index].exchange(true)) {
+                    conflicts++;
+                }
+                manager.SetBufferBusy(index);
+                owned[index] = false;
+                manager.ReleaseBuffer(index);
+            }
+        });
+    }
+    for (auto &item : threads) {
+        item.join();
+    }
+    EXPECT_EQ(conflicts.load(), 0);
+    uint32_t index = 0;
+    for (uint32_t i = 0; i < BUFFER_COUNT; ++i) {
+        ASSERT_TRUE(manager.RequestAvailableIndex(index));
+    }
+}
+
+/**
+ * @tc.name: AudioBuffersManager_ReleaseAll_001
+ * @tc.desc: ReleaseAll racing requests and releases, as on an asynchronous worker stop, queues every index once
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioBuffersManagerUnitTest, AudioBuffersManager_ReleaseAll_001, TestSize.Level1)
+{
+    AudioBuffersManager manager(BUFFER_SIZE, "release_all", BUFFER_COUNT);
+    atomic<bool> isStopped = false;
+    vector<thread> threads;
+    for (uint32_t i = 0; i < STRESS_THREAD_NUM; ++i) {
+        threads.emplace_back([&manager, &isStopped] {
+            uint32_t index = 0;
+            while (!isStopped.load() && manager.RequestAvailableIndex(index)) {
+                manager.ReleaseBuffer(index);
+            }
+        });
+    }
+    for (uint32_t round = 0; round < STRESS_ROUND_NUM; ++round) {
+        manager.ReleaseAll();
+    }
+    isStopped = true;
+    manager.DisableRunning();
+    for (auto &item : threads) {
+        item.join();
+    }
+
+    manager.SetRunning();
+    manager.ReleaseAll();
+    vector<bool> requested(BUFFER_COUNT, false);
+    uint32_t index = 0;
+    for (uint32_t i = 0; i < BUFFER_COUNT; ++i) {
+        ASSERT_TRUE(manager.RequestAvailableIndex(index));
+        ASSERT_LT(index, BUFFER_COUNT);
+        EXPECT_FALSE(requested[index]);
+        requested[index] = true;
+    }
+    // no index was queued twice, the list is empty now
+    manager.DisableRunning();
+    EXPECT_FALSE(manager.RequestAvailableIndex(index));
+}
+
+/**
+ * @tc.name: AudioBuffersManager_Perf_001
+ * @tc.desc: 64 concurrent amr-nb decoders, every buffer handoff goes through the lock free free list
+ * @tc.type: PERF
+ */
+HWTEST_F(AudioBuffersManagerUnitTest, AudioBuffersManager_Perf_001, TestSize.Level3)
+{
+    auto frames = LoadAmrFrames();
+    ASSERT_FALSE(frames.empty());
+    vector<std::unique_ptr<AmrDecodeSession>> sessions;
+    for (uint32_t i = 0; i < SESSION_NUM; ++i) {
+        sessions.push_back(std::make_unique<AmrDecodeSession>(frames));
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (auto &session : sessions) {
+        ASSERT_EQ(session->Start(), AVCodecServiceErrCode::AVCS_ERR_OK);
+    }
+    uint64_t totalFrames = 0;
+    for (auto &session : sessions) {
+        EXPECT_TRUE(session->WaitDone());
+        totalFrames += session->OutputFrames();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cout << "sessions: " << SESSION_NUM << ", frames: " << totalFrames << ", " << totalFrames / seconds
+         << " frames/s, realtime x" << totalFrames * AMRNB_FRAME_US / 1e6 / seconds << endl;
+    EXPECT_GT(totalFrames, 0);
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
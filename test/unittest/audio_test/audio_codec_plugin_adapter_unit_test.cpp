@@ -0,0 +1,460 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "securec.h"
+#include "audio_codec_adapter.h"
+#include "avcodec_audio_channel_layout.h"
+#include "avcodec_audio_common.h"
+#include "audio_codec_plugin_adapter.h"
+#include "avcodec_codec_name.h"
+#include "avcodec_errors.h"
+#include "media_description.h"
+
+using namespace std;
+using namespace testing::ext;
+using namespace OHOS::MediaAVCodec;
+
+namespace {
+constexpr int64_t MAX_FRAME_SIZE = 8192;
+constexpr uint32_t INPUT_REPEAT_NUM = 10;
+constexpr uint32_t BENCH_SESSION_NUM = 8;
+constexpr double P99 = 0.99;
+constexpr auto SESSION_TIMEOUT = std::chrono::seconds(60);
+
+struct AudioResource {
+    string_view name;
+    string_view path;
+    int32_t channelCount;
+    int32_t sampleRate;
+    int64_t bitrate;
+    int64_t frameUs;
+};
+
+const AudioResource AMRNB_RESOURCE = { AVCodecCodecName::AUDIO_DECODER_AMRNB_NAME,
+    "/data/test/media/voice_amrnb_12200.dat", 1, 8000, 12200, 20000 };
+const AudioResource AMRWB_RESOURCE = { AVCodecCodecName::AUDIO_DECODER_AMRWB_NAME,
+    "/data/test/media/voice_amrwb_23850.dat", 1, 16000, 23850, 20000 };
+const AudioResource MP3_RESOURCE = { AVCodecCodecName::AUDIO_DECODER_MP3_NAME,
+    "/data/test/media/mp3_2c_44100hz_60k.dat", 2, 44100, 60000, 26122 };
+
+struct LegacyCodec {
+    string_view name;
+    int32_t channelCount;
+    int32_t sampleRate;
+    int64_t bitrate;
+};
+
+// every codec AudioBaseCodec registers, the api 10 audio path serves exactly these
+const LegacyCodec LEGACY_CODECS[] = {
+    { AVCodecCodecName::AUDIO_DECODER_AAC_NAME, 2, 44100, 128000 },
+    { AVCodecCodecName::AUDIO_DECODER_MP3_NAME, 2, 44100, 128000 },
+    { AVCodecCodecName::AUDIO_DECODER_FLAC_NAME, 2, 44100, 128000 },
+    { AVCodecCodecName::AUDIO_DECODER_VORBIS_NAME, 2, 44100, 128000 },
+    { AVCodecCodecName::AUDIO_DECODER_AMRNB_NAME, 1, 8000, 12200 },
+    { AVCodecCodecName::AUDIO_DECODER_AMRWB_NAME, 1, 16000, 23850 },
+    { AVCodecCodecName::AUDIO_DECODER_G711MU_NAME, 1, 8000, 64000 },
+    { AVCodecCodecName::AUDIO_DECODER_OPUS_NAME, 2, 48000, 64000 },
+    { AVCodecCodecName::AUDIO_ENCODER_AAC_NAME, 2, 44100, 128000 },
+    { AVCodecCodecName::AUDIO_ENCODER_FLAC_NAME, 2, 44100, 128000 },
+    { AVCodecCodecName::AUDIO_ENCODER_G711MU_NAME, 1, 8000, 64000 },
+    { AVCodecCodecName::AUDIO_ENCODER_OPUS_NAME, 2, 48000, 64000 },
+};
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+enum class Engine {
+    LEGACY,
+    SHIM_ASYNC,
+    SHIM_SYNC,
+};
+
+const char *EngineName(Engine engine)
+{
+    switch (engine) {
+        case Engine::LEGACY:
+            return "legacy";
+        case Engine::SHIM_ASYNC:
+            return "shim async";
+        default:
+            return "shim sync";
+    }
+}
+
+class AudioCodecPluginAdapterUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp() {}
+    void TearDown() {}
+};
+
+vector<vector<uint8_t>> LoadFrames(const AudioResource &resource)
+{
+    vector<vector<uint8_t>> frames;
+    ifstream input(resource.path.data(), std::ios::binary);
+    int64_t size = 0;
+    int64_t pts = 0;
+    while (input.read(reinterpret_cast<char *>(&size), sizeof(size)) &&
+        input.read(reinterpret_cast<char *>(&pts), sizeof(pts))) {
+        if (size <= 0 || size > MAX_FRAME_SIZE) {
+            break;
+        }
+        vector<uint8_t> frame(static_cast<size_t>(size));
+        if (!input.read(reinterpret_cast<char *>(frame.data()), size)) {
+            break;
+        }
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+Format ResourceFormat(const AudioResource &resource)
+{
+    Format format;
+    format.PutIntValue(MediaDescriptionKey::MD_KEY_CHANNEL_COUNT, resource.channelCount);
+    format.PutIntValue(MediaDescriptionKey::MD_KEY_SAMPLE_RATE, resource.sampleRate);
+    format.PutLongValue(MediaDescriptionKey::MD_KEY_BITRATE, resource.bitrate);
+    return format;
+}
+
+// One decoder fed from memory by a single client thread, records when each pts went in and came out
+class DecodeSession : public AVCodecCallback {
+public:
+    DecodeSession(const AudioResource &resource, const vector<vector<uint8_t>> &frames, Engine engine)
+        : resource_(resource), frames_(frames), engine_(engine)
+    {
+    }
+
+    ~DecodeSession()
+    {
+        {
+            lock_guard<mutex> lock(mutex_);
+            stop_ = true;
+            cond_.notify_all();
+        }
+        if (client_.joinable()) {
+            client_.join();
+        }
+    }
+
+    int32_t Start()
+    {
+        Format format = ResourceFormat(resource_);
+        if (engine_ == Engine::LEGACY) {
+            codec_ = std::make_shared<AudioCodecAdapter>(std::string(resource_.name));
+        } else {
+            codec_ = std::make_shared<AudioCodecPluginAdapter>(std::string(resource_.name));
+            format.PutIntValue(AudioCodecPluginAdapter::SYNC_MODE_KEY, engine_ == Engine::SHIM_SYNC ? 1 : 0);
+        }
+        int32_t ret = codec_->SetCallback(std::shared_ptr<AVCodecCallback>(this, [](AVCodecCallback *) {}));
+        if (ret != AVCodecServiceErrCode::AVCS_ERR_OK) {
+            return ret;
+        }
+        ret = codec_->Configure(format);
+        if (ret != AVCodecServiceErrCode::AVCS_ERR_OK) {
+            return ret;
+        }
+        client_ = std::thread([this] { ClientLoop(); });
+        return codec_->Start();
+    }
+
+    bool WaitDone()
+    {
+        unique_lock<mutex> lock(mutex_);
+        bool done = cond_.wait_for(lock, SESSION_TIMEOUT, [this] { return outputEos_ || error_; });
+        stop_ = true;
+        cond_.notify_all();
+        lock.unlock();
+        if (client_.joinable()) {
+            client_.join();
+        }
+        codec_->Stop();
+        codec_->Release();
+        return done && !error_;
+    }
+
+    uint64_t OutputFrames() const
+    {
+        return outputFrames_;
+    }
+
+    uint64_t OutputBytes() const
+    {
+        return outputBytes_;
+    }
+
+    const vector<double> &LatenciesUs() const
+    {
+        return latenciesUs_;
+    }
+
+    void OnError(AVCodecErrorType errorType, int32_t errorCode) override
+    {
+        (void)errorType;
+        cout << "Error errorCode=" << errorCode << endl;
+        lock_guard<mutex> lock(mutex_);
+        error_ = true;
+        cond_.notify_all();
+    }
+
+    void OnOutputFormatChanged(const Format &format) override
+    {
+        (void)format;
+    }
+
+    void OnInputBufferAvailable(uint32_t index, std::shared_ptr<AVSharedMemory> buffer) override
+    {
+        lock_guard<mutex> lock(mutex_);
+        inputQueue_.push({ index, buffer });
+        cond_.notify_all();
+    }
+
+    void OnOutputBufferAvailable(uint32_t index, AVCodecBufferInfo info, AVCodecBufferFlag flag,
+                                 std::shared_ptr<AVSharedMemory> buffer) override
+    {
+        (void)buffer;
+        auto now = std::chrono::steady_clock::now();
+        lock_guard<mutex> lock(mutex_);
+        auto it = queuedAt_.find(info.presentationTimeUs);
+        if (it != queuedAt_.end() && flag != AVCODEC_BUFFER_FLAG_EOS) {
+            latenciesUs_.push_back(std::chrono::duration<double, std::micro>(now - it->second).count());
+            queuedAt_.erase(it);
+        }
+        outputBytes_ += static_cast<uint64_t>(info.size);
+        outputQueue_.push({ index, flag });
+        cond_.notify_all();
+    }
+
+private:
+    void ClientLoop()
+    {
+        while (true) {
+            queue<pair<uint32_t, std::shared_ptr<AVSharedMemory>>> inputs;
+            queue<pair<uint32_t, AVCodecBufferFlag>> outputs;
+            {
+                unique_lock<mutex> lock(mutex_);
+                cond_.wait(lock, [this] { return stop_ || !inputQueue_.empty() || !outputQueue_.empty(); });
+                if (stop_) {
+                    break;
+                }
+                inputs.swap(inputQueue_);
+                outputs.swap(outputQueue_);
+            }
+            for (; !outputs.empty(); outputs.pop()) {
+                auto [index, flag] = outputs.front();
+                codec_->ReleaseOutputBuffer(index);
+                if (flag != AVCODEC_BUFFER_FLAG_EOS) {
+                    outputFrames_++;
+                    continue;
+                }
+                lock_guard<mutex> lock(mutex_);
+                outputEos_ = true;
+                cond_.notify_all();
+            }
+            for (; !inputs.empty() && !inputEos_; inputs.pop()) {
+                QueueNextFrame(inputs.front().first, inputs.front().second);
+            }
+        }
+    }
+
+    void QueueNextFrame(uint32_t index, const std::shared_ptr<AVSharedMemory> &buffer)
+    {
+        AVCodecBufferInfo info;
+        info.presentationTimeUs = static_cast<int64_t>(sent_) * resource_.frameUs;
+        if (sent_ >= frames_.size() * INPUT_REPEAT_NUM) {
+            inputEos_ = true;
+            codec_->QueueInputBuffer(index, info, AVCODEC_BUFFER_FLAG_EOS);
+            return;
+        }
+        const vector<uint8_t> &frame = frames_[sent_ % frames_.size()];
+        (void)memcpy_s(buffer->GetBase(), buffer->GetSize(), frame.data(), frame.size());
+        info.size = static_cast<int32_t>(frame.size());
+        sent_++;
+        {
+            lock_guard<mutex> lock(mutex_);
+            queuedAt_[info.presentationTimeUs] = std::chrono::steady_clock::now();
+        }
+        codec_->QueueInputBuffer(index, info, AVCODEC_BUFFER_FLAG_NONE);
+    }
+
+    const AudioResource &resource_;
+    const vector<vector<uint8_t>> &frames_;
+    Engine engine_;
+    std::shared_ptr<CodecBase> codec_;
+    std::thread client_;
+    mutex mutex_;
+    condition_variable cond_;
+    queue<pair<uint32_t, std::shared_ptr<AVSharedMemory>>> inputQueue_;
+    queue<pair<uint32_t, AVCodecBufferFlag>> outputQueue_;
+    map<int64_t, std::chrono::steady_clock::time_point> queuedAt_;
+    vector<double> latenciesUs_;
+    size_t sent_ = 0;
+    bool inputEos_ = false;
+    bool outputEos_ = false;
+    bool error_ = false;
+    bool stop_ = false;
+    uint64_t outputFrames_ = 0;
+    uint64_t outputBytes_ = 0;
+};
+
+struct BenchResult {
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;
+    vector<double> latenciesUs;
+};
+
+BenchResult RunSessions(const AudioResource &resource, const vector<vector<uint8_t>> &frames, Engine engine,
+                        uint32_t sessionNum)
+{
+    BenchResult result;
+    vector<std::unique_ptr<DecodeSession>> sessions;
+    for (uint32_t i = 0; i < sessionNum; ++i) {
+        sessions.push_back(std::make_unique<DecodeSession>(resource, frames, engine));
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (auto &session : sessions) {
+        EXPECT_EQ(session->Start(), AVCodecServiceErrCode::AVCS_ERR_OK);
+    }
+    for (auto &session : sessions) {
+        EXPECT_TRUE(session->WaitDone());
+        result.frames += session->OutputFrames();
+        result.bytes += session->OutputBytes();
+        const auto &latencies = session->LatenciesUs();
+        result.latenciesUs.insert(result.latenciesUs.end(), latencies.begin(), latencies.end());
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void PrintResult(const AudioResource &resource, Engine engine, BenchResult &result)
+{
+    double average = 0;
+    double p99 = 0;
+    if (!result.latenciesUs.empty()) {
+        std::sort(result.latenciesUs.begin(), result.latenciesUs.end());
+        for (double latency : result.latenciesUs) {
+            average += latency;
+        }
+        average /= result.latenciesUs.size();
+        p99 = result.latenciesUs[static_cast<size_t>((result.latenciesUs.size() - 1) * P99)];
+    }
+    cout << resource.name << " " << EngineName(engine) << ": " << result.frames / result.seconds
+         << " frames/s, realtime x" << result.frames * resource.frameUs / 1e6 / result.seconds
+         << ", latency avg " << average << " us, p99 " << p99 << " us" << endl;
+}
+
+/**
+ * @tc.name: AudioCodecPluginAdapter_Configure_001
+ * @tc.desc: configure checks the legacy keys, buffer calls are refused before start
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioCodecPluginAdapterUnitTest, AudioCodecPluginAdapter_Configure_001, TestSize.Level1)
+{
+    auto codec = std::make_shared<AudioCodecPluginAdapter>(std::string(AVCodecCodecName::AUDIO_DECODER_AMRNB_NAME));
+    Format format;
+    EXPECT_EQ(codec->Configure(format), AVCodecServiceErrCode::AVCS_ERR_CONFIGURE_MISMATCH_CHANNEL_COUNT);
+    format.PutIntValue(MediaDescriptionKey::MD_KEY_CHANNEL_COUNT, AMRNB_RESOURCE.channelCount);
+    EXPECT_EQ(codec->Configure(format), AVCodecServiceErrCode::AVCS_ERR_MISMATCH_SAMPLE_RATE);
+    AVCodecBufferInfo info;
+    EXPECT_EQ(codec->QueueInputBuffer(0, info, AVCODEC_BUFFER_FLAG_NONE),
+        AVCodecServiceErrCode::AVCS_ERR_INVALID_STATE);
+    EXPECT_EQ(codec->ReleaseOutputBuffer(0), AVCodecServiceErrCode::AVCS_ERR_INVALID_VAL);
+    EXPECT_EQ(codec->SetCallback(std::shared_ptr<AVCodecCallback>(nullptr)),
+        AVCodecServiceErrCode::AVCS_ERR_INVALID_VAL);
+    EXPECT_EQ(codec->Release(), AVCodecServiceErrCode::AVCS_ERR_OK);
+}
+
+/**
+ * @tc.name: AudioCodecPluginAdapter_Create_001
+ * @tc.desc: with the shim on every legacy codec is created and configures where the legacy stack does, codecs
+ *           without a media engine plugin such as opus fall back to the legacy stack
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioCodecPluginAdapterUnitTest, AudioCodecPluginAdapter_Create_001, TestSize.Level1)
+{
+    for (const LegacyCodec &legacyCodec : LEGACY_CODECS) {
+        string name(legacyCodec.name);
+        Format format;
+        format.PutIntValue(MediaDescriptionKey::MD_KEY_CHANNEL_COUNT, legacyCodec.channelCount);
+        format.PutIntValue(MediaDescriptionKey::MD_KEY_SAMPLE_RATE, legacyCodec.sampleRate);
+        format.PutLongValue(MediaDescriptionKey::MD_KEY_BITRATE, legacyCodec.bitrate);
+        format.PutIntValue(MediaDescriptionKey::MD_KEY_AUDIO_SAMPLE_FORMAT, AudioSampleFormat::SAMPLE_S16LE);
+        format.PutLongValue(MediaDescriptionKey::MD_KEY_CHANNEL_LAYOUT, legacyCodec.channelCount == 1 ?
+            AudioChannelLayout::MONO : AudioChannelLayout::STEREO);
+
+        auto legacy = std::make_shared<AudioCodecAdapter>(name);
+        int32_t legacyRet = legacy->Configure(format);
+        EXPECT_EQ(legacy->Release(), AVCodecServiceErrCode::AVCS_ERR_OK) << name;
+
+        std::shared_ptr<CodecBase> codec = AudioCodecPluginAdapter::Create(name);
+        ASSERT_NE(codec, nullptr) << name;
+        int32_t ret = codec->Configure(format);
+        if (legacyRet == AVCodecServiceErrCode::AVCS_ERR_OK) {
+            EXPECT_EQ(ret, AVCodecServiceErrCode::AVCS_ERR_OK) << name;
+        }
+        EXPECT_EQ(codec->Release(), AVCodecServiceErrCode::AVCS_ERR_OK) << name;
+    }
+}
+
+/**
+ * @tc.name: AudioCodecPluginAdapter_Decode_001
+ * @tc.desc: the legacy stack and both shim modes decode amr-nb to eos, the shim modes frame for frame alike
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioCodecPluginAdapterUnitTest, AudioCodecPluginAdapter_Decode_001, TestSize.Level1)
+{
+    auto frames = LoadFrames(AMRNB_RESOURCE);
+    ASSERT_FALSE(frames.empty());
+    BenchResult legacy = RunSessions(AMRNB_RESOURCE, frames, Engine::LEGACY, 1);
+    BenchResult async = RunSessions(AMRNB_RESOURCE, frames, Engine::SHIM_ASYNC, 1);
+    BenchResult sync = RunSessions(AMRNB_RESOURCE, frames, Engine::SHIM_SYNC, 1);
+    EXPECT_GT(legacy.frames, 0);
+    EXPECT_GT(async.frames, 0);
+    EXPECT_EQ(sync.frames, async.frames);
+    EXPECT_EQ(sync.bytes, async.bytes);
+}
+
+/**
+ * @tc.name: AudioCodecPluginAdapter_Perf_001
+ * @tc.desc: A/B throughput and queue to output latency of the legacy stack and both shim modes
+ * @tc.type: PERF
+ */
+HWTEST_F(AudioCodecPluginAdapterUnitTest, AudioCodecPluginAdapter_Perf_001, TestSize.Level3)
+{
+    for (const AudioResource *resource : { &AMRNB_RESOURCE, &AMRWB_RESOURCE, &MP3_RESOURCE }) {
+        auto frames = LoadFrames(*resource);
+        ASSERT_FALSE(frames.empty()) << resource->path;
+        for (Engine engine : { Engine::LEGACY, Engine::SHIM_ASYNC, Engine::SHIM_SYNC }) {
+            BenchResult result = RunSessions(*resource, frames, engine, BENCH_SESSION_NUM);
+            EXPECT_GT(result.frames, 0);
+            PrintResult(*resource, engine, result);
+        }
+    }
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
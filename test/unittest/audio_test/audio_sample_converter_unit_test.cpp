@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "audio_sample_converter.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+using namespace OHOS::Media::Plugins::Ffmpeg;
+
+namespace {
+constexpr int32_t SAMPLE_RATE = 44100;
+constexpr int32_t FRAME_SAMPLES = 1024;
+constexpr int32_t BENCH_CHANNELS = 2;
+constexpr int32_t BENCH_FRAMES = 20000;
+constexpr uint32_t RANDOM_SEED = 20240101;
+constexpr float CLIP_RANGE = 1.1f; // a little beyond full scale to cover saturation
+
+struct FormatPair {
+    AVSampleFormat srcFmt;
+    AVSampleFormat destFmt;
+};
+
+// the conversions the audio codecs spend most of their conversion time in
+const FormatPair TOP_PAIRS[] = {
+    { AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_S16 },
+    { AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_FLT },
+    { AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_S32 },
+    { AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_S16 },
+    { AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_S32 },
+    { AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S16 },
+    { AV_SAMPLE_FMT_S32, AV_SAMPLE_FMT_S16 },
+    { AV_SAMPLE_FMT_S32P, AV_SAMPLE_FMT_S16 },
+    { AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_FLT },
+    { AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_FLTP },
+};
+
+bool IsFloat(AVSampleFormat fmt)
+{
+    return av_get_packed_sample_fmt(fmt) == AV_SAMPLE_FMT_FLT;
+}
+
+/**
+ * Random samples of one frame, kept as planes the way an AVFrame holds them.
+ */
+class SampleFrame {
+public:
+    SampleFrame(AVSampleFormat fmt, int32_t channels, int32_t samples, std::mt19937 &rng)
+        : data_(av_samples_get_buffer_size(nullptr, channels, samples, fmt, 1)),
+          planes_(av_sample_fmt_is_planar(fmt) ? channels : 1)
+    {
+        av_samples_fill_arrays(planes_.data(), nullptr, data_.data(), channels, samples, fmt, 1);
+        size_t count = static_cast<size_t>(channels) * static_cast<size_t>(samples);
+        if (IsFloat(fmt)) {
+            std::uniform_real_distribution<float> dist(-CLIP_RANGE, CLIP_RANGE);
+            float *values = reinterpret_cast<float *>(data_.data());
+            for (size_t i = 0; i < count; i++) {
+                values[i] = dist(rng);
+            }
+        } else {
+            for (auto &byte : data_) {
+                byte = static_cast<uint8_t>(rng());
+            }
+        }
+    }
+
+    const uint8_t *const *Planes() const
+    {
+        return planes_.data();
+    }
+
+private:
+    std::vector<uint8_t> data_;
+    std::vector<uint8_t *> planes_;
+};
+
+SwrContext *CreateSwrContext(AVSampleFormat srcFmt, AVSampleFormat destFmt, const AVChannelLayout &layout)
+{
+    SwrContext *swrCtx = nullptr;
+    if (swr_alloc_set_opts2(&swrCtx, &layout, destFmt, SAMPLE_RATE, &layout, srcFmt, SAMPLE_RATE, 0, nullptr) < 0 ||
+        swr_init(swrCtx) < 0) {
+        swr_free(&swrCtx);
+    }
+    return swrCtx;
+}
+
+int32_t SwrConvert(SwrContext *swrCtx, const SampleFrame &frame, int32_t samples, AVSampleFormat destFmt,
+    int32_t channels, std::vector<uint8_t> &dest)
+{
+    dest.resize(av_samples_get_buffer_size(nullptr, channels, samples, destFmt, 1));
+    std::vector<uint8_t *> planes(av_sample_fmt_is_planar(destFmt) ? channels : 1);
+    av_samples_fill_arrays(planes.data(), nullptr, dest.data(), channels, samples, destFmt, 1);
+    return swr_convert(swrCtx, planes.data(), samples, const_cast<const uint8_t **>(frame.Planes()), samples);
+}
+
+// largest difference between two sample buffers, counted in units of the last bit
+int64_t MaxDiff(AVSampleFormat fmt, const std::vector<uint8_t> &first, const std::vector<uint8_t> &second)
+{
+    if (first.size() != second.size()) {
+        return INT64_MAX;
+    }
+    int64_t maxDiff = 0;
+    int32_t bytes = av_get_bytes_per_sample(fmt);
+    for (size_t i = 0; i < first.size(); i += static_cast<size_t>(bytes)) {
+        int64_t diff = 0;
+        if (IsFloat(fmt)) {
+            diff = *reinterpret_cast<const float *>(&first[i]) == *reinterpret_cast<const float *>(&second[i]) ? 0 : 1;
+        } else if (bytes == sizeof(int16_t)) {
+            diff = *reinterpret_cast<const int16_t *>(&first[i]) - *reinterpret_cast<const int16_t *>(&second[i]);
+        } else {
+            diff = static_cast<int64_t>(*reinterpret_cast<const int32_t *>(&first[i])) -
+                *reinterpret_cast<const int32_t *>(&second[i]);
+        }
+        maxDiff = std::max(maxDiff, std::abs(diff));
+    }
+    return maxDiff;
+}
+} // namespace
+
+class AudioSampleConverterUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp(void) {};
+    void TearDown(void) {};
+};
+
+/**
+ * @tc.name: AudioSampleConverter_001
+ * @tc.desc: every vectorized conversion matches libswresample, float to integer within the last bit
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioSampleConverterUnitTest, AudioSampleConverter_001, TestSize.Level1)
+{
+    std::mt19937 rng(RANDOM_SEED);
+    const int32_t channelCounts[] = { 1, 2, 6 };
+    const int32_t sampleCounts[] = { 1, 7, FRAME_SAMPLES, FRAME_SAMPLES * 3 + 5 }; // 7 3 5: odd sized tails
+    for (const auto &pair : TOP_PAIRS) {
+        for (int32_t channels : channelCounts) {
+            AVChannelLayout layout {};
+            av_channel_layout_default(&layout, channels);
+            AudioSampleConverter converter;
+            ASSERT_EQ(converter.Init(pair.srcFmt, pair.destFmt, layout, SAMPLE_RATE), Status::OK);
+            EXPECT_TRUE(converter.IsAccelerated());
+            SwrContext *swrCtx = CreateSwrContext(pair.srcFmt, pair.destFmt, layout);
+            ASSERT_NE(swrCtx, nullptr);
+            for (int32_t samples : sampleCounts) {
+                SampleFrame frame(pair.srcFmt, channels, samples, rng);
+                std::vector<uint8_t> expected;
+                ASSERT_EQ(SwrConvert(swrCtx, frame, samples, pair.destFmt, channels, expected), samples);
+                std::vector<uint8_t> dest(converter.GetDestSize(samples));
+                size_t destLength = 0;
+                ASSERT_EQ(converter.Convert(frame.Planes(), samples, dest.data(), dest.size(), destLength),
+                    Status::OK);
+                EXPECT_EQ(destLength, expected.size());
+                int64_t tolerance = IsFloat(pair.srcFmt) && !IsFloat(pair.destFmt) ? 1 : 0;
+                EXPECT_LE(MaxDiff(pair.destFmt, dest, expected), tolerance) << av_get_sample_fmt_name(pair.srcFmt)
+                    << " to " << av_get_sample_fmt_name(pair.destFmt) << ", " << channels << " channels, "
+                    << samples << " samples";
+            }
+            swr_free(&swrCtx);
+            av_channel_layout_uninit(&layout);
+        }
+    }
+}
+
+/**
+ * @tc.name: AudioSampleConverter_002
+ * @tc.desc: other conversions go through libswresample, short buffers are refused, the own buffer is kept
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioSampleConverterUnitTest, AudioSampleConverter_002, TestSize.Level1)
+{
+    std::mt19937 rng(RANDOM_SEED);
+    AVChannelLayout layout {};
+    av_channel_layout_default(&layout, BENCH_CHANNELS);
+    AudioSampleConverter converter;
+    ASSERT_EQ(converter.Init(AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_U8, layout, SAMPLE_RATE), Status::OK);
+    EXPECT_FALSE(converter.IsAccelerated());
+    SampleFrame frame(AV_SAMPLE_FMT_S16, BENCH_CHANNELS, FRAME_SAMPLES, rng);
+    SwrContext *swrCtx = CreateSwrContext(AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_U8, layout);
+    ASSERT_NE(swrCtx, nullptr);
+    std::vector<uint8_t> expected;
+    ASSERT_EQ(SwrConvert(swrCtx, frame, FRAME_SAMPLES, AV_SAMPLE_FMT_U8, BENCH_CHANNELS, expected), FRAME_SAMPLES);
+    swr_free(&swrCtx);
+
+    uint8_t *dest = nullptr;
+    size_t destLength = 0;
+    ASSERT_EQ(converter.Convert(frame.Planes(), FRAME_SAMPLES, dest, destLength), Status::OK);
+    ASSERT_EQ(destLength, expected.size());
+    EXPECT_EQ(std::vector<uint8_t>(dest, dest + destLength), expected);
+    uint8_t *again = nullptr;
+    ASSERT_EQ(converter.Convert(frame.Planes(), FRAME_SAMPLES, again, destLength), Status::OK);
+    EXPECT_EQ(again, dest);
+
+    std::vector<uint8_t> shortBuffer(expected.size() - 1);
+    EXPECT_EQ(converter.Convert(frame.Planes(), FRAME_SAMPLES, shortBuffer.data(), shortBuffer.size(), destLength),
+        Status::ERROR_NO_MEMORY);
+    EXPECT_EQ(destLength, 0U);
+
+    converter.Release();
+    EXPECT_EQ(converter.Convert(frame.Planes(), FRAME_SAMPLES, dest, destLength), Status::ERROR_INVALID_OPERATION);
+    av_channel_layout_uninit(&layout);
+}
+
+/**
+ * @tc.name: AudioSampleConverter_003
+ * @tc.desc: a frame of another sample format switches the conversion, another channel count or rate is refused
+ * @tc.type: FUNC
+ */
+HWTEST_F(AudioSampleConverterUnitTest, AudioSampleConverter_003, TestSize.Level1)
+{
+    AVChannelLayout layout {};
+    av_channel_layout_default(&layout, BENCH_CHANNELS);
+    AudioSampleConverter converter;
+    ASSERT_EQ(converter.Init(AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_S16, layout, SAMPLE_RATE), Status::OK);
+    AVFrame *frame = av_frame_alloc();
+    ASSERT_NE(frame, nullptr);
+    frame->format = AV_SAMPLE_FMT_S32P;
+    frame->sample_rate = SAMPLE_RATE;
+    frame->nb_samples = FRAME_SAMPLES;
+    ASSERT_EQ(av_channel_layout_copy(&frame->ch_layout, &layout), 0);
+    ASSERT_EQ(av_frame_get_buffer(frame, 0), 0);
+    for (int32_t i = 0; i < BENCH_CHANNELS; i++) {
+        int32_t *samples = reinterpret_cast<int32_t *>(frame->extended_data[i]);
+        std::fill_n(samples, FRAME_SAMPLES, 0x12340000 + i); // 0x12340000: 0x1234 once shifted to 16 bits
+    }
+    std::vector<uint8_t> dest(converter.GetDestSize(FRAME_SAMPLES));
+    size_t destLength = 0;
+    ASSERT_EQ(converter.Convert(frame, dest.data(), dest.size(), destLength), Status::OK);
+    ASSERT_EQ(destLength, dest.size());
+    const int16_t *converted = reinterpret_cast<const int16_t *>(dest.data());
+    EXPECT_EQ(converted[0], 0x1234);
+    EXPECT_EQ(converted[1], 0x1234);
+
+    frame->sample_rate = SAMPLE_RATE * 2; // 2: any other rate
+    EXPECT_EQ(converter.Convert(frame, dest.data(), dest.size(), destLength), Status::ERROR_INVALID_DATA);
+    frame->sample_rate = SAMPLE_RATE;
+    av_channel_layout_uninit(&frame->ch_layout);
+    av_channel_layout_default(&frame->ch_layout, 1);
+    EXPECT_EQ(converter.Convert(frame, dest.data(), dest.size(), destLength), Status::ERROR_INVALID_DATA);
+    EXPECT_EQ(destLength, 0U);
+    av_frame_free(&frame);
+    av_channel_layout_uninit(&layout);
+}
+
+/**
+ * @tc.name: AudioSampleConverter_Perf_001
+ * @tc.desc: throughput of the ten most used conversions, vectorized kernels against libswresample
+ * @tc.type: PERF
+ */
+HWTEST_F(AudioSampleConverterUnitTest, AudioSampleConverter_Perf_001, TestSize.Level3)
+{
+    std::mt19937 rng(RANDOM_SEED);
+    AVChannelLayout layout {};
+    av_channel_layout_default(&layout, BENCH_CHANNELS);
+    auto measure = [](const auto &convert) {
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < BENCH_FRAMES; i++) {
+            convert();
+        }
+        std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(BENCH_FRAMES) * FRAME_SAMPLES * BENCH_CHANNELS / cost.count();
+    };
+    for (const auto &pair : TOP_PAIRS) {
+        SampleFrame frame(pair.srcFmt, BENCH_CHANNELS, FRAME_SAMPLES, rng);
+        AudioSampleConverter converter;
+        ASSERT_EQ(converter.Init(pair.srcFmt, pair.destFmt, layout, SAMPLE_RATE), Status::OK);
+        std::vector<uint8_t> dest(converter.GetDestSize(FRAME_SAMPLES));
+        size_t destLength = 0;
+        double kernelRate = measure([&]() {
+            converter.Convert(frame.Planes(), FRAME_SAMPLES, dest.data(), dest.size(), destLength);
+        });
+        SwrContext *swrCtx = CreateSwrContext(pair.srcFmt, pair.destFmt, layout);
+        ASSERT_NE(swrCtx, nullptr);
+        std::vector<uint8_t> expected;
+        double swrRate = measure([&]() {
+            SwrConvert(swrCtx, frame, FRAME_SAMPLES, pair.destFmt, BENCH_CHANNELS, expected);
+        });
+        swr_free(&swrCtx);
+        std::cout << av_get_sample_fmt_name(pair.srcFmt) << " to " << av_get_sample_fmt_name(pair.destFmt)
+                  << ", kernel: " << kernelRate << " samples/s, swr: " << swrRate << " samples/s" << std::endl;
+        EXPECT_EQ(destLength, expected.size());
+    }
+    av_channel_layout_uninit(&layout);
+}
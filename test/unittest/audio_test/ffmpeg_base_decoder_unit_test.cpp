@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <gtest/gtest.h>
+#include "avcodec_common.h"
+#include "buffer/avbuffer.h"
+#include "ffmpeg_base_decoder.h"
+#include "media_description.h"
+#include "meta/meta.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+using namespace OHOS::Media::Plugins;
+using namespace OHOS::Media::Plugins::Ffmpeg;
+
+namespace {
+constexpr int32_t SAMPLE_RATE = 44100;
+constexpr int32_t CHANNELS = 2;
+constexpr int32_t BUFFER_CAPACITY = 65536;
+constexpr int32_t BUFFER_COUNT = 4;
+constexpr int32_t PACKED_DURATION_MS = 300; // three 4608 sample flac frames
+constexpr int32_t STREAM_SECONDS = 10;
+constexpr int32_t BENCH_SECONDS = 600;
+constexpr int32_t BENCH_ROUNDS = 2;
+constexpr double TONE_HZ = 440.0;
+constexpr double AMPLITUDE = 20000.0;
+
+struct EncodedStream {
+    std::vector<uint8_t> extradata;
+    std::vector<std::vector<uint8_t>> packets;
+    std::vector<int64_t> pts;
+};
+
+std::vector<int16_t> CreateTone(int32_t seconds)
+{
+    std::vector<int16_t> pcm(static_cast<size_t>(SAMPLE_RATE) * seconds * CHANNELS);
+    for (size_t i = 0; i < pcm.size() / CHANNELS; i++) {
+        double value = AMPLITUDE * std::sin(2.0 * M_PI * TONE_HZ * i / SAMPLE_RATE);
+        pcm[i * CHANNELS] = static_cast<int16_t>(value);
+        pcm[i * CHANNELS + 1] = static_cast<int16_t>(-value);
+    }
+    return pcm;
+}
+
+void DrainEncoder(AVCodecContext *context, AVPacket *packet, EncodedStream &stream)
+{
+    while (avcodec_receive_packet(context, packet) == 0) {
+        stream.packets.emplace_back(packet->data, packet->data + packet->size);
+        stream.pts.push_back(av_rescale_q(packet->pts, context->time_base, AVRational{1, 1000000}));
+        av_packet_unref(packet);
+    }
+}
+
+// flac keeps the samples bit exact, so every decode of the stream has to give back the tone
+EncodedStream EncodeFlac(const std::vector<int16_t> &pcm)
+{
+    EncodedStream stream;
+    const AVCodec *codec = avcodec_find_encoder_by_name("flac");
+    AVCodecContext *context = avcodec_alloc_context3(codec);
+    context->sample_fmt = AV_SAMPLE_FMT_S16;
+    context->sample_rate = SAMPLE_RATE;
+    av_channel_layout_default(&context->ch_layout, CHANNELS);
+    context->time_base = AVRational{1, SAMPLE_RATE};
+    if (avcodec_open2(context, codec, nullptr) != 0) {
+        avcodec_free_context(&context);
+        return stream;
+    }
+    stream.extradata.assign(context->extradata, context->extradata + context->extradata_size);
+    AVFrame *frame = av_frame_alloc();
+    AVPacket *packet = av_packet_alloc();
+    int32_t total = static_cast<int32_t>(pcm.size() / CHANNELS);
+    for (int32_t offset = 0; offset < total; offset += context->frame_size) {
+        frame->nb_samples = std::min(context->frame_size, total - offset);
+        frame->format = context->sample_fmt;
+        av_channel_layout_copy(&frame->ch_layout, &context->ch_layout);
+        av_frame_get_buffer(frame, 0);
+        std::copy_n(pcm.data() + static_cast<size_t>(offset) * CHANNELS, frame->nb_samples * CHANNELS,
+            reinterpret_cast<int16_t *>(frame->data[0]));
+        frame->pts = offset;
+        avcodec_send_frame(context, frame);
+        av_frame_unref(frame);
+        DrainEncoder(context, packet, stream);
+    }
+    avcodec_send_frame(context, nullptr);
+    DrainEncoder(context, packet, stream);
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&context);
+    return stream;
+}
+
+// plays the part of MediaCodec: a small output pool, each input followed by output requests until the plugin stops
+class DecodeDriver : public DataCallback {
+public:
+    explicit DecodeDriver(int32_t maxOutputDurationMs)
+    {
+        auto allocator = AVAllocatorFactory::CreateSharedAllocator(MemoryFlag::MEMORY_READ_WRITE);
+        for (int32_t i = 0; i < BUFFER_COUNT; i++) {
+            freeBuffers_.push_back(AVBuffer::CreateAVBuffer(allocator, BUFFER_CAPACITY));
+        }
+        inputBuffer_ = AVBuffer::CreateAVBuffer(allocator, BUFFER_CAPACITY);
+        maxOutputDurationMs_ = maxOutputDurationMs;
+    }
+
+    bool Open(const EncodedStream &stream)
+    {
+        auto format = std::make_shared<Meta>();
+        format->Set<Tag::AUDIO_CHANNEL_COUNT>(CHANNELS);
+        format->Set<Tag::AUDIO_SAMPLE_RATE>(SAMPLE_RATE);
+        format->Set<Tag::AUDIO_SAMPLE_FORMAT>(AudioSampleFormat::SAMPLE_S16LE);
+        format->Set<Tag::MEDIA_CODEC_CONFIG>(stream.extradata);
+        format->SetData(std::string(MediaAVCodec::MediaDescriptionKey::MD_KEY_AUDIO_MAX_OUTPUT_DURATION),
+            maxOutputDurationMs_);
+        decoder_.SetCallback(this);
+        return decoder_.AllocateContext("flac") == Status::OK && decoder_.CheckSampleFormat(format, CHANNELS) &&
+            decoder_.InitContext(format) == Status::OK && decoder_.OpenContext() == Status::OK;
+    }
+
+    void Decode(const EncodedStream &stream, size_t count)
+    {
+        for (size_t i = 0; i < count && i < stream.packets.size(); i++) {
+            inputBuffer_->memory_->Write(stream.packets[i].data(), stream.packets[i].size(), 0);
+            inputBuffer_->pts_ = stream.pts[i];
+            inputBuffer_->flag_ = 0;
+            Process();
+        }
+    }
+
+    void DecodeEos()
+    {
+        inputBuffer_->memory_->SetSize(0);
+        inputBuffer_->flag_ = MediaAVCodec::AVCODEC_BUFFER_FLAG_EOS;
+        Process();
+    }
+
+    void Flush()
+    {
+        decoder_.Flush();
+        pcm_.clear();
+        outputPts_.clear();
+    }
+
+    void Reset()
+    {
+        decoder_.Reset();
+    }
+
+    size_t GetFreeCount() const
+    {
+        return freeBuffers_.size();
+    }
+
+    int32_t GetKeptCount() const
+    {
+        return keptCount_;
+    }
+
+    void OnInputBufferDone(const std::shared_ptr<AVBuffer> &inputBuffer) override
+    {
+        (void)inputBuffer;
+    }
+
+    void OnOutputBufferDone(const std::shared_ptr<AVBuffer> &outputBuffer) override
+    {
+        if (outputBuffer->flag_ == MediaAVCodec::AVCODEC_BUFFER_FLAG_EOS) {
+            eos_ = true;
+        } else {
+            auto memory = outputBuffer->memory_;
+            auto samples = reinterpret_cast<const int16_t *>(memory->GetAddr());
+            pcm_.insert(pcm_.end(), samples, samples + memory->GetSize() / sizeof(int16_t));
+            outputPts_.push_back(outputBuffer->pts_);
+        }
+        freeBuffers_.push_back(outputBuffer);
+    }
+
+    void OnEvent(const std::shared_ptr<Plugins::PluginEvent> event) override
+    {
+        (void)event;
+    }
+
+    const std::vector<int16_t> &GetPcm() const
+    {
+        return pcm_;
+    }
+
+    const std::vector<int64_t> &GetOutputPts() const
+    {
+        return outputPts_;
+    }
+
+    bool IsEos() const
+    {
+        return eos_;
+    }
+
+private:
+    void Process()
+    {
+        ASSERT_EQ(decoder_.ProcessSendData(inputBuffer_), Status::OK);
+        Status ret = Status::ERROR_AGAIN;
+        while (ret == Status::ERROR_AGAIN) {
+            ASSERT_FALSE(freeBuffers_.empty());
+            std::shared_ptr<AVBuffer> outputBuffer = freeBuffers_.back();
+            freeBuffers_.pop_back();
+            outputBuffer->flag_ = inputBuffer_->flag_;
+            ret = decoder_.ProcessReceiveData(outputBuffer);
+            if (ret == Status::OK) {
+                keptCount_++;
+            } else if (ret != Status::ERROR_AGAIN && ret != Status::END_OF_STREAM) {
+                freeBuffers_.push_back(outputBuffer);
+            }
+        }
+    }
+
+    FfmpegBaseDecoder decoder_;
+    std::vector<std::shared_ptr<AVBuffer>> freeBuffers_;
+    std::shared_ptr<AVBuffer> inputBuffer_;
+    int32_t maxOutputDurationMs_{0};
+    std::vector<int16_t> pcm_;
+    std::vector<int64_t> outputPts_;
+    bool eos_{false};
+    int32_t keptCount_{0};
+};
+} // namespace
+
+class FfmpegBaseDecoderUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp(void) {};
+    void TearDown(void) {};
+};
+
+/**
+ * @tc.name: FfmpegBaseDecoder_001
+ * @tc.desc: packing frames into one output buffer gives the same samples as one frame per buffer, in fewer buffers
+ * @tc.type: FUNC
+ */
+HWTEST_F(FfmpegBaseDecoderUnitTest, FfmpegBaseDecoder_001, TestSize.Level1)
+{
+    std::vector<int16_t> tone = CreateTone(STREAM_SECONDS);
+    EncodedStream stream = EncodeFlac(tone);
+    ASSERT_FALSE(stream.packets.empty());
+    DecodeDriver single(0);
+    DecodeDriver packed(PACKED_DURATION_MS);
+    ASSERT_TRUE(single.Open(stream));
+    ASSERT_TRUE(packed.Open(stream));
+    for (DecodeDriver *driver : {&single, &packed}) {
+        driver->Decode(stream, stream.packets.size());
+        driver->DecodeEos();
+        EXPECT_TRUE(driver->IsEos());
+        EXPECT_EQ(driver->GetPcm(), tone);
+        EXPECT_EQ(driver->GetOutputPts().front(), 0);
+        EXPECT_TRUE(std::is_sorted(driver->GetOutputPts().begin(), driver->GetOutputPts().end()));
+    }
+    EXPECT_EQ(single.GetOutputPts().size(), stream.packets.size());
+    EXPECT_LT(packed.GetOutputPts().size(), single.GetOutputPts().size());
+}
+
+/**
+ * @tc.name: FfmpegBaseDecoder_002
+ * @tc.desc: flush drops the samples collected so far, the stream decodes again from the start
+ * @tc.type: FUNC
+ */
+HWTEST_F(FfmpegBaseDecoderUnitTest, FfmpegBaseDecoder_002, TestSize.Level1)
+{
+    std::vector<int16_t> tone = CreateTone(STREAM_SECONDS);
+    EncodedStream stream = EncodeFlac(tone);
+    ASSERT_FALSE(stream.packets.empty());
+    const size_t halfStream = stream.packets.size() / 2;
+    DecodeDriver driver(PACKED_DURATION_MS);
+    ASSERT_TRUE(driver.Open(stream));
+    driver.Decode(stream, halfStream);
+    EXPECT_FALSE(driver.GetPcm().empty());
+    driver.Flush();
+    driver.Decode(stream, stream.packets.size());
+    driver.DecodeEos();
+    EXPECT_TRUE(driver.IsEos());
+    EXPECT_EQ(driver.GetPcm(), tone);
+}
+
+/**
+ * @tc.name: FfmpegBaseDecoder_003
+ * @tc.desc: one frame per buffer keeps no output buffer between calls, reset hands a packed buffer back
+ * @tc.type: FUNC
+ */
+HWTEST_F(FfmpegBaseDecoderUnitTest, FfmpegBaseDecoder_003, TestSize.Level1)
+{
+    std::vector<int16_t> tone = CreateTone(STREAM_SECONDS);
+    EncodedStream stream = EncodeFlac(tone);
+    ASSERT_FALSE(stream.packets.empty());
+    DecodeDriver single(0);
+    ASSERT_TRUE(single.Open(stream));
+    single.Decode(stream, stream.packets.size());
+    EXPECT_EQ(single.GetKeptCount(), 0);
+    EXPECT_EQ(single.GetFreeCount(), static_cast<size_t>(BUFFER_COUNT));
+    DecodeDriver packed(PACKED_DURATION_MS);
+    ASSERT_TRUE(packed.Open(stream));
+    packed.Decode(stream, 1);
+    EXPECT_EQ(packed.GetFreeCount(), static_cast<size_t>(BUFFER_COUNT - 1));
+    packed.Reset();
+    EXPECT_EQ(packed.GetFreeCount(), static_cast<size_t>(BUFFER_COUNT));
+}
+
+/**
+ * @tc.name: FfmpegBaseDecoder_004
+ * @tc.desc: packing keeps one output buffer between inputs for the next frames to decode into, the end of stream
+ *           hands it back
+ * @tc.type: FUNC
+ */
+HWTEST_F(FfmpegBaseDecoderUnitTest, FfmpegBaseDecoder_004, TestSize.Level1)
+{
+    std::vector<int16_t> tone = CreateTone(STREAM_SECONDS);
+    EncodedStream stream = EncodeFlac(tone);
+    ASSERT_FALSE(stream.packets.empty());
+    DecodeDriver packed(PACKED_DURATION_MS);
+    ASSERT_TRUE(packed.Open(stream));
+    packed.Decode(stream, stream.packets.size());
+    EXPECT_EQ(packed.GetFreeCount(), static_cast<size_t>(BUFFER_COUNT - 1));
+    packed.DecodeEos();
+    EXPECT_TRUE(packed.IsEos());
+    EXPECT_EQ(packed.GetFreeCount(), static_cast<size_t>(BUFFER_COUNT));
+}
+
+/**
+ * @tc.name: FfmpegBaseDecoder_Perf_001
+ * @tc.desc: decode time and output callbacks of ten minutes of flac, one frame per buffer against packed buffers
+ * @tc.type: PERF
+ */
+HWTEST_F(FfmpegBaseDecoderUnitTest, FfmpegBaseDecoder_Perf_001, TestSize.Level3)
+{
+    std::vector<int16_t> tone = CreateTone(BENCH_SECONDS);
+    EncodedStream stream = EncodeFlac(tone);
+    ASSERT_FALSE(stream.packets.empty());
+    for (int32_t durationMs : {0, PACKED_DURATION_MS}) {
+        std::chrono::duration<double> cost{0};
+        size_t outputs = 0;
+        for (int32_t round = 0; round < BENCH_ROUNDS; round++) {
+            DecodeDriver driver(durationMs);
+            ASSERT_TRUE(driver.Open(stream));
+            auto start = std::chrono::steady_clock::now();
+            driver.Decode(stream, stream.packets.size());
+            driver.DecodeEos();
+            cost += std::chrono::steady_clock::now() - start;
+            ASSERT_EQ(driver.GetPcm().size(), tone.size());
+            outputs = driver.GetOutputPts().size();
+        }
+        std::cout << "max output duration " << durationMs << " ms: " << outputs << " output buffers, "
+                  << BENCH_SECONDS * BENCH_ROUNDS / cost.count() << "x realtime" << std::endl;
+    }
+}
@@ -0,0 +1,614 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hdi_codec.h"
+#include "OMX_Component.h"
+
+using namespace testing::ext;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace OHOS::Media::Plugins::Hdi;
+
+namespace {
+const std::string COMPONENT_NAME = "OMX.audio.decoder.lbvc";
+constexpr uint32_t FRAME_SIZE = 640;
+constexpr int64_t FRAME_DURATION_US = 20000;
+constexpr uint32_t PIPELINE_DEPTH = 4;
+constexpr int64_t COMPONENT_LATENCY_US = 2000;
+constexpr int64_t SLOW_COMPONENT_LATENCY_US = 20000;
+constexpr uint32_t BENCH_FRAMES = 200;
+constexpr int32_t WAIT_TIMEOUT_MS = 1000;
+constexpr uint32_t PORT_INPUT_BUFFER_COUNT = 3;
+constexpr uint32_t PORT_OUTPUT_BUFFER_COUNT = 2;
+
+uint8_t FramePattern(int64_t pts)
+{
+    return static_cast<uint8_t>(pts / FRAME_DURATION_US);
+}
+
+/**
+ * A passthrough component, every input is copied into the next free output once the latency passed. Buffers are
+ * completed from a worker thread like the HDI callback thread, several of them may be in flight at a time. A flush
+ * returns every queued buffer empty. With port buffer counts set it reports them in its port definitions.
+ */
+class MockCodecComponent : public ICodecComponent {
+public:
+    MockCodecComponent(const sptr<ICodecCallback> &callback, int64_t latencyUs, bool hasPortBufferCounts)
+        : callback_(callback), latencyUs_(latencyUs), hasPortBufferCounts_(hasPortBufferCounts),
+          worker_([this] { Work(); })
+    {
+    }
+
+    ~MockCodecComponent() override
+    {
+        {
+            std::lock_guard lock(mutex_);
+            isRunning_ = false;
+            cond_.notify_all();
+        }
+        worker_.join();
+    }
+
+    // the test maps the registered shared memory itself, keyed by the fd the codec hands to UseBuffer
+    void AddMemory(const std::shared_ptr<AVBuffer> &buffer)
+    {
+        std::lock_guard lock(mutex_);
+        memories_[buffer->memory_->GetFileDescriptor()] = buffer;
+    }
+
+    uint32_t MaxInputsInFlight()
+    {
+        std::lock_guard lock(mutex_);
+        return maxInputsInFlight_;
+    }
+
+    int32_t GetComponentVersion(CompVerInfo &verInfo) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    uint32_t FilledOutputs()
+    {
+        std::lock_guard lock(mutex_);
+        return static_cast<uint32_t>(outputs_.size());
+    }
+
+    int32_t SendCommand(CodecCommandType cmd, uint32_t param, const std::vector<int8_t> &cmdData) override
+    {
+        std::lock_guard lock(mutex_);
+        pendingFlush_ = pendingFlush_ || cmd == CODEC_COMMAND_FLUSH;
+        pendingEvents_++;
+        cond_.notify_all();
+        return HDF_SUCCESS;
+    }
+
+    int32_t GetParameter(uint32_t index, const std::vector<int8_t> &inParamStruct,
+        std::vector<int8_t> &outParamStruct) override
+    {
+        outParamStruct = inParamStruct;
+        if (index == OMX_IndexParamPortDefinition && hasPortBufferCounts_ &&
+            inParamStruct.size() == sizeof(OMX_PARAM_PORTDEFINITIONTYPE)) {
+            auto def = reinterpret_cast<OMX_PARAM_PORTDEFINITIONTYPE *>(outParamStruct.data());
+            def->nBufferCountActual = def->nPortIndex == static_cast<uint32_t>(HdiCodec::PortIndex::INPUT_PORT) ?
+                PORT_INPUT_BUFFER_COUNT : PORT_OUTPUT_BUFFER_COUNT;
+        }
+        return HDF_SUCCESS;
+    }
+
+    int32_t SetParameter(uint32_t index, const std::vector<int8_t> &paramStruct) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t GetConfig(uint32_t index, const std::vector<int8_t> &inCfgStruct,
+        std::vector<int8_t> &outCfgStruct) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t SetConfig(uint32_t index, const std::vector<int8_t> &cfgStruct) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t GetExtensionIndex(const std::string &paramName, uint32_t &indexType) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t GetState(CodecStateType &state) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t ComponentTunnelRequest(uint32_t port, int32_t tunneledComp, uint32_t tunneledPort,
+        const CodecTunnelSetupType &inTunnelSetup, CodecTunnelSetupType &outTunnelSetup) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t UseBuffer(uint32_t portIndex, const OmxCodecBuffer &inBuffer, OmxCodecBuffer &outBuffer) override
+    {
+        std::lock_guard lock(mutex_);
+        outBuffer = inBuffer;
+        outBuffer.bufferId = nextBufferId_++;
+        fds_[outBuffer.bufferId] = inBuffer.fd;
+        return HDF_SUCCESS;
+    }
+
+    int32_t AllocateBuffer(uint32_t portIndex, const OmxCodecBuffer &inBuffer, OmxCodecBuffer &outBuffer) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t FreeBuffer(uint32_t portIndex, const OmxCodecBuffer &buffer) override
+    {
+        std::lock_guard lock(mutex_);
+        fds_.erase(buffer.bufferId);
+        return HDF_SUCCESS;
+    }
+
+    int32_t EmptyThisBuffer(const OmxCodecBuffer &buffer) override
+    {
+        std::lock_guard lock(mutex_);
+        inputs_.push_back({buffer, std::chrono::steady_clock::now()});
+        inputsInFlight_++;
+        maxInputsInFlight_ = std::max(maxInputsInFlight_, inputsInFlight_);
+        cond_.notify_all();
+        return HDF_SUCCESS;
+    }
+
+    int32_t FillThisBuffer(const OmxCodecBuffer &buffer) override
+    {
+        std::lock_guard lock(mutex_);
+        outputs_.push_back({buffer, std::chrono::steady_clock::now()});
+        cond_.notify_all();
+        return HDF_SUCCESS;
+    }
+
+    int32_t SetCallbacks(const sptr<ICodecCallback> &callbacks, int64_t appData) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t ComponentDeInit() override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t UseEglImage(uint32_t portIndex, const OmxCodecBuffer &inBuffer, OmxCodecBuffer &outBuffer,
+        const std::vector<int8_t> &eglImage) override
+    {
+        return HDF_SUCCESS;
+    }
+
+    int32_t ComponentRoleEnum(std::vector<uint8_t> &role, uint32_t index) override
+    {
+        return HDF_SUCCESS;
+    }
+
+private:
+    struct Request {
+        OmxCodecBuffer buffer;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    void Work()
+    {
+        std::unique_lock lock(mutex_);
+        while (isRunning_) {
+            if (pendingFlush_) {
+                pendingFlush_ = false;
+                ReturnAll(lock);
+                continue;
+            }
+            if (pendingEvents_ > 0) {
+                pendingEvents_--;
+                lock.unlock();
+                callback_->EventHandler(CODEC_EVENT_CMD_COMPLETE, {});
+                lock.lock();
+                continue;
+            }
+            if (inputs_.empty() || outputs_.empty()) {
+                cond_.wait(lock);
+                continue;
+            }
+            Request input = inputs_.front();
+            Request output = outputs_.front();
+            inputs_.pop_front();
+            outputs_.pop_front();
+            auto ready = std::max(input.time, output.time) + std::chrono::microseconds(latencyUs_);
+            lock.unlock();
+            std::this_thread::sleep_until(ready);
+            lock.lock();
+            Process(input.buffer, output.buffer);
+            inputsInFlight_--;
+            lock.unlock();
+            callback_->EmptyBufferDone(0, input.buffer);
+            callback_->FillBufferDone(0, output.buffer);
+            lock.lock();
+        }
+    }
+
+    void ReturnAll(std::unique_lock<std::mutex> &lock)
+    {
+        std::deque<Request> inputs;
+        std::deque<Request> outputs;
+        inputs.swap(inputs_);
+        outputs.swap(outputs_);
+        inputsInFlight_ = 0;
+        lock.unlock();
+        for (auto &input : inputs) {
+            callback_->EmptyBufferDone(0, input.buffer);
+        }
+        for (auto &output : outputs) {
+            output.buffer.filledLen = 0;
+            callback_->FillBufferDone(0, output.buffer);
+        }
+        lock.lock();
+    }
+
+    void Process(const OmxCodecBuffer &input, OmxCodecBuffer &output)
+    {
+        std::shared_ptr<AVBuffer> from = memories_[fds_[input.bufferId]];
+        std::shared_ptr<AVBuffer> to = memories_[fds_[output.bufferId]];
+        if (from != nullptr && to != nullptr) {
+            std::copy_n(from->memory_->GetAddr() + input.offset, input.filledLen, to->memory_->GetAddr());
+        }
+        output.filledLen = input.filledLen;
+        output.offset = 0;
+        output.pts = input.pts;
+        output.flag = input.flag;
+    }
+
+    sptr<ICodecCallback> callback_;
+    int64_t latencyUs_;
+    bool hasPortBufferCounts_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool isRunning_ = true;
+    bool pendingFlush_ = false;
+    uint32_t pendingEvents_ = 0;
+    uint32_t nextBufferId_ = 1;
+    uint32_t inputsInFlight_ = 0;
+    uint32_t maxInputsInFlight_ = 0;
+    std::map<uint32_t, int32_t> fds_;
+    std::map<int32_t, std::shared_ptr<AVBuffer>> memories_;
+    std::deque<Request> inputs_;
+    std::deque<Request> outputs_;
+    std::thread worker_;
+};
+
+class MockComponentManager : public ICodecComponentManager {
+public:
+    MockComponentManager(int64_t latencyUs, bool hasPortBufferCounts)
+        : latencyUs_(latencyUs), hasPortBufferCounts_(hasPortBufferCounts)
+    {
+    }
+
+    int32_t GetComponentNum(int32_t &count) override
+    {
+        count = 1;
+        return HDF_SUCCESS;
+    }
+
+    int32_t GetComponentCapabilityList(std::vector<CodecCompCapability> &capList, int32_t count) override
+    {
+        CodecCompCapability capability;
+        capability.compName = COMPONENT_NAME;
+        capList.push_back(capability);
+        return HDF_SUCCESS;
+    }
+
+    int32_t CreateComponent(sptr<ICodecComponent> &component, uint32_t &componentId, const std::string &compName,
+        int64_t appData, const sptr<ICodecCallback> &callbacks) override
+    {
+        component_ = new MockCodecComponent(callbacks, latencyUs_, hasPortBufferCounts_);
+        component = component_;
+        componentId = 1;
+        return HDF_SUCCESS;
+    }
+
+    int32_t DestroyComponent(uint32_t componentId) override
+    {
+        component_ = nullptr;
+        return HDF_SUCCESS;
+    }
+
+    sptr<MockCodecComponent> component_;
+
+private:
+    int64_t latencyUs_;
+    bool hasPortBufferCounts_;
+};
+
+// drives the codec the way MediaCodec does, refilling every buffer as soon as it is handed back
+class CodecDriver {
+public:
+    explicit CodecDriver(const std::shared_ptr<HdiCodec> &codec) : codec_(codec)
+    {
+        codec_->SetBufferDoneCallback([this](HdiCodec::PortIndex portIndex, const std::shared_ptr<AVBuffer> &buffer) {
+            std::lock_guard lock(mutex_);
+            if (portIndex == HdiCodec::PortIndex::INPUT_PORT) {
+                freeInputs_.push_back(buffer);
+            } else {
+                doneOutputs_.push_back(buffer);
+            }
+            cond_.notify_all();
+        });
+    }
+
+    ~CodecDriver()
+    {
+        codec_->SetBufferDoneCallback(nullptr);
+    }
+
+    // returns the pts of the frames in output order, empty when the codec stalled
+    std::vector<int64_t> Run(uint32_t frames, std::vector<std::shared_ptr<AVBuffer>> inputs,
+        std::vector<std::shared_ptr<AVBuffer>> outputs)
+    {
+        for (auto &output : outputs) {
+            if (codec_->FillThisBuffer(output) != Status::OK) {
+                return {};
+            }
+        }
+        freeInputs_.assign(inputs.begin(), inputs.end());
+        std::vector<int64_t> received;
+        bool drained = false;
+        // inputs and outputs run on their own threads like in MediaCodec, copying into a busy port blocks
+        std::thread outputThread([this, frames, &received, &drained] { drained = DrainOutputs(frames, received); });
+        bool fed = FeedInputs(frames);
+        outputThread.join();
+        return fed && drained ? received : std::vector<int64_t>();
+    }
+
+    std::vector<std::shared_ptr<AVBuffer>> outputBuffers_;
+
+private:
+    bool FeedInputs(uint32_t frames)
+    {
+        for (uint32_t sent = 0; sent < frames; sent++) {
+            std::unique_lock lock(mutex_);
+            if (!cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS),
+                [this] { return !freeInputs_.empty(); })) {
+                return false;
+            }
+            std::shared_ptr<AVBuffer> input = freeInputs_.front();
+            freeInputs_.pop_front();
+            lock.unlock();
+            int64_t pts = static_cast<int64_t>(sent) * FRAME_DURATION_US;
+            std::fill_n(input->memory_->GetAddr(), FRAME_SIZE, FramePattern(pts));
+            input->memory_->SetSize(FRAME_SIZE);
+            input->pts_ = pts;
+            input->flag_ = 0;
+            if (codec_->EmptyThisBuffer(input) != Status::OK) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool DrainOutputs(uint32_t frames, std::vector<int64_t> &received)
+    {
+        while (received.size() < frames) {
+            std::unique_lock lock(mutex_);
+            if (!cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS),
+                [this] { return !doneOutputs_.empty(); })) {
+                return false;
+            }
+            std::shared_ptr<AVBuffer> output = doneOutputs_.front();
+            doneOutputs_.pop_front();
+            lock.unlock();
+            outputBuffers_.push_back(output);
+            bool match = output->memory_->GetSize() == static_cast<int32_t>(FRAME_SIZE) &&
+                output->memory_->GetAddr()[output->memory_->GetOffset()] == FramePattern(output->pts_);
+            received.push_back(match ? output->pts_ : -1);
+            if (codec_->FillThisBuffer(output) != Status::OK) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::shared_ptr<HdiCodec> codec_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::shared_ptr<AVBuffer>> freeInputs_;
+    std::deque<std::shared_ptr<AVBuffer>> doneOutputs_;
+};
+
+std::shared_ptr<AVBuffer> CreateBuffer()
+{
+    auto allocator = AVAllocatorFactory::CreateSharedAllocator(MemoryFlag::MEMORY_READ_WRITE);
+    return AVBuffer::CreateAVBuffer(allocator, FRAME_SIZE);
+}
+
+std::vector<int64_t> ExpectedPts(uint32_t frames)
+{
+    std::vector<int64_t> pts;
+    for (uint32_t i = 0; i < frames; i++) {
+        pts.push_back(static_cast<int64_t>(i) * FRAME_DURATION_US);
+    }
+    return pts;
+}
+} // namespace
+
+namespace OHOS {
+namespace Media {
+class HdiCodecUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp(void) {};
+    void TearDown(void);
+
+protected:
+    // bufferCount 0 takes the counts of the port definitions
+    bool CreateCodec(int64_t latencyUs, uint32_t bufferCount);
+
+    sptr<MockComponentManager> compMgr_;
+    std::shared_ptr<HdiCodec> codec_;
+    std::vector<std::shared_ptr<AVBuffer>> inputs_;
+    std::vector<std::shared_ptr<AVBuffer>> outputs_;
+};
+
+bool HdiCodecUnitTest::CreateCodec(int64_t latencyUs, uint32_t bufferCount)
+{
+    compMgr_ = new MockComponentManager(latencyUs, bufferCount == 0);
+    codec_ = std::make_shared<HdiCodec>(compMgr_);
+    if (codec_->InitComponent(COMPONENT_NAME) != Status::OK ||
+        codec_->InitBuffers(FRAME_SIZE, bufferCount) != Status::OK) {
+        return false;
+    }
+    inputs_.clear();
+    outputs_.clear();
+    codec_->GetInputBuffers(inputs_);
+    codec_->GetOutputBuffers(outputs_);
+    for (const auto &buffer : inputs_) {
+        compMgr_->component_->AddMemory(buffer);
+    }
+    for (const auto &buffer : outputs_) {
+        compMgr_->component_->AddMemory(buffer);
+    }
+    return codec_->SendCommand(CODEC_COMMAND_STATE_SET, CODEC_STATE_EXECUTING) == Status::OK;
+}
+
+void HdiCodecUnitTest::TearDown(void)
+{
+    if (codec_ != nullptr) {
+        codec_->Release();
+        codec_ = nullptr;
+    }
+    compMgr_ = nullptr;
+}
+
+/**
+ * @tc.name: HdiCodec_001
+ * @tc.desc: registered buffers are handed back themselves, and the component holds several inputs at a time
+ * @tc.type: FUNC
+ */
+HWTEST_F(HdiCodecUnitTest, HdiCodec_001, TestSize.Level1)
+{
+    ASSERT_TRUE(CreateCodec(SLOW_COMPONENT_LATENCY_US, PIPELINE_DEPTH));
+    ASSERT_EQ(inputs_.size(), PIPELINE_DEPTH);
+    ASSERT_EQ(outputs_.size(), PIPELINE_DEPTH);
+    const uint32_t frames = PIPELINE_DEPTH * 4;
+    CodecDriver driver(codec_);
+    EXPECT_EQ(driver.Run(frames, inputs_, outputs_), ExpectedPts(frames));
+    for (const auto &output : driver.outputBuffers_) {
+        EXPECT_NE(std::find(outputs_.begin(), outputs_.end(), output), outputs_.end());
+    }
+    EXPECT_EQ(codec_->WaitForInputDone(), Status::OK);
+    EXPECT_EQ(compMgr_->component_->MaxInputsInFlight(), PIPELINE_DEPTH);
+}
+
+/**
+ * @tc.name: HdiCodec_002
+ * @tc.desc: buffers the component does not know are copied through a free registered one
+ * @tc.type: FUNC
+ */
+HWTEST_F(HdiCodecUnitTest, HdiCodec_002, TestSize.Level1)
+{
+    ASSERT_TRUE(CreateCodec(COMPONENT_LATENCY_US, 1));
+    const uint32_t frames = 8;
+    std::vector<std::shared_ptr<AVBuffer>> inputs = {CreateBuffer()};
+    std::vector<std::shared_ptr<AVBuffer>> outputs = {CreateBuffer()};
+    CodecDriver driver(codec_);
+    EXPECT_EQ(driver.Run(frames, inputs, outputs), ExpectedPts(frames));
+    for (const auto &output : driver.outputBuffers_) {
+        EXPECT_EQ(output, outputs[0]);
+    }
+    EXPECT_EQ(codec_->WaitForInputDone(), Status::OK);
+}
+
+/**
+ * @tc.name: HdiCodec_003
+ * @tc.desc: without a count from the caller every port registers as many buffers as its port definition asks for
+ * @tc.type: FUNC
+ */
+HWTEST_F(HdiCodecUnitTest, HdiCodec_003, TestSize.Level1)
+{
+    ASSERT_TRUE(CreateCodec(COMPONENT_LATENCY_US, 0));
+    EXPECT_EQ(inputs_.size(), PORT_INPUT_BUFFER_COUNT);
+    EXPECT_EQ(outputs_.size(), PORT_OUTPUT_BUFFER_COUNT);
+    const uint32_t frames = 8;
+    CodecDriver driver(codec_);
+    EXPECT_EQ(driver.Run(frames, inputs_, outputs_), ExpectedPts(frames));
+}
+
+/**
+ * @tc.name: HdiCodec_004
+ * @tc.desc: outputs a flush returns empty go back to the component instead of to the caller
+ * @tc.type: FUNC
+ */
+HWTEST_F(HdiCodecUnitTest, HdiCodec_004, TestSize.Level1)
+{
+    ASSERT_TRUE(CreateCodec(COMPONENT_LATENCY_US, PIPELINE_DEPTH));
+    std::mutex mutex;
+    uint32_t doneOutputs = 0;
+    codec_->SetBufferDoneCallback([&mutex, &doneOutputs](HdiCodec::PortIndex portIndex,
+        const std::shared_ptr<AVBuffer> &buffer) {
+        std::lock_guard lock(mutex);
+        doneOutputs += portIndex == HdiCodec::PortIndex::OUTPUT_PORT ? 1 : 0;
+    });
+    for (auto &output : outputs_) {
+        ASSERT_EQ(codec_->FillThisBuffer(output), Status::OK);
+    }
+    ASSERT_EQ(codec_->SendCommand(CODEC_COMMAND_FLUSH, CODEC_STATE_EXECUTING), Status::OK);
+    EXPECT_EQ(compMgr_->component_->FilledOutputs(), PIPELINE_DEPTH);
+    {
+        std::lock_guard lock(mutex);
+        EXPECT_EQ(doneOutputs, 0u);
+    }
+    codec_->SetBufferDoneCallback(nullptr);
+    CodecDriver driver(codec_);
+    const uint32_t frames = 8;
+    EXPECT_EQ(driver.Run(frames, inputs_, {}), ExpectedPts(frames));
+}
+
+/**
+ * @tc.name: HdiCodec_Perf_001
+ * @tc.desc: frames per second through a component with fixed latency, one buffer per port against a pipeline
+ * @tc.type: PERF
+ */
+HWTEST_F(HdiCodecUnitTest, HdiCodec_Perf_001, TestSize.Level3)
+{
+    double fps[2] = {0.0, 0.0};
+    const uint32_t bufferCounts[2] = {1, PIPELINE_DEPTH};
+    for (uint32_t i = 0; i < 2; i++) {
+        ASSERT_TRUE(CreateCodec(COMPONENT_LATENCY_US, bufferCounts[i]));
+        CodecDriver driver(codec_);
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_EQ(driver.Run(BENCH_FRAMES, inputs_, outputs_), ExpectedPts(BENCH_FRAMES));
+        std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+        fps[i] = BENCH_FRAMES / cost.count();
+        TearDown();
+    }
+    std::cout << "one buffer per port: " << fps[0] << " frames/s, " << PIPELINE_DEPTH << " buffers per port: "
+              << fps[1] << " frames/s" << std::endl;
+    EXPECT_GT(fps[1], fps[0] * 2);
+}
+} // namespace Media
+} // namespace OHOS
@@ -15,6 +15,10 @@
 
 #include "avmuxer_unit_test.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <string>
 #include <vector>
 #include <fcntl.h>
@@ -42,6 +46,43 @@ const std::string HEVC_LIB_PATH = std::string(AV_CODEC_PATH) + "/libav_codec_hev
 constexpr uint32_t AVCODEC_BUFFER_FLAGS_DISPOSABLE_EXT_TEST = 1 << 6;
 const std::string TIMED_METADATA_TRACK_MIMETYPE = "meta/timed-metadata";
 const std::string TIMED_METADATA_KEY = "com.openharmony.timed_metadata.test";
+constexpr size_t BOX_HEADER_SIZE = 8;
+constexpr size_t LARGE_BOX_HEADER_SIZE = 16;
+constexpr size_t FULL_BOX_VERSION_FLAGS_SIZE = 4;
+
+uint32_t ReadBe32(const std::vector<uint8_t> &data, size_t pos)
+{
+    return (static_cast<uint32_t>(data[pos]) << 24) | (static_cast<uint32_t>(data[pos + 1]) << 16) | // 24, 16: bytes
+        (static_cast<uint32_t>(data[pos + 2]) << 8) | data[pos + 3]; // 2, 8, 3: the lower two bytes
+}
+
+// calls onBox(type, payload begin, payload end) for every box in [begin, end), false if a box runs past end
+bool WalkBoxes(const std::vector<uint8_t> &data, size_t begin, size_t end,
+    const std::function<void(const std::string &, size_t, size_t)> &onBox)
+{
+    size_t pos = begin;
+    while (pos + BOX_HEADER_SIZE <= end) {
+        uint64_t size = ReadBe32(data, pos);
+        std::string type(data.begin() + pos + 4, data.begin() + pos + BOX_HEADER_SIZE); // 4: type follows size
+        size_t header = BOX_HEADER_SIZE;
+        if (size == 1) { // 1: a 64 bit size follows the type
+            if (pos + LARGE_BOX_HEADER_SIZE > end) {
+                return false;
+            }
+            size = (static_cast<uint64_t>(ReadBe32(data, pos + BOX_HEADER_SIZE)) << 32) | // 32: high word
+                ReadBe32(data, pos + BOX_HEADER_SIZE + 4); // 4: low word
+            header = LARGE_BOX_HEADER_SIZE;
+        } else if (size == 0) { // 0: the box extends to the end
+            size = end - pos;
+        }
+        if (size < header || size > end - pos) {
+            return false;
+        }
+        onBox(type, pos + header, pos + size);
+        pos += size;
+    }
+    return pos == end;
+}
 } // namespace
 
 void AVMuxerUnitTest::SetUpTestCase() {}
@@ -2146,5 +2187,150 @@ HWTEST_F(AVMuxerUnitTest, Muxer_MP4_001, TestSize.Level0)
     ASSERT_EQ(avmuxer->Stop(), 0);
     close(fd);
 }
+
+/**
+ * @tc.name: Muxer_FMP4_001
+ * @tc.desc: Muxer mux fragmented mp4 by h264
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVMuxerUnitTest, Muxer_FMP4_001, TestSize.Level0)
+{
+    int32_t trackId = -1;
+    std::string outputFile = TEST_FILE_PATH + std::string("Muxer_AVC_Fragmented.mp4");
+    Plugins::OutputFormat outputFormat = Plugins::OutputFormat::MPEG_4;
+    int32_t fd = open(outputFile.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    std::shared_ptr<AVMuxer> avmuxer = AVMuxerFactory::CreateAVMuxer(fd, outputFormat);
+    ASSERT_NE(avmuxer, nullptr);
+
+    std::shared_ptr<Meta> videoParams = std::make_shared<Meta>();
+    videoParams->Set<Tag::MIME_TYPE>(Plugins::MimeType::VIDEO_AVC);
+    videoParams->Set<Tag::VIDEO_WIDTH>(TEST_WIDTH);
+    videoParams->Set<Tag::VIDEO_HEIGHT>(TEST_HEIGHT);
+    videoParams->Set<Tag::VIDEO_FRAME_RATE>(60.0); // 60.0 fps
+    ASSERT_EQ(avmuxer->AddTrack(trackId, videoParams), 0);
+    ASSERT_GE(trackId, 0);
+
+    std::shared_ptr<Meta> invalidParam = std::make_shared<Meta>();
+    invalidParam->SetData("fragmented_mp4", static_cast<int32_t>(1));
+    invalidParam->SetData("fragment_duration", static_cast<int32_t>(10)); // 10 ms is too short
+    EXPECT_NE(avmuxer->SetParameter(invalidParam), 0);
+
+    std::shared_ptr<Meta> param = std::make_shared<Meta>();
+    param->SetData("fragmented_mp4", static_cast<int32_t>(1));
+    param->SetData("fragment_duration", static_cast<int32_t>(500)); // 500 ms per fragment
+    EXPECT_EQ(avmuxer->SetParameter(param), 0);
+    OHOS::sptr<AVBufferQueueProducer> bqProducer = avmuxer->GetInputBufferQueue(trackId);
+    ASSERT_NE(bqProducer, nullptr);
+    ASSERT_EQ(avmuxer->Start(), 0);
+
+    inputFile_ = std::make_shared<std::ifstream>(INPUT_FILE_PATH, std::ios::binary);
+    int32_t extSize = 0;
+    inputFile_->read(reinterpret_cast<char*>(&extSize), sizeof(extSize));
+    if (extSize > 0) {
+        std::vector<uint8_t> buffer(extSize);
+        inputFile_->read(reinterpret_cast<char*>(buffer.data()), extSize);
+    }
+    bool eosFlag = false;
+    int32_t ret = 0;
+    do {
+        ret = WriteSample(bqProducer, inputFile_, eosFlag);
+    } while (!eosFlag && (ret == 0));
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(avmuxer->Stop(), 0);
+    close(fd);
+
+    std::ifstream file(outputFile, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<std::string> topBoxes;
+    std::vector<uint32_t> sequenceNumbers;
+    bool isValid = WalkBoxes(data, 0, data.size(), [&](const std::string &type, size_t begin, size_t end) {
+        topBoxes.push_back(type);
+        if (type != "moof") {
+            return;
+        }
+        size_t mfhdCount = 0;
+        EXPECT_TRUE(WalkBoxes(data, begin, end, [&](const std::string &child, size_t childBegin, size_t childEnd) {
+            // mfhd: version and flags, then the 32 bit sequence number
+            if (child == "mfhd" && childEnd - childBegin >= FULL_BOX_VERSION_FLAGS_SIZE + sizeof(uint32_t)) {
+                sequenceNumbers.push_back(ReadBe32(data, childBegin + FULL_BOX_VERSION_FLAGS_SIZE));
+                mfhdCount++;
+            }
+        }));
+        EXPECT_EQ(mfhdCount, 1);
+    });
+    ASSERT_TRUE(isValid);
+    ASSERT_FALSE(topBoxes.empty());
+    EXPECT_EQ(topBoxes.front(), "ftyp");
+    EXPECT_NE(std::find(topBoxes.begin(), topBoxes.end(), "moov"), topBoxes.end());
+    // the input is longer than one 500 ms fragment
+    ASSERT_GT(sequenceNumbers.size(), 1);
+    EXPECT_EQ(static_cast<size_t>(std::count(topBoxes.begin(), topBoxes.end(), "moof")), sequenceNumbers.size());
+    EXPECT_EQ(static_cast<size_t>(std::count(topBoxes.begin(), topBoxes.end(), "mdat")), sequenceNumbers.size());
+    for (size_t i = 1; i < sequenceNumbers.size(); i++) {
+        EXPECT_GT(sequenceNumbers[i], sequenceNumbers[i - 1]);
+    }
+}
+
+/**
+ * @tc.name: Muxer_IoBuffer_001
+ * @tc.desc: a large avio buffer written behind the muxer thread produces the same fast start file
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVMuxerUnitTest, Muxer_IoBuffer_001, TestSize.Level0)
+{
+    auto mux = [this](const std::string &outputFile, const std::shared_ptr<Meta> &param) {
+        int32_t trackId = -1;
+        int32_t fd = open(outputFile.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+        std::shared_ptr<AVMuxer> avmuxer = AVMuxerFactory::CreateAVMuxer(fd, Plugins::OutputFormat::MPEG_4);
+        ASSERT_NE(avmuxer, nullptr);
+        std::shared_ptr<Meta> videoParams = std::make_shared<Meta>();
+        videoParams->Set<Tag::MIME_TYPE>(Plugins::MimeType::VIDEO_AVC);
+        videoParams->Set<Tag::VIDEO_WIDTH>(TEST_WIDTH);
+        videoParams->Set<Tag::VIDEO_HEIGHT>(TEST_HEIGHT);
+        ASSERT_EQ(avmuxer->AddTrack(trackId, videoParams), 0);
+        param->SetData("fast_start", static_cast<int32_t>(1)); // 1: moov rewritten in front through a second io
+        ASSERT_EQ(avmuxer->SetParameter(param), 0);
+        OHOS::sptr<AVBufferQueueProducer> bqProducer = avmuxer->GetInputBufferQueue(trackId);
+        ASSERT_NE(bqProducer, nullptr);
+        ASSERT_EQ(avmuxer->Start(), 0);
+        inputFile_ = std::make_shared<std::ifstream>(INPUT_FILE_PATH, std::ios::binary);
+        int32_t extSize = 0;
+        inputFile_->read(reinterpret_cast<char*>(&extSize), sizeof(extSize));
+        if (extSize > 0) {
+            std::vector<uint8_t> buffer(extSize);
+            inputFile_->read(reinterpret_cast<char*>(buffer.data()), extSize);
+        }
+        bool eosFlag = false;
+        int32_t ret = 0;
+        do {
+            ret = WriteSample(bqProducer, inputFile_, eosFlag);
+        } while (!eosFlag && (ret == 0));
+        ASSERT_EQ(ret, 0);
+        ASSERT_EQ(avmuxer->Stop(), 0);
+        close(fd);
+    };
+    auto readFile = [](const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    std::string defaultFile = TEST_FILE_PATH + std::string("Muxer_IoBuffer_Default.mp4");
+    std::string tunedFile = TEST_FILE_PATH + std::string("Muxer_IoBuffer_Tuned.mp4");
+    mux(defaultFile, std::make_shared<Meta>());
+    std::shared_ptr<Meta> param = std::make_shared<Meta>();
+    param->SetData("io_buffer_size", static_cast<int32_t>(1000 * 1000)); // 1000 * 1000: rounded up to pages
+    param->SetData("io_write_behind", static_cast<int32_t>(1));
+    mux(tunedFile, param);
+    std::vector<char> expect = readFile(defaultFile);
+    EXPECT_FALSE(expect.empty());
+    EXPECT_EQ(expect, readFile(tunedFile));
+
+    int32_t fd = open(tunedFile.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    std::shared_ptr<AVMuxer> avmuxer = AVMuxerFactory::CreateAVMuxer(fd, Plugins::OutputFormat::MPEG_4);
+    ASSERT_NE(avmuxer, nullptr);
+    std::shared_ptr<Meta> invalidParam = std::make_shared<Meta>();
+    invalidParam->SetData("io_buffer_size", static_cast<int32_t>(1024)); // 1024: below the 4 KiB minimum
+    EXPECT_NE(avmuxer->SetParameter(invalidParam), 0);
+    close(fd);
+}
 #endif
 } // namespace
\ No newline at end of file
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "avcodec_latency_stats.h"
+#include "avcodec_trace.h"
+
+using namespace testing::ext;
+
+namespace {
+constexpr uint32_t RECORD_THREAD_NUM = 4;
+constexpr uint32_t RECORD_TIMES = 10000;
+constexpr int64_t COST_1_US = 1;
+constexpr int64_t COST_100_US = 100;
+constexpr int64_t COST_OVERFLOW_US = 10'000'000;
+constexpr uint32_t BUCKET_100_US = 6; // [64, 128)
+constexpr auto PAUSED_TIME = std::chrono::milliseconds(50);
+}
+
+namespace OHOS::MediaAVCodec {
+class LatencyStatsTestSuilt : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp(void)
+    {
+        AVCodecLatencyStats::GetInstance().Reset();
+    };
+    void TearDown(void)
+    {
+        AVCodecLatencyStats::GetInstance().Reset();
+    };
+};
+
+HWTEST_F(LatencyStatsTestSuilt, RECORD_TEST, TestSize.Level1)
+{
+    auto &stats = AVCodecLatencyStats::GetInstance();
+    stats.Record(LatencyStage::DECODE, COST_1_US);
+    stats.Record(LatencyStage::DECODE, COST_100_US);
+    stats.Record(LatencyStage::DECODE, COST_OVERFLOW_US);
+    stats.Record(LatencyStage::DECODE, -1);
+    stats.Record(LatencyStage::STAGE_BUTT, COST_100_US);
+
+    LatencySnapshot snapshot = stats.GetSnapshot(LatencyStage::DECODE);
+    ASSERT_EQ(snapshot.count, 4);
+    ASSERT_EQ(snapshot.maxUs, COST_OVERFLOW_US);
+    ASSERT_EQ(snapshot.sumUs, COST_1_US + COST_100_US + COST_OVERFLOW_US);
+    ASSERT_EQ(snapshot.buckets[0], 2); // 1us and the clamped negative cost
+    ASSERT_EQ(snapshot.buckets[BUCKET_100_US], 1);
+    ASSERT_EQ(snapshot.buckets[LatencySnapshot::BUCKET_NUM - 1], 1);
+    ASSERT_EQ(stats.GetSnapshot(LatencyStage::DEMUX).count, 0);
+}
+
+HWTEST_F(LatencyStatsTestSuilt, CONCURRENT_RECORD_TEST, TestSize.Level1)
+{
+    auto &stats = AVCodecLatencyStats::GetInstance();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < RECORD_THREAD_NUM; i++) {
+        threads.emplace_back([&stats]() {
+            for (uint32_t j = 0; j < RECORD_TIMES; j++) {
+                stats.Record(LatencyStage::MUX, COST_100_US);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    LatencySnapshot snapshot = stats.GetSnapshot(LatencyStage::MUX);
+    ASSERT_EQ(snapshot.count, RECORD_THREAD_NUM * RECORD_TIMES);
+    ASSERT_EQ(snapshot.buckets[BUCKET_100_US], RECORD_THREAD_NUM * RECORD_TIMES);
+}
+
+HWTEST_F(LatencyStatsTestSuilt, SCOPE_AND_DUMP_TEST, TestSize.Level1)
+{
+    {
+        AVCodecTrace trace("LatencyStatsTestSuilt::SCOPE_AND_DUMP_TEST");
+        AVCodecLatencyScope latency(LatencyStage::RENDER);
+    }
+    ASSERT_EQ(AVCodecLatencyStats::GetInstance().GetSnapshot(LatencyStage::RENDER).count, 1);
+
+    std::string dumpString;
+    AVCodecLatencyStats::GetInstance().GetDumpString(dumpString);
+    std::cout << dumpString;
+    ASSERT_NE(dumpString.find("Render"), std::string::npos);
+    ASSERT_EQ(dumpString.find("Demux"), std::string::npos);
+}
+
+HWTEST_F(LatencyStatsTestSuilt, SCOPE_PAUSE_TEST, TestSize.Level1)
+{
+    {
+        AVCodecLatencyScope latency(LatencyStage::DECODE);
+        latency.Pause();
+        std::this_thread::sleep_for(PAUSED_TIME); // a wait that is not the stage's own work
+        latency.Resume();
+        latency.Pause();
+        latency.Pause();
+    }
+    LatencySnapshot snapshot = AVCodecLatencyStats::GetInstance().GetSnapshot(LatencyStage::DECODE);
+    ASSERT_EQ(snapshot.count, 1);
+    ASSERT_LT(snapshot.maxUs, std::chrono::duration_cast<std::chrono::microseconds>(PAUSED_TIME).count());
+}
+} // namespace OHOS::MediaAVCodec
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ffmpeg_converter.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace Plugins {
+namespace {
+constexpr int32_t PROBE_MARGIN = 8;
+constexpr int32_t MAX_CHANNELS = 32;
+constexpr int32_t CHANNEL_BITS = 64;
+constexpr int32_t BENCH_ROUNDS = 100000;
+
+// the linear tables FFMpegConverter searched before its lookups were generated at compile time
+// ffmpeg channel layout to histreamer channel layout
+const std::vector<std::pair<AudioChannelLayout, uint64_t>> g_toFFMPEGChannelLayout = {
+    {AudioChannelLayout::MONO, AV_CH_LAYOUT_MONO},
+    {AudioChannelLayout::STEREO, AV_CH_LAYOUT_STEREO},
+    {AudioChannelLayout::CH_2POINT1, AV_CH_LAYOUT_2POINT1},
+    {AudioChannelLayout::CH_2_1, AV_CH_LAYOUT_2_1},
+    {AudioChannelLayout::SURROUND, AV_CH_LAYOUT_SURROUND},
+    {AudioChannelLayout::CH_3POINT1, AV_CH_LAYOUT_3POINT1},
+    {AudioChannelLayout::CH_4POINT0, AV_CH_LAYOUT_4POINT0},
+    {AudioChannelLayout::CH_4POINT1, AV_CH_LAYOUT_4POINT1},
+    {AudioChannelLayout::CH_2_2, AV_CH_LAYOUT_2_2},
+    {AudioChannelLayout::QUAD, AV_CH_LAYOUT_QUAD},
+    {AudioChannelLayout::CH_5POINT0, AV_CH_LAYOUT_5POINT0},
+    {AudioChannelLayout::CH_5POINT1, AV_CH_LAYOUT_5POINT1},
+    {AudioChannelLayout::CH_5POINT0_BACK, AV_CH_LAYOUT_5POINT0_BACK},
+    {AudioChannelLayout::CH_5POINT1_BACK, AV_CH_LAYOUT_5POINT1_BACK},
+    {AudioChannelLayout::CH_6POINT0, AV_CH_LAYOUT_6POINT0},
+    {AudioChannelLayout::CH_6POINT0_FRONT, AV_CH_LAYOUT_6POINT0_FRONT},
+    {AudioChannelLayout::HEXAGONAL, AV_CH_LAYOUT_HEXAGONAL},
+    {AudioChannelLayout::CH_6POINT1, AV_CH_LAYOUT_6POINT1},
+    {AudioChannelLayout::CH_6POINT1_BACK, AV_CH_LAYOUT_6POINT1_BACK},
+    {AudioChannelLayout::CH_6POINT1_FRONT, AV_CH_LAYOUT_6POINT1_FRONT},
+    {AudioChannelLayout::CH_7POINT0, AV_CH_LAYOUT_7POINT0},
+    {AudioChannelLayout::CH_7POINT0_FRONT, AV_CH_LAYOUT_7POINT0_FRONT},
+    {AudioChannelLayout::CH_7POINT1, AV_CH_LAYOUT_7POINT1},
+    {AudioChannelLayout::CH_7POINT1_WIDE, AV_CH_LAYOUT_7POINT1_WIDE},
+    {AudioChannelLayout::CH_7POINT1_WIDE_BACK, AV_CH_LAYOUT_7POINT1_WIDE_BACK},
+    {AudioChannelLayout::OCTAGONAL, AV_CH_LAYOUT_OCTAGONAL},
+    {AudioChannelLayout::HEXADECAGONAL, AV_CH_LAYOUT_HEXADECAGONAL},
+    {AudioChannelLayout::STEREO_DOWNMIX, AV_CH_LAYOUT_STEREO_DOWNMIX},
+};
+
+const std::vector<std::pair<int, AudioChannelLayout>> g_channelLayoutDefaukltMap = {
+    {2, AudioChannelLayout::STEREO},             // 2: STEREO
+    {4, AudioChannelLayout::CH_4POINT0},         // 4: CH_4POINT0
+    {6, AudioChannelLayout::CH_5POINT1},         // 6: CH_5POINT1
+    {8, AudioChannelLayout::CH_5POINT1POINT2},   // 8: CH_5POINT1POINT2
+    {9, AudioChannelLayout::HOA_ORDER2_ACN_N3D}, // 9: HOA_ORDER2_ACN_N3D
+    {10, AudioChannelLayout::CH_7POINT1POINT2},  // 10: CH_7POINT1POINT2 or CH_5POINT1POINT4 ?
+    {12, AudioChannelLayout::CH_7POINT1POINT4},  // 12: CH_7POINT1POINT4
+    {14, AudioChannelLayout::CH_9POINT1POINT4},  // 14: CH_9POINT1POINT4
+    {16, AudioChannelLayout::CH_9POINT1POINT6},  // 16: CH_9POINT1POINT6
+    {24, AudioChannelLayout::CH_22POINT2},       // 24: CH_22POINT2
+};
+
+const std::vector<std::pair<AVSampleFormat, AudioSampleFormat>> g_pFfSampleFmtMap = {
+    {AVSampleFormat::AV_SAMPLE_FMT_U8, AudioSampleFormat::SAMPLE_U8},
+    {AVSampleFormat::AV_SAMPLE_FMT_S16, AudioSampleFormat::SAMPLE_S16LE},
+    {AVSampleFormat::AV_SAMPLE_FMT_S32, AudioSampleFormat::SAMPLE_S32LE},
+    {AVSampleFormat::AV_SAMPLE_FMT_FLT, AudioSampleFormat::SAMPLE_F32LE},
+    {AVSampleFormat::AV_SAMPLE_FMT_U8P, AudioSampleFormat::SAMPLE_U8P},
+    {AVSampleFormat::AV_SAMPLE_FMT_S16P, AudioSampleFormat::SAMPLE_S16P},
+    {AVSampleFormat::AV_SAMPLE_FMT_S32P, AudioSampleFormat::SAMPLE_S32P},
+    {AVSampleFormat::AV_SAMPLE_FMT_FLTP, AudioSampleFormat::SAMPLE_F32P},
+};
+
+// align with player framework capability.
+const std::vector<std::pair<AVCodecID, AudioSampleFormat>> g_pFfCodeIDToSampleFmtMap = {
+    {AVCodecID::AV_CODEC_ID_PCM_U8, AudioSampleFormat::SAMPLE_U8},
+    {AVCodecID::AV_CODEC_ID_PCM_S16LE, AudioSampleFormat::SAMPLE_S16LE},
+    {AVCodecID::AV_CODEC_ID_PCM_S24LE, AudioSampleFormat::SAMPLE_S24LE},
+    {AVCodecID::AV_CODEC_ID_PCM_S32LE, AudioSampleFormat::SAMPLE_S32LE},
+    {AVCodecID::AV_CODEC_ID_PCM_F32LE, AudioSampleFormat::SAMPLE_F32LE},
+};
+
+const std::vector<std::pair<AudioChannelLayout, std::string_view>> g_ChannelLayoutToString = {
+    {AudioChannelLayout::UNKNOWN, "UNKNOW"},
+    {AudioChannelLayout::MONO, "MONO"},
+    {AudioChannelLayout::STEREO, "STEREO"},
+    {AudioChannelLayout::CH_2POINT1, "2POINT1"},
+    {AudioChannelLayout::CH_2_1, "CH_2_1"},
+    {AudioChannelLayout::SURROUND, "SURROUND"},
+    {AudioChannelLayout::CH_3POINT1, "3POINT1"},
+    {AudioChannelLayout::CH_4POINT0, "4POINT0"},
+    {AudioChannelLayout::CH_4POINT1, "4POINT1"},
+    {AudioChannelLayout::CH_2_2, "CH_2_2"},
+    {AudioChannelLayout::QUAD, "QUAD"},
+    {AudioChannelLayout::CH_5POINT0, "5POINT0"},
+    {AudioChannelLayout::CH_5POINT1, "5POINT1"},
+    {AudioChannelLayout::CH_5POINT0_BACK, "5POINT0_BACK"},
+    {AudioChannelLayout::CH_5POINT1_BACK, "5POINT1_BACK"},
+    {AudioChannelLayout::CH_6POINT0, "6POINT0"},
+    {AudioChannelLayout::CH_6POINT0_FRONT, "6POINT0_FRONT"},
+    {AudioChannelLayout::HEXAGONAL, "HEXAGONAL"},
+    {AudioChannelLayout::CH_6POINT1, "6POINT1"},
+    {AudioChannelLayout::CH_6POINT1_BACK, "6POINT1_BACK"},
+    {AudioChannelLayout::CH_6POINT1_FRONT, "6POINT1_FRONT"},
+    {AudioChannelLayout::CH_7POINT0, "7POINT0"},
+    {AudioChannelLayout::CH_7POINT0_FRONT, "7POINT0_FRONT"},
+    {AudioChannelLayout::CH_7POINT1, "7POINT1"},
+    {AudioChannelLayout::CH_7POINT1_WIDE, "7POINT1_WIDE"},
+    {AudioChannelLayout::CH_7POINT1_WIDE_BACK, "7POINT1_WIDE_BACK"},
+    {AudioChannelLayout::CH_3POINT1POINT2, "CH_3POINT1POINT2"},
+    {AudioChannelLayout::CH_5POINT1POINT2, "CH_5POINT1POINT2"},
+    {AudioChannelLayout::CH_5POINT1POINT4, "CH_5POINT1POINT4"},
+    {AudioChannelLayout::CH_7POINT1POINT2, "CH_7POINT1POINT2"},
+    {AudioChannelLayout::CH_7POINT1POINT4, "CH_7POINT1POINT4"},
+    {AudioChannelLayout::CH_9POINT1POINT4, "CH_9POINT1POINT4"},
+    {AudioChannelLayout::CH_9POINT1POINT6, "CH_9POINT1POINT6"},
+    {AudioChannelLayout::CH_10POINT2, "CH_10POINT2"},
+    {AudioChannelLayout::CH_22POINT2, "CH_22POINT2"},
+    {AudioChannelLayout::OCTAGONAL, "OCTAGONAL"},
+    {AudioChannelLayout::HEXADECAGONAL, "HEXADECAGONAL"},
+    {AudioChannelLayout::STEREO_DOWNMIX, "STEREO_DOWNMIX"},
+    {AudioChannelLayout::CH_2POINT0POINT2, "CH_2POINT0POINT2"},
+    {AudioChannelLayout::CH_2POINT1POINT2, "CH_2POINT1POINT2"},
+    {AudioChannelLayout::CH_3POINT0POINT2, "CH_3POINT0POINT2"},
+    {AudioChannelLayout::HOA_ORDER1_ACN_N3D, "HOA_ORDER1_ACN_N3D"},
+    {AudioChannelLayout::HOA_ORDER1_ACN_SN3D, "HOA_ORDER1_ACN_SN3D"},
+    {AudioChannelLayout::HOA_ORDER1_FUMA, "HOA_ORDER1_FUMA"},
+    {AudioChannelLayout::HOA_ORDER2_ACN_N3D, "HOA_ORDER2_ACN_N3D"},
+    {AudioChannelLayout::HOA_ORDER2_ACN_SN3D, "HOA_ORDER2_ACN_SN3D"},
+    {AudioChannelLayout::HOA_ORDER2_FUMA, "HOA_ORDER2_FUMA"},
+    {AudioChannelLayout::HOA_ORDER3_ACN_N3D, "HOA_ORDER3_ACN_N3D"},
+    {AudioChannelLayout::HOA_ORDER3_ACN_SN3D, "HOA_ORDER3_ACN_SN3D"},
+    {AudioChannelLayout::HOA_ORDER3_FUMA, "HOA_ORDER3_FUMA"},
+};
+
+const std::vector<std::pair<AVColorPrimaries, ColorPrimary>> g_pFfColorPrimariesMap = {
+    {AVColorPrimaries::AVCOL_PRI_BT709, ColorPrimary::BT709},
+    {AVColorPrimaries::AVCOL_PRI_UNSPECIFIED, ColorPrimary::UNSPECIFIED},
+    {AVColorPrimaries::AVCOL_PRI_BT470M, ColorPrimary::BT470_M},
+    {AVColorPrimaries::AVCOL_PRI_BT470BG, ColorPrimary::BT601_625},
+    {AVColorPrimaries::AVCOL_PRI_SMPTE170M, ColorPrimary::BT601_525},
+    {AVColorPrimaries::AVCOL_PRI_SMPTE240M, ColorPrimary::SMPTE_ST240},
+    {AVColorPrimaries::AVCOL_PRI_FILM, ColorPrimary::GENERIC_FILM},
+    {AVColorPrimaries::AVCOL_PRI_BT2020, ColorPrimary::BT2020},
+    {AVColorPrimaries::AVCOL_PRI_SMPTE428, ColorPrimary::SMPTE_ST428},
+    {AVColorPrimaries::AVCOL_PRI_SMPTEST428_1, ColorPrimary::SMPTE_ST428},
+    {AVColorPrimaries::AVCOL_PRI_SMPTE431, ColorPrimary::P3DCI},
+    {AVColorPrimaries::AVCOL_PRI_SMPTE432, ColorPrimary::P3D65},
+};
+
+const std::vector<std::pair<AVColorTransferCharacteristic, TransferCharacteristic>> g_pFfTransferCharacteristicMap = {
+    {AVColorTransferCharacteristic::AVCOL_TRC_BT709, TransferCharacteristic::BT709},
+    {AVColorTransferCharacteristic::AVCOL_TRC_UNSPECIFIED, TransferCharacteristic::UNSPECIFIED},
+    {AVColorTransferCharacteristic::AVCOL_TRC_GAMMA22, TransferCharacteristic::GAMMA_2_2},
+    {AVColorTransferCharacteristic::AVCOL_TRC_GAMMA28, TransferCharacteristic::GAMMA_2_8},
+    {AVColorTransferCharacteristic::AVCOL_TRC_SMPTE170M, TransferCharacteristic::BT601},
+    {AVColorTransferCharacteristic::AVCOL_TRC_SMPTE240M, TransferCharacteristic::SMPTE_ST240},
+    {AVColorTransferCharacteristic::AVCOL_TRC_LINEAR, TransferCharacteristic::LINEAR},
+    {AVColorTransferCharacteristic::AVCOL_TRC_LOG, TransferCharacteristic::LOG},
+    {AVColorTransferCharacteristic::AVCOL_TRC_LOG_SQRT, TransferCharacteristic::LOG_SQRT},
+    {AVColorTransferCharacteristic::AVCOL_TRC_IEC61966_2_4, TransferCharacteristic::IEC_61966_2_4},
+    {AVColorTransferCharacteristic::AVCOL_TRC_BT1361_ECG, TransferCharacteristic::BT1361},
+    {AVColorTransferCharacteristic::AVCOL_TRC_IEC61966_2_1, TransferCharacteristic::IEC_61966_2_1},
+    {AVColorTransferCharacteristic::AVCOL_TRC_BT2020_10, TransferCharacteristic::BT2020_10BIT},
+    {AVColorTransferCharacteristic::AVCOL_TRC_BT2020_12, TransferCharacteristic::BT2020_12BIT},
+    {AVColorTransferCharacteristic::AVCOL_TRC_SMPTE2084, TransferCharacteristic::PQ},
+    {AVColorTransferCharacteristic::AVCOL_TRC_SMPTEST2084, TransferCharacteristic::PQ},
+    {AVColorTransferCharacteristic::AVCOL_TRC_SMPTE428, TransferCharacteristic::SMPTE_ST428},
+    {AVColorTransferCharacteristic::AVCOL_TRC_SMPTEST428_1, TransferCharacteristic::SMPTE_ST428},
+    {AVColorTransferCharacteristic::AVCOL_TRC_ARIB_STD_B67, TransferCharacteristic::HLG},
+};
+
+const std::vector<std::pair<AVColorSpace, MatrixCoefficient>> g_pFfMatrixCoefficientMap = {
+    {AVColorSpace::AVCOL_SPC_RGB, MatrixCoefficient::IDENTITY},
+    {AVColorSpace::AVCOL_SPC_BT709, MatrixCoefficient::BT709},
+    {AVColorSpace::AVCOL_SPC_UNSPECIFIED, MatrixCoefficient::UNSPECIFIED},
+    {AVColorSpace::AVCOL_SPC_FCC, MatrixCoefficient::FCC},
+    {AVColorSpace::AVCOL_SPC_BT470BG, MatrixCoefficient::BT601_625},
+    {AVColorSpace::AVCOL_SPC_SMPTE170M, MatrixCoefficient::BT601_525},
+    {AVColorSpace::AVCOL_SPC_SMPTE240M, MatrixCoefficient::SMPTE_ST240},
+    {AVColorSpace::AVCOL_SPC_YCGCO, MatrixCoefficient::YCGCO},
+    {AVColorSpace::AVCOL_SPC_YCOCG, MatrixCoefficient::YCGCO},
+    {AVColorSpace::AVCOL_SPC_BT2020_NCL, MatrixCoefficient::BT2020_NCL},
+    {AVColorSpace::AVCOL_SPC_BT2020_CL, MatrixCoefficient::BT2020_CL},
+    {AVColorSpace::AVCOL_SPC_SMPTE2085, MatrixCoefficient::SMPTE_ST2085},
+    {AVColorSpace::AVCOL_SPC_CHROMA_DERIVED_NCL, MatrixCoefficient::CHROMATICITY_NCL},
+    {AVColorSpace::AVCOL_SPC_CHROMA_DERIVED_CL, MatrixCoefficient::CHROMATICITY_CL},
+    {AVColorSpace::AVCOL_SPC_ICTCP, MatrixCoefficient::ICTCP},
+};
+
+const std::vector<std::pair<AVColorRange, int>> g_pFfColorRangeMap = {
+    {AVColorRange::AVCOL_RANGE_MPEG, 0},
+    {AVColorRange::AVCOL_RANGE_JPEG, 1},
+};
+
+const std::vector<std::pair<AVChromaLocation, ChromaLocation>> g_pFfChromaLocationMap = {
+    {AVChromaLocation::AVCHROMA_LOC_UNSPECIFIED, ChromaLocation::UNSPECIFIED},
+    {AVChromaLocation::AVCHROMA_LOC_LEFT, ChromaLocation::LEFT},
+    {AVChromaLocation::AVCHROMA_LOC_CENTER, ChromaLocation::CENTER},
+    {AVChromaLocation::AVCHROMA_LOC_TOPLEFT, ChromaLocation::TOPLEFT},
+    {AVChromaLocation::AVCHROMA_LOC_TOP, ChromaLocation::TOP},
+    {AVChromaLocation::AVCHROMA_LOC_BOTTOMLEFT, ChromaLocation::BOTTOMLEFT},
+    {AVChromaLocation::AVCHROMA_LOC_BOTTOM, ChromaLocation::BOTTOM},
+};
+
+const std::vector<std::pair<int, HEVCProfile>> g_pFfHEVCProfileMap = {
+    {FF_PROFILE_HEVC_MAIN, HEVCProfile::HEVC_PROFILE_MAIN},
+    {FF_PROFILE_HEVC_MAIN_10, HEVCProfile::HEVC_PROFILE_MAIN_10},
+    {FF_PROFILE_HEVC_MAIN_STILL_PICTURE, HEVCProfile::HEVC_PROFILE_MAIN_STILL},
+};
+
+const std::vector<std::pair<int, HEVCLevel>> g_pFfHEVCLevelMap = {
+    {30, HEVCLevel::HEVC_LEVEL_1},   {60, HEVCLevel::HEVC_LEVEL_2},  {63, HEVCLevel::HEVC_LEVEL_21},
+    {90, HEVCLevel::HEVC_LEVEL_3},   {93, HEVCLevel::HEVC_LEVEL_31}, {120, HEVCLevel::HEVC_LEVEL_4},
+    {123, HEVCLevel::HEVC_LEVEL_41}, {150, HEVCLevel::HEVC_LEVEL_5}, {153, HEVCLevel::HEVC_LEVEL_51},
+    {156, HEVCLevel::HEVC_LEVEL_52}, {180, HEVCLevel::HEVC_LEVEL_6}, {183, HEVCLevel::HEVC_LEVEL_61},
+    {186, HEVCLevel::HEVC_LEVEL_62},
+};
+
+// what the linear search answered: the first entry holding the key, or the fallback
+template <bool BY_SECOND, typename First, typename Second, typename Key, typename Value>
+Value Search(const std::vector<std::pair<First, Second>> &table, Key key, Value fallback)
+{
+    for (const auto &item : table) {
+        if constexpr (BY_SECOND) {
+            if (item.second == key) {
+                return item.first;
+            }
+        } else {
+            if (item.first == key) {
+                return item.second;
+            }
+        }
+    }
+    return fallback;
+}
+
+// every key of the table, plus the integers around and between them that the table does not hold
+template <bool BY_SECOND, typename First, typename Second>
+std::vector<int64_t> ProbeKeys(const std::vector<std::pair<First, Second>> &table)
+{
+    std::vector<int64_t> keys;
+    for (const auto &item : table) {
+        if constexpr (BY_SECOND) {
+            keys.push_back(static_cast<int64_t>(item.second));
+        } else {
+            keys.push_back(static_cast<int64_t>(item.first));
+        }
+    }
+    auto [minKey, maxKey] = std::minmax_element(keys.begin(), keys.end());
+    for (int64_t key = *minKey - PROBE_MARGIN; key <= *maxKey + PROBE_MARGIN; key++) {
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+template <bool BY_SECOND, typename First, typename Second, typename Convert, typename Value>
+void ExpectSameAsTable(const std::vector<std::pair<First, Second>> &table, Convert convert, Value fallback)
+{
+    using Key = std::conditional_t<BY_SECOND, Second, First>;
+    for (int64_t key : ProbeKeys<BY_SECOND>(table)) {
+        EXPECT_EQ(convert(static_cast<Key>(key)), Search<BY_SECOND>(table, static_cast<Key>(key), fallback))
+            << "key " << key;
+    }
+}
+
+// channel layout masks: every table entry, each single channel and every table entry with one channel more
+std::vector<uint64_t> ProbeLayouts()
+{
+    std::vector<uint64_t> layouts = {0, AV_CH_LAYOUT_NATIVE};
+    for (const auto &item : g_toFFMPEGChannelLayout) {
+        layouts.push_back(item.second);
+        layouts.push_back(static_cast<uint64_t>(item.first));
+        for (int32_t bit = 0; bit < CHANNEL_BITS; bit++) {
+            layouts.push_back(item.second | (1ULL << bit));
+        }
+    }
+    for (const auto &item : g_ChannelLayoutToString) {
+        layouts.push_back(static_cast<uint64_t>(item.first));
+    }
+    for (int32_t bit = 0; bit < CHANNEL_BITS; bit++) {
+        layouts.push_back(1ULL << bit);
+    }
+    return layouts;
+}
+} // namespace
+
+class FFMpegConverterUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp(void) {};
+    void TearDown(void) {};
+};
+
+/**
+ * @tc.name: FFMpegConverter_001
+ * @tc.desc: sample format and codec id conversions answer like the linear tables, for listed and unlisted keys
+ * @tc.type: FUNC
+ */
+HWTEST_F(FFMpegConverterUnitTest, FFMpegConverter_001, TestSize.Level1)
+{
+    ExpectSameAsTable<false>(g_pFfSampleFmtMap, FFMpegConverter::ConvertFFMpegToOHAudioFormat,
+        AudioSampleFormat::INVALID_WIDTH);
+    ExpectSameAsTable<true>(g_pFfSampleFmtMap, FFMpegConverter::ConvertOHAudioFormatToFFMpeg,
+        AVSampleFormat::AV_SAMPLE_FMT_NONE);
+    ExpectSameAsTable<false>(g_pFfCodeIDToSampleFmtMap, FFMpegConverter::ConvertFFMpegAVCodecIdToOHAudioFormat,
+        AudioSampleFormat::INVALID_WIDTH);
+}
+
+/**
+ * @tc.name: FFMpegConverter_002
+ * @tc.desc: channel layout conversions and names answer like the linear tables, for listed and unlisted layouts
+ * @tc.type: FUNC
+ */
+HWTEST_F(FFMpegConverterUnitTest, FFMpegConverter_002, TestSize.Level1)
+{
+    for (int32_t channels = -1; channels <= MAX_CHANNELS; channels++) {
+        EXPECT_EQ(FFMpegConverter::GetDefaultChannelLayout(channels),
+            Search<false>(g_channelLayoutDefaukltMap, channels, AudioChannelLayout::MONO));
+    }
+    for (uint64_t layout : ProbeLayouts()) {
+        auto ohLayout = static_cast<AudioChannelLayout>(layout);
+        EXPECT_EQ(FFMpegConverter::ConvertFFToOHAudioChannelLayout(layout),
+            Search<true>(g_toFFMPEGChannelLayout, layout, AudioChannelLayout::MONO)) << layout;
+        for (int32_t channels : {1, 2, 6, 8, 24}) {
+            EXPECT_EQ(FFMpegConverter::ConvertFFToOHAudioChannelLayoutV2(layout, channels),
+                Search<true>(g_toFFMPEGChannelLayout, layout, FFMpegConverter::GetDefaultChannelLayout(channels)));
+        }
+        EXPECT_EQ(FFMpegConverter::ConvertOHAudioChannelLayoutToFFMpeg(ohLayout),
+            Search<false>(g_toFFMPEGChannelLayout, ohLayout, AV_CH_LAYOUT_NATIVE)) << layout;
+        EXPECT_EQ(FFMpegConverter::ConvertOHAudioChannelLayoutToString(ohLayout),
+            Search<false>(g_ChannelLayoutToString, ohLayout, g_ChannelLayoutToString[0].second)) << layout;
+    }
+}
+
+/**
+ * @tc.name: FFMpegConverter_003
+ * @tc.desc: color, chroma location and hevc profile and level conversions answer like the linear tables
+ * @tc.type: FUNC
+ */
+HWTEST_F(FFMpegConverterUnitTest, FFMpegConverter_003, TestSize.Level1)
+{
+    ExpectSameAsTable<false>(g_pFfColorPrimariesMap, FFMpegConverter::ConvertFFMpegToOHColorPrimaries,
+        ColorPrimary::UNSPECIFIED);
+    ExpectSameAsTable<false>(g_pFfTransferCharacteristicMap, FFMpegConverter::ConvertFFMpegToOHColorTrans,
+        TransferCharacteristic::UNSPECIFIED);
+    ExpectSameAsTable<false>(g_pFfMatrixCoefficientMap, FFMpegConverter::ConvertFFMpegToOHColorMatrix,
+        MatrixCoefficient::UNSPECIFIED);
+    ExpectSameAsTable<false>(g_pFfColorRangeMap, FFMpegConverter::ConvertFFMpegToOHColorRange, 0);
+    ExpectSameAsTable<false>(g_pFfChromaLocationMap, FFMpegConverter::ConvertFFMpegToOHChromaLocation,
+        ChromaLocation::UNSPECIFIED);
+    ExpectSameAsTable<false>(g_pFfHEVCProfileMap, FFMpegConverter::ConvertFFMpegToOHHEVCProfile,
+        HEVCProfile::HEVC_PROFILE_UNKNOW);
+    ExpectSameAsTable<false>(g_pFfHEVCLevelMap, FFMpegConverter::ConvertFFMpegToOHHEVCLevel,
+        HEVCLevel::HEVC_LEVEL_UNKNOW);
+}
+
+/**
+ * @tc.name: FFMpegConverter_Perf_001
+ * @tc.desc: channel layout and sample format conversions of every listed key, linear tables against lookups
+ * @tc.type: PERF
+ */
+HWTEST_F(FFMpegConverterUnitTest, FFMpegConverter_Perf_001, TestSize.Level3)
+{
+    uint64_t linearSum = 0;
+    uint64_t lookupSum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t round = 0; round < BENCH_ROUNDS; round++) {
+        for (const auto &item : g_toFFMPEGChannelLayout) {
+            linearSum +=
+                static_cast<uint64_t>(Search<true>(g_toFFMPEGChannelLayout, item.second, AudioChannelLayout::MONO));
+            linearSum += Search<false>(g_toFFMPEGChannelLayout, item.first, AV_CH_LAYOUT_NATIVE);
+        }
+        for (const auto &item : g_pFfSampleFmtMap) {
+            linearSum +=
+                static_cast<uint64_t>(Search<false>(g_pFfSampleFmtMap, item.first, AudioSampleFormat::INVALID_WIDTH));
+        }
+    }
+    std::chrono::duration<double> linearCost = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    for (int32_t round = 0; round < BENCH_ROUNDS; round++) {
+        for (const auto &item : g_toFFMPEGChannelLayout) {
+            lookupSum += static_cast<uint64_t>(FFMpegConverter::ConvertFFToOHAudioChannelLayout(item.second));
+            lookupSum += FFMpegConverter::ConvertOHAudioChannelLayoutToFFMpeg(item.first);
+        }
+        for (const auto &item : g_pFfSampleFmtMap) {
+            lookupSum += static_cast<uint64_t>(FFMpegConverter::ConvertFFMpegToOHAudioFormat(item.first));
+        }
+    }
+    std::chrono::duration<double> lookupCost = std::chrono::steady_clock::now() - start;
+    std::cout << "linear tables: " << linearCost.count() << " s, lookups: " << lookupCost.count() << " s" << std::endl;
+    EXPECT_EQ(lookupSum, linearSum);
+}
+} // namespace Plugins
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+#include "library_cache.h"
+
+using namespace testing::ext;
+
+namespace {
+// both are linked by the test, so they are always present
+const std::string LIB_PATH = "libav_codec_service_utils.z.so";
+const std::string OTHER_LIB_PATH = "libutils.z.so";
+// resolved through the dependencies of LIB_PATH
+const std::string SYMBOL = "malloc";
+constexpr std::chrono::milliseconds IDLE_TTL {50};
+constexpr std::chrono::milliseconds PAST_IDLE_TTL {200};
+
+std::string GetLibraryInfo(OHOS::MediaAVCodec::LibraryCache &cache, const std::string &path)
+{
+    std::string dumpString;
+    cache.GetDumpInfo(dumpString);
+    size_t begin = dumpString.find("    " + path + " - ");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = dumpString.find('\n', begin);
+    return dumpString.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+}
+
+bool IsLoaded(OHOS::MediaAVCodec::LibraryCache &cache, const std::string &path)
+{
+    return GetLibraryInfo(cache, path).find("loaded: 1,") != std::string::npos;
+}
+
+bool HasOpenCount(OHOS::MediaAVCodec::LibraryCache &cache, const std::string &path, uint32_t count)
+{
+    return GetLibraryInfo(cache, path).find("opens: " + std::to_string(count) + ",") != std::string::npos;
+}
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+class LibraryCacheUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp(void) {}
+    void TearDown(void) {}
+};
+
+/**
+ * @tc.name: LibraryCache_Acquire_001
+ * @tc.desc: repeated acquires share one open and one cached symbol lookup
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibraryCacheUnitTest, LibraryCache_Acquire_001, TestSize.Level1)
+{
+    LibraryCache cache(IDLE_TTL);
+    void *handle = cache.Acquire(LIB_PATH);
+    ASSERT_NE(handle, nullptr);
+    EXPECT_EQ(cache.Acquire(LIB_PATH), handle);
+    void *symbol = cache.GetSymbol(LIB_PATH, SYMBOL);
+    ASSERT_NE(symbol, nullptr);
+    EXPECT_EQ(cache.GetSymbol(LIB_PATH, SYMBOL), symbol);
+    EXPECT_TRUE(HasOpenCount(cache, LIB_PATH, 1));
+    EXPECT_NE(GetLibraryInfo(cache, LIB_PATH).find("symbol hits: 1/2"), std::string::npos);
+    cache.Release(LIB_PATH);
+    cache.Release(LIB_PATH);
+    EXPECT_EQ(cache.Acquire("libav_codec_not_exist.z.so"), nullptr);
+}
+
+/**
+ * @tc.name: LibraryCache_Evict_001
+ * @tc.desc: a library still referenced is not closed once the idle period of an earlier release passed
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibraryCacheUnitTest, LibraryCache_Evict_001, TestSize.Level1)
+{
+    LibraryCache cache(IDLE_TTL);
+    ASSERT_NE(cache.Acquire(LIB_PATH), nullptr);
+    ASSERT_NE(cache.Acquire(OTHER_LIB_PATH), nullptr);
+    cache.Release(LIB_PATH);
+    // taken again within the idle period, the stale idle time must not close it
+    ASSERT_NE(cache.Acquire(LIB_PATH), nullptr);
+    std::this_thread::sleep_for(PAST_IDLE_TTL);
+    cache.Release(OTHER_LIB_PATH);
+    std::this_thread::sleep_for(PAST_IDLE_TTL);
+    ASSERT_NE(cache.Acquire(OTHER_LIB_PATH), nullptr);
+
+    EXPECT_TRUE(IsLoaded(cache, LIB_PATH));
+    EXPECT_TRUE(HasOpenCount(cache, LIB_PATH, 1));
+    EXPECT_NE(cache.GetSymbol(LIB_PATH, SYMBOL), nullptr);
+    // the other library went idle in between and was closed and opened again
+    EXPECT_TRUE(HasOpenCount(cache, OTHER_LIB_PATH, 2));
+    cache.Release(LIB_PATH);
+    cache.Release(OTHER_LIB_PATH);
+}
+
+/**
+ * @tc.name: LibraryCache_Evict_002
+ * @tc.desc: an idle library is closed on the first acquire or release after its idle period, not before
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibraryCacheUnitTest, LibraryCache_Evict_002, TestSize.Level1)
+{
+    LibraryCache cache(IDLE_TTL);
+    ASSERT_NE(cache.Acquire(LIB_PATH), nullptr);
+    ASSERT_NE(cache.Acquire(OTHER_LIB_PATH), nullptr);
+    cache.Release(LIB_PATH);
+    EXPECT_TRUE(IsLoaded(cache, LIB_PATH));
+    EXPECT_NE(cache.GetSymbol(LIB_PATH, SYMBOL), nullptr);
+
+    std::this_thread::sleep_for(PAST_IDLE_TTL);
+    // eviction is lazy, nothing ran since the release
+    EXPECT_TRUE(IsLoaded(cache, LIB_PATH));
+    cache.Release(OTHER_LIB_PATH);
+    EXPECT_FALSE(IsLoaded(cache, LIB_PATH));
+    EXPECT_EQ(cache.GetSymbol(LIB_PATH, SYMBOL), nullptr);
+}
+
+/**
+ * @tc.name: LibraryCache_Reload_001
+ * @tc.desc: an evicted library is opened again on the next acquire and its symbols are resolved again
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibraryCacheUnitTest, LibraryCache_Reload_001, TestSize.Level1)
+{
+    LibraryCache cache(IDLE_TTL);
+    ASSERT_NE(cache.Acquire(LIB_PATH), nullptr);
+    ASSERT_NE(cache.GetSymbol(LIB_PATH, SYMBOL), nullptr);
+    cache.Release(LIB_PATH);
+    std::this_thread::sleep_for(PAST_IDLE_TTL);
+
+    ASSERT_NE(cache.Acquire(LIB_PATH), nullptr);
+    EXPECT_TRUE(IsLoaded(cache, LIB_PATH));
+    EXPECT_TRUE(HasOpenCount(cache, LIB_PATH, 2));
+    EXPECT_NE(cache.GetSymbol(LIB_PATH, SYMBOL), nullptr);
+    // the cached symbol was dropped with the handle, the lookup after the reload is a miss
+    EXPECT_NE(GetLibraryInfo(cache, LIB_PATH).find("symbol hits: 0/2"), std::string::npos);
+    cache.Release(LIB_PATH);
+}
+
+/**
+ * @tc.name: LibraryCache_Reload_002
+ * @tc.desc: with no idle period the library is closed on its last release and reopened on the next acquire
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibraryCacheUnitTest, LibraryCache_Reload_002, TestSize.Level1)
+{
+    LibraryCache cache(std::chrono::milliseconds(0));
+    ASSERT_NE(cache.Acquire(LIB_PATH), nullptr);
+    cache.Release(LIB_PATH);
+    EXPECT_FALSE(IsLoaded(cache, LIB_PATH));
+    ASSERT_NE(cache.Acquire(LIB_PATH), nullptr);
+    EXPECT_TRUE(HasOpenCount(cache, LIB_PATH, 2));
+    cache.Release(LIB_PATH);
+}
+
+/**
+ * @tc.name: LibraryCache_Preload_001
+ * @tc.desc: a preloaded library stays loaded after its last release, whatever the idle period
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibraryCacheUnitTest, LibraryCache_Preload_001, TestSize.Level1)
+{
+    LibraryCache cache(std::chrono::milliseconds(0));
+    ASSERT_TRUE(cache.Preload(LIB_PATH));
+    ASSERT_NE(cache.Acquire(LIB_PATH), nullptr);
+    cache.Release(LIB_PATH);
+    EXPECT_TRUE(IsLoaded(cache, LIB_PATH));
+    EXPECT_TRUE(HasOpenCount(cache, LIB_PATH, 1));
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
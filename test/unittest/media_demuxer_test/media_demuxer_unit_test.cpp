@@ -13,15 +13,20 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <iostream>
 #include <string>
+#include <vector>
 #include <malloc.h>
 #include <sys/stat.h>
 #include <cinttypes>
 #include <fcntl.h>
+#include <unistd.h>
 #include "media_demuxer_unit_test.h"
 #include "http_server_demo.h"
 #include "plugin/plugin_event.h"
 #include "demuxer/stream_demuxer.h"
+#include "syspara/parameters.h"
 
 #define LOCAL true
 namespace OHOS::Media {
@@ -1444,6 +1449,51 @@ HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_ReadSample_001, TestSize.Level1)
     delete[] data;
 }
 
+HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_ReadSamples_001, TestSize.Level1)
+{
+    std::shared_ptr<MediaDemuxer> demuxer = std::make_shared<MediaDemuxer>();
+    demuxer->streamDemuxer_ = std::make_shared<StreamDemuxer>();
+
+    uint32_t readCount = 0;
+    std::vector<std::shared_ptr<AVBuffer>> samples(2);
+    demuxer->useBufferQueue_ = true;
+    EXPECT_EQ(demuxer->ReadSamples(0, samples, 0, readCount), Status::ERROR_WRONG_STATE);
+    demuxer->useBufferQueue_ = false;
+    EXPECT_EQ(demuxer->ReadSamples(0, samples, 0, readCount), Status::ERROR_INVALID_OPERATION);
+    demuxer->eosMap_[0] = true;
+    EXPECT_EQ(demuxer->ReadSamples(0, samples, 0, readCount), Status::ERROR_INVALID_PARAMETER);
+    uint8_t* data = new uint8_t[200];
+    samples[0] = AVBuffer::CreateAVBuffer(data, 100, 100);
+    samples[1] = AVBuffer::CreateAVBuffer(data + 100, 100, 100);
+    EXPECT_EQ(demuxer->ReadSamples(0, samples, 0, readCount), Status::END_OF_STREAM);
+    EXPECT_EQ(readCount, 1);
+    EXPECT_EQ(samples[0]->flag_, static_cast<uint32_t>(AVBufferFlag::EOS));
+    EXPECT_EQ(samples[0]->memory_->GetSize(), 0);
+    delete[] data;
+}
+
+HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_ReadSamples_002, TestSize.Level1)
+{
+    uint8_t* data = new uint8_t[300];
+    std::vector<std::shared_ptr<AVBuffer>> samples;
+    for (int32_t i = 0; i < 3; i++) {
+        samples.push_back(AVBuffer::CreateAVBuffer(data + i * 100, 100, 0));
+    }
+    uint32_t readCount = 0;
+    std::shared_ptr<DemuxerPluginMock> plugin = std::make_shared<DemuxerPluginMock>("StatusOK");
+    EXPECT_EQ(plugin->ReadSamples(0, samples, 0, readCount), Status::OK);
+    EXPECT_EQ(readCount, 3);
+
+    samples[1]->flag_ = static_cast<uint32_t>(AVBufferFlag::EOS);
+    EXPECT_EQ(plugin->ReadSamples(0, samples, 0, readCount), Status::OK);
+    EXPECT_EQ(readCount, 2);
+
+    plugin = std::make_shared<DemuxerPluginMock>("StatusErrorUnknown");
+    EXPECT_EQ(plugin->ReadSamples(0, samples, 0, readCount), Status::ERROR_UNKNOWN);
+    EXPECT_EQ(readCount, 0);
+    delete[] data;
+}
+
 HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_StartTask_002, TestSize.Level1)
 {
     std::shared_ptr<MediaDemuxer> demuxer = std::make_shared<MediaDemuxer>();
@@ -1633,4 +1683,290 @@ HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_GetInnerTrackIDByTrackID_0100, TestS
     int32_t actualInnerTrackIndex = demuxerPluginManager->GetInnerTrackIDByTrackID(trackId);
     ASSERT_EQ(actualInnerTrackIndex, expectedInnerTrackIndex);
 }
+
+// Opens the file through an fd source, the fd is closed once the demuxer is released
+static std::shared_ptr<MediaDemuxer> CreateFdDemuxer(const std::string &path)
+{
+    struct stat fileStatus {};
+    if (stat(path.c_str(), &fileStatus) != 0) {
+        return nullptr;
+    }
+    int32_t fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    std::string uri = "fd://" + std::to_string(fd) + "?offset=0&size=" + std::to_string(fileStatus.st_size);
+    std::shared_ptr<MediaDemuxer> demuxer(new MediaDemuxer(), [fd](MediaDemuxer *ptr) {
+        delete ptr;
+        close(fd);
+    });
+    if (demuxer->SetDataSource(std::make_shared<MediaSource>(uri)) != Status::OK) {
+        return nullptr;
+    }
+    return demuxer;
+}
+
+static std::shared_ptr<MediaDemuxer> CreateVideoOnlyDemuxer(const std::string &path, uint32_t &videoTrackId)
+{
+    std::shared_ptr<MediaDemuxer> demuxer = CreateFdDemuxer(path);
+    if (demuxer == nullptr) {
+        return nullptr;
+    }
+    std::vector<std::shared_ptr<Meta>> trackMetas = demuxer->GetStreamMetaInfo();
+    for (uint32_t i = 0; i < trackMetas.size(); i++) {
+        std::string mime;
+        if (trackMetas[i]->GetData(Tag::MIME_TYPE, mime) && mime.find("video/") == 0) {
+            videoTrackId = i;
+            return demuxer->SelectTrack(i) == Status::OK ? demuxer : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+// Takes the first key frame at or after each of thumbnailNum evenly spaced positions, returns the thumbnail count
+static uint32_t GenerateThumbnails(std::shared_ptr<MediaDemuxer> demuxer, uint32_t trackId, int64_t durationUs,
+    uint32_t thumbnailNum, uint32_t &readNum)
+{
+    std::vector<uint8_t> data(8 * 1024 * 1024); // holds a 4k key frame
+    std::shared_ptr<AVBuffer> sample = AVBuffer::CreateAVBuffer(data.data(), data.size(), 0);
+    int64_t interval = durationUs / thumbnailNum;
+    uint32_t thumbnailCount = 0;
+    readNum = 0;
+    while (thumbnailCount < thumbnailNum && demuxer->ReadSample(trackId, sample) == Status::OK) {
+        ++readNum;
+        if ((sample->flag_ & static_cast<uint32_t>(AVBufferFlag::EOS)) != 0) {
+            break;
+        }
+        if ((sample->flag_ & static_cast<uint32_t>(AVBufferFlag::SYNC_FRAME)) != 0 &&
+            sample->pts_ >= interval * thumbnailCount) {
+            ++thumbnailCount;
+        }
+    }
+    return thumbnailCount;
+}
+
+HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_SetKeyFrameOnly_001, TestSize.Level1)
+{
+    std::shared_ptr<MediaDemuxer> demuxer = std::make_shared<MediaDemuxer>();
+    EXPECT_EQ(demuxer->SetKeyFrameOnly(true), Status::ERROR_INVALID_OPERATION);
+
+    uint32_t trackId = 0;
+    demuxer = CreateVideoOnlyDemuxer("/data/test/media/H264_AAC_multi_track.mp4", trackId);
+    ASSERT_NE(demuxer, nullptr);
+    EXPECT_EQ(demuxer->SetKeyFrameOnly(true), Status::OK);
+    std::vector<uint8_t> data(1024 * 1024);
+    std::shared_ptr<AVBuffer> sample = AVBuffer::CreateAVBuffer(data.data(), data.size(), 0);
+    uint32_t keyFrameNum = 0;
+    while (demuxer->ReadSample(trackId, sample) == Status::OK &&
+        (sample->flag_ & static_cast<uint32_t>(AVBufferFlag::EOS)) == 0) {
+        EXPECT_NE(sample->flag_ & static_cast<uint32_t>(AVBufferFlag::SYNC_FRAME), 0);
+        ++keyFrameNum;
+    }
+    EXPECT_GT(keyFrameNum, 0);
+}
+
+/**
+ * @tc.name: MediaDemuxer_SetKeyFrameOnly_Perf_001
+ * @tc.desc: time to generate 100 thumbnails from a 2 hour file, with and without the key frame only mode
+ * @tc.type: PERF
+ */
+HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_SetKeyFrameOnly_Perf_001, TestSize.Level3)
+{
+    const std::string path = "/data/test/media/h264_aac_2h.mp4";
+    constexpr uint32_t thumbnailNum = 100;
+    int64_t costUs[2] = {0, 0};
+    uint32_t readNum[2] = {0, 0};
+    for (int32_t keyFrameOnly = 0; keyFrameOnly < 2; keyFrameOnly++) {
+        uint32_t trackId = 0;
+        std::shared_ptr<MediaDemuxer> demuxer = CreateVideoOnlyDemuxer(path, trackId);
+        if (demuxer == nullptr) {
+            std::cout << path << " is not available, skip" << std::endl;
+            return;
+        }
+        int64_t durationMs = 0;
+        ASSERT_TRUE(demuxer->GetDuration(durationMs));
+        if (keyFrameOnly != 0) {
+            ASSERT_EQ(demuxer->SetKeyFrameOnly(true), Status::OK);
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint32_t thumbnailCount =
+            GenerateThumbnails(demuxer, trackId, durationMs * 1000, thumbnailNum, readNum[keyFrameOnly]);
+        costUs[keyFrameOnly] = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        EXPECT_EQ(thumbnailCount, thumbnailNum);
+    }
+    std::cout << "thumbnails: " << thumbnailNum << ", all frames: " << costUs[0] << " us / " << readNum[0] <<
+        " samples, key frame only: " << costUs[1] << " us / " << readNum[1] << " samples" << std::endl;
+    EXPECT_LT(readNum[1], readNum[0]);
+}
+
+struct TrackSamples {
+    std::vector<int64_t> pts;
+    std::vector<uint32_t> flags;
+    std::vector<int32_t> sizes;
+    uint64_t checksum = 0;
+};
+
+// Opens the file with or without the per-track read cursors, selects its first audio and, if asked, video track
+static std::shared_ptr<MediaDemuxer> CreateAudioVideoDemuxer(const std::string &path, bool trackCursor,
+    uint32_t &audioTrackId, uint32_t &videoTrackId, bool selectVideo = true)
+{
+    const std::string key = "persist.media_service.demuxer_track_cursor";
+    std::string saved = OHOS::system::GetParameter(key, "1");
+    OHOS::system::SetParameter(key, trackCursor ? "1" : "0");
+    std::shared_ptr<MediaDemuxer> demuxer = CreateFdDemuxer(path);
+    OHOS::system::SetParameter(key, saved);
+    if (demuxer == nullptr) {
+        return nullptr;
+    }
+    std::vector<std::shared_ptr<Meta>> trackMetas = demuxer->GetStreamMetaInfo();
+    int32_t audioIndex = -1;
+    int32_t videoIndex = -1;
+    for (uint32_t i = 0; i < trackMetas.size(); i++) {
+        std::string mime;
+        if (!trackMetas[i]->GetData(Tag::MIME_TYPE, mime)) {
+            continue;
+        }
+        if (audioIndex < 0 && mime.find("audio/") == 0) {
+            audioIndex = static_cast<int32_t>(i);
+        } else if (videoIndex < 0 && mime.find("video/") == 0) {
+            videoIndex = static_cast<int32_t>(i);
+        }
+    }
+    if (audioIndex < 0 || videoIndex < 0 || demuxer->SelectTrack(audioIndex) != Status::OK ||
+        (selectVideo && demuxer->SelectTrack(videoIndex) != Status::OK)) {
+        return nullptr;
+    }
+    audioTrackId = static_cast<uint32_t>(audioIndex);
+    videoTrackId = static_cast<uint32_t>(videoIndex);
+    return demuxer;
+}
+
+static void ReadTrack(std::shared_ptr<MediaDemuxer> demuxer, uint32_t trackId, TrackSamples &samples)
+{
+    std::vector<uint8_t> data(8 * 1024 * 1024); // holds a 4k key frame
+    std::shared_ptr<AVBuffer> sample = AVBuffer::CreateAVBuffer(data.data(), data.size(), 0);
+    while (demuxer->ReadSample(trackId, sample) == Status::OK &&
+        (sample->flag_ & static_cast<uint32_t>(AVBufferFlag::EOS)) == 0) {
+        int32_t size = sample->memory_->GetSize();
+        samples.pts.push_back(sample->pts_);
+        samples.flags.push_back(sample->flag_);
+        samples.sizes.push_back(size);
+        for (int32_t i = 0; i < size; i++) {
+            samples.checksum = samples.checksum * 31 + data[i]; // 31 spreads the bytes over the checksum
+        }
+    }
+}
+
+HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_TrackCursor_001, TestSize.Level1)
+{
+    const std::string path = "/data/test/media/H264_AAC_multi_track.mp4";
+    TrackSamples audio[2];
+    TrackSamples video[2];
+    for (int32_t trackCursor = 0; trackCursor < 2; trackCursor++) {
+        uint32_t audioTrackId = 0;
+        uint32_t videoTrackId = 0;
+        std::shared_ptr<MediaDemuxer> demuxer =
+            CreateAudioVideoDemuxer(path, trackCursor != 0, audioTrackId, videoTrackId);
+        ASSERT_NE(demuxer, nullptr);
+        // drain the audio first, the shared cursor parks every video sample on the way
+        ReadTrack(demuxer, audioTrackId, audio[trackCursor]);
+        ReadTrack(demuxer, videoTrackId, video[trackCursor]);
+    }
+    EXPECT_GT(audio[0].pts.size(), 0);
+    EXPECT_GT(video[0].pts.size(), 0);
+    EXPECT_EQ(audio[1].pts, audio[0].pts);
+    EXPECT_EQ(audio[1].flags, audio[0].flags);
+    EXPECT_EQ(audio[1].sizes, audio[0].sizes);
+    EXPECT_EQ(audio[1].checksum, audio[0].checksum);
+    EXPECT_EQ(video[1].pts, video[0].pts);
+    EXPECT_EQ(video[1].flags, video[0].flags);
+    EXPECT_EQ(video[1].sizes, video[0].sizes);
+    EXPECT_EQ(video[1].checksum, video[0].checksum);
+}
+
+HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_TrackCursor_002, TestSize.Level1)
+{
+    uint32_t audioTrackId = 0;
+    uint32_t videoTrackId = 0;
+    std::shared_ptr<MediaDemuxer> demuxer =
+        CreateAudioVideoDemuxer("/data/test/media/H264_AAC_multi_track.mp4", true, audioTrackId, videoTrackId);
+    ASSERT_NE(demuxer, nullptr);
+    TrackSamples first;
+    ReadTrack(demuxer, audioTrackId, first);
+    ASSERT_GT(first.pts.size(), 0);
+
+    // the audio cursor is at the end, the video cursor at the start, both go back to the first key frame
+    int64_t realSeekTime = 0;
+    ASSERT_EQ(demuxer->SeekTo(0, SeekMode::SEEK_PREVIOUS_SYNC, realSeekTime), Status::OK);
+    TrackSamples audio;
+    TrackSamples video;
+    ReadTrack(demuxer, audioTrackId, audio);
+    ReadTrack(demuxer, videoTrackId, video);
+    EXPECT_EQ(audio.pts, first.pts);
+    EXPECT_EQ(audio.checksum, first.checksum);
+    ASSERT_GT(video.flags.size(), 0);
+    EXPECT_NE(video.flags[0] & static_cast<uint32_t>(AVBufferFlag::SYNC_FRAME), 0);
+}
+
+/**
+ * @tc.name: MediaDemuxer_TrackCursor_003
+ * @tc.desc: a track selected after the others have been read starts at a key frame near their position
+ * @tc.type: FUNC
+ */
+HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_TrackCursor_003, TestSize.Level1)
+{
+    const std::string path = "/data/test/media/H264_AAC_multi_track.mp4";
+    uint32_t audioTrackId = 0;
+    uint32_t videoTrackId = 0;
+    std::shared_ptr<MediaDemuxer> demuxer = CreateAudioVideoDemuxer(path, true, audioTrackId, videoTrackId);
+    ASSERT_NE(demuxer, nullptr);
+    TrackSamples fullVideo;
+    ReadTrack(demuxer, videoTrackId, fullVideo);
+    ASSERT_GT(fullVideo.pts.size(), 0);
+
+    demuxer = CreateAudioVideoDemuxer(path, true, audioTrackId, videoTrackId, false);
+    ASSERT_NE(demuxer, nullptr);
+    TrackSamples audio;
+    ReadTrack(demuxer, audioTrackId, audio);
+    ASSERT_GT(audio.pts.size(), 0);
+    ASSERT_EQ(demuxer->SelectTrack(videoTrackId), Status::OK);
+    TrackSamples video;
+    ReadTrack(demuxer, videoTrackId, video);
+    ASSERT_GT(video.flags.size(), 0);
+    EXPECT_NE(video.flags[0] & static_cast<uint32_t>(AVBufferFlag::SYNC_FRAME), 0);
+    EXPECT_LT(video.pts.size(), fullVideo.pts.size());
+    EXPECT_LE(video.pts[0], audio.pts.back());
+}
+
+/**
+ * @tc.name: MediaDemuxer_TrackCursor_Perf_001
+ * @tc.desc: time to extract the audio of a 1 GB video while its video track stays selected, with the shared read
+ *           cursor and with one cursor per track
+ * @tc.type: PERF
+ */
+HWTEST_F(MediaDemuxerUnitTest, MediaDemuxer_TrackCursor_Perf_001, TestSize.Level3)
+{
+    const std::string path = "/data/test/media/h264_aac_1g.mp4";
+    int64_t costUs[2] = {0, 0};
+    TrackSamples audio[2];
+    for (int32_t trackCursor = 0; trackCursor < 2; trackCursor++) {
+        uint32_t audioTrackId = 0;
+        uint32_t videoTrackId = 0;
+        std::shared_ptr<MediaDemuxer> demuxer =
+            CreateAudioVideoDemuxer(path, trackCursor != 0, audioTrackId, videoTrackId);
+        if (demuxer == nullptr) {
+            std::cout << path << " is not available, skip" << std::endl;
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        ReadTrack(demuxer, audioTrackId, audio[trackCursor]);
+        costUs[trackCursor] = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+    std::cout << "audio samples: " << audio[0].pts.size() << ", shared cursor: " << costUs[0] <<
+        " us, track cursor: " << costUs[1] << " us" << std::endl;
+    EXPECT_EQ(audio[1].pts.size(), audio[0].pts.size());
+    EXPECT_EQ(audio[1].checksum, audio[0].checksum);
+}
 }
\ No newline at end of file
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "sink/subtitle_cue_index.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+namespace {
+constexpr int64_t SECOND_US = 1000000;
+constexpr uint32_t BENCH_CUE_NUM = 50000;
+constexpr uint32_t BENCH_SEEK_NUM = 100000;
+constexpr uint32_t VERIFY_SEEK_NUM = 1000;
+constexpr int64_t CUE_INTERVAL_US = 2 * SECOND_US;
+constexpr int64_t CUE_DURATION_US = 1500000;
+constexpr uint32_t OVERLAP_PERIOD = 10;
+
+struct PlainCue {
+    int64_t pts;
+    int64_t duration;
+};
+
+// The cue layout of a long srt file, every tenth cue lasts long enough to overlap the next ones
+std::vector<PlainCue> GenerateCues(uint32_t cueNum)
+{
+    std::vector<PlainCue> cues;
+    for (uint32_t i = 0; i < cueNum; ++i) {
+        int64_t duration = (i % OVERLAP_PERIOD == 0) ? CUE_INTERVAL_US * 3 : CUE_DURATION_US;
+        cues.push_back({ static_cast<int64_t>(i) * CUE_INTERVAL_US, duration });
+    }
+    return cues;
+}
+
+// The sorted vector binary search the sink used before, kept as the benchmark baseline
+int32_t BinarySearchCue(const std::vector<PlainCue> &cues, int64_t time)
+{
+    int32_t left = 0;
+    int32_t right = static_cast<int32_t>(cues.size());
+    while (left < right) {
+        int32_t mid = (left + right) / 2;
+        int64_t startTime = cues.at(mid).pts;
+        int64_t endTime = cues.at(mid).duration + startTime;
+        if (startTime > time) {
+            right = mid;
+        } else if (endTime < time) {
+            left = mid + 1;
+        } else {
+            return mid;
+        }
+    }
+    return left;
+}
+
+size_t CountActive(const std::vector<PlainCue> &cues, int64_t time)
+{
+    size_t count = 0;
+    for (const auto &cue : cues) {
+        count += (cue.pts <= time && time < cue.pts + cue.duration) ? 1 : 0;
+    }
+    return count;
+}
+
+int64_t BruteNextBoundary(const std::vector<PlainCue> &cues, int64_t time)
+{
+    int64_t boundary = SubtitleCueIndex::NO_BOUNDARY;
+    for (const auto &cue : cues) {
+        if (cue.pts > time) {
+            boundary = std::min(boundary, cue.pts);
+        } else if (cue.pts + cue.duration > time) {
+            boundary = std::min(boundary, cue.pts + cue.duration);
+        }
+    }
+    return boundary;
+}
+} // namespace
+
+HWTEST(TestSubtitleCueIndex, find_overlapping_cues, TestSize.Level1)
+{
+    SubtitleCueIndex index;
+    EXPECT_TRUE(index.Insert("a", 0, 3 * SECOND_US));
+    EXPECT_TRUE(index.Insert("b", SECOND_US, SECOND_US));
+    EXPECT_TRUE(index.Insert("c", 5 * SECOND_US, SECOND_US));
+
+    std::vector<const SubtitleCue *> cues;
+    index.FindActive(SECOND_US + 1, cues);
+    ASSERT_EQ(cues.size(), 2);
+    EXPECT_EQ(cues[0]->text, "a");
+    EXPECT_EQ(cues[1]->text, "b");
+    index.FindActive(2 * SECOND_US, cues);
+    ASSERT_EQ(cues.size(), 1);
+    EXPECT_EQ(cues[0]->text, "a");
+    index.FindActive(4 * SECOND_US, cues);
+    EXPECT_TRUE(cues.empty());
+
+    EXPECT_EQ(index.NextBoundary(0), SECOND_US);
+    EXPECT_EQ(index.NextBoundary(SECOND_US), 2 * SECOND_US);
+    EXPECT_EQ(index.NextBoundary(2 * SECOND_US), 3 * SECOND_US);
+    EXPECT_EQ(index.NextBoundary(3 * SECOND_US), 5 * SECOND_US);
+    EXPECT_EQ(index.NextBoundary(6 * SECOND_US), SubtitleCueIndex::NO_BOUNDARY);
+}
+
+HWTEST(TestSubtitleCueIndex, insert_out_of_order_and_duplicate, TestSize.Level1)
+{
+    SubtitleCueIndex index;
+    EXPECT_TRUE(index.Insert("late", 10 * SECOND_US, SECOND_US));
+    EXPECT_TRUE(index.Insert("early", SECOND_US, SECOND_US));
+    EXPECT_FALSE(index.Insert("late", 10 * SECOND_US, SECOND_US));
+    EXPECT_FALSE(index.Insert("invalid", SECOND_US, 0));
+    EXPECT_FALSE(index.Insert("invalid", -1, SECOND_US));
+    EXPECT_EQ(index.Size(), 2);
+    EXPECT_EQ(index.NextBoundary(0), SECOND_US);
+
+    std::vector<const SubtitleCue *> cues;
+    index.FindActive(10 * SECOND_US, cues);
+    ASSERT_EQ(cues.size(), 1);
+    EXPECT_EQ(cues[0]->text, "late");
+    index.Clear();
+    EXPECT_TRUE(index.Empty());
+    index.FindActive(10 * SECOND_US, cues);
+    EXPECT_TRUE(cues.empty());
+}
+
+HWTEST(TestSubtitleCueIndex, erase_ended_cues, TestSize.Level1)
+{
+    SubtitleCueIndex index;
+    EXPECT_TRUE(index.Insert("first", 0, SECOND_US));
+    EXPECT_TRUE(index.Insert("long", 0, 4 * SECOND_US));
+    EXPECT_TRUE(index.Insert("third", 2 * SECOND_US, SECOND_US));
+    std::vector<const SubtitleCue *> cues;
+    index.FindActive(2 * SECOND_US, cues);
+    ASSERT_EQ(cues.size(), 2);
+    uint32_t thirdId = cues[1]->id;
+
+    EXPECT_EQ(index.EraseEndedBefore(SECOND_US / 2), 0);
+    EXPECT_EQ(index.EraseEndedBefore(SECOND_US), 1);
+    EXPECT_EQ(index.Size(), 2);
+    index.FindActive(2 * SECOND_US, cues);
+    ASSERT_EQ(cues.size(), 2);
+    EXPECT_EQ(cues[0]->text, "long");
+    EXPECT_EQ(cues[1]->id, thirdId);
+    EXPECT_EQ(index.NextBoundary(SECOND_US), 2 * SECOND_US);
+
+    // an erased cue may be sent again, it gets a new id
+    EXPECT_TRUE(index.Insert("first", 0, SECOND_US));
+    index.FindActive(0, cues);
+    ASSERT_EQ(cues.size(), 2);
+    EXPECT_EQ(cues[1]->text, "first");
+    EXPECT_GT(cues[1]->id, thirdId);
+    EXPECT_EQ(index.EraseEndedBefore(5 * SECOND_US), 3);
+    EXPECT_TRUE(index.Empty());
+    EXPECT_EQ(index.NextBoundary(0), SubtitleCueIndex::NO_BOUNDARY);
+}
+
+HWTEST(TestSubtitleCueIndex, random_seek_matches_linear_scan, TestSize.Level1)
+{
+    auto plainCues = GenerateCues(BENCH_CUE_NUM / OVERLAP_PERIOD);
+    SubtitleCueIndex index;
+    for (const auto &cue : plainCues) {
+        ASSERT_TRUE(index.Insert("cue", cue.pts, cue.duration));
+    }
+    std::mt19937_64 random(0);
+    std::uniform_int_distribution<int64_t> seekTime(0, plainCues.back().pts + CUE_INTERVAL_US * 4);
+    std::vector<const SubtitleCue *> cues;
+    for (uint32_t i = 0; i < VERIFY_SEEK_NUM; ++i) {
+        int64_t time = seekTime(random);
+        index.FindActive(time, cues);
+        EXPECT_EQ(cues.size(), CountActive(plainCues, time)) << "time " << time;
+        EXPECT_EQ(index.NextBoundary(time), BruteNextBoundary(plainCues, time)) << "time " << time;
+    }
+}
+
+/**
+ * @tc.name: subtitle_cue_index_perf
+ * @tc.desc: random seeks over 50k cues, bucketed index against the binary search baseline
+ * @tc.type: PERF
+ */
+HWTEST(TestSubtitleCueIndex, subtitle_cue_index_perf, TestSize.Level3)
+{
+    auto plainCues = GenerateCues(BENCH_CUE_NUM);
+    SubtitleCueIndex index;
+    auto buildStart = std::chrono::steady_clock::now();
+    for (const auto &cue : plainCues) {
+        index.Insert("subtitle cue text", cue.pts, cue.duration);
+    }
+    auto buildUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - buildStart).count();
+    ASSERT_EQ(index.Size(), BENCH_CUE_NUM);
+
+    std::mt19937_64 random(0);
+    std::uniform_int_distribution<int64_t> seekTime(0, plainCues.back().pts);
+    std::vector<int64_t> seeks;
+    for (uint32_t i = 0; i < BENCH_SEEK_NUM; ++i) {
+        seeks.push_back(seekTime(random));
+    }
+
+    std::vector<const SubtitleCue *> cues;
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t time : seeks) {
+        index.FindActive(time, cues);
+        checksum += cues.size() + static_cast<uint64_t>(index.NextBoundary(time));
+    }
+    auto indexNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int64_t time : seeks) {
+        checksum += static_cast<uint64_t>(BinarySearchCue(plainCues, time));
+    }
+    auto searchNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "cues: " << BENCH_CUE_NUM << ", build: " << buildUs << " us, seeks: " << BENCH_SEEK_NUM
+              << ", index: " << static_cast<double>(indexNs) / BENCH_SEEK_NUM << " ns/seek, binary search: "
+              << static_cast<double>(searchNs) / BENCH_SEEK_NUM << " ns/seek" << std::endl;
+    EXPECT_NE(checksum, 0);
+}
+}  // namespace Test
+}  // namespace Media
+}  // namespace OHOS
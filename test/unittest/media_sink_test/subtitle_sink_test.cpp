@@ -67,7 +67,7 @@ HWTEST(TestSubtitleSink, do_sync_write_not_eos, TestSize.Level1)
     ASSERT_TRUE(bufferQP != nullptr);
     auto bufferQC = sink->GetBufferQueueConsumer();
     ASSERT_TRUE(bufferQC != nullptr);
-    sink->subtitleInfoVec_.push_back({"test", 1, 1});
+    sink->cueIndex_.Insert("test", 1, 1);
     sink->isThreadExit_ = true;
     sink->RenderLoop();
  
@@ -91,12 +91,12 @@ HWTEST(TestSubtitleSink, do_sync_write_two_frames_case1, TestSize.Level1)
     auto syncCenter = std::make_shared<MediaSyncManager>();
     sink->SetSyncCenter(syncCenter);
     sink->Prepare();
-    sink->subtitleInfoVec_.push_back({"test", 1, 1});
+    sink->cueIndex_.Insert("test", 1, 1);
     SubtitleSink::SubtitleInfo tempSubtitleInfo = {{"test", 1, 1}};
     sink->NotifyRender(tempSubtitleInfo);
     sink->isThreadExit_ = true;
-    sink->CalcWaitTime(tempSubtitleInfo);
-    sink->ActionToDo(tempSubtitleInfo);
+    sink->CalcWaitTime(tempSubtitleInfo.pts_);
+    sink->RenderActiveCues(tempSubtitleInfo.pts_);
     sink->RenderLoop();
  
     AVBufferConfig config;
@@ -126,7 +126,7 @@ HWTEST(TestSubtitleSink, do_sync_write_prepare_two_frames_case2, TestSize.Level1
     sink->PrepareInputBufferQueue();
     sink->PrepareInputBufferQueue();
     sink->Prepare();
-    sink->subtitleInfoVec_.push_back({"test", 1, 1});
+    sink->cueIndex_.Insert("test", 1, 1);
     sink->shouldUpdate_ = true;
     SubtitleSink::SubtitleInfo tempSubtitleInfo = {{"test", 1, 1}};
     std::shared_ptr<EventReceiver> testEventReceiver = std::make_shared<TestEventReceiver>();
@@ -167,7 +167,7 @@ HWTEST(TestSubtitleSink, do_sync_write_prepare_two_frames_case3, TestSize.Level1
     sink->PrepareInputBufferQueue();
     sink->PrepareInputBufferQueue();
     sink->Prepare();
-    sink->subtitleInfoVec_.push_back({"test", 1, 1});
+    sink->cueIndex_.Insert("test", 1, 1);
     sink->isThreadExit_ = true;
     sink->shouldUpdate_ = false;
     sink->RenderLoop();
@@ -203,8 +203,8 @@ HWTEST(TestSubtitleSink, do_sync_write_prepare_two_frames_case4, TestSize.Level1
     sink->PrepareInputBufferQueue();
     sink->PrepareInputBufferQueue();
     sink->Prepare();
-    sink->subtitleInfoVec_.push_back({"test", 1, 1});
-    sink->subtitleInfoVec_.push_back({"test", 1, 1});
+    sink->cueIndex_.Insert("test", 1, 1);
+    sink->cueIndex_.Insert("test", 1, 1);
     sink->isThreadExit_ = true;
     sink->RenderLoop();
     sink->filledOutputBuffer_ = std::make_shared<AVBuffer>();
@@ -239,8 +239,8 @@ HWTEST(TestSubtitleSink, do_sync_write_prepare_two_frames_case5, TestSize.Level1
     sink->PrepareInputBufferQueue();
     sink->PrepareInputBufferQueue();
     sink->Prepare();
-    sink->subtitleInfoVec_.push_back({"test", 1, 1});
-    sink->subtitleInfoVec_.push_back({"test", 2, 1});
+    sink->cueIndex_.Insert("test", 1, 1);
+    sink->cueIndex_.Insert("test", 2, 1);
     sink->isThreadExit_ = true;
     sink->RenderLoop();
     sink->filledOutputBuffer_ = std::make_shared<AVBuffer>();
@@ -307,12 +307,12 @@ HWTEST(TestSubtitleSink, do_sync_write_two_frames_case7, TestSize.Level1)
     auto syncCenter = std::make_shared<MediaSyncManager>();
     sink->SetSyncCenter(syncCenter);
     sink->Prepare();
-    sink->subtitleInfoVec_.push_back({"test", 1, 1});
+    sink->cueIndex_.Insert("test", 1, 1);
     SubtitleSink::SubtitleInfo tempSubtitleInfo = {{"test", 1, 1}};
     sink->NotifyRender(tempSubtitleInfo);
     sink->isThreadExit_ = true;
-    sink->CalcWaitTime(tempSubtitleInfo);
-    sink->ActionToDo(tempSubtitleInfo);
+    sink->CalcWaitTime(tempSubtitleInfo.pts_);
+    sink->RenderActiveCues(tempSubtitleInfo.pts_);
     sink->RenderLoop();
  
     AVBufferConfig config;
@@ -340,12 +340,12 @@ HWTEST(TestSubtitleSink, do_sync_write_two_frames_case8, TestSize.Level1)
     auto syncCenter = std::make_shared<MediaSyncManager>();
     sink->SetSyncCenter(syncCenter);
     sink->Prepare();
-    sink->subtitleInfoVec_.push_back({"test", 1, 1});
+    sink->cueIndex_.Insert("test", 1, 1);
     SubtitleSink::SubtitleInfo tempSubtitleInfo = {{"test", 2, 2}};
     sink->NotifyRender(tempSubtitleInfo);
  
-    sink->CalcWaitTime(tempSubtitleInfo);
-    sink->ActionToDo(tempSubtitleInfo);
+    sink->CalcWaitTime(tempSubtitleInfo.pts_);
+    sink->RenderActiveCues(tempSubtitleInfo.pts_);
     sink->isThreadExit_ = true;
     sink->RenderLoop();
  
@@ -383,6 +383,51 @@ HWTEST(TestSubtitleSink, do_sync_write_eos, TestSize.Level1)
     buffer->flag_ = BUFFER_FLAG_EOS;
     sink->DoSyncWrite(buffer);
 }
+
+static void QueueCue(const sptr<AVBufferQueueProducer> &producer, int64_t pts, int64_t duration)
+{
+    AVBufferConfig config;
+    config.size = 4;
+    config.memoryType = MemoryType::SHARED_MEMORY;
+    std::shared_ptr<AVBuffer> buffer = nullptr;
+    ASSERT_EQ(producer->RequestBuffer(buffer, config, 1000), Status::OK);
+    ASSERT_TRUE(buffer != nullptr && buffer->memory_ != nullptr);
+    char subtitle[] = "test";
+    buffer->memory_->Write(reinterpret_cast<uint8_t *>(subtitle), 4, 0);
+    buffer->pts_ = pts;
+    buffer->duration_ = duration;
+    ASSERT_EQ(producer->ReturnBuffer(buffer, true), Status::OK);
+}
+
+HWTEST(TestSubtitleSink, hold_cue_beyond_lookahead_until_flush, TestSize.Level1)
+{
+    auto sink = SubtitleSinkCreate();
+    ASSERT_TRUE(sink != nullptr);
+    auto syncCenter = std::make_shared<MediaSyncManager>();
+    sink->SetSyncCenter(syncCenter);
+    ASSERT_EQ(sink->Prepare(), Status::OK);
+    auto producer = sink->GetBufferQueueProducer();
+    ASSERT_TRUE(producer != nullptr);
+
+    // a cue close to the play position is copied and its buffer handed back at once
+    QueueCue(producer, 1000000, 1000000);
+    sink->DrainOutputBuffer(false);
+    EXPECT_EQ(sink->cueIndex_.Size(), 1);
+    EXPECT_EQ(sink->heldBuffer_, nullptr);
+
+    // a cue a minute ahead is indexed but its buffer is kept, so the demuxer can not send more
+    QueueCue(producer, 60000000, 1000000);
+    sink->DrainOutputBuffer(false);
+    EXPECT_EQ(sink->cueIndex_.Size(), 2);
+    EXPECT_NE(sink->heldBuffer_, nullptr);
+
+    sink->Flush();
+    EXPECT_TRUE(sink->cueIndex_.Empty());
+    EXPECT_EQ(sink->heldBuffer_, nullptr);
+    QueueCue(producer, 1000000, 1000000);
+    sink->DrainOutputBuffer(false);
+    EXPECT_EQ(sink->cueIndex_.Size(), 1);
+}
 }  // namespace Test
 }  // namespace Media
 }  // namespace OHOS
\ No newline at end of file
@@ -13,10 +13,19 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "gtest/gtest.h"
 #include "filter/filter.h"
 #include "video_sink.h"
 #include "sink/media_synchronous_sink.h"
+#include "decoder_surface_filter.h"
+#include "video_decoder_adapter.h"
 
 using namespace testing::ext;
 
@@ -39,6 +48,131 @@ public:
 private:
 };
 
+namespace {
+constexpr int64_t DECODE_COST_US = 8000;
+constexpr int64_t SLOW_DECODE_COST_US = 16000;
+constexpr int64_t DECODE_COST_TOLERANCE_US = 5000;
+constexpr size_t LATE_FRAME_NUM = 10;
+constexpr size_t MAX_LATE_RELEASE_BATCH = 8;
+constexpr int64_t FORCED_LAG_MS = 300;
+constexpr uint64_t SKIPPED_FRAME_NUM = 2;
+constexpr uint64_t DISCARDED_FRAME_NUM = 3;
+constexpr auto RELEASE_TIMEOUT = std::chrono::seconds(5);
+}
+
+// Stands in for the codec server, records every output buffer the filter hands back
+class FakeVideoDecoder : public MediaAVCodec::AVCodecVideoDecoder {
+public:
+    int32_t Configure(const Format &format) override
+    {
+        (void)format;
+        return 0;
+    }
+    int32_t Prepare() override
+    {
+        return 0;
+    }
+    int32_t Start() override
+    {
+        return 0;
+    }
+    int32_t Stop() override
+    {
+        return 0;
+    }
+    int32_t Flush() override
+    {
+        return 0;
+    }
+    int32_t Reset() override
+    {
+        return 0;
+    }
+    int32_t Release() override
+    {
+        return 0;
+    }
+    int32_t SetOutputSurface(sptr<Surface> surface) override
+    {
+        (void)surface;
+        return 0;
+    }
+    int32_t QueueInputBuffer(uint32_t index, MediaAVCodec::AVCodecBufferInfo info,
+        MediaAVCodec::AVCodecBufferFlag flag) override
+    {
+        (void)index;
+        (void)info;
+        (void)flag;
+        return 0;
+    }
+    int32_t QueueInputBuffer(uint32_t index) override
+    {
+        (void)index;
+        return 0;
+    }
+    int32_t GetOutputFormat(Format &format) override
+    {
+        (void)format;
+        return 0;
+    }
+    int32_t ReleaseOutputBuffer(uint32_t index, bool render) override
+    {
+        if (onRelease_ != nullptr) {
+            onRelease_();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        releases_.emplace_back(index, render);
+        cond_.notify_all();
+        return 0;
+    }
+    int32_t RenderOutputBufferAtTime(uint32_t index, int64_t renderTimestampNs) override
+    {
+        (void)renderTimestampNs;
+        return ReleaseOutputBuffer(index, true);
+    }
+    int32_t SetParameter(const Format &format) override
+    {
+        (void)format;
+        return 0;
+    }
+    int32_t SetCallback(const std::shared_ptr<MediaAVCodec::AVCodecCallback> &callback) override
+    {
+        (void)callback;
+        return 0;
+    }
+    int32_t SetCallback(const std::shared_ptr<MediaAVCodec::MediaCodecCallback> &callback) override
+    {
+        (void)callback;
+        return 0;
+    }
+
+    bool WaitReleases(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, RELEASE_TIMEOUT, [this, count] { return releases_.size() >= count; });
+    }
+
+    std::function<void()> onRelease_;
+    std::vector<std::pair<uint32_t, bool>> releases_;
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+std::shared_ptr<AVBuffer> CreateVideoFrame(int64_t pts, bool canDrop)
+{
+    AVBufferConfig config;
+    config.size = 4;
+    config.memoryType = MemoryType::SHARED_MEMORY;
+    std::shared_ptr<AVBuffer> buffer = AVBuffer::CreateAVBuffer(config);
+    if (buffer != nullptr) {
+        buffer->pts_ = pts;
+        buffer->meta_->SetData(Tag::VIDEO_BUFFER_CAN_DROP, canDrop);
+    }
+    return buffer;
+}
+
 std::shared_ptr<VideoSink> VideoSinkCreate()
 {
     auto videoSink = std::make_shared<VideoSink>();
@@ -165,6 +299,157 @@ HWTEST(TestVideoSink, do_sync_write_eos, TestSize.Level1)
     float speed = 0;
     videoSink->GetSpeed(speed);
 }
+
+HWTEST(TestVideoSink, get_render_slack_before_anchor, TestSize.Level1)
+{
+    auto videoSink = VideoSinkCreate();
+    ASSERT_TRUE(videoSink != nullptr);
+    EXPECT_EQ(videoSink->GetRenderSlackUs(0), INT64_MAX); // no frame rendered yet
+    AVBufferConfig config;
+    config.size = 4;
+    config.memoryType = MemoryType::SHARED_MEMORY;
+    const std::shared_ptr<AVBuffer> buffer = AVBuffer::CreateAVBuffer(config);
+    ASSERT_TRUE(buffer != nullptr);
+    buffer->flag_ = 0; // not eos
+    videoSink->SetFirstPts(0);
+    videoSink->DoSyncWrite(buffer);
+    videoSink->syncCenter_.reset();
+    EXPECT_EQ(videoSink->GetRenderSlackUs(0), INT64_MAX); // no render clock
+}
+HWTEST(TestVideoSink, can_skip_decode_late_non_reference_frame, TestSize.Level1)
+{
+    auto adapter = std::make_shared<VideoDecoderAdapter>();
+    int64_t slackUs = DECODE_COST_US / 2; // due before a frame can be decoded
+    adapter->SetRenderSlackQuery([&slackUs](int64_t pts) {
+        (void)pts;
+        return slackUs;
+    });
+    auto frame = CreateVideoFrame(0, true);
+    ASSERT_TRUE(frame != nullptr);
+    EXPECT_FALSE(adapter->CanSkipDecode(frame)); // no decode cost measured yet
+
+    adapter->decodeCostUs_ = DECODE_COST_US;
+    EXPECT_TRUE(adapter->CanSkipDecode(frame));
+    slackUs = -DECODE_COST_US; // already late
+    EXPECT_TRUE(adapter->CanSkipDecode(frame));
+    slackUs = DECODE_COST_US * 2; // the deadline can still be met
+    EXPECT_FALSE(adapter->CanSkipDecode(frame));
+}
+
+HWTEST(TestVideoSink, can_skip_decode_keeps_reference_and_eos_frames, TestSize.Level1)
+{
+    auto adapter = std::make_shared<VideoDecoderAdapter>();
+    adapter->SetRenderSlackQuery([](int64_t pts) {
+        (void)pts;
+        return -DECODE_COST_US;
+    });
+    adapter->decodeCostUs_ = DECODE_COST_US;
+    auto referenceFrame = CreateVideoFrame(0, false);
+    ASSERT_TRUE(referenceFrame != nullptr);
+    EXPECT_FALSE(adapter->CanSkipDecode(referenceFrame));
+
+    auto untaggedFrame = CreateVideoFrame(0, true);
+    ASSERT_TRUE(untaggedFrame != nullptr);
+    untaggedFrame->meta_->Remove(Tag::VIDEO_BUFFER_CAN_DROP);
+    EXPECT_FALSE(adapter->CanSkipDecode(untaggedFrame));
+
+    auto eosFrame = CreateVideoFrame(0, true);
+    ASSERT_TRUE(eosFrame != nullptr);
+    eosFrame->flag_ = BUFFER_FLAG_EOS;
+    EXPECT_FALSE(adapter->CanSkipDecode(eosFrame));
+}
+
+HWTEST(TestVideoSink, decode_cost_is_seven_eighths_average, TestSize.Level1)
+{
+    auto adapter = std::make_shared<VideoDecoderAdapter>();
+    const uint32_t index = 1;
+    const int64_t pts = 40000;
+    adapter->RecordDecodeStart(index); // never queued, nothing to time
+    adapter->RecordDecodeEnd(pts);
+    EXPECT_EQ(adapter->GetDecodeCostUs(), 0);
+
+    adapter->RecordDecodeQueued(index, pts);
+    adapter->RecordDecodeStart(index);
+    ASSERT_EQ(adapter->decodeStartTimes_.count(pts), 1u);
+    adapter->decodeStartTimes_[pts] -= DECODE_COST_US;
+    adapter->RecordDecodeEnd(pts);
+    int64_t firstCostUs = adapter->GetDecodeCostUs();
+    EXPECT_GE(firstCostUs, DECODE_COST_US); // the first frame seeds the average
+    EXPECT_LT(firstCostUs, DECODE_COST_US + DECODE_COST_TOLERANCE_US);
+
+    adapter->decodeCostUs_ = DECODE_COST_US;
+    adapter->RecordDecodeQueued(index, pts);
+    adapter->RecordDecodeStart(index);
+    adapter->decodeStartTimes_[pts] -= SLOW_DECODE_COST_US;
+    adapter->RecordDecodeEnd(pts);
+    int64_t expectedUs = (DECODE_COST_US * 7 + SLOW_DECODE_COST_US) / 8; // 7, 8: history weighs 7/8
+    EXPECT_GE(adapter->GetDecodeCostUs(), expectedUs);
+    EXPECT_LT(adapter->GetDecodeCostUs(), expectedUs + DECODE_COST_TOLERANCE_US);
+    EXPECT_TRUE(adapter->decodeStartTimes_.empty());
+    EXPECT_TRUE(adapter->queuedFrames_.empty());
+}
+
+HWTEST(TestVideoSink, render_loop_releases_late_frames_in_batches, TestSize.Level1)
+{
+    auto filter = std::make_shared<DecoderSurfaceFilter>("testVideoDecoder", FilterType::FILTERTYPE_VDEC);
+    auto decoder = std::make_shared<FakeVideoDecoder>();
+    filter->videoDecoder_->mediaCodec_ = decoder;
+    // every frame decoded before the seek target is late
+    filter->isSeek_ = true;
+    filter->seekTimeUs_ = INT64_MAX;
+    for (size_t i = 0; i < LATE_FRAME_NUM; ++i) {
+        auto frame = CreateVideoFrame(static_cast<int64_t>(i), true);
+        ASSERT_TRUE(frame != nullptr);
+        filter->outputBuffers_.push_back(std::make_pair(static_cast<int>(i), frame));
+    }
+    size_t queuedAtFirstRelease = LATE_FRAME_NUM;
+    decoder->onRelease_ = [&filter, &queuedAtFirstRelease]() {
+        std::lock_guard<std::mutex> lock(filter->mutex_);
+        queuedAtFirstRelease = std::min(queuedAtFirstRelease, filter->outputBuffers_.size());
+    };
+    std::thread renderThread(&DecoderSurfaceFilter::RenderLoop, filter.get());
+    bool released = decoder->WaitReleases(LATE_FRAME_NUM);
+    {
+        std::lock_guard<std::mutex> lock(filter->mutex_);
+        filter->isThreadExit_ = true;
+    }
+    filter->condBufferAvailable_.notify_all();
+    renderThread.join();
+    ASSERT_TRUE(released);
+    // the first run of late frames was popped in one go before any of them went back to the decoder
+    EXPECT_EQ(queuedAtFirstRelease, LATE_FRAME_NUM - MAX_LATE_RELEASE_BATCH);
+    ASSERT_EQ(decoder->releases_.size(), LATE_FRAME_NUM);
+    for (size_t i = 0; i < LATE_FRAME_NUM; ++i) {
+        EXPECT_EQ(decoder->releases_[i].first, static_cast<uint32_t>(i));
+        EXPECT_FALSE(decoder->releases_[i].second);
+    }
+}
+
+HWTEST(TestVideoSink, get_lag_info_reports_drops_after_lag, TestSize.Level1)
+{
+    auto filter = std::make_shared<DecoderSurfaceFilter>("testVideoDecoder", FilterType::FILTERTYPE_VDEC);
+    auto decoder = std::make_shared<FakeVideoDecoder>();
+    auto adapter = filter->videoDecoder_;
+    adapter->mediaCodec_ = decoder;
+    // the previous frame was rendered long before this one
+    adapter->currentTime_ = adapter->GetCurrentMillisecond() - FORCED_LAG_MS;
+    adapter->ReleaseOutputBuffer(0, true);
+    adapter->skippedFrameCnt_ = SKIPPED_FRAME_NUM;
+    adapter->decodeCostUs_ = DECODE_COST_US;
+    filter->discardFrameCnt_ = DISCARDED_FRAME_NUM;
+
+    int32_t lagTimes = 0;
+    int32_t maxLagDuration = 0;
+    int32_t avgLagDuration = 0;
+    VideoDropInfo dropInfo;
+    EXPECT_EQ(filter->GetLagInfo(lagTimes, maxLagDuration, avgLagDuration, dropInfo), Status::OK);
+    EXPECT_EQ(lagTimes, 1);
+    EXPECT_GE(maxLagDuration, FORCED_LAG_MS);
+    EXPECT_EQ(avgLagDuration, maxLagDuration);
+    EXPECT_EQ(dropInfo.skippedBeforeDecode, SKIPPED_FRAME_NUM);
+    EXPECT_EQ(dropInfo.droppedAfterDecode, DISCARDED_FRAME_NUM);
+    EXPECT_EQ(dropInfo.avgDecodeCostUs, DECODE_COST_US);
+}
 }  // namespace Test
 }  // namespace Media
 }  // namespace OHOS
\ No newline at end of file
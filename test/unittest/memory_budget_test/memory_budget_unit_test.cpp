@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "memory_budget.h"
+
+using namespace testing::ext;
+
+namespace {
+constexpr uint64_t KB = 1024;
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+class MemoryBudgetUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp(void) {}
+    void TearDown(void) {}
+};
+
+/**
+ * @tc.name: MemoryBudget_Charge_001
+ * @tc.desc: charges and releases propagate to every ancestor, peaks are kept
+ * @tc.type: FUNC
+ */
+HWTEST_F(MemoryBudgetUnitTest, MemoryBudget_Charge_001, TestSize.Level1)
+{
+    auto session = MemoryBudget::Create("session", 0);
+    auto demuxer = session->CreateChild("demuxer", MemoryBudget::RECLAIM_DEMUXER_CACHE);
+    auto codec = session->CreateChild("codec", MemoryBudget::RECLAIM_CODEC_BUFFER, 4 * KB);
+    EXPECT_TRUE(demuxer->Charge(10 * KB));
+    EXPECT_TRUE(codec->TryCharge(3 * KB));
+    EXPECT_EQ(session->GetUsage(), 13 * KB);
+    EXPECT_FALSE(codec->TryCharge(2 * KB));
+    EXPECT_EQ(codec->GetUsage(), 3 * KB);
+    EXPECT_FALSE(codec->Charge(2 * KB));
+    EXPECT_TRUE(codec->IsOverLimit());
+    codec->Release(5 * KB);
+    demuxer->Release(4 * KB);
+    EXPECT_EQ(session->GetUsage(), 6 * KB);
+    EXPECT_EQ(session->GetPeak(), 15 * KB);
+    EXPECT_FALSE(codec->IsOverLimit());
+}
+
+/**
+ * @tc.name: MemoryBudget_Reclaim_001
+ * @tc.desc: a charge that does not fit reclaims in ascending order and never from the charging component
+ * @tc.type: FUNC
+ */
+HWTEST_F(MemoryBudgetUnitTest, MemoryBudget_Reclaim_001, TestSize.Level1)
+{
+    auto session = MemoryBudget::Create("session", 100 * KB);
+    auto codec = session->CreateChild("codec", MemoryBudget::RECLAIM_CODEC_BUFFER);
+    auto demuxer = session->CreateChild("demuxer", MemoryBudget::RECLAIM_DEMUXER_CACHE);
+    auto http = session->CreateChild("http", MemoryBudget::RECLAIM_HTTP_CACHE);
+    std::vector<std::string> calls;
+    auto makeReclaimer = [&calls](const std::shared_ptr<MemoryBudget> &budget) {
+        return [&calls, weak = std::weak_ptr<MemoryBudget>(budget)](uint64_t bytes) -> uint64_t {
+            auto self = weak.lock();
+            uint64_t freed = std::min(bytes, self->GetUsage());
+            self->Release(freed);
+            calls.push_back(self->GetName());
+            return freed;
+        };
+    };
+    codec->SetReclaimer(makeReclaimer(codec));
+    demuxer->SetReclaimer(makeReclaimer(demuxer));
+    http->SetReclaimer(makeReclaimer(http));
+    EXPECT_TRUE(http->TryCharge(20 * KB));
+    EXPECT_TRUE(demuxer->TryCharge(30 * KB));
+    EXPECT_TRUE(codec->TryCharge(40 * KB));
+    EXPECT_TRUE(calls.empty());
+
+    // 90 KB crosses the high watermark, the session drops back to the low one from the http cache first
+    EXPECT_TRUE(codec->TryCharge(KB));
+    ASSERT_EQ(calls.size(), 1);
+    EXPECT_EQ(calls[0], "http");
+    EXPECT_EQ(session->GetUsage(), 75 * KB);
+
+    // the charge itself empties the http cache and takes the rest from the demuxer, which then covers the watermark
+    calls.clear();
+    EXPECT_TRUE(codec->TryCharge(50 * KB));
+    ASSERT_EQ(calls.size(), 3);
+    EXPECT_EQ(calls[0], "http");
+    EXPECT_EQ(calls[1], "demuxer");
+    EXPECT_EQ(calls[2], "demuxer");
+    EXPECT_EQ(http->GetUsage(), 0);
+    EXPECT_EQ(demuxer->GetUsage(), 0);
+    EXPECT_EQ(codec->GetUsage(), 91 * KB);
+    EXPECT_FALSE(codec->TryCharge(10 * KB));
+    EXPECT_EQ(codec->GetUsage(), 91 * KB);
+}
+
+/**
+ * @tc.name: MemoryBudget_Find_001
+ * @tc.desc: session roots are found by id while alive, children release their charge when destroyed
+ * @tc.type: FUNC
+ */
+HWTEST_F(MemoryBudgetUnitTest, MemoryBudget_Find_001, TestSize.Level1)
+{
+    auto session = MemoryBudget::Create("session", 0);
+    uint64_t id = session->GetId();
+    EXPECT_EQ(MemoryBudget::Find(id), session);
+    {
+        auto child = session->CreateChild("http", MemoryBudget::RECLAIM_HTTP_CACHE);
+        child->Charge(KB);
+        std::string dump;
+        session->GetDumpInfo(dump);
+        EXPECT_NE(dump.find("http - usage: 1024"), std::string::npos);
+    }
+    EXPECT_EQ(session->GetUsage(), 0);
+    session = nullptr;
+    EXPECT_EQ(MemoryBudget::Find(id), nullptr);
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
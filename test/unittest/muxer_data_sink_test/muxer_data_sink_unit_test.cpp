@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <gtest/gtest.h>
+#include "data_sink_fd.h"
+#include "write_behind_sink.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+
+namespace {
+const std::string TEST_FILE = "/data/test/media/muxer_data_sink_test.dat";
+constexpr uint32_t RANDOM_SEED = 20240101;
+constexpr uint32_t FUZZ_OPS = 5000;
+constexpr uint32_t FUZZ_MAX_WRITE = 2048;
+constexpr int32_t FAIL_AFTER_WRITES = 3;
+constexpr int32_t SMALL_CHUNK = 4 * 1024; // the old avio buffer
+constexpr int32_t LARGE_CHUNK = 256 * 1024; // the new default avio buffer
+constexpr int32_t BENCH_FILE_SIZE = 64 * 1024 * 1024;
+constexpr int32_t BENCH_FRAME_SIZE = 200 * 1024;
+constexpr int32_t BENCH_FRAME_COUNT = 200;
+constexpr auto BENCH_ENCODE_TIME = std::chrono::milliseconds(2);
+constexpr auto SLOW_DISK_WRITE_TIME = std::chrono::milliseconds(2);
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+// in memory sink with the seek semantics of DataSinkFd, optionally slow or failing
+class MemorySink : public Plugins::DataSink {
+public:
+    int32_t Read(uint8_t *buf, int32_t bufSize) override
+    {
+        int32_t size = std::max<int32_t>(0, std::min<int32_t>(bufSize, static_cast<int32_t>(data_.size()) - pos_));
+        std::copy(data_.begin() + pos_, data_.begin() + pos_ + size, buf);
+        pos_ += size;
+        return size;
+    }
+    int32_t Write(const uint8_t *buf, int32_t bufSize) override
+    {
+        writeCount_++;
+        if (failAfter_ >= 0 && writeCount_ > failAfter_) {
+            return -1;
+        }
+        if (writeTime_.count() > 0) {
+            std::this_thread::sleep_for(writeTime_);
+        }
+        if (data_.size() < static_cast<size_t>(pos_ + bufSize)) {
+            data_.resize(pos_ + bufSize);
+        }
+        std::copy(buf, buf + bufSize, data_.begin() + pos_);
+        pos_ += bufSize;
+        return bufSize;
+    }
+    int64_t Seek(int64_t offset, int whence) override
+    {
+        pos_ = whence == SEEK_END ? static_cast<int64_t>(data_.size()) + offset :
+            (whence == SEEK_CUR ? pos_ + offset : offset);
+        return pos_;
+    }
+    int64_t GetCurrentPosition() const override
+    {
+        return pos_;
+    }
+    bool CanRead() override
+    {
+        return true;
+    }
+
+    std::vector<uint8_t> data_;
+    int64_t pos_ {0};
+    int32_t writeCount_ {0};
+    int32_t failAfter_ {-1};
+    std::chrono::milliseconds writeTime_ {0};
+};
+
+double MuxFrames(Plugins::DataSink &sink, std::function<void()> flush)
+{
+    std::vector<uint8_t> frame(BENCH_FRAME_SIZE, 0x5a);
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < BENCH_FRAME_COUNT; i++) {
+        std::this_thread::sleep_for(BENCH_ENCODE_TIME); // the muxer thread waiting for the next encoded frame
+        EXPECT_EQ(sink.Write(frame.data(), BENCH_FRAME_SIZE), BENCH_FRAME_SIZE);
+    }
+    flush();
+    std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+    return cost.count();
+}
+
+double WriteFile(int32_t chunkSize, int32_t &writeCount)
+{
+    int32_t fd = open(TEST_FILE.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    EXPECT_GE(fd, 0);
+    std::vector<uint8_t> chunk(chunkSize, 0x5a);
+    writeCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        DataSinkFd sink(fd);
+        for (int32_t written = 0; written < BENCH_FILE_SIZE; written += chunkSize) {
+            EXPECT_EQ(sink.Write(chunk.data(), chunkSize), chunkSize);
+            writeCount++;
+        }
+    }
+    std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+    close(fd);
+    return BENCH_FILE_SIZE / BYTES_PER_MB / cost.count();
+}
+} // namespace
+
+namespace OHOS {
+namespace Media {
+class MuxerDataSinkUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void)
+    {
+        unlink(TEST_FILE.c_str());
+    }
+    void SetUp() {}
+    void TearDown() {}
+};
+
+/**
+ * @tc.name: WriteBehindSink_001
+ * @tc.desc: random writes, seeks and reads through the write behind sink match a direct sink
+ * @tc.type: FUNC
+ */
+HWTEST_F(MuxerDataSinkUnitTest, WriteBehindSink_001, TestSize.Level1)
+{
+    std::mt19937 rng(RANDOM_SEED);
+    std::uniform_int_distribution<int32_t> op(0, 9);
+    std::uniform_int_distribution<int32_t> length(0, FUZZ_MAX_WRITE);
+    auto inner = std::make_shared<MemorySink>();
+    MemorySink direct;
+    {
+        auto sink = std::make_shared<WriteBehindSink>(inner);
+        std::vector<uint8_t> buf(FUZZ_MAX_WRITE);
+        std::vector<uint8_t> expect(FUZZ_MAX_WRITE);
+        for (uint32_t i = 0; i < FUZZ_OPS; i++) {
+            int32_t kind = op(rng);
+            int32_t size = length(rng);
+            if (kind < 6) { // 6: mostly writes, as a muxer does
+                std::generate(buf.begin(), buf.begin() + size, [&rng] { return static_cast<uint8_t>(rng()); });
+                ASSERT_EQ(direct.Write(buf.data(), size), sink->Write(buf.data(), size));
+            } else if (kind < 8) { // 8: seek back to patch an earlier box
+                int64_t pos = direct.data_.empty() ? 0 : static_cast<int64_t>(rng() % direct.data_.size());
+                ASSERT_EQ(direct.Seek(pos, SEEK_SET), sink->Seek(pos, SEEK_SET));
+            } else if (kind < 9) { // 9: back to the end
+                ASSERT_EQ(direct.Seek(0, SEEK_END), sink->Seek(0, SEEK_END));
+            } else {
+                int32_t expectSize = direct.Read(expect.data(), size);
+                ASSERT_EQ(expectSize, sink->Read(buf.data(), size));
+                ASSERT_TRUE(std::equal(expect.begin(), expect.begin() + expectSize, buf.begin()));
+            }
+            ASSERT_EQ(direct.GetCurrentPosition(), sink->GetCurrentPosition());
+        }
+        ASSERT_EQ(sink->Flush(), 0);
+    }
+    EXPECT_EQ(direct.data_, inner->data_);
+}
+
+/**
+ * @tc.name: WriteBehindSink_002
+ * @tc.desc: a failed write shows up in a later write and in flush
+ * @tc.type: FUNC
+ */
+HWTEST_F(MuxerDataSinkUnitTest, WriteBehindSink_002, TestSize.Level1)
+{
+    auto inner = std::make_shared<MemorySink>();
+    inner->failAfter_ = FAIL_AFTER_WRITES;
+    auto sink = std::make_shared<WriteBehindSink>(inner, 1);
+    std::vector<uint8_t> buf(SMALL_CHUNK);
+    for (int32_t i = 0; i <= FAIL_AFTER_WRITES; i++) {
+        EXPECT_EQ(sink->Write(buf.data(), SMALL_CHUNK), SMALL_CHUNK);
+    }
+    EXPECT_EQ(sink->Flush(), -1);
+    EXPECT_EQ(sink->Write(buf.data(), SMALL_CHUNK), -1);
+    EXPECT_EQ(sink->Read(buf.data(), SMALL_CHUNK), -1);
+}
+
+/**
+ * @tc.name: DataSinkFd_001
+ * @tc.desc: positioned writes and reads keep the seek semantics
+ * @tc.type: FUNC
+ */
+HWTEST_F(MuxerDataSinkUnitTest, DataSinkFd_001, TestSize.Level1)
+{
+    int32_t fd = open(TEST_FILE.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    DataSinkFd sink(fd);
+    close(fd);
+    const uint8_t head[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    const uint8_t patch[] = {9, 9};
+    ASSERT_EQ(sink.Write(head, sizeof(head)), static_cast<int32_t>(sizeof(head)));
+    ASSERT_EQ(sink.Seek(2, SEEK_SET), 2); // 2: patch in the middle
+    ASSERT_EQ(sink.Write(patch, sizeof(patch)), static_cast<int32_t>(sizeof(patch)));
+    EXPECT_EQ(sink.GetCurrentPosition(), 4); // 4: right after the patch
+    ASSERT_EQ(sink.Seek(0, SEEK_SET), 0);
+    uint8_t out[sizeof(head)] = {0};
+    ASSERT_EQ(sink.Read(out, sizeof(out)), static_cast<int32_t>(sizeof(out)));
+    const uint8_t expect[] = {1, 2, 9, 9, 5, 6, 7, 8};
+    EXPECT_TRUE(std::equal(out, out + sizeof(out), expect));
+    EXPECT_EQ(sink.Read(out, sizeof(out)), 0);
+}
+
+/**
+ * @tc.name: MuxerDataSink_Perf_001
+ * @tc.desc: write syscalls and throughput of the old 4 KiB avio buffer against the new 256 KiB one
+ * @tc.type: PERF
+ */
+HWTEST_F(MuxerDataSinkUnitTest, MuxerDataSink_Perf_001, TestSize.Level3)
+{
+    int32_t smallCount = 0;
+    int32_t largeCount = 0;
+    double small = WriteFile(SMALL_CHUNK, smallCount);
+    double large = WriteFile(LARGE_CHUNK, largeCount);
+    std::cout << "data sink fd MB/s, 4 KiB: " << small << " (" << smallCount << " writes), 256 KiB: " << large
+              << " (" << largeCount << " writes)" << std::endl;
+    EXPECT_EQ(smallCount, BENCH_FILE_SIZE / SMALL_CHUNK);
+    EXPECT_EQ(largeCount, BENCH_FILE_SIZE / LARGE_CHUNK);
+}
+
+/**
+ * @tc.name: MuxerDataSink_Perf_002
+ * @tc.desc: muxing onto a slow disk, writing on the muxer thread against writing behind it
+ * @tc.type: PERF
+ */
+HWTEST_F(MuxerDataSinkUnitTest, MuxerDataSink_Perf_002, TestSize.Level3)
+{
+    MemorySink direct;
+    direct.writeTime_ = SLOW_DISK_WRITE_TIME;
+    double directCost = MuxFrames(direct, [] {});
+
+    auto inner = std::make_shared<MemorySink>();
+    inner->writeTime_ = SLOW_DISK_WRITE_TIME;
+    auto sink = std::make_shared<WriteBehindSink>(inner);
+    double behindCost = MuxFrames(*sink, [&sink] { EXPECT_EQ(sink->Flush(), 0); });
+    std::cout << "slow disk mux of " << BENCH_FRAME_COUNT << " frames, direct: " << directCost
+              << " s, write behind: " << behindCost << " s" << std::endl;
+    EXPECT_EQ(direct.data_, inner->data_);
+}
+} // namespace Media
+} // namespace OHOS
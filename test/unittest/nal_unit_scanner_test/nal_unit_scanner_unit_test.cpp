@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "nal_unit_scanner.h"
+
+using namespace testing::ext;
+using namespace OHOS::MediaAVCodec;
+
+namespace {
+constexpr uint32_t FUZZ_ROUNDS = 2000;
+constexpr uint32_t FUZZ_MAX_SIZE = 300;
+constexpr uint32_t RANDOM_SEED = 20240101;
+constexpr uint32_t BENCH_AU_SIZE = 512 * 1024; // a typical 4K hevc access unit
+constexpr uint32_t BENCH_AU_COUNT = 64;
+constexpr uint32_t BENCH_ROUNDS = 20;
+constexpr uint32_t BENCH_SLICE_COUNT = 8;
+constexpr double BYTES_PER_GB = 1024.0 * 1024.0 * 1024.0;
+constexpr uint32_t FUZZ_MAX_NAL_COUNT = 6;
+constexpr uint32_t FUZZ_MAX_NAL_SIZE = 64;
+constexpr uint32_t MUX_FPS = 60;
+constexpr uint32_t MUX_SECONDS = 60;
+constexpr uint32_t MUX_IDR_SIZE = 1024 * 1024; // 4K60 hevc at about 60 Mbps, one idr per second
+constexpr uint32_t MUX_P_SIZE = 112 * 1024;
+constexpr uint8_t START_CODE[] = {0x00, 0x00, 0x01};
+
+uint32_t NaiveFindStartCode(const uint8_t *data, uint32_t size, uint32_t pos)
+{
+    for (uint32_t i = pos; i + 2 < size; i++) {
+        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) {
+            return i;
+        }
+    }
+    return size;
+}
+
+// random bytes biased towards 0 and 1 so that start codes and near misses are frequent
+std::vector<uint8_t> MakeFuzzBuffer(std::mt19937 &rng, uint32_t size)
+{
+    std::vector<uint8_t> buf(size);
+    std::uniform_int_distribution<int> pick(0, 7);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (auto &b : buf) {
+        int p = pick(rng);
+        b = p < 3 ? 0 : (p < 5 ? 1 : static_cast<uint8_t>(byte(rng)));
+    }
+    return buf;
+}
+
+// well formed annex-b: no payload holds two zeros in a row or ends with a zero, start codes are 3 or 4 bytes
+std::vector<uint8_t> MakeAnnexbAccessUnit(std::mt19937 &rng, uint32_t nalCount, uint32_t maxNalSize,
+    bool allLongStartCodes)
+{
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<uint32_t> nalSize(1, maxNalSize);
+    std::vector<uint8_t> au;
+    for (uint32_t i = 0; i < nalCount; i++) {
+        if (allLongStartCodes || byte(rng) % 2 == 0) {
+            au.push_back(0);
+        }
+        au.insert(au.end(), {0, 0, 1});
+        uint32_t size = nalSize(rng);
+        for (uint32_t j = 0; j < size; j++) {
+            uint8_t b = static_cast<uint8_t>(byte(rng));
+            au.push_back((b == 0 && (j == 0 || j + 1 == size || au.back() == 0)) ? 0x80 : b);
+        }
+    }
+    return au;
+}
+
+// the conversion FFmpegMuxerPlugin used before the scanner, kept as reference and benchmark baseline
+std::vector<uint8_t> LegacyAnnexbToMp4(const uint8_t *sample, int32_t size)
+{
+    auto findNalStartCode = [](const uint8_t *buf, const uint8_t *end, int32_t &startCodeLen) {
+        startCodeLen = sizeof(START_CODE);
+        auto *iter = std::search(buf, end, START_CODE, START_CODE + startCodeLen);
+        if (iter != end && iter > buf && *(iter - 1) == 0x00) {
+            ++startCodeLen;
+            return iter - 1;
+        }
+        return iter;
+    };
+    std::vector<uint8_t> data;
+    const uint8_t *end = sample + size;
+    int32_t startCodeLen = 0;
+    const uint8_t *nalStart = findNalStartCode(sample, end, startCodeLen) + startCodeLen;
+    while (nalStart < end) {
+        const uint8_t *nalEnd = findNalStartCode(nalStart, end, startCodeLen);
+        uint32_t naluSize = static_cast<uint32_t>(nalEnd - nalStart);
+        for (int32_t i = sizeof(naluSize) - 1; i >= 0; --i) {
+            data.emplace_back((naluSize >> (i * 0x08)) & 0xFF);
+        }
+        data.insert(data.end(), nalStart, nalEnd);
+        nalStart = nalEnd + startCodeLen;
+    }
+    return data;
+}
+
+std::vector<uint8_t> MakeAccessUnit(std::mt19937 &rng, uint32_t size)
+{
+    std::vector<uint8_t> buf(size);
+    std::uniform_int_distribution<int> byte(2, 255);
+    for (auto &b : buf) {
+        b = static_cast<uint8_t>(byte(rng));
+    }
+    uint32_t sliceSize = size / BENCH_SLICE_COUNT;
+    for (uint32_t i = 0; i < BENCH_SLICE_COUNT; i++) {
+        uint32_t pos = i * sliceSize;
+        buf[pos] = 0;
+        buf[pos + 1] = 0;
+        buf[pos + 2] = 0;
+        buf[pos + 3] = 1;
+    }
+    return buf;
+}
+} // namespace
+
+namespace OHOS {
+namespace MediaAVCodec {
+class NalUnitScannerUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp(void) {}
+    void TearDown(void) {}
+};
+
+/**
+ * @tc.name: NalUnitScanner_FindStartCode_001
+ * @tc.desc: simd and scalar search agree with a naive byte search on random buffers
+ * @tc.type: FUNC
+ */
+HWTEST_F(NalUnitScannerUnitTest, NalUnitScanner_FindStartCode_001, TestSize.Level1)
+{
+    std::mt19937 rng(RANDOM_SEED);
+    std::uniform_int_distribution<uint32_t> sizeDist(0, FUZZ_MAX_SIZE);
+    for (uint32_t round = 0; round < FUZZ_ROUNDS; round++) {
+        std::vector<uint8_t> buf = MakeFuzzBuffer(rng, sizeDist(rng));
+        uint32_t size = static_cast<uint32_t>(buf.size());
+        uint32_t pos = 0;
+        while (pos < size) {
+            uint32_t expect = NaiveFindStartCode(buf.data(), size, pos);
+            ASSERT_EQ(expect, NalUnitScanner::FindStartCode(buf.data(), size, pos));
+            ASSERT_EQ(expect, NalUnitScanner::FindStartCodeScalar(buf.data(), size, pos));
+            pos = expect + 1;
+        }
+    }
+}
+
+/**
+ * @tc.name: NalUnitScanner_FindStartCode_002
+ * @tc.desc: start codes at block boundaries and at the end of the buffer
+ * @tc.type: FUNC
+ */
+HWTEST_F(NalUnitScannerUnitTest, NalUnitScanner_FindStartCode_002, TestSize.Level1)
+{
+    constexpr uint32_t size = 100;
+    for (uint32_t at = 0; at + NalUnitScanner::START_CODE_LEN <= size; at++) {
+        std::vector<uint8_t> buf(size, 0xFF);
+        buf[at] = 0;
+        buf[at + 1] = 0;
+        buf[at + 2] = 1;
+        ASSERT_EQ(at, NalUnitScanner::FindStartCode(buf.data(), size, 0));
+        ASSERT_EQ(size, NalUnitScanner::FindStartCode(buf.data(), size, at + 1));
+    }
+    EXPECT_EQ(0u, NalUnitScanner::FindStartCode(nullptr, 0, 0));
+    uint8_t tiny[] = {0, 0};
+    EXPECT_EQ(sizeof(tiny), NalUnitScanner::FindStartCode(tiny, sizeof(tiny), 0));
+}
+
+/**
+ * @tc.name: NalUnitScanner_Scan_001
+ * @tc.desc: scan reports 3 and 4 byte start codes and the header byte of each nal unit
+ * @tc.type: FUNC
+ */
+HWTEST_F(NalUnitScannerUnitTest, NalUnitScanner_Scan_001, TestSize.Level1)
+{
+    std::vector<uint8_t> au = {
+        0x00, 0x00, 0x00, 0x01, 0x40, 0x01, 0x0C, // vps, 4 byte start code
+        0x00, 0x00, 0x01, 0x42, 0x01, 0x01,       // sps, 3 byte start code
+        0x00, 0x00, 0x00, 0x01, 0x26, 0x01, 0xAF, // idr slice
+        0x00, 0x00, 0x01,                         // trailing start code without header
+    };
+    std::vector<NalUnitInfo> nalUnits;
+    ASSERT_EQ(3u, NalUnitScanner::Scan(au.data(), static_cast<uint32_t>(au.size()), nalUnits));
+    EXPECT_EQ(0u, nalUnits[0].startCodePos);
+    EXPECT_EQ(4u, nalUnits[0].startCodeLen);
+    EXPECT_EQ(0x40, nalUnits[0].header);
+    EXPECT_EQ(7u, nalUnits[1].startCodePos);
+    EXPECT_EQ(3u, nalUnits[1].startCodeLen);
+    EXPECT_EQ(0x42, nalUnits[1].header);
+    EXPECT_EQ(13u, nalUnits[2].startCodePos);
+    EXPECT_EQ(4u, nalUnits[2].startCodeLen);
+    EXPECT_EQ(17u, nalUnits[2].headerPos);
+    EXPECT_EQ(0x26, nalUnits[2].header);
+}
+
+/**
+ * @tc.name: NalUnitScanner_LengthPrefixed_001
+ * @tc.desc: in place and copying conversion match the legacy muxer conversion, start codes are restored
+ * @tc.type: FUNC
+ */
+HWTEST_F(NalUnitScannerUnitTest, NalUnitScanner_LengthPrefixed_001, TestSize.Level1)
+{
+    std::mt19937 rng(RANDOM_SEED);
+    std::uniform_int_distribution<uint32_t> nalCount(1, FUZZ_MAX_NAL_COUNT);
+    std::vector<NalUnitInfo> nalUnits;
+    std::vector<uint8_t> scratch;
+    for (uint32_t round = 0; round < FUZZ_ROUNDS; round++) {
+        std::vector<uint8_t> au = MakeAnnexbAccessUnit(rng, nalCount(rng), FUZZ_MAX_NAL_SIZE, round % 2 == 0);
+        uint32_t size = static_cast<uint32_t>(au.size());
+        std::vector<uint8_t> expect = LegacyAnnexbToMp4(au.data(), static_cast<int32_t>(size));
+        ASSERT_GT(NalUnitScanner::Scan(au.data(), size, nalUnits), 0u);
+
+        uint32_t outSize = NalUnitScanner::ToLengthPrefixed(au.data(), size, nalUnits, scratch);
+        ASSERT_EQ(expect.size(), outSize);
+        ASSERT_TRUE(std::equal(expect.begin(), expect.end(), scratch.begin()));
+
+        std::vector<uint8_t> original = au;
+        bool allLong = std::all_of(nalUnits.begin(), nalUnits.end(),
+            [](const NalUnitInfo &nal) { return nal.startCodeLen == 4; }); // 4: long start code
+        ASSERT_EQ(allLong, NalUnitScanner::ToLengthPrefixedInPlace(au.data(), size, nalUnits));
+        if (allLong) {
+            ASSERT_TRUE(std::equal(expect.begin(), expect.end(), au.begin() + nalUnits.front().startCodePos));
+            NalUnitScanner::RestoreStartCodes(au.data(), nalUnits);
+        }
+        ASSERT_EQ(original, au);
+    }
+}
+
+/**
+ * @tc.name: NalUnitScanner_Perf_001
+ * @tc.desc: start code search throughput over synthetic 4K hevc access units, reported in GB/s
+ * @tc.type: PERF
+ */
+HWTEST_F(NalUnitScannerUnitTest, NalUnitScanner_Perf_001, TestSize.Level3)
+{
+    std::mt19937 rng(RANDOM_SEED);
+    std::vector<std::vector<uint8_t>> aus;
+    for (uint32_t i = 0; i < BENCH_AU_COUNT; i++) {
+        aus.emplace_back(MakeAccessUnit(rng, BENCH_AU_SIZE));
+    }
+    auto measure = [&aus](uint32_t (*find)(const uint8_t *, uint32_t, uint32_t)) {
+        size_t found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+            for (const auto &au : aus) {
+                uint32_t pos = find(au.data(), BENCH_AU_SIZE, 0);
+                while (pos < BENCH_AU_SIZE) {
+                    found++;
+                    pos = find(au.data(), BENCH_AU_SIZE, pos + NalUnitScanner::START_CODE_LEN);
+                }
+            }
+        }
+        std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(static_cast<size_t>(BENCH_ROUNDS) * BENCH_AU_COUNT * BENCH_SLICE_COUNT, found);
+        double bytes = static_cast<double>(BENCH_ROUNDS) * BENCH_AU_COUNT * BENCH_AU_SIZE;
+        return cost.count() > 0 ? bytes / BYTES_PER_GB / cost.count() : 0.0;
+    };
+    double scalar = measure(NalUnitScanner::FindStartCodeScalar);
+    double simd = measure(NalUnitScanner::FindStartCode);
+    double naive = measure(NaiveFindStartCode);
+    std::cout << "start code search GB/s, naive: " << naive << ", scalar: " << scalar << ", simd: " << simd
+              << std::endl;
+}
+
+/**
+ * @tc.name: NalUnitScanner_Perf_002
+ * @tc.desc: annex-b to length prefixed cost of 60 s of 4K60 hevc as the muxer writes it, legacy copy vs in place
+ * @tc.type: PERF
+ */
+HWTEST_F(NalUnitScannerUnitTest, NalUnitScanner_Perf_002, TestSize.Level3)
+{
+    std::mt19937 rng(RANDOM_SEED);
+    // one gop of distinct frames, replayed for every second of the recording
+    std::vector<std::vector<uint8_t>> gop;
+    gop.emplace_back(MakeAccessUnit(rng, MUX_IDR_SIZE));
+    for (uint32_t i = 1; i < MUX_FPS; i++) {
+        gop.emplace_back(MakeAccessUnit(rng, MUX_P_SIZE));
+    }
+    double bytes = 0;
+    for (const auto &frame : gop) {
+        bytes += static_cast<double>(frame.size()) * MUX_SECONDS;
+    }
+    volatile uint8_t sink = 0;
+    auto measure = [&gop, &sink](auto &&convert) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t second = 0; second < MUX_SECONDS; second++) {
+            for (auto &frame : gop) {
+                sink = sink + convert(frame);
+            }
+        }
+        std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+        return cost.count();
+    };
+    double legacy = measure([](std::vector<uint8_t> &frame) {
+        std::vector<uint8_t> converted = LegacyAnnexbToMp4(frame.data(), static_cast<int32_t>(frame.size()));
+        // the legacy path copied the result once more into a new AVBuffer
+        std::vector<uint8_t> packet(converted.begin(), converted.end());
+        return packet[0];
+    });
+    std::vector<NalUnitInfo> nalUnits;
+    double inPlace = measure([&nalUnits](std::vector<uint8_t> &frame) {
+        uint32_t size = static_cast<uint32_t>(frame.size());
+        NalUnitScanner::Scan(frame.data(), size, nalUnits);
+        EXPECT_TRUE(NalUnitScanner::ToLengthPrefixedInPlace(frame.data(), size, nalUnits));
+        uint8_t first = frame[nalUnits.front().startCodePos + 3]; // 3: low byte of the first nal size
+        NalUnitScanner::RestoreStartCodes(frame.data(), nalUnits);
+        return first;
+    });
+    std::vector<uint8_t> scratch;
+    double scratchCopy = measure([&nalUnits, &scratch](std::vector<uint8_t> &frame) {
+        uint32_t size = static_cast<uint32_t>(frame.size());
+        NalUnitScanner::Scan(frame.data(), size, nalUnits);
+        NalUnitScanner::ToLengthPrefixed(frame.data(), size, nalUnits, scratch);
+        return scratch[3]; // 3: low byte of the first nal size
+    });
+    std::cout << "annexb rewrite of " << MUX_SECONDS << " s 4K" << MUX_FPS << " (" << bytes / BYTES_PER_GB
+              << " GB), legacy: " << legacy << " s, in place: " << inPlace << " s, scratch: " << scratchCopy
+              << " s" << std::endl;
+}
+} // namespace MediaAVCodec
+} // namespace OHOS
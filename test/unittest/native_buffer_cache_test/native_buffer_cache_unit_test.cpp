@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <gtest/gtest.h>
+#include "buffer/avallocator.h"
+#include "native_buffer_cache.h"
+
+using namespace testing::ext;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace OHOS::MediaAVCodec;
+
+namespace {
+constexpr uint32_t BUFFER_NUM = 8;
+constexpr int32_t BUFFER_SIZE = 1024;
+constexpr uint32_t OVERFLOW_INDEX = NativeAVBufferCache::SLOT_NUM + 10;
+constexpr uint32_t BENCH_CALLBACK_NUM = 1000000;
+constexpr uint32_t STRESS_THREAD_NUM = 4;
+constexpr uint32_t STRESS_CALLBACK_NUM = 100000;
+
+/**
+ * Stands in for a codec server: owns a fixed pool of buffers and fires buffer callbacks in round-robin order, the way
+ * a decoder running at high frame rate does.
+ */
+class FakeCodec {
+public:
+    explicit FakeCodec(uint32_t bufferNum)
+    {
+        auto allocator = AVAllocatorFactory::CreateSharedAllocator(MemoryFlag::MEMORY_READ_WRITE);
+        for (uint32_t i = 0; i < bufferNum; ++i) {
+            buffers_.emplace_back(AVBuffer::CreateAVBuffer(allocator, BUFFER_SIZE));
+        }
+    }
+
+    template <typename Callback>
+    void Fire(uint32_t callbackNum, Callback &&onBufferAvailable)
+    {
+        for (uint32_t i = 0; i < callbackNum; ++i) {
+            uint32_t index = i % buffers_.size();
+            onBufferAvailable(index, buffers_[index]);
+        }
+    }
+
+    std::shared_ptr<AVBuffer> &GetBuffer(uint32_t index)
+    {
+        return buffers_[index];
+    }
+
+private:
+    std::vector<std::shared_ptr<AVBuffer>> buffers_;
+};
+
+// The per-index map guarded by a shared_mutex that the C API used before, kept as the benchmark baseline
+class MapBufferCache {
+public:
+    OH_AVBuffer *FindOrCreate(uint32_t index, std::shared_ptr<AVBuffer> &buffer)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto iter = map_.find(index);
+            if (iter != map_.end() && iter->second->IsEqualBuffer(buffer)) {
+                return iter->second.GetRefPtr();
+            }
+        }
+        sptr<OH_AVBuffer> object = new (std::nothrow) OH_AVBuffer(buffer);
+        std::lock_guard<std::shared_mutex> lock(mutex_);
+        map_[index] = object;
+        return object.GetRefPtr();
+    }
+
+private:
+    std::unordered_map<uint32_t, sptr<OH_AVBuffer>> map_;
+    std::shared_mutex mutex_;
+};
+
+template <typename Cache>
+double MeasureNsPerCallback(FakeCodec &codec, Cache &cache)
+{
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    codec.Fire(BENCH_CALLBACK_NUM, [&cache, &checksum](uint32_t index, std::shared_ptr<AVBuffer> &buffer) {
+        checksum += reinterpret_cast<uintptr_t>(cache.FindOrCreate(index, buffer));
+    });
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_NE(checksum, 0);
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) /
+           BENCH_CALLBACK_NUM;
+}
+
+class NativeBufferCacheUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp(void) {}
+    void TearDown(void) {}
+};
+
+/**
+ * @tc.name: NativeBufferCache_FindOrCreate_001
+ * @tc.desc: the same buffer at the same index always maps to the same wrapper
+ * @tc.type: FUNC
+ */
+HWTEST_F(NativeBufferCacheUnitTest, NativeBufferCache_FindOrCreate_001, TestSize.Level1)
+{
+    FakeCodec codec(BUFFER_NUM);
+    NativeAVBufferCache cache;
+    std::vector<OH_AVBuffer *> first(BUFFER_NUM, nullptr);
+    codec.Fire(BUFFER_NUM, [&cache, &first](uint32_t index, std::shared_ptr<AVBuffer> &buffer) {
+        first[index] = cache.FindOrCreate(index, buffer);
+        ASSERT_NE(first[index], nullptr);
+        EXPECT_TRUE(first[index]->IsEqualBuffer(buffer));
+    });
+    codec.Fire(BUFFER_NUM * BUFFER_NUM, [&cache, &first](uint32_t index, std::shared_ptr<AVBuffer> &buffer) {
+        EXPECT_EQ(cache.FindOrCreate(index, buffer), first[index]);
+        EXPECT_EQ(cache.Find(index), first[index]);
+    });
+}
+
+/**
+ * @tc.name: NativeBufferCache_FindOrCreate_002
+ * @tc.desc: a new buffer behind a known index gets a new wrapper and the old one is invalidated
+ * @tc.type: FUNC
+ */
+HWTEST_F(NativeBufferCacheUnitTest, NativeBufferCache_FindOrCreate_002, TestSize.Level1)
+{
+    FakeCodec codec(BUFFER_NUM);
+    NativeAVBufferCache cache;
+    OH_AVBuffer *oldObject = cache.FindOrCreate(0, codec.GetBuffer(0));
+    ASSERT_NE(oldObject, nullptr);
+
+    OH_AVBuffer *newObject = cache.FindOrCreate(0, codec.GetBuffer(1));
+    ASSERT_NE(newObject, nullptr);
+    EXPECT_NE(newObject, oldObject);
+    EXPECT_TRUE(newObject->IsEqualBuffer(codec.GetBuffer(1)));
+    EXPECT_EQ(oldObject->magic_, MFMagic::MFMAGIC_UNKNOWN);
+    EXPECT_EQ(oldObject->buffer_, nullptr);
+    EXPECT_EQ(cache.Find(0, codec.GetBuffer(0)), nullptr);
+}
+
+/**
+ * @tc.name: NativeBufferCache_FindOrCreate_003
+ * @tc.desc: wrappers replaced more often than the retire bound stay readable until clear
+ * @tc.type: FUNC
+ */
+HWTEST_F(NativeBufferCacheUnitTest, NativeBufferCache_FindOrCreate_003, TestSize.Level1)
+{
+    FakeCodec codec(BUFFER_NUM);
+    NativeAVBufferCache cache;
+    OH_AVBuffer *firstObject = cache.FindOrCreate(0, codec.GetBuffer(0));
+    ASSERT_NE(firstObject, nullptr);
+    OH_AVBuffer *lastObject = firstObject;
+    for (uint32_t i = 1; i <= NativeAVBufferCache::MAX_RETIRED_NUM + BUFFER_NUM; ++i) {
+        lastObject = cache.FindOrCreate(0, codec.GetBuffer(i % BUFFER_NUM));
+        ASSERT_NE(lastObject, nullptr);
+    }
+    EXPECT_EQ(firstObject->magic_, MFMagic::MFMAGIC_UNKNOWN);
+    EXPECT_EQ(firstObject->buffer_, nullptr);
+    EXPECT_EQ(cache.Find(0), lastObject);
+}
+
+/**
+ * @tc.name: NativeBufferCache_Clear_001
+ * @tc.desc: clear invalidates every wrapper, including the ones beyond the flat slots
+ * @tc.type: FUNC
+ */
+HWTEST_F(NativeBufferCacheUnitTest, NativeBufferCache_Clear_001, TestSize.Level1)
+{
+    FakeCodec codec(BUFFER_NUM);
+    NativeAVBufferCache cache;
+    OH_AVBuffer *slotObject = cache.FindOrCreate(1, codec.GetBuffer(1));
+    OH_AVBuffer *overflowObject = cache.FindOrCreate(OVERFLOW_INDEX, codec.GetBuffer(2));
+    ASSERT_NE(slotObject, nullptr);
+    ASSERT_NE(overflowObject, nullptr);
+    EXPECT_EQ(cache.FindOrCreate(OVERFLOW_INDEX, codec.GetBuffer(2)), overflowObject);
+
+    cache.Clear();
+    EXPECT_EQ(cache.Find(1), nullptr);
+    EXPECT_EQ(cache.Find(OVERFLOW_INDEX), nullptr);
+    EXPECT_EQ(slotObject->magic_, MFMagic::MFMAGIC_UNKNOWN);
+    EXPECT_EQ(overflowObject->magic_, MFMagic::MFMAGIC_UNKNOWN);
+    EXPECT_NE(cache.FindOrCreate(1, codec.GetBuffer(1)), nullptr);
+}
+
+/**
+ * @tc.name: NativeBufferCache_Concurrent_001
+ * @tc.desc: callbacks fired from several threads agree on one wrapper per index
+ * @tc.type: FUNC
+ */
+HWTEST_F(NativeBufferCacheUnitTest, NativeBufferCache_Concurrent_001, TestSize.Level1)
+{
+    FakeCodec codec(BUFFER_NUM);
+    NativeAVBufferCache cache;
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < STRESS_THREAD_NUM; ++i) {
+        threads.emplace_back([&codec, &cache]() {
+            codec.Fire(STRESS_CALLBACK_NUM, [&cache](uint32_t index, std::shared_ptr<AVBuffer> &buffer) {
+                OH_AVBuffer *object = cache.FindOrCreate(index, buffer);
+                ASSERT_NE(object, nullptr);
+                EXPECT_TRUE(object->IsEqualBuffer(buffer));
+            });
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (uint32_t i = 0; i < BUFFER_NUM; ++i) {
+        OH_AVBuffer *object = cache.Find(i);
+        ASSERT_NE(object, nullptr);
+        EXPECT_EQ(object->magic_, MFMagic::MFMAGIC_AVBUFFER);
+    }
+}
+
+/**
+ * @tc.name: NativeBufferCache_Concurrent_002
+ * @tc.desc: data read through FindData stays valid while another thread keeps replacing the buffer behind the index
+ * @tc.type: FUNC
+ */
+HWTEST_F(NativeBufferCacheUnitTest, NativeBufferCache_Concurrent_002, TestSize.Level1)
+{
+    FakeCodec codec(BUFFER_NUM);
+    NativeAVBufferCache cache;
+    ASSERT_NE(cache.FindOrCreate(0, codec.GetBuffer(0)), nullptr);
+    std::thread replacer([&codec, &cache]() {
+        for (uint32_t i = 0; i < STRESS_CALLBACK_NUM; ++i) {
+            EXPECT_NE(cache.FindOrCreate(0, codec.GetBuffer(i % BUFFER_NUM)), nullptr);
+        }
+    });
+    for (uint32_t i = 0; i < STRESS_CALLBACK_NUM; ++i) {
+        std::shared_ptr<AVBuffer> buffer = cache.FindData(0);
+        ASSERT_NE(buffer, nullptr);
+        EXPECT_EQ(buffer->flag_, 0);
+    }
+    replacer.join();
+    EXPECT_EQ(cache.FindData(OVERFLOW_INDEX), nullptr);
+}
+
+/**
+ * @tc.name: NativeBufferCache_Perf_001
+ * @tc.desc: callback lookup cost of the lock-free slots against the map baseline
+ * @tc.type: PERF
+ */
+HWTEST_F(NativeBufferCacheUnitTest, NativeBufferCache_Perf_001, TestSize.Level3)
+{
+    FakeCodec codec(BUFFER_NUM);
+    NativeAVBufferCache cache;
+    MapBufferCache mapCache;
+    double cacheNs = MeasureNsPerCallback(codec, cache);
+    double mapNs = MeasureNsPerCallback(codec, mapCache);
+    std::cout << "callbacks: " << BENCH_CALLBACK_NUM << ", flat cache: " << cacheNs << " ns/callback, map: " << mapNs
+              << " ns/callback" << std::endl;
+    EXPECT_GT(cacheNs, 0.0);
+}
+} // namespace
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "sample_interleaver.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint32_t AUDIO_TRACK = 0;
+constexpr uint32_t VIDEO_TRACK = 1;
+constexpr uint32_t META_TRACK = 2;
+constexpr uint32_t TRACK_COUNT = 3;
+constexpr int64_t AUDIO_DURATION_US = 23220; // 1024 samples at 44.1 kHz
+constexpr int64_t VIDEO_DURATION_US = 33333;
+constexpr int64_t META_DURATION_US = 1000000;
+constexpr int64_t WINDOW_US = 500000;
+constexpr uint32_t MAX_PENDING = 32;
+constexpr int64_t MAX_JITTER_US = 200000; // encoder latency spread, well inside the window
+constexpr int64_t RECORD_DURATION_US = 20000000;
+constexpr int64_t BENCH_DURATION_US = 3600000000; // one hour
+constexpr uint32_t RANDOM_SEED = 20240101;
+constexpr uint32_t GOP_B_FRAMES = 2;
+
+struct Arrival {
+    int64_t time;
+    uint32_t track;
+    std::shared_ptr<AVBuffer> sample;
+};
+
+std::shared_ptr<AVBuffer> CreateSample(int64_t pts)
+{
+    std::shared_ptr<AVBuffer> sample = AVBuffer::CreateAVBuffer();
+    sample->pts_ = pts;
+    return sample;
+}
+
+// pts of one IBBP group of video frames in decode order, the B-frames follow the P-frame they reference
+int64_t VideoPts(int64_t frame)
+{
+    int64_t group = frame / (GOP_B_FRAMES + 1);
+    int64_t pos = frame % (GOP_B_FRAMES + 1);
+    int64_t display = pos == 0 ? group * (GOP_B_FRAMES + 1) + GOP_B_FRAMES : group * (GOP_B_FRAMES + 1) + pos - 1;
+    return display * VIDEO_DURATION_US;
+}
+
+// audio, b-frame video and sparse timed metadata, every track arriving with its own random latency
+std::vector<Arrival> CreateArrivals(int64_t durationUs, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int64_t> jitter(0, MAX_JITTER_US);
+    std::vector<Arrival> arrivals;
+    auto addTrack = [&](uint32_t track, int64_t step, bool reorder) {
+        int64_t lastTime = 0;
+        for (int64_t i = 0; i * step < durationUs; i++) {
+            int64_t pts = reorder ? VideoPts(i) : i * step;
+            // a track delivers in decode order, later samples never overtake earlier ones
+            lastTime = std::max(lastTime, i * step + jitter(rng));
+            arrivals.push_back({lastTime, track, CreateSample(pts)});
+        }
+    };
+    addTrack(AUDIO_TRACK, AUDIO_DURATION_US, false);
+    addTrack(VIDEO_TRACK, VIDEO_DURATION_US, true);
+    addTrack(META_TRACK, META_DURATION_US, false);
+    std::stable_sort(arrivals.begin(), arrivals.end(),
+        [](const Arrival &a, const Arrival &b) { return a.time < b.time; });
+    return arrivals;
+}
+
+// drives the interleaver like the muxer writer thread, samples of a full track wait in its queue
+std::vector<std::pair<uint32_t, int64_t>> Interleave(const std::vector<Arrival> &arrivals)
+{
+    SampleInterleaver interleaver(TRACK_COUNT, WINDOW_US, MAX_PENDING);
+    std::vector<std::deque<std::shared_ptr<AVBuffer>>> queues(TRACK_COUNT);
+    std::vector<std::pair<uint32_t, int64_t>> output;
+    auto pull = [&]() {
+        for (uint32_t i = 0; i < TRACK_COUNT; i++) {
+            while (!queues[i].empty() && !interleaver.IsFull(i)) {
+                interleaver.Push(i, queues[i].front());
+                queues[i].pop_front();
+            }
+        }
+    };
+    auto write = [&](bool drain) {
+        int32_t track = -1;
+        while ((track = interleaver.Next(drain)) >= 0) {
+            std::shared_ptr<AVBuffer> sample = interleaver.Pop(static_cast<uint32_t>(track));
+            output.emplace_back(static_cast<uint32_t>(track), sample->pts_);
+            pull();
+        }
+    };
+    for (const Arrival &arrival : arrivals) {
+        queues[arrival.track].push_back(arrival.sample);
+        pull();
+        write(false);
+    }
+    write(true);
+    return output;
+}
+
+// the old writer loop, it wrote the smallest head as soon as any track had one
+std::vector<std::pair<uint32_t, int64_t>> GreedyInterleave(const std::vector<Arrival> &arrivals)
+{
+    std::vector<std::pair<uint32_t, int64_t>> output;
+    for (const Arrival &arrival : arrivals) {
+        output.emplace_back(arrival.track, arrival.sample->pts_);
+    }
+    return output;
+}
+
+// counts samples written after a sample of another track that starts later than they do
+int32_t CountInversions(const std::vector<std::pair<uint32_t, int64_t>> &output)
+{
+    std::vector<int64_t> lastKey(TRACK_COUNT, INT64_MIN);
+    int32_t inversions = 0;
+    for (const auto &[track, pts] : output) {
+        int64_t key = std::max(lastKey[track], pts);
+        lastKey[track] = key;
+        for (uint32_t other = 0; other < TRACK_COUNT; other++) {
+            if (other != track && lastKey[other] > key) {
+                inversions++;
+                break;
+            }
+        }
+    }
+    return inversions;
+}
+
+std::vector<int64_t> TrackPts(const std::vector<std::pair<uint32_t, int64_t>> &output, uint32_t track)
+{
+    std::vector<int64_t> pts;
+    for (const auto &item : output) {
+        if (item.first == track) {
+            pts.push_back(item.second);
+        }
+    }
+    return pts;
+}
+} // namespace
+
+class SampleInterleaverUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp(void) {};
+    void TearDown(void) {};
+};
+
+/**
+ * @tc.name: SampleInterleaver_001
+ * @tc.desc: out of order multi track arrival comes out in timestamp order, the same for every arrival order
+ * @tc.type: FUNC
+ */
+HWTEST_F(SampleInterleaverUnitTest, SampleInterleaver_001, TestSize.Level1)
+{
+    std::vector<Arrival> first = CreateArrivals(RECORD_DURATION_US, RANDOM_SEED);
+    std::vector<Arrival> second = CreateArrivals(RECORD_DURATION_US, RANDOM_SEED + 1);
+    std::vector<std::pair<uint32_t, int64_t>> output = Interleave(first);
+    ASSERT_EQ(output.size(), first.size());
+    EXPECT_EQ(CountInversions(output), 0);
+    EXPECT_EQ(Interleave(second), output);
+    for (uint32_t track = 0; track < TRACK_COUNT; track++) {
+        std::vector<int64_t> expected;
+        for (const Arrival &arrival : first) {
+            if (arrival.track == track) {
+                expected.push_back(arrival.sample->pts_);
+            }
+        }
+        EXPECT_EQ(TrackPts(output, track), expected);
+    }
+}
+
+/**
+ * @tc.name: SampleInterleaver_002
+ * @tc.desc: a track without samples only holds the others back for the look-ahead window or count
+ * @tc.type: FUNC
+ */
+HWTEST_F(SampleInterleaverUnitTest, SampleInterleaver_002, TestSize.Level1)
+{
+    SampleInterleaver byWindow(TRACK_COUNT, WINDOW_US, MAX_PENDING);
+    byWindow.Push(AUDIO_TRACK, CreateSample(0));
+    byWindow.Push(VIDEO_TRACK, CreateSample(0));
+    EXPECT_EQ(byWindow.Next(false), -1);
+    byWindow.Push(VIDEO_TRACK, CreateSample(WINDOW_US));
+    EXPECT_EQ(byWindow.Next(false), static_cast<int32_t>(AUDIO_TRACK));
+    EXPECT_NE(byWindow.Pop(AUDIO_TRACK), nullptr);
+    EXPECT_EQ(byWindow.Next(false), static_cast<int32_t>(VIDEO_TRACK));
+    EXPECT_NE(byWindow.Pop(VIDEO_TRACK), nullptr);
+    EXPECT_EQ(byWindow.Next(false), -1);
+    EXPECT_EQ(byWindow.Next(true), static_cast<int32_t>(VIDEO_TRACK));
+    EXPECT_NE(byWindow.Pop(VIDEO_TRACK), nullptr);
+    EXPECT_TRUE(byWindow.Empty());
+    EXPECT_EQ(byWindow.Pop(VIDEO_TRACK), nullptr);
+
+    const uint32_t maxPending = 2;
+    SampleInterleaver byCount(TRACK_COUNT, WINDOW_US, maxPending);
+    byCount.Push(VIDEO_TRACK, CreateSample(0));
+    EXPECT_FALSE(byCount.IsFull(VIDEO_TRACK));
+    EXPECT_EQ(byCount.Next(false), -1);
+    byCount.Push(VIDEO_TRACK, CreateSample(VIDEO_DURATION_US));
+    EXPECT_TRUE(byCount.IsFull(VIDEO_TRACK));
+    EXPECT_EQ(byCount.Next(false), static_cast<int32_t>(VIDEO_TRACK));
+}
+
+/**
+ * @tc.name: SampleInterleaver_Perf_001
+ * @tc.desc: interleaving quality and throughput of an hour of jittered input, greedy writer against interleaver
+ * @tc.type: PERF
+ */
+HWTEST_F(SampleInterleaverUnitTest, SampleInterleaver_Perf_001, TestSize.Level3)
+{
+    std::vector<Arrival> arrivals = CreateArrivals(BENCH_DURATION_US, RANDOM_SEED);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::pair<uint32_t, int64_t>> output = Interleave(arrivals);
+    std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+    int32_t greedyInversions = CountInversions(GreedyInterleave(arrivals));
+    int32_t inversions = CountInversions(output);
+    std::cout << arrivals.size() << " samples, greedy writer: " << greedyInversions << " out of order, interleaver: "
+              << inversions << " out of order, " << arrivals.size() / cost.count() << " samples/s" << std::endl;
+    ASSERT_EQ(output.size(), arrivals.size());
+    EXPECT_EQ(inversions, 0);
+    EXPECT_GT(greedyInversions, 0);
+}
+} // namespace Media
+} // namespace OHOS
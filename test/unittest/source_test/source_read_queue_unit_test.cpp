@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "source_read_queue.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+
+namespace {
+const std::string TEST_FILE = "/data/test/media/source_read_queue_test.dat";
+constexpr uint32_t RANDOM_SEED = 20240101;
+constexpr size_t FILE_SIZE = 4 * 1024 * 1024;
+constexpr size_t CHUNK = 4 * 1024;
+constexpr uint32_t RANDOM_READS = 200;
+constexpr size_t BENCH_PREFETCH_SIZE = 64 * 1024;
+constexpr uint32_t BENCH_PREFETCH_COUNT = 100;
+constexpr uint32_t BENCH_PLAYBACK_COUNT = 20;
+constexpr auto BENCH_READ_TIME = std::chrono::milliseconds(2); // an sdcard or a nearby cdn
+constexpr auto BENCH_FRAME_TIME = std::chrono::milliseconds(5);
+
+uint8_t Pattern(uint64_t offset)
+{
+    return static_cast<uint8_t>((offset * 31) ^ (offset >> 8)); // 31 spreads neighbouring bytes apart
+}
+
+// reads a local file like a source plugin does, optionally slow and holding the reads until released
+class LocalFileReader {
+public:
+    LocalFileReader()
+    {
+        int32_t fd = open(TEST_FILE.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+        EXPECT_GE(fd, 0);
+        std::vector<uint8_t> data(FILE_SIZE);
+        for (size_t i = 0; i < FILE_SIZE; i++) {
+            data[i] = Pattern(i);
+        }
+        EXPECT_EQ(write(fd, data.data(), FILE_SIZE), static_cast<ssize_t>(FILE_SIZE));
+        close(fd);
+        fd_ = open(TEST_FILE.c_str(), O_RDONLY);
+        EXPECT_GE(fd_, 0);
+    }
+    ~LocalFileReader()
+    {
+        close(fd_);
+        std::remove(TEST_FILE.c_str());
+    }
+
+    Status Read(int32_t streamID, uint64_t offset, size_t size, std::shared_ptr<Plugins::Buffer> &buffer)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            reads_.emplace_back(offset, size);
+            cond_.notify_all();
+            cond_.wait(lock, [this] { return !isHeld_; });
+        }
+        std::this_thread::sleep_for(readTime_);
+        if (offset >= FILE_SIZE) {
+            return Status::END_OF_STREAM;
+        }
+        std::vector<uint8_t> data(std::min(size, FILE_SIZE - offset));
+        ssize_t readSize = pread(fd_, data.data(), data.size(), static_cast<off_t>(offset));
+        EXPECT_EQ(readSize, static_cast<ssize_t>(data.size()));
+        if (buffer == nullptr) {
+            buffer = std::make_shared<Plugins::Buffer>();
+        }
+        auto memory = buffer->IsEmpty() ? buffer->AllocMemory(nullptr, size) : buffer->GetMemory();
+        memory->Write(data.data(), data.size(), 0);
+        return Status::OK;
+    }
+
+    SourceReadQueue::ReadFunc Func()
+    {
+        return [this](int32_t streamID, uint64_t offset, size_t size, std::shared_ptr<Plugins::Buffer> &buffer) {
+            return Read(streamID, offset, size, buffer);
+        };
+    }
+    void Hold()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isHeld_ = true;
+    }
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isHeld_ = false;
+        cond_.notify_all();
+    }
+    void WaitForReads(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this, count] { return reads_.size() >= count; });
+    }
+    std::vector<std::pair<uint64_t, size_t>> Reads()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return reads_;
+    }
+
+    std::chrono::milliseconds readTime_ {0};
+
+private:
+    int32_t fd_ {-1};
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool isHeld_ {false};
+    std::vector<std::pair<uint64_t, size_t>> reads_;
+};
+
+// collects the results of ReadAsync
+class Results {
+public:
+    SourceReadQueue::DoneCallback Callback(uint64_t offset)
+    {
+        return [this, offset](Status ret, std::shared_ptr<Plugins::Buffer> &buffer) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            results_.push_back({ offset, ret, buffer });
+            cond_.notify_all();
+        };
+    }
+    void WaitFor(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this, count] { return results_.size() >= count; });
+    }
+
+    struct Result {
+        uint64_t offset;
+        Status ret;
+        std::shared_ptr<Plugins::Buffer> buffer;
+    };
+    std::vector<Result> results_;
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+size_t DataSize(const std::shared_ptr<Plugins::Buffer> &buffer)
+{
+    return (buffer == nullptr || buffer->GetMemory() == nullptr) ? 0 : buffer->GetMemory()->GetSize();
+}
+
+bool CheckData(const std::shared_ptr<Plugins::Buffer> &buffer, uint64_t offset, size_t size)
+{
+    if (DataSize(buffer) != size) {
+        return false;
+    }
+    const uint8_t *data = buffer->GetMemory()->GetReadOnlyData();
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] != Pattern(offset + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double AveragePlaybackWait(ReadPriority priority)
+{
+    LocalFileReader reader;
+    reader.readTime_ = BENCH_READ_TIME;
+    SourceReadQueue queue(reader.Func());
+    Results results;
+    // prefetch of the whole file in scattered order, so nothing can be merged
+    for (uint32_t i = 0; i < BENCH_PREFETCH_COUNT; i++) {
+        uint64_t offset = (i * 7 % BENCH_PREFETCH_COUNT) * 2 * BENCH_PREFETCH_SIZE % FILE_SIZE; // 7 shuffles
+        queue.ReadAsync(0, offset, BENCH_PREFETCH_SIZE, nullptr, ReadPriority::PREFETCH, results.Callback(offset));
+    }
+    std::chrono::duration<double> wait(0);
+    for (uint32_t i = 0; i < BENCH_PLAYBACK_COUNT; i++) {
+        std::this_thread::sleep_for(BENCH_FRAME_TIME);
+        uint64_t offset = FILE_SIZE - (i + 1) * CHUNK - 1;
+        std::shared_ptr<Plugins::Buffer> buffer = std::make_shared<Plugins::Buffer>();
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_EQ(queue.Read(1, offset, CHUNK, buffer, priority), Status::OK);
+        wait += std::chrono::steady_clock::now() - start;
+        EXPECT_TRUE(CheckData(buffer, offset, CHUNK));
+    }
+    queue.Cancel();
+    results.WaitFor(BENCH_PREFETCH_COUNT);
+    return wait.count() / BENCH_PLAYBACK_COUNT;
+}
+} // namespace
+
+namespace OHOS {
+namespace Media {
+class SourceReadQueueUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp(void) {}
+    void TearDown(void) {}
+};
+
+/**
+ * @tc.name: SourceReadQueue_Read_001
+ * @tc.desc: blocking reads at random ranges return the data of the file, reads past its end END_OF_STREAM
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceReadQueueUnitTest, SourceReadQueue_Read_001, TestSize.Level1)
+{
+    LocalFileReader reader;
+    SourceReadQueue queue(reader.Func());
+    std::mt19937 random(RANDOM_SEED);
+    for (uint32_t i = 0; i < RANDOM_READS; i++) {
+        uint64_t offset = random() % FILE_SIZE;
+        size_t size = std::min<size_t>(random() % (4 * CHUNK) + 1, FILE_SIZE - offset); // up to 4 chunks
+        std::shared_ptr<Plugins::Buffer> buffer = std::make_shared<Plugins::Buffer>();
+        ReadPriority priority = static_cast<ReadPriority>(i % static_cast<uint32_t>(ReadPriority::COUNT));
+        ASSERT_EQ(queue.Read(0, offset, size, buffer, priority), Status::OK);
+        ASSERT_TRUE(CheckData(buffer, offset, size));
+    }
+    std::shared_ptr<Plugins::Buffer> buffer = std::make_shared<Plugins::Buffer>();
+    EXPECT_EQ(queue.Read(0, FILE_SIZE, CHUNK, buffer), Status::END_OF_STREAM);
+    EXPECT_EQ(DataSize(buffer), 0);
+}
+
+/**
+ * @tc.name: SourceReadQueue_Priority_001
+ * @tc.desc: queued reads are served playback first, then metadata, then prefetch
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceReadQueueUnitTest, SourceReadQueue_Priority_001, TestSize.Level1)
+{
+    LocalFileReader reader;
+    SourceReadQueue queue(reader.Func());
+    Results results;
+    reader.Hold();
+    queue.ReadAsync(0, 0, CHUNK, nullptr, ReadPriority::PREFETCH, results.Callback(0));
+    reader.WaitForReads(1);
+    const std::vector<std::pair<uint64_t, ReadPriority>> requests = {
+        { 10 * CHUNK, ReadPriority::PREFETCH }, { 20 * CHUNK, ReadPriority::METADATA },
+        { 30 * CHUNK, ReadPriority::PLAYBACK }, { 40 * CHUNK, ReadPriority::PREFETCH },
+        { 50 * CHUNK, ReadPriority::PLAYBACK },
+    };
+    for (auto &request : requests) {
+        queue.ReadAsync(0, request.first, CHUNK, nullptr, request.second, results.Callback(request.first));
+    }
+    reader.Release();
+    results.WaitFor(requests.size() + 1);
+    std::vector<uint64_t> order;
+    for (auto &read : reader.Reads()) {
+        order.push_back(read.first);
+    }
+    EXPECT_EQ(order, std::vector<uint64_t>({ 0, 30 * CHUNK, 50 * CHUNK, 20 * CHUNK, 10 * CHUNK, 40 * CHUNK }));
+    for (auto &result : results.results_) {
+        EXPECT_EQ(result.ret, Status::OK);
+        EXPECT_TRUE(CheckData(result.buffer, result.offset, CHUNK));
+    }
+}
+
+/**
+ * @tc.name: SourceReadQueue_Merge_001
+ * @tc.desc: queued reads continuing each other on one stream are served by one read, other streams are not merged
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceReadQueueUnitTest, SourceReadQueue_Merge_001, TestSize.Level1)
+{
+    LocalFileReader reader;
+    SourceReadQueue queue(reader.Func());
+    Results results;
+    reader.Hold();
+    queue.ReadAsync(0, FILE_SIZE / 2, CHUNK, nullptr, ReadPriority::PLAYBACK, results.Callback(FILE_SIZE / 2));
+    reader.WaitForReads(1);
+    for (uint64_t offset : { 0UL, 2 * CHUNK, CHUNK, 3 * CHUNK }) {
+        queue.ReadAsync(0, offset, CHUNK, nullptr, ReadPriority::PREFETCH, results.Callback(offset));
+    }
+    queue.ReadAsync(1, 4 * CHUNK, CHUNK, nullptr, ReadPriority::PREFETCH, results.Callback(4 * CHUNK));
+    reader.Release();
+    results.WaitFor(6); // 6 requests
+    auto reads = reader.Reads();
+    ASSERT_EQ(reads.size(), 3);
+    EXPECT_EQ(reads[1], std::make_pair(0UL, 4 * CHUNK));
+    EXPECT_EQ(reads[2], std::make_pair(4 * CHUNK, CHUNK));
+    for (auto &result : results.results_) {
+        EXPECT_EQ(result.ret, Status::OK);
+        EXPECT_TRUE(CheckData(result.buffer, result.offset, CHUNK));
+    }
+}
+
+/**
+ * @tc.name: SourceReadQueue_Merge_002
+ * @tc.desc: a merged read cut short by the end of the file gives each request what it would have read alone
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceReadQueueUnitTest, SourceReadQueue_Merge_002, TestSize.Level1)
+{
+    LocalFileReader reader;
+    SourceReadQueue queue(reader.Func());
+    Results results;
+    reader.Hold();
+    queue.ReadAsync(0, 0, CHUNK, nullptr, ReadPriority::PLAYBACK, results.Callback(0));
+    reader.WaitForReads(1);
+    uint64_t offset = FILE_SIZE - CHUNK - CHUNK / 2;
+    for (uint32_t i = 0; i < 3; i++) { // the last of 3 chunks starts past the end
+        queue.ReadAsync(0, offset + i * CHUNK, CHUNK, nullptr, ReadPriority::PLAYBACK,
+            results.Callback(offset + i * CHUNK));
+    }
+    reader.Release();
+    results.WaitFor(4); // 4 requests
+    auto reads = reader.Reads();
+    ASSERT_EQ(reads.size(), 3); // 3, the chunk past the end is read again on its own
+    EXPECT_EQ(reads[2], std::make_pair(offset + 2 * CHUNK, CHUNK));
+    EXPECT_EQ(results.results_[1].ret, Status::OK);
+    EXPECT_TRUE(CheckData(results.results_[1].buffer, offset, CHUNK));
+    EXPECT_EQ(results.results_[2].ret, Status::OK);
+    EXPECT_TRUE(CheckData(results.results_[2].buffer, offset + CHUNK, CHUNK / 2));
+    EXPECT_EQ(results.results_[3].ret, Status::END_OF_STREAM);
+    EXPECT_EQ(DataSize(results.results_[3].buffer), 0);
+}
+
+/**
+ * @tc.name: SourceReadQueue_Cancel_001
+ * @tc.desc: cancel completes the queued reads with ERROR_AGAIN and no data, the read in flight finishes
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceReadQueueUnitTest, SourceReadQueue_Cancel_001, TestSize.Level1)
+{
+    LocalFileReader reader;
+    SourceReadQueue queue(reader.Func());
+    Results results;
+    reader.Hold();
+    queue.ReadAsync(0, 0, CHUNK, nullptr, ReadPriority::PLAYBACK, results.Callback(0));
+    reader.WaitForReads(1);
+    for (uint64_t offset : { 10 * CHUNK, 20 * CHUNK, 30 * CHUNK }) {
+        queue.ReadAsync(0, offset, CHUNK, nullptr, ReadPriority::PREFETCH, results.Callback(offset));
+    }
+    queue.Cancel();
+    results.WaitFor(3); // 3 queued requests
+    reader.Release();
+    results.WaitFor(4); // 4 requests
+    EXPECT_EQ(reader.Reads().size(), 1);
+    for (auto &result : results.results_) {
+        bool isInFlight = result.offset == 0;
+        EXPECT_EQ(result.ret, isInFlight ? Status::OK : Status::ERROR_AGAIN);
+        EXPECT_EQ(DataSize(result.buffer), isInFlight ? CHUNK : 0);
+    }
+}
+
+/**
+ * @tc.name: SourceReadQueue_Stop_001
+ * @tc.desc: destruction waits for the blocked read in flight, every request still queued completes
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceReadQueueUnitTest, SourceReadQueue_Stop_001, TestSize.Level1)
+{
+    LocalFileReader reader;
+    auto queue = new SourceReadQueue(reader.Func());
+    Results results;
+    reader.Hold();
+    Status blockedRet = Status::ERROR_UNKNOWN;
+    std::shared_ptr<Plugins::Buffer> blockedBuffer;
+    std::thread reading([queue, &blockedRet, &blockedBuffer] {
+        blockedRet = queue->Read(1, 0, CHUNK, blockedBuffer);
+    });
+    reader.WaitForReads(1);
+    uint64_t offset = FILE_SIZE - CHUNK - CHUNK / 2;
+    for (uint32_t i = 0; i < 3; i++) { // the last of 3 chunks starts past the end
+        queue->ReadAsync(0, offset + i * CHUNK, CHUNK, nullptr, ReadPriority::PLAYBACK,
+            results.Callback(offset + i * CHUNK));
+    }
+    std::thread stopping([queue] { delete queue; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 50 lets the destructor stop the queue first
+    reader.Release();
+    stopping.join();
+    reading.join();
+    EXPECT_EQ(blockedRet, Status::OK);
+    EXPECT_TRUE(CheckData(blockedBuffer, 0, CHUNK));
+    results.WaitFor(3); // 3 requests
+    for (auto &result : results.results_) {
+        bool isPastEnd = result.offset >= FILE_SIZE;
+        Status served = isPastEnd ? Status::END_OF_STREAM : Status::OK;
+        EXPECT_TRUE(result.ret == Status::ERROR_WRONG_STATE || result.ret == served);
+    }
+}
+
+/**
+ * @tc.name: SourceReadQueue_Perf_001
+ * @tc.desc: wait of playback reads while a prefetch of the whole file is queued, with and without priority
+ * @tc.type: PERF
+ */
+HWTEST_F(SourceReadQueueUnitTest, SourceReadQueue_Perf_001, TestSize.Level3)
+{
+    double fifoWait = AveragePlaybackWait(ReadPriority::PREFETCH);
+    double priorityWait = AveragePlaybackWait(ReadPriority::PLAYBACK);
+    std::cout << "average playback read wait behind " << BENCH_PREFETCH_COUNT << " prefetch reads: fifo "
+              << fifoWait * 1000 << " ms, by priority " << priorityWait * 1000 << " ms" << std::endl; // 1000 ms/s
+    // by priority a playback read waits for at most the read in flight
+    EXPECT_LT(priorityWait, fifoWait / 2); // 2, the prefetch keeps fifo reads waiting far longer
+}
+} // namespace Media
+} // namespace OHOS
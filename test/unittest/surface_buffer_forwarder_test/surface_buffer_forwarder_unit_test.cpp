@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "buffer/avbuffer_queue.h"
+#include "surface_buffer.h"
+#include "surface_buffer_forwarder.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr int32_t QUEUE_SIZE = 8;
+constexpr int32_t SURFACE_BUFFER_COUNT = 4;
+constexpr int32_t FRAME_SIZE = 64 * 1024;
+constexpr int32_t FRAME_COUNT = 32;
+constexpr int32_t BENCH_FRAME_SIZE = 200 * 1024; // a 4K intra frame at a high bitrate
+constexpr int32_t BENCH_FRAME_COUNT = 2400; // 10 s at 240 fps
+constexpr int32_t BYTES_PER_PIXEL = 4;
+constexpr int64_t FRAME_DURATION_US = 4166;
+constexpr auto WAIT_TIMEOUT = std::chrono::seconds(3);
+
+// stands in for the encoder surface, hands out a fixed pool of SurfaceBuffers and counts the ones returned
+class MockSurface {
+public:
+    MockSurface(int32_t count, int32_t size)
+    {
+        BufferRequestConfig config = {
+            .width = size / BYTES_PER_PIXEL,
+            .height = 1,
+            .strideAlignment = 0x8,
+            .format = GRAPHIC_PIXEL_FMT_RGBA_8888,
+            .usage = BUFFER_USAGE_CPU_READ | BUFFER_USAGE_CPU_WRITE | BUFFER_USAGE_MEM_DMA,
+            .timeout = 0,
+        };
+        for (int32_t i = 0; i < count; i++) {
+            sptr<SurfaceBuffer> buffer = SurfaceBuffer::Create();
+            if (buffer != nullptr && buffer->Alloc(config) == GSERROR_OK) {
+                free_.push_back(buffer);
+            }
+        }
+        count_ = free_.size();
+    }
+
+    sptr<SurfaceBuffer> Acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!cond_.wait_for(lock, WAIT_TIMEOUT, [this] { return !free_.empty(); })) {
+            return nullptr;
+        }
+        sptr<SurfaceBuffer> buffer = free_.front();
+        free_.pop_front();
+        return buffer;
+    }
+
+    void Release(const sptr<SurfaceBuffer> &buffer)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(buffer);
+        released_++;
+        cond_.notify_all();
+    }
+
+    bool WaitAllFree()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, WAIT_TIMEOUT, [this] { return free_.size() == count_; });
+    }
+
+    size_t GetReleasedCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return released_;
+    }
+
+    size_t count_ = 0;
+
+private:
+    size_t released_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<sptr<SurfaceBuffer>> free_;
+};
+
+class ConsumerListener : public IConsumerListener {
+public:
+    void OnBufferAvailable() override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        available_++;
+        cond_.notify_all();
+    }
+
+    bool Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!cond_.wait_for(lock, WAIT_TIMEOUT, [this] { return available_ > 0; })) {
+            return false;
+        }
+        available_--;
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    int32_t available_ = 0;
+};
+
+class SurfaceBufferForwarderUnitTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        queue_ = AVBufferQueue::Create(QUEUE_SIZE, MemoryType::UNKNOWN_MEMORY, "forwarder_test");
+        ASSERT_NE(queue_, nullptr);
+        consumer_ = queue_->GetConsumer();
+        listener_ = new ConsumerListener();
+        sptr<IConsumerListener> listener = listener_;
+        consumer_->SetBufferAvailableListener(listener);
+    }
+
+    void TearDown() override
+    {
+        consumer_ = nullptr;
+        listener_ = nullptr;
+        queue_ = nullptr;
+    }
+
+    std::shared_ptr<AVBuffer> AcquireOutput()
+    {
+        std::shared_ptr<AVBuffer> buffer;
+        if (!listener_->Wait() || consumer_->AcquireBuffer(buffer) != Status::OK) {
+            return nullptr;
+        }
+        return buffer;
+    }
+
+protected:
+    std::shared_ptr<AVBufferQueue> queue_;
+    sptr<AVBufferQueueConsumer> consumer_;
+    sptr<ConsumerListener> listener_;
+};
+
+SurfaceBufferForwarder::FillCallback MakeFill(int32_t size, int64_t pts)
+{
+    return [size, pts](const sptr<SurfaceBuffer> &buffer, std::shared_ptr<AVBuffer> &output) {
+        if (size > output->memory_->GetCapacity()) {
+            return false;
+        }
+        output->memory_->SetSize(size);
+        output->pts_ = pts;
+        return true;
+    };
+}
+
+// the copy VideoCaptureFilter used to make for every encoded frame, timed per frame in microseconds
+double CopyHandOff(MockSurface &surface)
+{
+    std::shared_ptr<AVBufferQueue> queue = AVBufferQueue::Create(QUEUE_SIZE, MemoryType::SHARED_MEMORY, "copy_test");
+    sptr<AVBufferQueueProducer> producer = queue->GetProducer();
+    sptr<AVBufferQueueConsumer> consumer = queue->GetConsumer();
+    AVBufferConfig config;
+    config.size = BENCH_FRAME_SIZE;
+    config.memoryType = MemoryType::SHARED_MEMORY;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < BENCH_FRAME_COUNT; i++) {
+        sptr<SurfaceBuffer> buffer = surface.Acquire();
+        std::shared_ptr<AVBuffer> empty;
+        if (buffer == nullptr || producer->RequestBuffer(empty, config, 0) != Status::OK) {
+            return -1;
+        }
+        empty->memory_->Write(static_cast<const uint8_t *>(buffer->GetVirAddr()), BENCH_FRAME_SIZE, 0);
+        empty->pts_ = i * FRAME_DURATION_US;
+        surface.Release(buffer);
+        producer->PushBuffer(empty, true);
+        std::shared_ptr<AVBuffer> filled;
+        consumer->AcquireBuffer(filled);
+        consumer->ReleaseBuffer(filled);
+    }
+    std::chrono::duration<double, std::micro> cost = std::chrono::steady_clock::now() - start;
+    return cost.count() / BENCH_FRAME_COUNT;
+}
+} // namespace
+
+/**
+ * @tc.name: SurfaceBufferForwarder_001
+ * @tc.desc: the consumer reads the SurfaceBuffer memory itself, every buffer returns to the surface after release
+ * @tc.type: FUNC
+ */
+HWTEST_F(SurfaceBufferForwarderUnitTest, SurfaceBufferForwarder_001, TestSize.Level1)
+{
+    MockSurface surface(SURFACE_BUFFER_COUNT, FRAME_SIZE);
+    ASSERT_EQ(surface.count_, static_cast<size_t>(SURFACE_BUFFER_COUNT));
+    auto forwarder = std::make_shared<SurfaceBufferForwarder>("OS_FwdTest",
+        [&surface](const sptr<SurfaceBuffer> &buffer) { surface.Release(buffer); });
+    ASSERT_EQ(forwarder->SetOutputBufferQueue(queue_->GetProducer()), Status::OK);
+
+    for (int32_t i = 0; i < FRAME_COUNT; i++) {
+        sptr<SurfaceBuffer> buffer = surface.Acquire();
+        ASSERT_NE(buffer, nullptr);
+        int32_t size = FRAME_SIZE - i;
+        memset(buffer->GetVirAddr(), i, size);
+        forwarder->Forward(buffer, SyncFence::INVALID_FENCE, MakeFill(size, i * FRAME_DURATION_US));
+
+        std::shared_ptr<AVBuffer> output = AcquireOutput();
+        ASSERT_NE(output, nullptr);
+        EXPECT_EQ(output->memory_->GetAddr(), buffer->GetVirAddr());
+        EXPECT_EQ(output->memory_->GetSize(), size);
+        EXPECT_EQ(output->pts_, i * FRAME_DURATION_US);
+        EXPECT_EQ(output->memory_->GetAddr()[size - 1], static_cast<uint8_t>(i));
+        EXPECT_EQ(consumer_->ReleaseBuffer(output), Status::OK);
+    }
+    EXPECT_TRUE(surface.WaitAllFree());
+    EXPECT_EQ(surface.GetReleasedCount(), static_cast<size_t>(FRAME_COUNT));
+    EXPECT_EQ(forwarder->GetInFlightCount(), 0u);
+}
+
+/**
+ * @tc.name: SurfaceBufferForwarder_002
+ * @tc.desc: rejected frames return at once, destruction waits for the frames the consumer still holds
+ * @tc.type: FUNC
+ */
+HWTEST_F(SurfaceBufferForwarderUnitTest, SurfaceBufferForwarder_002, TestSize.Level1)
+{
+    MockSurface surface(SURFACE_BUFFER_COUNT, FRAME_SIZE);
+    ASSERT_EQ(surface.count_, static_cast<size_t>(SURFACE_BUFFER_COUNT));
+    auto forwarder = std::make_shared<SurfaceBufferForwarder>("OS_FwdTest",
+        [&surface](const sptr<SurfaceBuffer> &buffer) { surface.Release(buffer); });
+    ASSERT_EQ(forwarder->SetOutputBufferQueue(queue_->GetProducer()), Status::OK);
+
+    sptr<SurfaceBuffer> rejected = surface.Acquire();
+    ASSERT_NE(rejected, nullptr);
+    forwarder->Forward(rejected, SyncFence::INVALID_FENCE, MakeFill(FRAME_SIZE * 2, 0));
+    std::vector<std::shared_ptr<AVBuffer>> outputs;
+    for (int32_t i = 0; i < SURFACE_BUFFER_COUNT - 1; i++) {
+        sptr<SurfaceBuffer> buffer = surface.Acquire();
+        ASSERT_NE(buffer, nullptr);
+        forwarder->Forward(buffer, SyncFence::INVALID_FENCE, MakeFill(FRAME_SIZE, i * FRAME_DURATION_US));
+        outputs.push_back(AcquireOutput());
+        ASSERT_NE(outputs.back(), nullptr);
+    }
+    // the consumer holds every forwarded frame, only the rejected one is back
+    EXPECT_EQ(surface.GetReleasedCount(), 1u);
+    EXPECT_EQ(forwarder->GetInFlightCount(), static_cast<size_t>(SURFACE_BUFFER_COUNT - 1));
+    std::thread consumer([this, &outputs] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 50: released while the forwarder is destroyed
+        for (auto &output : outputs) {
+            consumer_->ReleaseBuffer(output);
+        }
+    });
+    forwarder = nullptr;
+    consumer.join();
+    EXPECT_TRUE(surface.WaitAllFree());
+}
+
+/**
+ * @tc.name: SurfaceBufferForwarder_003
+ * @tc.desc: a frame the consumer keeps past destruction is not returned to the surface and stays readable
+ * @tc.type: FUNC
+ */
+HWTEST_F(SurfaceBufferForwarderUnitTest, SurfaceBufferForwarder_003, TestSize.Level1)
+{
+    MockSurface surface(SURFACE_BUFFER_COUNT, FRAME_SIZE);
+    ASSERT_EQ(surface.count_, static_cast<size_t>(SURFACE_BUFFER_COUNT));
+    auto forwarder = std::make_shared<SurfaceBufferForwarder>("OS_FwdTest",
+        [&surface](const sptr<SurfaceBuffer> &buffer) { surface.Release(buffer); });
+    ASSERT_EQ(forwarder->SetOutputBufferQueue(queue_->GetProducer()), Status::OK);
+
+    sptr<SurfaceBuffer> buffer = surface.Acquire();
+    ASSERT_NE(buffer, nullptr);
+    memset(buffer->GetVirAddr(), 1, FRAME_SIZE);
+    forwarder->Forward(buffer, SyncFence::INVALID_FENCE, MakeFill(FRAME_SIZE, 0));
+    std::shared_ptr<AVBuffer> output = AcquireOutput();
+    ASSERT_NE(output, nullptr);
+    forwarder = nullptr;
+    EXPECT_EQ(surface.GetReleasedCount(), 0u);
+    EXPECT_EQ(output->memory_->GetAddr()[FRAME_SIZE - 1], 1);
+    EXPECT_EQ(consumer_->ReleaseBuffer(output), Status::OK);
+}
+
+/**
+ * @tc.name: SurfaceBufferForwarder_Perf_001
+ * @tc.desc: per frame hand-off cost at 240 fps, copying into shared memory against forwarding the SurfaceBuffer
+ * @tc.type: PERF
+ */
+HWTEST_F(SurfaceBufferForwarderUnitTest, SurfaceBufferForwarder_Perf_001, TestSize.Level3)
+{
+    MockSurface surface(SURFACE_BUFFER_COUNT, BENCH_FRAME_SIZE);
+    ASSERT_EQ(surface.count_, static_cast<size_t>(SURFACE_BUFFER_COUNT));
+    double copyCost = CopyHandOff(surface);
+    ASSERT_GT(copyCost, 0);
+
+    auto forwarder = std::make_shared<SurfaceBufferForwarder>("OS_FwdTest",
+        [&surface](const sptr<SurfaceBuffer> &buffer) { surface.Release(buffer); });
+    ASSERT_EQ(forwarder->SetOutputBufferQueue(queue_->GetProducer()), Status::OK);
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < BENCH_FRAME_COUNT; i++) {
+        sptr<SurfaceBuffer> buffer = surface.Acquire();
+        ASSERT_NE(buffer, nullptr);
+        forwarder->Forward(buffer, SyncFence::INVALID_FENCE, MakeFill(BENCH_FRAME_SIZE, i * FRAME_DURATION_US));
+        std::shared_ptr<AVBuffer> output = AcquireOutput();
+        ASSERT_NE(output, nullptr);
+        consumer_->ReleaseBuffer(output);
+    }
+    std::chrono::duration<double, std::micro> cost = std::chrono::steady_clock::now() - start;
+    double forwardCost = cost.count() / BENCH_FRAME_COUNT;
+    std::cout << "hand-off of " << BENCH_FRAME_SIZE << " byte frames, copy: " << copyCost << " us/frame, forward: "
+              << forwardCost << " us/frame" << std::endl;
+    EXPECT_TRUE(surface.WaitAllFree());
+    EXPECT_EQ(forwarder->GetInFlightCount(), 0u);
+}
+} // namespace Media
+} // namespace OHOS
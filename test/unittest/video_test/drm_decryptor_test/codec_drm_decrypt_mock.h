@@ -43,6 +43,13 @@ private:
     std::shared_ptr<MediaAVCodec::CodecDrmDecrypt> decryptor_ = nullptr;
 };
 
+// stands in for the key session's decrypt module, so batching can be checked without a drm service
+class CodecDrmDecryptKeySessionMock : public CodecDrmDecrypt {
+public:
+    MOCK_METHOD(int32_t, DecryptByModule,
+        (const DrmCryptInfo &cryptInfo, DrmBuffer &inDrmBuffer, DrmBuffer &outDrmBuffer), (override));
+};
+
 } // name space MediaAVCodec
 } // namespace OHOS
 
@@ -439,6 +439,23 @@ void AudioCencDecrypt(std::shared_ptr<AVBuffer> drmInBuf, std::shared_ptr<AVBuff
     decryptorMock->DrmAudioCencDecrypt(drmInBuf, drmOutBuf, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE);
 }
 
+std::shared_ptr<AVBuffer> CreateAudioSample(std::shared_ptr<AVAllocator> avAllocator, MetaDrmCencAlgorithm algo)
+{
+    std::shared_ptr<AVBuffer> buffer = AVBuffer::CreateAVBuffer(avAllocator,
+        static_cast<int32_t>(DRM_AUDIO_ENCRYPTED_BUFFER_SIZE));
+    EXPECT_NE(buffer, nullptr);
+    int32_t drmRes = memcpy_s(buffer->memory_->GetAddr(), DRM_AUDIO_ENCRYPTED_BUFFER_SIZE,
+        DRM_AUDIO_ENCRYPTED_BUFFER, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE);
+    EXPECT_EQ(drmRes, 0);
+    buffer->memory_->SetSize(static_cast<int32_t>(DRM_AUDIO_ENCRYPTED_BUFFER_SIZE));
+    MetaDrmCencInfo cencInfo;
+    CreateAudioCencInfo(cencInfo, algo);
+    std::vector<uint8_t> drmCencVec(reinterpret_cast<uint8_t *>(&cencInfo),
+        (reinterpret_cast<uint8_t *>(&cencInfo)) + sizeof(MetaDrmCencInfo));
+    buffer->meta_->SetData(Media::Tag::DRM_CENC_INFO, std::move(drmCencVec));
+    return buffer;
+}
+
 /**
  * @tc.name: Codec_Drm_Decryptor_SetCodecName_001
  * @tc.desc: set decoder name with H264
@@ -638,5 +655,155 @@ HWTEST_F(CodecDrmDecryptorUnitTest, Codec_Drm_Decryptor_DrmAudioCencDecrypt_001,
     AudioCencDecrypt(drmInBuf, drmOutBuf, decryptorMock_, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_SM4_CBC, 1);
     AudioCencDecrypt(drmInBuf, drmOutBuf, decryptorMock_, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_UNENCRYPTED, 1);
 }
+/**
+ * @tc.name: Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_001
+ * @tc.desc: a batch with one key calls the decrypt module once per encrypted sample, clear samples are copied
+ */
+HWTEST_F(CodecDrmDecryptorUnitTest, Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_001, TestSize.Level1)
+{
+    auto decryptor = std::make_shared<CodecDrmDecryptKeySessionMock>();
+    std::shared_ptr<AVAllocator> avAllocator = AVAllocatorFactory::CreateSharedAllocator(MEMORY_READ_WRITE);
+    ASSERT_NE(avAllocator, nullptr);
+    std::vector<DrmDecryptTask> tasks;
+    const MetaDrmCencAlgorithm algos[] = {
+        MetaDrmCencAlgorithm::META_DRM_ALG_CENC_AES_CTR, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_UNENCRYPTED,
+        MetaDrmCencAlgorithm::META_DRM_ALG_CENC_AES_CTR, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_AES_CBC,
+    };
+    for (auto algo : algos) {
+        tasks.push_back({CreateAudioSample(avAllocator, algo),
+            AVBuffer::CreateAVBuffer(avAllocator, static_cast<int32_t>(DRM_AUDIO_ENCRYPTED_BUFFER_SIZE)),
+            DRM_AUDIO_ENCRYPTED_BUFFER_SIZE});
+    }
+    std::vector<uint8_t> keyId(DRM_AUDIO_KEY_ID, DRM_AUDIO_KEY_ID + KEY_ID_LEN);
+    EXPECT_CALL(*decryptor, DecryptByModule(Field(&DrmCryptInfo::keyId, keyId), _, _))
+        .Times(3)
+        .WillRepeatedly(Return(AVCS_ERR_OK));
+    EXPECT_EQ(decryptor->DrmAudioCencDecryptBatch(tasks), AVCS_ERR_OK);
+    EXPECT_EQ(memcmp(tasks[1].outBuf->memory_->GetAddr(), DRM_AUDIO_ENCRYPTED_BUFFER,
+        DRM_AUDIO_ENCRYPTED_BUFFER_SIZE), 0);
+}
+
+/**
+ * @tc.name: Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_002
+ * @tc.desc: in-place decryption hands the same buffer to the decrypt module as input and output
+ */
+HWTEST_F(CodecDrmDecryptorUnitTest, Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_002, TestSize.Level1)
+{
+    auto decryptor = std::make_shared<CodecDrmDecryptKeySessionMock>();
+    std::shared_ptr<AVAllocator> avAllocator = AVAllocatorFactory::CreateSharedAllocator(MEMORY_READ_WRITE);
+    ASSERT_NE(avAllocator, nullptr);
+    std::shared_ptr<AVBuffer> sample = CreateAudioSample(avAllocator, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_SM4_CTR);
+    EXPECT_TRUE(decryptor->CanDecryptInPlace(sample));
+    std::vector<DrmDecryptTask> tasks = {{sample, sample, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE}};
+    EXPECT_CALL(*decryptor, DecryptByModule(_, _, _))
+        .WillOnce(Invoke([](const DrmCryptInfo &cryptInfo, DrmBuffer &inDrmBuffer, DrmBuffer &outDrmBuffer) {
+            EXPECT_EQ(cryptInfo.subSample.size(), 1);
+            EXPECT_EQ(inDrmBuffer.fd, outDrmBuffer.fd);
+            return AVCS_ERR_OK;
+        }));
+    EXPECT_EQ(decryptor->DrmAudioCencDecryptBatch(tasks), AVCS_ERR_OK);
+}
+
+/**
+ * @tc.name: Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_003
+ * @tc.desc: a failing decrypt module stops the batch and reports the error
+ */
+HWTEST_F(CodecDrmDecryptorUnitTest, Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_003, TestSize.Level1)
+{
+    auto decryptor = std::make_shared<CodecDrmDecryptKeySessionMock>();
+    std::shared_ptr<AVAllocator> avAllocator = AVAllocatorFactory::CreateSharedAllocator(MEMORY_READ_WRITE);
+    ASSERT_NE(avAllocator, nullptr);
+    std::vector<DrmDecryptTask> tasks;
+    for (int32_t i = 0; i < 2; i++) { // 2: samples in the batch
+        auto sample = CreateAudioSample(avAllocator, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_AES_CTR);
+        tasks.push_back({sample, sample, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE});
+    }
+    EXPECT_CALL(*decryptor, DecryptByModule(_, _, _)).WillOnce(Return(AVCS_ERR_UNKNOWN));
+    EXPECT_NE(decryptor->DrmAudioCencDecryptBatch(tasks), AVCS_ERR_OK);
+}
+
+/**
+ * @tc.name: Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_004
+ * @tc.desc: a decrypt module rejecting in-place decryption after writing into the sample gets the original sample
+ *           again through a separate output buffer, later samples are no longer offered in place
+ */
+HWTEST_F(CodecDrmDecryptorUnitTest, Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_004, TestSize.Level1)
+{
+    auto decryptor = std::make_shared<CodecDrmDecryptKeySessionMock>();
+    std::shared_ptr<AVAllocator> avAllocator = AVAllocatorFactory::CreateSharedAllocator(MEMORY_READ_WRITE);
+    ASSERT_NE(avAllocator, nullptr);
+    std::shared_ptr<AVBuffer> sample = CreateAudioSample(avAllocator, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_AES_CTR);
+    ASSERT_TRUE(decryptor->CanDecryptInPlace(sample));
+    std::vector<DrmDecryptTask> tasks = {{sample, sample, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE}};
+    uint8_t *sampleAddr = sample->memory_->GetAddr();
+    EXPECT_CALL(*decryptor, DecryptByModule(_, _, _))
+        .Times(2) // 2: the rejected in-place attempt and the copy path
+        .WillRepeatedly(Invoke([sampleAddr](const DrmCryptInfo &cryptInfo, DrmBuffer &inDrmBuffer,
+            DrmBuffer &outDrmBuffer) {
+            (void)cryptInfo;
+            if (inDrmBuffer.fd == outDrmBuffer.fd) {
+                (void)memset_s(sampleAddr, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE, 0, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE);
+                return AVCS_ERR_UNSUPPORT;
+            }
+            EXPECT_EQ(memcmp(sampleAddr, DRM_AUDIO_ENCRYPTED_BUFFER, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE), 0);
+            return AVCS_ERR_OK;
+        }));
+    EXPECT_EQ(decryptor->DrmAudioCencDecryptBatch(tasks), AVCS_ERR_OK);
+    EXPECT_FALSE(decryptor->CanDecryptInPlace(sample));
+}
+
+/**
+ * @tc.name: Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_005
+ * @tc.desc: a transient in-place failure restores the sample and keeps in-place decryption for the next batch
+ */
+HWTEST_F(CodecDrmDecryptorUnitTest, Codec_Drm_Decryptor_DrmAudioCencDecryptBatch_005, TestSize.Level1)
+{
+    auto decryptor = std::make_shared<CodecDrmDecryptKeySessionMock>();
+    std::shared_ptr<AVAllocator> avAllocator = AVAllocatorFactory::CreateSharedAllocator(MEMORY_READ_WRITE);
+    ASSERT_NE(avAllocator, nullptr);
+    std::shared_ptr<AVBuffer> sample = CreateAudioSample(avAllocator, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_AES_CTR);
+    std::vector<DrmDecryptTask> tasks = {{sample, sample, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE}};
+    uint8_t *sampleAddr = sample->memory_->GetAddr();
+    EXPECT_CALL(*decryptor, DecryptByModule(_, _, _))
+        .WillOnce(Invoke([sampleAddr](const DrmCryptInfo &cryptInfo, DrmBuffer &inDrmBuffer,
+            DrmBuffer &outDrmBuffer) {
+            (void)cryptInfo;
+            EXPECT_EQ(inDrmBuffer.fd, outDrmBuffer.fd);
+            (void)memset_s(sampleAddr, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE, 0, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE);
+            return AVCS_ERR_UNKNOWN;
+        }))
+        .WillOnce(Invoke([](const DrmCryptInfo &cryptInfo, DrmBuffer &inDrmBuffer, DrmBuffer &outDrmBuffer) {
+            (void)cryptInfo;
+            EXPECT_EQ(inDrmBuffer.fd, outDrmBuffer.fd);
+            return AVCS_ERR_OK;
+        }));
+    EXPECT_NE(decryptor->DrmAudioCencDecryptBatch(tasks), AVCS_ERR_OK);
+    EXPECT_EQ(memcmp(sampleAddr, DRM_AUDIO_ENCRYPTED_BUFFER, DRM_AUDIO_ENCRYPTED_BUFFER_SIZE), 0);
+    EXPECT_TRUE(decryptor->CanDecryptInPlace(sample));
+    EXPECT_EQ(decryptor->DrmAudioCencDecryptBatch(tasks), AVCS_ERR_OK);
+    EXPECT_TRUE(decryptor->CanDecryptInPlace(sample));
+}
+
+/**
+ * @tc.name: Codec_Drm_Decryptor_NeedsDecryption_001
+ * @tc.desc: clear samples of a non secure session skip decryption, encrypted ones and secure sessions do not
+ */
+HWTEST_F(CodecDrmDecryptorUnitTest, Codec_Drm_Decryptor_NeedsDecryption_001, TestSize.Level1)
+{
+    auto decryptor = std::make_shared<CodecDrmDecryptKeySessionMock>();
+    std::shared_ptr<AVAllocator> avAllocator = AVAllocatorFactory::CreateSharedAllocator(MEMORY_READ_WRITE);
+    ASSERT_NE(avAllocator, nullptr);
+    auto clearSample = CreateAudioSample(avAllocator, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_UNENCRYPTED);
+    auto encryptedSample = CreateAudioSample(avAllocator, MetaDrmCencAlgorithm::META_DRM_ALG_CENC_SM4_CBC);
+    auto plainSample = AVBuffer::CreateAVBuffer(avAllocator, static_cast<int32_t>(DRM_AUDIO_ENCRYPTED_BUFFER_SIZE));
+    ASSERT_NE(plainSample, nullptr);
+    EXPECT_FALSE(decryptor->NeedsDecryption(clearSample));
+    EXPECT_FALSE(decryptor->NeedsDecryption(plainSample));
+    EXPECT_TRUE(decryptor->NeedsDecryption(encryptedSample));
+
+    sptr<DrmStandard::IMediaKeySessionService> session = nullptr;
+    decryptor->SetDecryptionConfig(session, true);
+    EXPECT_TRUE(decryptor->NeedsDecryption(clearSample));
+}
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
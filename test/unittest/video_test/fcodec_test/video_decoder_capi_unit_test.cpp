@@ -202,6 +202,7 @@ public:
     void InputFunc();
     void FormatChangeInputFunc();
     void OutputFunc();
+    void DecodeToEos();
 
 protected:
     std::atomic<bool> isRunning_ = false;
@@ -386,6 +387,29 @@ void VideoCodeCapiDecoderUnitTest::OutputFunc()
     }
 }
 
+void VideoCodeCapiDecoderUnitTest::DecodeToEos()
+{
+    isRunning_.store(true);
+    inputLoop_ = make_unique<thread>(&VideoCodeCapiDecoderUnitTest::InputFunc, this);
+    outputLoop_ = make_unique<thread>(&VideoCodeCapiDecoderUnitTest::OutputFunc, this);
+    EXPECT_EQ(OH_AVErrCode::AV_ERR_OK, OH_VideoDecoder_Start(videoDec_));
+    while (isRunning_.load()) {
+        sleep(1); // sleep 1s
+    }
+    if (inputLoop_ != nullptr && inputLoop_->joinable()) {
+        unique_lock<mutex> lock(signal_->inMutex_);
+        signal_->inCond_.notify_all();
+        lock.unlock();
+        inputLoop_->join();
+    }
+    if (outputLoop_ != nullptr && outputLoop_->joinable()) {
+        unique_lock<mutex> lock(signal_->outMutex_);
+        signal_->outCond_.notify_all();
+        lock.unlock();
+        outputLoop_->join();
+    }
+}
+
 int32_t VideoCodeCapiDecoderUnitTest::ProceFunc(void)
 {
     videoDec_ = OH_VideoDecoder_CreateByName((AVCodecCodecName::VIDEO_DECODER_AVC_NAME).data());
@@ -823,6 +847,49 @@ HWTEST_F(VideoCodeCapiDecoderUnitTest, videoDecoder_normalcase_formatchange, Tes
     }
 }
 
+/**
+ * @tc.name: videoDecoder_reuse_01
+ * @tc.desc: a decoder released after RGBA surface output is reset into the codec pool, the next one created by the
+ *           same name decodes NV21 into buffers without any of the surface or RGBA configuration left
+ */
+HWTEST_F(VideoCodeCapiDecoderUnitTest, videoDecoder_reuse_01, TestSize.Level1)
+{
+    ProceFunc();
+    OH_AVFormat_SetIntValue(format_, OH_MD_KEY_WIDTH, DEFAULT_WIDTH);
+    OH_AVFormat_SetIntValue(format_, OH_MD_KEY_HEIGHT, DEFAULT_HEIGHT);
+    OH_AVFormat_SetIntValue(format_, OH_MD_KEY_PIXEL_FORMAT, AV_PIXEL_FORMAT_RGBA);
+    EXPECT_EQ(OH_AVErrCode::AV_ERR_OK, OH_VideoDecoder_Configure(videoDec_, format_));
+    surface_ = GetSurface();
+    ASSERT_NE(nullptr, surface_);
+    OHNativeWindow *nativeWindow = CreateNativeWindowFromSurface(&surface_);
+    EXPECT_EQ(OH_AVErrCode::AV_ERR_OK, OH_VideoDecoder_SetSurface(videoDec_, nativeWindow));
+    DecodeToEos();
+    EXPECT_EQ(OH_AVErrCode::AV_ERR_OK, OH_VideoDecoder_Destroy(videoDec_));
+    OH_AVFormat_Destroy(format_);
+    DestoryNativeWindow(nativeWindow);
+    surface_ = nullptr;
+    isFirstFrame_ = true;
+    frameCount_ = 0;
+    writeFrameCount = 0;
+
+    ProceFunc();
+    OH_AVFormat_SetIntValue(format_, OH_MD_KEY_WIDTH, DEFAULT_WIDTH);
+    OH_AVFormat_SetIntValue(format_, OH_MD_KEY_HEIGHT, DEFAULT_HEIGHT);
+    OH_AVFormat_SetIntValue(format_, OH_MD_KEY_PIXEL_FORMAT, AV_PIXEL_FORMAT_NV21);
+    EXPECT_EQ(OH_AVErrCode::AV_ERR_OK, OH_VideoDecoder_Configure(videoDec_, format_));
+    OH_AVFormat *outputFormat = OH_VideoDecoder_GetOutputDescription(videoDec_);
+    ASSERT_NE(nullptr, outputFormat);
+    int32_t pixelFormat = 0;
+    int32_t stride = 0;
+    EXPECT_TRUE(OH_AVFormat_GetIntValue(outputFormat, OH_MD_KEY_PIXEL_FORMAT, &pixelFormat));
+    EXPECT_TRUE(OH_AVFormat_GetIntValue(outputFormat, OH_MD_KEY_VIDEO_STRIDE, &stride));
+    EXPECT_EQ(AV_PIXEL_FORMAT_NV21, pixelFormat);
+    EXPECT_EQ(DEFAULT_WIDTH, static_cast<uint32_t>(stride));
+    OH_AVFormat_Destroy(outputFormat);
+    DecodeToEos();
+    EXPECT_GT(writeFrameCount, 0);
+}
+
 HWTEST_F(VideoCodeCapiDecoderUnitTest, videoDecoder_abnormalcase_01, TestSize.Level1)
 {
     EXPECT_EQ(nullptr, videoDec_);
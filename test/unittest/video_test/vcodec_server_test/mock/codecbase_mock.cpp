@@ -88,6 +88,21 @@ int32_t HevcDecoderLoader::GetCapabilityList(std::vector<CapabilityData> &caps)
     return item.first;
 }
 
+void HCodecLoader::GetDumpInfo(std::string &dumpString)
+{
+    (void)dumpString;
+}
+
+void FCodecLoader::GetDumpInfo(std::string &dumpString)
+{
+    (void)dumpString;
+}
+
+void HevcDecoderLoader::GetDumpInfo(std::string &dumpString)
+{
+    (void)dumpString;
+}
+
 void CodecBase::RegisterMock(std::shared_ptr<CodecBaseMock> &mock)
 {
     std::lock_guard<std::mutex> lock(g_mutex);
@@ -27,6 +27,7 @@ class HCodecLoader {
 public:
     static std::shared_ptr<CodecBase> CreateByName(const std::string &name);
     static int32_t GetCapabilityList(std::vector<CapabilityData> &caps);
+    static void GetDumpInfo(std::string &dumpString);
 };
 } // namespace MediaAVCodec
 } // namespace OHOS